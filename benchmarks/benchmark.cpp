@@ -0,0 +1,331 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   B E N C H M A R K   C L A S S
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#include "benchmark.h"
+
+
+/// Default constructor.
+
+Benchmark::Benchmark()
+{
+}
+
+
+/// Destructor.
+
+Benchmark::~Benchmark()
+{
+}
+
+
+/// Returns the number of timed repetitions of each benchmark.
+
+const Index& Benchmark::get_repetitions_number() const
+{
+    return repetitions_number;
+}
+
+
+/// Returns the minimum time of a repetition, in seconds.
+
+const double& Benchmark::get_minimum_time() const
+{
+    return minimum_time;
+}
+
+
+/// Returns the string which the names of the benchmarks to be run must contain.
+
+const string& Benchmark::get_filter() const
+{
+    return filter;
+}
+
+
+/// Returns the seed of the random numbers of each benchmark.
+
+const unsigned& Benchmark::get_seed() const
+{
+    return seed;
+}
+
+
+/// Returns the factor by which the sizes of the synthetic benchmarks are multiplied.
+
+const Index& Benchmark::get_scale() const
+{
+    return scale;
+}
+
+
+/// Returns the results of the benchmarks which have been run.
+
+const vector<Benchmark::Result>& Benchmark::get_results() const
+{
+    return results;
+}
+
+
+/// Returns true if a benchmark is run, and false otherwise.
+/// @param name Name of the benchmark.
+
+bool Benchmark::is_selected(const string& name) const
+{
+    return filter.empty() || name.find(filter) != string::npos;
+}
+
+
+/// Sets the number of timed repetitions of each benchmark.
+/// @param new_repetitions_number Number of repetitions.
+
+void Benchmark::set_repetitions_number(const Index& new_repetitions_number)
+{
+    if(new_repetitions_number <= 0)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: Benchmark class.\n"
+               << "void set_repetitions_number(const Index&) method.\n"
+               << "Number of repetitions must be greater than 0.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    repetitions_number = new_repetitions_number;
+}
+
+
+/// Sets the minimum time of a repetition.
+/// @param new_minimum_time Minimum time in seconds.
+
+void Benchmark::set_minimum_time(const double& new_minimum_time)
+{
+    if(new_minimum_time < 0.0)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: Benchmark class.\n"
+               << "void set_minimum_time(const double&) method.\n"
+               << "Minimum time must be equal or greater than 0.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    minimum_time = new_minimum_time;
+}
+
+
+/// Sets the string which the names of the benchmarks to be run must contain.
+/// An empty string runs all the benchmarks.
+/// @param new_filter Filter string.
+
+void Benchmark::set_filter(const string& new_filter)
+{
+    filter = new_filter;
+}
+
+
+/// Sets the seed of the random numbers of each benchmark.
+/// @param new_seed Seed value.
+
+void Benchmark::set_seed(const unsigned& new_seed)
+{
+    seed = new_seed;
+}
+
+
+/// Sets the factor by which the sizes of the synthetic benchmarks are multiplied.
+/// @param new_scale Scale factor.
+
+void Benchmark::set_scale(const Index& new_scale)
+{
+    if(new_scale <= 0)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: Benchmark class.\n"
+               << "void set_scale(const Index&) method.\n"
+               << "Scale must be greater than 0.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    scale = new_scale;
+}
+
+
+/// Sets a new display value.
+/// @param new_display True if the results are to be displayed as the benchmarks are run, false otherwise.
+
+void Benchmark::set_display(const bool& new_display)
+{
+    display = new_display;
+}
+
+
+/// Computes the statistics of the times of a benchmark and appends them to the results.
+/// @param name Name of the benchmark.
+/// @param iterations_number Number of calls in each repetition.
+/// @param items_number Number of items processed in each call.
+/// @param times Time of a call in each repetition.
+
+void Benchmark::add_result(const string& name, const Index& iterations_number, const Index& items_number, vector<double>& times)
+{
+    Result result;
+
+    result.name = name;
+    result.repetitions_number = static_cast<Index>(times.size());
+    result.iterations_number = iterations_number;
+    result.items_number = items_number;
+
+    sort(times.begin(), times.end());
+
+    const size_t size = times.size();
+
+    double sum = 0.0;
+
+    for(size_t i = 0; i < size; i++) sum += times[i];
+
+    result.mean_time = sum/static_cast<double>(size);
+
+    result.median_time = size%2 == 1 ? times[size/2] : (times[size/2-1] + times[size/2])/2.0;
+
+    result.minimum_time = times.front();
+    result.maximum_time = times.back();
+
+    double squared_deviations = 0.0;
+
+    for(size_t i = 0; i < size; i++) squared_deviations += (times[i] - result.mean_time)*(times[i] - result.mean_time);
+
+    result.standard_deviation = size > 1 ? sqrt(squared_deviations/static_cast<double>(size-1)) : 0.0;
+
+    result.items_per_second = result.median_time > 0.0 ? static_cast<double>(items_number)/result.median_time : 0.0;
+
+    results.push_back(result);
+
+    if(display)
+    {
+        cout << left << setw(56) << name
+             << right << setw(14) << scientific << setprecision(4) << result.median_time << " s"
+             << setw(14) << result.items_per_second << " items/s" << endl;
+    }
+}
+
+
+/// Returns a string in which the quotes and backslashes are escaped for JSON.
+
+string Benchmark::write_escaped(const string& text)
+{
+    ostringstream buffer;
+
+    for(size_t i = 0; i < text.size(); i++)
+    {
+        if(text[i] == '"' || text[i] == '\\') buffer << '\\';
+
+        buffer << text[i];
+    }
+
+    return buffer.str();
+}
+
+
+/// Writes the context and the results of the benchmarks in JSON.
+/// @param stream Output stream.
+
+void Benchmark::write_JSON(ostream& stream) const
+{
+    stream << setprecision(9);
+
+    stream << "{\n"
+           << "  \"context\": {\n"
+           << "    \"library\": \"OpenNN\",\n"
+#ifdef __VERSION__
+           << "    \"compiler\": \"" << write_escaped(__VERSION__) << "\",\n"
+#endif
+           << "    \"threads_number\": " << omp_get_max_threads() << ",\n"
+           << "    \"type_size\": " << sizeof(type) << ",\n"
+           << "    \"index_size\": " << sizeof(Index) << ",\n"
+           << "    \"repetitions_number\": " << repetitions_number << ",\n"
+           << "    \"minimum_time\": " << minimum_time << ",\n"
+           << "    \"seed\": " << seed << ",\n"
+           << "    \"scale\": " << scale << "\n"
+           << "  },\n"
+           << "  \"benchmarks\": [";
+
+    for(size_t i = 0; i < results.size(); i++)
+    {
+        const Result& result = results[i];
+
+        stream << (i == 0 ? "\n" : ",\n")
+               << "    {\n"
+               << "      \"name\": \"" << write_escaped(result.name) << "\",\n"
+               << "      \"repetitions_number\": " << result.repetitions_number << ",\n"
+               << "      \"iterations_number\": " << result.iterations_number << ",\n"
+               << "      \"items_number\": " << result.items_number << ",\n"
+               << "      \"mean_time\": " << result.mean_time << ",\n"
+               << "      \"median_time\": " << result.median_time << ",\n"
+               << "      \"minimum_time\": " << result.minimum_time << ",\n"
+               << "      \"maximum_time\": " << result.maximum_time << ",\n"
+               << "      \"standard_deviation\": " << result.standard_deviation << ",\n"
+               << "      \"items_per_second\": " << result.items_per_second << "\n"
+               << "    }";
+    }
+
+    stream << "\n  ]\n"
+           << "}\n";
+}
+
+
+/// Saves the context and the results of the benchmarks to a JSON file.
+/// @param file_name Name of the JSON file.
+
+void Benchmark::save_JSON(const string& file_name) const
+{
+    ofstream file(file_name.c_str());
+
+    if(!file.is_open())
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: Benchmark class.\n"
+               << "void save_JSON(const string&) const method.\n"
+               << "Cannot open JSON file: " << file_name << "\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    write_JSON(file);
+
+    file.close();
+}
+
+
+/// Prints to the screen the results of the benchmarks in JSON.
+
+void Benchmark::print() const
+{
+    write_JSON(cout);
+}
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
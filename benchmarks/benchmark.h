@@ -0,0 +1,230 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   B E N C H M A R K   C L A S S   H E A D E R
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+// System includes
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <omp.h>
+
+// OpenNN includes
+
+#include "../opennn/opennn.h"
+
+using namespace OpenNN;
+
+/// This class measures the time of repeated calls to a function and writes the results in JSON,
+/// so that the performance of the library can be tracked across releases.
+
+///
+/// Each benchmark is run once as a warm up, then the number of calls per repetition is calibrated
+/// so that a repetition lasts at least the minimum time, and then the repetitions are timed.
+/// The random numbers are seeded before each benchmark, so that the inputs are the same in every run.
+
+class Benchmark
+{
+
+public:
+
+   /// This structure contains the timings of a benchmark.
+
+   struct Result
+   {
+       /// Name of the benchmark, with the group as prefix.
+
+       string name;
+
+       /// Number of timed repetitions.
+
+       Index repetitions_number = 0;
+
+       /// Number of calls to the function in each repetition.
+
+       Index iterations_number = 0;
+
+       /// Number of items, such as instances or parameters, processed in each call.
+
+       Index items_number = 0;
+
+       /// Mean, median, minimum and maximum time of a call, in seconds.
+
+       double mean_time = 0.0;
+       double median_time = 0.0;
+       double minimum_time = 0.0;
+       double maximum_time = 0.0;
+
+       /// Standard deviation of the time of a call, in seconds.
+
+       double standard_deviation = 0.0;
+
+       /// Number of items processed per second, from the median time.
+
+       double items_per_second = 0.0;
+   };
+
+   // Constructors
+
+   explicit Benchmark();
+
+   // Destructor
+
+   virtual ~Benchmark();
+
+   // Get methods
+
+   const Index& get_repetitions_number() const;
+   const double& get_minimum_time() const;
+   const string& get_filter() const;
+   const unsigned& get_seed() const;
+   const Index& get_scale() const;
+
+   const vector<Result>& get_results() const;
+
+   bool is_selected(const string&) const;
+
+   // Set methods
+
+   void set_repetitions_number(const Index&);
+   void set_minimum_time(const double&);
+   void set_filter(const string&);
+   void set_seed(const unsigned&);
+   void set_scale(const Index&);
+
+   void set_display(const bool&);
+
+   // Benchmark methods
+
+   /// Runs a benchmark if its name is selected by the filter.
+   /// @param name Name of the benchmark.
+   /// @param items_number Number of items processed in each call to the function.
+   /// @param function Function to be timed.
+
+   template<class Function>
+   void run(const string& name, const Index& items_number, Function function)
+   {
+       if(!is_selected(name)) return;
+
+       srand(seed);
+
+       // Warm up and calibration
+
+       Index iterations_number = 1;
+
+       double elapsed_time = measure_time(function, iterations_number);
+
+       while(elapsed_time < minimum_time && iterations_number < maximum_iterations_number)
+       {
+           iterations_number *= 2;
+
+           elapsed_time = measure_time(function, iterations_number);
+       }
+
+       // Repetitions
+
+       vector<double> times(static_cast<size_t>(repetitions_number));
+
+       for(size_t i = 0; i < times.size(); i++)
+       {
+           times[i] = measure_time(function, iterations_number)/static_cast<double>(iterations_number);
+       }
+
+       add_result(name, iterations_number, items_number, times);
+   }
+
+   // Serialization methods
+
+   void write_JSON(ostream&) const;
+
+   void save_JSON(const string&) const;
+
+   void print() const;
+
+private:
+
+   /// Returns the time in seconds of a number of consecutive calls to a function.
+
+   template<class Function>
+   static double measure_time(Function& function, const Index& iterations_number)
+   {
+       const chrono::steady_clock::time_point beginning_time = chrono::steady_clock::now();
+
+       for(Index i = 0; i < iterations_number; i++) function();
+
+       const chrono::steady_clock::time_point current_time = chrono::steady_clock::now();
+
+       return chrono::duration<double>(current_time - beginning_time).count();
+   }
+
+   void add_result(const string&, const Index&, const Index&, vector<double>&);
+
+   static string write_escaped(const string&);
+
+   // MEMBERS
+
+   /// Number of timed repetitions of each benchmark.
+
+   Index repetitions_number = 5;
+
+   /// Minimum time of a repetition, in seconds.
+
+   double minimum_time = 0.1;
+
+   /// Maximum number of calls in a repetition.
+
+   Index maximum_iterations_number = 1 << 20;
+
+   /// Only the benchmarks whose name contains this string are run.
+
+   string filter;
+
+   /// Seed of the random numbers of each benchmark.
+
+   unsigned seed = 1;
+
+   /// Factor by which the sizes of the synthetic benchmarks are multiplied.
+
+   Index scale = 1;
+
+   /// Display messages to screen.
+
+   bool display = true;
+
+   /// Results of the benchmarks which have been run.
+
+   vector<Result> results;
+};
+
+#endif
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
@@ -0,0 +1,772 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   B E N C H M A R K S   A P P L I C A T I O N
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+// This application measures the training and inference hot paths of OpenNN
+// and writes the results in JSON, so that performance regressions can be tracked.
+
+// System includes
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <time.h>
+#include <omp.h>
+
+// OpenNN includes
+
+#include "benchmark.h"
+
+using namespace OpenNN;
+
+#ifndef OPENNN_DATASETS_DIRECTORY
+#define OPENNN_DATASETS_DIRECTORY "../datasets"
+#endif
+
+
+/// Sets random inputs and one hot encoded targets to a data set,
+/// whose class is the largest of the first inputs.
+/// @param data_set Data set to be set.
+/// @param instances_number Number of instances.
+/// @param inputs_number Number of inputs.
+/// @param targets_number Number of classes.
+
+void set_classification_data(DataSet& data_set, const Index& instances_number, const Index& inputs_number, const Index& targets_number)
+{
+    Tensor<type, 2> data(instances_number, inputs_number + targets_number);
+
+    data.setRandom<Eigen::internal::NormalRandomGenerator<type>>();
+
+    for(Index i = 0; i < instances_number; i++)
+    {
+        Index target_index = 0;
+
+        for(Index j = 1; j < targets_number; j++)
+        {
+            if(data(i, j) > data(i, target_index)) target_index = j;
+        }
+
+        for(Index j = 0; j < targets_number; j++)
+        {
+            data(i, inputs_number + j) = j == target_index ? 1 : 0;
+        }
+    }
+
+    data_set.set(data);
+
+    Tensor<DataSet::VariableUse, 1> columns_uses(inputs_number + targets_number);
+    columns_uses.setConstant(DataSet::Input);
+
+    for(Index j = 0; j < targets_number; j++) columns_uses(inputs_number + j) = DataSet::Target;
+
+    data_set.set_columns_uses(columns_uses);
+}
+
+
+/// Benchmarks the loading of data files and the filling of batches.
+
+void benchmark_data_set(Benchmark& benchmark, const string& datasets_directory)
+{
+    const Index scale = benchmark.get_scale();
+
+    // Batch fill
+
+    {
+        DataSet data_set;
+        data_set.generate_Rosenbrock_data(10000*scale, 101);
+
+        const Index batch_instances_number = 1000;
+
+        const Tensor<Index, 1> instances_indices = data_set.get_used_instances_indices();
+        const Tensor<Index, 1> inputs_indices = data_set.get_input_variables_indices();
+        const Tensor<Index, 1> targets_indices = data_set.get_target_variables_indices();
+
+        const Tensor<Index, 2> batches = data_set.get_batches(instances_indices, batch_instances_number, false);
+
+        const Tensor<Index, 1> batch_indices = batches.chip(0, 0);
+
+        DataSet::Batch batch(batch_instances_number, &data_set);
+
+        benchmark.run("data_set/batch_fill/1000x100", batch_instances_number, [&]()
+        {
+            batch.fill(batch_indices, inputs_indices, targets_indices);
+        });
+
+        benchmark.run("data_set/get_batches/" + to_string(10000*scale), instances_indices.size(), [&]()
+        {
+            data_set.get_batches(instances_indices, batch_instances_number, false);
+        });
+    }
+
+    // Read synthetic CSV
+
+    {
+        const string file_name = "benchmark_data.csv";
+
+        DataSet data_set;
+        data_set.generate_Rosenbrock_data(10000*scale, 21);
+
+        const Tensor<type, 2>& data = data_set.get_data();
+
+        ofstream file(file_name.c_str());
+
+        file.precision(17);
+
+        for(Index i = 0; i < data.dimension(0); i++)
+        {
+            for(Index j = 0; j < data.dimension(1); j++)
+            {
+                file << (j == 0 ? "" : ",") << data(i, j);
+            }
+
+            file << "\n";
+        }
+
+        file.close();
+
+        benchmark.run("data_set/read_csv/synthetic_" + to_string(10000*scale) + "x21", 10000*scale, [&]()
+        {
+            DataSet read_data_set;
+            read_data_set.set_data_file_name(file_name);
+            read_data_set.set_separator(',');
+            read_data_set.set_has_columns_names(false);
+            read_data_set.set_display(false);
+            read_data_set.read_csv();
+        });
+
+        remove(file_name.c_str());
+    }
+
+    // Read bundled data sets
+
+    const Index files_number = 4;
+
+    const string files_names[files_number] = {"iris.data", "car.data", "adult.data", "mnist.csv"};
+    const char separators[files_number] = {',', ',', ',', ','};
+    const bool columns_names[files_number] = {false, false, false, false};
+
+    for(Index i = 0; i < files_number; i++)
+    {
+        const string name = "data_set/read_csv/" + files_names[i];
+
+        if(!benchmark.is_selected(name)) continue;
+
+        const string file_name = datasets_directory + "/" + files_names[i];
+
+        try
+        {
+            DataSet data_set(file_name, separators[i], columns_names[i]);
+
+            benchmark.run(name, data_set.get_instances_number(), [&]()
+            {
+                DataSet read_data_set(file_name, separators[i], columns_names[i]);
+            });
+        }
+        catch(const logic_error& e)
+        {
+            cerr << "Skipping " << file_name << ":\n" << e.what() << endl;
+        }
+    }
+}
+
+
+/// Benchmarks the forward propagation of each type of layer.
+
+void benchmark_layers(Benchmark& benchmark)
+{
+    const Index batch_instances_number = 1000*benchmark.get_scale();
+    const Index inputs_number = 100;
+    const Index neurons_number = 100;
+
+    Tensor<type, 2> inputs(batch_instances_number, inputs_number);
+    inputs.setRandom();
+
+    const Index flops = 2*batch_instances_number*inputs_number*neurons_number;
+
+    // Perceptron
+
+    const PerceptronLayer::ActivationFunction activation_functions[3]
+            = {PerceptronLayer::HyperbolicTangent, PerceptronLayer::RectifiedLinear, PerceptronLayer::Logistic};
+
+    const string activation_functions_names[3] = {"hyperbolic_tangent", "rectified_linear", "logistic"};
+
+    for(Index i = 0; i < 3; i++)
+    {
+        PerceptronLayer perceptron_layer(inputs_number, neurons_number, 0, activation_functions[i]);
+
+        Layer::ForwardPropagation forward_propagation(batch_instances_number, &perceptron_layer);
+
+        benchmark.run("layers/perceptron/forward_propagate/" + activation_functions_names[i], flops, [&]()
+        {
+            perceptron_layer.forward_propagate(inputs, forward_propagation);
+        });
+    }
+
+    // Wide perceptron, whose combinations do not fit in cache
+
+    {
+        const Index wide_batch_instances_number = 1024*benchmark.get_scale();
+        const Index wide_neurons_number = 1024;
+
+        Tensor<type, 2> wide_inputs(wide_batch_instances_number, wide_neurons_number);
+        wide_inputs.setRandom();
+
+        PerceptronLayer perceptron_layer(wide_neurons_number, wide_neurons_number, 0, PerceptronLayer::HyperbolicTangent);
+
+        Layer::ForwardPropagation forward_propagation(wide_batch_instances_number, &perceptron_layer);
+
+        benchmark.run("layers/perceptron/forward_propagate/wide/hyperbolic_tangent",
+                      2*wide_batch_instances_number*wide_neurons_number*wide_neurons_number, [&]()
+        {
+            perceptron_layer.forward_propagate(wide_inputs, forward_propagation);
+        });
+    }
+
+    // Probabilistic
+
+    {
+        ProbabilisticLayer probabilistic_layer(inputs_number, 10);
+        probabilistic_layer.set_activation_function(ProbabilisticLayer::Softmax);
+
+        Layer::ForwardPropagation forward_propagation(batch_instances_number, &probabilistic_layer);
+
+        benchmark.run("layers/probabilistic/forward_propagate/softmax", 2*batch_instances_number*inputs_number*10, [&]()
+        {
+            probabilistic_layer.forward_propagate(inputs, forward_propagation);
+        });
+    }
+
+    // Recurrent
+
+    {
+        RecurrentLayer recurrent_layer(inputs_number, neurons_number);
+
+        Layer::ForwardPropagation forward_propagation(batch_instances_number, &recurrent_layer);
+
+        benchmark.run("layers/recurrent/forward_propagate", 2*flops, [&]()
+        {
+            recurrent_layer.forward_propagate(inputs, forward_propagation);
+        });
+    }
+
+    // Long short term memory
+
+    {
+        LongShortTermMemoryLayer long_short_term_memory_layer(inputs_number, neurons_number);
+
+        Layer::ForwardPropagation forward_propagation(batch_instances_number, &long_short_term_memory_layer);
+
+        benchmark.run("layers/long_short_term_memory/forward_propagate", 8*flops, [&]()
+        {
+            long_short_term_memory_layer.forward_propagate(inputs, forward_propagation);
+        });
+    }
+}
+
+
+/// Benchmarks the back propagation of each loss index on a multilayer perceptron.
+
+void benchmark_losses(Benchmark& benchmark)
+{
+    const Index instances_number = 1000*benchmark.get_scale();
+    const Index inputs_number = 50;
+    const Index targets_number = 5;
+
+    DataSet data_set;
+    set_classification_data(data_set, instances_number, inputs_number, targets_number);
+    data_set.set_training();
+
+    const Tensor<Index, 1> instances_indices = data_set.get_training_instances_indices();
+    const Tensor<Index, 1> inputs_indices = data_set.get_input_variables_indices();
+    const Tensor<Index, 1> targets_indices = data_set.get_target_variables_indices();
+
+    DataSet::Batch batch(instances_number, &data_set);
+    batch.fill(instances_indices, inputs_indices, targets_indices);
+
+    Tensor<Index, 1> architecture(3);
+    architecture.setValues({inputs_number, 50, targets_number});
+
+    NeuralNetwork approximation_neural_network(NeuralNetwork::Approximation, architecture);
+    NeuralNetwork classification_neural_network(NeuralNetwork::Classification, architecture);
+
+    NeuralNetwork::ForwardPropagation approximation_forward_propagation(instances_number, &approximation_neural_network);
+    NeuralNetwork::ForwardPropagation classification_forward_propagation(instances_number, &classification_neural_network);
+
+    const Index parameters_number = approximation_neural_network.get_parameters_number();
+
+    benchmark.run("neural_network/forward_propagate/approximation", instances_number, [&]()
+    {
+        approximation_neural_network.forward_propagate(batch, approximation_forward_propagation);
+    });
+
+    benchmark.run("neural_network/forward_propagate/classification", instances_number, [&]()
+    {
+        classification_neural_network.forward_propagate(batch, classification_forward_propagation);
+    });
+
+    const Tensor<type, 2>& inputs = batch.inputs_2d;
+
+    benchmark.run("neural_network/calculate_outputs", instances_number, [&]()
+    {
+        approximation_neural_network.calculate_outputs(inputs);
+    });
+
+    approximation_neural_network.forward_propagate(batch, approximation_forward_propagation);
+    classification_neural_network.forward_propagate(batch, classification_forward_propagation);
+
+    SumSquaredError sum_squared_error(&approximation_neural_network, &data_set);
+    MeanSquaredError mean_squared_error(&approximation_neural_network, &data_set);
+    NormalizedSquaredError normalized_squared_error(&approximation_neural_network, &data_set);
+    MinkowskiError minkowski_error(&approximation_neural_network, &data_set);
+    CrossEntropyError cross_entropy_error(&classification_neural_network, &data_set);
+
+    const Index losses_number = 5;
+
+    LossIndex* losses_pointers[losses_number]
+            = {&sum_squared_error, &mean_squared_error, &normalized_squared_error, &minkowski_error, &cross_entropy_error};
+
+    NeuralNetwork::ForwardPropagation* forward_propagations_pointers[losses_number]
+            = {&approximation_forward_propagation,
+               &approximation_forward_propagation,
+               &approximation_forward_propagation,
+               &approximation_forward_propagation,
+               &classification_forward_propagation};
+
+    const string losses_names[losses_number]
+            = {"sum_squared_error", "mean_squared_error", "normalized_squared_error", "minkowski_error", "cross_entropy_error"};
+
+    for(Index i = 0; i < losses_number; i++)
+    {
+        LossIndex* loss_index_pointer = losses_pointers[i];
+        NeuralNetwork::ForwardPropagation& forward_propagation = *forward_propagations_pointers[i];
+
+        LossIndex::BackPropagation back_propagation(instances_number, loss_index_pointer);
+
+        benchmark.run("loss_index/back_propagate/" + losses_names[i], parameters_number, [&]()
+        {
+            loss_index_pointer->back_propagate(batch, forward_propagation, back_propagation);
+        });
+    }
+
+    // Levenberg-Marquardt terms
+
+    {
+        LossIndex::BackPropagation back_propagation(instances_number, &sum_squared_error);
+        LossIndex::SecondOrderLoss terms_second_order_loss(parameters_number, instances_number);
+
+        benchmark.run("loss_index/calculate_terms_second_order_loss/sum_squared_error", parameters_number, [&]()
+        {
+            sum_squared_error.calculate_terms_second_order_loss(batch,
+                                                                approximation_forward_propagation,
+                                                                back_propagation,
+                                                                terms_second_order_loss);
+        });
+    }
+}
+
+
+/// Benchmarks an iteration of the stochastic optimization algorithms,
+/// and an epoch of the optimization algorithms which use the whole training instances.
+
+void benchmark_optimizers(Benchmark& benchmark)
+{
+    const Index instances_number = 1000*benchmark.get_scale();
+    const Index inputs_number = 20;
+
+    DataSet data_set;
+    data_set.generate_Rosenbrock_data(instances_number, inputs_number+1);
+    data_set.set_training();
+
+    Tensor<Index, 1> architecture(3);
+    architecture.setValues({inputs_number, 20, 1});
+
+    NeuralNetwork neural_network(NeuralNetwork::Approximation, architecture);
+
+    SumSquaredError sum_squared_error(&neural_network, &data_set);
+
+    const Index parameters_number = neural_network.get_parameters_number();
+
+    LossIndex::BackPropagation back_propagation(instances_number, &sum_squared_error);
+    back_propagation.gradient.setRandom();
+
+    // Iterations
+
+    {
+        StochasticGradientDescent stochastic_gradient_descent(&sum_squared_error);
+        StochasticGradientDescent::OptimizationData optimization_data(&stochastic_gradient_descent);
+
+        benchmark.run("optimization_algorithm/update_iteration/stochastic_gradient_descent", parameters_number, [&]()
+        {
+            stochastic_gradient_descent.update_iteration(back_propagation, optimization_data);
+        });
+    }
+
+    {
+        AdaptiveMomentEstimation adaptive_moment_estimation(&sum_squared_error);
+        AdaptiveMomentEstimation::OptimizationData optimization_data(&adaptive_moment_estimation);
+
+        optimization_data.iteration = 1;
+
+        benchmark.run("optimization_algorithm/update_iteration/adaptive_moment_estimation", parameters_number, [&]()
+        {
+            adaptive_moment_estimation.update_iteration(back_propagation, optimization_data);
+        });
+    }
+
+    // Epochs
+
+    const Tensor<type, 1> parameters = neural_network.get_parameters();
+
+    TrainingStrategy training_strategy(&neural_network, &data_set);
+    training_strategy.set_loss_method(TrainingStrategy::NORMALIZED_SQUARED_ERROR);
+    training_strategy.get_normalized_squared_error_pointer()->set_normalization_coefficient();
+    training_strategy.set_display(false);
+    training_strategy.set_maximum_epochs_number(1);
+
+    const Index optimization_methods_number = 4;
+
+    const TrainingStrategy::OptimizationMethod optimization_methods[optimization_methods_number]
+            = {TrainingStrategy::GRADIENT_DESCENT,
+               TrainingStrategy::CONJUGATE_GRADIENT,
+               TrainingStrategy::QUASI_NEWTON_METHOD,
+               TrainingStrategy::LEVENBERG_MARQUARDT_ALGORITHM};
+
+    const string optimization_methods_names[optimization_methods_number]
+            = {"gradient_descent", "conjugate_gradient", "quasi_newton_method", "levenberg_marquardt_algorithm"};
+
+    for(Index i = 0; i < optimization_methods_number; i++)
+    {
+        training_strategy.set_optimization_method(optimization_methods[i]);
+
+        benchmark.run("optimization_algorithm/epoch/" + optimization_methods_names[i], instances_number, [&]()
+        {
+            Tensor<type, 1> initial_parameters = parameters;
+
+            neural_network.set_parameters(initial_parameters);
+
+            training_strategy.perform_training();
+        });
+    }
+}
+
+
+/// Benchmarks the descriptives, histograms and correlations of the variables.
+
+void benchmark_statistics(Benchmark& benchmark, ThreadPoolDevice* thread_pool_device)
+{
+    const Index instances_number = 10000*benchmark.get_scale();
+    const Index variables_number = 20;
+
+    DataSet data_set;
+    data_set.generate_Rosenbrock_data(instances_number, variables_number);
+
+    const Tensor<type, 2>& data = data_set.get_data();
+
+    const Tensor<type, 1> x = data.chip(0, 1);
+    const Tensor<type, 1> y = data.chip(variables_number-1, 1);
+
+    benchmark.run("statistics/descriptives/" + to_string(instances_number) + "x" + to_string(variables_number), data.size(), [&]()
+    {
+        descriptives(data);
+    });
+
+    benchmark.run("statistics/histogram/10", instances_number, [&]()
+    {
+        histogram(x, 10);
+    });
+
+    benchmark.run("statistics/box_plot", instances_number, [&]()
+    {
+        box_plot(x);
+    });
+
+    benchmark.run("correlations/linear_correlation", instances_number, [&]()
+    {
+        linear_correlation(thread_pool_device, x, y);
+    });
+
+    benchmark.run("correlations/rank_linear_correlation", instances_number, [&]()
+    {
+        rank_linear_correlation(thread_pool_device, x, y);
+    });
+
+    benchmark.run("correlations/input_target_columns_correlations", data.size(), [&]()
+    {
+        data_set.calculate_input_target_columns_correlations_values();
+    });
+
+    benchmark.run("correlations/input_columns_correlations", data.size(), [&]()
+    {
+        data_set.calculate_input_columns_correlations();
+    });
+}
+
+
+/// Benchmarks the testing analysis of an approximation and a classification neural network.
+
+void benchmark_testing_analysis(Benchmark& benchmark)
+{
+    const Index instances_number = 10000*benchmark.get_scale();
+    const Index inputs_number = 10;
+    const Index targets_number = 3;
+
+    DataSet data_set;
+    set_classification_data(data_set, instances_number, inputs_number, targets_number);
+    data_set.split_instances_random();
+
+    const Index testing_instances_number = data_set.get_testing_instances_number();
+
+    Tensor<Index, 1> architecture(3);
+    architecture.setValues({inputs_number, 10, targets_number});
+
+    NeuralNetwork approximation_neural_network(NeuralNetwork::Approximation, architecture);
+    NeuralNetwork classification_neural_network(NeuralNetwork::Classification, architecture);
+
+    TestingAnalysis approximation_testing_analysis(&approximation_neural_network, &data_set);
+    TestingAnalysis classification_testing_analysis(&classification_neural_network, &data_set);
+
+    benchmark.run("testing_analysis/calculate_errors", instances_number, [&]()
+    {
+        approximation_testing_analysis.calculate_errors();
+    });
+
+    benchmark.run("testing_analysis/linear_regression", testing_instances_number, [&]()
+    {
+        approximation_testing_analysis.linear_regression();
+    });
+
+    benchmark.run("testing_analysis/calculate_confusion", testing_instances_number, [&]()
+    {
+        classification_testing_analysis.calculate_confusion();
+    });
+}
+
+
+/// Benchmarks complete trainings on the bundled data sets and on synthetic data sets.
+
+void benchmark_training(Benchmark& benchmark, const string& datasets_directory)
+{
+    const Index scale = benchmark.get_scale();
+
+    // Bundled data sets
+
+    const Index files_number = 2;
+
+    const string files_names[files_number] = {"iris.data", "urinary_inflammations.csv"};
+    const char separators[files_number] = {',', ';'};
+    const bool columns_names[files_number] = {false, true};
+    const Index targets_numbers[files_number] = {1, 2};
+
+    for(Index i = 0; i < files_number; i++)
+    {
+        const string name = "training/quasi_newton_method/" + files_names[i];
+
+        if(!benchmark.is_selected(name)) continue;
+
+        const string file_name = datasets_directory + "/" + files_names[i];
+
+        try
+        {
+            DataSet data_set(file_name, separators[i], columns_names[i]);
+
+            const Index columns_number = data_set.get_columns_number();
+
+            for(Index j = 0; j < targets_numbers[i]; j++)
+            {
+                data_set.set_column_use(columns_number-1-j, DataSet::Target);
+            }
+
+            data_set.split_instances_random();
+
+            Tensor<Index, 1> architecture(3);
+            architecture.setValues({data_set.get_input_variables_number(), 10, data_set.get_target_variables_number()});
+
+            NeuralNetwork neural_network(NeuralNetwork::Classification, architecture);
+
+            const Tensor<type, 1> parameters = neural_network.get_parameters();
+
+            TrainingStrategy training_strategy(&neural_network, &data_set);
+            training_strategy.set_loss_method(TrainingStrategy::NORMALIZED_SQUARED_ERROR);
+            training_strategy.get_normalized_squared_error_pointer()->set_normalization_coefficient();
+            training_strategy.set_optimization_method(TrainingStrategy::QUASI_NEWTON_METHOD);
+            training_strategy.set_maximum_epochs_number(100);
+            training_strategy.set_display(false);
+
+            benchmark.run(name, 100*data_set.get_training_instances_number(), [&]()
+            {
+                Tensor<type, 1> initial_parameters = parameters;
+
+                neural_network.set_parameters(initial_parameters);
+
+                training_strategy.perform_training();
+            });
+        }
+        catch(const logic_error& e)
+        {
+            cerr << "Skipping " << file_name << ":\n" << e.what() << endl;
+        }
+    }
+
+    // Synthetic data sets
+
+    {
+        const Index instances_number = 10000*scale;
+
+        DataSet data_set;
+        data_set.generate_Rosenbrock_data(instances_number, 11);
+        data_set.split_instances_random();
+
+        Tensor<Index, 1> architecture(3);
+        architecture.setValues({10, 20, 1});
+
+        NeuralNetwork neural_network(NeuralNetwork::Approximation, architecture);
+
+        const Tensor<type, 1> parameters = neural_network.get_parameters();
+
+        TrainingStrategy training_strategy(&neural_network, &data_set);
+        training_strategy.set_loss_method(TrainingStrategy::MEAN_SQUARED_ERROR);
+        training_strategy.set_optimization_method(TrainingStrategy::ADAPTIVE_MOMENT_ESTIMATION);
+        training_strategy.set_maximum_epochs_number(10);
+        training_strategy.set_display(false);
+
+        benchmark.run("training/adaptive_moment_estimation/rosenbrock_" + to_string(instances_number), 10*data_set.get_training_instances_number(), [&]()
+        {
+            Tensor<type, 1> initial_parameters = parameters;
+
+            neural_network.set_parameters(initial_parameters);
+
+            training_strategy.perform_training();
+        });
+    }
+
+    {
+        const Index instances_number = 10000*scale;
+        const Index inputs_number = 20;
+        const Index targets_number = 4;
+
+        DataSet data_set;
+        set_classification_data(data_set, instances_number, inputs_number, targets_number);
+        data_set.split_instances_random();
+
+        Tensor<Index, 1> architecture(3);
+        architecture.setValues({inputs_number, 20, targets_number});
+
+        NeuralNetwork neural_network(NeuralNetwork::Classification, architecture);
+
+        const Tensor<type, 1> parameters = neural_network.get_parameters();
+
+        TrainingStrategy training_strategy(&neural_network, &data_set);
+        training_strategy.set_loss_method(TrainingStrategy::CROSS_ENTROPY_ERROR);
+        training_strategy.set_optimization_method(TrainingStrategy::STOCHASTIC_GRADIENT_DESCENT);
+        training_strategy.set_maximum_epochs_number(10);
+        training_strategy.set_display(false);
+
+        benchmark.run("training/stochastic_gradient_descent/classification_" + to_string(instances_number), 10*data_set.get_training_instances_number(), [&]()
+        {
+            Tensor<type, 1> initial_parameters = parameters;
+
+            neural_network.set_parameters(initial_parameters);
+
+            training_strategy.perform_training();
+        });
+    }
+}
+
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        Benchmark benchmark;
+
+        string datasets_directory = OPENNN_DATASETS_DIRECTORY;
+        string output_file_name = "benchmarks.json";
+
+        for(int i = 1; i < argc; i++)
+        {
+            const string argument = argv[i];
+
+            if(i + 1 == argc)
+            {
+                cout << "Usage: benchmarks [--filter name] [--repetitions number] [--minimum-time seconds]\n"
+                     << "                  [--scale number] [--seed number] [--datasets directory] [--output file]" << endl;
+
+                return 1;
+            }
+
+            const string value = argv[++i];
+
+            if(argument == "--filter") benchmark.set_filter(value);
+            else if(argument == "--repetitions") benchmark.set_repetitions_number(atol(value.c_str()));
+            else if(argument == "--minimum-time") benchmark.set_minimum_time(atof(value.c_str()));
+            else if(argument == "--scale") benchmark.set_scale(atol(value.c_str()));
+            else if(argument == "--seed") benchmark.set_seed(static_cast<unsigned>(atol(value.c_str())));
+            else if(argument == "--datasets") datasets_directory = value;
+            else if(argument == "--output") output_file_name = value;
+            else
+            {
+                cout << "Unknown argument: " << argument << endl;
+
+                return 1;
+            }
+        }
+
+        cout << "OpenNN. Benchmarks." << endl;
+
+        // Device
+
+        const int n = omp_get_max_threads();
+        NonBlockingThreadPool* non_blocking_thread_pool = new NonBlockingThreadPool(n);
+        ThreadPoolDevice* thread_pool_device = new ThreadPoolDevice(non_blocking_thread_pool, n);
+
+        srand(benchmark.get_seed());
+
+        benchmark_data_set(benchmark, datasets_directory);
+        benchmark_layers(benchmark);
+        benchmark_losses(benchmark);
+        benchmark_optimizers(benchmark);
+        benchmark_statistics(benchmark, thread_pool_device);
+        benchmark_testing_analysis(benchmark);
+        benchmark_training(benchmark, datasets_directory);
+
+        benchmark.save_JSON(output_file_name);
+
+        cout << "Results saved to " << output_file_name << endl;
+
+        delete thread_pool_device;
+        delete non_blocking_thread_pool;
+
+        return 0;
+    }
+    catch(exception& e)
+    {
+        cerr << e.what() << endl;
+
+        return 1;
+    }
+}
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
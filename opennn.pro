@@ -18,6 +18,14 @@ SUBDIRS += opennn
 
 SUBDIRS += tests
 SUBDIRS += examples
+SUBDIRS += benchmarks
+
+# The model server uses POSIX sockets, so it is only built with CONFIG+=opennn_serve
+
+CONFIG(opennn_serve) {
+SUBDIRS += serve
+}
+
 SUBDIRS += blank
 
 CONFIG += ordered
@@ -104,6 +104,14 @@ const type& AdaptiveMomentEstimation::get_maximum_time() const
 }
 
 
+/// Returns the maximum number of epochs for training.
+
+const Index& AdaptiveMomentEstimation::get_maximum_epochs_number() const
+{
+    return maximum_epochs_number;
+}
+
+
 /// Returns true if the final model will be the neural network with the minimum selection error, false otherwise.
 
 const bool& AdaptiveMomentEstimation::get_choose_best_selection() const
@@ -352,7 +360,14 @@ OptimizationAlgorithm::Results AdaptiveMomentEstimation::perform_training()
     DataSet::Batch training_batch(batch_instances_number, data_set_pointer);
 
     DataSet::Batch selection_batch(selection_instances_number, data_set_pointer);
-    selection_batch.fill(selection_instances_indices, input_variables_indices, target_variables_indices);
+
+    start_profile();
+
+    {
+        OPENNN_PROFILE_SCOPE(&profiler, TrainingProfiler::BatchFill);
+
+        selection_batch.fill(selection_instances_indices, input_variables_indices, target_variables_indices);
+    }
 
     // Neural network
 
@@ -399,13 +414,49 @@ OptimizationAlgorithm::Results AdaptiveMomentEstimation::perform_training()
     || neural_network_pointer->has_recurrent_layer())
         is_forecasting = true;
 
+    // Checkpoint
+
+    TrainingCheckpoint checkpoint;
+
+    Index initial_epoch = 0;
+
+    if(start_checkpoints(checkpoint, results))
+    {
+        initial_epoch = checkpoint.get_epoch();
+
+        beginning_time -= static_cast<time_t>(checkpoint.get_elapsed_time());
+
+        optimization_data.parameters = checkpoint.get_vector("parameters");
+        optimization_data.minimal_selection_parameters = checkpoint.get_vector("optimization_minimal_selection_parameters");
+        optimization_data.last_gradient_exponential_decay = checkpoint.get_vector("last_gradient_exponential_decay");
+        optimization_data.last_square_gradient_exponential_decay = checkpoint.get_vector("last_square_gradient_exponential_decay");
+
+        minimal_selection_parameters = checkpoint.get_vector("minimal_selection_parameters");
+        minimum_selection_error = checkpoint.get_scalar("minimum_selection_error");
+        old_selection_error = checkpoint.get_scalar("old_selection_error");
+        selection_error_increases = checkpoint.get_index("selection_error_increases");
+
+        neural_network_pointer->set_parameters(optimization_data.parameters);
+    }
+
+    // Observers
+
+    begin_observers();
+
+    TrainingObserver::Metrics metrics;
+
+    bool stop_requested = false;
+
     // Main loop
 
-    for(Index epoch = 0; epoch <= maximum_epochs_number; epoch++)
+    for(Index epoch = initial_epoch; epoch <= maximum_epochs_number; epoch++)
     {
+        begin_epoch_profile(epoch);
+
         const Tensor<Index, 2> training_batches = data_set_pointer->get_batches(training_instances_indices,
                                                                                          batch_instances_number,
-                                                                                         is_forecasting);
+                                                                                         is_forecasting,
+                                                                                         get_epoch_random_generator(epoch));
         const Index batches_number = training_batches.dimension(0);
 
         parameters_norm = l2_norm(optimization_data.parameters);
@@ -417,11 +468,24 @@ OptimizationAlgorithm::Results AdaptiveMomentEstimation::perform_training()
 
         for(Index iteration = 0; iteration < batches_number; iteration++)
         {
+            // Training control
+
+            if(iteration != 0 && check_training_control())
+            {
+                stop_requested = true;
+
+                break;
+            }
+
             optimization_data.iteration++;
 
             // Data set
 
-            training_batch.fill(training_batches.chip(iteration, 0), input_variables_indices, target_variables_indices);
+            {
+                OPENNN_PROFILE_SCOPE(&profiler, TrainingProfiler::BatchFill);
+
+                training_batch.fill(training_batches.chip(iteration, 0), input_variables_indices, target_variables_indices);
+            }
 
             // Neural network
 
@@ -436,15 +500,42 @@ OptimizationAlgorithm::Results AdaptiveMomentEstimation::perform_training()
 
             // Gradient
 
-            update_iteration(training_back_propagation, optimization_data);
+            {
+                OPENNN_PROFILE_SCOPE(&profiler, TrainingProfiler::UpdateIteration);
+
+                update_iteration(training_back_propagation, optimization_data);
+            }
+
+            {
+                OPENNN_PROFILE_SCOPE(&profiler, TrainingProfiler::SetParameters);
+
+                neural_network_pointer->set_parameters(optimization_data.parameters);
+            }
 
-            neural_network_pointer->set_parameters(optimization_data.parameters);
+            if(has_observers())
+            {
+                learning_rate = initial_learning_rate*
+                        sqrt(1 - pow(beta_2, static_cast<type>(optimization_data.iteration)))/
+                        (1 - pow(beta_1, static_cast<type>(optimization_data.iteration)));
+
+                metrics.epoch = epoch;
+                metrics.iteration = iteration;
+                metrics.iterations_number = epoch*batches_number + iteration + 1;
+                metrics.instances_number = batch_instances_number;
+                metrics.training_loss = training_back_propagation.loss;
+                metrics.training_error = training_back_propagation.error;
+                metrics.selection_error = numeric_limits<type>::quiet_NaN();
+                metrics.gradient_norm = l2_norm(training_back_propagation.gradient);
+                metrics.learning_rate = learning_rate;
+
+                notify_iteration(metrics);
+            }
         }
 
         // Loss
 
-        training_loss /= static_cast<type>(batches_number);
-        training_error /= static_cast<type>(batches_number);
+        training_loss /= static_cast<type>(optimization_data.iteration);
+        training_error /= static_cast<type>(optimization_data.iteration);
 
         if(has_selection)
         {
@@ -505,6 +596,30 @@ OptimizationAlgorithm::Results AdaptiveMomentEstimation::perform_training()
             results.stopping_condition  = LossGoal;
         }
 
+        if(!stop_training && (stop_requested || check_training_control()))
+        {
+            if(display) cout << "Epoch " << epoch+1 << ": Stop requested.\n";
+
+            stop_training = true;
+
+            results.stopping_condition = StopRequested;
+        }
+
+        if(has_observers())
+        {
+            metrics.epoch = epoch;
+            metrics.iteration = optimization_data.iteration;
+            metrics.iterations_number = epoch*batches_number + optimization_data.iteration;
+            metrics.instances_number = optimization_data.iteration*batch_instances_number;
+            metrics.training_loss = training_loss;
+            metrics.training_error = training_error;
+            metrics.selection_error = has_selection ? selection_back_propagation.error : numeric_limits<type>::quiet_NaN();
+            metrics.gradient_norm = l2_norm(training_back_propagation.gradient);
+            metrics.learning_rate = learning_rate;
+
+            notify_epoch(metrics);
+        }
+
         if(epoch != 0 && epoch % save_period == 0)
         {
             neural_network_pointer->save(neural_network_file_name);
@@ -559,8 +674,29 @@ OptimizationAlgorithm::Results AdaptiveMomentEstimation::perform_training()
         old_selection_error = selection_back_propagation.error;
 
         if(stop_training) break;
+
+        if(is_checkpoint_epoch(epoch+1))
+        {
+            checkpoint.set_vector("parameters", optimization_data.parameters);
+            checkpoint.set_vector("optimization_minimal_selection_parameters", optimization_data.minimal_selection_parameters);
+            checkpoint.set_vector("last_gradient_exponential_decay", optimization_data.last_gradient_exponential_decay);
+            checkpoint.set_vector("last_square_gradient_exponential_decay", optimization_data.last_square_gradient_exponential_decay);
+
+            checkpoint.set_vector("minimal_selection_parameters", minimal_selection_parameters);
+            checkpoint.set_scalar("minimum_selection_error", minimum_selection_error);
+            checkpoint.set_scalar("old_selection_error", old_selection_error);
+            checkpoint.set_index("selection_error_increases", selection_error_increases);
+
+            write_checkpoint(checkpoint, results, epoch+1, elapsed_time);
+        }
     }
 
+    wait_checkpoint();
+
+    finish_profile(results);
+
+    end_observers(results);
+
     if(choose_best_selection)
     {
         optimization_data.parameters = optimization_data.minimal_selection_parameters;
@@ -916,6 +1052,10 @@ void AdaptiveMomentEstimation::write_XML(tinyxml2::XMLPrinter& file_stream) cons
 
     file_stream.CloseElement();
 
+    // Checkpoints
+
+    write_checkpoints_XML(file_stream);
+
     file_stream.CloseElement();
 }
 
@@ -1067,6 +1207,10 @@ void AdaptiveMomentEstimation::from_XML(const tinyxml2::XMLDocument& document)
             }
         }
     }
+
+    // Checkpoints
+
+    checkpoints_from_XML(root_element);
 }
 
 
@@ -0,0 +1,265 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   A S Y N C   T R A I N I N G   O B S E R V E R   C L A S S
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#include "async_training_observer.h"
+
+namespace OpenNN
+{
+
+/// Constructor. It starts the worker thread.
+/// @param new_maximum_queue_size Maximum number of pending events.
+
+AsyncTrainingObserver::AsyncTrainingObserver(const Index& new_maximum_queue_size) : TrainingObserver()
+{
+    if(new_maximum_queue_size <= 0)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: AsyncTrainingObserver class.\n"
+               << "explicit AsyncTrainingObserver(const Index&) constructor.\n"
+               << "Maximum queue size (" << new_maximum_queue_size << ") must be greater than 0.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    maximum_queue_size = new_maximum_queue_size;
+
+    worker = thread(&AsyncTrainingObserver::run, this);
+}
+
+
+/// Destructor. It stops the worker thread if the derived class has not done it.
+
+AsyncTrainingObserver::~AsyncTrainingObserver()
+{
+    stop();
+}
+
+
+/// Returns the maximum number of pending events.
+
+Index AsyncTrainingObserver::get_maximum_queue_size() const
+{
+    return maximum_queue_size;
+}
+
+
+/// Returns the number of iteration events which have been dropped because the queue was full.
+
+Index AsyncTrainingObserver::get_dropped_events_number() const
+{
+    lock_guard<mutex> lock(events_mutex);
+
+    return dropped_events_number;
+}
+
+
+/// Returns a string with the name of a type of event.
+
+string AsyncTrainingObserver::write_event_type(const EventType& event_type)
+{
+    switch(event_type)
+    {
+    case TrainingBegin: return "training_begin";
+
+    case Iteration: return "iteration";
+
+    case Epoch: return "epoch";
+
+    case TrainingEnd: return "training_end";
+    }
+
+    return string();
+}
+
+
+/// Queues the beginning of a training.
+
+void AsyncTrainingObserver::on_training_begin(const string& optimization_algorithm_type)
+{
+    Event event;
+
+    event.type = TrainingBegin;
+    event.text = optimization_algorithm_type;
+
+    push(event);
+}
+
+
+/// Queues an iteration. It is dropped if the queue is full.
+
+void AsyncTrainingObserver::on_iteration(const Metrics& metrics)
+{
+    Event event;
+
+    event.type = Iteration;
+    event.metrics = metrics;
+
+    push(event);
+}
+
+
+/// Queues an epoch.
+
+void AsyncTrainingObserver::on_epoch(const Metrics& metrics)
+{
+    Event event;
+
+    event.type = Epoch;
+    event.metrics = metrics;
+
+    push(event);
+}
+
+
+/// Queues the end of a training.
+
+void AsyncTrainingObserver::on_training_end(const Metrics& metrics, const string& stopping_condition)
+{
+    Event event;
+
+    event.type = TrainingEnd;
+    event.metrics = metrics;
+    event.text = stopping_condition;
+
+    push(event);
+}
+
+
+/// Blocks the calling thread until all the queued events have been written.
+
+void AsyncTrainingObserver::flush()
+{
+    unique_lock<mutex> lock(events_mutex);
+
+    flushed_condition.wait(lock, [this]{return (events.empty() && !writing) || !running;});
+}
+
+
+/// Writes the pending events and stops the worker thread. Later events are ignored.
+/// The derived classes must call it in their destructors.
+
+void AsyncTrainingObserver::stop()
+{
+    {
+        lock_guard<mutex> lock(events_mutex);
+
+        if(!running) return;
+
+        running = false;
+    }
+
+    events_condition.notify_all();
+
+    if(worker.joinable()) worker.join();
+
+    flushed_condition.notify_all();
+}
+
+
+/// Writes a number, or a given text if the number is NaN.
+/// @param stream Output stream.
+/// @param value Number to be written.
+/// @param nan_text Text written for NaN values.
+
+void AsyncTrainingObserver::write_number(ostream& stream, const type& value, const string& nan_text)
+{
+    if(isnan(value))
+    {
+        stream << nan_text;
+    }
+    else
+    {
+        stream << value;
+    }
+}
+
+
+/// Adds an event to the queue and wakes up the worker thread. It never waits for the writing of events.
+
+void AsyncTrainingObserver::push(const Event& event)
+{
+    {
+        lock_guard<mutex> lock(events_mutex);
+
+        if(!running) return;
+
+        if(event.type == Iteration && static_cast<Index>(events.size()) >= maximum_queue_size)
+        {
+            dropped_events_number++;
+
+            return;
+        }
+
+        events.push_back(event);
+    }
+
+    events_condition.notify_one();
+}
+
+
+/// Loop of the worker thread. It takes all the pending events at once and writes them without holding the lock.
+/// The events pending when the observer is stopped are also written.
+
+void AsyncTrainingObserver::run()
+{
+    deque<Event> taken_events;
+
+    while(true)
+    {
+        {
+            unique_lock<mutex> lock(events_mutex);
+
+            writing = false;
+
+            if(events.empty()) flushed_condition.notify_all();
+
+            events_condition.wait(lock, [this]{return !events.empty() || !running;});
+
+            if(events.empty() && !running) return;
+
+            taken_events.swap(events);
+
+            writing = true;
+        }
+
+        for(size_t i = 0; i < taken_events.size(); i++)
+        {
+            try
+            {
+                write_event(taken_events[i]);
+            }
+            catch(const exception& e)
+            {
+                cerr << e.what() << endl;
+            }
+        }
+
+        taken_events.clear();
+    }
+}
+
+}
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
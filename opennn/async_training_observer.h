@@ -0,0 +1,174 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   A S Y N C   T R A I N I N G   O B S E R V E R   C L A S S   H E A D E R
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#ifndef ASYNCTRAININGOBSERVER_H
+#define ASYNCTRAININGOBSERVER_H
+
+// System includes
+
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+// OpenNN includes
+
+#include "config.h"
+#include "training_observer.h"
+
+using namespace std;
+using namespace Eigen;
+
+namespace OpenNN
+{
+
+/// This abstract class processes the training metrics on a thread of its own, so that it never blocks the training thread.
+
+///
+/// The callbacks only copy the metrics into a bounded queue. When the queue is full, the iteration events are dropped and counted,
+/// while the events of epochs, beginnings and ends of trainings are always kept.
+/// The derived classes implement write_event(), which runs on the worker thread, and must call stop() in their destructors,
+/// so that the pending events are written before their members are destroyed.
+
+class AsyncTrainingObserver : public TrainingObserver
+{
+
+public:
+
+   /// Enumeration of the types of events.
+
+   enum EventType{TrainingBegin, Iteration, Epoch, TrainingEnd};
+
+   /// This structure contains an event queued for the worker thread.
+
+   struct Event
+   {
+       /// Type of the event.
+
+       EventType type = Iteration;
+
+       /// Metrics of the event.
+
+       Metrics metrics;
+
+       /// Optimization algorithm type for the beginnings, or stopping condition for the ends.
+
+       string text;
+   };
+
+   // Constructors
+
+   explicit AsyncTrainingObserver(const Index& = 10000);
+
+   // Destructor
+
+   virtual ~AsyncTrainingObserver();
+
+   // Get methods
+
+   Index get_maximum_queue_size() const;
+
+   Index get_dropped_events_number() const;
+
+   static string write_event_type(const EventType&);
+
+   // Callback methods
+
+   void on_training_begin(const string&);
+
+   void on_iteration(const Metrics&);
+
+   void on_epoch(const Metrics&);
+
+   void on_training_end(const Metrics&, const string&);
+
+   // Worker methods
+
+   void flush();
+
+   void stop();
+
+protected:
+
+   /// Processes an event on the worker thread.
+
+   virtual void write_event(const Event&) = 0;
+
+   static void write_number(ostream&, const type&, const string&);
+
+private:
+
+   void push(const Event&);
+
+   void run();
+
+   // MEMBERS
+
+   /// Maximum number of pending events.
+
+   Index maximum_queue_size;
+
+   /// Pending events.
+
+   deque<Event> events;
+
+   /// Number of iteration events dropped because the queue was full.
+
+   Index dropped_events_number = 0;
+
+   /// True while the worker thread writes events taken from the queue.
+
+   bool writing = false;
+
+   /// True until stop() is called.
+
+   bool running = true;
+
+   /// Mutex of the queue and the flags.
+
+   mutable mutex events_mutex;
+
+   /// Condition variable which wakes up the worker thread.
+
+   condition_variable events_condition;
+
+   /// Condition variable which wakes up the threads waiting in flush().
+
+   condition_variable flushed_condition;
+
+   /// Worker thread.
+
+   thread worker;
+};
+
+}
+
+#endif
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
@@ -0,0 +1,1192 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   B A T C H   P R E D I C T O R   C L A S S
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#include "batch_predictor.h"
+
+namespace OpenNN
+{
+
+/// Default constructor.
+/// It creates a batch predictor not associated to any neural network.
+
+BatchPredictor::BatchPredictor()
+{
+    set();
+}
+
+
+/// Neural network constructor.
+/// @param new_neural_network_pointer Pointer to the neural network which calculates the outputs.
+
+BatchPredictor::BatchPredictor(NeuralNetwork* new_neural_network_pointer)
+{
+    set(new_neural_network_pointer);
+}
+
+
+/// Destructor.
+
+BatchPredictor::~BatchPredictor()
+{
+}
+
+
+/// Returns a pointer to the neural network which calculates the outputs.
+
+NeuralNetwork* BatchPredictor::get_neural_network_pointer() const
+{
+    return neural_network_pointer;
+}
+
+
+/// Returns the format of the inputs file.
+
+const BatchPredictor::FileFormat& BatchPredictor::get_inputs_file_format() const
+{
+    return inputs_file_format;
+}
+
+
+/// Returns a string with the name of the format of the inputs file.
+
+string BatchPredictor::write_inputs_file_format() const
+{
+    return inputs_file_format == CSV ? "CSV" : "Binary";
+}
+
+
+/// Returns the format of the outputs file.
+
+const BatchPredictor::FileFormat& BatchPredictor::get_outputs_file_format() const
+{
+    return outputs_file_format;
+}
+
+
+/// Returns a string with the name of the format of the outputs file.
+
+string BatchPredictor::write_outputs_file_format() const
+{
+    return outputs_file_format == CSV ? "CSV" : "Binary";
+}
+
+
+/// Returns the separator of the CSV files.
+
+const char& BatchPredictor::get_separator() const
+{
+    return separator;
+}
+
+
+/// Returns true if the CSV files have a header with the names of the columns, and false otherwise.
+
+const bool& BatchPredictor::get_has_columns_names() const
+{
+    return has_columns_names;
+}
+
+
+/// Returns the indices of the columns of the inputs which are the inputs of the neural network.
+/// An empty vector means all the columns of the inputs files, or the input variables of the data sets.
+
+const Tensor<Index, 1>& BatchPredictor::get_input_variables_indices() const
+{
+    return input_variables_indices;
+}
+
+
+/// Returns the number of instances of each chunk.
+
+const Index& BatchPredictor::get_chunk_instances_number() const
+{
+    return chunk_instances_number;
+}
+
+
+/// Returns the number of worker threads.
+
+const Index& BatchPredictor::get_workers_number() const
+{
+    return workers_number;
+}
+
+
+/// Returns the number of threads of the thread pools of the copy of the neural network of each worker.
+
+const Index& BatchPredictor::get_worker_threads_number() const
+{
+    return worker_threads_number;
+}
+
+
+/// Returns true if messages from this class are to be displayed on the screen, or false if messages
+/// from this class are not to be displayed on the screen.
+
+const bool& BatchPredictor::get_display() const
+{
+    return display;
+}
+
+
+/// Sets a batch predictor not associated to any neural network, with the default values.
+
+void BatchPredictor::set()
+{
+    neural_network_pointer = nullptr;
+
+    set_default();
+}
+
+
+/// Sets a batch predictor associated to a neural network, with the default values.
+/// @param new_neural_network_pointer Pointer to the neural network which calculates the outputs.
+
+void BatchPredictor::set(NeuralNetwork* new_neural_network_pointer)
+{
+    neural_network_pointer = new_neural_network_pointer;
+
+    set_default();
+}
+
+
+/// Sets the members of the batch predictor to their default values:
+/// <ul>
+/// <li> CSV inputs and outputs files, separated by commas and without columns names.
+/// <li> All the columns of the inputs as inputs of the neural network.
+/// <li> Chunks of 1000 instances.
+/// <li> As many workers as OpenMP threads, with one thread each.
+/// <li> Display: true.
+/// </ul>
+
+void BatchPredictor::set_default()
+{
+    inputs_file_format = CSV;
+    outputs_file_format = CSV;
+
+    separator = ',';
+
+    has_columns_names = false;
+
+    input_variables_indices.resize(0);
+
+    chunk_instances_number = 1000;
+
+    workers_number = omp_get_max_threads();
+
+    worker_threads_number = 1;
+
+    display = true;
+}
+
+
+/// Sets a new neural network to calculate the outputs.
+/// @param new_neural_network_pointer Pointer to the neural network.
+
+void BatchPredictor::set_neural_network_pointer(NeuralNetwork* new_neural_network_pointer)
+{
+    neural_network_pointer = new_neural_network_pointer;
+}
+
+
+/// Sets a new format of the inputs file.
+/// @param new_inputs_file_format Format of the inputs file.
+
+void BatchPredictor::set_inputs_file_format(const FileFormat& new_inputs_file_format)
+{
+    inputs_file_format = new_inputs_file_format;
+}
+
+
+/// Sets a new format of the inputs file from a string.
+/// @param new_inputs_file_format String with the name of the format("CSV" or "Binary").
+
+void BatchPredictor::set_inputs_file_format(const string& new_inputs_file_format)
+{
+    if(new_inputs_file_format == "CSV")
+    {
+        set_inputs_file_format(CSV);
+    }
+    else if(new_inputs_file_format == "Binary")
+    {
+        set_inputs_file_format(Binary);
+    }
+    else
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: BatchPredictor class.\n"
+               << "void set_inputs_file_format(const string&) method.\n"
+               << "Unknown file format: " << new_inputs_file_format << ".\n";
+
+        throw logic_error(buffer.str());
+    }
+}
+
+
+/// Sets a new format of the outputs file.
+/// @param new_outputs_file_format Format of the outputs file.
+
+void BatchPredictor::set_outputs_file_format(const FileFormat& new_outputs_file_format)
+{
+    outputs_file_format = new_outputs_file_format;
+}
+
+
+/// Sets a new format of the outputs file from a string.
+/// @param new_outputs_file_format String with the name of the format("CSV" or "Binary").
+
+void BatchPredictor::set_outputs_file_format(const string& new_outputs_file_format)
+{
+    if(new_outputs_file_format == "CSV")
+    {
+        set_outputs_file_format(CSV);
+    }
+    else if(new_outputs_file_format == "Binary")
+    {
+        set_outputs_file_format(Binary);
+    }
+    else
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: BatchPredictor class.\n"
+               << "void set_outputs_file_format(const string&) method.\n"
+               << "Unknown file format: " << new_outputs_file_format << ".\n";
+
+        throw logic_error(buffer.str());
+    }
+}
+
+
+/// Sets a new separator of the CSV files.
+/// @param new_separator Separator character.
+
+void BatchPredictor::set_separator(const char& new_separator)
+{
+    separator = new_separator;
+}
+
+
+/// Sets whether the CSV files have a header with the names of the columns.
+/// The header of the outputs file has the names of the outputs of the neural network.
+/// @param new_has_columns_names True if the CSV files have columns names, and false otherwise.
+
+void BatchPredictor::set_has_columns_names(const bool& new_has_columns_names)
+{
+    has_columns_names = new_has_columns_names;
+}
+
+
+/// Sets the indices of the columns of the inputs which are the inputs of the neural network, in the order of the inputs.
+/// @param new_input_variables_indices Indices of the columns, or an empty vector for all the columns of the inputs files,
+/// or the input variables of the data sets.
+
+void BatchPredictor::set_input_variables_indices(const Tensor<Index, 1>& new_input_variables_indices)
+{
+    for(Index i = 0; i < new_input_variables_indices.size(); i++)
+    {
+        if(new_input_variables_indices(i) < 0)
+        {
+            ostringstream buffer;
+
+            buffer << "OpenNN Exception: BatchPredictor class.\n"
+                   << "void set_input_variables_indices(const Tensor<Index, 1>&) method.\n"
+                   << "Input variable index (" << new_input_variables_indices(i) << ") must be positive.\n";
+
+            throw logic_error(buffer.str());
+        }
+    }
+
+    input_variables_indices = new_input_variables_indices;
+}
+
+
+/// Sets the number of instances of each chunk.
+/// Larger chunks make better use of the matrix products, and smaller chunks use less memory.
+/// @param new_chunk_instances_number Number of instances of each chunk.
+
+void BatchPredictor::set_chunk_instances_number(const Index& new_chunk_instances_number)
+{
+    if(new_chunk_instances_number <= 0)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: BatchPredictor class.\n"
+               << "void set_chunk_instances_number(const Index&) method.\n"
+               << "Number of instances of each chunk must be greater than 0.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    chunk_instances_number = new_chunk_instances_number;
+}
+
+
+/// Sets the number of worker threads.
+/// @param new_workers_number Number of workers.
+
+void BatchPredictor::set_workers_number(const Index& new_workers_number)
+{
+    if(new_workers_number <= 0)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: BatchPredictor class.\n"
+               << "void set_workers_number(const Index&) method.\n"
+               << "Number of workers must be greater than 0.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    workers_number = new_workers_number;
+}
+
+
+/// Sets the number of threads of the thread pools of the copy of the neural network of each worker.
+/// @param new_worker_threads_number Number of threads per worker.
+
+void BatchPredictor::set_worker_threads_number(const Index& new_worker_threads_number)
+{
+    if(new_worker_threads_number <= 0)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: BatchPredictor class.\n"
+               << "void set_worker_threads_number(const Index&) method.\n"
+               << "Number of threads per worker must be greater than 0.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    worker_threads_number = new_worker_threads_number;
+}
+
+
+/// Sets a new display value.
+/// If it is set to true messages from this class are to be displayed on the screen;
+/// if it is set to false messages from this class are not to be displayed on the screen.
+/// @param new_display Display value.
+
+void BatchPredictor::set_display(const bool& new_display)
+{
+    display = new_display;
+}
+
+
+/// Calculates the outputs of the neural network for all the instances of an inputs file, and writes them in order to an outputs file.
+/// The formats of the files are given by the inputs and outputs file formats.
+/// Binary outputs of CSV inputs need a first pass over the inputs file to count the instances.
+/// Returns the number of instances.
+/// @param inputs_file_name Name of the inputs file.
+/// @param outputs_file_name Name of the outputs file.
+
+Index BatchPredictor::predict(const string& inputs_file_name, const string& outputs_file_name)
+{
+    check();
+
+    const Index inputs_number = neural_network_pointer->get_inputs_number();
+
+    if(inputs_file_format == CSV)
+    {
+        const Index instances_number = outputs_file_format == Binary ? count_csv_instances(inputs_file_name) : -1;
+
+        ifstream file(inputs_file_name.c_str());
+
+        if(!file.is_open())
+        {
+            ostringstream buffer;
+
+            buffer << "OpenNN Exception: BatchPredictor class.\n"
+                   << "Index predict(const string&, const string&) method.\n"
+                   << "Cannot open inputs file: " << inputs_file_name << "\n";
+
+            throw logic_error(buffer.str());
+        }
+
+        string header;
+
+        if(has_columns_names) getline(file, header);
+
+        const ChunkReader read_chunk = [&](Chunk& chunk)
+        {
+            chunk.lines.resize(static_cast<size_t>(chunk_instances_number));
+
+            Index lines_number = 0;
+
+            while(lines_number < chunk_instances_number && getline(file, chunk.lines[static_cast<size_t>(lines_number)]))
+            {
+                string& line = chunk.lines[static_cast<size_t>(lines_number)];
+
+                if(!line.empty() && line.back() == '\r') line.pop_back();
+
+                if(line.find_first_not_of(" \t") == string::npos) continue;
+
+                lines_number++;
+            }
+
+            chunk.instances_number = lines_number;
+
+            return lines_number != 0;
+        };
+
+        return run(read_chunk, instances_number, outputs_file_name);
+    }
+
+    ifstream file(inputs_file_name.c_str(), ios::binary);
+
+    if(!file.is_open())
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: BatchPredictor class.\n"
+               << "Index predict(const string&, const string&) method.\n"
+               << "Cannot open inputs file: " << inputs_file_name << "\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    Index columns_number = 0;
+    Index rows_number = 0;
+
+    file.read(reinterpret_cast<char*>(&columns_number), sizeof(Index));
+    file.read(reinterpret_cast<char*>(&rows_number), sizeof(Index));
+
+    if(!file || columns_number < get_file_columns_number() || rows_number < 0)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: BatchPredictor class.\n"
+               << "Index predict(const string&, const string&) method.\n"
+               << "Binary inputs file " << inputs_file_name << " has " << columns_number << " columns, "
+               << "but " << get_file_columns_number() << " are needed.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    const streamoff header_size = static_cast<streamoff>(2*sizeof(Index));
+
+    Index first_instance = 0;
+
+    const ChunkReader read_chunk = [&](Chunk& chunk)
+    {
+        const Index instances_number = min(chunk_instances_number, rows_number - first_instance);
+
+        if(instances_number <= 0) return false;
+
+        if(chunk.inputs.dimension(0) != chunk_instances_number || chunk.inputs.dimension(1) != inputs_number)
+        {
+            chunk.inputs.resize(chunk_instances_number, inputs_number);
+        }
+
+        // The binary files are stored by columns, as the tensors
+
+        for(Index j = 0; j < inputs_number; j++)
+        {
+            const Index column_index = input_variables_indices.size() == 0 ? j : input_variables_indices(j);
+
+            file.seekg(header_size + static_cast<streamoff>((column_index*rows_number + first_instance)*static_cast<Index>(sizeof(type))));
+
+            file.read(reinterpret_cast<char*>(chunk.inputs.data() + j*chunk_instances_number),
+                      static_cast<streamsize>(instances_number*static_cast<Index>(sizeof(type))));
+
+            if(!file)
+            {
+                ostringstream buffer;
+
+                buffer << "OpenNN Exception: BatchPredictor class.\n"
+                       << "Index predict(const string&, const string&) method.\n"
+                       << "Cannot read instances " << first_instance << " to " << first_instance + instances_number - 1
+                       << " of binary inputs file " << inputs_file_name << ".\n";
+
+                throw logic_error(buffer.str());
+            }
+        }
+
+        chunk.instances_number = instances_number;
+
+        first_instance += instances_number;
+
+        return true;
+    };
+
+    return run(read_chunk, rows_number, outputs_file_name);
+}
+
+
+/// Calculates the outputs of the neural network for all the instances of a data set, and writes them in order to an outputs file.
+/// The inputs are read from the data matrix of the data set by chunks, without copying the whole inputs matrix.
+/// Returns the number of instances.
+/// @param data_set Data set with the inputs.
+/// @param outputs_file_name Name of the outputs file.
+
+Index BatchPredictor::predict(const DataSet& data_set, const string& outputs_file_name)
+{
+    check();
+
+    const Index inputs_number = neural_network_pointer->get_inputs_number();
+
+    const Tensor<Index, 1> inputs_indices = input_variables_indices.size() == 0
+            ? data_set.get_input_variables_indices()
+            : input_variables_indices;
+
+    const Tensor<type, 2>& data = data_set.get_data();
+
+    const Index rows_number = data.dimension(0);
+
+    bool valid_indices = inputs_indices.size() == inputs_number;
+
+    for(Index i = 0; i < inputs_indices.size(); i++)
+    {
+        if(inputs_indices(i) >= data.dimension(1)) valid_indices = false;
+    }
+
+    if(!valid_indices)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: BatchPredictor class.\n"
+               << "Index predict(const DataSet&, const string&) method.\n"
+               << "Input variables of the data set do not match the " << inputs_number << " inputs of the neural network.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    Index first_instance = 0;
+
+    const ChunkReader read_chunk = [&](Chunk& chunk)
+    {
+        const Index instances_number = min(chunk_instances_number, rows_number - first_instance);
+
+        if(instances_number <= 0) return false;
+
+        if(chunk.inputs.dimension(0) != chunk_instances_number || chunk.inputs.dimension(1) != inputs_number)
+        {
+            chunk.inputs.resize(chunk_instances_number, inputs_number);
+        }
+
+        for(Index j = 0; j < inputs_number; j++)
+        {
+            const type* column = data.data() + inputs_indices(j)*rows_number + first_instance;
+
+            copy(column, column + instances_number, chunk.inputs.data() + j*chunk_instances_number);
+        }
+
+        chunk.instances_number = instances_number;
+
+        first_instance += instances_number;
+
+        return true;
+    };
+
+    return run(read_chunk, rows_number, outputs_file_name);
+}
+
+
+/// Checks that the batch predictor has a neural network with inputs, and that the input variables indices match them.
+
+void BatchPredictor::check() const
+{
+    ostringstream buffer;
+
+    if(!neural_network_pointer)
+    {
+        buffer << "OpenNN Exception: BatchPredictor class.\n"
+               << "void check() const method.\n"
+               << "Pointer to neural network is nullptr.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    const Index inputs_number = neural_network_pointer->get_inputs_number();
+
+    if(inputs_number == 0 || neural_network_pointer->get_layers_number() == 0)
+    {
+        buffer << "OpenNN Exception: BatchPredictor class.\n"
+               << "void check() const method.\n"
+               << "Neural network has no inputs or no layers.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    if(input_variables_indices.size() != 0 && input_variables_indices.size() != inputs_number)
+    {
+        buffer << "OpenNN Exception: BatchPredictor class.\n"
+               << "void check() const method.\n"
+               << "Number of input variables indices (" << input_variables_indices.size() << ") "
+               << "must be equal to the number of inputs (" << inputs_number << ").\n";
+
+        throw logic_error(buffer.str());
+    }
+}
+
+
+/// Returns the minimum number of columns of the inputs files.
+
+Index BatchPredictor::get_file_columns_number() const
+{
+    if(input_variables_indices.size() == 0) return neural_network_pointer->get_inputs_number();
+
+    const Tensor<Index, 0> maximum_index = input_variables_indices.maximum();
+
+    return maximum_index(0) + 1;
+}
+
+
+/// Returns the number of non-empty lines of a CSV file, without the header.
+/// @param file_name Name of the CSV file.
+
+Index BatchPredictor::count_csv_instances(const string& file_name) const
+{
+    ifstream file(file_name.c_str());
+
+    if(!file.is_open())
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: BatchPredictor class.\n"
+               << "Index count_csv_instances(const string&) const method.\n"
+               << "Cannot open inputs file: " << file_name << "\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    string line;
+
+    if(has_columns_names) getline(file, line);
+
+    Index instances_number = 0;
+
+    while(getline(file, line))
+    {
+        if(line.find_first_not_of(" \t\r") != string::npos) instances_number++;
+    }
+
+    return instances_number;
+}
+
+
+/// Reads the chunks, calculates their outputs with the workers and writes them in order to the outputs file.
+/// The reader and the workers run on their own threads, and the outputs are written by the calling thread.
+/// The first error of any thread stops all of them, and it is thrown once they have finished.
+/// Returns the number of instances written.
+/// @param read_chunk Function which reads the next chunk.
+/// @param instances_number Number of instances of the inputs, which is only needed for binary outputs.
+/// @param outputs_file_name Name of the outputs file.
+
+Index BatchPredictor::run(const ChunkReader& read_chunk, const Index& instances_number, const string& outputs_file_name)
+{
+    const chrono::steady_clock::time_point beginning_time = chrono::steady_clock::now();
+
+    const Index outputs_number = neural_network_pointer->get_outputs_number();
+
+    ofstream file;
+
+    if(outputs_file_format == CSV)
+    {
+        file.open(outputs_file_name.c_str());
+    }
+    else
+    {
+        file.open(outputs_file_name.c_str(), ios::binary);
+    }
+
+    if(!file.is_open())
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: BatchPredictor class.\n"
+               << "Index run(const ChunkReader&, const Index&, const string&) method.\n"
+               << "Cannot open outputs file: " << outputs_file_name << "\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    if(outputs_file_format == CSV && has_columns_names)
+    {
+        const Tensor<string, 1> outputs_names = neural_network_pointer->get_outputs_names();
+
+        for(Index i = 0; i < outputs_names.size(); i++)
+        {
+            if(i != 0) file << separator;
+
+            file << outputs_names(i);
+        }
+
+        file << "\n";
+    }
+    else if(outputs_file_format == Binary)
+    {
+        Index columns_number = outputs_number;
+        Index rows_number = instances_number;
+
+        file.write(reinterpret_cast<char*>(&columns_number), sizeof(Index));
+        file.write(reinterpret_cast<char*>(&rows_number), sizeof(Index));
+    }
+
+    // Copies of the neural network, each one with a thread pool of the threads budget of one worker.
+    // The pools and devices are declared first, so that they are destroyed after the copies.
+    // The XML keeps only a few digits, so the parameters and the statistics of the layers are copied afterwards.
+
+    Tensor<type, 1> parameters = neural_network_pointer->get_parameters();
+
+    tinyxml2::XMLDocument neural_network_document;
+
+    write_XML_document(*neural_network_pointer, neural_network_document);
+
+    const int threads_number = static_cast<int>(worker_threads_number);
+
+    vector<unique_ptr<NonBlockingThreadPool>> thread_pools(static_cast<size_t>(workers_number));
+
+    vector<unique_ptr<ThreadPoolDevice>> thread_pool_devices(static_cast<size_t>(workers_number));
+
+    vector<unique_ptr<NeuralNetwork>> neural_networks(static_cast<size_t>(workers_number));
+
+    for(size_t i = 0; i < neural_networks.size(); i++)
+    {
+        thread_pools[i].reset(new NonBlockingThreadPool(threads_number));
+
+        thread_pool_devices[i].reset(new ThreadPoolDevice(thread_pools[i].get(), threads_number));
+
+        neural_networks[i].reset(new NeuralNetwork);
+
+        neural_networks[i]->from_XML(neural_network_document);
+        neural_networks[i]->set_display(false);
+
+        neural_networks[i]->set_parameters(parameters);
+
+        if(neural_network_pointer->has_scaling_layer())
+        {
+            neural_networks[i]->get_scaling_layer_pointer()->set_descriptives(neural_network_pointer->get_scaling_layer_pointer()->get_descriptives());
+        }
+
+        if(neural_network_pointer->has_unscaling_layer())
+        {
+            neural_networks[i]->get_unscaling_layer_pointer()->set_descriptives(neural_network_pointer->get_unscaling_layer_pointer()->get_descriptives());
+        }
+
+        if(neural_network_pointer->has_bounding_layer())
+        {
+            BoundingLayer* bounding_layer_pointer = neural_network_pointer->get_bounding_layer_pointer();
+
+            neural_networks[i]->get_bounding_layer_pointer()->set_lower_bounds(bounding_layer_pointer->get_lower_bounds());
+            neural_networks[i]->get_bounding_layer_pointer()->set_upper_bounds(bounding_layer_pointer->get_upper_bounds());
+        }
+
+        neural_networks[i]->set_thread_pool_device(thread_pool_devices[i].get());
+    }
+
+    // Chunks in flight, which are free, waiting to be calculated, or waiting to be written
+
+    const size_t chunks_number = static_cast<size_t>(2*workers_number);
+
+    vector<Chunk> chunks(chunks_number);
+
+    deque<Chunk*> free_chunks;
+
+    for(size_t i = 0; i < chunks_number; i++) free_chunks.push_back(&chunks[i]);
+
+    deque<Chunk*> calculation_queue;
+
+    vector<Chunk*> calculated_chunks(chunks_number, nullptr);
+
+    mutex chunks_mutex;
+
+    condition_variable chunks_condition;
+
+    bool reading_finished = false;
+
+    Index read_chunks_number = 0;
+
+    string error_message;
+
+    const auto set_error = [&](const string& message)
+    {
+        lock_guard<mutex> lock(chunks_mutex);
+
+        if(error_message.empty()) error_message = message;
+
+        chunks_condition.notify_all();
+    };
+
+    thread reader([&]()
+    {
+        try
+        {
+            while(true)
+            {
+                Chunk* chunk = nullptr;
+
+                {
+                    unique_lock<mutex> lock(chunks_mutex);
+
+                    chunks_condition.wait(lock, [&]{return !free_chunks.empty() || !error_message.empty();});
+
+                    if(!error_message.empty()) break;
+
+                    chunk = free_chunks.front();
+                    free_chunks.pop_front();
+
+                    chunk->chunk_index = read_chunks_number;
+                }
+
+                const bool read = read_chunk(*chunk);
+
+                lock_guard<mutex> lock(chunks_mutex);
+
+                if(!read)
+                {
+                    free_chunks.push_back(chunk);
+
+                    reading_finished = true;
+
+                    chunks_condition.notify_all();
+
+                    break;
+                }
+
+                calculation_queue.push_back(chunk);
+
+                read_chunks_number++;
+
+                chunks_condition.notify_all();
+            }
+        }
+        catch(const exception& e)
+        {
+            set_error(e.what());
+        }
+    });
+
+    vector<thread> workers;
+
+    for(size_t i = 0; i < neural_networks.size(); i++)
+    {
+        NeuralNetwork* worker_neural_network_pointer = neural_networks[i].get();
+
+        workers.push_back(thread([&, worker_neural_network_pointer]()
+        {
+            // The number of threads of the OpenMP regions is set for each thread
+
+            omp_set_num_threads(threads_number);
+
+            try
+            {
+                while(true)
+                {
+                    Chunk* chunk = nullptr;
+
+                    {
+                        unique_lock<mutex> lock(chunks_mutex);
+
+                        chunks_condition.wait(lock, [&]{return !calculation_queue.empty() || reading_finished || !error_message.empty();});
+
+                        if(!error_message.empty() || calculation_queue.empty()) break;
+
+                        chunk = calculation_queue.front();
+                        calculation_queue.pop_front();
+                    }
+
+                    calculate_chunk(*worker_neural_network_pointer, *chunk);
+
+                    lock_guard<mutex> lock(chunks_mutex);
+
+                    calculated_chunks[static_cast<size_t>(chunk->chunk_index)%chunks_number] = chunk;
+
+                    chunks_condition.notify_all();
+                }
+            }
+            catch(const exception& e)
+            {
+                set_error(e.what());
+            }
+        }));
+    }
+
+    // The chunks are written in order, so that at most chunks_number of them are in flight
+
+    const streamoff header_size = static_cast<streamoff>(2*sizeof(Index));
+
+    Index written_chunks_number = 0;
+    Index written_instances_number = 0;
+
+    try
+    {
+        while(true)
+        {
+            Chunk* chunk = nullptr;
+
+            const size_t slot = static_cast<size_t>(written_chunks_number)%chunks_number;
+
+            {
+                unique_lock<mutex> lock(chunks_mutex);
+
+                chunks_condition.wait(lock, [&]
+                {
+                    return calculated_chunks[slot] != nullptr
+                        || (reading_finished && written_chunks_number == read_chunks_number)
+                        || !error_message.empty();
+                });
+
+                if(!error_message.empty() || calculated_chunks[slot] == nullptr) break;
+
+                chunk = calculated_chunks[slot];
+                calculated_chunks[slot] = nullptr;
+            }
+
+            if(outputs_file_format == CSV)
+            {
+                file.write(chunk->text.data(), static_cast<streamsize>(chunk->text.size()));
+            }
+            else
+            {
+                if(written_instances_number + chunk->instances_number > instances_number)
+                {
+                    ostringstream buffer;
+
+                    buffer << "OpenNN Exception: BatchPredictor class.\n"
+                           << "Index run(const ChunkReader&, const Index&, const string&) method.\n"
+                           << "Inputs have more than " << instances_number << " instances.\n";
+
+                    throw logic_error(buffer.str());
+                }
+
+                // The binary files are stored by columns, as the tensors
+
+                for(Index j = 0; j < outputs_number; j++)
+                {
+                    file.seekp(header_size + static_cast<streamoff>((j*instances_number + written_instances_number)*static_cast<Index>(sizeof(type))));
+
+                    file.write(reinterpret_cast<const char*>(chunk->outputs.data() + j*chunk->instances_number),
+                               static_cast<streamsize>(chunk->instances_number*static_cast<Index>(sizeof(type))));
+                }
+            }
+
+            if(!file)
+            {
+                ostringstream buffer;
+
+                buffer << "OpenNN Exception: BatchPredictor class.\n"
+                       << "Index run(const ChunkReader&, const Index&, const string&) method.\n"
+                       << "Cannot write outputs file: " << outputs_file_name << "\n";
+
+                throw logic_error(buffer.str());
+            }
+
+            written_instances_number += chunk->instances_number;
+            written_chunks_number++;
+
+            lock_guard<mutex> lock(chunks_mutex);
+
+            free_chunks.push_back(chunk);
+
+            chunks_condition.notify_all();
+        }
+    }
+    catch(const exception& e)
+    {
+        set_error(e.what());
+    }
+
+    reader.join();
+
+    for(size_t i = 0; i < workers.size(); i++) workers[i].join();
+
+    if(!error_message.empty())
+    {
+        throw logic_error(error_message);
+    }
+
+    if(outputs_file_format == Binary && written_instances_number != instances_number)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: BatchPredictor class.\n"
+               << "Index run(const ChunkReader&, const Index&, const string&) method.\n"
+               << "Inputs have " << written_instances_number << " instances instead of " << instances_number << ".\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    file.close();
+
+    if(display)
+    {
+        const double elapsed_time = chrono::duration<double>(chrono::steady_clock::now() - beginning_time).count();
+
+        cout << "Predicted " << written_instances_number << " instances in " << elapsed_time << " s.\n";
+    }
+
+    return written_instances_number;
+}
+
+
+/// Calculates the outputs of a chunk with the copy of the neural network of a worker.
+/// The lines of CSV chunks are parsed first, and the outputs are formatted as CSV text for CSV outputs files,
+/// so that the parsing and formatting also run on the workers.
+/// @param neural_network Copy of the neural network of the worker.
+/// @param chunk Chunk to be calculated.
+
+void BatchPredictor::calculate_chunk(NeuralNetwork& neural_network, Chunk& chunk) const
+{
+    if(!chunk.lines.empty()) parse_csv_chunk(chunk);
+
+    if(chunk.instances_number == chunk.inputs.dimension(0))
+    {
+        chunk.outputs = neural_network.calculate_outputs(chunk.inputs);
+    }
+    else
+    {
+        const Eigen::array<Index, 2> offsets = {0, 0};
+        const Eigen::array<Index, 2> extents = {chunk.instances_number, chunk.inputs.dimension(1)};
+
+        const Tensor<type, 2> inputs = chunk.inputs.slice(offsets, extents);
+
+        chunk.outputs = neural_network.calculate_outputs(inputs);
+    }
+
+    if(outputs_file_format == CSV) format_csv_chunk(chunk);
+}
+
+
+/// Parses the lines of a CSV chunk into its inputs.
+/// Empty fields and "NA" are read as missing values.
+/// @param chunk Chunk with the lines of the CSV file.
+
+void BatchPredictor::parse_csv_chunk(Chunk& chunk) const
+{
+    const Index inputs_number = neural_network_pointer->get_inputs_number();
+
+    const Index columns_number = get_file_columns_number();
+
+    if(chunk.inputs.dimension(0) != chunk_instances_number || chunk.inputs.dimension(1) != inputs_number)
+    {
+        chunk.inputs.resize(chunk_instances_number, inputs_number);
+    }
+
+    vector<type> values;
+
+    for(Index i = 0; i < chunk.instances_number; i++)
+    {
+        const string& line = chunk.lines[static_cast<size_t>(i)];
+
+        values.clear();
+
+        size_t field_beginning = 0;
+
+        while(true)
+        {
+            size_t field_end = line.find(separator, field_beginning);
+
+            if(field_end == string::npos) field_end = line.size();
+
+            const size_t first = line.find_first_not_of(" \t", field_beginning);
+
+            const string field = first == string::npos || first >= field_end
+                    ? string()
+                    : line.substr(first, line.find_last_not_of(" \t", field_end - 1) - first + 1);
+
+            if(field.empty() || field == "NA")
+            {
+                values.push_back(numeric_limits<type>::quiet_NaN());
+            }
+            else
+            {
+                char* end = nullptr;
+
+                const type value = static_cast<type>(strtod(field.c_str(), &end));
+
+                if(end != field.c_str() + field.size())
+                {
+                    ostringstream buffer;
+
+                    buffer << "OpenNN Exception: BatchPredictor class.\n"
+                           << "void parse_csv_chunk(Chunk&) const method.\n"
+                           << "Instance " << chunk.chunk_index*chunk_instances_number + i << " has a non numeric value: " << field << "\n";
+
+                    throw logic_error(buffer.str());
+                }
+
+                values.push_back(value);
+            }
+
+            if(field_end == line.size()) break;
+
+            field_beginning = field_end + 1;
+        }
+
+        const Index values_number = static_cast<Index>(values.size());
+
+        if((input_variables_indices.size() == 0 && values_number != columns_number) || values_number < columns_number)
+        {
+            ostringstream buffer;
+
+            buffer << "OpenNN Exception: BatchPredictor class.\n"
+                   << "void parse_csv_chunk(Chunk&) const method.\n"
+                   << "Instance " << chunk.chunk_index*chunk_instances_number + i << " has " << values_number << " values, "
+                   << "but " << columns_number << " are needed.\n";
+
+            throw logic_error(buffer.str());
+        }
+
+        for(Index j = 0; j < inputs_number; j++)
+        {
+            const Index column_index = input_variables_indices.size() == 0 ? j : input_variables_indices(j);
+
+            chunk.inputs(i, j) = values[static_cast<size_t>(column_index)];
+        }
+    }
+}
+
+
+/// Formats the outputs of a chunk as CSV text, with enough digits to read back the same values.
+/// @param chunk Chunk with the calculated outputs.
+
+void BatchPredictor::format_csv_chunk(Chunk& chunk) const
+{
+    const Index outputs_number = chunk.outputs.dimension(1);
+
+    chunk.text.clear();
+
+    char number[64];
+
+    for(Index i = 0; i < chunk.instances_number; i++)
+    {
+        for(Index j = 0; j < outputs_number; j++)
+        {
+            if(j != 0) chunk.text.push_back(separator);
+
+            const int length = snprintf(number, sizeof(number), "%.*g",
+                                        numeric_limits<type>::max_digits10, static_cast<double>(chunk.outputs(i, j)));
+
+            chunk.text.append(number, static_cast<size_t>(length));
+        }
+
+        chunk.text.push_back('\n');
+    }
+}
+
+}
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
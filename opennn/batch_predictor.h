@@ -0,0 +1,242 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   B A T C H   P R E D I C T O R   C L A S S   H E A D E R
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#ifndef BATCHPREDICTOR_H
+#define BATCHPREDICTOR_H
+
+// System includes
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <sstream>
+#include <limits>
+#include <vector>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <omp.h>
+
+// OpenNN includes
+
+#include "config.h"
+#include "data_set.h"
+#include "neural_network.h"
+
+using namespace std;
+using namespace Eigen;
+
+namespace OpenNN
+{
+
+/// This class calculates the outputs of a neural network for large inputs files or data sets in bounded memory.
+
+///
+/// The inputs are read in chunks of instances from a CSV file, a binary data file as written by DataSet::save_data_binary(),
+/// or the input variables of a data set, without copying the whole inputs matrix.
+/// The chunks are parsed and calculated by worker threads, each one owning a copy of the neural network,
+/// while a reader thread reads the next chunks and the calling thread writes the outputs in order, to a CSV or a binary file.
+/// At most twice as many chunks as workers are held in memory, and their buffers are reused along the file.
+
+class BatchPredictor
+{
+
+public:
+
+   // Constructors
+
+   explicit BatchPredictor();
+
+   explicit BatchPredictor(NeuralNetwork*);
+
+   // Destructor
+
+   virtual ~BatchPredictor();
+
+   /// Enumeration of the formats of the inputs and outputs files.
+
+   enum FileFormat{CSV, Binary};
+
+   // Get methods
+
+   NeuralNetwork* get_neural_network_pointer() const;
+
+   const FileFormat& get_inputs_file_format() const;
+   string write_inputs_file_format() const;
+
+   const FileFormat& get_outputs_file_format() const;
+   string write_outputs_file_format() const;
+
+   const char& get_separator() const;
+
+   const bool& get_has_columns_names() const;
+
+   const Tensor<Index, 1>& get_input_variables_indices() const;
+
+   const Index& get_chunk_instances_number() const;
+
+   const Index& get_workers_number() const;
+   const Index& get_worker_threads_number() const;
+
+   const bool& get_display() const;
+
+   // Set methods
+
+   void set();
+   void set(NeuralNetwork*);
+
+   void set_default();
+
+   void set_neural_network_pointer(NeuralNetwork*);
+
+   void set_inputs_file_format(const FileFormat&);
+   void set_inputs_file_format(const string&);
+
+   void set_outputs_file_format(const FileFormat&);
+   void set_outputs_file_format(const string&);
+
+   void set_separator(const char&);
+
+   void set_has_columns_names(const bool&);
+
+   void set_input_variables_indices(const Tensor<Index, 1>&);
+
+   void set_chunk_instances_number(const Index&);
+
+   void set_workers_number(const Index&);
+   void set_worker_threads_number(const Index&);
+
+   void set_display(const bool&);
+
+   // Prediction methods
+
+   Index predict(const string&, const string&);
+
+   Index predict(const DataSet&, const string&);
+
+private:
+
+   /// Buffers of a chunk of instances, which are reused along the inputs.
+
+   struct Chunk
+   {
+       explicit Chunk() {}
+
+       virtual ~Chunk() {}
+
+       /// Position of the chunk in the inputs.
+
+       Index chunk_index = 0;
+
+       /// Number of instances of the chunk, which is smaller than the buffers for the last one.
+
+       Index instances_number = 0;
+
+       /// Lines of the chunk, when the inputs come from a CSV file.
+
+       vector<string> lines;
+
+       /// Inputs of the chunk.
+
+       Tensor<type, 2> inputs;
+
+       /// Outputs of the chunk.
+
+       Tensor<type, 2> outputs;
+
+       /// Outputs of the chunk formatted as CSV text.
+
+       string text;
+   };
+
+   /// Reads the next chunk into the given buffers, and returns false when the inputs are over.
+
+   typedef function<bool(Chunk&)> ChunkReader;
+
+   void check() const;
+
+   Index get_file_columns_number() const;
+
+   Index count_csv_instances(const string&) const;
+
+   Index run(const ChunkReader&, const Index&, const string&);
+
+   void calculate_chunk(NeuralNetwork&, Chunk&) const;
+
+   void parse_csv_chunk(Chunk&) const;
+
+   void format_csv_chunk(Chunk&) const;
+
+   /// Pointer to the neural network which calculates the outputs.
+
+   NeuralNetwork* neural_network_pointer = nullptr;
+
+   /// Format of the inputs file.
+
+   FileFormat inputs_file_format = CSV;
+
+   /// Format of the outputs file.
+
+   FileFormat outputs_file_format = CSV;
+
+   /// Separator of the CSV files.
+
+   char separator = ',';
+
+   /// True if the CSV files have a header with the names of the columns.
+
+   bool has_columns_names = false;
+
+   /// Indices of the columns of the inputs file which are the inputs of the neural network, or empty for all the columns.
+
+   Tensor<Index, 1> input_variables_indices;
+
+   /// Number of instances of each chunk.
+
+   Index chunk_instances_number = 1000;
+
+   /// Number of worker threads.
+
+   Index workers_number = 1;
+
+   /// Number of threads of the thread pools of the copy of the neural network of each worker.
+
+   Index worker_threads_number = 1;
+
+   /// Display messages to screen.
+
+   bool display = true;
+};
+
+}
+
+#endif
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
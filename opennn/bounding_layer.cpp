@@ -278,6 +278,10 @@ void BoundingLayer::set(const tinyxml2::XMLDocument& bounding_layer_document)
 
 void BoundingLayer::set(const BoundingLayer& other_bounding_layer)
 {
+    set_default();
+
+    bounding_method = other_bounding_layer.bounding_method;
+
     lower_bounds = other_bounding_layer.lower_bounds;
 
     upper_bounds = other_bounding_layer.upper_bounds;
@@ -628,6 +632,45 @@ string BoundingLayer::write_expression_c() const
 }
 
 
+/// Returns the C function of the bounding layer for a batch of inputs, which are stored by rows.
+
+string BoundingLayer::write_batch_expression_c() const
+{
+    const Index neurons_number = get_neurons_number();
+
+    ostringstream buffer;
+
+    if(bounding_method == Bounding)
+    {
+        buffer << write_array_c(layer_name + "_lower_bounds", lower_bounds.data(), neurons_number);
+        buffer << write_array_c(layer_name + "_upper_bounds", upper_bounds.data(), neurons_number);
+    }
+
+    buffer << "static void " << layer_name << "(const float* inputs, float* outputs, int batch_size)\n{" << endl;
+
+    buffer << "\tfor(int i = 0; i < batch_size; i++)\n\t{" << endl;
+    buffer << "\t\tfor(int j = 0; j < " << neurons_number << "; j++)\n\t\t{" << endl;
+
+    if(bounding_method == Bounding)
+    {
+        buffer << "\t\t\tconst float x = inputs[i*" << neurons_number << " + j];\n" << endl;
+        buffer << "\t\t\toutputs[i*" << neurons_number << " + j] = x < " << layer_name << "_lower_bounds[j] ? " << layer_name << "_lower_bounds[j]"
+               << " : (x > " << layer_name << "_upper_bounds[j] ? " << layer_name << "_upper_bounds[j] : x);" << endl;
+    }
+    else
+    {
+        buffer << "\t\t\toutputs[i*" << neurons_number << " + j] = inputs[i*" << neurons_number << " + j];" << endl;
+    }
+
+    buffer << "\t\t}" << endl;
+    buffer << "\t}" << endl;
+
+    buffer << "}\n" << endl;
+
+    return buffer.str();
+}
+
+
 ///
 /// \brief BoundingLayer::write_expression_python
 /// \return
@@ -109,6 +109,7 @@ public:
    string write_expression_php(const Tensor<string, 1>&, const Tensor<string, 1>&) const;
 
    string write_expression_c() const;
+   string write_batch_expression_c() const;
    string write_expression_python() const;
 
    // Serialization methods
@@ -36,6 +36,7 @@
 #pragma warning(push, 0)
 #include "../eigen/unsupported/Eigen/CXX11/Tensor"
 #include "../eigen/unsupported/Eigen/CXX11/ThreadPool"
+#include "../eigen/Eigen/SparseCore"
 #pragma warning(pop)
 
 
@@ -45,6 +46,14 @@
     #include "mkl.h"
 #endif
 
+// Rational approximations of tanh and logistic in the layers, with absolute error below 3e-8
+
+//#define OPENNN_FAST_ACTIVATIONS
+
+// High resolution timers and counters of the training phases and layers, see TrainingProfiler
+
+//#define OPENNN_PROFILE
+
 
 //#define EIGEN_USE_BLAS
 
@@ -65,6 +74,10 @@
 namespace OpenNN
 {
     typedef double type;
+
+    /// Matrix in compressed sparse row format, used for batches of mostly zero inputs.
+
+    typedef Eigen::SparseMatrix<type, Eigen::RowMajor, Eigen::Index> CsrMatrix;
 }
 
 
@@ -53,498 +53,641 @@ bool ConvolutionalLayer::is_empty() const
 
 
 /// Returns the output of the convolutional layer applied to a batch of images.
-/// @param inputs The batch of images.
+/// @param inputs The batch of images, with one flattened image in each row.
+
+Tensor<type, 2> ConvolutionalLayer::calculate_outputs(const Tensor<type, 2>& inputs)
+{
+    ForwardPropagation forward_propagation(inputs.dimension(0), this);
+
+    forward_propagate(inputs, forward_propagation);
+
+    return forward_propagation.activations_2d;
+}
+
+
+/// Returns the output of the convolutional layer applied to a batch of images.
+/// @param inputs The batch of images, ordered as set in the inputs layout.
 
 Tensor<type, 4> ConvolutionalLayer::calculate_outputs(const Tensor<type, 4>& inputs)
 {
-//    return calculate_activations(calculate_combinations(inputs));
+    ForwardPropagation forward_propagation(inputs.dimension(0), this);
 
-    return Tensor<type, 4>();
+    forward_propagate(inputs, forward_propagation);
+
+    return forward_propagation.activations_4d;
 }
 
 
-Tensor<type, 2> ConvolutionalLayer::calculate_hidden_delta(Layer* next_layer_pointer,
-        const Tensor<type, 2>& activations_2d,
-        const Tensor<type, 2>& activations_derivatives,
-        const Tensor<type, 2>& next_layer_delta) const
+/// Returns the distances in memory between consecutive channels, rows and columns of the input images.
+/// The images are stored one after another in the fastest dimension, as in the rows of a data set batch.
+/// @param images_number Number of images in the batch.
+
+void ConvolutionalLayer::get_inputs_steps(const Index& images_number,
+                                          Index& channels_step,
+                                          Index& rows_step,
+                                          Index& columns_step) const
 {
-    const Type layer_type = next_layer_pointer->get_type();
+    const Index channels_number = get_inputs_channels_number();
+    const Index rows_number = get_inputs_rows_number();
+    const Index columns_number = get_inputs_columns_number();
 
-    if(layer_type == Convolutional)
+    switch(inputs_layout)
     {
-        ConvolutionalLayer* convolutional_layer = dynamic_cast<ConvolutionalLayer*>(next_layer_pointer);
+        case NCHW:
+        {
+            channels_step = images_number;
+            rows_step = images_number*channels_number;
+            columns_step = images_number*channels_number*rows_number;
+        }
+        return;
 
-//        return calculate_hidden_delta_convolutional(convolutional_layer, activations_2d, activations_derivatives, next_layer_delta);
+        case NHWC:
+        {
+            rows_step = images_number;
+            columns_step = images_number*rows_number;
+            channels_step = images_number*rows_number*columns_number;
+        }
+        return;
     }
-    else if(layer_type == Pooling)
-    {
-        PoolingLayer* pooling_layer = dynamic_cast<PoolingLayer*>(next_layer_pointer);
+}
 
-        return calculate_hidden_delta_pooling(pooling_layer, activations_2d, activations_derivatives, next_layer_delta);
-    }
-    else if(layer_type == Perceptron)
+
+/// Unrolls the receptive fields of all the outputs of a batch of images into the rows of a matrix (im2col),
+/// so that the convolution becomes a single matrix product with the filters.
+/// Each row corresponds to an image and output position, and each column to a channel and filter position.
+/// The positions outside the images are filled with zeros, which implements the padding.
+/// @param inputs_data Pointer to the batch of images.
+/// @param images_number Number of images in the batch.
+/// @param patches Matrix where the patches are saved.
+
+void ConvolutionalLayer::calculate_image_patches(const type* inputs_data,
+                                                 const Index& images_number,
+                                                 Tensor<type, 2>& patches) const
+{
+    const Index channels_number = get_inputs_channels_number();
+    const Index inputs_rows_number = get_inputs_rows_number();
+    const Index inputs_columns_number = get_inputs_columns_number();
+
+    const Index filters_rows_number = get_filters_rows_number();
+    const Index filters_columns_number = get_filters_columns_number();
+
+    const Index outputs_rows_number = get_outputs_rows_number();
+    const Index outputs_columns_number = get_outputs_columns_number();
+
+    const Index padding_top = get_padding_height()/2;
+    const Index padding_left = get_padding_width()/2;
+
+    const Index patch_size = channels_number*filters_rows_number*filters_columns_number;
+    const Index patches_number = images_number*outputs_rows_number*outputs_columns_number;
+
+    Index channels_step;
+    Index rows_step;
+    Index columns_step;
+
+    get_inputs_steps(images_number, channels_step, rows_step, columns_step);
+
+    patches.resize(patches_number, patch_size);
+
+    #pragma omp parallel for
+
+    for(Index index = 0; index < patch_size*outputs_columns_number; index++)
     {
-        PerceptronLayer* perceptron_layer = dynamic_cast<PerceptronLayer*>(next_layer_pointer);
+        const Index patch_index = index%patch_size;
+        const Index output_column = index/patch_size;
+
+        const Index channel = patch_index%channels_number;
+        const Index filter_row = (patch_index/channels_number)%filters_rows_number;
+        const Index filter_column = patch_index/(channels_number*filters_rows_number);
+
+        const Index column = output_column*column_stride + filter_column - padding_left;
 
-        return calculate_hidden_delta_perceptron(perceptron_layer, activations_2d, activations_derivatives, next_layer_delta);
+        for(Index output_row = 0; output_row < outputs_rows_number; output_row++)
+        {
+            const Index row = output_row*row_stride + filter_row - padding_top;
+
+            type* patch_data = patches.data()
+                             + patch_index*patches_number
+                             + images_number*(output_row + outputs_rows_number*output_column);
+
+            if(row < 0 || row >= inputs_rows_number || column < 0 || column >= inputs_columns_number)
+            {
+                fill_n(patch_data, images_number, static_cast<type>(0.0));
+            }
+            else
+            {
+                const type* image_data = inputs_data + channel*channels_step + row*rows_step + column*columns_step;
+
+                copy(image_data, image_data + images_number, patch_data);
+            }
+        }
     }
-    else if(layer_type == Probabilistic)
+}
+
+
+/// Calculates the combinations of a batch of images with the filters of the layer.
+/// @param inputs Batch of images, ordered as set in the inputs layout.
+/// @param combinations Tensor of dimensions (images, filters, outputs rows, outputs columns) where the combinations are saved.
+
+void ConvolutionalLayer::calculate_convolutions(const Tensor<type, 4>& inputs, Tensor<type, 4>& combinations) const
+{
+#ifdef __OPENNN_DEBUG__
+
+    const Index inputs_size = inputs.size()/inputs.dimension(0);
+
+    if(inputs_size != get_inputs_number())
     {
-        ProbabilisticLayer* probabilistic_layer = dynamic_cast<ProbabilisticLayer*>(next_layer_pointer);
+        ostringstream buffer;
 
-        return calculate_hidden_delta_probabilistic(probabilistic_layer, activations_2d, activations_derivatives, next_layer_delta);
+        buffer << "OpenNN Exception: ConvolutionalLayer class.\n"
+               << "void calculate_convolutions(const Tensor<type, 4>&, Tensor<type, 4>&) const method.\n"
+               << "Size of input images (" << inputs_size << ") must be equal to number of inputs (" << get_inputs_number() << ").\n";
+
+        throw logic_error(buffer.str());
     }
 
-    return Tensor<type, 2>();
+#endif
+
+    calculate_convolutions(inputs.data(), inputs.dimension(0), synaptic_weights.data(), biases.data(), combinations);
 }
 
 
-Tensor<type, 2> ConvolutionalLayer::calculate_hidden_delta_convolutional(ConvolutionalLayer* next_layer_pointer,
-        const Tensor<type, 2>&,
-        const Tensor<type, 2>& activations_derivatives,
-        const Tensor<type, 4>& next_layer_delta) const
+/// Calculates the combinations of a batch of images with the given filters and biases,
+/// as the product of the image patches with the filters.
+/// @param inputs_data Pointer to the batch of images.
+/// @param images_number Number of images in the batch.
+/// @param synaptic_weights_data Pointer to the filters, with the same ordering as the synaptic weights.
+/// @param biases_data Pointer to the biases.
+/// @param combinations Tensor of dimensions (images, filters, outputs rows, outputs columns) where the combinations are saved.
+
+void ConvolutionalLayer::calculate_convolutions(const type* inputs_data,
+                                                const Index& images_number,
+                                                const type* synaptic_weights_data,
+                                                const type* biases_data,
+                                                Tensor<type, 4>& combinations) const
 {
+    const Index filters_number = get_filters_number();
+    const Index outputs_rows_number = get_outputs_rows_number();
+    const Index outputs_columns_number = get_outputs_columns_number();
 
-    // Current layer's values
+    const Index patches_number = images_number*outputs_rows_number*outputs_columns_number;
+    const Index patch_size = synaptic_weights.size()/filters_number;
 
-    const auto images_number = next_layer_delta.dimension(0);
-    const Index filters_number = get_filters_number();
-    const Index output_rows_number = get_outputs_rows_number();
-    const Index output_columns_number = get_outputs_columns_number();
+    const TensorMap<Tensor<type, 2>> filters(const_cast<type*>(synaptic_weights_data), filters_number, patch_size);
+    const TensorMap<Tensor<type, 2>> filters_biases(const_cast<type*>(biases_data), 1, filters_number);
 
-        // Next layer's values
+    Tensor<type, 2> patches;
 
-        const Index next_layers_filters_number = next_layer_pointer->get_filters_number();
-        const Index next_layers_filter_rows = next_layer_pointer->get_filters_rows_number();
-        const Index next_layers_filter_columns = next_layer_pointer->get_filters_columns_number();
-        const Index next_layers_output_rows = next_layer_pointer->get_outputs_rows_number();
-        const Index next_layers_output_columns = next_layer_pointer->get_outputs_columns_number();
-        const Index next_layers_row_stride = next_layer_pointer->get_row_stride();
-        const Index next_layers_column_stride = next_layer_pointer->get_column_stride();
+    calculate_image_patches(inputs_data, images_number, patches);
 
-        const Tensor<type, 2> next_layers_weights = next_layer_pointer->get_synaptic_weights();
+    Tensor<type, 2> patches_combinations(patches_number, filters_number);
 
-        // Hidden delta calculation
+    patches_combinations.device(*thread_pool_device) = patches.contract(filters, A_BT)
+            + filters_biases.broadcast(Eigen::array<Index, 2>({patches_number, 1}));
 
-        Tensor<type, 4> hidden_delta(images_number, filters_number, output_rows_number, output_columns_number);
+    combinations.resize(images_number, filters_number, outputs_rows_number, outputs_columns_number);
 
-        const Index size = hidden_delta.size();
+    combinations.device(*thread_pool_device)
+            = patches_combinations.reshape(Eigen::array<Index, 4>({images_number, outputs_rows_number, outputs_columns_number, filters_number}))
+                                  .shuffle(Eigen::array<Index, 4>({0, 3, 1, 2}));
+}
 
-        #pragma omp parallel for
 
-        for(Index tensor_index = 0; tensor_index < size; tensor_index++)
-        {
-            const Index image_index = tensor_index/(filters_number*output_rows_number*output_columns_number);
-            const Index channel_index = (tensor_index/(output_rows_number*output_columns_number))%filters_number;
-            const Index row_index = (tensor_index/output_columns_number)%output_rows_number;
-            const Index column_index = tensor_index%output_columns_number;
+/// Calculates the activations of a batch of flattened combinations.
+/// @param combinations_2d Combinations, with one flattened image in each row.
+/// @param activations_2d Matrix where the activations are saved.
 
-            type sum = 0;
+void ConvolutionalLayer::calculate_activations(const Tensor<type, 2>& combinations_2d, Tensor<type, 2>& activations_2d) const
+{
+    switch(activation_function)
+    {
+        case Linear: linear(combinations_2d, activations_2d); return;
 
-            const Index lower_row_index = (row_index - next_layers_filter_rows)/next_layers_row_stride + 1;
-            const Index upper_row_index = min(row_index/next_layers_row_stride + 1, next_layers_output_rows);
-            const Index lower_column_index = (column_index - next_layers_filter_columns)/next_layers_column_stride + 1;
-            const Index upper_column_index = min(column_index/next_layers_column_stride + 1, next_layers_output_columns);
+        case Logistic: logistic(combinations_2d, activations_2d); return;
 
-            for(Index i = 0; i < next_layers_filters_number; i++)
-            {
-                for(Index j = lower_row_index; j < upper_row_index; j++)
-                {
-                    for(Index k = lower_column_index; k < upper_column_index; k++)
-                    {
-                        const type delta_element = next_layer_delta(image_index, i, j, k);
+        case HyperbolicTangent: hyperbolic_tangent(combinations_2d, activations_2d); return;
 
-//                        const type weight = next_layers_weights(i, channel_index, row_index - j*next_layers_row_stride, column_index - k*next_layers_column_stride);
+        case Threshold: threshold(combinations_2d, activations_2d); return;
 
-//                        sum += delta_element*weight;
-                    }
-                }
-            }
+        case SymmetricThreshold: symmetric_threshold(combinations_2d, activations_2d); return;
 
-            hidden_delta(image_index, channel_index, row_index, column_index) = sum;
-        }
+        case RectifiedLinear: rectified_linear(combinations_2d, activations_2d); return;
+
+        case ScaledExponentialLinear: scaled_exponential_linear(combinations_2d, activations_2d); return;
+
+        case SoftPlus: soft_plus(combinations_2d, activations_2d); return;
 
-//        return hidden_delta*activations_derivatives;
+        case SoftSign: soft_sign(combinations_2d, activations_2d); return;
 
-    return Tensor<type, 2>();
+        case HardSigmoid: hard_sigmoid(combinations_2d, activations_2d); return;
+
+        case ExponentialLinear: exponential_linear(combinations_2d, activations_2d); return;
+    }
 }
 
 
-Tensor<type, 2> ConvolutionalLayer::calculate_hidden_delta_pooling(PoolingLayer* next_layer_pointer,
-        const Tensor<type, 2>& activations_2d,
-        const Tensor<type, 2>& activations_derivatives,
-        const Tensor<type, 2>& next_layer_delta) const
-{
+/// Calculates the activations of a batch of combinations.
+/// @param combinations Combinations of dimensions (images, filters, outputs rows, outputs columns).
+/// @param activations Tensor where the activations are saved.
 
-        switch(next_layer_pointer->get_pooling_method())
-        {
-            case OpenNN::PoolingLayer::PoolingMethod::NoPooling:
-            {
-                return next_layer_delta;
-            }
+void ConvolutionalLayer::calculate_activations(const Tensor<type, 4>& combinations, Tensor<type, 4>& activations) const
+{
+    const Index images_number = combinations.dimension(0);
 
-            case OpenNN::PoolingLayer::PoolingMethod::AveragePooling:
-            {
-                // Current layer's values
+    const Eigen::array<Index, 2> dimensions_2d({images_number, combinations.size()/images_number});
 
-                const Index images_number = next_layer_delta.dimension(0);
-                const Index filters_number = get_filters_number();
-                const Index output_rows_number = get_outputs_rows_number();
-                const Index output_columns_number = get_outputs_columns_number();
+    const Tensor<type, 2> combinations_2d = combinations.reshape(dimensions_2d);
 
-                // Next layer's values
+    Tensor<type, 2> activations_2d(dimensions_2d);
 
-                const Index next_layers_pool_rows = next_layer_pointer->get_pool_rows_number();
-                const Index next_layers_pool_columns = next_layer_pointer->get_pool_columns_number();
-                const Index next_layers_output_rows = next_layer_pointer->get_outputs_rows_number();
-                const Index next_layers_output_columns = next_layer_pointer->get_outputs_columns_number();
-                const Index next_layers_row_stride = next_layer_pointer->get_row_stride();
-                const Index next_layers_column_stride = next_layer_pointer->get_column_stride();
+    calculate_activations(combinations_2d, activations_2d);
 
-                // Hidden delta calculation
+    activations = activations_2d.reshape(combinations.dimensions());
+}
 
-                Tensor<type, 4> hidden_delta(images_number, filters_number, output_rows_number, output_columns_number);
 
-                const Index size = hidden_delta.size();
+/// Calculates the activations and the activations derivatives of a batch of flattened combinations.
+/// @param combinations_2d Combinations, with one flattened image in each row.
+/// @param activations_2d Matrix where the activations are saved.
+/// @param activations_derivatives_2d Matrix where the activations derivatives are saved.
 
-                #pragma omp parallel for
+void ConvolutionalLayer::calculate_activations_derivatives(const Tensor<type, 2>& combinations_2d,
+                                                           Tensor<type, 2>& activations_2d,
+                                                           Tensor<type, 2>& activations_derivatives_2d) const
+{
+    switch(activation_function)
+    {
+        case Linear: linear_derivatives(combinations_2d, activations_2d, activations_derivatives_2d); return;
 
-                for(Index tensor_index = 0; tensor_index < size; tensor_index++)
-                {
-                    const Index image_index = tensor_index/(filters_number*output_rows_number*output_columns_number);
-                    const Index channel_index = (tensor_index/(output_rows_number*output_columns_number))%filters_number;
-                    const Index row_index = (tensor_index/output_columns_number)%output_rows_number;
-                    const Index column_index = tensor_index%output_columns_number;
+        case Logistic: logistic_derivatives(combinations_2d, activations_2d, activations_derivatives_2d); return;
 
-                    type sum = 0;
+        case HyperbolicTangent: hyperbolic_tangent_derivatives(combinations_2d, activations_2d, activations_derivatives_2d); return;
 
-                    const Index lower_row_index = (row_index - next_layers_pool_rows)/next_layers_row_stride + 1;
-                    const Index upper_row_index = min(row_index/next_layers_row_stride + 1, next_layers_output_rows);
-                    const Index lower_column_index = (column_index - next_layers_pool_columns)/next_layers_column_stride + 1;
-                    const Index upper_column_index = min(column_index/next_layers_column_stride + 1, next_layers_output_columns);
+        case Threshold: threshold_derivatives(combinations_2d, activations_2d, activations_derivatives_2d); return;
 
-                    for(Index i = lower_row_index; i < upper_row_index; i++)
-                    {
-                        for(Index j = lower_column_index; j < upper_column_index; j++)
-                        {
-//                            const type delta_element = next_layer_delta(image_index, channel_index, i, j);
+        case SymmetricThreshold: symmetric_threshold_derivatives(combinations_2d, activations_2d, activations_derivatives_2d); return;
 
-//                            sum += delta_element;
-                        }
-                    }
+        case RectifiedLinear: rectified_linear_derivatives(combinations_2d, activations_2d, activations_derivatives_2d); return;
 
-                    hidden_delta(image_index, channel_index, row_index, column_index) = sum;
-                }
+        case ScaledExponentialLinear: scaled_exponential_linear_derivatives(combinations_2d, activations_2d, activations_derivatives_2d); return;
 
-//                return (hidden_delta*activations_derivatives)/(next_layers_pool_rows*next_layers_pool_columns);
-            }
+        case SoftPlus: soft_plus_derivatives(combinations_2d, activations_2d, activations_derivatives_2d); return;
 
-            case OpenNN::PoolingLayer::PoolingMethod::MaxPooling:
-            {
-                // Current layer's values
+        case SoftSign: soft_sign_derivatives(combinations_2d, activations_2d, activations_derivatives_2d); return;
 
-                const Index images_number = next_layer_delta.dimension(0);
-                const Index filters_number = get_filters_number();
-                const Index output_rows_number = get_outputs_rows_number();
-                const Index output_columns_number = get_outputs_columns_number();
+        case HardSigmoid: hard_sigmoid_derivatives(combinations_2d, activations_2d, activations_derivatives_2d); return;
 
-                // Next layer's values
+        case ExponentialLinear: exponential_linear_derivatives(combinations_2d, activations_2d, activations_derivatives_2d); return;
+    }
+}
 
-                const Index next_layers_pool_rows = next_layer_pointer->get_pool_rows_number();
-                const Index next_layers_pool_columns = next_layer_pointer->get_pool_columns_number();
-                const Index next_layers_output_rows = next_layer_pointer->get_outputs_rows_number();
-                const Index next_layers_output_columns = next_layer_pointer->get_outputs_columns_number();
-                const Index next_layers_row_stride = next_layer_pointer->get_row_stride();
-                const Index next_layers_column_stride = next_layer_pointer->get_column_stride();
 
-                // Hidden delta calculation
+/// Calculates the activations and the activations derivatives of a batch of combinations.
+/// @param combinations Combinations of dimensions (images, filters, outputs rows, outputs columns).
+/// @param activations Tensor where the activations are saved.
+/// @param activations_derivatives Tensor where the activations derivatives are saved.
 
-                Tensor<type, 4> hidden_delta(images_number, filters_number, output_rows_number, output_columns_number);
+void ConvolutionalLayer::calculate_activations_derivatives(const Tensor<type, 4>& combinations,
+                                                           Tensor<type, 4>& activations,
+                                                           Tensor<type, 4>& activations_derivatives) const
+{
+    const Index images_number = combinations.dimension(0);
 
-                const Index size = hidden_delta.size();
+    const Eigen::array<Index, 2> dimensions_2d({images_number, combinations.size()/images_number});
 
-                #pragma omp parallel for
+    const Tensor<type, 2> combinations_2d = combinations.reshape(dimensions_2d);
 
-                for(Index tensor_index = 0; tensor_index < size; tensor_index++)
-                {
-                    const Index image_index = tensor_index/(filters_number*output_rows_number*output_columns_number);
-                    const Index channel_index = (tensor_index/(output_rows_number*output_columns_number))%filters_number;
-                    const Index row_index = (tensor_index/output_columns_number)%output_rows_number;
-                    const Index column_index = tensor_index%output_columns_number;
-
-                    type sum = 0;
-
-                    const Index lower_row_index = (row_index - next_layers_pool_rows)/next_layers_row_stride + 1;
-                    const Index upper_row_index = min(row_index/next_layers_row_stride + 1, next_layers_output_rows);
-                    const Index lower_column_index = (column_index - next_layers_pool_columns)/next_layers_column_stride + 1;
-                    const Index upper_column_index = min(column_index/next_layers_column_stride + 1, next_layers_output_columns);
-
-                    for(Index i = lower_row_index; i < upper_row_index; i++)
-                    {
-                        for(Index j = lower_column_index; j < upper_column_index; j++)
-                        {
-//                            const type delta_element = next_layer_delta(image_index, channel_index, i, j);
-
-                            Tensor<type, 2> activations_current_submatrix(next_layers_pool_rows, next_layers_pool_columns);
-
-                            for(Index submatrix_row_index = 0; submatrix_row_index < next_layers_pool_rows; submatrix_row_index++)
-                            {
-                                for(Index submatrix_column_index = 0; submatrix_column_index < next_layers_pool_columns; submatrix_column_index++)
-                                {
-//                                    activations_current_submatrix(submatrix_row_index, submatrix_column_index) =
-//                                            activations_2d(image_index, channel_index, i*next_layers_row_stride + submatrix_row_index, j*next_layers_column_stride + submatrix_column_index);
-                                }
-                            }
-
-                            Tensor<type, 2> multiply_not_multiply(next_layers_pool_rows, next_layers_pool_columns);
-
-                            type max_value = activations_current_submatrix(0,0);
-
-                            for(Index submatrix_row_index = 0; submatrix_row_index < next_layers_pool_rows; submatrix_row_index++)
-                            {
-                                for(Index submatrix_column_index = 0; submatrix_column_index < next_layers_pool_columns; submatrix_column_index++)
-                                {
-                                    if(activations_current_submatrix(submatrix_row_index, submatrix_column_index) > max_value)
-                                    {
-                                        max_value = activations_current_submatrix(submatrix_row_index, submatrix_column_index);
-
-//                                        multiply_not_multiply = Tensor<type, 2>(next_layers_pool_rows, next_layers_pool_columns, 0.0);
-                                        multiply_not_multiply(submatrix_row_index, submatrix_column_index) = 1.0;
-                                    }
-                                }
-                            }
-
-                            const type max_derivative = multiply_not_multiply(row_index - i*next_layers_row_stride, column_index - j*next_layers_column_stride);
-
-//                            sum += delta_element*max_derivative;
-                        }
-                    }
-
-                    hidden_delta(image_index, channel_index, row_index, column_index) = sum;
-                }
+    Tensor<type, 2> activations_2d(dimensions_2d);
+    Tensor<type, 2> activations_derivatives_2d(dimensions_2d);
 
-//                return hidden_delta*activations_derivatives;
-            }
-        }
+    calculate_activations_derivatives(combinations_2d, activations_2d, activations_derivatives_2d);
 
-    return Tensor<type, 2>();
+    activations = activations_2d.reshape(combinations.dimensions());
+    activations_derivatives = activations_derivatives_2d.reshape(combinations.dimensions());
 }
 
 
-Tensor<type, 2> ConvolutionalLayer::calculate_hidden_delta_perceptron(PerceptronLayer* next_layer_pointer,
-        const Tensor<type, 2>&,
-        const Tensor<type, 2>& activations_derivatives,
-        const Tensor<type, 2>& next_layer_delta) const
+/// Calculates the forward propagation of a batch of images with the current parameters.
+/// The results are saved both as images, in the 4D tensors, and flattened, in the 2D tensors used by the next layers.
+/// @param inputs Batch of images, with one flattened image in each row.
+/// @param forward_propagation Structure where the combinations, activations and activations derivatives are saved.
+
+void ConvolutionalLayer::forward_propagate(const Tensor<type, 2>& inputs, ForwardPropagation& forward_propagation) const
 {
+    const Index images_number = inputs.dimension(0);
+
+#ifdef __OPENNN_DEBUG__
+
+    if(inputs.dimension(1) != get_inputs_number())
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: ConvolutionalLayer class.\n"
+               << "void forward_propagate(const Tensor<type, 2>&, ForwardPropagation&) const method.\n"
+               << "Number of inputs columns (" << inputs.dimension(1) << ") must be equal to number of inputs (" << get_inputs_number() << ").\n";
+
+        throw logic_error(buffer.str());
+    }
 
-        // Current layer's values
+#endif
 
-        const Index images_number = next_layer_delta.dimension(0);
-        const Index filters_number = get_filters_number();
-        const Index output_rows_number = get_outputs_rows_number();
-        const Index output_columns_number = get_outputs_columns_number();
+    calculate_convolutions(inputs.data(), images_number, synaptic_weights.data(), biases.data(), forward_propagation.combinations_4d);
 
-        // Next layer's values
+    forward_propagation.combinations_2d = forward_propagation.combinations_4d.reshape(Eigen::array<Index, 2>({images_number, get_neurons_number()}));
 
-        const Index next_layers_output_columns = next_layer_delta.dimension(1);
+    calculate_activations_derivatives(forward_propagation.combinations_2d,
+                                      forward_propagation.activations_2d,
+                                      forward_propagation.activations_derivatives_2d);
 
-        const Tensor<type, 2>& next_layers_weights = next_layer_pointer->get_synaptic_weights();
+    forward_propagation.activations_4d = forward_propagation.activations_2d.reshape(forward_propagation.combinations_4d.dimensions());
+    forward_propagation.activations_derivatives_4d = forward_propagation.activations_derivatives_2d.reshape(forward_propagation.combinations_4d.dimensions());
+}
 
-        // Hidden delta calculation
 
-        Tensor<type, 4> hidden_delta(images_number, filters_number, output_rows_number, output_columns_number);
+/// Calculates the forward propagation of a batch of images with the current parameters.
+/// @param inputs Batch of images, ordered as set in the inputs layout.
+/// @param forward_propagation Structure where the combinations, activations and activations derivatives are saved.
 
-        const Index size = hidden_delta.size();
+void ConvolutionalLayer::forward_propagate(const Tensor<type, 4>& inputs, ForwardPropagation& forward_propagation) const
+{
+    const Index images_number = inputs.dimension(0);
 
-        #pragma omp parallel for
+    calculate_convolutions(inputs, forward_propagation.combinations_4d);
 
-        for(Index tensor_index = 0; tensor_index < size; tensor_index++)
-        {
-            const Index image_index = tensor_index/(filters_number*output_rows_number*output_columns_number);
-            const Index channel_index = (tensor_index/(output_rows_number*output_columns_number))%filters_number;
-            const Index row_index = (tensor_index/output_columns_number)%output_rows_number;
-            const Index column_index = tensor_index%output_columns_number;
+    forward_propagation.combinations_2d = forward_propagation.combinations_4d.reshape(Eigen::array<Index, 2>({images_number, get_neurons_number()}));
 
-            type sum = 0;
+    calculate_activations_derivatives(forward_propagation.combinations_2d,
+                                      forward_propagation.activations_2d,
+                                      forward_propagation.activations_derivatives_2d);
 
-            for(Index sum_index = 0; sum_index < next_layers_output_columns; sum_index++)
-            {
-                const type delta_element = next_layer_delta(image_index, sum_index);
+    forward_propagation.activations_4d = forward_propagation.activations_2d.reshape(forward_propagation.combinations_4d.dimensions());
+    forward_propagation.activations_derivatives_4d = forward_propagation.activations_derivatives_2d.reshape(forward_propagation.combinations_4d.dimensions());
+}
 
-                const type weight = next_layers_weights(channel_index + row_index*filters_number + column_index*filters_number*output_rows_number, sum_index);
 
-                sum += delta_element*weight;
-            }
+/// Calculates the forward propagation of a batch of images with the given parameters.
+/// @param inputs Batch of images, with one flattened image in each row.
+/// @param parameters Parameters of the layer, in the same order as get_parameters().
+/// @param forward_propagation Structure where the combinations, activations and activations derivatives are saved.
 
-            hidden_delta(image_index, channel_index, row_index, column_index) = sum;
-        }
+void ConvolutionalLayer::forward_propagate(const Tensor<type, 2>& inputs,
+                                           const TensorMap<Tensor<type, 1>>& parameters,
+                                           ForwardPropagation& forward_propagation) const
+{
+    const Index images_number = inputs.dimension(0);
 
-//        return hidden_delta*activations_derivatives;
+    const Index synaptic_weights_number = get_synaptic_weights_number();
 
-    return Tensor<type, 2>();
+    calculate_convolutions(inputs.data(), images_number, parameters.data(), parameters.data() + synaptic_weights_number, forward_propagation.combinations_4d);
 
+    forward_propagation.combinations_2d = forward_propagation.combinations_4d.reshape(Eigen::array<Index, 2>({images_number, get_neurons_number()}));
+
+    calculate_activations_derivatives(forward_propagation.combinations_2d,
+                                      forward_propagation.activations_2d,
+                                      forward_propagation.activations_derivatives_2d);
+
+    forward_propagation.activations_4d = forward_propagation.activations_2d.reshape(forward_propagation.combinations_4d.dimensions());
+    forward_propagation.activations_derivatives_4d = forward_propagation.activations_derivatives_2d.reshape(forward_propagation.combinations_4d.dimensions());
 }
 
 
-Tensor<type, 2> ConvolutionalLayer::calculate_hidden_delta_probabilistic(ProbabilisticLayer* next_layer_pointer,
-        const Tensor<type, 2>&,
-        const Tensor<type, 2>& activations_derivatives,
-        const Tensor<type, 2>& next_layer_delta) const
+void ConvolutionalLayer::calculate_output_delta(ForwardPropagation& forward_propagation,
+                                                const Tensor<type, 2>& output_gradient,
+                                                Tensor<type, 2>& output_delta) const
 {
+    output_delta.device(*thread_pool_device) = forward_propagation.activations_derivatives_2d*output_gradient;
+}
 
-        // Current layer's values
 
-        const Index images_number = next_layer_delta.dimension(0);
-        const Index filters_number = get_filters_number();
-        const Index output_rows_number = get_outputs_rows_number();
-        const Index output_columns_number = get_outputs_columns_number();
+void ConvolutionalLayer::calculate_hidden_delta(Layer* next_layer_pointer,
+                                                const Tensor<type, 2>&,
+                                                ForwardPropagation& forward_propagation,
+                                                const Tensor<type, 2>& next_layer_delta,
+                                                Tensor<type, 2>& hidden_delta) const
+{
+    const Type next_layer_type = next_layer_pointer->get_type();
 
-        // Next layer's values
+    switch(next_layer_type)
+    {
+        case Convolutional:
 
-        const Index next_layers_output_columns = next_layer_delta.dimension(1);
+        calculate_hidden_delta_convolutional(dynamic_cast<ConvolutionalLayer*>(next_layer_pointer),
+                                             forward_propagation.activations_derivatives_2d, next_layer_delta, hidden_delta);
 
-        const Tensor<type, 2> next_layers_weights = next_layer_pointer->get_synaptic_weights();
+        return;
 
-        // Hidden delta calculation
+        case Pooling:
 
-        Tensor<type, 4> hidden_delta(images_number, filters_number, output_rows_number, output_columns_number);
+        calculate_hidden_delta_pooling(dynamic_cast<PoolingLayer*>(next_layer_pointer),
+                                       forward_propagation.activations_derivatives_2d, next_layer_delta, hidden_delta);
 
-        const Index size = hidden_delta.size();
+        return;
 
-        #pragma omp parallel for
+        case Perceptron:
 
-        for(Index tensor_index = 0; tensor_index < size; tensor_index++)
-        {
-            const Index image_index = tensor_index/(filters_number*output_rows_number*output_columns_number);
-            const Index channel_index = (tensor_index/(output_rows_number*output_columns_number))%filters_number;
-            const Index row_index = (tensor_index/output_columns_number)%output_rows_number;
-            const Index column_index = tensor_index%output_columns_number;
+        calculate_hidden_delta_perceptron(dynamic_cast<PerceptronLayer*>(next_layer_pointer),
+                                          forward_propagation.activations_derivatives_2d, next_layer_delta, hidden_delta);
 
-            type sum = 0;
+        return;
 
-            for(Index sum_index = 0; sum_index < next_layers_output_columns; sum_index++)
-            {
-                const type delta_element = next_layer_delta(image_index, sum_index);
+        case Probabilistic:
 
-                const type weight = next_layers_weights(channel_index + row_index*filters_number + column_index*filters_number*output_rows_number, sum_index);
+        calculate_hidden_delta_probabilistic(dynamic_cast<ProbabilisticLayer*>(next_layer_pointer),
+                                             forward_propagation.activations_derivatives_2d, next_layer_delta, hidden_delta);
 
-                sum += delta_element*weight;
-            }
+        return;
 
-            hidden_delta(image_index, channel_index, row_index, column_index) = sum;
-        }
+        default:
 
-//        return hidden_delta*activations_derivatives;
+        return;
+    }
+}
 
-    return Tensor<type, 2>();
 
+void ConvolutionalLayer::calculate_hidden_delta_convolutional(ConvolutionalLayer* next_layer_pointer,
+                                                              const Tensor<type, 2>& activations_derivatives,
+                                                              const Tensor<type, 2>& next_layer_delta,
+                                                              Tensor<type, 2>& hidden_delta) const
+{
+    next_layer_pointer->calculate_inputs_delta(next_layer_delta, hidden_delta);
+
+    hidden_delta.device(*thread_pool_device) = hidden_delta*activations_derivatives;
 }
 
 
-Tensor<type, 1> ConvolutionalLayer::calculate_error_gradient(const Tensor<type, 2>& previous_layers_outputs,
-        const Layer::ForwardPropagation&,
-        const Tensor<type, 2>& layer_deltas)
+/// The delta of a pooling layer is taken with respect to its inputs,
+/// so that it is routed back with the positions of the maxima saved in its own forward propagation.
+
+void ConvolutionalLayer::calculate_hidden_delta_pooling(PoolingLayer*,
+                                                        const Tensor<type, 2>& activations_derivatives,
+                                                        const Tensor<type, 2>& next_layer_delta,
+                                                        Tensor<type, 2>& hidden_delta) const
 {
+    hidden_delta.device(*thread_pool_device) = next_layer_delta*activations_derivatives;
+}
 
-        Tensor<type, 2> layers_inputs;
 
-        switch(get_padding_option()) {
+void ConvolutionalLayer::calculate_hidden_delta_perceptron(PerceptronLayer* next_layer_pointer,
+                                                           const Tensor<type, 2>& activations_derivatives,
+                                                           const Tensor<type, 2>& next_layer_delta,
+                                                           Tensor<type, 2>& hidden_delta) const
+{
+    const Tensor<type, 2>& next_synaptic_weights = next_layer_pointer->get_synaptic_weights();
 
-            case OpenNN::ConvolutionalLayer::PaddingOption::NoPadding:
-            {
-                layers_inputs = previous_layers_outputs;
-            }
-            break;
+    hidden_delta.device(*thread_pool_device) = next_layer_delta.contract(next_synaptic_weights, A_BT);
 
-            case OpenNN::ConvolutionalLayer::PaddingOption::Same:
-            {
-//                layers_inputs.resize(previous_layers_outputs.dimension(0),
-//                                     previous_layers_outputs.dimension(1),
-//                                     previous_layers_outputs.dimension(2) + get_padding_height(),
-//                                     previous_layers_outputs.dimension(3) + get_padding_width());
+    hidden_delta.device(*thread_pool_device) = hidden_delta*activations_derivatives;
+}
 
-                for(Index image_number = 0; image_number < previous_layers_outputs.dimension(0); image_number++)
-                {
-                    //layers_inputs.set_tensor(image_number, insert_padding(previous_layers_outputs.get_tensor(image_number)));
-                }
-            }
-            break;
-        }
 
-        // Gradient declaration and values used
+void ConvolutionalLayer::calculate_hidden_delta_probabilistic(ProbabilisticLayer* next_layer_pointer,
+                                                              const Tensor<type, 2>& activations_derivatives,
+                                                              const Tensor<type, 2>& next_layer_delta,
+                                                              Tensor<type, 2>& hidden_delta) const
+{
+    const Tensor<type, 2>& next_synaptic_weights = next_layer_pointer->get_synaptic_weights();
 
-        const Index parameters_number = get_parameters_number();
+    hidden_delta.device(*thread_pool_device) = next_layer_delta.contract(next_synaptic_weights, A_BT);
 
-        Tensor<type, 1> layer_error_gradient(parameters_number);
-        layer_error_gradient.setZero();
+    hidden_delta.device(*thread_pool_device) = hidden_delta*activations_derivatives;
+}
 
-        const Index images_number = layer_deltas.dimension(0);
-        const Index filters_number = get_filters_number();
-        const Index filters_channels_number = get_filters_channels_number();
-        const Index filters_rows_number = get_filters_rows_number();
-        const Index filters_columns_number = get_filters_columns_number();
-        const Index output_rows_number = get_outputs_rows_number();
-        const Index output_columns_number = get_outputs_columns_number();
 
-        // Synaptic weights
+/// Calculates the derivatives of the error with respect to the inputs of the layer (col2im).
+/// The deltas are multiplied by the transposed filters, and the resulting patches are added back to the image positions they were taken from.
+/// @param delta Deltas of the layer, with one flattened image in each row.
+/// @param inputs_delta Matrix where the derivatives are saved, with one flattened image in each row and ordered as set in the inputs layout.
 
-        const Index synaptic_weights_number = get_synaptic_weights_number();
+void ConvolutionalLayer::calculate_inputs_delta(const Tensor<type, 2>& delta, Tensor<type, 2>& inputs_delta) const
+{
+    const Index images_number = delta.dimension(0);
 
-        for(Index gradient_index = 0; gradient_index < synaptic_weights_number; gradient_index++)
-        {
-            Index filter_index = gradient_index%filters_number;
-            Index channel_index = (gradient_index/filters_number)%filters_channels_number;
-            Index row_index = (gradient_index/(filters_number*filters_channels_number))%filters_rows_number;
-            Index column_index = (gradient_index/(filters_number*filters_channels_number*filters_rows_number))%filters_columns_number;
+    const Index channels_number = get_inputs_channels_number();
+    const Index inputs_rows_number = get_inputs_rows_number();
+    const Index inputs_columns_number = get_inputs_columns_number();
 
-            type sum = 0;
+    const Index filters_number = get_filters_number();
+    const Index filters_rows_number = get_filters_rows_number();
+    const Index filters_columns_number = get_filters_columns_number();
 
-            for(Index i = 0; i < images_number; i++)
-            {
-                for(Index j = 0; j < output_rows_number; j++)
-                {
-                    for(Index k = 0; k < output_columns_number; k++)
-                    {
-//                        const type delta_element = layer_deltas(i, filter_index, j, k);
+    const Index outputs_rows_number = get_outputs_rows_number();
+    const Index outputs_columns_number = get_outputs_columns_number();
 
-//                        const type input_element = layers_inputs(i, channel_index, j*row_stride + row_index, k*column_stride + column_index);
+    const Index padding_top = get_padding_height()/2;
+    const Index padding_left = get_padding_width()/2;
 
-//                        sum += delta_element*input_element;
-                    }
-                }
-            }
+    const Index patch_size = channels_number*filters_rows_number*filters_columns_number;
+    const Index patches_number = images_number*outputs_rows_number*outputs_columns_number;
 
-            layer_error_gradient[gradient_index] += sum;
-        }
+    const TensorMap<Tensor<type, 2>> filters(const_cast<type*>(synaptic_weights.data()), filters_number, patch_size);
 
-        // Biases
+    Tensor<type, 2> patches_delta(patches_number, patch_size);
 
-        for(Index gradient_index = synaptic_weights_number; gradient_index < parameters_number; gradient_index++)
-        {
-            Index bias_index = gradient_index - synaptic_weights_number;
+    patches_delta.device(*thread_pool_device)
+            = delta.reshape(Eigen::array<Index, 4>({images_number, filters_number, outputs_rows_number, outputs_columns_number}))
+                   .shuffle(Eigen::array<Index, 4>({0, 2, 3, 1}))
+                   .reshape(Eigen::array<Index, 2>({patches_number, filters_number}))
+                   .contract(filters, A_B);
+
+    Index channels_step;
+    Index rows_step;
+    Index columns_step;
+
+    get_inputs_steps(images_number, channels_step, rows_step, columns_step);
 
-            type sum = 0;
+    inputs_delta.resize(images_number, get_inputs_number());
+    inputs_delta.setZero();
+
+    // Patches overlap, so the images are split into blocks to add them without races
+
+    const Index block_size = 8;
+    const Index blocks_number = (images_number + block_size - 1)/block_size;
+
+    #pragma omp parallel for
+
+    for(Index block = 0; block < blocks_number; block++)
+    {
+        const Index first_image = block*block_size;
+        const Index block_images_number = min(block_size, images_number - first_image);
+
+        for(Index patch_index = 0; patch_index < patch_size; patch_index++)
+        {
+            const Index channel = patch_index%channels_number;
+            const Index filter_row = (patch_index/channels_number)%filters_rows_number;
+            const Index filter_column = patch_index/(channels_number*filters_rows_number);
 
-            for(Index i = 0; i < images_number; i++)
+            for(Index output_column = 0; output_column < outputs_columns_number; output_column++)
             {
-                for(Index j = 0; j < output_rows_number; j++)
+                const Index column = output_column*column_stride + filter_column - padding_left;
+
+                if(column < 0 || column >= inputs_columns_number) continue;
+
+                for(Index output_row = 0; output_row < outputs_rows_number; output_row++)
                 {
-                    for(Index k = 0; k < output_columns_number; k++)
-                    {
-                        //const type delta_element = layer_deltas(i, bias_index, j, k);
+                    const Index row = output_row*row_stride + filter_row - padding_top;
+
+                    if(row < 0 || row >= inputs_rows_number) continue;
+
+                    const type* patch_data = patches_delta.data()
+                                           + patch_index*patches_number
+                                           + images_number*(output_row + outputs_rows_number*output_column)
+                                           + first_image;
 
-                        //sum += delta_element;
-                    }
+                    type* image_data = inputs_delta.data() + channel*channels_step + row*rows_step + column*columns_step + first_image;
+
+                    for(Index i = 0; i < block_images_number; i++) image_data[i] += patch_data[i];
                 }
             }
-
-            layer_error_gradient[gradient_index] += sum;
         }
+    }
+}
+
+
+/// Calculates the derivatives of the error with respect to the filters and biases of the layer,
+/// as the product of the deltas with the image patches.
+/// @param inputs Batch of images, with one flattened image in each row.
+/// @param back_propagation Structure with the deltas of the layer, where the derivatives are saved.
+
+void ConvolutionalLayer::calculate_error_gradient(const Tensor<type, 2>& inputs,
+                                                  const Layer::ForwardPropagation&,
+                                                  Layer::BackPropagation& back_propagation) const
+{
+    const Index images_number = inputs.dimension(0);
+
+    const Index filters_number = get_filters_number();
+    const Index outputs_rows_number = get_outputs_rows_number();
+    const Index outputs_columns_number = get_outputs_columns_number();
 
-        return layer_error_gradient;
+    const Index patches_number = images_number*outputs_rows_number*outputs_columns_number;
 
-//    return Tensor<type, 1>();
+    Tensor<type, 2> patches;
 
+    calculate_image_patches(inputs.data(), images_number, patches);
+
+    Tensor<type, 2> patches_delta(patches_number, filters_number);
+
+    patches_delta.device(*thread_pool_device)
+            = back_propagation.delta.reshape(Eigen::array<Index, 4>({images_number, filters_number, outputs_rows_number, outputs_columns_number}))
+                                    .shuffle(Eigen::array<Index, 4>({0, 2, 3, 1}))
+                                    .reshape(Eigen::array<Index, 2>({patches_number, filters_number}));
+
+    back_propagation.biases_derivatives.device(*thread_pool_device) = patches_delta.sum(Eigen::array<Index, 1>({0}));
+
+    back_propagation.synaptic_weights_derivatives.device(*thread_pool_device) = patches_delta.contract(patches, AT_B);
+}
+
+
+void ConvolutionalLayer::insert_gradient(const BackPropagation& back_propagation, const Index& index, Tensor<type, 1>& gradient) const
+{
+    const Index biases_number = biases.size();
+    const Index synaptic_weights_number = get_synaptic_weights_number();
+
+    memcpy(gradient.data() + index,
+           back_propagation.synaptic_weights_derivatives.data(),
+           static_cast<size_t>(synaptic_weights_number)*sizeof(type));
+
+    memcpy(gradient.data() + index + synaptic_weights_number,
+           back_propagation.biases_derivatives.data(),
+           static_cast<size_t>(biases_number)*sizeof(type));
 }
 
 
@@ -556,6 +699,22 @@ ConvolutionalLayer::ActivationFunction ConvolutionalLayer::get_activation_functi
 }
 
 
+/// Returns the ordering of the input images.
+
+ConvolutionalLayer::InputsLayout ConvolutionalLayer::get_inputs_layout() const
+{
+    return inputs_layout;
+}
+
+
+/// Returns the number of channels, rows and columns of the input images.
+
+Tensor<Index, 1> ConvolutionalLayer::get_input_variables_dimensions() const
+{
+    return input_variables_dimensions;
+}
+
+
 /// Returns the number of rows the result of applying the layer's filters to an image will have.
 
 Index ConvolutionalLayer::get_outputs_rows_number() const
@@ -651,6 +810,7 @@ Index ConvolutionalLayer::get_filters_columns_number() const
 
 
 /// Returns the total number of columns of zeroes to be added to an image before applying a filter, which depends on the padding option set.
+/// With the same padding, the outputs have the inputs columns number divided by the column stride, rounded up.
 
 Index ConvolutionalLayer::get_padding_width() const
 {
@@ -663,7 +823,11 @@ Index ConvolutionalLayer::get_padding_width() const
 
     case Same:
     {
-        return column_stride*(input_variables_dimensions[2] - 1) - input_variables_dimensions[2] + get_filters_columns_number();
+        const Index inputs_columns_number = input_variables_dimensions[2];
+
+        const Index outputs_columns_number = (inputs_columns_number + column_stride - 1)/column_stride;
+
+        return max<Index>((outputs_columns_number - 1)*column_stride + get_filters_columns_number() - inputs_columns_number, 0);
     }
     }
 
@@ -672,6 +836,7 @@ Index ConvolutionalLayer::get_padding_width() const
 
 
 /// Returns the total number of rows of zeroes to be added to an image before applying a filter, which depends on the padding option set.
+/// With the same padding, the outputs have the inputs rows number divided by the row stride, rounded up.
 
 Index ConvolutionalLayer::get_padding_height() const
 {
@@ -684,7 +849,11 @@ Index ConvolutionalLayer::get_padding_height() const
 
     case Same:
     {
-        return row_stride*(input_variables_dimensions[1] - 1) - input_variables_dimensions[1] + get_filters_rows_number();
+        const Index inputs_rows_number = input_variables_dimensions[1];
+
+        const Index outputs_rows_number = (inputs_rows_number + row_stride - 1)/row_stride;
+
+        return max<Index>((outputs_rows_number - 1)*row_stride + get_filters_rows_number() - inputs_rows_number, 0);
     }
     }
 
@@ -708,11 +877,15 @@ Index ConvolutionalLayer::get_neurons_number() const
 
 Tensor<type, 1> ConvolutionalLayer::get_parameters() const
 {
+    const Index synaptic_weights_number = synaptic_weights.size();
 
-//        return synaptic_weights.to_vector().assemble(biases);
+    Tensor<type, 1> parameters(get_parameters_number());
 
-    return Tensor<type, 1>();
+    memcpy(parameters.data(), synaptic_weights.data(), static_cast<size_t>(synaptic_weights_number)*sizeof(type));
 
+    memcpy(parameters.data() + synaptic_weights_number, biases.data(), static_cast<size_t>(biases.size())*sizeof(type));
+
+    return parameters;
 }
 
 
@@ -768,18 +941,18 @@ void ConvolutionalLayer::set(const Tensor<Index, 1>& new_inputs_dimensions, cons
 
 #endif
 
-//        input_variables_dimensions.set(new_inputs_dimensions);
+    input_variables_dimensions = new_inputs_dimensions;
+
+    const Index filters_number = new_filters_dimensions[0];
+    const Index filters_channels_number = new_inputs_dimensions[0];
+    const Index filters_rows_number = new_filters_dimensions[1];
+    const Index filters_columns_number = new_filters_dimensions[2];
 
-        const Index filters_number = new_filters_dimensions[0];
-        const Index filters_channels_number = new_inputs_dimensions[0];
-        const Index filters_rows_number = new_filters_dimensions[1];
-        const Index filters_columns_number = new_filters_dimensions[2];
+    biases.resize(filters_number);
 
-        biases.resize(filters_number);
-        biases.setRandom<Eigen::internal::NormalRandomGenerator<type>>();
+    synaptic_weights.resize(filters_number, filters_channels_number, filters_rows_number, filters_columns_number);
 
-//        synaptic_weights.resize(filters_number, filters_channels_number, filters_rows_number, filters_columns_number);
-        synaptic_weights.setRandom<Eigen::internal::NormalRandomGenerator<type>>();
+    set_parameters_random();
 
 }
 
@@ -813,6 +986,16 @@ void ConvolutionalLayer::set_parameters_constant(const type& value)
 }
 
 
+/// Initializes the layer's parameters with random values from a normal distribution.
+
+void ConvolutionalLayer::set_parameters_random()
+{
+    biases.setRandom<Eigen::internal::NormalRandomGenerator<type>>();
+
+    synaptic_weights.setRandom<Eigen::internal::NormalRandomGenerator<type>>();
+}
+
+
 /// Sets the layer's activation function.
 /// @param new_activation_function The desired activation function.
 
@@ -834,12 +1017,21 @@ void ConvolutionalLayer::set_biases(const Tensor<type, 1>& new_biases)
 /// Sets the layer's synaptic weights.
 /// @param new_synaptic_weights The desired synaptic weights.
 
-void ConvolutionalLayer::set_synaptic_weights(const Tensor<type, 2>& new_synaptic_weights)
+void ConvolutionalLayer::set_synaptic_weights(const Tensor<type, 4>& new_synaptic_weights)
 {
     synaptic_weights = new_synaptic_weights;
 }
 
 
+/// Sets the ordering of the input images.
+/// @param new_inputs_layout The desired layout, NCHW or NHWC.
+
+void ConvolutionalLayer::set_inputs_layout(const ConvolutionalLayer::InputsLayout& new_inputs_layout)
+{
+    inputs_layout = new_inputs_layout;
+}
+
+
 /// Sets the padding option.
 /// @param new_padding_option The desired padding option.
 
@@ -879,22 +1071,33 @@ void ConvolutionalLayer::set_column_stride(const Index& new_stride_column)
 
 /// Sets the synaptic weights and biases to the given values.
 /// @param new_parameters A vector containing the synaptic weights and biases, in this order.
+/// @param index Position of the first parameter of the layer in the vector.
 
-void ConvolutionalLayer::set_parameters(const Tensor<type, 1>& new_parameters, const Index& )
+void ConvolutionalLayer::set_parameters(const Tensor<type, 1>& new_parameters, const Index& index)
 {
     const Index synaptic_weights_number = synaptic_weights.size();
 
+#ifdef __OPENNN_DEBUG__
+
     const Index parameters_number = get_parameters_number();
 
-    const Index filters_number = get_filters_number();
-    const Index filters_channels_number = get_filters_channels_number();
-    const Index filters_rows_number = get_filters_rows_number();
-    const Index filters_columns_number = get_filters_columns_number();
+    if(new_parameters.size() < index + parameters_number)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: ConvolutionalLayer class.\n"
+               << "void set_parameters(const Tensor<type, 1>&, const Index&) method.\n"
+               << "Size of parameters (" << new_parameters.size() << ") must be at least index plus number of parameters ("
+               << index + parameters_number << ").\n";
+
+        throw logic_error(buffer.str());
+    }
 
-//        synaptic_weights = new_parameters.get_subvector(0, synaptic_weights_number-1).to_tensor({filters_number, filters_channels_number, filters_rows_number, filters_columns_number});
+#endif
 
-//        biases = new_parameters.get_subvector(synaptic_weights_number, parameters_number-1);
+    memcpy(synaptic_weights.data(), new_parameters.data() + index, static_cast<size_t>(synaptic_weights_number)*sizeof(type));
 
+    memcpy(biases.data(), new_parameters.data() + index + synaptic_weights_number, static_cast<size_t>(biases.size())*sizeof(type));
 }
 
 
@@ -907,14 +1110,22 @@ Tensor<type, 1> ConvolutionalLayer::get_biases() const
 
 
 
-/// Returns the layer's synaptic weights.
+/// Returns the layer's synaptic weights, with dimensions filters, channels, rows and columns.
 
-Tensor<type, 2> ConvolutionalLayer::get_synaptic_weights() const
+Tensor<type, 4> ConvolutionalLayer::get_synaptic_weights() const
 {
     return synaptic_weights;
 }
 
 
+/// Returns the number of synaptic weights of the layer.
+
+Index ConvolutionalLayer::get_synaptic_weights_number() const
+{
+    return synaptic_weights.size();
+}
+
+
 /// Returns the number of channels of the input.
 
 Index ConvolutionalLayer::get_inputs_channels_number() const
@@ -37,35 +37,17 @@ class ConvolutionalLayer : public Layer
 
 public:
 
-    struct ConvolutionalLayerForwardPropagation : ForwardPropagation
-    {
-        /// Default constructor.
-
-        explicit ConvolutionalLayerForwardPropagation() : ForwardPropagation(){}
-
-        virtual ~ConvolutionalLayerForwardPropagation() {}
-
-        void allocate()
-        {
-//            const ConvolutionalLayer* convolutional_layer = dynamic_cast<ConvolutionalLayer*>(trainable_layers_pointers[i]);
-
-//            const Index outputs_channels_number = convolutional_layer->get_filters_number();
-//            const Index outputs_rows_number = convolutional_layer->get_outputs_rows_number();
-//            const Index outputs_columns_number = convolutional_layer->get_outputs_columns_number();
-
-//            layers[i].combinations_2d.resize(Tensor<Index, 1>({batch_instances_number, outputs_channels_number, outputs_rows_number, outputs_columns_number}));
-//            layers[i].activations_2d.resize(Tensor<Index, 1>({batch_instances_number, outputs_channels_number, outputs_rows_number, outputs_columns_number}));
-//            layers[i].activations_derivatives.resize(Tensor<Index, 1>({batch_instances_number, outputs_channels_number, outputs_rows_number, outputs_columns_number}));
-        }
-
-    };
-
     /// Enumeration of available activation functions for the convolutional layer.
 
     enum ActivationFunction{Threshold, SymmetricThreshold, Logistic, HyperbolicTangent, Linear, RectifiedLinear, ExponentialLinear, ScaledExponentialLinear, SoftPlus, SoftSign, HardSigmoid};
 
     enum PaddingOption{NoPadding, Same};
 
+    /// Enumeration of the orderings of the images given to the layer.
+    /// NCHW stores the images as (images, channels, rows, columns) and NHWC as (images, rows, columns, channels).
+
+    enum InputsLayout{NCHW, NHWC};
+
     // Constructors
 
     explicit ConvolutionalLayer();
@@ -80,10 +62,16 @@ public:
 
     Tensor<type, 1> get_biases() const;
 
-    Tensor<type, 2> get_synaptic_weights() const;
+    Tensor<type, 4> get_synaptic_weights() const;
+
+    Index get_synaptic_weights_number() const;
 
     ActivationFunction get_activation_function() const;
 
+    InputsLayout get_inputs_layout() const;
+
+    Tensor<Index, 1> get_input_variables_dimensions() const;
+
     Tensor<Index, 1> get_outputs_dimensions() const;
 
     Index get_outputs_rows_number() const;
@@ -123,9 +111,11 @@ public:
 
     void set_activation_function(const ActivationFunction&);
 
+    void set_inputs_layout(const InputsLayout&);
+
     void set_biases(const Tensor<type, 1>&);
 
-    void set_synaptic_weights(const Tensor<type, 2>&);
+    void set_synaptic_weights(const Tensor<type, 4>&);
 
     void set_padding_option(const PaddingOption&);
 
@@ -143,55 +133,65 @@ public:
 
     void set_parameters_constant(const type&);
 
+    void set_parameters_random();
+
     // Combinations
 
-    void calculate_convolutions(const Tensor<type, 4>&, Tensor<type, 4>&) const
-    {
-    }
+    void calculate_image_patches(const type*, const Index&, Tensor<type, 2>&) const;
+
+    void calculate_convolutions(const Tensor<type, 4>&, Tensor<type, 4>&) const;
 
     // Activation
 
-    void calculate_activations(const Tensor<type, 4>&, Tensor<type, 4>&) const
-    {
+    void calculate_activations(const Tensor<type, 2>&, Tensor<type, 2>&) const;
 
-    }
+    void calculate_activations(const Tensor<type, 4>&, Tensor<type, 4>&) const;
 
-    void calculate_activations_derivatives(const Tensor<type, 4>&, Tensor<type, 4>&) const
-    {
+    void calculate_activations_derivatives(const Tensor<type, 2>&, Tensor<type, 2>&, Tensor<type, 2>&) const;
 
-    }
+    void calculate_activations_derivatives(const Tensor<type, 4>&, Tensor<type, 4>&, Tensor<type, 4>&) const;
 
    // Outputs
 
+   Tensor<type, 2> calculate_outputs(const Tensor<type, 2>&);
+
    Tensor<type, 4> calculate_outputs(const Tensor<type, 4>&);
 
-   void forward_propagate(const Tensor<type, 4>& inputs, ForwardPropagation& forward_propagation) const
-   {
-       calculate_convolutions(inputs, forward_propagation.combinations_4d);
+   void forward_propagate(const Tensor<type, 2>&, ForwardPropagation&) const;
 
-       calculate_activations(forward_propagation.combinations_4d, forward_propagation.activations_4d);
+   void forward_propagate(const Tensor<type, 4>&, ForwardPropagation&) const;
 
-       calculate_activations_derivatives(forward_propagation.combinations_4d, forward_propagation.activations_derivatives_4d);
-   }
+   void forward_propagate(const Tensor<type, 2>&, const TensorMap<Tensor<type, 1>>&, ForwardPropagation&) const;
 
    // Delta methods
 
-   Tensor<type, 2> calculate_hidden_delta(Layer*, const Tensor<type, 2>&, const Tensor<type, 2>&, const Tensor<type, 2>&) const;
+   void calculate_output_delta(ForwardPropagation&, const Tensor<type, 2>&, Tensor<type, 2>&) const;
+
+   void calculate_hidden_delta(Layer*, const Tensor<type, 2>&, ForwardPropagation&, const Tensor<type, 2>&, Tensor<type, 2>&) const;
+
+   void calculate_hidden_delta_convolutional(ConvolutionalLayer*, const Tensor<type, 2>&, const Tensor<type, 2>&, Tensor<type, 2>&) const;
+   void calculate_hidden_delta_pooling(PoolingLayer*, const Tensor<type, 2>&, const Tensor<type, 2>&, Tensor<type, 2>&) const;
+   void calculate_hidden_delta_perceptron(PerceptronLayer*, const Tensor<type, 2>&, const Tensor<type, 2>&, Tensor<type, 2>&) const;
+   void calculate_hidden_delta_probabilistic(ProbabilisticLayer*, const Tensor<type, 2>&, const Tensor<type, 2>&, Tensor<type, 2>&) const;
 
-   Tensor<type, 2> calculate_hidden_delta_convolutional(ConvolutionalLayer*, const Tensor<type, 2>&, const Tensor<type, 2>&, const Tensor<type, 4>&) const;
-   Tensor<type, 2> calculate_hidden_delta_pooling(PoolingLayer*, const Tensor<type, 2>&, const Tensor<type, 2>&, const Tensor<type, 2>&) const;
-   Tensor<type, 2> calculate_hidden_delta_perceptron(PerceptronLayer*, const Tensor<type, 2>&, const Tensor<type, 2>&, const Tensor<type, 2>&) const;
-   Tensor<type, 2> calculate_hidden_delta_probabilistic(ProbabilisticLayer*, const Tensor<type, 2>&, const Tensor<type, 2>&, const Tensor<type, 2>&) const;
+   void calculate_inputs_delta(const Tensor<type, 2>&, Tensor<type, 2>&) const;
 
    // Gradient methods
 
-   Tensor<type, 1> calculate_error_gradient(const Tensor<type, 2>&, const Layer::ForwardPropagation&, const Tensor<type, 2>&);
+   void calculate_error_gradient(const Tensor<type, 2>&, const Layer::ForwardPropagation&, Layer::BackPropagation&) const;
+
+   void insert_gradient(const BackPropagation&, const Index&, Tensor<type, 1>&) const;
 
 protected:
 
+   void calculate_convolutions(const type*, const Index&, const type*, const type*, Tensor<type, 4>&) const;
+
+   void get_inputs_steps(const Index&, Index&, Index&, Index&) const;
+
    /// This tensor containing conection strengths from a layer's inputs to its neurons.
+   /// Its dimensions are filters, channels, rows and columns.
 
-   Tensor<type, 2> synaptic_weights;
+   Tensor<type, 4> synaptic_weights;
 
    /// Bias is a neuron parameter that is summed with the neuron's weighted inputs
    /// and passed through the neuron's trabsfer function to generate the neuron's output.
@@ -202,10 +202,14 @@ protected:
 
    Index column_stride = 1;
 
+   /// Channels, rows and columns of the input images.
+
    Tensor<Index, 1> input_variables_dimensions;
 
    PaddingOption padding_option = NoPadding;
 
+   InputsLayout inputs_layout = NCHW;
+
    ActivationFunction activation_function = RectifiedLinear;
 
 #ifdef OPENNN_CUDA
@@ -86,6 +86,28 @@ CrossEntropyError::~CrossEntropyError()
 }
 
 
+/// Returns true if the neural network ends in a softmax probabilistic layer with several outputs.
+/// In that case softmax and cross entropy are differentiated together,
+/// and the output gradient is taken with respect to the combinations of the output layer.
+
+bool CrossEntropyError::has_softmax_outputs() const
+{
+    if(neural_network_pointer->get_outputs_number() == 1) return false;
+
+    const Index trainable_layers_number = neural_network_pointer->get_trainable_layers_number();
+
+    if(trainable_layers_number == 0) return false;
+
+    const Layer* output_layer_pointer = neural_network_pointer->get_trainable_layers_pointers()(trainable_layers_number-1);
+
+    if(output_layer_pointer->get_type() != Layer::Probabilistic) return false;
+
+    const ProbabilisticLayer* probabilistic_layer_pointer = static_cast<const ProbabilisticLayer*>(output_layer_pointer);
+
+    return probabilistic_layer_pointer->get_activation_function() == ProbabilisticLayer::Softmax;
+}
+
+
 void CrossEntropyError::calculate_error(const DataSet::Batch& batch,
                      const NeuralNetwork::ForwardPropagation& forward_propagation,
                      LossIndex::BackPropagation& back_propagation) const
@@ -158,11 +180,42 @@ void CrossEntropyError::calculate_multiple_error(const DataSet::Batch& batch,
 {
     const Index trainable_layers_number = neural_network_pointer->get_trainable_layers_number();
 
-    const Tensor<type, 2>& outputs = forward_propagation.layers[trainable_layers_number-1].activations_2d;
     const Tensor<type, 2>& targets = batch.targets_2d;
 
     Tensor<type, 0> cross_entropy_error;
-    cross_entropy_error.device(*thread_pool_device) = (targets*(outputs.log())).sum();
+
+    if(has_softmax_outputs())
+    {
+        // log(softmax(z)) = z - max(z) - log(sum(exp(z - max(z)))), which stays finite when outputs underflow
+
+        const Tensor<type, 2>& combinations = forward_propagation.layers[trainable_layers_number-1].combinations_2d;
+
+        const Index batch_instances_number = combinations.dimension(0);
+        const Index outputs_number = combinations.dimension(1);
+
+        const Eigen::array<Index, 1> columns_dimension({1});
+        const Eigen::array<Index, 2> column_shape({batch_instances_number, 1});
+        const Eigen::array<Index, 2> columns_broadcast({1, outputs_number});
+
+        Tensor<type, 1> maxima(batch_instances_number);
+        maxima.device(*thread_pool_device) = combinations.maximum(columns_dimension);
+
+        Tensor<type, 2> shifted_combinations(batch_instances_number, outputs_number);
+        shifted_combinations.device(*thread_pool_device)
+                = combinations - maxima.reshape(column_shape).broadcast(columns_broadcast);
+
+        Tensor<type, 1> logarithms(batch_instances_number);
+        logarithms.device(*thread_pool_device) = shifted_combinations.exp().sum(columns_dimension).log();
+
+        cross_entropy_error.device(*thread_pool_device)
+                = (targets*(shifted_combinations - logarithms.reshape(column_shape).broadcast(columns_broadcast))).sum();
+    }
+    else
+    {
+        const Tensor<type, 2>& outputs = forward_propagation.layers[trainable_layers_number-1].activations_2d;
+
+        cross_entropy_error.device(*thread_pool_device) = (targets*(outputs.log())).sum();
+    }
 
     back_propagation.error = -cross_entropy_error();
 }
@@ -214,7 +267,44 @@ void CrossEntropyError::calculate_multiple_output_gradient(const DataSet::Batch&
     const Tensor<type, 2>& targets = batch.targets_2d;
     const Tensor<type, 2>& outputs = forward_propagation.layers[trainable_layers_number-1].activations_2d;
 
-    back_propagation.output_gradient.device(*thread_pool_device) = -targets/outputs;
+    if(has_softmax_outputs())
+    {
+        // Gradient with respect to the softmax combinations, outputs*sum(targets) - targets
+
+        const Index batch_instances_number = targets.dimension(0);
+        const Index outputs_number = targets.dimension(1);
+
+        const Eigen::array<Index, 1> columns_dimension({1});
+        const Eigen::array<Index, 2> column_shape({batch_instances_number, 1});
+        const Eigen::array<Index, 2> columns_broadcast({1, outputs_number});
+
+        back_propagation.output_gradient.device(*thread_pool_device)
+                = outputs*targets.sum(columns_dimension).reshape(column_shape).broadcast(columns_broadcast) - targets;
+    }
+    else
+    {
+        back_propagation.output_gradient.device(*thread_pool_device) = -targets/outputs;
+    }
+}
+
+
+/// Calculates the delta of the output layer.
+/// With softmax outputs the output gradient is already the delta, and the Jacobian of softmax is not needed.
+
+void CrossEntropyError::calculate_output_delta(NeuralNetwork::ForwardPropagation& forward_propagation,
+                                               BackPropagation& back_propagation) const
+{
+    if(!has_softmax_outputs())
+    {
+        LossIndex::calculate_output_delta(forward_propagation, back_propagation);
+
+        return;
+    }
+
+    const Index trainable_layers_number = neural_network_pointer->get_trainable_layers_number();
+
+    back_propagation.neural_network.layers(trainable_layers_number-1).delta.device(*thread_pool_device)
+            = back_propagation.output_gradient;
 }
 
 /// Returns a string with the name of the cross entropy error loss type, "CROSS_ENTROPY_ERROR".
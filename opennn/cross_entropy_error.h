@@ -52,6 +52,8 @@ public:
 
    virtual ~CrossEntropyError();
 
+   bool has_softmax_outputs() const;
+
    // Error methods
 
    void calculate_error(const DataSet::Batch& batch,
@@ -80,6 +82,11 @@ public:
                                            const NeuralNetwork::ForwardPropagation& forward_propagation,
                                            BackPropagation& back_propagation) const;
 
+   // Delta methods
+
+   void calculate_output_delta(NeuralNetwork::ForwardPropagation& forward_propagation,
+                               BackPropagation& back_propagation) const;
+
    string get_error_type() const;
    string get_error_type_text() const;
 
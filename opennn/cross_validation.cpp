@@ -0,0 +1,877 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   C R O S S   V A L I D A T I O N   C L A S S
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#include "cross_validation.h"
+
+namespace OpenNN
+{
+
+/// Default constructor.
+/// It creates a cross-validation not associated to any training strategy.
+
+CrossValidation::CrossValidation()
+{
+    set();
+}
+
+
+/// Training strategy constructor.
+/// @param new_training_strategy_pointer Pointer to the training strategy to be cross-validated.
+
+CrossValidation::CrossValidation(TrainingStrategy* new_training_strategy_pointer)
+{
+    set(new_training_strategy_pointer);
+}
+
+
+/// Destructor.
+/// It deletes the copies made by the workers.
+
+CrossValidation::~CrossValidation()
+{
+    delete_workers();
+}
+
+
+/// Returns a pointer to the training strategy which is cross-validated.
+
+TrainingStrategy* CrossValidation::get_training_strategy_pointer() const
+{
+    return training_strategy_pointer;
+}
+
+
+/// Returns the number of folds.
+
+const Index& CrossValidation::get_folds_number() const
+{
+    return folds_number;
+}
+
+
+/// Returns the method to split the instances into folds.
+
+const CrossValidation::PartitionMethod& CrossValidation::get_partition_method() const
+{
+    return partition_method;
+}
+
+
+/// Returns a string with the name of the method to split the instances into folds.
+
+string CrossValidation::write_partition_method() const
+{
+    switch(partition_method)
+    {
+    case Random:
+        return "Random";
+
+    case Stratified:
+        return "Stratified";
+
+    case Blocked:
+        return "Blocked";
+    }
+
+    return string();
+}
+
+
+/// Returns the ratio of the training instances of each fold which are used for selection.
+
+const type& CrossValidation::get_selection_instances_ratio() const
+{
+    return selection_instances_ratio;
+}
+
+
+/// Returns the number of folds which are trained at the same time.
+
+const Index& CrossValidation::get_workers_number() const
+{
+    return workers_number;
+}
+
+
+/// Returns the number of threads used by the thread pools of each worker.
+
+const Index& CrossValidation::get_worker_threads_number() const
+{
+    return worker_threads_number;
+}
+
+
+/// Returns true if messages from this class are to be displayed on the screen, or false if messages
+/// from this class are not to be displayed on the screen.
+
+const bool& CrossValidation::get_display() const
+{
+    return display;
+}
+
+
+/// Sets the training strategy pointer to nullptr and the rest of members to their default values.
+
+void CrossValidation::set()
+{
+    delete_workers();
+
+    training_strategy_pointer = nullptr;
+
+    set_default();
+}
+
+
+/// Sets a new training strategy to be cross-validated, and the rest of members to their default values.
+/// @param new_training_strategy_pointer Pointer to a training strategy object.
+
+void CrossValidation::set(TrainingStrategy* new_training_strategy_pointer)
+{
+    delete_workers();
+
+    training_strategy_pointer = new_training_strategy_pointer;
+
+    set_default();
+}
+
+
+/// Sets the members to their default values.
+/// The instances are split into five folds. The partition is stratified for classifiers, blocked for forecasting models,
+/// and random otherwise. All the available threads are used, with one thread per worker.
+
+void CrossValidation::set_default()
+{
+    folds_number = 5;
+
+    partition_method = Random;
+
+    if(training_strategy_pointer != nullptr && training_strategy_pointer->has_neural_network())
+    {
+        const NeuralNetwork* neural_network_pointer = training_strategy_pointer->get_neural_network_pointer();
+
+        if(neural_network_pointer->has_long_short_term_memory_layer() || neural_network_pointer->has_recurrent_layer())
+        {
+            partition_method = Blocked;
+        }
+        else if(neural_network_pointer->has_probabilistic_layer())
+        {
+            partition_method = Stratified;
+        }
+    }
+
+    selection_instances_ratio = 0;
+
+    workers_number = omp_get_max_threads();
+
+    worker_threads_number = 1;
+
+    display = true;
+}
+
+
+/// Sets a new training strategy to be cross-validated, keeping the rest of members.
+/// The copies of the previous training strategy are deleted.
+/// @param new_training_strategy_pointer Pointer to a training strategy object.
+
+void CrossValidation::set_training_strategy_pointer(TrainingStrategy* new_training_strategy_pointer)
+{
+    delete_workers();
+
+    training_strategy_pointer = new_training_strategy_pointer;
+}
+
+
+/// Sets the number of folds.
+/// @param new_folds_number Number of folds. It must be greater than one.
+
+void CrossValidation::set_folds_number(const Index& new_folds_number)
+{
+    if(new_folds_number < 2)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: CrossValidation class.\n"
+               << "void set_folds_number(const Index&) method.\n"
+               << "Number of folds (" << new_folds_number << ") must be greater than 1.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    folds_number = new_folds_number;
+}
+
+
+/// Sets the method to split the instances into folds.
+/// @param new_partition_method Partition method.
+
+void CrossValidation::set_partition_method(const PartitionMethod& new_partition_method)
+{
+    partition_method = new_partition_method;
+}
+
+
+/// Sets the method to split the instances into folds from a string.
+/// @param new_partition_method String with the name of the partition method: "Random", "Stratified" or "Blocked".
+
+void CrossValidation::set_partition_method(const string& new_partition_method)
+{
+    if(new_partition_method == "Random")
+    {
+        partition_method = Random;
+    }
+    else if(new_partition_method == "Stratified")
+    {
+        partition_method = Stratified;
+    }
+    else if(new_partition_method == "Blocked")
+    {
+        partition_method = Blocked;
+    }
+    else
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: CrossValidation class.\n"
+               << "void set_partition_method(const string&) method.\n"
+               << "Unknown partition method: " << new_partition_method << ".\n";
+
+        throw logic_error(buffer.str());
+    }
+}
+
+
+/// Sets the ratio of the training instances of each fold which are used for selection.
+/// @param new_selection_instances_ratio Ratio between 0 and 1. Zero means that the folds have no selection instances.
+
+void CrossValidation::set_selection_instances_ratio(const type& new_selection_instances_ratio)
+{
+    if(new_selection_instances_ratio < 0 || new_selection_instances_ratio >= 1)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: CrossValidation class.\n"
+               << "void set_selection_instances_ratio(const type&) method.\n"
+               << "Selection instances ratio (" << new_selection_instances_ratio << ") must be in [0, 1).\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    selection_instances_ratio = new_selection_instances_ratio;
+}
+
+
+/// Sets the number of folds which are trained at the same time.
+/// @param new_workers_number Number of workers.
+
+void CrossValidation::set_workers_number(const Index& new_workers_number)
+{
+#ifdef __OPENNN_DEBUG__
+
+    if(new_workers_number <= 0)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: CrossValidation class.\n"
+               << "void set_workers_number(const Index&) method.\n"
+               << "Number of workers must be greater than 0.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+#endif
+
+    workers_number = new_workers_number;
+}
+
+
+/// Sets the number of threads used by the thread pools of each worker.
+/// @param new_worker_threads_number Number of threads per worker.
+
+void CrossValidation::set_worker_threads_number(const Index& new_worker_threads_number)
+{
+#ifdef __OPENNN_DEBUG__
+
+    if(new_worker_threads_number <= 0)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: CrossValidation class.\n"
+               << "void set_worker_threads_number(const Index&) method.\n"
+               << "Number of threads per worker must be greater than 0.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+#endif
+
+    worker_threads_number = new_worker_threads_number;
+}
+
+
+/// Sets a new display value.
+/// If it is set to true messages from this class are to be displayed on the screen;
+/// if it is set to false messages from this class are not to be displayed on the screen.
+/// @param new_display Display value.
+
+void CrossValidation::set_display(const bool& new_display)
+{
+    display = new_display;
+}
+
+
+/// Splits the used instances of the data set into folds, and returns the indices of the instances of each fold.
+/// The instances uses of the data set are not modified.
+/// Random partitions shuffle the instances, stratified partitions deal the instances of each class, or the instances sorted by target value,
+/// in turns to the folds, and blocked partitions make contiguous folds in the order of the instances.
+
+Tensor<Tensor<Index, 1>, 1> CrossValidation::calculate_folds() const
+{
+    check();
+
+    const DataSet* data_set_pointer = training_strategy_pointer->get_loss_index_pointer()->get_data_set_pointer();
+
+    Tensor<Index, 1> used_instances_indices = data_set_pointer->get_used_instances_indices();
+
+    const Index used_instances_number = used_instances_indices.size();
+
+    if(used_instances_number < folds_number)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: CrossValidation class.\n"
+               << "Tensor<Tensor<Index, 1>, 1> calculate_folds() const method.\n"
+               << "Number of used instances (" << used_instances_number << ") must be greater or equal than the number of folds (" << folds_number << ").\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    Tensor<Tensor<Index, 1>, 1> folds(folds_number);
+
+    if(partition_method == Stratified)
+    {
+        const Tensor<Index, 1> stratified_order = calculate_stratified_order(used_instances_indices);
+
+        for(Index i = 0; i < folds_number; i++)
+        {
+            folds(i).resize((used_instances_number - i + folds_number - 1)/folds_number);
+        }
+
+        for(Index i = 0; i < used_instances_number; i++)
+        {
+            folds(i%folds_number)(i/folds_number) = stratified_order(i);
+        }
+
+        return folds;
+    }
+
+    if(partition_method == Random)
+    {
+        random_shuffle(used_instances_indices.data(), used_instances_indices.data() + used_instances_number);
+    }
+
+    for(Index i = 0; i < folds_number; i++)
+    {
+        const Index start = i*used_instances_number/folds_number;
+        const Index end = (i+1)*used_instances_number/folds_number;
+
+        folds(i).resize(end - start);
+
+        for(Index j = start; j < end; j++)
+        {
+            folds(i)(j - start) = used_instances_indices(j);
+        }
+    }
+
+    return folds;
+}
+
+
+/// Returns the instances uses of a fold: the instances of the fold are testing, and the rest of used instances are training,
+/// except a ratio of them which are selection. The selection instances are the last ones for blocked partitions, and random ones otherwise.
+/// @param folds Indices of the instances of each fold.
+/// @param fold_index Index of the fold.
+
+Tensor<DataSet::InstanceUse, 1> CrossValidation::calculate_fold_instances_uses(const Tensor<Tensor<Index, 1>, 1>& folds,
+                                                                                 const Index& fold_index) const
+{
+    check();
+
+    const DataSet* data_set_pointer = training_strategy_pointer->get_loss_index_pointer()->get_data_set_pointer();
+
+    const Index instances_number = data_set_pointer->get_instances_number();
+
+    Tensor<DataSet::InstanceUse, 1> instances_uses(instances_number);
+
+    instances_uses.setConstant(DataSet::UnusedInstance);
+
+    vector<Index> training_instances_indices;
+
+    for(Index i = 0; i < folds.size(); i++)
+    {
+        for(Index j = 0; j < folds(i).size(); j++)
+        {
+            if(i == fold_index)
+            {
+                instances_uses(folds(i)(j)) = DataSet::Testing;
+            }
+            else
+            {
+                instances_uses(folds(i)(j)) = DataSet::Training;
+
+                training_instances_indices.push_back(folds(i)(j));
+            }
+        }
+    }
+
+    const Index selection_instances_number
+            = static_cast<Index>(selection_instances_ratio*static_cast<type>(training_instances_indices.size()));
+
+    if(selection_instances_number == 0) return instances_uses;
+
+    if(partition_method == Blocked)
+    {
+        sort(training_instances_indices.begin(), training_instances_indices.end());
+    }
+    else
+    {
+        random_shuffle(training_instances_indices.begin(), training_instances_indices.end());
+    }
+
+    for(size_t i = training_instances_indices.size() - static_cast<size_t>(selection_instances_number); i < training_instances_indices.size(); i++)
+    {
+        instances_uses(training_instances_indices[i]) = DataSet::Selection;
+    }
+
+    return instances_uses;
+}
+
+
+/// Trains and tests all the folds, as many at the same time as workers, and returns their results and aggregates.
+/// Each fold starts from the parameters of the original neural network.
+/// The original data set, neural network and training strategy are not modified.
+
+CrossValidation::Results CrossValidation::perform_cross_validation()
+{
+    const Tensor<Tensor<Index, 1>, 1> folds = calculate_folds();
+
+    // The partitions are made before the workers start, so that the random ones only depend on the seed
+
+    Tensor<Tensor<DataSet::InstanceUse, 1>, 1> folds_instances_uses(folds_number);
+
+    for(Index i = 0; i < folds_number; i++)
+    {
+        folds_instances_uses(i) = calculate_fold_instances_uses(folds, i);
+    }
+
+    const Tensor<type, 1> initial_parameters = training_strategy_pointer->get_neural_network_pointer()->get_parameters();
+
+    if(display)
+    {
+        cout << "Performing " << folds_number << "-fold cross-validation with " << write_partition_method() << " partition...\n";
+    }
+
+    const chrono::steady_clock::time_point beginning_time = chrono::steady_clock::now();
+
+    // The workers are made again for each cross-validation, so that they copy the current originals and folds number
+
+    delete_workers();
+
+    create_workers();
+
+    Results results;
+
+    results.folds.resize(folds_number);
+
+    const int threads_number = static_cast<int>(workers.size());
+
+    string error_message;
+
+    #pragma omp parallel for schedule(dynamic) num_threads(threads_number)
+    for(Index i = 0; i < folds_number; i++)
+    {
+        Worker* worker = workers(omp_get_thread_num());
+
+        try
+        {
+            results.folds(i).testing_instances_indices = folds(i);
+
+            perform_fold(i, folds_instances_uses(i), initial_parameters, worker, results.folds(i));
+        }
+        catch(const exception& e)
+        {
+            #pragma omp critical
+            error_message = e.what();
+        }
+    }
+
+    delete_workers();
+
+    if(!error_message.empty())
+    {
+        throw logic_error(error_message);
+    }
+
+    results.elapsed_time = static_cast<type>(chrono::duration<double>(chrono::steady_clock::now() - beginning_time).count());
+
+    // Testing errors
+
+    const Index errors_number = results.folds(0).testing_errors.size();
+
+    results.testing_errors_mean.resize(errors_number);
+    results.testing_errors_mean.setZero();
+
+    results.testing_errors_standard_deviation.resize(errors_number);
+    results.testing_errors_standard_deviation.setZero();
+
+    for(Index i = 0; i < folds_number; i++)
+    {
+        results.testing_errors_mean += results.folds(i).testing_errors;
+    }
+
+    results.testing_errors_mean = results.testing_errors_mean/static_cast<type>(folds_number);
+
+    for(Index i = 0; i < folds_number; i++)
+    {
+        results.testing_errors_standard_deviation += (results.folds(i).testing_errors - results.testing_errors_mean).square();
+    }
+
+    results.testing_errors_standard_deviation = (results.testing_errors_standard_deviation/static_cast<type>(folds_number - 1)).sqrt();
+
+    // Classification
+
+    if(is_classification())
+    {
+        results.confusion = results.folds(0).confusion;
+
+        type accuracy_sum = 0;
+
+        for(Index i = 0; i < folds_number; i++)
+        {
+            if(i != 0) results.confusion += results.folds(i).confusion;
+
+            accuracy_sum += results.folds(i).accuracy;
+        }
+
+        results.accuracy_mean = accuracy_sum/static_cast<type>(folds_number);
+
+        type accuracy_squares_sum = 0;
+
+        for(Index i = 0; i < folds_number; i++)
+        {
+            accuracy_squares_sum += (results.folds(i).accuracy - results.accuracy_mean)*(results.folds(i).accuracy - results.accuracy_mean);
+        }
+
+        results.accuracy_standard_deviation = sqrt(accuracy_squares_sum/static_cast<type>(folds_number - 1));
+    }
+
+    if(display) results.print();
+
+    return results;
+}
+
+
+/// Deletes the copies of the data set, the neural network and the training strategy.
+/// They are made again from the originals each time the folds are trained.
+
+void CrossValidation::delete_workers()
+{
+    for(Index i = 0; i < workers.size(); i++)
+    {
+        delete workers(i);
+    }
+
+    workers.resize(0);
+}
+
+
+/// Prints to the screen the testing errors of each fold and their aggregates.
+
+void CrossValidation::Results::print() const
+{
+    const Index folds_number = folds.size();
+
+    cout << "Cross-validation results\n"
+         << "Fold\tSSE\tMSE\tRMSE\tNSE\tAccuracy\n";
+
+    for(Index i = 0; i < folds_number; i++)
+    {
+        cout << folds(i).fold_index;
+
+        for(Index j = 0; j < folds(i).testing_errors.size(); j++)
+        {
+            cout << "\t" << folds(i).testing_errors(j);
+        }
+
+        cout << "\t" << folds(i).accuracy << "\n";
+    }
+
+    cout << "Mean";
+
+    for(Index j = 0; j < testing_errors_mean.size(); j++) cout << "\t" << testing_errors_mean(j);
+
+    cout << "\t" << accuracy_mean << "\n"
+         << "Std";
+
+    for(Index j = 0; j < testing_errors_standard_deviation.size(); j++) cout << "\t" << testing_errors_standard_deviation(j);
+
+    cout << "\t" << accuracy_standard_deviation << "\n"
+         << "Elapsed time: " << elapsed_time << " s" << endl;
+
+    if(confusion.size() != 0) cout << "Confusion:\n" << confusion << endl;
+}
+
+
+/// Checks that the training strategy has a data set and a neural network.
+
+void CrossValidation::check() const
+{
+    ostringstream buffer;
+
+    if(!training_strategy_pointer)
+    {
+        buffer << "OpenNN Exception: CrossValidation class.\n"
+               << "void check() const method.\n"
+               << "Pointer to training strategy is nullptr.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    if(!training_strategy_pointer->has_neural_network() || !training_strategy_pointer->has_data_set())
+    {
+        buffer << "OpenNN Exception: CrossValidation class.\n"
+               << "void check() const method.\n"
+               << "Training strategy must have a neural network and a data set.\n";
+
+        throw logic_error(buffer.str());
+    }
+}
+
+
+/// Makes the copies of the data set, the neural network and the training strategy for each worker, one for each fold at most.
+/// The copies share a thread pool with the threads budget of one worker.
+
+void CrossValidation::create_workers()
+{
+    DataSet* data_set_pointer = training_strategy_pointer->get_loss_index_pointer()->get_data_set_pointer();
+
+    NeuralNetwork* neural_network_pointer = training_strategy_pointer->get_neural_network_pointer();
+
+    tinyxml2::XMLDocument neural_network_document;
+
+    write_XML_document(*neural_network_pointer, neural_network_document);
+
+    tinyxml2::XMLDocument training_strategy_document;
+
+    write_XML_document(*training_strategy_pointer, training_strategy_document);
+
+    const int threads_number = static_cast<int>(worker_threads_number);
+
+    const Index created_workers_number = min(workers_number, folds_number);
+
+    workers.resize(created_workers_number);
+
+    for(Index i = 0; i < created_workers_number; i++)
+    {
+        workers(i) = new Worker(worker_threads_number);
+
+        workers(i)->data_set.set(*data_set_pointer);
+        workers(i)->data_set.set_display(false);
+
+        workers(i)->neural_network.from_XML(neural_network_document);
+        workers(i)->neural_network.set_display(false);
+
+        workers(i)->training_strategy.set_neural_network_pointer(&workers(i)->neural_network);
+        workers(i)->training_strategy.set_data_set_pointer(&workers(i)->data_set);
+        workers(i)->training_strategy.from_XML(training_strategy_document);
+        workers(i)->training_strategy.set_display(false);
+
+        workers(i)->data_set.set_thread_pool_device(new ThreadPoolDevice(&workers(i)->thread_pool, threads_number));
+        workers(i)->neural_network.set_thread_pool_device(new ThreadPoolDevice(&workers(i)->thread_pool, threads_number));
+        workers(i)->training_strategy.set_thread_pool_device(new ThreadPoolDevice(&workers(i)->thread_pool, threads_number));
+    }
+}
+
+
+/// Returns the used instances in the order in which they are dealt to the folds by a stratified partition.
+/// The instances of classifiers are grouped by class, which is the target above 0.5 for one output and the maximal target otherwise,
+/// and they are shuffled within each class. The instances of other models are sorted by their first target.
+/// @param used_instances_indices Indices of the used instances.
+
+Tensor<Index, 1> CrossValidation::calculate_stratified_order(const Tensor<Index, 1>& used_instances_indices) const
+{
+    const DataSet* data_set_pointer = training_strategy_pointer->get_loss_index_pointer()->get_data_set_pointer();
+
+    const Tensor<type, 2>& data = data_set_pointer->get_data();
+
+    const Tensor<Index, 1> target_variables_indices = data_set_pointer->get_target_variables_indices();
+
+    const Index used_instances_number = used_instances_indices.size();
+    const Index targets_number = target_variables_indices.size();
+
+    vector<Index> order(used_instances_indices.data(), used_instances_indices.data() + used_instances_number);
+
+    if(targets_number == 0) return used_instances_indices;
+
+    if(!is_classification())
+    {
+        const Index target_index = target_variables_indices(0);
+
+        stable_sort(order.begin(), order.end(),
+                    [&data, target_index](const Index& a, const Index& b){return data(a, target_index) < data(b, target_index);});
+    }
+    else
+    {
+        const Index classes_number = targets_number == 1 ? 2 : targets_number;
+
+        vector<vector<Index>> classes(static_cast<size_t>(classes_number));
+
+        for(Index i = 0; i < used_instances_number; i++)
+        {
+            const Index instance_index = used_instances_indices(i);
+
+            Index class_index = 0;
+
+            if(targets_number == 1)
+            {
+                class_index = data(instance_index, target_variables_indices(0)) > static_cast<type>(0.5) ? 1 : 0;
+            }
+            else
+            {
+                for(Index j = 1; j < targets_number; j++)
+                {
+                    if(data(instance_index, target_variables_indices(j)) > data(instance_index, target_variables_indices(class_index)))
+                    {
+                        class_index = j;
+                    }
+                }
+            }
+
+            classes[static_cast<size_t>(class_index)].push_back(instance_index);
+        }
+
+        order.clear();
+
+        for(size_t i = 0; i < classes.size(); i++)
+        {
+            random_shuffle(classes[i].begin(), classes[i].end());
+
+            order.insert(order.end(), classes[i].begin(), classes[i].end());
+        }
+    }
+
+    Tensor<Index, 1> stratified_order(used_instances_number);
+
+    copy(order.begin(), order.end(), stratified_order.data());
+
+    return stratified_order;
+}
+
+
+/// Trains and tests a fold with a worker.
+/// @param fold_index Index of the fold.
+/// @param instances_uses Instances uses of the fold.
+/// @param initial_parameters Parameters of the original neural network.
+/// @param worker Worker which trains the fold.
+/// @param fold_results Results of the fold.
+
+void CrossValidation::perform_fold(const Index& fold_index,
+                                   const Tensor<DataSet::InstanceUse, 1>& instances_uses,
+                                   const Tensor<type, 1>& initial_parameters,
+                                   Worker* worker,
+                                   FoldResults& fold_results) const
+{
+    DataSet* data_set_pointer = &worker->data_set;
+
+    NeuralNetwork* neural_network_pointer = &worker->neural_network;
+
+    TrainingStrategy* training_strategy_pointer = &worker->training_strategy;
+
+    data_set_pointer->set_instances_uses(instances_uses);
+
+    // The normalization coefficients and the weights depend on the training and selection instances
+
+    if(training_strategy_pointer->get_loss_method() == TrainingStrategy::NORMALIZED_SQUARED_ERROR)
+    {
+        NormalizedSquaredError* normalized_squared_error_pointer = training_strategy_pointer->get_normalized_squared_error_pointer();
+
+        normalized_squared_error_pointer->set_normalization_coefficient();
+
+        if(data_set_pointer->has_selection()) normalized_squared_error_pointer->set_selection_normalization_coefficient();
+    }
+    else if(training_strategy_pointer->get_loss_method() == TrainingStrategy::WEIGHTED_SQUARED_ERROR)
+    {
+        WeightedSquaredError* weighted_squared_error_pointer = training_strategy_pointer->get_weighted_squared_error_pointer();
+
+        weighted_squared_error_pointer->set_weights();
+        weighted_squared_error_pointer->set_normalization_coefficient();
+    }
+
+    Tensor<type, 1> parameters = initial_parameters;
+
+    neural_network_pointer->set_parameters(parameters);
+
+    fold_results.fold_index = fold_index;
+
+    fold_results.training_results = training_strategy_pointer->perform_training();
+
+    fold_results.parameters = neural_network_pointer->get_parameters();
+
+    // Testing analysis
+
+    TestingAnalysis testing_analysis(neural_network_pointer, data_set_pointer);
+
+    testing_analysis.set_display(false);
+
+    fold_results.testing_errors = testing_analysis.calculate_testing_errors();
+
+    if(is_classification())
+    {
+        fold_results.confusion = testing_analysis.calculate_confusion();
+
+        Index correct_instances_number = 0;
+
+        for(Index i = 0; i < fold_results.confusion.dimension(0); i++)
+        {
+            correct_instances_number += fold_results.confusion(i, i);
+        }
+
+        const Tensor<Index, 0> instances_number = fold_results.confusion.sum();
+
+        fold_results.accuracy = instances_number(0) == 0
+                ? 0
+                : static_cast<type>(correct_instances_number)/static_cast<type>(instances_number(0));
+    }
+}
+
+
+/// Returns true if the neural network is a classifier, that is, if it has a probabilistic layer.
+
+bool CrossValidation::is_classification() const
+{
+    return training_strategy_pointer->get_neural_network_pointer()->has_probabilistic_layer();
+}
+
+}
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
@@ -0,0 +1,272 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   C R O S S   V A L I D A T I O N   C L A S S   H E A D E R
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#ifndef CROSSVALIDATION_H
+#define CROSSVALIDATION_H
+
+// System includes
+
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <omp.h>
+
+// OpenNN includes
+
+#include "config.h"
+#include "data_set.h"
+#include "neural_network.h"
+#include "training_strategy.h"
+#include "testing_analysis.h"
+
+namespace OpenNN
+{
+
+/// This class estimates the generalization performance of a training strategy by k-fold cross-validation.
+
+///
+/// The used instances are split into k folds, which are index partitions computed without modifying the instances uses of the data set.
+/// The partitions are random, stratified by class or by target value, or blocked in time order for forecasting.
+/// Each fold is tested with a model trained on the rest of the instances, starting from the parameters of the original neural network.
+/// The folds are trained concurrently by workers, each one owning a copy of the data set, the neural network and the training strategy,
+/// as the workers of TrainingScheduler do. The testing errors, the confusion matrices and the accuracies of the folds are aggregated.
+
+class CrossValidation
+{
+
+public:
+
+   // Constructors
+
+   explicit CrossValidation();
+
+   explicit CrossValidation(TrainingStrategy*);
+
+   // Destructor
+
+   virtual ~CrossValidation();
+
+   /// Enumeration of the methods to split the instances into folds.
+
+   enum PartitionMethod{Random, Stratified, Blocked};
+
+   /// This structure contains the results of a fold.
+
+   struct FoldResults
+   {
+       /// Default constructor.
+
+       explicit FoldResults() {}
+
+       virtual ~FoldResults() {}
+
+       /// Index of the fold.
+
+       Index fold_index = 0;
+
+       /// Indices of the instances tested by the fold.
+
+       Tensor<Index, 1> testing_instances_indices;
+
+       /// Results of the training of the fold.
+
+       OptimizationAlgorithm::Results training_results;
+
+       /// Parameters of the neural network trained by the fold.
+
+       Tensor<type, 1> parameters;
+
+       /// Sum squared error, mean squared error, root mean squared error and normalized squared error of the testing instances.
+
+       Tensor<type, 1> testing_errors;
+
+       /// Confusion matrix of the testing instances, only for classification.
+
+       Tensor<Index, 2> confusion;
+
+       /// Accuracy of the testing instances, or NaN if the model is not a classifier.
+
+       type accuracy = numeric_limits<type>::quiet_NaN();
+   };
+
+   /// This structure contains the results of all the folds and their aggregates.
+
+   struct Results
+   {
+       /// Default constructor.
+
+       explicit Results() {}
+
+       virtual ~Results() {}
+
+       void print() const;
+
+       /// Results of each fold.
+
+       Tensor<FoldResults, 1> folds;
+
+       /// Mean and standard deviation across the folds of each testing error.
+
+       Tensor<type, 1> testing_errors_mean;
+
+       Tensor<type, 1> testing_errors_standard_deviation;
+
+       /// Sum of the confusion matrices of the folds, only for classification.
+
+       Tensor<Index, 2> confusion;
+
+       /// Mean and standard deviation across the folds of the accuracy, or NaN if the model is not a classifier.
+
+       type accuracy_mean = numeric_limits<type>::quiet_NaN();
+
+       type accuracy_standard_deviation = numeric_limits<type>::quiet_NaN();
+
+       /// Wall clock time of the cross-validation, in seconds.
+
+       type elapsed_time = 0;
+   };
+
+   // Get methods
+
+   TrainingStrategy* get_training_strategy_pointer() const;
+
+   const Index& get_folds_number() const;
+
+   const PartitionMethod& get_partition_method() const;
+   string write_partition_method() const;
+
+   const type& get_selection_instances_ratio() const;
+
+   const Index& get_workers_number() const;
+   const Index& get_worker_threads_number() const;
+
+   const bool& get_display() const;
+
+   // Set methods
+
+   void set();
+   void set(TrainingStrategy*);
+
+   void set_default();
+
+   void set_training_strategy_pointer(TrainingStrategy*);
+
+   void set_folds_number(const Index&);
+
+   void set_partition_method(const PartitionMethod&);
+   void set_partition_method(const string&);
+
+   void set_selection_instances_ratio(const type&);
+
+   void set_workers_number(const Index&);
+   void set_worker_threads_number(const Index&);
+
+   void set_display(const bool&);
+
+   // Partition methods
+
+   Tensor<Tensor<Index, 1>, 1> calculate_folds() const;
+
+   Tensor<DataSet::InstanceUse, 1> calculate_fold_instances_uses(const Tensor<Tensor<Index, 1>, 1>&, const Index&) const;
+
+   // Cross-validation methods
+
+   Results perform_cross_validation();
+
+   void delete_workers();
+
+private:
+
+   /// Copy of the data set, neural network and training strategy used by one thread.
+
+   struct Worker
+   {
+       explicit Worker(const Index& threads_number) : thread_pool(static_cast<int>(threads_number)) {}
+
+       virtual ~Worker() {}
+
+       /// Thread pool of the copies, declared first so that it is destroyed after them.
+
+       NonBlockingThreadPool thread_pool;
+
+       DataSet data_set;
+
+       NeuralNetwork neural_network;
+
+       TrainingStrategy training_strategy;
+   };
+
+   void check() const;
+
+   void create_workers();
+
+   Tensor<Index, 1> calculate_stratified_order(const Tensor<Index, 1>&) const;
+
+   void perform_fold(const Index&, const Tensor<DataSet::InstanceUse, 1>&, const Tensor<type, 1>&, Worker*, FoldResults&) const;
+
+   bool is_classification() const;
+
+   /// Pointer to the training strategy to be copied by the workers.
+
+   TrainingStrategy* training_strategy_pointer = nullptr;
+
+   /// Copies of the training strategy, one for each worker, which only exist while the folds are trained.
+
+   Tensor<Worker*, 1> workers;
+
+   /// Number of folds.
+
+   Index folds_number = 5;
+
+   /// Method to split the instances into folds.
+
+   PartitionMethod partition_method = Random;
+
+   /// Ratio of the training instances of each fold which are used for selection.
+
+   type selection_instances_ratio = 0;
+
+   /// Number of folds trained at the same time.
+
+   Index workers_number = 1;
+
+   /// Number of threads of the thread pools of each worker.
+
+   Index worker_threads_number = 1;
+
+   /// Display messages to screen.
+
+   bool display = true;
+};
+
+}
+
+#endif
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
@@ -0,0 +1,112 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   C S V   T R A I N I N G   O B S E R V E R   C L A S S
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#include "csv_training_observer.h"
+
+namespace OpenNN
+{
+
+/// Constructor. It creates the CSV file and writes its header.
+/// @param new_file_name Name of the CSV file.
+/// @param new_maximum_queue_size Maximum number of pending events.
+
+CSVTrainingObserver::CSVTrainingObserver(const string& new_file_name, const Index& new_maximum_queue_size)
+    : AsyncTrainingObserver(new_maximum_queue_size)
+{
+    file_name = new_file_name;
+
+    file.open(file_name.c_str());
+
+    if(!file.is_open())
+    {
+        stop();
+
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: CSVTrainingObserver class.\n"
+               << "explicit CSVTrainingObserver(const string&, const Index&) constructor.\n"
+               << "Cannot open CSV file: " << file_name << "\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    file.precision(10);
+
+    file << "event,epoch,iteration,iterations_number,instances_number,"
+         << "training_loss,training_error,selection_error,gradient_norm,learning_rate,"
+         << "instances_per_second,time,elapsed_time" << endl;
+}
+
+
+/// Destructor. It writes the pending events and closes the file.
+
+CSVTrainingObserver::~CSVTrainingObserver()
+{
+    stop();
+}
+
+
+/// Returns the name of the CSV file.
+
+const string& CSVTrainingObserver::get_file_name() const
+{
+    return file_name;
+}
+
+
+/// Writes a row for the iterations, the epochs and the ends of trainings. The beginnings of trainings are not written.
+
+void CSVTrainingObserver::write_event(const Event& event)
+{
+    if(event.type == TrainingBegin) return;
+
+    const Metrics& metrics = event.metrics;
+
+    file << write_event_type(event.type) << ","
+         << metrics.epoch << ","
+         << metrics.iteration << ","
+         << metrics.iterations_number << ","
+         << metrics.instances_number << ",";
+
+    write_number(file, metrics.training_loss, "");
+    file << ",";
+    write_number(file, metrics.training_error, "");
+    file << ",";
+    write_number(file, metrics.selection_error, "");
+    file << ",";
+    write_number(file, metrics.gradient_norm, "");
+    file << ",";
+    write_number(file, metrics.learning_rate, "");
+    file << ",";
+    write_number(file, metrics.instances_per_second, "");
+    file << ",";
+    write_number(file, metrics.time, "");
+    file << ",";
+    write_number(file, metrics.elapsed_time, "");
+    file << endl;
+}
+
+}
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
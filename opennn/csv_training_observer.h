@@ -0,0 +1,85 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   C S V   T R A I N I N G   O B S E R V E R   C L A S S   H E A D E R
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#ifndef CSVTRAININGOBSERVER_H
+#define CSVTRAININGOBSERVER_H
+
+// System includes
+
+#include <fstream>
+#include <string>
+
+// OpenNN includes
+
+#include "config.h"
+#include "async_training_observer.h"
+
+using namespace std;
+using namespace Eigen;
+
+namespace OpenNN
+{
+
+/// This class writes the training metrics to a CSV file, one row per iteration, epoch or end of training.
+
+///
+/// The file is created with a header row when the observer is constructed. NaN values are written as empty fields.
+
+class CSVTrainingObserver : public AsyncTrainingObserver
+{
+
+public:
+
+   // Constructors
+
+   explicit CSVTrainingObserver(const string&, const Index& = 10000);
+
+   // Destructor
+
+   virtual ~CSVTrainingObserver();
+
+   // Get methods
+
+   const string& get_file_name() const;
+
+protected:
+
+   void write_event(const Event&);
+
+private:
+
+   /// Name of the CSV file.
+
+   string file_name;
+
+   /// Stream of the CSV file.
+
+   ofstream file;
+};
+
+}
+
+#endif
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
@@ -130,6 +130,15 @@ const bool& DataSet::get_display() const
 }
 
 
+/// Returns true if the batches are filled with the inputs in compressed sparse row format,
+/// so that the first layer of a neural network can skip the zero inputs.
+
+const bool& DataSet::get_sparse_inputs() const
+{
+    return sparse_inputs;
+}
+
+
 /// Column default constructor
 
 DataSet::Column::Column()
@@ -964,9 +973,37 @@ Tensor<Index, 2> DataSet::get_batches(const Tensor<Index,1>& instances_indices,
                                       const Index& batch_instances_number,
                                       const bool& shuffle,
                                       const Index& new_buffer_size) const
+{
+    return get_batches(instances_indices, batch_instances_number, shuffle, nullptr, new_buffer_size);
+}
+
+
+/// Returns a vector, where each element is a vector that contains the indices of the different batches of the training instances.
+/// The instances are shuffled with the given random generator, so that the global random numbers are neither used nor seeded.
+/// @param shuffle True if the indices are shuffled into batches, and false otherwise.
+/// @param random_generator Random generator of the shuffle. If it is null, the global random numbers are used.
+
+Tensor<Index, 2> DataSet::get_batches(const Tensor<Index,1>& instances_indices,
+                                      const Index& batch_instances_number,
+                                      const bool& shuffle,
+                                      mt19937* random_generator,
+                                      const Index& new_buffer_size) const
 {
     if(!shuffle) return split_instances(instances_indices, batch_instances_number);
 
+    const auto random_integer = [random_generator](const Index& maximum) -> Index
+    {
+        if(random_generator == nullptr) return static_cast<Index>(rand()%maximum);
+
+        return uniform_int_distribution<Index>(0, maximum-1)(*random_generator);
+    };
+
+    const auto shuffle_indices = [random_generator](Index* first, Index* last)
+    {
+        if(random_generator == nullptr) random_shuffle(first, last);
+        else std::shuffle(first, last, *random_generator);
+    };
+
     const Index instances_number = instances_indices.size();
 
     Index buffer_size = new_buffer_size;
@@ -987,7 +1024,7 @@ Tensor<Index, 2> DataSet::get_batches(const Tensor<Index,1>& instances_indices,
 
         // Shuffle
 
-        random_shuffle(instances_copy.data(), instances_copy.data() + instances_copy.size());
+        shuffle_indices(instances_copy.data(), instances_copy.data() + instances_copy.size());
 
         for(Index i = 0; i < batch_size; i++)
             batches(0,i) = instances_copy(i);
@@ -1042,7 +1079,7 @@ Tensor<Index, 2> DataSet::get_batches(const Tensor<Index,1>& instances_indices,
 
             for(Index j = 0; j < batch_size; j++)
             {
-                random_index = static_cast<Index>(rand()%buffer_size);
+                random_index = random_integer(buffer_size);
 
                 batches(i, j) = buffer(random_index);
 
@@ -1065,7 +1102,7 @@ Tensor<Index, 2> DataSet::get_batches(const Tensor<Index,1>& instances_indices,
 
             if(i == batches_number-1)
             {
-                random_shuffle(buffer.data(), buffer.data() +  buffer.size());
+                shuffle_indices(buffer.data(), buffer.data() + buffer.size());
 
                 if(batch_size <= buffer_size)
                 {
@@ -1096,7 +1133,7 @@ Tensor<Index, 2> DataSet::get_batches(const Tensor<Index,1>& instances_indices,
 
             for(Index j = 0; j < batch_size; j++)
             {
-                random_index = static_cast<Index>(rand()%buffer_size);
+                random_index = random_integer(buffer_size);
 
                 batches(i, j) = buffer(random_index);
 
@@ -4269,7 +4306,31 @@ void DataSet::set(const DataSet& other_data_set)
 
     columns = other_data_set.columns;
 
+    instances_uses = other_data_set.instances_uses;
+
+    input_variables_dimensions = other_data_set.input_variables_dimensions;
+
+    target_variables_dimensions = other_data_set.target_variables_dimensions;
+
+    lags_number = other_data_set.lags_number;
+
+    steps_ahead = other_data_set.steps_ahead;
+
+    time_index = other_data_set.time_index;
+
+    time_series_data = other_data_set.time_series_data;
+
+    time_series_columns = other_data_set.time_series_columns;
+
+    missing_values_method = other_data_set.missing_values_method;
+
+    has_rows_labels = other_data_set.has_rows_labels;
+
+    rows_labels = other_data_set.rows_labels;
+
     display = other_data_set.display;
+
+    sparse_inputs = other_data_set.sparse_inputs;
 }
 
 
@@ -4303,6 +4364,16 @@ void DataSet::set_display(const bool& new_display)
 }
 
 
+/// Sets whether the batches are also filled with the inputs in compressed sparse row format.
+/// This is intended for wide inputs, such as indicator variables, which are mostly zero.
+/// @param new_sparse_inputs True to fill sparse inputs in the batches, false otherwise.
+
+void DataSet::set_sparse_inputs(const bool& new_sparse_inputs)
+{
+    sparse_inputs = new_sparse_inputs;
+}
+
+
 /// Sets the default member values:
 /// <ul>
 /// <li> Display: True.
@@ -7395,6 +7466,18 @@ tinyxml2::XMLDocument* DataSet::to_XML() const
         element->LinkEndChild(text);
     }
 
+    // Sparse inputs
+    {
+        element = document->NewElement("SparseInputs");
+        data_set_element->LinkEndChild(element);
+
+        buffer.str("");
+        buffer << sparse_inputs;
+
+        text = document->NewText(buffer.str().c_str());
+        element->LinkEndChild(text);
+    }
+
     // Display
 //   {
 //      element = document->NewElement("Display");
@@ -7819,6 +7902,17 @@ void DataSet::write_XML(tinyxml2::XMLPrinter& file_stream) const
 
     file_stream.CloseElement();
 
+    // Sparse inputs
+
+    file_stream.OpenElement("SparseInputs");
+
+    buffer.str("");
+    buffer << sparse_inputs;
+
+    file_stream.PushText(buffer.str().c_str());
+
+    file_stream.CloseElement();
+
     // Close data set
 
     file_stream.CloseElement();
@@ -8482,6 +8576,15 @@ void DataSet::from_XML(const tinyxml2::XMLDocument& data_set_document)
         }
     }
 
+    // Sparse inputs
+
+    const tinyxml2::XMLElement* sparse_inputs_element = data_set_element->FirstChildElement("SparseInputs");
+
+    if(sparse_inputs_element && sparse_inputs_element->GetText())
+    {
+        set_sparse_inputs(string(sparse_inputs_element->GetText()) != "0");
+    }
+
     // Display
 
     const tinyxml2::XMLElement* display_element = data_set_element->FirstChildElement("Display");
@@ -10786,6 +10889,32 @@ void DataSet::Batch::fill(const Tensor<Index, 1>& instances,
             targets_2d_pointer[rows_number_j+i] = data_pointer[total_rows_variable+instances[i]];
         }
     }
+
+    sparse_inputs = data_set_pointer->get_sparse_inputs();
+
+    if(!sparse_inputs) return;
+
+    // Compressed sparse rows, built row by row from the data
+
+    inputs_csr.resize(rows_number, inputs_number);
+
+    inputs_csr.reserve(rows_number);
+
+    for(Index i = 0; i < rows_number; i++)
+    {
+        inputs_csr.startVec(i);
+
+        const type* instance_pointer = data_pointer + instances[i];
+
+        for(Index j = 0; j < inputs_number; j++)
+        {
+            const type value = instance_pointer[total_rows*inputs[j]];
+
+            if(value != static_cast<type>(0)) inputs_csr.insertBack(i, j) = value;
+        }
+    }
+
+    inputs_csr.finalize();
 }
 
 
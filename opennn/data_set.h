@@ -195,6 +195,12 @@ public:
 
        Tensor<type, 2> inputs_2d;
        Tensor<type, 2> targets_2d;
+
+       /// True if the inputs of the batch have also been filled in compressed sparse row format.
+
+       bool sparse_inputs = false;
+
+       CsrMatrix inputs_csr;
    };
 
 
@@ -289,6 +295,7 @@ public:
    // Batches get methods
 
    Tensor<Index, 2> get_batches(const Tensor<Index,1>&, const Index&, const bool&, const Index& buffer_size= 100) const;
+   Tensor<Index, 2> get_batches(const Tensor<Index,1>&, const Index&, const bool&, mt19937*, const Index& buffer_size= 100) const;
 
    // Data get methods
 
@@ -368,6 +375,8 @@ public:
 
    const bool& get_display() const;
 
+   const bool& get_sparse_inputs() const;
+
    // Set methods
 
    void set();
@@ -475,6 +484,8 @@ public:
 
    void set_display(const bool&);
 
+   void set_sparse_inputs(const bool&);
+
    // Check methods
 
    bool is_binary_classification() const;
@@ -813,6 +824,10 @@ private:
 
    bool display = true;
 
+   /// Fill batches with the inputs in compressed sparse row format, for mostly zero inputs.
+
+   bool sparse_inputs = false;
+
    /// Index where time variable is located for forecasting applications.
 
    Index time_index;
@@ -11,6 +11,9 @@
 namespace OpenNN
 {
 
+const Index GeneticAlgorithm::genes_per_word;
+
+
 /// Default constructor.
 
 GeneticAlgorithm::GeneticAlgorithm()
@@ -57,11 +60,48 @@ GeneticAlgorithm::~GeneticAlgorithm()
 }
 
 
-/// Returns the population matrix.
+/// Returns the population matrix, unpacked from the genomes.
+/// Each row is an individual and each column is an input.
 
-const Tensor<bool, 2>& GeneticAlgorithm::get_population() const
+Tensor<bool, 2> GeneticAlgorithm::get_population() const
 {
-    return population;
+    const Index individuals_number = population.dimension(1);
+
+    Tensor<bool, 2> individuals(individuals_number, genes_number);
+
+    for(Index i = 0; i < individuals_number; i++)
+    {
+        for(Index j = 0; j < genes_number; j++)
+        {
+            individuals(i,j) = get_gene(i,j);
+        }
+    }
+
+    return individuals;
+}
+
+
+/// Returns the inputs used by an individual of the population.
+/// @param index Index of the individual.
+
+Tensor<bool, 1> GeneticAlgorithm::get_individual(const Index& index) const
+{
+    Tensor<bool, 1> individual(genes_number);
+
+    for(Index j = 0; j < genes_number; j++)
+    {
+        individual(j) = get_gene(index,j);
+    }
+
+    return individual;
+}
+
+
+/// Returns the number of genes of each individual, which is the number of inputs.
+
+const Index& GeneticAlgorithm::get_genes_number() const
+{
+    return genes_number;
 }
 
 
@@ -285,7 +325,7 @@ void GeneticAlgorithm::set_default()
 
     // Population stuff
 
-    population.resize(0, 0);//set();
+    resize_population(0, 0);
 
     loss.resize(0, 0);//set();
 
@@ -381,9 +421,15 @@ void GeneticAlgorithm::set_population(const Tensor<bool, 2>& new_population)
 
 #endif
 
-    population.setZero();
+    resize_population(new_population.dimension(0), new_population.dimension(1));
 
-    population = new_population;
+    for(Index i = 0; i < new_population.dimension(0); i++)
+    {
+        for(Index j = 0; j < new_population.dimension(1); j++)
+        {
+            if(new_population(i,j)) set_gene(i, j, true);
+        }
+    }
 }
 
 
@@ -419,7 +465,7 @@ void GeneticAlgorithm::set_loss(const Tensor<type, 2>& new_loss)
 
 #endif
 
-    copy(new_loss.data(), new_loss.data() + new_loss.size(), loss.data());
+    loss = new_loss;
 }
 
 
@@ -458,7 +504,7 @@ void GeneticAlgorithm::set_fitness(const Tensor<type, 1>& new_fitness)
 
 #endif
 
-    copy(new_fitness.data(), new_fitness.data() + new_fitness.size(), fitness.data());
+    fitness = new_fitness;
 }
 
 
@@ -810,12 +856,22 @@ void GeneticAlgorithm::initialize_population()
         throw logic_error(buffer.str());
     }
 
+    if(training_strategy_pointer->get_neural_network_pointer()->get_inputs_number() == 0)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: GeneticAlgorithm class.\n"
+               << "void initialize_population() method.\n"
+               << "Number of inputs must be greater than 0.\n";
+
+        throw logic_error(buffer.str());
+    }
+
 #endif
 
     const Index inputs_number = training_strategy_pointer->get_neural_network_pointer()->get_inputs_number();
 
-    population.resize(population_size, inputs_number);
-    population.setZero();
+    resize_population(population_size, inputs_number);
 
     switch(initialization_method)
     {
@@ -834,68 +890,33 @@ void GeneticAlgorithm::initialize_population()
 
 
 /// Initialize the population with the random intialization method.
+/// The genes are drawn a whole word at a time, and repeated individuals are drawn again up to five times.
 
 void GeneticAlgorithm::initialize_random_population()
 {
-    // Loss index
+    const uint64_t tail_mask = get_tail_mask();
 
-    const LossIndex* loss_index_pointer = training_strategy_pointer->get_loss_index_pointer();
-
-    // Neural network
-
-    const NeuralNetwork* neural_network_pointer = loss_index_pointer->get_neural_network_pointer();
-
-    // Optimization algorithm
-
-    const Index inputs_number = neural_network_pointer->get_inputs_number();
-
-    Tensor<bool, 1> inputs(inputs_number);
-
-    inputs.setConstant(true);
-
-    Index zero_ocurrences;
-
-    Index random;
+    GenomeSet genomes;
 
     Index random_loops = 0;
 
     for(Index i = 0; i < population_size; i++)
     {
-        zero_ocurrences = 0;
-
-        for(Index j = 0; j < inputs_number; j++)
-        {
-            random = rand()%2;
-
-            if(random == 0)
-            {
-                inputs[j] = false;
-
-                zero_ocurrences++;
-            }
-            else
-            {
-                inputs[j] = true;
-            }
-        }
+        uint64_t* genome = population.data() + i*words_number;
 
-        if(zero_ocurrences == inputs_number)
+        for(Index j = 0; j < words_number; j++)
         {
-            inputs(static_cast<Index>(rand())%inputs_number) = true;
+            genome[j] = random_word();
         }
 
-        bool contains = true;
+        genome[words_number-1] &= tail_mask;
 
-        for(Index k = 0; k < population.dimension(1); k++)
+        if(count_active_genes(i) == 0)
         {
-            for(Index l = 0; l < inputs.size(); l++)
-            {
-                if(population(l,k) != inputs(l)) contains = false;
-
-                contains = true;
-            }
+            set_gene(i, static_cast<Index>(rand())%genes_number, true);
         }
-        if(contains && random_loops <= 5)
+
+        if(!genomes.insert(get_genome(i)).second && random_loops < 5)
         {
             random_loops++;
 
@@ -903,17 +924,14 @@ void GeneticAlgorithm::initialize_random_population()
         }
         else
         {
-            for(Index k = 0; k < inputs.size(); k++)
-            {
-                population(i,k) = inputs(k);
-            }
             random_loops = 0;
-        }        
+        }
     }
 }
 
 
 /// Initialize the population with the weighted intialization method.
+/// The inputs are drawn with probabilities proportional to their correlations with the targets.
 
 void GeneticAlgorithm::initialize_weighted_population()
 {
@@ -925,98 +943,47 @@ void GeneticAlgorithm::initialize_weighted_population()
 
     const DataSet* data_set_pointer = loss_index_pointer->get_data_set_pointer();
 
-    Tensor<type, 2> correlations = data_set_pointer->calculate_input_target_columns_correlations_values();
+    const Tensor<type, 2> correlations = data_set_pointer->calculate_input_target_columns_correlations_values();
 
     const Eigen::array<int, 1> rows_sum = {Eigen::array<int, 1>({1})};
 
-    Tensor<type, 1> final_correlations = correlations.sum(rows_sum).abs();
+    const Tensor<type, 1> final_correlations
+            = correlations.sum(rows_sum).abs().cwiseMax(static_cast<type>(1.0)/population_size);
 
-    // Neural network
-
-    const NeuralNetwork* neural_network_pointer = loss_index_pointer->get_neural_network_pointer();
-
-    const Index inputs_number = neural_network_pointer->get_inputs_number();
+    const Tensor<type, 1> correlations_sum = final_correlations.cumsum(0);
 
-    // Optimization algortihm stuff
+    const Index correlations_number = correlations_sum.size();
 
-    Tensor<bool, 1> inputs(inputs_number);
-    inputs.setConstant(false);
+    const type sum = correlations_sum(correlations_number-1);
 
-    Tensor<type, 0> sum;
-
-    Tensor<type, 1> correlations_sum;
-
-    Index zero_ocurrences;
+    GenomeSet genomes;
 
     type random;
 
-    //type random_uniform;
+    Index index;
 
     Index random_loops = 0;
 
-    for(Index i = 0; i < final_correlations.size(); i++)
-    {
-        if(final_correlations(i) < static_cast<type>(1.0)/population_size)
-        {
-            final_correlations(i) = static_cast<type>(1.0)/population_size;
-        }
-    }
-
-    sum = final_correlations.sum();
-
-    correlations_sum = final_correlations.cumsum(0);//cumulative(final_correlations);
-
     for(Index i = 0; i < population_size; i++)
     {
-        zero_ocurrences = 0;
+        fill(population.data() + i*words_number, population.data() + (i+1)*words_number, static_cast<uint64_t>(0));
 
-        inputs.resize(inputs_number);
-        inputs.setConstant(false);
-
-        for(Index j = 0; j < inputs_number; j++)
+        for(Index j = 0; j < genes_number; j++)
         {
-            random = sum(0)*static_cast<type>(rand() /(RAND_MAX + 1.0));
-
-            for(Index k = 0; k < correlations_sum.size(); k++)
-            {
-                if(k == 0 && random < correlations_sum[0])
-                {
-                    inputs[k] = true;
-
-                    k = correlations_sum.size();
-                }
-                else if(random < correlations_sum[k] && random >= correlations_sum[k-1])
-                {
-                    inputs[k] = true;
-
-                    k = correlations_sum.size();
-                }
-            }
+            random = sum*static_cast<type>(rand() /(RAND_MAX + 1.0));
 
-            if(inputs[j] == false)
-            {
-                zero_ocurrences++;
-            }
-        }
+            index = upper_bound(correlations_sum.data(), correlations_sum.data() + correlations_number, random)
+                  - correlations_sum.data();
 
-        if(zero_ocurrences == inputs_number)
-        {
-            inputs[static_cast<Index>(rand())%inputs_number] = true;
+            set_gene(i, min(index, genes_number-1), true);
         }
 
-        bool contains = true;
-
-        for(Index k = 0; k < population.dimension(1); k++)
+        if(count_active_genes(i) == 0)
         {
-            for(Index l = 0; l < inputs.size(); l++)
-            {
-                if(population(l,k) != inputs(l)) contains = false;
-
-                contains = true;
-            }
+            set_gene(i, static_cast<Index>(rand())%genes_number, true);
         }
 
-        if(contains && random_loops <= 5)
+        if(!genomes.insert(get_genome(i)).second && random_loops < 5)
         {
             random_loops++;
 
@@ -1024,11 +991,6 @@ void GeneticAlgorithm::initialize_weighted_population()
         }
         else
         {
-            for(Index k = 0; k < population.dimension(0); k++)
-            {
-                population(k,i) = inputs(k);
-            }
-
             random_loops = 0;
         }
     }
@@ -1057,65 +1019,39 @@ void GeneticAlgorithm::evaluate_population()
 
 #endif
 
-    // Loss index
-
-    const LossIndex* loss_index_pointer = training_strategy_pointer->get_loss_index_pointer();
+    // Columns uses of the individuals
 
-    // Data set
-
-    DataSet* data_set_pointer = loss_index_pointer->get_data_set_pointer();
+    Tensor<Index, 1> columns_indices(genes_number);
 
-    Tensor<DataSet::VariableUse, 1> current_uses(original_uses);
-
-    // Neural network
-
-    NeuralNetwork* neural_network_pointer = loss_index_pointer->get_neural_network_pointer();
-
-    // Optimization algorithm
-
-    Tensor<bool, 1> current_inputs;
-
-    Index index = 0;
-
-    Tensor<type, 1> errors(2);
+    for(Index j = 0; j < genes_number; j++)
+    {
+        columns_indices(j) = get_input_index(original_uses,j);
+    }
 
-    loss.resize(population_size,2);
-    loss.setZero();
+    Tensor<Tensor<DataSet::VariableUse, 1>, 1> columns_uses(population_size);
 
     for(Index i = 0; i < population_size; i++)
     {
-        current_inputs = population.chip(i,0);
+        Tensor<DataSet::VariableUse, 1> current_uses(original_uses);
 
-        for(Index j = 0; j < current_inputs.size(); j++)
+        for(Index j = 0; j < genes_number; j++)
         {
-            index = get_input_index(original_uses,j);
-
-            Index inputs_number = 0;
-
-            if(current_inputs[j] == false)
-            {
-                current_uses[index] = DataSet::UnusedVariable;
-            }
-            else
-            {
-                current_uses[index] = DataSet::Input;
-                inputs_number++;
-            }
+            current_uses(columns_indices(j)) = get_gene(i,j) ? DataSet::Input : DataSet::UnusedVariable;
         }
 
-        data_set_pointer->set_columns_uses(current_uses);
-
-        neural_network_pointer->set_inputs_number(current_inputs);
+        columns_uses(i) = current_uses;
+    }
 
-        // Training Neural networks
+    // Training neural networks
 
-        errors = calculate_losses(population.chip(i,0));
+    const Tensor<OptimizationAlgorithm::Results, 1> results = perform_trials(columns_uses);
 
-        for(Index k = 0; k < loss.dimension(1); k++)
-        {
-            loss(i,k) = errors(k);
-        }
+    loss.resize(population_size,2);
 
+    for(Index i = 0; i < population_size; i++)
+    {
+        loss(i,0) = results(i).final_training_error;
+        loss(i,1) = results(i).final_selection_error;
     }
 
     calculate_fitness();
@@ -1161,62 +1097,37 @@ void GeneticAlgorithm::calculate_fitness()
 
 void GeneticAlgorithm::calculate_objetive_fitness()
 {
+    const Tensor<type, 1> selection_errors = loss.chip(1,1);
 
-    fitness.resize(loss.dimension(0));
-    fitness.setConstant(0.);
-
-    for(Index i = 0; i < fitness.size(); i++)
-    {
-        fitness(i) = 1/(1 + loss(i,1));
-    }
-
+    fitness = (selection_errors + static_cast<type>(1.0)).inverse();
 }
 
 
 /// Calculate the fitness with rank based fitness assignment method.
+/// The individuals are sorted by decreasing selection error, so that the best one gets the greatest rank.
 
 void GeneticAlgorithm::calculate_rank_fitness()
 {
+    const Index individuals_number = loss.dimension(0);
 
-    const Tensor<type, 1> column = loss.chip(1,1);
-
-    const Index column_size = column.size();
-
-    Tensor<Index, 1> rank(column_size);
-
-    Tensor<type, 1> sorted_vector(column);
-
-    sort(sorted_vector.data(), sorted_vector.data() + sorted_vector.size(), greater<type>());
+    Tensor<Index, 1> rank(individuals_number);
 
-    Tensor<Index, 1> previous_rank(column_size);
-
-    for(Index i = 0; i < column_size; i++)
+    for(Index i = 0; i < individuals_number; i++)
     {
-        for(Index j = 0; j < column_size; j++)
-        {
-            for(Index k = 0; k < previous_rank.size(); k++)
-            {
-                if(previous_rank(k) == j) continue;
-            }
+        rank(i) = i;
+    }
 
-            if (static_cast<Index>(sorted_vector(i)) == static_cast<Index>(column(j)))
-            {
-                rank(i) = j;
+    const Tensor<type, 2>& errors = loss;
 
-                previous_rank(i) = j;
+    sort(rank.data(), rank.data() + individuals_number,
+         [&errors](const Index& a, const Index& b){return errors(a,1) > errors(b,1);});
 
-                break;
-            }
-        }
-    }
+    fitness.resize(individuals_number);
 
-    fitness.resize(loss.dimension(0));
-
-    for(Index i = 0; i < population_size; i++)
+    for(Index i = 0; i < individuals_number; i++)
     {
-        fitness[i] = selective_pressure*rank[i];
+        fitness(rank(i)) = selective_pressure*i;
     }
-
 }
 
 
@@ -1225,44 +1136,24 @@ void GeneticAlgorithm::calculate_rank_fitness()
 
 void GeneticAlgorithm::evolve_population()
 {
-    Index zero_ocurrences;
-
     perform_selection();
 
-    cout << "perform selection" << endl;
-
     perform_crossover();
 
-    cout << "perform crossover" << endl;
-
     perform_mutation();
 
-    cout << "perform mutation" << endl;
-
-    for(Index i = 0; i < population.dimension(0); i++)
+    for(Index i = 0; i < population_size; i++)
     {
-        zero_ocurrences = 0;
-
-        const Tensor<bool, 1> population_row = population.chip(i,0);
-
-        for(Index j = 0; j < population_row.size(); j++)
+        if(count_active_genes(i) == 0)
         {
-            if(population(i,j) == false)
-            {
-                zero_ocurrences++;
-            }
-        }
-
-        if(zero_ocurrences == population_row.size())
-        {
-            population(i,static_cast<Index>(rand())%population_row.size()) = true;
+            set_gene(i, static_cast<Index>(rand())%genes_number, true);
         }
-
     }
 }
 
 
 /// Selects for crossover some individuals from the population.
+/// The selected individuals are moved to the first half of the population.
 
 void GeneticAlgorithm::perform_selection()
 {
@@ -1292,96 +1183,80 @@ void GeneticAlgorithm::perform_selection()
 
 #endif
 
+    const Index individuals_number = fitness.size();
+
     const Index selected_population_size = static_cast<Index>(population_size/2);
 
-    Tensor<bool, 2> population_copy;
+    Tensor<uint64_t, 2> selected_population(words_number, population_size);
+    selected_population.setZero();
 
-    vector<vector<bool>> population_vector_copy;
+    Tensor<bool, 1> selected(individuals_number);
+    selected.setConstant(false);
 
-    Tensor<bool, 1> selected_population(population.dimension(0));
-    selected_population.setConstant(false);
+    Index selected_number = 0;
 
-    Index selected_index = 0;
+    GenomeSet selected_genomes;
 
-    Tensor<type, 1> fitness_sum = fitness.cumsum(0);    
+    Index index;
 
-    const Tensor<type, 0> sum = fitness.sum();
+    // Elitist selection
 
-    type random;
+    Tensor<Index, 1> fitness_rank(individuals_number);
 
-    Index random_loops = 0;
+    for(Index i = 0; i < individuals_number; i++)
+    {
+        fitness_rank(i) = i;
+    }
 
-    Tensor<type, 1> fitness_copy(fitness);
+    const Tensor<type, 1>& current_fitness = fitness;
 
-    // Elitist selection
+    sort(fitness_rank.data(), fitness_rank.data() + individuals_number,
+         [&current_fitness](const Index& a, const Index& b){return current_fitness(a) > current_fitness(b);});
 
-    if(elitism_size >= 1)
+    for(Index i = -1; i < individuals_number; i++)
     {
-        selected_index = get_optimal_individual_index();
+        if(selected_number >= elitism_size || selected_number >= selected_population_size) break;
 
-        selected_population[selected_index] = true;
+        index = i == -1 ? get_optimal_individual_index() : fitness_rank(i);
 
-        population_vector_copy.push_back(tensor_to_vector(population.chip(selected_index, 0)));
+        if(selected(index) || !selected_genomes.insert(get_genome(index)).second) continue;
 
-        fitness_copy[selected_index] = -1;
-    }
+        copy(population.data() + index*words_number,
+             population.data() + (index+1)*words_number,
+             selected_population.data() + selected_number*words_number);
 
-    // Natural selection
+        selected(index) = true;
 
-    while(static_cast<Index>(population_vector_copy.size()) < elitism_size
-       && static_cast<Index>(population_vector_copy.size()) < selected_population_size)
-    {
-        selected_index = maximal_index(fitness_copy);
+        selected_number++;
+    }
 
-        const Tensor<bool, 1> selected_population_row = population.chip(selected_index,0);
+    // Roulette wheel
 
-        Index count = 0;
+    const Tensor<type, 1> fitness_sum = fitness.cumsum(0);
 
-        for(size_t i = 0; i < population_vector_copy.size(); i++)
-        {
-            count = 0;
+    const type sum = fitness_sum(individuals_number-1);
 
-            for(Index j = 0; j < selected_population_row.size(); j++)
-            {
-                if(population_vector_copy[i][static_cast<size_t>(j)] == selected_population_row(j)) count++;
-            }
-        }
+    type random;
 
-        if(count < selected_population_row.size())
-        {
-            selected_population[selected_index] = true;
+    Index random_loops = 0;
 
-            population_vector_copy.push_back(tensor_to_vector(selected_population_row));
-        }
+    while(selected_number < selected_population_size)
+    {
+        random = sum*static_cast<type>(rand() /(RAND_MAX + 1.0));
 
-        fitness_copy[selected_index] = -1;
-    }
+        index = upper_bound(fitness_sum.data(), fitness_sum.data() + individuals_number, random) - fitness_sum.data();
 
-    // Roulette wheel
+        index = min(index, individuals_number-1);
 
-    while(static_cast<Index>(population_vector_copy.size()) != selected_population_size)
-    {
-        random = sum(0)*static_cast<type>(rand() /(RAND_MAX + 1.0));
-
-        for(Index k = 0; k < fitness_sum.size(); k++)
+        if(!selected(index) || random_loops == 5)
         {
-            if(k == 0 && random < fitness_sum[0])
-            {
-                selected_index = k;
-                k = fitness_sum.size();
-            }
-            else if(random < fitness_sum[k] && random >= fitness_sum[k-1])
-            {
-                selected_index = k;
-                k = fitness_sum.size();
-            }
-        }
+            copy(population.data() + index*words_number,
+                 population.data() + (index+1)*words_number,
+                 selected_population.data() + selected_number*words_number);
 
-        if(selected_population[selected_index] == false || random_loops == 5)
-        {
-            selected_population[selected_index] = true;
+            selected(index) = true;
 
-            population_vector_copy.push_back(tensor_to_vector(population.chip(selected_index,0)));
+            selected_number++;
 
             random_loops = 0;
         }
@@ -1390,19 +1265,8 @@ void GeneticAlgorithm::perform_selection()
             random_loops++;
         }
     }
-cout << "wheel" << endl;
-    population_copy.resize(static_cast<Index>(population_vector_copy.size()), static_cast<Index>(population_vector_copy[0].size()));
-
-    population.setZero();
-
-    for(size_t i = 0; i < population_vector_copy.size(); i++)
-    {
-        for(size_t j = 0; j < population_vector_copy[0].size(); j++)
-        {
-            population(static_cast<Index>(i),static_cast<Index>(j)) = population_vector_copy[i][j];
-        }
-    }
 
+    population = selected_population;
 }
 
 
@@ -1450,96 +1314,34 @@ void GeneticAlgorithm::perform_crossover()
 
 void GeneticAlgorithm::perform_1point_crossover()
 {
+    const Index selected_population_size = static_cast<Index>(population_size/2);
 
-    const Index inputs_number = population.dimension(1);
-    const Index selected_population = population.dimension(0);
+    Tensor<uint64_t, 2> offspring(words_number, population_size);
 
-    Index parent1_index;
-    Tensor<bool, 1> parent1(inputs_number);
+    Tensor<uint64_t, 1> mask(words_number);
 
+    Index parent1_index;
     Index parent2_index;
-    Tensor<bool, 1> parent2(inputs_number);
-
-    Tensor<bool, 1> offspring1(inputs_number);
-    Tensor<bool, 1> offspring2(inputs_number);
-
-    Index random_loops = 0;
 
     Index first_point = crossover_first_point;
 
-    vector<vector<bool>> new_population;
+    Index offspring_number = 0;
 
-    while(static_cast<Index>(new_population.size()) < population_size)
+    while(offspring_number < population_size)
     {
-        parent1_index = static_cast<Index>(rand())%selected_population;
-
-        parent2_index = static_cast<Index>(rand())%selected_population;
-
-        random_loops = 0;
-
-        const Tensor<type, 1 > parent_1 = population.chip(parent1_index,0).cast<type>();
-        const Tensor<type, 1 > parent_2 = population.chip(parent2_index,0).cast<type>();
-
-        while(euclidean_distance(parent_1, parent_2)
-                <= incest_prevention_distance)
-        {
-            parent2_index = static_cast<Index>(rand())%selected_population;
-
-            random_loops++;
-
-            if(random_loops == 5 && parent1_index != selected_population-1)
-            {
-                parent2_index = parent1_index+1;
-                break;
-            }
-            else if(random_loops == 5)
-            {
-                parent2_index = parent1_index-1;
-                break;
-            }
-        }
-
-        parent1 = population.chip(parent1_index,1);
-        parent2 = population.chip(parent2_index,1);
+        select_parents(selected_population_size, parent1_index, parent2_index);
 
         if(crossover_first_point == 0)
         {
-            first_point = 1 + static_cast<Index>(rand())%(inputs_number-1);
+            first_point = 1 + static_cast<Index>(rand())%max(genes_number-1, static_cast<Index>(1));
         }
 
-        for(Index i = 0; i < inputs_number; i++)
-        {
-            if(i < first_point)
-            {
-                offspring1[i] = parent1[i];
-                offspring2[i] = parent2[i];
-            }
-            else
-            {
-                offspring1[i] = parent2[i];
-                offspring2[i] = parent1[i];
-            }
-        }
+        set_range_mask(0, first_point, mask);
 
-        new_population.push_back(tensor_to_vector(offspring1));
-
-        if(static_cast<Index>(new_population.size()) != population_size)
-        {
-            new_population.push_back(tensor_to_vector(offspring2));
-        }
+        recombine(parent1_index, parent2_index, mask, offspring, offspring_number);
     }
 
-    Tensor<bool, 2> population_copy(static_cast<Index>(new_population.size()), static_cast<Index>(new_population[0].size()));
-
-    for(size_t i = 0; i < new_population.size(); i++)
-    {
-        for(size_t j = 0; j < new_population[0].size(); j++)
-        {
-            population_copy(static_cast<Index>(i),static_cast<Index>(j)) = new_population[i][j];
-        }
-    }
-
-    set_population(population_copy);
+    population = offspring;
 }
 
 
@@ -1547,105 +1349,47 @@ void GeneticAlgorithm::perform_1point_crossover()
 
 void GeneticAlgorithm::perform_2point_crossover()
 {
+    const Index selected_population_size = static_cast<Index>(population_size/2);
+
+    Tensor<uint64_t, 2> offspring(words_number, population_size);
 
-    const Index inputs_number = population.dimension(1);
-    const Index selected_population = population.dimension(0);
+    Tensor<uint64_t, 1> mask(words_number);
 
     Index parent1_index;
-    Tensor<bool, 1> parent1(inputs_number);
     Index parent2_index;
-    Tensor<bool, 1> parent2(inputs_number);
-
-    Tensor<bool, 1> offspring1(inputs_number);
-    Tensor<bool, 1> offspring2(inputs_number);
-
-    Index random_loops = 0;
 
     Index first_point = crossover_first_point;
     Index second_point = crossover_second_point;
 
-    vector<vector<bool>> new_population;
+    Index offspring_number = 0;
 
-    while(static_cast<Index>(new_population.size()) < population_size)
+    while(offspring_number < population_size)
     {
-        parent1_index = static_cast<Index>(rand())%selected_population;
-        parent2_index = static_cast<Index>(rand())%selected_population;
-
-        random_loops = 0;
-
-        const Tensor<type, 1 > parent_1 = population.chip(parent1_index,0).cast<type>();
-        const Tensor<type, 1 > parent_2 = population.chip(parent2_index,0).cast<type>();
-
-        while(euclidean_distance(parent_1, parent_2)
-                <= incest_prevention_distance)
-        {
-            parent2_index = static_cast<Index>(rand())%selected_population;
-            random_loops++;
-
-            if(random_loops == 5 && parent1_index != selected_population-1)
-            {
-                parent2_index = parent1_index+1;
-                break;
-            }
-            else if(random_loops == 5)
-            {
-                parent2_index = parent1_index-1;
-                break;
-            }
-        }
-
-        parent1 = population.chip(parent1_index,0);
-        parent2 = population.chip(parent2_index,0);
+        select_parents(selected_population_size, parent1_index, parent2_index);
 
         if(crossover_first_point == 0)
         {
-            first_point = 1 + static_cast<Index>(rand())%(inputs_number-2);
+            first_point = 1 + static_cast<Index>(rand())%max(genes_number-2, static_cast<Index>(1));
         }
 
         if(crossover_second_point == 0)
         {
-            second_point = first_point + static_cast<Index>(rand())%(inputs_number-1-first_point);
+            second_point = first_point + static_cast<Index>(rand())%max(genes_number-1-first_point, static_cast<Index>(1));
         }
 
-        for(Index i = 0; i < inputs_number; i++)
-        {
-            if(i < first_point)
-            {
-                offspring1[i] = parent1[i];
-                offspring2[i] = parent2[i];
-            }
-            else if(i < second_point)
-            {
-                offspring1[i] = parent2[i];
-                offspring2[i] = parent1[i];
-            }
-            else
-            {
-                offspring1[i] = parent1[i];
-                offspring2[i] = parent2[i];
-            }
-        }
+        // The genes between the two points come from the other parent
 
-        new_population.push_back(tensor_to_vector(offspring1));
+        set_range_mask(first_point, second_point, mask);
 
-        if(static_cast<Index>(new_population.size()) < population_size)
+        for(Index j = 0; j < words_number; j++)
         {
-            new_population.push_back(tensor_to_vector(offspring2));
+            mask(j) = ~mask(j);
         }
-    }
-
-    Tensor<bool, 2> population_copy(static_cast<Index>(new_population.size()), static_cast<Index>(new_population[0].size()));
 
-    for(size_t i = 0; i < new_population.size(); i++)
-    {
-        for(size_t j = 0; j < new_population[0].size(); j++)
-        {
-            population_copy(static_cast<Index>(i),static_cast<Index>(j)) = new_population[i][j];
-        }
+        recombine(parent1_index, parent2_index, mask, offspring, offspring_number);
     }
 
-    set_population(population_copy);
-
+    population = offspring;
 }
 
 
@@ -1653,100 +1397,43 @@ void GeneticAlgorithm::perform_2point_crossover()
 
 void GeneticAlgorithm::perform_uniform_crossover()
 {
+    const Index selected_population_size = static_cast<Index>(population_size/2);
 
-    const Index inputs_number = population.dimension(1);
-    const Index selected_population = static_cast<Index>(population_size/2);
+    Tensor<uint64_t, 2> offspring(words_number, population_size);
 
-    Index parent1_index;
-    Tensor<bool, 1> parent1(inputs_number);
+    Tensor<uint64_t, 1> mask(words_number);
 
+    Index parent1_index;
     Index parent2_index;
-    Tensor<bool, 1> parent2(inputs_number);
-
-    Tensor<bool, 1> offspring1(inputs_number);
-    Tensor<bool, 1> offspring2(inputs_number);
 
-    type random_uniform;
-    Index random_loops = 0;
-
-    vector<vector<bool>> new_population;
+    Index offspring_number = 0;
 
-    while(static_cast<Index>(new_population.size()) < population_size)
+    while(offspring_number < population_size)
     {
-        parent1_index = static_cast<Index>(rand())%selected_population;
-        parent2_index = static_cast<Index>(rand())%selected_population;
-
-        random_loops = 0;
-
-        const Tensor<type, 1 > parent_1 = population.chip(parent1_index,0).cast<type>();
-        const Tensor<type, 1 > parent_2 = population.chip(parent2_index,0).cast<type>();
-
-        while(euclidean_distance(parent_1, parent_2)
-                <= incest_prevention_distance)
-        {
-            parent2_index = static_cast<Index>(rand())%selected_population;
-            random_loops++;
-
-            if(random_loops == 5 && parent1_index != selected_population-1)
-            {
-                parent2_index = parent1_index+1;
-                break;
-            }
-            else if(random_loops == 5)
-            {
-                parent2_index = parent1_index-1;
-                break;
-            }
-        }
-
-        parent1 = population.chip(parent1_index,0);
-        parent2 = population.chip(parent2_index,0);
-
-        for(Index i = 0; i < inputs_number; i++)
-        {
-            random_uniform = static_cast<type>(1.0)*static_cast<type>(rand() /(RAND_MAX + 1.0));
-
-            if(random_uniform > static_cast<type>(0.5))
-            {
-                offspring1[i] = parent1[i];
-                offspring2[i] = parent2[i];
-            }
-            else
-            {
-                offspring1[i] = parent2[i];
-                offspring2[i] = parent1[i];
-            }
-        }
-
-        new_population.push_back(tensor_to_vector(offspring1));
+        select_parents(selected_population_size, parent1_index, parent2_index);
 
-        if(static_cast<Index>(new_population.size()) != population_size)
+        for(Index j = 0; j < words_number; j++)
         {
-            new_population.push_back(tensor_to_vector(offspring2));
+            mask(j) = random_word();
         }
-    }
-
-    Tensor<bool, 2> population_copy(static_cast<Index>(new_population.size()), static_cast<Index>(new_population[0].size()));
 
-    for(size_t i = 0; i < new_population.size(); i++)
-    {
-        for(size_t j = 0; j < new_population[0].size(); j++)
-        {
-            population_copy(static_cast<Index>(i),static_cast<Index>(j)) = new_population[i][j];
-        }
+        recombine(parent1_index, parent2_index, mask, offspring, offspring_number);
     }
 
-    set_population(population_copy);
+    population = offspring;
 }
 
 
 /// Perform the mutation of the individuals generated in the crossover.
+/// Each gene of the population is flipped with probability equal to the mutation rate.
+/// Instead of drawing a random number for each gene, the gaps between mutated genes are drawn from a geometric distribution,
+/// so that the cost is proportional to the number of mutations.
 
 void GeneticAlgorithm::perform_mutation()
 {
 #ifdef __OPENNN_DEBUG__
 
-    if(population.dimension(0) != population_size)
+    if(population.dimension(1) != population_size)
     {
         ostringstream buffer;
 
@@ -1759,21 +1446,30 @@ void GeneticAlgorithm::perform_mutation()
 
 #endif
 
-    const Index selected_population_size = population_size - elitism_size;
+    if(mutation_rate <= 0 || genes_number == 0) return;
+
+    const Index total_genes_number = population.dimension(1)*genes_number;
+
+    const type log_complement = log(static_cast<type>(1.0) - mutation_rate);
 
     type random;
 
-    for(Index i = selected_population_size; i < population.dimension(0); i++)
+    Index position = 0;
+
+    while(true)
     {
-        for(Index j = 0; j < population.dimension(1); j++)
+        if(mutation_rate < 1)
         {
-            random = static_cast<type>(1.0)*static_cast<type>(rand() /(RAND_MAX + 1.0));
+            random = static_cast<type>((rand() + 1.0)/(RAND_MAX + 1.0));
 
-            if(random <= mutation_rate)
-            {
-                population(i,j) = !population(i,j);
-            }
+            position += static_cast<Index>(log(random)/log_complement);
         }
+
+        if(position >= total_genes_number) break;
+
+        flip_gene(position/genes_number, position%genes_number);
+
+        position++;
     }
 }
 
@@ -1784,34 +1480,26 @@ Index GeneticAlgorithm::get_optimal_individual_index() const
 {
     Index index = 0;
 
-    Tensor<bool, 1> optimal_inputs = population.chip(0,0);
-
     type optimum_error = loss(0,1);
 
-    Tensor<bool, 1> current_inputs(optimal_inputs.size());
+    Index count_optimal = count_active_genes(0);
 
     type current_error = 0;
 
+    Index count_inputs;
+
     for(Index i = 1; i < population_size; i++)
     {
-        current_inputs = population.chip(i,0);
         current_error = loss(i,1);
 
-        Index count_inputs = 0;
-        Index count_optimal = 0;
-
-        for(Index j = 0; j < optimal_inputs.size(); j++)
-        {
-            if(current_inputs(j) == true) count_inputs++;
-            if(optimal_inputs(j) == true) count_optimal++;
-        }
+        count_inputs = count_active_genes(i);
 
         if((abs(optimum_error-current_error) < tolerance &&
                 count_inputs > count_optimal) ||
                 (abs(optimum_error-current_error) >= tolerance &&
                  current_error < optimum_error)  )
         {
-            optimal_inputs = current_inputs;
+            count_optimal = count_inputs;
             optimum_error = current_error;
 
             index = i;
@@ -1894,6 +1582,8 @@ GeneticAlgorithm::GeneticAlgorithmResults* GeneticAlgorithm::perform_inputs_sele
 
     Tensor<type, 2>  test(100,4);
 
+    training_scheduler.set_training_strategy_pointer(training_strategy_pointer);
+
     time(&beginning_time);
 
     initialize_population();
@@ -1921,13 +1611,13 @@ GeneticAlgorithm::GeneticAlgorithmResults* GeneticAlgorithm::perform_inputs_sele
 
         current_standard_deviation = standard_deviation(loss.chip(1,1));
 
-        current_inputs = population.chip(minimal_index,0);
+        current_inputs = get_individual(minimal_index);
 
         current_selection_error = loss(minimal_index,1);
 
         current_training_error = loss(minimal_index,0);
 
-        current_parameters = neural_network_pointer->get_parameters();
+        current_parameters = parameters_history[parameters_history.size() - static_cast<size_t>(population_size - minimal_index)];
 
         Index count_optimal = 0;
         Index count_inputs = 0;
@@ -3397,82 +3087,276 @@ void GeneticAlgorithm::load(const string& file_name)
 }
 
 
-type GeneticAlgorithm::euclidean_distance(const Tensor<type, 1>& tensor, const Tensor<type, 1>& other_tensor)
+/// Returns true if an individual uses a given input, and false otherwise.
+/// @param individual Index of the individual.
+/// @param gene Index of the input.
+
+bool GeneticAlgorithm::get_gene(const Index& individual, const Index& gene) const
 {
-    const Index x_size = tensor.size();
+    return (population(gene/genes_per_word, individual) >> (gene%genes_per_word)) & static_cast<uint64_t>(1);
+}
 
-#ifdef __OPENNN_DEBUG__
 
-    const Index y_size = other_tensor.size();
+/// Sets whether an individual uses a given input.
+/// @param individual Index of the individual.
+/// @param gene Index of the input.
+/// @param new_value True if the input is used, and false otherwise.
+
+void GeneticAlgorithm::set_gene(const Index& individual, const Index& gene, const bool& new_value)
+{
+    const uint64_t bit = static_cast<uint64_t>(1) << (gene%genes_per_word);
 
-    if(y_size != x_size)
+    if(new_value)
     {
-        ostringstream buffer;
+        population(gene/genes_per_word, individual) |= bit;
+    }
+    else
+    {
+        population(gene/genes_per_word, individual) &= ~bit;
+    }
+}
 
-        buffer << "OpenNN Exception: Metrics functions.\n"
-               << "double euclidean_distance(const Vector<double>&) const "
-               "method.\n"
-               << "Size must be equal to this size.\n";
 
-        throw logic_error(buffer.str());
+/// Changes whether an individual uses a given input.
+/// @param individual Index of the individual.
+/// @param gene Index of the input.
+
+void GeneticAlgorithm::flip_gene(const Index& individual, const Index& gene)
+{
+    population(gene/genes_per_word, individual) ^= static_cast<uint64_t>(1) << (gene%genes_per_word);
+}
+
+
+/// Returns the number of inputs used by an individual.
+/// @param individual Index of the individual.
+
+Index GeneticAlgorithm::count_active_genes(const Index& individual) const
+{
+    const uint64_t* genome = population.data() + individual*words_number;
+
+    Index count = 0;
+
+    for(Index j = 0; j < words_number; j++)
+    {
+        count += count_bits(genome[j]);
     }
 
-#endif
+    return count;
+}
+
+
+/// Returns the number of inputs in which two individuals differ.
+/// For binary genomes, it is the square of the euclidean distance between them.
+/// @param individual Index of the first individual.
+/// @param other_individual Index of the second individual.
+
+Index GeneticAlgorithm::calculate_Hamming_distance(const Index& individual, const Index& other_individual) const
+{
+    const uint64_t* genome = population.data() + individual*words_number;
+    const uint64_t* other_genome = population.data() + other_individual*words_number;
 
-    type distance = 0.0;
-    type error;
+    Index distance = 0;
 
-    for(Index i = 0; i < x_size; i++)
+    for(Index j = 0; j < words_number; j++)
     {
-        error = tensor(i) - other_tensor(i);
+        distance += count_bits(genome[j] ^ other_genome[j]);
+    }
+
+    return distance;
+}
+
+
+/// Resizes the packed population and sets all the genes to false.
+/// @param individuals_number Number of individuals.
+/// @param new_genes_number Number of genes of each individual.
+
+void GeneticAlgorithm::resize_population(const Index& individuals_number, const Index& new_genes_number)
+{
+    genes_number = new_genes_number;
+
+    words_number = (genes_number + genes_per_word - 1)/genes_per_word;
+
+    population.resize(words_number, individuals_number);
+
+    population.setZero();
+}
+
+
+/// Returns a copy of the packed genome of an individual, to be used as a key of a hash set.
+/// @param individual Index of the individual.
+
+vector<uint64_t> GeneticAlgorithm::get_genome(const Index& individual) const
+{
+    const uint64_t* genome = population.data() + individual*words_number;
+
+    return vector<uint64_t>(genome, genome + words_number);
+}
+
+
+/// Returns the mask of the bits of the last word of a genome which correspond to genes.
+
+uint64_t GeneticAlgorithm::get_tail_mask() const
+{
+    const Index tail_genes_number = genes_number%genes_per_word;
+
+    if(tail_genes_number == 0) return ~static_cast<uint64_t>(0);
+
+    return (static_cast<uint64_t>(1) << tail_genes_number) - 1;
+}
+
 
-        distance += error * error;
+/// Returns a word of uniformly distributed random bits.
+
+uint64_t GeneticAlgorithm::random_word()
+{
+    // rand() only guarantees 15 random bits
+
+    uint64_t word = 0;
+
+    for(Index i = 0; i < 5; i++)
+    {
+        word = (word << 15) ^ static_cast<uint64_t>(rand() & 0x7FFF);
     }
 
-    return sqrt(distance);
+    return word;
 }
 
 
-vector<bool> GeneticAlgorithm::tensor_to_vector(const Tensor<bool, 1>& tensor)
+/// Returns the number of bits set in a word.
+
+Index GeneticAlgorithm::count_bits(const uint64_t& word)
 {
-    const size_t size = static_cast<size_t>(tensor.dimension(0));
+#if defined(__GNUC__) || defined(__clang__)
+
+    return static_cast<Index>(__builtin_popcountll(word));
+
+#else
+
+    uint64_t bits = word - ((word >> 1) & 0x5555555555555555ULL);
+    bits = (bits & 0x3333333333333333ULL) + ((bits >> 2) & 0x3333333333333333ULL);
+    bits = (bits + (bits >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+
+    return static_cast<Index>((bits * 0x0101010101010101ULL) >> 56);
+
+#endif
+}
+
 
-    vector<bool> new_vector(static_cast<size_t>(size));
+/// Draws two parents among the first individuals of the population.
+/// Parents closer than the incest prevention distance are drawn again up to five times.
+/// If there is a single individual which can be parent, it is both parents.
+/// @param selected_population_size Number of individuals which can be parents.
+/// @param parent1_index Index of the first parent.
+/// @param parent2_index Index of the second parent.
 
-    for(size_t i = 0; i < size; i++)
+void GeneticAlgorithm::select_parents(const Index& selected_population_size, Index& parent1_index, Index& parent2_index) const
+{
+    if(selected_population_size == 1)
     {
-        new_vector[i] = tensor(static_cast<Index>(i));
+        parent1_index = 0;
+        parent2_index = 0;
+
+        return;
     }
 
-    return new_vector;
+    parent1_index = static_cast<Index>(rand())%selected_population_size;
+    parent2_index = static_cast<Index>(rand())%selected_population_size;
+
+    const type squared_distance = incest_prevention_distance*incest_prevention_distance;
+
+    Index random_loops = 0;
+
+    while(static_cast<type>(calculate_Hamming_distance(parent1_index, parent2_index)) <= squared_distance)
+    {
+        parent2_index = static_cast<Index>(rand())%selected_population_size;
+
+        random_loops++;
+
+        if(random_loops == 5 && parent1_index != selected_population_size-1)
+        {
+            parent2_index = parent1_index+1;
+            break;
+        }
+        else if(random_loops == 5)
+        {
+            parent2_index = parent1_index-1;
+            break;
+        }
+    }
+}
+
+
+/// Sets the bits of a genome mask between two genes.
+/// @param begin Index of the first gene in the range.
+/// @param end Index of the gene past the end of the range.
+/// @param mask Mask with one word for each word of the genomes.
+
+void GeneticAlgorithm::set_range_mask(const Index& begin, const Index& end, Tensor<uint64_t, 1>& mask) const
+{
+    Index word_begin;
+    Index low;
+    Index high;
+
+    for(Index j = 0; j < words_number; j++)
+    {
+        word_begin = j*genes_per_word;
+
+        low = max(begin - word_begin, static_cast<Index>(0));
+        high = min(end - word_begin, static_cast<Index>(genes_per_word));
+
+        if(low >= high)
+        {
+            mask(j) = 0;
+        }
+        else if(high == genes_per_word)
+        {
+            mask(j) = ~((static_cast<uint64_t>(1) << low) - 1);
+        }
+        else
+        {
+            mask(j) = ((static_cast<uint64_t>(1) << high) - 1) & ~((static_cast<uint64_t>(1) << low) - 1);
+        }
+    }
 }
 
 
-bool GeneticAlgorithm::contains(const vector<vector<bool>>&values, const vector<bool>&values_2) const
+/// Crosses two parents word by word into at most two offspring.
+/// The first offspring takes the genes of the first parent where the mask is set, and those of the second parent elsewhere.
+/// The second offspring takes the other genes.
+/// @param parent1_index Index of the first parent.
+/// @param parent2_index Index of the second parent.
+/// @param mask Crossover mask.
+/// @param offspring Packed new population.
+/// @param offspring_number Number of offspring in the new population, which is increased.
+
+void GeneticAlgorithm::recombine(const Index& parent1_index,
+                                 const Index& parent2_index,
+                                 const Tensor<uint64_t, 1>& mask,
+                                 Tensor<uint64_t, 2>& offspring,
+                                 Index& offspring_number) const
 {
+    const uint64_t* parent1 = population.data() + parent1_index*words_number;
+    const uint64_t* parent2 = population.data() + parent2_index*words_number;
+
+    uint64_t* offspring1 = offspring.data() + offspring_number*words_number;
 
-  if(values.empty()) {
-    return false;
-  }
+    for(Index j = 0; j < words_number; j++)
+    {
+        offspring1[j] = (parent1[j] & mask(j)) | (parent2[j] & ~mask(j));
+    }
 
-  vector<bool> copy(values_2);
+    offspring_number++;
 
-  const size_t values_size = values.size();
+    if(offspring_number >= offspring.dimension(1)) return;
 
-  for(size_t i = 0; i < values_size; i++)
-  {
-  for(size_t j = 0; j < values[i].size(); j++)
-  {
-      typename vector<bool>::iterator it = find(copy.begin(), copy.end(), values[i][j]);
+    uint64_t* offspring2 = offspring.data() + offspring_number*words_number;
 
-      if(it != copy.end())
-      {
-          return true;
-      }
-  }
-  }
+    for(Index j = 0; j < words_number; j++)
+    {
+        offspring2[j] = (parent2[j] & mask(j)) | (parent1[j] & ~mask(j));
+    }
 
-  return false;
+    offspring_number++;
 }
 
 }
@@ -18,6 +18,9 @@
 #include <limits>
 #include <cmath>
 #include <ctime>
+#include <cstdint>
+#include <vector>
+#include <unordered_set>
 
 // OpenNN includes
 
@@ -118,7 +121,11 @@ public:
 
     // Get methods
 
-    const Tensor<bool, 2>& get_population() const;
+    Tensor<bool, 2> get_population() const;
+
+    Tensor<bool, 1> get_individual(const Index&) const;
+
+    const Index& get_genes_number() const;
 
     const Tensor<type, 2>& get_loss() const;
 
@@ -244,11 +251,15 @@ public:
 
     // Utilities
 
-    type euclidean_distance(const Tensor<type, 1>&, const Tensor<type, 1>&);
+    bool get_gene(const Index&, const Index&) const;
+
+    void set_gene(const Index&, const Index&, const bool&);
+
+    void flip_gene(const Index&, const Index&);
 
-    vector<bool> tensor_to_vector(const Tensor<bool, 1>& tensor);
+    Index count_active_genes(const Index&) const;
 
-    bool contains(const vector<vector<bool>>&, const vector<bool>&) const;
+    Index calculate_Hamming_distance(const Index&, const Index&) const;
 
     // Serialization methods
 
@@ -265,11 +276,62 @@ public:
 
 private:
 
+    /// Number of genes packed in each word of a genome.
+
+    static const Index genes_per_word = 64;
+
+    /// Hash function of the packed genomes.
+
+    struct GenomeHash
+    {
+        size_t operator()(const vector<uint64_t>& genome) const
+        {
+            size_t seed = genome.size();
+
+            for(size_t i = 0; i < genome.size(); i++)
+            {
+                seed ^= hash<uint64_t>()(genome[i]) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+            }
+
+            return seed;
+        }
+    };
+
+    /// Set of packed genomes, used to find repeated individuals in constant time.
+
+    typedef unordered_set<vector<uint64_t>, GenomeHash> GenomeSet;
+
+    void resize_population(const Index&, const Index&);
+
+    vector<uint64_t> get_genome(const Index&) const;
+
+    uint64_t get_tail_mask() const;
+
+    static uint64_t random_word();
+
+    static Index count_bits(const uint64_t&);
+
+    void select_parents(const Index&, Index&, Index&) const;
+
+    void set_range_mask(const Index&, const Index&, Tensor<uint64_t, 1>&) const;
+
+    void recombine(const Index&, const Index&, const Tensor<uint64_t, 1>&, Tensor<uint64_t, 2>&, Index&) const;
+
     // Population stuff
 
-    /// Population matrix.
+    /// Bit-packed population.
+    /// Each column is the genome of one individual, with one bit for each input and genes_per_word genes in each word.
+    /// The unused bits of the last word are always zero.
+
+    Tensor<uint64_t, 2> population;
+
+    /// Number of genes of each individual, which is the number of inputs.
+
+    Index genes_number = 0;
+
+    /// Number of words of each genome.
 
-    Tensor<bool, 2> population;
+    Index words_number = 0;
 
     /// Performance of population.
 
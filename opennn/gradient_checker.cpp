@@ -0,0 +1,772 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   G R A D I E N T   C H E C K E R   C L A S S
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#include "gradient_checker.h"
+
+namespace OpenNN
+{
+
+/// Default constructor.
+/// It creates a gradient checker not associated to any loss index.
+
+GradientChecker::GradientChecker()
+{
+    set();
+}
+
+
+/// Loss index constructor.
+/// @param new_loss_index_pointer Pointer to the loss index whose error gradient is checked.
+
+GradientChecker::GradientChecker(LossIndex* new_loss_index_pointer)
+{
+    set(new_loss_index_pointer);
+}
+
+
+/// Destructor.
+
+GradientChecker::~GradientChecker()
+{
+}
+
+
+/// Returns a pointer to the loss index whose error gradient is checked.
+
+LossIndex* GradientChecker::get_loss_index_pointer() const
+{
+    return loss_index_pointer;
+}
+
+
+/// Returns the method to choose the derivatives to be checked.
+
+const GradientChecker::CheckMethod& GradientChecker::get_check_method() const
+{
+    return check_method;
+}
+
+
+/// Returns a string with the name of the method to choose the derivatives to be checked.
+
+string GradientChecker::write_check_method() const
+{
+    switch(check_method)
+    {
+    case AllParameters:
+        return "AllParameters";
+
+    case RandomParameters:
+        return "RandomParameters";
+
+    case RandomDirections:
+        return "RandomDirections";
+    }
+
+    return string();
+}
+
+
+/// Returns the number of parameters of each trainable layer checked by the random parameters method.
+
+const Index& GradientChecker::get_random_parameters_number() const
+{
+    return random_parameters_number;
+}
+
+
+/// Returns the number of directions of each trainable layer checked by the random directions method.
+
+const Index& GradientChecker::get_random_directions_number() const
+{
+    return random_directions_number;
+}
+
+
+/// Returns the magnitude below which the derivatives are compared in absolute terms.
+
+const type& GradientChecker::get_minimum_derivative() const
+{
+    return minimum_derivative;
+}
+
+
+/// Returns the maximum relative error for a check to pass.
+
+const type& GradientChecker::get_tolerance() const
+{
+    return tolerance;
+}
+
+
+/// Returns the number of workers which evaluate the perturbed errors.
+
+const Index& GradientChecker::get_workers_number() const
+{
+    return workers_number;
+}
+
+
+/// Returns true if messages from this class are to be displayed on the screen, or false if messages
+/// from this class are not to be displayed on the screen.
+
+const bool& GradientChecker::get_display() const
+{
+    return display;
+}
+
+
+/// Sets a gradient checker not associated to any loss index, with the default values.
+
+void GradientChecker::set()
+{
+    loss_index_pointer = nullptr;
+
+    set_default();
+}
+
+
+/// Sets a gradient checker for a loss index, with the default values.
+/// @param new_loss_index_pointer Pointer to the loss index whose error gradient is checked.
+
+void GradientChecker::set(LossIndex* new_loss_index_pointer)
+{
+    loss_index_pointer = new_loss_index_pointer;
+
+    set_default();
+}
+
+
+/// Sets the members of the gradient checker to their default values:
+/// <ul>
+/// <li> Check method: All parameters.
+/// <li> Random parameters number: 10 per trainable layer.
+/// <li> Random directions number: 1 per trainable layer.
+/// <li> Minimum derivative: 1e-4.
+/// <li> Tolerance: 1e-3.
+/// <li> Workers number: As many as OpenMP threads.
+/// <li> Display: true.
+/// </ul>
+
+void GradientChecker::set_default()
+{
+    check_method = AllParameters;
+
+    random_parameters_number = 10;
+
+    random_directions_number = 1;
+
+    minimum_derivative = static_cast<type>(1.0e-4);
+
+    tolerance = static_cast<type>(1.0e-3);
+
+    workers_number = omp_get_max_threads();
+
+    display = true;
+}
+
+
+/// Sets a new loss index whose error gradient is checked.
+/// @param new_loss_index_pointer Pointer to a loss index with a neural network and a data set.
+
+void GradientChecker::set_loss_index_pointer(LossIndex* new_loss_index_pointer)
+{
+    loss_index_pointer = new_loss_index_pointer;
+}
+
+
+/// Sets a new method to choose the derivatives to be checked.
+/// @param new_check_method Check method.
+
+void GradientChecker::set_check_method(const CheckMethod& new_check_method)
+{
+    check_method = new_check_method;
+}
+
+
+/// Sets a new method to choose the derivatives to be checked from a string.
+/// @param new_check_method String with the name of the check method: "AllParameters", "RandomParameters" or "RandomDirections".
+
+void GradientChecker::set_check_method(const string& new_check_method)
+{
+    if(new_check_method == "AllParameters")
+    {
+        check_method = AllParameters;
+    }
+    else if(new_check_method == "RandomParameters")
+    {
+        check_method = RandomParameters;
+    }
+    else if(new_check_method == "RandomDirections")
+    {
+        check_method = RandomDirections;
+    }
+    else
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: GradientChecker class.\n"
+               << "void set_check_method(const string&) method.\n"
+               << "Unknown check method: " << new_check_method << ".\n";
+
+        throw logic_error(buffer.str());
+    }
+}
+
+
+/// Sets the number of parameters of each trainable layer checked by the random parameters method.
+/// Layers with fewer parameters have all of them checked.
+/// @param new_random_parameters_number Number of parameters per layer.
+
+void GradientChecker::set_random_parameters_number(const Index& new_random_parameters_number)
+{
+    if(new_random_parameters_number <= 0)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: GradientChecker class.\n"
+               << "void set_random_parameters_number(const Index&) method.\n"
+               << "Number of random parameters must be greater than 0.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    random_parameters_number = new_random_parameters_number;
+}
+
+
+/// Sets the number of directions of each trainable layer checked by the random directions method.
+/// @param new_random_directions_number Number of directions per layer.
+
+void GradientChecker::set_random_directions_number(const Index& new_random_directions_number)
+{
+    if(new_random_directions_number <= 0)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: GradientChecker class.\n"
+               << "void set_random_directions_number(const Index&) method.\n"
+               << "Number of random directions must be greater than 0.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    random_directions_number = new_random_directions_number;
+}
+
+
+/// Sets the magnitude below which the derivatives are compared in absolute terms,
+/// so that derivatives which are zero up to rounding errors do not fail the check.
+/// @param new_minimum_derivative Minimum derivative, equal or greater than 0.
+
+void GradientChecker::set_minimum_derivative(const type& new_minimum_derivative)
+{
+    if(new_minimum_derivative < 0)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: GradientChecker class.\n"
+               << "void set_minimum_derivative(const type&) method.\n"
+               << "Minimum derivative (" << new_minimum_derivative << ") must be equal or greater than 0.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    minimum_derivative = new_minimum_derivative;
+}
+
+
+/// Sets the maximum relative error for a check to pass.
+/// @param new_tolerance Tolerance, equal or greater than 0.
+
+void GradientChecker::set_tolerance(const type& new_tolerance)
+{
+    if(new_tolerance < 0)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: GradientChecker class.\n"
+               << "void set_tolerance(const type&) method.\n"
+               << "Tolerance (" << new_tolerance << ") must be equal or greater than 0.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    tolerance = new_tolerance;
+}
+
+
+/// Sets the number of workers which evaluate the perturbed errors.
+/// @param new_workers_number Number of workers.
+
+void GradientChecker::set_workers_number(const Index& new_workers_number)
+{
+    if(new_workers_number <= 0)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: GradientChecker class.\n"
+               << "void set_workers_number(const Index&) method.\n"
+               << "Number of workers must be greater than 0.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    workers_number = new_workers_number;
+}
+
+
+/// Sets a new display value.
+/// If it is set to true messages from this class are to be displayed on the screen;
+/// if it is set to false messages from this class are not to be displayed on the screen.
+/// @param new_display Display value.
+
+void GradientChecker::set_display(const bool& new_display)
+{
+    display = new_display;
+}
+
+
+/// Returns the derivatives of the error of the training instances with respect to all the parameters, by central differences.
+/// The perturbed errors are evaluated in parallel by the workers.
+
+Tensor<type, 1> GradientChecker::calculate_numerical_gradient() const
+{
+    check();
+
+    DataSet* data_set_pointer = loss_index_pointer->get_data_set_pointer();
+
+    const Index parameters_number = loss_index_pointer->get_neural_network_pointer()->get_parameters_number();
+
+    DataSet::Batch batch(data_set_pointer->get_training_instances_number(), data_set_pointer);
+
+    fill_training_batch(batch);
+
+    Tensor<Index, 1> offsets(parameters_number);
+
+    for(Index i = 0; i < parameters_number; i++) offsets(i) = i;
+
+    const Tensor<Tensor<type, 1>, 1> directions(parameters_number);
+
+    return calculate_directional_derivatives(batch, offsets, directions);
+}
+
+
+/// Checks the error gradient calculated by back-propagation against central differences of the error,
+/// along the derivatives chosen by the check method, and returns the relative errors of each trainable layer.
+
+GradientChecker::Results GradientChecker::perform_gradient_check() const
+{
+    check();
+
+    const chrono::steady_clock::time_point beginning_time = chrono::steady_clock::now();
+
+    NeuralNetwork* neural_network_pointer = loss_index_pointer->get_neural_network_pointer();
+
+    DataSet* data_set_pointer = loss_index_pointer->get_data_set_pointer();
+
+    const Index instances_number = data_set_pointer->get_training_instances_number();
+
+    DataSet::Batch batch(instances_number, data_set_pointer);
+
+    fill_training_batch(batch);
+
+    Results results;
+
+    // Analytical gradient
+
+    NeuralNetwork::ForwardPropagation forward_propagation(instances_number, neural_network_pointer);
+
+    LossIndex::BackPropagation back_propagation(instances_number, loss_index_pointer);
+
+    neural_network_pointer->forward_propagate(batch, forward_propagation);
+
+    loss_index_pointer->calculate_error(batch, forward_propagation, back_propagation);
+    loss_index_pointer->calculate_output_gradient(batch, forward_propagation, back_propagation);
+    loss_index_pointer->calculate_layers_delta(forward_propagation, back_propagation);
+    loss_index_pointer->calculate_error_gradient(batch, forward_propagation, back_propagation);
+
+    results.gradient = back_propagation.gradient;
+
+    // Derivatives to be checked
+
+    const Tensor<Layer*, 1> trainable_layers_pointers = neural_network_pointer->get_trainable_layers_pointers();
+
+    const Tensor<Index, 1> trainable_layers_parameters_numbers = neural_network_pointer->get_trainable_layers_parameters_numbers();
+
+    const Index trainable_layers_number = trainable_layers_pointers.size();
+
+    results.layers_names.resize(trainable_layers_number);
+
+    vector<Index> layers_indices;
+    vector<Index> parameters_indices;
+    vector<Tensor<type, 1>> directions;
+
+    Index layer_offset = 0;
+
+    for(Index i = 0; i < trainable_layers_number; i++)
+    {
+        results.layers_names(i) = trainable_layers_pointers(i)->get_name();
+
+        const Index layer_parameters_number = trainable_layers_parameters_numbers(i);
+
+        if(check_method == AllParameters || check_method == RandomParameters)
+        {
+            vector<Index> layer_parameters_indices(static_cast<size_t>(layer_parameters_number));
+
+            for(Index j = 0; j < layer_parameters_number; j++) layer_parameters_indices[static_cast<size_t>(j)] = layer_offset + j;
+
+            if(check_method == RandomParameters && layer_parameters_number > random_parameters_number)
+            {
+                random_shuffle(layer_parameters_indices.begin(), layer_parameters_indices.end());
+
+                layer_parameters_indices.resize(static_cast<size_t>(random_parameters_number));
+
+                sort(layer_parameters_indices.begin(), layer_parameters_indices.end());
+            }
+
+            for(size_t j = 0; j < layer_parameters_indices.size(); j++)
+            {
+                layers_indices.push_back(i);
+                parameters_indices.push_back(layer_parameters_indices[j]);
+                directions.push_back(Tensor<type, 1>());
+            }
+        }
+        else if(layer_parameters_number != 0)
+        {
+            for(Index j = 0; j < random_directions_number; j++)
+            {
+                // Uniform random direction with unit norm
+
+                Tensor<type, 1> direction(layer_parameters_number);
+
+                type squared_norm = 0;
+
+                while(squared_norm == 0)
+                {
+                    for(Index k = 0; k < layer_parameters_number; k++)
+                    {
+                        direction(k) = static_cast<type>(2.0*rand()/RAND_MAX - 1.0);
+                    }
+
+                    const Tensor<type, 0> sum_squares = direction.square().sum();
+
+                    squared_norm = sum_squares(0);
+                }
+
+                direction = direction/sqrt(squared_norm);
+
+                layers_indices.push_back(i);
+                parameters_indices.push_back(layer_offset);
+                directions.push_back(direction);
+            }
+        }
+
+        layer_offset += layer_parameters_number;
+    }
+
+    const Index checks_number = static_cast<Index>(layers_indices.size());
+
+    results.layers_indices.resize(checks_number);
+    results.parameters_indices.resize(checks_number);
+
+    Tensor<Index, 1> offsets(checks_number);
+    Tensor<Tensor<type, 1>, 1> checks_directions(checks_number);
+
+    for(Index i = 0; i < checks_number; i++)
+    {
+        results.layers_indices(i) = layers_indices[static_cast<size_t>(i)];
+
+        offsets(i) = parameters_indices[static_cast<size_t>(i)];
+
+        checks_directions(i) = directions[static_cast<size_t>(i)];
+
+        results.parameters_indices(i) = checks_directions(i).size() == 0 ? offsets(i) : -1;
+    }
+
+    if(display)
+    {
+        cout << "Checking " << checks_number << " derivatives of the error gradient by " << write_check_method()
+             << " with " << min(workers_number, checks_number) << " workers...\n";
+    }
+
+    // Numerical derivatives
+
+    results.numerical_derivatives = calculate_directional_derivatives(batch, offsets, checks_directions);
+
+    results.error_evaluations_number = 2*checks_number;
+
+    // Relative errors
+
+    results.analytical_derivatives.resize(checks_number);
+    results.relative_errors.resize(checks_number);
+
+    results.layers_maximum_relative_errors.resize(trainable_layers_number);
+    results.layers_maximum_relative_errors.setConstant(numeric_limits<type>::quiet_NaN());
+
+    results.maximum_relative_error = 0;
+
+    for(Index i = 0; i < checks_number; i++)
+    {
+        const Tensor<type, 1>& direction = checks_directions(i);
+
+        type analytical_derivative = 0;
+
+        if(direction.size() == 0)
+        {
+            analytical_derivative = results.gradient(offsets(i));
+        }
+        else
+        {
+            for(Index k = 0; k < direction.size(); k++) analytical_derivative += results.gradient(offsets(i) + k)*direction(k);
+        }
+
+        const type numerical_derivative = results.numerical_derivatives(i);
+
+        const type denominator = max(max(abs(analytical_derivative), abs(numerical_derivative)), minimum_derivative);
+
+        type relative_error = denominator > 0 ? abs(analytical_derivative - numerical_derivative)/denominator : 0;
+
+        // NaN derivatives fail the check
+
+        if(::isnan(relative_error)) relative_error = numeric_limits<type>::infinity();
+
+        results.analytical_derivatives(i) = analytical_derivative;
+        results.relative_errors(i) = relative_error;
+
+        type& layer_maximum_relative_error = results.layers_maximum_relative_errors(results.layers_indices(i));
+
+        if(::isnan(layer_maximum_relative_error) || relative_error > layer_maximum_relative_error)
+        {
+            layer_maximum_relative_error = relative_error;
+        }
+
+        if(relative_error > results.maximum_relative_error) results.maximum_relative_error = relative_error;
+    }
+
+    results.passed = results.maximum_relative_error <= tolerance;
+
+    results.elapsed_time = static_cast<type>(chrono::duration<double>(chrono::steady_clock::now() - beginning_time).count());
+
+    if(display) results.print();
+
+    return results;
+}
+
+
+/// Throws an exception if the loss index, its neural network or its data set are missing,
+/// or if there are no parameters or no training instances.
+
+void GradientChecker::check() const
+{
+    ostringstream buffer;
+
+    if(!loss_index_pointer)
+    {
+        buffer << "OpenNN Exception: GradientChecker class.\n"
+               << "void check() const method.\n"
+               << "Pointer to loss index is nullptr.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    const NeuralNetwork* neural_network_pointer = loss_index_pointer->get_neural_network_pointer();
+
+    const DataSet* data_set_pointer = loss_index_pointer->get_data_set_pointer();
+
+    if(!neural_network_pointer || !data_set_pointer)
+    {
+        buffer << "OpenNN Exception: GradientChecker class.\n"
+               << "void check() const method.\n"
+               << "Loss index must have a neural network and a data set.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    if(neural_network_pointer->get_parameters_number() == 0 || data_set_pointer->get_training_instances_number() == 0)
+    {
+        buffer << "OpenNN Exception: GradientChecker class.\n"
+               << "void check() const method.\n"
+               << "Neural network must have parameters and data set must have training instances.\n";
+
+        throw logic_error(buffer.str());
+    }
+}
+
+
+/// Fills a batch with all the training instances of the data set.
+/// @param batch Batch of the training instances.
+
+void GradientChecker::fill_training_batch(DataSet::Batch& batch) const
+{
+    const DataSet* data_set_pointer = loss_index_pointer->get_data_set_pointer();
+
+    Tensor<Index, 1> instances_indices = data_set_pointer->get_training_instances_indices();
+    const Tensor<Index, 1> input_indices = data_set_pointer->get_input_variables_indices();
+    const Tensor<Index, 1> target_indices = data_set_pointer->get_target_variables_indices();
+
+    batch.fill(instances_indices, input_indices, target_indices);
+}
+
+
+/// Returns the derivatives of the error along some directions by central differences, evaluated in parallel.
+/// Each worker perturbs its own copy of the parameters vector and restores it afterwards, so that no vectors are allocated per derivative,
+/// and the profiler of the neural network, which is not thread safe, is detached meanwhile.
+/// @param batch Batch of the training instances.
+/// @param offsets Index of the first parameter of each direction.
+/// @param directions Values of each direction from its offset, or an empty vector for the derivative with respect to the parameter at the offset.
+
+Tensor<type, 1> GradientChecker::calculate_directional_derivatives(const DataSet::Batch& batch,
+                                                                   const Tensor<Index, 1>& offsets,
+                                                                   const Tensor<Tensor<type, 1>, 1>& directions) const
+{
+    NeuralNetwork* neural_network_pointer = loss_index_pointer->get_neural_network_pointer();
+
+    const Tensor<type, 1> parameters = neural_network_pointer->get_parameters();
+
+    const Index derivatives_number = offsets.size();
+
+    Tensor<type, 1> derivatives(derivatives_number);
+
+    if(derivatives_number == 0) return derivatives;
+
+    const int threads_number = static_cast<int>(min(workers_number, derivatives_number));
+
+    vector<unique_ptr<Worker>> workers(static_cast<size_t>(threads_number));
+
+    for(size_t i = 0; i < workers.size(); i++)
+    {
+        workers[i].reset(new Worker(batch.get_instances_number(), neural_network_pointer, loss_index_pointer));
+
+        workers[i]->parameters = parameters;
+    }
+
+    TrainingProfiler* profiler_pointer = neural_network_pointer->get_profiler_pointer();
+
+    neural_network_pointer->set_profiler_pointer(nullptr);
+
+    string error_message;
+
+    #pragma omp parallel for schedule(dynamic) num_threads(threads_number)
+    for(Index i = 0; i < derivatives_number; i++)
+    {
+        Worker& worker = *workers[static_cast<size_t>(omp_get_thread_num())];
+
+        try
+        {
+            const Index offset = offsets(i);
+
+            const Tensor<type, 1>& direction = directions(i);
+
+            const Index size = direction.size() == 0 ? 1 : direction.size();
+
+            // The step of a direction is scaled by the root mean square of its parameters
+
+            type scale = parameters(offset);
+
+            if(direction.size() != 0)
+            {
+                type sum_squares = 0;
+
+                for(Index k = 0; k < size; k++) sum_squares += parameters(offset + k)*parameters(offset + k);
+
+                scale = sqrt(sum_squares/static_cast<type>(size));
+            }
+
+            const type h = loss_index_pointer->calculate_h(scale);
+
+            for(Index k = 0; k < size; k++)
+            {
+                worker.parameters(offset + k) = parameters(offset + k) + h*(direction.size() == 0 ? 1 : direction(k));
+            }
+
+            const type error_forward = calculate_error(batch, worker);
+
+            for(Index k = 0; k < size; k++)
+            {
+                worker.parameters(offset + k) = parameters(offset + k) - h*(direction.size() == 0 ? 1 : direction(k));
+            }
+
+            const type error_backward = calculate_error(batch, worker);
+
+            for(Index k = 0; k < size; k++)
+            {
+                worker.parameters(offset + k) = parameters(offset + k);
+            }
+
+            derivatives(i) = (error_forward - error_backward)/(static_cast<type>(2.0)*h);
+        }
+        catch(const exception& e)
+        {
+            #pragma omp critical
+            error_message = e.what();
+        }
+    }
+
+    neural_network_pointer->set_profiler_pointer(profiler_pointer);
+
+    if(!error_message.empty())
+    {
+        throw logic_error(error_message);
+    }
+
+    return derivatives;
+}
+
+
+/// Returns the error of the training instances for the parameters of a worker.
+/// @param batch Batch of the training instances.
+/// @param worker Worker with the parameters and the forward propagation.
+
+type GradientChecker::calculate_error(const DataSet::Batch& batch, Worker& worker) const
+{
+    loss_index_pointer->get_neural_network_pointer()->forward_propagate(batch, worker.parameters, worker.forward_propagation);
+
+    loss_index_pointer->calculate_error(batch, worker.forward_propagation, worker.back_propagation);
+
+    return worker.back_propagation.error;
+}
+
+
+/// Prints to the screen the maximum relative error of each trainable layer and of all the derivatives.
+
+void GradientChecker::Results::print() const
+{
+    cout << "Gradient check results\n"
+         << "Layer\tMaximum relative error\n";
+
+    for(Index i = 0; i < layers_names.size(); i++)
+    {
+        cout << i << " " << layers_names(i) << "\t" << layers_maximum_relative_errors(i) << "\n";
+    }
+
+    cout << "Maximum relative error: " << maximum_relative_error << "\n"
+         << "Passed: " << (passed ? "yes" : "no") << "\n"
+         << "Error evaluations: " << error_evaluations_number << "\n"
+         << "Elapsed time: " << elapsed_time << " s" << endl;
+}
+
+}
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
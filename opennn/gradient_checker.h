@@ -0,0 +1,262 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   G R A D I E N T   C H E C K E R   C L A S S   H E A D E R
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#ifndef GRADIENTCHECKER_H
+#define GRADIENTCHECKER_H
+
+// System includes
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <limits>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <chrono>
+#include <omp.h>
+
+// OpenNN includes
+
+#include "config.h"
+#include "data_set.h"
+#include "neural_network.h"
+#include "loss_index.h"
+
+using namespace std;
+using namespace Eigen;
+
+namespace OpenNN
+{
+
+/// This class checks the error gradient of a loss index against central differences of its error, in parallel.
+
+///
+/// The error is evaluated on the training instances, without regularization, as the numerical differentiation methods of LossIndex do.
+/// The parameters of the neural network are perturbed by workers, each one owning a forward propagation and a parameters vector,
+/// so that the perturbed errors are evaluated concurrently without modifying the neural network.
+/// The derivatives are checked along all the parameters, along some random parameters of each trainable layer,
+/// or along some random directions of each trainable layer, which takes two error evaluations per direction whatever the number of parameters.
+/// The maximum relative error of the derivatives of each trainable layer is reported.
+
+class GradientChecker
+{
+
+public:
+
+   // Constructors
+
+   explicit GradientChecker();
+
+   explicit GradientChecker(LossIndex*);
+
+   // Destructor
+
+   virtual ~GradientChecker();
+
+   /// Enumeration of the methods to choose the derivatives to be checked.
+
+   enum CheckMethod{AllParameters, RandomParameters, RandomDirections};
+
+   /// This structure contains the checked derivatives and their relative errors.
+
+   struct Results
+   {
+       /// Default constructor.
+
+       explicit Results() {}
+
+       virtual ~Results() {}
+
+       void print() const;
+
+       /// Error gradient calculated by back-propagation.
+
+       Tensor<type, 1> gradient;
+
+       /// Index of the trainable layer of each checked derivative.
+
+       Tensor<Index, 1> layers_indices;
+
+       /// Index of the parameter of each checked derivative, or -1 for directional derivatives.
+
+       Tensor<Index, 1> parameters_indices;
+
+       /// Derivatives calculated from the gradient.
+
+       Tensor<type, 1> analytical_derivatives;
+
+       /// Derivatives calculated by central differences.
+
+       Tensor<type, 1> numerical_derivatives;
+
+       /// Relative errors between the analytical and the numerical derivatives.
+
+       Tensor<type, 1> relative_errors;
+
+       /// Names of the trainable layers.
+
+       Tensor<string, 1> layers_names;
+
+       /// Maximum relative error of the derivatives of each trainable layer, or NaN if the layer has no parameters.
+
+       Tensor<type, 1> layers_maximum_relative_errors;
+
+       /// Maximum relative error of all the derivatives.
+
+       type maximum_relative_error = 0;
+
+       /// True if the maximum relative error is not larger than the tolerance.
+
+       bool passed = false;
+
+       /// Number of evaluations of the error.
+
+       Index error_evaluations_number = 0;
+
+       /// Time of the check, in seconds.
+
+       type elapsed_time = 0;
+   };
+
+   // Get methods
+
+   LossIndex* get_loss_index_pointer() const;
+
+   const CheckMethod& get_check_method() const;
+   string write_check_method() const;
+
+   const Index& get_random_parameters_number() const;
+
+   const Index& get_random_directions_number() const;
+
+   const type& get_minimum_derivative() const;
+
+   const type& get_tolerance() const;
+
+   const Index& get_workers_number() const;
+
+   const bool& get_display() const;
+
+   // Set methods
+
+   void set();
+   void set(LossIndex*);
+
+   void set_default();
+
+   void set_loss_index_pointer(LossIndex*);
+
+   void set_check_method(const CheckMethod&);
+   void set_check_method(const string&);
+
+   void set_random_parameters_number(const Index&);
+
+   void set_random_directions_number(const Index&);
+
+   void set_minimum_derivative(const type&);
+
+   void set_tolerance(const type&);
+
+   void set_workers_number(const Index&);
+
+   void set_display(const bool&);
+
+   // Checking methods
+
+   Tensor<type, 1> calculate_numerical_gradient() const;
+
+   Results perform_gradient_check() const;
+
+private:
+
+   /// Forward propagation and perturbed parameters of a worker.
+
+   struct Worker
+   {
+       explicit Worker(const Index& instances_number, NeuralNetwork* neural_network_pointer, LossIndex* loss_index_pointer)
+           : forward_propagation(instances_number, neural_network_pointer),
+             back_propagation(instances_number, loss_index_pointer)
+       {
+       }
+
+       virtual ~Worker() {}
+
+       NeuralNetwork::ForwardPropagation forward_propagation;
+
+       LossIndex::BackPropagation back_propagation;
+
+       Tensor<type, 1> parameters;
+   };
+
+   void check() const;
+
+   void fill_training_batch(DataSet::Batch&) const;
+
+   Tensor<type, 1> calculate_directional_derivatives(const DataSet::Batch&,
+                                                     const Tensor<Index, 1>&,
+                                                     const Tensor<Tensor<type, 1>, 1>&) const;
+
+   type calculate_error(const DataSet::Batch&, Worker&) const;
+
+   /// Pointer to the loss index whose error gradient is checked.
+
+   LossIndex* loss_index_pointer = nullptr;
+
+   /// Method to choose the derivatives to be checked.
+
+   CheckMethod check_method = AllParameters;
+
+   /// Number of parameters of each trainable layer checked by the random parameters method.
+
+   Index random_parameters_number = 10;
+
+   /// Number of directions of each trainable layer checked by the random directions method.
+
+   Index random_directions_number = 1;
+
+   /// Derivatives whose magnitude is smaller than this value are compared in absolute terms.
+
+   type minimum_derivative = static_cast<type>(1.0e-4);
+
+   /// Maximum relative error for a check to pass.
+
+   type tolerance = static_cast<type>(1.0e-3);
+
+   /// Number of workers which evaluate the perturbed errors.
+
+   Index workers_number = 1;
+
+   /// Display messages to screen.
+
+   bool display = true;
+};
+
+}
+
+#endif
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
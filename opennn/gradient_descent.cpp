@@ -571,8 +571,14 @@ OptimizationAlgorithm::Results GradientDescent::perform_training()
     DataSet::Batch training_batch(training_instances_number, data_set_pointer);
     DataSet::Batch selection_batch(selection_instances_number, data_set_pointer);
 
-    training_batch.fill(training_instances_indices, inputs_indices, target_indices);
-    selection_batch.fill(selection_instances_indices, inputs_indices, target_indices);
+    start_profile();
+
+    {
+        OPENNN_PROFILE_SCOPE(&profiler, TrainingProfiler::BatchFill);
+
+        training_batch.fill(training_instances_indices, inputs_indices, target_indices);
+        selection_batch.fill(selection_instances_indices, inputs_indices, target_indices);
+    }
 
     training_instances_indices.resize(0);
     selection_instances_indices.resize(0);
@@ -625,8 +631,40 @@ OptimizationAlgorithm::Results GradientDescent::perform_training()
     time(&beginning_time);
     type elapsed_time = 0;
 
-    for(Index epoch = 0; epoch <= maximum_epochs_number; epoch++)
+    // Checkpoint
+
+    TrainingCheckpoint checkpoint;
+
+    Index initial_epoch = 0;
+
+    if(start_checkpoints(checkpoint, results))
+    {
+        initial_epoch = checkpoint.get_epoch();
+
+        beginning_time -= static_cast<time_t>(checkpoint.get_elapsed_time());
+
+        optimization_data.parameters = checkpoint.get_vector("parameters");
+        optimization_data.old_learning_rate = checkpoint.get_scalar("old_learning_rate");
+        optimization_data.old_training_loss = checkpoint.get_scalar("old_training_loss");
+
+        minimal_selection_parameters = checkpoint.get_vector("minimal_selection_parameters");
+        minimum_selection_error = checkpoint.get_scalar("minimum_selection_error");
+        old_selection_error = checkpoint.get_scalar("old_selection_error");
+        selection_error_increases = checkpoint.get_index("selection_error_increases");
+
+        neural_network_pointer->set_parameters(optimization_data.parameters);
+    }
+
+    // Observers
+
+    begin_observers();
+
+    TrainingObserver::Metrics metrics;
+
+    for(Index epoch = initial_epoch; epoch <= maximum_epochs_number; epoch++)
     {
+        begin_epoch_profile(epoch);
+
         optimization_data.epoch = epoch;
 
         // Neural network
@@ -668,9 +706,17 @@ OptimizationAlgorithm::Results GradientDescent::perform_training()
 
         // Optimization algorithm
 
-        update_epoch(training_batch, training_forward_propagation, training_back_propagation, optimization_data);
+        {
+            OPENNN_PROFILE_SCOPE(&profiler, TrainingProfiler::UpdateIteration);
 
-        neural_network_pointer->set_parameters(optimization_data.parameters);
+            update_epoch(training_batch, training_forward_propagation, training_back_propagation, optimization_data);
+        }
+
+        {
+            OPENNN_PROFILE_SCOPE(&profiler, TrainingProfiler::SetParameters);
+
+            neural_network_pointer->set_parameters(optimization_data.parameters);
+        }
 
         // Elapsed time
 
@@ -760,6 +806,30 @@ OptimizationAlgorithm::Results GradientDescent::perform_training()
             results.stopping_condition = MaximumTime;
         }
 
+        if(!stop_training && check_training_control())
+        {
+            if(display) cout << "Epoch " << epoch+1 << ": Stop requested.\n";
+
+            stop_training = true;
+
+            results.stopping_condition = StopRequested;
+        }
+
+        if(has_observers())
+        {
+            metrics.epoch = epoch;
+            metrics.iteration = 0;
+            metrics.iterations_number = epoch + 1;
+            metrics.instances_number = training_instances_number;
+            metrics.training_loss = training_back_propagation.loss;
+            metrics.training_error = training_back_propagation.error;
+            metrics.selection_error = has_selection ? selection_back_propagation.error : numeric_limits<type>::quiet_NaN();
+            metrics.gradient_norm = gradient_norm;
+            metrics.learning_rate = optimization_data.learning_rate;
+
+            notify_epoch(metrics);
+        }
+
         if(epoch != 0 && epoch % save_period == 0)
         {
             neural_network_pointer->save(neural_network_file_name);
@@ -816,8 +886,28 @@ OptimizationAlgorithm::Results GradientDescent::perform_training()
         old_selection_error = selection_back_propagation.error;
 
         if(stop_training) break;
+
+        if(is_checkpoint_epoch(epoch+1))
+        {
+            checkpoint.set_vector("parameters", optimization_data.parameters);
+            checkpoint.set_scalar("old_learning_rate", optimization_data.old_learning_rate);
+            checkpoint.set_scalar("old_training_loss", optimization_data.old_training_loss);
+
+            checkpoint.set_vector("minimal_selection_parameters", minimal_selection_parameters);
+            checkpoint.set_scalar("minimum_selection_error", minimum_selection_error);
+            checkpoint.set_scalar("old_selection_error", old_selection_error);
+            checkpoint.set_index("selection_error_increases", selection_error_increases);
+
+            write_checkpoint(checkpoint, results, epoch+1, elapsed_time);
+        }
     }
 
+    wait_checkpoint();
+
+    finish_profile(results);
+
+    end_observers(results);
+
     if(choose_best_selection)
     {
         neural_network_pointer->set_parameters(minimal_selection_parameters);
@@ -1242,6 +1332,10 @@ void GradientDescent::write_XML(tinyxml2::XMLPrinter& file_stream) const
 
     file_stream.CloseElement();
 
+    // Checkpoints
+
+    write_checkpoints_XML(file_stream);
+
     file_stream.CloseElement();
 }
 
@@ -1468,6 +1562,10 @@ void GradientDescent::from_XML(const tinyxml2::XMLDocument& document)
             }
         }
     }
+
+    // Checkpoints
+
+    checkpoints_from_XML(root_element);
 }
 
 }
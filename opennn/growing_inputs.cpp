@@ -258,6 +258,8 @@ GrowingInputs::GrowingInputsResults* GrowingInputs::perform_inputs_selection()
     time_t beginning_time, current_time;
     type elapsed_time = 0;
 
+    training_scheduler.set_training_strategy_pointer(training_strategy_pointer);
+
     time(&beginning_time);
 
     bool end_algorithm = false;
@@ -272,6 +274,8 @@ GrowingInputs::GrowingInputsResults* GrowingInputs::perform_inputs_selection()
 
         const string column_name = used_columns_names[column_index];
 
+        const Tensor<Index, 1> previous_input_variables_indices = data_set_pointer->get_input_variables_indices();
+
         data_set_pointer->set_column_use(column_name, DataSet::Input);
 
         current_columns_indices = insert_result(column_index, current_columns_indices);
@@ -280,41 +284,36 @@ GrowingInputs::GrowingInputsResults* GrowingInputs::perform_inputs_selection()
 
         data_set_pointer->set_input_variables_dimensions({input_variables_number});
 
-        neural_network_pointer->set_inputs_number(input_variables_number);
+        // Warm start
+
+        Tensor<Tensor<type, 1>, 1> initial_parameters;
 
-        // Trial
+        if(warm_start && iteration != 0)
+        {
+            neural_network_pointer->set_parameters(current_parameters);
 
-        type optimum_selection_error_trial = numeric_limits<type>::max();
-        type optimum_training_error_trial = numeric_limits<type>::max();
-        Tensor<type, 1> optimum_parameters_trial;
+            neural_network_pointer->resize_inputs(get_inputs_indices(previous_input_variables_indices,
+                                                                     data_set_pointer->get_input_variables_indices()));
 
-        for(Index i = 0; i < trials_number; i++)
+            initial_parameters.resize(1);
+            initial_parameters(0) = neural_network_pointer->get_parameters();
+        }
+        else
         {
-            OptimizationAlgorithm::Results training_results = training_strategy_pointer->perform_training();
+            neural_network_pointer->set_inputs_number(input_variables_number);
+        }
 
-            type current_training_error_trial = training_results.final_training_error;
-            type current_selection_error_trial = training_results.final_selection_error;
-            Tensor<type, 1> current_parameters_trial = training_results.final_parameters;
+        // Trials
 
-            if(display)
-            {
-                cout << endl << "Trial number: " << i << endl;
-                cout << "Training error: " << current_training_error_trial << endl;
-                cout << "Selection error: " << current_selection_error_trial << endl;
-                cout << "Stopping condition: " << training_results.write_stopping_condition() << endl << endl;
-            }
+        Tensor<Tensor<DataSet::VariableUse, 1>, 1> columns_uses(1);
 
-            if(current_selection_error_trial < optimum_selection_error_trial)
-            {
-                optimum_parameters_trial = current_parameters_trial;
-                optimum_selection_error_trial = current_selection_error_trial;
-                optimum_training_error_trial = current_training_error_trial;
-            }
-        }
+        columns_uses(0) = data_set_pointer->get_columns_uses();
 
-        current_selection_error = optimum_selection_error_trial;
-        current_training_error = optimum_training_error_trial;
-        current_parameters = optimum_parameters_trial;
+        const OptimizationAlgorithm::Results training_results = perform_trials(columns_uses, initial_parameters)(0);
+
+        current_selection_error = training_results.final_selection_error;
+        current_training_error = training_results.final_training_error;
+        current_parameters = training_results.final_parameters;
 
         if(current_selection_error < optimum_selection_error)
         {
@@ -630,6 +629,18 @@ tinyxml2::XMLDocument* GrowingInputs::to_XML() const
         element->LinkEndChild(text);
     }
 
+    // Warm start
+    {
+        element = document->NewElement("WarmStart");
+        root_element->LinkEndChild(element);
+
+        buffer.str("");
+        buffer << warm_start;
+
+        text = document->NewText(buffer.str().c_str());
+        element->LinkEndChild(text);
+    }
+
     // Tolerance
     {
         element = document->NewElement("Tolerance");
@@ -799,6 +810,17 @@ void GrowingInputs::write_XML(tinyxml2::XMLPrinter& file_stream) const
 
     file_stream.CloseElement();
 
+    // Warm start
+
+    file_stream.OpenElement("WarmStart");
+
+    buffer.str("");
+    buffer << warm_start;
+
+    file_stream.PushText(buffer.str().c_str());
+
+    file_stream.CloseElement();
+
     // Tolerance
 
     file_stream.OpenElement("Tolerance");
@@ -981,6 +1003,25 @@ void GrowingInputs::from_XML(const tinyxml2::XMLDocument& document)
         }
     }
 
+    // Warm start
+    {
+        const tinyxml2::XMLElement* element = root_element->FirstChildElement("WarmStart");
+
+        if(element)
+        {
+            const string new_warm_start = element->GetText();
+
+            try
+            {
+                set_warm_start(new_warm_start != "0");
+            }
+            catch(const logic_error& e)
+            {
+                cerr << e.what() << endl;
+            }
+        }
+    }
+
     // Reserve loss data
     {
         const tinyxml2::XMLElement* element = root_element->FirstChildElement("ReserveTrainingErrorHistory");
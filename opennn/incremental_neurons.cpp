@@ -179,6 +179,8 @@ IncrementalNeurons::IncrementalNeuronsResults* IncrementalNeurons::perform_neuro
     time_t beginning_time, current_time;
     type elapsed_time = 0;
 
+    training_scheduler.set_training_strategy_pointer(training_strategy_pointer);
+
     time(&beginning_time);
 
     // Main loop
@@ -187,46 +189,35 @@ IncrementalNeurons::IncrementalNeuronsResults* IncrementalNeurons::perform_neuro
     {
         // Set new neurons number
 
-        trainable_layers_pointers(trainable_layers_number-2)->set_neurons_number(neurons_number);
-        trainable_layers_pointers(trainable_layers_number-1)->set_inputs_number(neurons_number);
-        results->neurons_data = insert_index_result(neurons_number, results->neurons_data);
+        Tensor<Tensor<type, 1>, 1> initial_parameters;
 
-        // Loss index
+        if(warm_start && i != 0)
+        {
+            neural_network->set_parameters(current_parameters);
 
-        type optimum_selection_error_trial = numeric_limits<type>::max();
-        type optimum_training_error_trial = numeric_limits<type>::max();
-        Tensor<type, 1> optimum_parameters_trial;
+            neural_network->resize_hidden_neurons(neurons_number);
 
-        for(Index i = 0; i < trials_number; i++)
+            initial_parameters.resize(1);
+            initial_parameters(0) = neural_network->get_parameters();
+        }
+        else
         {
-            neural_network->set_parameters_random();
+            trainable_layers_pointers(trainable_layers_number-2)->set_neurons_number(neurons_number);
+            trainable_layers_pointers(trainable_layers_number-1)->set_inputs_number(neurons_number);
+        }
 
-            const OptimizationAlgorithm::Results optimization_algorithm_results
-                    = training_strategy_pointer->perform_training();
+        results->neurons_data = insert_index_result(neurons_number, results->neurons_data);
 
-            const type current_training_error_trial = optimization_algorithm_results.final_training_error;
-            const type current_selection_error_trial = optimization_algorithm_results.final_selection_error;
-            const Tensor<type, 1> current_parameters_trial = optimization_algorithm_results.final_parameters;
+        // Trials
 
-            if(current_selection_error_trial < optimum_selection_error_trial)
-            {
-                optimum_training_error_trial = current_training_error_trial;
-                optimum_selection_error_trial = current_selection_error_trial;
-                optimum_parameters_trial = current_parameters_trial;
-            }
+        Tensor<Index, 1> neurons_numbers(1);
+        neurons_numbers.setConstant(neurons_number);
 
-            if(display)
-            {
-                cout << "Trial number: " << i << endl;
-                cout << "Training error: " << current_training_error_trial << endl;
-                cout << "Selection error: " << current_selection_error_trial << endl;
-                cout << "Stopping condition: " << optimization_algorithm_results.write_stopping_condition() << endl;
-            }
-        }
+        const OptimizationAlgorithm::Results optimization_algorithm_results = perform_trials(neurons_numbers, initial_parameters)(0);
 
-        current_training_loss = optimum_training_error_trial;
-        current_selection_error = optimum_selection_error_trial;
-        current_parameters = optimum_parameters_trial;
+        current_training_loss = optimization_algorithm_results.final_training_error;
+        current_selection_error = optimization_algorithm_results.final_selection_error;
+        current_parameters = optimization_algorithm_results.final_parameters;
 
         time(&current_time);
 
@@ -554,6 +545,18 @@ tinyxml2::XMLDocument* IncrementalNeurons::to_XML() const
         element->LinkEndChild(text);
     }
 
+    // Warm start
+    {
+        element = document->NewElement("WarmStart");
+        root_element->LinkEndChild(element);
+
+        buffer.str("");
+        buffer << warm_start;
+
+        text = document->NewText(buffer.str().c_str());
+        element->LinkEndChild(text);
+    }
+
     // Reserve minimal parameters
 //   {
 //   element = document->NewElement("ReserveMinimalParameters");
@@ -720,6 +723,17 @@ void IncrementalNeurons::write_XML(tinyxml2::XMLPrinter& file_stream) const
 
     file_stream.CloseElement();
 
+    // Warm start
+
+    file_stream.OpenElement("WarmStart");
+
+    buffer.str("");
+    buffer << warm_start;
+
+    file_stream.PushText(buffer.str().c_str());
+
+    file_stream.CloseElement();
+
     // Tolerance
 
     file_stream.OpenElement("Tolerance");
@@ -885,6 +899,25 @@ void IncrementalNeurons::from_XML(const tinyxml2::XMLDocument& document)
         }
     }
 
+    // Warm start
+    {
+        const tinyxml2::XMLElement* element = root_element->FirstChildElement("WarmStart");
+
+        if(element)
+        {
+            const string new_warm_start = element->GetText();
+
+            try
+            {
+                set_warm_start(new_warm_start != "0");
+            }
+            catch(const logic_error& e)
+            {
+                cerr << e.what() << endl;
+            }
+        }
+    }
+
     // Tolerance
     {
         const tinyxml2::XMLElement* element = root_element->FirstChildElement("Tolerance");
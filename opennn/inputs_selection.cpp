@@ -100,6 +100,15 @@ bool InputsSelection::has_training_strategy() const
 }
 
 
+/// Returns a pointer to the scheduler which trains the candidates concurrently.
+/// It can be used to set the number of workers and the threads of each worker.
+
+TrainingScheduler* InputsSelection::get_training_scheduler_pointer()
+{
+    return &training_scheduler;
+}
+
+
 /// Returns the number of trials for each network architecture.
 
 const Index& InputsSelection::get_trials_number() const
@@ -108,6 +117,15 @@ const Index& InputsSelection::get_trials_number() const
 }
 
 
+/// Returns true if each step of the selection starts training from the parameters of the previous one,
+/// and false if the parameters are initialized at random.
+
+const bool& InputsSelection::get_warm_start() const
+{
+    return warm_start;
+}
+
+
 /// Returns true if the loss index losses are to be reserved, and false otherwise.
 
 const bool& InputsSelection::get_reserve_training_error_data() const
@@ -216,6 +234,8 @@ void InputsSelection::set_default()
 {
     trials_number = 1;
 
+    warm_start = false;
+
     // Results
 
     reserve_training_error_data = true;
@@ -262,6 +282,16 @@ void InputsSelection::set_trials_number(const Index& new_trials_number)
 }
 
 
+/// Sets whether each step of the selection starts training from the parameters of the previous one.
+/// The parameters of the inputs or neurons which remain are kept, and those of the new ones are initialized near zero.
+/// @param new_warm_start True to start from the previous parameters, false to start from random parameters.
+
+void InputsSelection::set_warm_start(const bool& new_warm_start)
+{
+    warm_start = new_warm_start;
+}
+
+
 /// Sets the reserve flag for the loss data.
 /// @param new_reserve_error_data Flag value.
 
@@ -468,133 +498,71 @@ Tensor<type, 1> InputsSelection::calculate_losses(const Tensor<bool, 1> & inputs
 
 #endif
 
-    // Neural network
+    // Trials
 
-    NeuralNetwork* neural_network = training_strategy_pointer->get_neural_network_pointer();
+    const DataSet* data_set_pointer = training_strategy_pointer->get_loss_index_pointer()->get_data_set_pointer();
 
-    // Optimization algorithm
+    Tensor<Tensor<DataSet::VariableUse, 1>, 1> columns_uses(1);
 
-    OptimizationAlgorithm::Results results;
+    columns_uses(0) = data_set_pointer->get_columns_uses();
 
-    type optimum_selection_error = numeric_limits<type>::max();
-    type optimum_training_error = numeric_limits<type>::max();
+    const OptimizationAlgorithm::Results results = perform_trials(columns_uses)(0);
 
-    Tensor<type, 1> optimum_parameters;
+    if(display)
+    {
+        if(trials_number != 1) cout << "Trial number: " << trials_number << endl;
+        cout << "Training loss: " << results.final_training_error << endl;
+        cout << "Selection error: " << results.final_selection_error << endl;
+        cout << "Stopping condition: " << write_stopping_condition(results) << endl << endl;
+    }
 
     Tensor<type, 1> optimum_losses(2);
 
-    bool flag_loss = false;
-    bool flag_selection = false;
+    optimum_losses[0] = results.final_training_error;
+    optimum_losses[1] = results.final_selection_error;
 
-    // Check population
+    return optimum_losses;
+}
 
-    for(Index i = 0; i < inputs_history.size(); i++)
-    {
-        const Tensor<bool, 1> inputs_rows = inputs_history.chip(i,0);
 
-        for(Index j = 0; j < inputs_rows.size(); j++)
-        {
-            if(inputs_rows(j) != inputs(j)) break;
+/// Trains trials_number times the neural network with each of the given uses of the data set columns,
+/// and returns the results of the trial with the minimum selection error for each uses.
+/// The trainings run concurrently on the training scheduler, which does not train again the input masks already evaluated.
+/// The results are appended to the histories.
+/// @param columns_uses Uses of the data set columns of each candidate.
+/// @param parameters Initial parameters of each candidate for its first trial. If empty, all the trials start from random parameters.
 
-            optimum_losses[0] = training_error_history[i];
-            flag_loss = true;
-        }
-        /*if(inputs_history(i) == inputs)
-        {
-            optimum_losses[0] = training_error_history[i];
-            flag_loss = true;
-        }*/
-    }
+Tensor<OptimizationAlgorithm::Results, 1> InputsSelection::perform_trials(const Tensor<Tensor<DataSet::VariableUse, 1>, 1>& columns_uses,
+                                                                          const Tensor<Tensor<type, 1>, 1>& parameters)
+{
+    const Index candidates_number = columns_uses.size();
 
-    for(Index i = 0; i < inputs_history.size(); i++)
-    {
-        const Tensor<bool, 1> inputs_rows = inputs_history.chip(i,0);
+    Tensor<TrainingScheduler::Candidate, 1> candidates(candidates_number);
 
-        for(Index j = 0; j < inputs_rows.size(); j++)
-        {
-            if(inputs_rows(j) != inputs(j)) break;
+    for(Index i = 0; i < candidates_number; i++)
+    {
+        candidates(i).columns_uses = columns_uses(i);
 
-            optimum_losses(0) = selection_error_history(i);
-            flag_selection = true;
-        }
-        /*
-                if(inputs_history[i] == inputs)
-                {
-                    optimum_losses[1] = selection_error_history[i];
-                    flag_selection = true;
-                }*/
+        if(parameters.size() != 0) candidates(i).parameters = parameters(i);
     }
 
-    if(flag_loss && flag_selection)
+    if(training_scheduler.get_training_strategy_pointer() != training_strategy_pointer)
     {
-        if(display)
-        {
-            cout << "Training loss: " << optimum_losses[0] << endl;
-            cout << "Selection error: " << optimum_losses[1] << endl;
-            cout << "Stopping condition: " << write_stopping_condition(results) << endl << endl;
-        }
-        return optimum_losses;
+        training_scheduler.set_training_strategy_pointer(training_strategy_pointer);
     }
 
-    neural_network->perturbate_parameters(static_cast<type>(0.001));
-
-//    neural_network->set_inputs_number(inputs);
+    const Tensor<OptimizationAlgorithm::Results, 1> optimum_results = training_scheduler.perform_trials(candidates, trials_number);
 
-    for(Index i = 0; i < trials_number; i++)
+    for(Index i = 0; i < candidates_number; i++)
     {
-        neural_network->set_parameters_random();
-
-        results = training_strategy_pointer->perform_training();
+        training_error_history.push_back(optimum_results(i).final_training_error);
 
-        const type selection_error = results.final_selection_error;
-        const type training_error = results.final_training_error;
-        const Tensor<type, 1> parameters = results.final_parameters;
+        selection_error_history.push_back(optimum_results(i).final_selection_error);
 
-        if(display && trials_number != 1)
-        {
-            cout << "Trial number: " << i << endl;
-            cout << "Training loss: " << training_error << endl;
-            cout << "Selection error: " << selection_error << endl;
-            cout << "Stopping condition: " << write_stopping_condition(results) << endl << endl;
-        }
-
-        if(optimum_selection_error > selection_error)
-        {
-            optimum_selection_error = selection_error;
-            optimum_training_error = training_error;
-            optimum_parameters = parameters;
-        }
-    }
-    if(display)
-    {
-        if(trials_number != 1) cout << "Trial number: " << trials_number << endl;
-        cout << "Training loss: " << optimum_training_error << endl;
-        cout << "Selection error: " << optimum_selection_error << endl;
-        cout << "Stopping condition: " << write_stopping_condition(results) << endl << endl;
+        parameters_history.push_back(optimum_results(i).final_parameters);
     }
 
-//    inputs_history = insert_result(inputs, inputs_history);
-
-    training_error_history = insert_result(optimum_training_error, training_error_history);
-
-    selection_error_history = insert_result(optimum_selection_error, selection_error_history);
-
-    parameters_history = insert_result(optimum_parameters, parameters_history);
-    /*
-        inputs_history.push_back(inputs);
-
-        training_error_history.push_back(optimum_training_error);
-
-        selection_error_history.push_back(optimum_selection_error);
-
-        parameters_history.push_back(optimum_parameters);
-    */
-    optimum_losses[0] = optimum_training_error;
-    optimum_losses[1] = optimum_selection_error;
-
-    return optimum_losses;
-
-//    return Tensor<type, 1>();
+    return optimum_results;
 }
 
 
@@ -724,9 +692,7 @@ string InputsSelection::write_stopping_condition(const OptimizationAlgorithm::Re
 
 void InputsSelection::delete_selection_history()
 {
-    /*
-        selection_error_history.set();
-    */
+    selection_error_history.clear();
 }
 
 
@@ -734,9 +700,7 @@ void InputsSelection::delete_selection_history()
 
 void InputsSelection::delete_loss_history()
 {
-    /*
-        training_error_history.set();
-    */
+    training_error_history.clear();
 }
 
 
@@ -744,9 +708,7 @@ void InputsSelection::delete_loss_history()
 
 void InputsSelection::delete_parameters_history()
 {
-    /*
-        parameters_history.set();
-    */
+    parameters_history.clear();
 }
 
 
@@ -965,6 +927,36 @@ Index InputsSelection::get_input_index(const Tensor<DataSet::VariableUse, 1> use
     return i;
 }
 
+
+/// Returns the index of each input variable among the previous input variables, or -1 if it is a new input variable.
+/// It is used to keep the parameters of the inputs which remain when the inputs of the neural network change.
+/// @param previous_input_variables_indices Indices in the data set of the previous input variables.
+/// @param input_variables_indices Indices in the data set of the new input variables.
+
+Tensor<Index, 1> InputsSelection::get_inputs_indices(const Tensor<Index, 1>& previous_input_variables_indices,
+                                                     const Tensor<Index, 1>& input_variables_indices) const
+{
+    const Index previous_inputs_number = previous_input_variables_indices.size();
+    const Index inputs_number = input_variables_indices.size();
+
+    Tensor<Index, 1> inputs_indices(inputs_number);
+    inputs_indices.setConstant(-1);
+
+    for(Index i = 0; i < inputs_number; i++)
+    {
+        for(Index j = 0; j < previous_inputs_number; j++)
+        {
+            if(previous_input_variables_indices(j) == input_variables_indices(i))
+            {
+                inputs_indices(i) = j;
+                break;
+            }
+        }
+    }
+
+    return inputs_indices;
+}
+
 }
 
 
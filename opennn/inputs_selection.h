@@ -18,10 +18,12 @@
 #include <cmath>
 #include <ctime>
 #include <limits>
+#include <vector>
 
 // OpenNN includes
 
 #include "training_strategy.h"
+#include "training_scheduler.h"
 #include "config.h"
 
 namespace OpenNN
@@ -127,7 +129,10 @@ public:
 
     bool has_training_strategy() const;
 
+    TrainingScheduler* get_training_scheduler_pointer();
+
     const Index& get_trials_number() const;
+    const bool& get_warm_start() const;
 
     const bool& get_reserve_training_error_data() const;
     const bool& get_reserve_selection_error_data() const;
@@ -151,6 +156,7 @@ public:
     void set_default();
 
     void set_trials_number(const Index&);
+    void set_warm_start(const bool&);
 
     void set_reserve_training_error_data(const bool&);
     void set_reserve_selection_error_data(const bool&);
@@ -169,6 +175,8 @@ public:
 
     Tensor<type, 1> calculate_losses(const Tensor<bool, 1>&);
 
+    Tensor<OptimizationAlgorithm::Results, 1> perform_trials(const Tensor<Tensor<DataSet::VariableUse, 1>, 1>&, const Tensor<Tensor<type, 1>, 1>& = Tensor<Tensor<type, 1>, 1>());
+
     Tensor<type, 1> get_parameters_inputs(const Tensor<bool, 1>&) const;
 
     string write_stopping_condition(const OptimizationAlgorithm::Results&) const;
@@ -190,6 +198,8 @@ public:
 
     Index get_input_index(const Tensor<DataSet::VariableUse, 1>, const Index);
 
+    Tensor<Index, 1> get_inputs_indices(const Tensor<Index, 1>&, const Tensor<Index, 1>&) const;
+
     /// Performs the inputs selection for a neural network.
 
     virtual Results* perform_inputs_selection() = 0;
@@ -206,30 +216,34 @@ protected:
 
     TrainingStrategy* training_strategy_pointer = nullptr;
 
-    /// True if this is a function regression problem.
+    /// Scheduler which trains the candidates concurrently on copies of the training strategy.
 
-    bool approximation;
+    TrainingScheduler training_scheduler;
 
-    /// Inputs of all the neural networks trained.
+    /// True if this is a function regression problem.
 
-    Tensor<bool, 2> inputs_history;
+    bool approximation;
 
     /// Selection loss of all the neural networks trained.
 
-    Tensor<type, 1> selection_error_history;
+    vector<type> selection_error_history;
 
     /// Performance of all the neural networks trained.
 
-    Tensor<type, 1> training_error_history;
+    vector<type> training_error_history;
 
     /// Parameters of all the neural network trained.
 
-    Tensor<Tensor<type, 1>, 1> parameters_history;
+    vector<Tensor<type, 1>> parameters_history;
 
     /// Number of trials for each neural network.
 
     Index trials_number;
 
+    /// True if each step of the selection starts training from the parameters of the previous one.
+
+    bool warm_start = false;
+
     // Inputs selection results
 
     /// True if the parameters of all neural networks are to be reserved.
@@ -0,0 +1,152 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   J S O N   L I N E S   T R A I N I N G   O B S E R V E R   C L A S S
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#include "json_lines_training_observer.h"
+
+namespace OpenNN
+{
+
+/// Constructor. It creates the JSON lines file.
+/// @param new_file_name Name of the JSON lines file.
+/// @param new_maximum_queue_size Maximum number of pending events.
+
+JSONLinesTrainingObserver::JSONLinesTrainingObserver(const string& new_file_name, const Index& new_maximum_queue_size)
+    : AsyncTrainingObserver(new_maximum_queue_size)
+{
+    file_name = new_file_name;
+
+    file.open(file_name.c_str());
+
+    if(!file.is_open())
+    {
+        stop();
+
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: JSONLinesTrainingObserver class.\n"
+               << "explicit JSONLinesTrainingObserver(const string&, const Index&) constructor.\n"
+               << "Cannot open JSON lines file: " << file_name << "\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    file.precision(10);
+}
+
+
+/// Destructor. It writes the pending events and closes the file.
+
+JSONLinesTrainingObserver::~JSONLinesTrainingObserver()
+{
+    stop();
+}
+
+
+/// Returns the name of the JSON lines file.
+
+const string& JSONLinesTrainingObserver::get_file_name() const
+{
+    return file_name;
+}
+
+
+/// Writes an event as a JSON object in a line.
+
+void JSONLinesTrainingObserver::write_event(const Event& event)
+{
+    file << "{\"event\": \"" << write_event_type(event.type) << "\"";
+
+    if(event.type == TrainingBegin)
+    {
+        file << ", \"optimization_algorithm\": \"" << write_escaped(event.text) << "\"}" << endl;
+
+        return;
+    }
+
+    const Metrics& metrics = event.metrics;
+
+    file << ", \"epoch\": " << metrics.epoch
+         << ", \"iteration\": " << metrics.iteration
+         << ", \"iterations_number\": " << metrics.iterations_number
+         << ", \"instances_number\": " << metrics.instances_number
+         << ", \"training_loss\": ";
+    write_number(file, metrics.training_loss, "null");
+    file << ", \"training_error\": ";
+    write_number(file, metrics.training_error, "null");
+    file << ", \"selection_error\": ";
+    write_number(file, metrics.selection_error, "null");
+    file << ", \"gradient_norm\": ";
+    write_number(file, metrics.gradient_norm, "null");
+    file << ", \"learning_rate\": ";
+    write_number(file, metrics.learning_rate, "null");
+    file << ", \"instances_per_second\": ";
+    write_number(file, metrics.instances_per_second, "null");
+    file << ", \"time\": ";
+    write_number(file, metrics.time, "null");
+    file << ", \"elapsed_time\": ";
+    write_number(file, metrics.elapsed_time, "null");
+
+    if(event.type == TrainingEnd)
+    {
+        file << ", \"stopping_condition\": \"" << write_escaped(event.text) << "\"";
+    }
+
+    file << "}" << endl;
+}
+
+
+/// Returns a string with the quotes, the backslashes and the control characters escaped for JSON.
+
+string JSONLinesTrainingObserver::write_escaped(const string& text)
+{
+    ostringstream buffer;
+
+    for(size_t i = 0; i < text.size(); i++)
+    {
+        const char character = text[i];
+
+        if(character == '"' || character == '\\')
+        {
+            buffer << '\\' << character;
+        }
+        else if(character == '\n')
+        {
+            buffer << "\\n";
+        }
+        else if(static_cast<unsigned char>(character) < 0x20)
+        {
+            buffer << ' ';
+        }
+        else
+        {
+            buffer << character;
+        }
+    }
+
+    return buffer.str();
+}
+
+}
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
@@ -0,0 +1,88 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   J S O N   L I N E S   T R A I N I N G   O B S E R V E R   C L A S S   H E A D E R
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#ifndef JSONLINESTRAININGOBSERVER_H
+#define JSONLINESTRAININGOBSERVER_H
+
+// System includes
+
+#include <fstream>
+#include <string>
+
+// OpenNN includes
+
+#include "config.h"
+#include "async_training_observer.h"
+
+using namespace std;
+using namespace Eigen;
+
+namespace OpenNN
+{
+
+/// This class writes the training events to a JSON lines file, one JSON object per line.
+
+///
+/// Every object has an "event" member with the type of the event. The beginnings of trainings carry the optimization algorithm,
+/// and the ends carry the stopping condition. NaN values are written as null.
+
+class JSONLinesTrainingObserver : public AsyncTrainingObserver
+{
+
+public:
+
+   // Constructors
+
+   explicit JSONLinesTrainingObserver(const string&, const Index& = 10000);
+
+   // Destructor
+
+   virtual ~JSONLinesTrainingObserver();
+
+   // Get methods
+
+   const string& get_file_name() const;
+
+protected:
+
+   void write_event(const Event&);
+
+private:
+
+   static string write_escaped(const string&);
+
+   /// Name of the JSON lines file.
+
+   string file_name;
+
+   /// Stream of the JSON lines file.
+
+   ofstream file;
+};
+
+}
+
+#endif
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
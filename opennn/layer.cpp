@@ -11,6 +11,142 @@
 namespace OpenNN
 {
 
+namespace
+{
+
+// Activations and their derivatives are calculated in blocks small enough to stay in the L1 cache,
+// so the derivatives are computed from activations that have just been written.
+
+const Index activations_block_size = 1024;
+
+
+/// Applies a block kernel to consecutive blocks of combinations, activations and activations derivatives.
+/// Each kernel call receives maps of the same block of the three tensors, and blocks are run in parallel.
+
+template<class Kernel>
+void calculate_blocks(const TensorMap<Tensor<type, 2>>& combinations,
+                      TensorMap<Tensor<type, 2>>& activations,
+                      TensorMap<Tensor<type, 2>>& activations_derivatives,
+                      const Kernel& kernel)
+{
+    const Index size = combinations.size();
+
+    type* combinations_data = const_cast<type*>(combinations.data());
+    type* activations_data = activations.data();
+    type* activations_derivatives_data = activations_derivatives.data();
+
+    #pragma omp parallel for if(size > activations_block_size)
+
+    for(Index begin = 0; begin < size; begin += activations_block_size)
+    {
+        const Index block_size = min(activations_block_size, size - begin);
+
+        const TensorMap<Tensor<type, 1>> x(combinations_data + begin, block_size);
+        TensorMap<Tensor<type, 1>> y(activations_data + begin, block_size);
+        TensorMap<Tensor<type, 1>> dy(activations_derivatives_data + begin, block_size);
+
+        kernel(x, y, dy);
+    }
+}
+
+#ifdef OPENNN_FAST_ACTIVATIONS
+
+// The fast loops below have no calls nor branches, so they are vectorized by the compiler.
+// With GCC on x86-64 Linux, AVX-512 and AVX2 clones are also built and the best one is chosen at load time.
+
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && defined(__linux__)
+    #define OPENNN_ACTIVATIONS_TARGETS __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+    #define OPENNN_ACTIVATIONS_TARGETS
+#endif
+
+/// Rational approximation of the hyperbolic tangent of x, with absolute error below 3e-8.
+/// The combination is clamped to [-9, 9], where tanh differs from one by less than 3e-8.
+
+inline type fast_tanh(const type& x)
+{
+    const type clamped = x < static_cast<type>(-9) ? static_cast<type>(-9) : (x > static_cast<type>(9) ? static_cast<type>(9) : x);
+
+    const type x2 = clamped*clamped;
+
+    const type p = ((((((static_cast<type>(-2.76076847742355e-16)*x2
+                       + static_cast<type>(2.00018790482477e-13))*x2
+                       + static_cast<type>(-8.60467152213735e-11))*x2
+                       + static_cast<type>(5.12229709037114e-08))*x2
+                       + static_cast<type>(1.48572235717979e-05))*x2
+                       + static_cast<type>(6.37261928875436e-04))*x2
+                       + static_cast<type>(4.89352455891786e-03))*clamped;
+
+    const type q = ((static_cast<type>(1.19825839466702e-06)*x2
+                     + static_cast<type>(1.18534705686654e-04))*x2
+                     + static_cast<type>(2.26843463243900e-03))*x2
+                     + static_cast<type>(4.89352518554385e-03);
+
+    return p/q;
+}
+
+
+OPENNN_ACTIVATIONS_TARGETS
+void fast_hyperbolic_tangent(const type* x, type* y, const Index size)
+{
+    for(Index i = 0; i < size; i++)
+    {
+        y[i] = fast_tanh(x[i]);
+    }
+}
+
+
+OPENNN_ACTIVATIONS_TARGETS
+void fast_hyperbolic_tangent(const type* x, type* y, type* dy, const Index size)
+{
+    for(Index i = 0; i < size; i++)
+    {
+        const type activation = fast_tanh(x[i]);
+
+        y[i] = activation;
+        dy[i] = static_cast<type>(1) - activation*activation;
+    }
+}
+
+
+OPENNN_ACTIVATIONS_TARGETS
+void fast_logistic(const type* x, type* y, const Index size)
+{
+    // logistic(x) = (1 + tanh(x/2))/2
+
+    for(Index i = 0; i < size; i++)
+    {
+        y[i] = static_cast<type>(0.5) + static_cast<type>(0.5)*fast_tanh(static_cast<type>(0.5)*x[i]);
+    }
+}
+
+
+OPENNN_ACTIVATIONS_TARGETS
+void fast_logistic(const type* x, type* y, type* dy, const Index size)
+{
+
+    for(Index i = 0; i < size; i++)
+    {
+        const type activation = static_cast<type>(0.5) + static_cast<type>(0.5)*fast_tanh(static_cast<type>(0.5)*x[i]);
+
+        y[i] = activation;
+        dy[i] = activation*(static_cast<type>(1) - activation);
+    }
+}
+
+#endif
+
+
+/// Returns a map of all the elements of a 2d tensor.
+
+TensorMap<Tensor<type, 2>> map_2d(const Tensor<type, 2>& tensor)
+{
+    return TensorMap<Tensor<type, 2>>(const_cast<type*>(tensor.data()), tensor.dimension(0), tensor.dimension(1));
+}
+
+}
+
+
 /// Default constructor.
 /// It creates a layer object with zero parameters.
 /// It also initializes the rest of class members to their default values.
@@ -57,6 +193,9 @@ string Layer::get_type_string() const
 
     case Unscaling:
         return "Unscaling";
+
+    case LowRankPerceptron:
+        return "LowRankPerceptron";
     }
 
     return string();
@@ -154,6 +293,100 @@ Tensor<type, 2> Layer::calculate_outputs(const Tensor<type, 2> &)
 }
 
 
+/// Calculates the forward propagation of a batch of sparse inputs.
+/// Layers without a sparse implementation convert the inputs to a dense matrix.
+/// @param inputs Inputs to the layer, in compressed sparse row format.
+/// @param forward_propagation Structure where the combinations, activations and activations derivatives are saved.
+
+void Layer::forward_propagate(const CsrMatrix& inputs, ForwardPropagation& forward_propagation) const
+{
+    forward_propagate(to_dense(inputs), forward_propagation);
+}
+
+
+/// Calculates the forward propagation of a batch of sparse inputs with the given parameters.
+/// Layers without a sparse implementation convert the inputs to a dense matrix.
+/// @param inputs Inputs to the layer, in compressed sparse row format.
+/// @param parameters Parameters of the layer, in the same order as get_parameters().
+/// @param forward_propagation Structure where the combinations, activations and activations derivatives are saved.
+
+void Layer::forward_propagate(const CsrMatrix& inputs,
+                              const TensorMap<Tensor<type, 1>>& parameters,
+                              ForwardPropagation& forward_propagation) const
+{
+    forward_propagate(to_dense(inputs), parameters, forward_propagation);
+}
+
+
+/// Calculates the error gradient of the layer for a batch of sparse inputs.
+/// Layers without a sparse implementation convert the inputs to a dense matrix.
+
+void Layer::calculate_error_gradient(const CsrMatrix& inputs,
+                                     const ForwardPropagation& forward_propagation,
+                                     BackPropagation& back_propagation) const
+{
+    calculate_error_gradient(to_dense(inputs), forward_propagation, back_propagation);
+}
+
+
+/// Returns a dense matrix with the values of a sparse matrix.
+
+Tensor<type, 2> Layer::to_dense(const CsrMatrix& sparse_matrix)
+{
+    Tensor<type, 2> dense_matrix(sparse_matrix.rows(), sparse_matrix.cols());
+
+    Eigen::Map<Eigen::Matrix<type, Eigen::Dynamic, Eigen::Dynamic>> dense_map(dense_matrix.data(),
+                                                                             sparse_matrix.rows(),
+                                                                             sparse_matrix.cols());
+
+    dense_map = sparse_matrix;
+
+    return dense_matrix;
+}
+
+
+/// Returns the C definition of a static and aligned array of floats, which is used by the batch expressions.
+/// The values out of the range of the float type are written as the largest float.
+/// @param name Name of the array.
+/// @param data Pointer to the values of the array.
+/// @param size Number of values of the array.
+
+string Layer::write_array_c(const string& name, const type* data, const Index& size) const
+{
+    ostringstream buffer;
+
+    buffer.precision(9);
+
+    buffer << "static const float ALIGNED " << name << "[" << (size > 0 ? size : 1) << "] = {";
+
+    for(Index i = 0; i < size; i++)
+    {
+        if(i%8 == 0) buffer << "\n\t";
+
+        if(data[i] > numeric_limits<float>::max())
+        {
+            buffer << "FLT_MAX";
+        }
+        else if(data[i] < -numeric_limits<float>::max())
+        {
+            buffer << "-FLT_MAX";
+        }
+        else
+        {
+            buffer << static_cast<float>(data[i]);
+        }
+
+        if(i != size-1) buffer << ", ";
+    }
+
+    if(size == 0) buffer << "0";
+
+    buffer << "};\n" << endl;
+
+    return buffer.str();
+}
+
+
 Tensor<Index, 1> Layer::get_input_variables_dimensions() const
 {
     ostringstream buffer;
@@ -166,6 +399,18 @@ Tensor<Index, 1> Layer::get_input_variables_dimensions() const
 }
 
 
+Tensor<Index, 1> Layer::get_outputs_dimensions() const
+{
+    ostringstream buffer;
+
+    buffer << "OpenNN Exception: Layer class.\n"
+           << "get_outputs_dimensions() const method.\n"
+           << "This method is not implemented in the layer type (" << get_type_string() << ").\n";
+
+    throw logic_error(buffer.str());
+}
+
+
 Index Layer::get_inputs_number() const
 {
     ostringstream buffer;
@@ -225,6 +470,26 @@ void Layer::set_neurons_number(const Index &)
 }
 
 
+/// Sets a new number of inputs, given the index of each new input among the previous ones.
+/// By default, the parameters are not kept, and the layer is just resized.
+/// @param inputs_indices Index of each new input among the previous inputs, or -1 for a new input.
+
+void Layer::resize_inputs(const Tensor<Index, 1>& inputs_indices)
+{
+    set_inputs_number(inputs_indices.size());
+}
+
+
+/// Sets a new number of neurons.
+/// By default, the parameters are not kept, and the layer is just resized.
+/// @param new_neurons_number Number of neurons.
+
+void Layer::resize_neurons(const Index& new_neurons_number)
+{
+    set_neurons_number(new_neurons_number);
+}
+
+
 // Activations 1d
 
 void Layer::hard_sigmoid(const Tensor<type, 1>& x, Tensor<type, 1>& y) const
@@ -398,11 +663,19 @@ void Layer::competitive(const Tensor<type, 1>& x, Tensor<type, 1>& y) const
 
 void Layer::softmax(const Tensor<type, 1>& x, Tensor<type, 1>& y) const
 {
+    // Shifting by the maximum keeps the exponentials in range
+
+    Tensor<type, 0> maximum;
+
+    maximum.device(*thread_pool_device) = x.maximum();
+
+    y.device(*thread_pool_device) = (x - maximum(0)).exp();
+
     Tensor<type, 0> sum;
 
-    sum.device(*thread_pool_device) = x.exp().sum();
+    sum.device(*thread_pool_device) = y.sum();
 
-    y.device(*thread_pool_device) = x.exp() / sum(0);
+    y.device(*thread_pool_device) = y / sum(0);
 }
 
 
@@ -690,13 +963,43 @@ void Layer::hard_sigmoid(const Tensor<type, 2>& x, Tensor<type, 2>& y) const
 
 void Layer::hyperbolic_tangent(const Tensor<type, 2>& x, Tensor<type, 2>& y) const
 {
+#ifdef OPENNN_FAST_ACTIVATIONS
+
+    const Index size = x.size();
+
+    #pragma omp parallel for if(size > activations_block_size)
+
+    for(Index begin = 0; begin < size; begin += activations_block_size)
+    {
+        fast_hyperbolic_tangent(x.data() + begin, y.data() + begin, min(activations_block_size, size - begin));
+    }
+
+#else
+
     y.device(*thread_pool_device) = x.tanh();
+
+#endif
 }
 
 
 void Layer::logistic(const Tensor<type, 2>& x, Tensor<type, 2>& y)const
 {
+#ifdef OPENNN_FAST_ACTIVATIONS
+
+    const Index size = x.size();
+
+    #pragma omp parallel for if(size > activations_block_size)
+
+    for(Index begin = 0; begin < size; begin += activations_block_size)
+    {
+        fast_logistic(x.data() + begin, y.data() + begin, min(activations_block_size, size - begin));
+    }
+
+#else
+
     y.device(*thread_pool_device) = (1 + x.exp().inverse()).inverse();
+
+#endif
 }
 
 
@@ -861,300 +1164,372 @@ void Layer::competitive(const Tensor<type, 2>& x, Tensor<type, 2>& y) const
 
 void Layer::softmax(const Tensor<type, 2>& x, Tensor<type, 2>& y) const
 {
+    const Index rows_number = x.dimension(0);
     const Index columns_number = x.dimension(1);
 
-    const Index rows_number = y.dimension(0);
-
-    // Activations
-
-    const Tensor<type, 1> sums = rows_sums(x.exp());
-
-    y.device(*thread_pool_device) = x.exp();
-
-    for(Index i = 0; i < rows_number; i++)
-    {
-        for(Index j = 0; j < columns_number; j++)
-        {
-            y(i, j) = y(i, j) / sums(i);
-        }
-    }
-}
-
+    const Eigen::array<Index, 1> columns_dimension({1});
+    const Eigen::array<Index, 2> column_shape({rows_number, 1});
+    const Eigen::array<Index, 2> columns_broadcast({1, columns_number});
 
-// Activations derivatives 2d
+    // Shifting each row by its maximum keeps the exponentials in range.
+    // The maxima are evaluated first so that x and y can be the same tensor.
 
-void Layer::hard_sigmoid_derivatives(const Tensor<type, 2>& combinations,
-                                     Tensor<type, 2>& activations,
-                                     Tensor<type, 2>& activations_derivatives) const
-{
+    Tensor<type, 1> maxima(rows_number);
 
-    // Conditions
+    maxima.device(*thread_pool_device) = x.maximum(columns_dimension);
 
-    const Tensor<bool, 2> if_sentence = combinations < combinations.constant(-2.5);
-    const Tensor<bool, 2> elif_sentence = combinations > combinations.constant(2.5);
-    const Tensor<bool, 2> if_sentence_2 = combinations < combinations.constant(-2.5) || combinations > combinations.constant(2.5);
+    y.device(*thread_pool_device) = (x - maxima.reshape(column_shape).broadcast(columns_broadcast)).exp();
 
-    // Sentences
+    Tensor<type, 1> sums(rows_number);
 
-    Tensor<type, 2> f1(combinations.dimension(0), combinations.dimension(1));
-    f1.setZero();
+    sums.device(*thread_pool_device) = y.sum(columns_dimension);
 
-    Tensor<type, 2> f2(combinations.dimension(0), combinations.dimension(1));
-    f2.setConstant(1);
+    y.device(*thread_pool_device) = y / sums.reshape(column_shape).broadcast(columns_broadcast);
+}
 
-    Tensor<type, 2> f3(combinations.dimension(0), combinations.dimension(1));
-    f3 = static_cast<type>(0.2) * combinations + static_cast<type>(0.5);
 
-    Tensor<type, 2> f4(combinations.dimension(0), combinations.dimension(1));
-    f4.setConstant(0.0);
 
-    Tensor<type, 2> f5(combinations.dimension(0), combinations.dimension(1));
-    f5.setConstant(static_cast<type>(0.2));
+// Activations derivatives 2d
 
-    // Activations
+void Layer::hard_sigmoid_derivatives(const TensorMap<Tensor<type, 2>>& combinations,
+                                     TensorMap<Tensor<type, 2>>& activations,
+                                     TensorMap<Tensor<type, 2>>& activations_derivatives) const
+{
+    const Index n = combinations.size();
 
-    activations.device(*thread_pool_device) = if_sentence.select(f1, elif_sentence.select(f2, f3));
+    #pragma omp parallel for
 
-    // Activations Derivatives
+    for(Index i = 0; i < n; i++)
+    {
+        const type combination = combinations(i);
 
-    activations_derivatives.device(*thread_pool_device) = if_sentence_2.select(f4, f5);
+        if(combination < static_cast<type>(-2.5))
+        {
+            activations(i) = 0;
+            activations_derivatives(i) = 0;
+        }
+        else if(combination > static_cast<type>(2.5))
+        {
+            activations(i) = 1;
+            activations_derivatives(i) = 0;
+        }
+        else
+        {
+            activations(i) = static_cast<type>(0.2)*combination + static_cast<type>(0.5);
+            activations_derivatives(i) = static_cast<type>(0.2);
+        }
+    }
 }
 
-void Layer::hyperbolic_tangent_derivatives(const Tensor<type, 2>& combinations,
-                                           Tensor<type, 2>& activations,
-                                           Tensor<type, 2>& activations_derivatives) const
+void Layer::hyperbolic_tangent_derivatives(const TensorMap<Tensor<type, 2>>& combinations,
+                                           TensorMap<Tensor<type, 2>>& activations,
+                                           TensorMap<Tensor<type, 2>>& activations_derivatives) const
 {
-    // Activations
-
-    activations.device(*thread_pool_device) = combinations.tanh();
-
-    // Activations Derivatives
+    calculate_blocks(combinations, activations, activations_derivatives,
+                     [](const TensorMap<Tensor<type, 1>>& x, TensorMap<Tensor<type, 1>>& y, TensorMap<Tensor<type, 1>>& dy)
+    {
+#ifdef OPENNN_FAST_ACTIVATIONS
+        fast_hyperbolic_tangent(x.data(), y.data(), dy.data(), x.size());
+#else
+        y = x.tanh();
 
-    activations_derivatives.device(*thread_pool_device) = 1 - activations.square();
+        dy = 1 - y.square();
+#endif
+    });
 }
 
 
-void Layer::logistic_derivatives(const Tensor<type, 2>& combinations,
-                                 Tensor<type, 2>& activations,
-                                 Tensor<type, 2>& activations_derivatives) const
+void Layer::logistic_derivatives(const TensorMap<Tensor<type, 2>>& combinations,
+                                 TensorMap<Tensor<type, 2>>& activations,
+                                 TensorMap<Tensor<type, 2>>& activations_derivatives) const
 {
-    // Activations
-
-    activations.device(*thread_pool_device) = (1 + combinations.exp().inverse()).inverse();
-
-    // Activations Derivatives
+    calculate_blocks(combinations, activations, activations_derivatives,
+                     [](const TensorMap<Tensor<type, 1>>& x, TensorMap<Tensor<type, 1>>& y, TensorMap<Tensor<type, 1>>& dy)
+    {
+#ifdef OPENNN_FAST_ACTIVATIONS
+        fast_logistic(x.data(), y.data(), dy.data(), x.size());
+#else
+        y = (1 + (-x).exp()).inverse();
 
-    activations_derivatives.device(*thread_pool_device) = activations*(1-activations);
+        dy = y*(1 - y);
+#endif
+    });
 }
 
 
-void Layer::linear_derivatives(const Tensor<type, 2>& combinations,
-                               Tensor<type, 2>& activations,
-                               Tensor<type, 2>& activations_derivatives) const
+void Layer::linear_derivatives(const TensorMap<Tensor<type, 2>>& combinations,
+                               TensorMap<Tensor<type, 2>>& activations,
+                               TensorMap<Tensor<type, 2>>& activations_derivatives) const
 {
-    activations = combinations;
+    if(activations.data() != combinations.data())
+    {
+        memcpy(activations.data(), combinations.data(), static_cast<size_t>(combinations.size())*sizeof(type));
+    }
 
     activations_derivatives.setConstant(1.0);
 }
 
 
 
-void Layer::threshold_derivatives(const Tensor<type, 2>& combinations,
-                                  Tensor<type, 2>& activations,
-                                  Tensor<type, 2>& activations_derivatives) const
+void Layer::threshold_derivatives(const TensorMap<Tensor<type, 2>>& combinations,
+                                  TensorMap<Tensor<type, 2>>& activations,
+                                  TensorMap<Tensor<type, 2>>& activations_derivatives) const
 {
+    const Index n = combinations.size();
 
-    const Tensor<bool, 2> if_sentence = combinations > combinations.constant(0);
-
-    Tensor<type, 2> ones(combinations.dimension(0), combinations.dimension(1));
-    ones.setConstant(1);
-
-    Tensor<type, 2> zeros(combinations.dimension(0), combinations.dimension(1));
-    zeros.setConstant(0);
-
-    // Activations
-
-    activations.device(*thread_pool_device) = if_sentence.select(ones, zeros);
+    #pragma omp parallel for
 
-    // Activations Derivatives
+    for(Index i = 0; i < n; i++)
+    {
+        activations(i) = combinations(i) > static_cast<type>(0) ? static_cast<type>(1) : static_cast<type>(0);
+    }
 
     activations_derivatives.setZero();
-
 }
 
 
-void Layer::symmetric_threshold_derivatives(const Tensor<type, 2>& combinations,
-                                            Tensor<type, 2>& activations,
-                                            Tensor<type, 2>& activations_derivatives) const
+void Layer::symmetric_threshold_derivatives(const TensorMap<Tensor<type, 2>>& combinations,
+                                            TensorMap<Tensor<type, 2>>& activations,
+                                            TensorMap<Tensor<type, 2>>& activations_derivatives) const
 {
+    const Index n = combinations.size();
 
-    const Tensor<bool, 2> if_sentence = combinations > combinations.constant(0);
-
-    Tensor<type, 2> ones(combinations.dimension(0), combinations.dimension(1));
-
-    ones.setConstant(1);
-
-    // Activations
-
-    activations.device(*thread_pool_device) = if_sentence.select(ones, -ones);
+    #pragma omp parallel for
 
-    // Activations Derivatives
+    for(Index i = 0; i < n; i++)
+    {
+        activations(i) = combinations(i) > static_cast<type>(0) ? static_cast<type>(1) : static_cast<type>(-1);
+    }
 
     activations_derivatives.setZero();
 }
 
 
-void Layer::rectified_linear_derivatives(const Tensor<type, 2>& combinations,
-                                         Tensor<type, 2>& activations,
-                                         Tensor<type, 2>& activations_derivatives) const
+void Layer::rectified_linear_derivatives(const TensorMap<Tensor<type, 2>>& combinations,
+                                         TensorMap<Tensor<type, 2>>& activations,
+                                         TensorMap<Tensor<type, 2>>& activations_derivatives) const
 {
+    const Index n = combinations.size();
 
-    const Tensor<bool, 2> if_sentence = combinations < combinations.constant(0);
-
-    Tensor<type, 2> zeros(combinations.dimension(0), combinations.dimension(1));
-    zeros.setZero();
-
-    Tensor<type, 2> ones(combinations.dimension(0), combinations.dimension(1));
-    ones.setConstant(1.);
-
-    // Activations
+    #pragma omp parallel for
 
-    activations.device(*thread_pool_device) = if_sentence.select(zeros, combinations);
+    for(Index i = 0; i < n; i++)
+    {
+        const type combination = combinations(i);
 
-    // Activations Derivatives
+        const bool negative = combination < static_cast<type>(0);
 
-    activations_derivatives.device(*thread_pool_device) = if_sentence.select(zeros, ones);
+        activations(i) = negative ? static_cast<type>(0) : combination;
+        activations_derivatives(i) = negative ? static_cast<type>(0) : static_cast<type>(1);
+    }
 }
 
 
-void Layer::scaled_exponential_linear_derivatives(const Tensor<type, 2>& combinations,
-                                                  Tensor<type, 2>& activations,
-                                                  Tensor<type, 2>& activations_derivatives) const
+void Layer::scaled_exponential_linear_derivatives(const TensorMap<Tensor<type, 2>>& combinations,
+                                                  TensorMap<Tensor<type, 2>>& activations,
+                                                  TensorMap<Tensor<type, 2>>& activations_derivatives) const
 {
-
     const type lambda = static_cast<type>(1.0507);
 
     const type alpha = static_cast<type>(1.67326);
 
-    const Tensor<bool, 2> if_sentence = combinations < combinations.constant(0);
+    // For negative combinations the activation is the derivative minus lambda*alpha
 
-    Tensor<type, 2> f_1(combinations.dimension(0), combinations.dimension(1));
+    calculate_blocks(combinations, activations, activations_derivatives,
+                     [&](const TensorMap<Tensor<type, 1>>& x, TensorMap<Tensor<type, 1>>& y, TensorMap<Tensor<type, 1>>& dy)
+    {
+        dy = (x < x.constant(0)).select(lambda*alpha*x.exp(), x.constant(lambda));
 
-    Tensor<type, 2> f_2(combinations.dimension(0), combinations.dimension(1));
+        y = (x < x.constant(0)).select(dy - lambda*alpha, lambda*x);
+    });
+}
 
-    f_1 = lambda*alpha*(combinations.exp()-static_cast<type>(1.0));
 
-    f_2 = lambda*combinations;
+void Layer::soft_plus_derivatives(const TensorMap<Tensor<type, 2>>& combinations,
+                                  TensorMap<Tensor<type, 2>>& activations,
+                                  TensorMap<Tensor<type, 2>>& activations_derivatives) const
+{
+    // The derivative of log(1 + exp(x)) is the logistic function, which equals 1 - exp(-activation)
 
-    // Activations
+    calculate_blocks(combinations, activations, activations_derivatives,
+                     [](const TensorMap<Tensor<type, 1>>& x, TensorMap<Tensor<type, 1>>& y, TensorMap<Tensor<type, 1>>& dy)
+    {
+        y = (1 + x.exp()).log();
 
-    activations.device(*thread_pool_device) = if_sentence.select(f_1, f_2);
+        dy = 1 - (-y).exp();
+    });
+}
 
-    // Activations Derivatives
 
-    f_1 = lambda*alpha*combinations.exp();
+void Layer::soft_sign_derivatives(const TensorMap<Tensor<type, 2>>& combinations,
+                                  TensorMap<Tensor<type, 2>>& activations,
+                                  TensorMap<Tensor<type, 2>>& activations_derivatives) const
+{
+    const Index n = combinations.size();
 
-    f_2 = combinations.constant(1)*lambda;
+    #pragma omp parallel for
 
-    activations_derivatives.device(*thread_pool_device) = if_sentence.select(f_1, f_2);
+    for(Index i = 0; i < n; i++)
+    {
+        const type denominator = static_cast<type>(1) + abs(combinations(i));
 
+        activations(i) = combinations(i)/denominator;
+        activations_derivatives(i) = static_cast<type>(1)/(denominator*denominator);
+    }
 }
 
 
-void Layer::soft_plus_derivatives(const Tensor<type, 2>& combinations,
-                                  Tensor<type, 2>& activations,
-                                  Tensor<type, 2>& activations_derivatives) const
+void Layer::exponential_linear_derivatives(const TensorMap<Tensor<type, 2>>& combinations,
+                                           TensorMap<Tensor<type, 2>>& activations,
+                                           TensorMap<Tensor<type, 2>>& activations_derivatives) const
 {
+    const type alpha = static_cast<type>(1.0);
 
-    // Activations
+    calculate_blocks(combinations, activations, activations_derivatives,
+                     [&](const TensorMap<Tensor<type, 1>>& x, TensorMap<Tensor<type, 1>>& y, TensorMap<Tensor<type, 1>>& dy)
+    {
+        dy = (x < x.constant(0)).select(alpha*x.exp(), x.constant(1));
 
-    activations.device(*thread_pool_device) = (combinations.constant(1) + combinations.exp()).log();
+        y = (x < x.constant(0)).select(dy - alpha, x);
+    });
+}
 
-    // Activations Derivatives
 
-    activations_derivatives.device(*thread_pool_device) = static_cast<type>(1.0) / (static_cast<type>(1.0) + combinations.exp().inverse());
 
+// Activations derivatives 2d of tensors, which are calculated on maps of their elements
+
+void Layer::hard_sigmoid_derivatives(const Tensor<type, 2>& combinations,
+                                     Tensor<type, 2>& activations,
+                                     Tensor<type, 2>& activations_derivatives) const
+{
+    TensorMap<Tensor<type, 2>> activations_map = map_2d(activations);
+    TensorMap<Tensor<type, 2>> activations_derivatives_map = map_2d(activations_derivatives);
+
+    hard_sigmoid_derivatives(map_2d(combinations), activations_map, activations_derivatives_map);
 }
 
 
-void Layer::soft_sign_derivatives(const Tensor<type, 2>& combinations,
-                                  Tensor<type, 2>& activations,
-                                  Tensor<type, 2>& activations_derivatives) const
+void Layer::hyperbolic_tangent_derivatives(const Tensor<type, 2>& combinations,
+                                           Tensor<type, 2>& activations,
+                                           Tensor<type, 2>& activations_derivatives) const
 {
+    TensorMap<Tensor<type, 2>> activations_map = map_2d(activations);
+    TensorMap<Tensor<type, 2>> activations_derivatives_map = map_2d(activations_derivatives);
 
-    const Tensor<bool, 2> if_sentence = combinations < combinations.constant(0);
+    hyperbolic_tangent_derivatives(map_2d(combinations), activations_map, activations_derivatives_map);
+}
 
-    Tensor<type, 2> f_1(combinations.dimension(0), combinations.dimension(1));
 
-    Tensor<type, 2> f_2(combinations.dimension(0), combinations.dimension(1));
+void Layer::logistic_derivatives(const Tensor<type, 2>& combinations,
+                                 Tensor<type, 2>& activations,
+                                 Tensor<type, 2>& activations_derivatives) const
+{
+    TensorMap<Tensor<type, 2>> activations_map = map_2d(activations);
+    TensorMap<Tensor<type, 2>> activations_derivatives_map = map_2d(activations_derivatives);
 
-    f_1 = combinations / (static_cast<type>(1) - combinations);
+    logistic_derivatives(map_2d(combinations), activations_map, activations_derivatives_map);
+}
 
-    f_2 = combinations / (static_cast<type>(1) + combinations);
 
-    // Activations
+void Layer::linear_derivatives(const Tensor<type, 2>& combinations,
+                               Tensor<type, 2>& activations,
+                               Tensor<type, 2>& activations_derivatives) const
+{
+    TensorMap<Tensor<type, 2>> activations_map = map_2d(activations);
+    TensorMap<Tensor<type, 2>> activations_derivatives_map = map_2d(activations_derivatives);
 
-    activations.device(*thread_pool_device) = if_sentence.select(f_1, f_2);
+    linear_derivatives(map_2d(combinations), activations_map, activations_derivatives_map);
+}
 
-    // Activations Derivatives
 
-    f_1 = static_cast<type>(1.0) / (static_cast<type>(1.0) - combinations).pow(2);
+void Layer::threshold_derivatives(const Tensor<type, 2>& combinations,
+                                  Tensor<type, 2>& activations,
+                                  Tensor<type, 2>& activations_derivatives) const
+{
+    TensorMap<Tensor<type, 2>> activations_map = map_2d(activations);
+    TensorMap<Tensor<type, 2>> activations_derivatives_map = map_2d(activations_derivatives);
 
-    f_2 = static_cast<type>(1.0) / (static_cast<type>(1.0) + combinations).pow(2);
+    threshold_derivatives(map_2d(combinations), activations_map, activations_derivatives_map);
+}
 
-    activations_derivatives.device(*thread_pool_device) = if_sentence.select(f_1, f_2);
 
+void Layer::symmetric_threshold_derivatives(const Tensor<type, 2>& combinations,
+                                            Tensor<type, 2>& activations,
+                                            Tensor<type, 2>& activations_derivatives) const
+{
+    TensorMap<Tensor<type, 2>> activations_map = map_2d(activations);
+    TensorMap<Tensor<type, 2>> activations_derivatives_map = map_2d(activations_derivatives);
+
+    symmetric_threshold_derivatives(map_2d(combinations), activations_map, activations_derivatives_map);
 }
 
 
-void Layer::exponential_linear_derivatives(const Tensor<type, 2>& combinations,
-                                           Tensor<type, 2>& activations,
-                                           Tensor<type, 2>& activations_derivatives) const
+void Layer::rectified_linear_derivatives(const Tensor<type, 2>& combinations,
+                                         Tensor<type, 2>& activations,
+                                         Tensor<type, 2>& activations_derivatives) const
 {
+    TensorMap<Tensor<type, 2>> activations_map = map_2d(activations);
+    TensorMap<Tensor<type, 2>> activations_derivatives_map = map_2d(activations_derivatives);
 
-    const type alpha = static_cast<type>(1.0);
+    rectified_linear_derivatives(map_2d(combinations), activations_map, activations_derivatives_map);
+}
 
-    const Tensor<bool, 2> if_sentence = combinations < combinations.constant(0);
 
-    Tensor<type, 2> f_1(combinations.dimension(0), combinations.dimension(1));
+void Layer::scaled_exponential_linear_derivatives(const Tensor<type, 2>& combinations,
+                                                  Tensor<type, 2>& activations,
+                                                  Tensor<type, 2>& activations_derivatives) const
+{
+    TensorMap<Tensor<type, 2>> activations_map = map_2d(activations);
+    TensorMap<Tensor<type, 2>> activations_derivatives_map = map_2d(activations_derivatives);
 
-    Tensor<type, 2> f_2(combinations.dimension(0), combinations.dimension(1));
+    scaled_exponential_linear_derivatives(map_2d(combinations), activations_map, activations_derivatives_map);
+}
 
-    f_1 = alpha*(combinations.exp() - static_cast<type>(1));
 
-    f_2 = combinations;
+void Layer::soft_plus_derivatives(const Tensor<type, 2>& combinations,
+                                  Tensor<type, 2>& activations,
+                                  Tensor<type, 2>& activations_derivatives) const
+{
+    TensorMap<Tensor<type, 2>> activations_map = map_2d(activations);
+    TensorMap<Tensor<type, 2>> activations_derivatives_map = map_2d(activations_derivatives);
 
-    // Activations
+    soft_plus_derivatives(map_2d(combinations), activations_map, activations_derivatives_map);
+}
 
-    activations.device(*thread_pool_device) = if_sentence.select(f_1, f_2);
 
-    // Activations Derivatives
+void Layer::soft_sign_derivatives(const Tensor<type, 2>& combinations,
+                                  Tensor<type, 2>& activations,
+                                  Tensor<type, 2>& activations_derivatives) const
+{
+    TensorMap<Tensor<type, 2>> activations_map = map_2d(activations);
+    TensorMap<Tensor<type, 2>> activations_derivatives_map = map_2d(activations_derivatives);
 
-    f_1 = alpha * combinations.exp();
+    soft_sign_derivatives(map_2d(combinations), activations_map, activations_derivatives_map);
+}
 
-    f_2 = combinations.constant(1.);
 
-    activations_derivatives.device(*thread_pool_device) = if_sentence.select(f_1, f_2);
-}
+void Layer::exponential_linear_derivatives(const Tensor<type, 2>& combinations,
+                                           Tensor<type, 2>& activations,
+                                           Tensor<type, 2>& activations_derivatives) const
+{
+    TensorMap<Tensor<type, 2>> activations_map = map_2d(activations);
+    TensorMap<Tensor<type, 2>> activations_derivatives_map = map_2d(activations_derivatives);
 
+    exponential_linear_derivatives(map_2d(combinations), activations_map, activations_derivatives_map);
+}
 
 
 void Layer::logistic_derivatives(const Tensor<type, 2>& combinations,
                                  Tensor<type, 2>& activations,
                                  Tensor<type, 3>& activations_derivatives) const
 {
-    // Activations
-
-    activations.device(*thread_pool_device) = (1 + combinations.exp().inverse()).inverse();
-
-    // Activations Derivatives
-
-    Tensor<type, 2> derivatives_2d(activations.dimension(0), activations.dimension(1));
+    TensorMap<Tensor<type, 2>> derivatives_2d(activations_derivatives.data(), activations.dimension(0), activations.dimension(1));
 
-    derivatives_2d.device(*thread_pool_device) = activations*(1-activations);
+    Tensor<type, 2> derivatives(activations.dimension(0), activations.dimension(1));
 
-    memcpy(activations_derivatives.data(), derivatives_2d.data(), static_cast<size_t>(derivatives_2d.size())*sizeof(type));
+    logistic_derivatives(combinations, activations, derivatives);
 
+    derivatives_2d = derivatives;
 }
 
 
@@ -1168,17 +1543,7 @@ void Layer::softmax_derivatives(const Tensor<type, 2>& combinations,
 
      //Activations
 
-     Tensor<type, 1> sums = rows_sums(combinations.exp());
-
-     activations.device(*thread_pool_device) = combinations.exp();
-
-     for(Index row = 0; row < rows_number; row++)
-     {
-         for(Index i = 0; i < dim; i++)
-         {
-             activations(row, i) = activations(row, i) / sums(row);
-         }
-     }
+     softmax(combinations, activations);
 
      //Activations derivatives
 
@@ -47,7 +47,7 @@ public:
     /// This enumeration represents the possible types of layers.
 
     enum Type{Scaling, Convolutional, Perceptron, Pooling, Probabilistic,
-              LongShortTermMemory,Recurrent, Unscaling, Bounding, PrincipalComponents};
+              LongShortTermMemory,Recurrent, Unscaling, Bounding, PrincipalComponents, LowRankPerceptron};
 
     /// This structure represents the first order activaions of layers.
 
@@ -79,7 +79,7 @@ public:
 
             activations_2d.resize(batch_instances_number, neurons_number);
 
-            if(layer_pointer->get_type() == Perceptron) // Perceptron
+            if(layer_pointer->get_type() == Perceptron || layer_pointer->get_type() == LowRankPerceptron) // Perceptron
             {
                 activations_derivatives_2d.resize(batch_instances_number, neurons_number);
             }
@@ -93,15 +93,46 @@ public:
             }
             else if(layer_pointer->get_type() == LongShortTermMemory) // LSTM
             {
-                combinations_1d.resize(neurons_number);
+                // Forget, input, state and output activations, cell states and cell states activations
 
-                activations_1d.resize(neurons_number);
+                activations_3d.resize(batch_instances_number, neurons_number, 6);
+
+                // Forget, input, state, output and cell states activations derivatives
 
                 activations_derivatives_3d.resize(batch_instances_number, neurons_number, 5);
             }
+            else if(layer_pointer->get_type() == Convolutional || layer_pointer->get_type() == Pooling)
+            {
+                // Images are kept as (images, channels, rows, columns) and flattened for the next layers
+
+                const Tensor<Index, 1> outputs_dimensions = layer_pointer->get_outputs_dimensions();
+
+                const Eigen::array<Index, 4> dimensions_4d({batch_instances_number,
+                                                            outputs_dimensions(0),
+                                                            outputs_dimensions(1),
+                                                            outputs_dimensions(2)});
+
+                activations_4d.resize(dimensions_4d);
+
+                if(layer_pointer->get_type() == Convolutional)
+                {
+                    combinations_4d.resize(dimensions_4d);
+
+                    activations_derivatives_4d.resize(dimensions_4d);
+
+                    activations_derivatives_2d.resize(batch_instances_number, neurons_number);
+                }
+                else
+                {
+                    maximal_indices.resize(batch_instances_number, neurons_number);
+                }
+            }
             else // Probabilistic
             {
-                activations_derivatives_3d.resize(batch_instances_number, neurons_number, neurons_number);
+                // Softmax deltas are computed from the activations, so the neurons_number x neurons_number
+                // Jacobian of each instance is never stored
+
+                activations_derivatives_2d.resize(batch_instances_number, neurons_number);
             }
         }
 
@@ -114,7 +145,9 @@ public:
             cout << "Activations: " << endl;
             cout << activations_2d << endl;
 
-            if(layer_pointer->get_type() == Perceptron)
+            if(layer_pointer->get_type() == Perceptron
+            || layer_pointer->get_type() == LowRankPerceptron
+            || layer_pointer->get_type() == Probabilistic)
             {
                 cout << "Activations derivatives: " << endl;
                 cout << activations_derivatives_2d << endl;
@@ -137,11 +170,16 @@ public:
         Tensor<type, 2> activations_2d;
         Tensor<type, 2> activations_derivatives_2d;
 
+        Tensor<type, 3> activations_3d;
         Tensor<type, 3> activations_derivatives_3d;
 
         Tensor<type, 4> combinations_4d;
         Tensor<type, 4> activations_4d;
         Tensor<type, 4> activations_derivatives_4d;
+
+        /// Input column of each output of a max pooling layer.
+
+        Tensor<Index, 2> maximal_indices;
     };
 
 
@@ -169,9 +207,56 @@ public:
             const Index neurons_number = layer_pointer->get_neurons_number();
             const Index inputs_number = layer_pointer->get_inputs_number();
 
-            biases_derivatives.resize(neurons_number);
+            if(layer_pointer->get_type() == LongShortTermMemory) // LSTM
+            {
+                // Forget, input, state and output gates side by side
+
+                biases_derivatives.resize(4*neurons_number);
+
+                synaptic_weights_derivatives.resize(inputs_number, 4*neurons_number);
+
+                recurrent_weights_derivatives.resize(neurons_number, 4*neurons_number);
+            }
+            else if(layer_pointer->get_type() == Convolutional)
+            {
+                // One bias and one filter of channels x rows x columns weights per output channel
+
+                const Index synaptic_weights_number = layer_pointer->get_synaptic_weights_number();
+
+                const Index filters_number = layer_pointer->get_parameters_number() - synaptic_weights_number;
+
+                biases_derivatives.resize(filters_number);
+
+                if(filters_number != 0) synaptic_weights_derivatives.resize(filters_number, synaptic_weights_number/filters_number);
+            }
+            else if(layer_pointer->get_type() == LowRankPerceptron)
+            {
+                // Synaptic weights are the product of inputs_number x rank and rank x neurons_number factors
+
+                const Index rank = (layer_pointer->get_parameters_number() - neurons_number)/(inputs_number + neurons_number);
+
+                biases_derivatives.resize(neurons_number);
+
+                input_factors_derivatives.resize(inputs_number, rank);
+
+                output_factors_derivatives.resize(rank, neurons_number);
+            }
+            else if(layer_pointer->get_type() == Pooling)
+            {
+                // No parameters, and the delta is taken with respect to the inputs
+
+                delta.resize(batch_instances_number, inputs_number);
 
-            synaptic_weights_derivatives.resize(inputs_number, neurons_number);
+                return;
+            }
+            else
+            {
+                biases_derivatives.resize(neurons_number);
+
+                synaptic_weights_derivatives.resize(inputs_number, neurons_number);
+
+                if(layer_pointer->get_type() == Recurrent) recurrent_weights_derivatives.resize(neurons_number, neurons_number);
+            }
 
             delta.resize(batch_instances_number, neurons_number);
         }
@@ -187,6 +272,13 @@ public:
         Tensor<type, 1> biases_derivatives;
 
         Tensor<type, 2> synaptic_weights_derivatives;
+
+        Tensor<type, 2> recurrent_weights_derivatives;
+
+        /// Derivatives of the factors of the synaptic weights of low rank perceptron layers.
+
+        Tensor<type, 2> input_factors_derivatives;
+        Tensor<type, 2> output_factors_derivatives;
     };
 
 
@@ -236,10 +328,18 @@ public:
     virtual void calculate_error_gradient(const Tensor<type, 2>&,
                                           const Layer::ForwardPropagation&, Layer::BackPropagation&) const {}
 
+    virtual void calculate_error_gradient(const CsrMatrix&,
+                                          const Layer::ForwardPropagation&, Layer::BackPropagation&) const;
+
     virtual void forward_propagate(const Tensor<type, 2>&, ForwardPropagation&) const {}
     virtual void forward_propagate(const Tensor<type, 4>&, ForwardPropagation&) const {}
 
-    virtual void forward_propagate(const Tensor<type, 2>&, Tensor<type, 1>, ForwardPropagation&) const {}
+    virtual void forward_propagate(const Tensor<type, 2>&, const TensorMap<Tensor<type, 1>>&, ForwardPropagation&) const {}
+
+    virtual void forward_propagate(const CsrMatrix&, ForwardPropagation&) const;
+    virtual void forward_propagate(const CsrMatrix&, const TensorMap<Tensor<type, 1>>&, ForwardPropagation&) const;
+
+    static Tensor<type, 2> to_dense(const CsrMatrix&);
 
     // Deltas
 
@@ -256,6 +356,7 @@ public:
     // Get neurons number
 
     virtual Tensor<Index, 1> get_input_variables_dimensions() const;
+    virtual Tensor<Index, 1> get_outputs_dimensions() const;
 
     virtual Index get_inputs_number() const;
     virtual Index get_neurons_number() const;
@@ -265,6 +366,9 @@ public:
     virtual void set_inputs_number(const Index&);
     virtual void set_neurons_number(const Index&);
 
+    virtual void resize_inputs(const Tensor<Index, 1>&);
+    virtual void resize_neurons(const Index&);
+
     virtual 
 
     // Layer type
@@ -283,6 +387,8 @@ public:
 
     virtual string write_expression_c() const {return string();}
 
+    virtual string write_batch_expression_c() const {return string();}
+
     virtual string write_expression_python() const {return string();}
 
 
@@ -298,6 +404,10 @@ protected:
 
     Type layer_type = Perceptron;
 
+    // Expression methods
+
+    string write_array_c(const string&, const type*, const Index&) const;
+
     // activations 1d (Time Series)
 
     void hard_sigmoid(const Tensor<type,1>&, Tensor<type,1>&) const;
@@ -356,6 +466,18 @@ protected:
     void soft_sign_derivatives(const Tensor<type, 2>&, Tensor<type, 2>&, Tensor<type, 2>&) const;
     void exponential_linear_derivatives(const Tensor<type, 2>&, Tensor<type, 2>&, Tensor<type, 2>&) const;
 
+    void hard_sigmoid_derivatives(const TensorMap<Tensor<type, 2>>&, TensorMap<Tensor<type, 2>>&, TensorMap<Tensor<type, 2>>&) const;
+    void hyperbolic_tangent_derivatives(const TensorMap<Tensor<type, 2>>&, TensorMap<Tensor<type, 2>>&, TensorMap<Tensor<type, 2>>&) const;
+    void logistic_derivatives(const TensorMap<Tensor<type, 2>>&, TensorMap<Tensor<type, 2>>&, TensorMap<Tensor<type, 2>>&) const;
+    void linear_derivatives(const TensorMap<Tensor<type, 2>>&, TensorMap<Tensor<type, 2>>&, TensorMap<Tensor<type, 2>>&) const;
+    void threshold_derivatives(const TensorMap<Tensor<type, 2>>&, TensorMap<Tensor<type, 2>>&, TensorMap<Tensor<type, 2>>&) const;
+    void symmetric_threshold_derivatives(const TensorMap<Tensor<type, 2>>&, TensorMap<Tensor<type, 2>>&, TensorMap<Tensor<type, 2>>&) const;
+    void rectified_linear_derivatives(const TensorMap<Tensor<type, 2>>&, TensorMap<Tensor<type, 2>>&, TensorMap<Tensor<type, 2>>&) const;
+    void scaled_exponential_linear_derivatives(const TensorMap<Tensor<type, 2>>&, TensorMap<Tensor<type, 2>>&, TensorMap<Tensor<type, 2>>&) const;
+    void soft_plus_derivatives(const TensorMap<Tensor<type, 2>>&, TensorMap<Tensor<type, 2>>&, TensorMap<Tensor<type, 2>>&) const;
+    void soft_sign_derivatives(const TensorMap<Tensor<type, 2>>&, TensorMap<Tensor<type, 2>>&, TensorMap<Tensor<type, 2>>&) const;
+    void exponential_linear_derivatives(const TensorMap<Tensor<type, 2>>&, TensorMap<Tensor<type, 2>>&, TensorMap<Tensor<type, 2>>&) const;
+
     void logistic_derivatives(const Tensor<type, 2>&, Tensor<type, 2>&, Tensor<type, 3>&) const;
     void softmax_derivatives(const Tensor<type, 2>&, Tensor<type, 2>&, Tensor<type, 3>&) const;
 
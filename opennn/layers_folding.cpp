@@ -0,0 +1,1018 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   L A Y E R S   F O L D I N G   C L A S S
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#include "layers_folding.h"
+
+namespace OpenNN
+{
+
+/// Default constructor.
+
+LayersFolding::LayersFolding()
+{
+    set();
+}
+
+
+/// Neural network constructor.
+/// @param new_neural_network_pointer Pointer to the neural network to be folded.
+
+LayersFolding::LayersFolding(NeuralNetwork* new_neural_network_pointer)
+{
+    set(new_neural_network_pointer);
+}
+
+
+/// Destructor.
+
+LayersFolding::~LayersFolding()
+{
+}
+
+
+/// Returns a pointer to the neural network to be folded.
+
+NeuralNetwork* LayersFolding::get_neural_network_pointer() const
+{
+#ifdef __OPENNN_DEBUG__
+
+    if(!neural_network_pointer)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: LayersFolding class.\n"
+               << "NeuralNetwork* get_neural_network_pointer() const method.\n"
+               << "Neural network pointer is nullptr.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+#endif
+
+    return neural_network_pointer;
+}
+
+
+/// Returns true if this object has a neural network associated, and false otherwise.
+
+bool LayersFolding::has_neural_network() const
+{
+    return neural_network_pointer != nullptr;
+}
+
+
+/// Returns the absolute value below which the synaptic weights are considered zero
+/// when looking for constant and dead neurons.
+
+const type& LayersFolding::get_pruning_tolerance() const
+{
+    return pruning_tolerance;
+}
+
+
+/// Returns the maximum relative difference allowed between the outputs of the original and the folded neural networks.
+
+const type& LayersFolding::get_verification_tolerance() const
+{
+    return verification_tolerance;
+}
+
+
+/// Returns true if messages from this class are displayed on the screen, or false otherwise.
+
+const bool& LayersFolding::get_display() const
+{
+    return display;
+}
+
+
+/// Sets the neural network pointer to nullptr and the rest of members to their default values.
+
+void LayersFolding::set()
+{
+    neural_network_pointer = nullptr;
+
+    set_default();
+}
+
+
+/// Sets a new neural network to be folded and the rest of members to their default values.
+/// @param new_neural_network_pointer Pointer to a neural network object.
+
+void LayersFolding::set(NeuralNetwork* new_neural_network_pointer)
+{
+    neural_network_pointer = new_neural_network_pointer;
+
+    set_default();
+}
+
+
+/// Sets the members of the folding object to their default values:
+/// <ul>
+/// <li> Pruning tolerance: 0.
+/// <li> Verification tolerance: 1.0e-6.
+/// <li> Display: True.
+/// </ul>
+
+void LayersFolding::set_default()
+{
+    pruning_tolerance = 0;
+
+    verification_tolerance = static_cast<type>(1.0e-6);
+
+    display = true;
+}
+
+
+/// Sets a new neural network to be folded.
+/// @param new_neural_network_pointer Pointer to a neural network object.
+
+void LayersFolding::set_neural_network_pointer(NeuralNetwork* new_neural_network_pointer)
+{
+    neural_network_pointer = new_neural_network_pointer;
+}
+
+
+/// Sets the absolute value below which the synaptic weights are considered zero.
+/// A value greater than zero removes more neurons, but then the folded neural network is no longer exactly equivalent.
+/// @param new_pruning_tolerance Pruning tolerance value.
+
+void LayersFolding::set_pruning_tolerance(const type& new_pruning_tolerance)
+{
+#ifdef __OPENNN_DEBUG__
+
+    if(new_pruning_tolerance < 0)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: LayersFolding class.\n"
+               << "void set_pruning_tolerance(const type&) method.\n"
+               << "Pruning tolerance (" << new_pruning_tolerance << ") must be equal or greater than 0.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+#endif
+
+    pruning_tolerance = new_pruning_tolerance;
+}
+
+
+/// Sets the maximum difference allowed between the outputs of the original and the folded neural networks,
+/// relative to the largest absolute output of the original neural network.
+/// @param new_verification_tolerance Verification tolerance value.
+
+void LayersFolding::set_verification_tolerance(const type& new_verification_tolerance)
+{
+#ifdef __OPENNN_DEBUG__
+
+    if(new_verification_tolerance < 0)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: LayersFolding class.\n"
+               << "void set_verification_tolerance(const type&) method.\n"
+               << "Verification tolerance (" << new_verification_tolerance << ") must be equal or greater than 0.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+#endif
+
+    verification_tolerance = new_verification_tolerance;
+}
+
+
+/// Sets a new display value.
+/// @param new_display True if messages from this class are to be displayed on the screen, false otherwise.
+
+void LayersFolding::set_display(const bool& new_display)
+{
+    display = new_display;
+}
+
+
+/// Builds in the given neural network a copy of the original neural network with the affine layers folded.
+/// The scaling and principal components layers are folded into the first layer,
+/// the unscaling layer is folded into the last layer if it is linear,
+/// consecutive linear layers are fused if that reduces the number of parameters,
+/// and the constant and dead hidden neurons are removed.
+/// The original neural network is not modified.
+/// @param folded_neural_network Neural network which is set to the folded neural network.
+
+void LayersFolding::fold(NeuralNetwork& folded_neural_network) const
+{
+    const NeuralNetwork* original_neural_network_pointer = get_neural_network_pointer();
+
+    const Tensor<Layer*, 1> layers_pointers = original_neural_network_pointer->get_layers_pointers();
+
+    const Index layers_number = layers_pointers.size();
+
+    for(Index i = 0; i < layers_number; i++)
+    {
+        const Layer::Type layer_type = layers_pointers(i)->get_type();
+
+        if(layer_type != Layer::Scaling
+        && layer_type != Layer::PrincipalComponents
+        && layer_type != Layer::Perceptron
+        && layer_type != Layer::Probabilistic
+        && layer_type != Layer::Unscaling
+        && layer_type != Layer::Bounding)
+        {
+            ostringstream buffer;
+
+            buffer << "OpenNN Exception: LayersFolding class.\n"
+                   << "void fold(NeuralNetwork&) const method.\n"
+                   << "Layer " << i << " (" << layers_pointers(i)->get_type_string() << ") cannot be folded.\n";
+
+            throw logic_error(buffer.str());
+        }
+    }
+
+    vector<Layer*> layers(static_cast<size_t>(layers_number));
+
+    for(Index i = 0; i < layers_number; i++)
+    {
+        layers[static_cast<size_t>(i)] = copy_layer(layers_pointers(i));
+    }
+
+    const Tensor<string, 1> inputs_names = original_neural_network_pointer->get_inputs_names();
+    const Tensor<string, 1> outputs_names = original_neural_network_pointer->get_outputs_names();
+
+    // Affine layers
+
+    fold_principal_components_layer(layers);
+
+    fold_scaling_layer(layers);
+
+    fuse_linear_layers(layers);
+
+    // Hidden neurons
+
+    while(fold_constant_neurons(layers) + remove_dead_neurons(layers) > 0)
+    {
+    }
+
+    fold_unscaling_layer(layers);
+
+    // Folded neural network
+
+    const Tensor<Layer*, 1> old_layers_pointers = folded_neural_network.get_layers_pointers();
+
+    for(Index i = 0; i < old_layers_pointers.size(); i++)
+    {
+        delete old_layers_pointers(i);
+    }
+
+    folded_neural_network.set();
+
+    for(size_t i = 0; i < layers.size(); i++)
+    {
+        folded_neural_network.add_layer(layers[i]);
+    }
+
+    folded_neural_network.set_inputs_names(inputs_names);
+    folded_neural_network.set_outputs_names(outputs_names);
+
+    folded_neural_network.set_display(original_neural_network_pointer->get_display());
+}
+
+
+/// Returns the maximum absolute difference between the outputs of the original and the folded neural networks.
+/// @param folded_neural_network Neural network built by the fold method.
+/// @param inputs Inputs to both neural networks.
+
+type LayersFolding::calculate_maximum_outputs_difference(NeuralNetwork& folded_neural_network, const Tensor<type, 2>& inputs) const
+{
+    NeuralNetwork* original_neural_network_pointer = get_neural_network_pointer();
+
+    const Tensor<type, 2> original_outputs = original_neural_network_pointer->calculate_outputs(inputs);
+
+    const Tensor<type, 2> folded_outputs = folded_neural_network.calculate_outputs(inputs);
+
+#ifdef __OPENNN_DEBUG__
+
+    if(original_outputs.dimension(0) != folded_outputs.dimension(0)
+    || original_outputs.dimension(1) != folded_outputs.dimension(1))
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: LayersFolding class.\n"
+               << "type calculate_maximum_outputs_difference(NeuralNetwork&, const Tensor<type, 2>&) const method.\n"
+               << "Dimensions of folded outputs must be equal to dimensions of original outputs.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+#endif
+
+    const Tensor<type, 0> maximum_difference = (folded_outputs - original_outputs).abs().maximum();
+
+    return maximum_difference(0);
+}
+
+
+/// Folds the neural network and verifies that the folded neural network calculates the same outputs.
+/// It throws an exception if the outputs differ by more than the verification tolerance,
+/// relative to the largest absolute output of the original neural network.
+/// @param folded_neural_network Neural network which is set to the folded neural network.
+/// @param inputs Inputs used to compare the original and the folded neural networks.
+
+LayersFolding::FoldingResults LayersFolding::perform_folding(NeuralNetwork& folded_neural_network, const Tensor<type, 2>& inputs) const
+{
+    NeuralNetwork* original_neural_network_pointer = get_neural_network_pointer();
+
+    FoldingResults results;
+
+    results.original_layers_number = original_neural_network_pointer->get_layers_number();
+    results.original_parameters_number = original_neural_network_pointer->get_parameters_number();
+
+    fold(folded_neural_network);
+
+    results.folded_layers_number = folded_neural_network.get_layers_number();
+    results.folded_parameters_number = folded_neural_network.get_parameters_number();
+
+    // Verification
+
+    const Tensor<type, 2> original_outputs = original_neural_network_pointer->calculate_outputs(inputs);
+
+    const Tensor<type, 0> maximum_output = original_outputs.abs().maximum();
+
+    results.maximum_outputs_difference = calculate_maximum_outputs_difference(folded_neural_network, inputs);
+
+    if(display) results.print();
+
+    if(!(results.maximum_outputs_difference <= verification_tolerance*(1 + maximum_output(0))))
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: LayersFolding class.\n"
+               << "FoldingResults perform_folding(NeuralNetwork&, const Tensor<type, 2>&) const method.\n"
+               << "Maximum outputs difference (" << results.maximum_outputs_difference << ") is greater than verification tolerance.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    return results;
+}
+
+
+/// Prints the results of the folding to the screen.
+
+void LayersFolding::FoldingResults::print() const
+{
+    cout << "Original layers number: " << original_layers_number << endl;
+    cout << "Folded layers number: " << folded_layers_number << endl;
+    cout << "Original parameters number: " << original_parameters_number << endl;
+    cout << "Folded parameters number: " << folded_parameters_number << endl;
+    cout << "Maximum outputs difference: " << maximum_outputs_difference << endl;
+}
+
+
+/// Returns a new layer which is a copy of the given layer.
+/// @param layer_pointer Pointer to the layer to be copied.
+
+Layer* LayersFolding::copy_layer(const Layer* layer_pointer) const
+{
+    switch(layer_pointer->get_type())
+    {
+    case Layer::Scaling:
+        return new ScalingLayer(*static_cast<const ScalingLayer*>(layer_pointer));
+
+    case Layer::PrincipalComponents:
+        return new PrincipalComponentsLayer(*static_cast<const PrincipalComponentsLayer*>(layer_pointer));
+
+    case Layer::Perceptron:
+        return new PerceptronLayer(*static_cast<const PerceptronLayer*>(layer_pointer));
+
+    case Layer::Probabilistic:
+        return new ProbabilisticLayer(*static_cast<const ProbabilisticLayer*>(layer_pointer));
+
+    case Layer::Unscaling:
+        return new UnscalingLayer(*static_cast<const UnscalingLayer*>(layer_pointer));
+
+    case Layer::Bounding:
+        return new BoundingLayer(*static_cast<const BoundingLayer*>(layer_pointer));
+
+    default:
+        break;
+    }
+
+    ostringstream buffer;
+
+    buffer << "OpenNN Exception: LayersFolding class.\n"
+           << "Layer* copy_layer(const Layer*) const method.\n"
+           << "Layer type (" << layer_pointer->get_type_string() << ") cannot be copied.\n";
+
+    throw logic_error(buffer.str());
+}
+
+
+/// Returns true if the outputs of the given layer are an activation function of an affine function of its inputs,
+/// that is, if it is a perceptron or a probabilistic layer.
+
+bool LayersFolding::is_affine(const Layer* layer_pointer) const
+{
+    return layer_pointer->get_type() == Layer::Perceptron || layer_pointer->get_type() == Layer::Probabilistic;
+}
+
+
+/// Returns the biases of a perceptron or a probabilistic layer.
+
+Tensor<type, 2> LayersFolding::get_biases(const Layer* layer_pointer) const
+{
+    if(layer_pointer->get_type() == Layer::Perceptron)
+    {
+        return static_cast<const PerceptronLayer*>(layer_pointer)->get_biases();
+    }
+
+    return static_cast<const ProbabilisticLayer*>(layer_pointer)->get_biases();
+}
+
+
+/// Returns the synaptic weights of a perceptron or a probabilistic layer.
+
+Tensor<type, 2> LayersFolding::get_synaptic_weights(const Layer* layer_pointer) const
+{
+    if(layer_pointer->get_type() == Layer::Perceptron)
+    {
+        return static_cast<const PerceptronLayer*>(layer_pointer)->get_synaptic_weights();
+    }
+
+    return static_cast<const ProbabilisticLayer*>(layer_pointer)->get_synaptic_weights();
+}
+
+
+/// Sets new biases to a perceptron or a probabilistic layer.
+
+void LayersFolding::set_biases(Layer* layer_pointer, const Tensor<type, 2>& new_biases) const
+{
+    if(layer_pointer->get_type() == Layer::Perceptron)
+    {
+        static_cast<PerceptronLayer*>(layer_pointer)->set_biases(new_biases);
+    }
+    else
+    {
+        static_cast<ProbabilisticLayer*>(layer_pointer)->set_biases(new_biases);
+    }
+}
+
+
+/// Sets new synaptic weights to a perceptron or a probabilistic layer.
+/// The pruning mask of a pruned perceptron layer is set to the non zero synaptic weights,
+/// so that the folded layer keeps calculating its outputs with the sparse synaptic weights.
+
+void LayersFolding::set_synaptic_weights(Layer* layer_pointer, const Tensor<type, 2>& new_synaptic_weights) const
+{
+    if(layer_pointer->get_type() == Layer::Perceptron)
+    {
+        PerceptronLayer* perceptron_layer_pointer = static_cast<PerceptronLayer*>(layer_pointer);
+
+        const bool is_pruned = perceptron_layer_pointer->is_pruned();
+
+        if(is_pruned) perceptron_layer_pointer->remove_pruning_mask();
+
+        perceptron_layer_pointer->set_synaptic_weights(new_synaptic_weights);
+
+        if(is_pruned)
+        {
+            const Tensor<bool, 2> new_pruning_mask(new_synaptic_weights != new_synaptic_weights.constant(0));
+
+            perceptron_layer_pointer->set_pruning_mask(new_pruning_mask);
+        }
+    }
+    else
+    {
+        static_cast<ProbabilisticLayer*>(layer_pointer)->set_synaptic_weights(new_synaptic_weights);
+    }
+}
+
+
+/// Folds the principal components layer into the next layer, which must be a perceptron or a probabilistic layer.
+/// The principal components are z = (x - means)*P^T, so the folded synaptic weights are P^T*W
+/// and the folded biases are b - means*P^T*W.
+/// Returns true if the principal components layer has been folded.
+/// @param layers Layers of the neural network to be folded.
+
+bool LayersFolding::fold_principal_components_layer(vector<Layer*>& layers) const
+{
+    const size_t layers_number = layers.size();
+
+    for(size_t i = 0; i+1 < layers_number; i++)
+    {
+        if(layers[i]->get_type() != Layer::PrincipalComponents) continue;
+
+        if(!is_affine(layers[i+1])) return false;
+
+        PrincipalComponentsLayer* principal_components_layer_pointer = static_cast<PrincipalComponentsLayer*>(layers[i]);
+
+        if(principal_components_layer_pointer->get_principal_components_method() == PrincipalComponentsLayer::PrincipalComponents)
+        {
+            const Index inputs_number = principal_components_layer_pointer->get_inputs_number();
+            const Index principal_components_number = principal_components_layer_pointer->get_principal_components_number();
+
+            const Eigen::array<Index, 2> offsets = {0, 0};
+            const Eigen::array<Index, 2> extents = {principal_components_number, inputs_number};
+
+            const Tensor<type, 2> principal_components = principal_components_layer_pointer->get_principal_components().slice(offsets, extents);
+
+            const Tensor<type, 1> means = principal_components_layer_pointer->get_means();
+
+            const Tensor<type, 2> synaptic_weights = get_synaptic_weights(layers[i+1]);
+            const Tensor<type, 2> biases = get_biases(layers[i+1]);
+
+            const Eigen::array<IndexPair<Index>, 1> AT_B = {IndexPair<Index>(0, 0)};
+            const Eigen::array<IndexPair<Index>, 1> A_B = {IndexPair<Index>(1, 0)};
+
+            const Tensor<type, 2> folded_synaptic_weights = principal_components.contract(synaptic_weights, AT_B);
+
+            const Tensor<type, 2> means_matrix = means.reshape(Eigen::array<Index, 2>{1, inputs_number});
+
+            const Tensor<type, 2> folded_biases = biases - means_matrix.contract(folded_synaptic_weights, A_B);
+
+            set_synaptic_weights(layers[i+1], folded_synaptic_weights);
+            set_biases(layers[i+1], folded_biases);
+        }
+
+        delete layers[i];
+
+        layers.erase(layers.begin() + static_cast<long>(i));
+
+        return true;
+    }
+
+    return false;
+}
+
+
+/// Folds the scaling layer into the next layer, which must be a perceptron or a probabilistic layer.
+/// Each scaling method is an affine function s*x + c of its input, so the folded synaptic weights are s_j*W(j,:)
+/// and the folded biases are b + sum_j c_j*W(j,:).
+/// The inputs whose minimum and maximum are equal are not scaled.
+/// Returns true if the scaling layer has been folded.
+/// @param layers Layers of the neural network to be folded.
+
+bool LayersFolding::fold_scaling_layer(vector<Layer*>& layers) const
+{
+    const size_t layers_number = layers.size();
+
+    for(size_t i = 0; i+1 < layers_number; i++)
+    {
+        if(layers[i]->get_type() != Layer::Scaling) continue;
+
+        if(!is_affine(layers[i+1])) return false;
+
+        const ScalingLayer* scaling_layer_pointer = static_cast<ScalingLayer*>(layers[i]);
+
+        const Tensor<Descriptives, 1> descriptives = scaling_layer_pointer->get_descriptives();
+        const Tensor<ScalingLayer::ScalingMethod, 1> scaling_methods = scaling_layer_pointer->get_scaling_methods();
+
+        Tensor<type, 2> synaptic_weights = get_synaptic_weights(layers[i+1]);
+        Tensor<type, 2> biases = get_biases(layers[i+1]);
+
+        const Index inputs_number = synaptic_weights.dimension(0);
+
+        for(Index j = 0; j < inputs_number; j++)
+        {
+            type slope = 1;
+            type intercept = 0;
+
+            if(abs(descriptives(j).minimum - descriptives(j).maximum) < numeric_limits<type>::min())
+            {
+                // This input is not scaled
+            }
+            else if(scaling_methods(j) == ScalingLayer::MinimumMaximum)
+            {
+                slope = static_cast<type>(2)/(descriptives(j).maximum-descriptives(j).minimum);
+
+                intercept = -(descriptives(j).maximum + descriptives(j).minimum)/(descriptives(j).maximum - descriptives(j).minimum);
+            }
+            else if(scaling_methods(j) == ScalingLayer::MeanStandardDeviation)
+            {
+                slope = static_cast<type>(2)/descriptives(j).standard_deviation;
+
+                intercept = -static_cast<type>(2)*descriptives(j).mean/descriptives(j).standard_deviation;
+            }
+            else if(scaling_methods(j) == ScalingLayer::StandardDeviation)
+            {
+                slope = static_cast<type>(1)/descriptives(j).standard_deviation;
+            }
+
+            const Tensor<type, 1> input_synaptic_weights = synaptic_weights.chip(j, 0);
+
+            biases.chip(0, 0) += input_synaptic_weights*intercept;
+
+            synaptic_weights.chip(j, 0) = input_synaptic_weights*slope;
+        }
+
+        set_synaptic_weights(layers[i+1], synaptic_weights);
+        set_biases(layers[i+1], biases);
+
+        delete layers[i];
+
+        layers.erase(layers.begin() + static_cast<long>(i));
+
+        return true;
+    }
+
+    return false;
+}
+
+
+/// Folds the unscaling layer into the previous layer, which must be a perceptron layer with linear activation function.
+/// The minimum and maximum and the mean and standard deviation methods are affine functions s*y + c,
+/// so the folded synaptic weights are W(:,k)*s_k and the folded biases are b_k*s_k + c_k.
+/// The logarithmic method is not affine, and then the unscaling layer is kept.
+/// Returns true if the unscaling layer has been folded.
+/// @param layers Layers of the neural network to be folded.
+
+bool LayersFolding::fold_unscaling_layer(vector<Layer*>& layers) const
+{
+    const size_t layers_number = layers.size();
+
+    for(size_t i = 1; i < layers_number; i++)
+    {
+        if(layers[i]->get_type() != Layer::Unscaling) continue;
+
+        if(layers[i-1]->get_type() != Layer::Perceptron
+        || static_cast<PerceptronLayer*>(layers[i-1])->get_activation_function() != PerceptronLayer::Linear)
+        {
+            return false;
+        }
+
+        const UnscalingLayer* unscaling_layer_pointer = static_cast<UnscalingLayer*>(layers[i]);
+
+        const Tensor<Descriptives, 1> descriptives = unscaling_layer_pointer->get_descriptives();
+        const Tensor<UnscalingLayer::UnscalingMethod, 1> unscaling_methods = unscaling_layer_pointer->get_unscaling_method();
+
+        const Index outputs_number = unscaling_methods.size();
+
+        for(Index k = 0; k < outputs_number; k++)
+        {
+            if(unscaling_methods(k) == UnscalingLayer::Logarithmic) return false;
+        }
+
+        Tensor<type, 2> synaptic_weights = get_synaptic_weights(layers[i-1]);
+        Tensor<type, 2> biases = get_biases(layers[i-1]);
+
+        for(Index k = 0; k < outputs_number; k++)
+        {
+            type slope = 1;
+            type intercept = 0;
+
+            if(abs(descriptives(k).minimum - descriptives(k).maximum) < numeric_limits<type>::min())
+            {
+                // This output is not unscaled
+            }
+            else if(unscaling_methods(k) == UnscalingLayer::MinimumMaximum)
+            {
+                slope = (descriptives(k).maximum - descriptives(k).minimum)/static_cast<type>(2);
+
+                intercept = (descriptives(k).minimum + descriptives(k).maximum)/static_cast<type>(2);
+            }
+            else if(unscaling_methods(k) == UnscalingLayer::MeanStandardDeviation)
+            {
+                slope = descriptives(k).standard_deviation/static_cast<type>(2);
+
+                intercept = descriptives(k).mean;
+            }
+
+            synaptic_weights.chip(k, 1) = synaptic_weights.chip(k, 1)*slope;
+
+            biases(0, k) = biases(0, k)*slope + intercept;
+        }
+
+        set_synaptic_weights(layers[i-1], synaptic_weights);
+        set_biases(layers[i-1], biases);
+
+        delete layers[i];
+
+        layers.erase(layers.begin() + static_cast<long>(i));
+
+        return true;
+    }
+
+    return false;
+}
+
+
+/// Fuses each perceptron layer with linear activation function into the next perceptron or probabilistic layer,
+/// if the fused layer has less parameters than both layers.
+/// The fused synaptic weights are W_1*W_2 and the fused biases are b_1*W_2 + b_2.
+/// Returns the number of layers which have been fused.
+/// @param layers Layers of the neural network to be folded.
+
+Index LayersFolding::fuse_linear_layers(vector<Layer*>& layers) const
+{
+    Index fused_layers_number = 0;
+
+    const Eigen::array<IndexPair<Index>, 1> A_B = {IndexPair<Index>(1, 0)};
+
+    size_t i = 0;
+
+    while(i+1 < layers.size())
+    {
+        if(layers[i]->get_type() != Layer::Perceptron
+        || static_cast<PerceptronLayer*>(layers[i])->get_activation_function() != PerceptronLayer::Linear
+        || !is_affine(layers[i+1]))
+        {
+            i++;
+            continue;
+        }
+
+        const Tensor<type, 2> synaptic_weights_1 = get_synaptic_weights(layers[i]);
+        const Tensor<type, 2> biases_1 = get_biases(layers[i]);
+
+        const Tensor<type, 2> synaptic_weights_2 = get_synaptic_weights(layers[i+1]);
+        const Tensor<type, 2> biases_2 = get_biases(layers[i+1]);
+
+        const Index inputs_number = synaptic_weights_1.dimension(0);
+        const Index hidden_neurons_number = synaptic_weights_1.dimension(1);
+        const Index outputs_number = synaptic_weights_2.dimension(1);
+
+        const Index parameters_number = (inputs_number + 1)*hidden_neurons_number + (hidden_neurons_number + 1)*outputs_number;
+        const Index fused_parameters_number = (inputs_number + 1)*outputs_number;
+
+        if(fused_parameters_number >= parameters_number)
+        {
+            i++;
+            continue;
+        }
+
+        const Tensor<type, 2> fused_synaptic_weights = synaptic_weights_1.contract(synaptic_weights_2, A_B);
+        const Tensor<type, 2> fused_biases = biases_1.contract(synaptic_weights_2, A_B) + biases_2;
+
+        set_synaptic_weights(layers[i+1], fused_synaptic_weights);
+        set_biases(layers[i+1], fused_biases);
+
+        delete layers[i];
+
+        layers.erase(layers.begin() + static_cast<long>(i));
+
+        fused_layers_number++;
+    }
+
+    return fused_layers_number;
+}
+
+
+/// Removes the hidden neurons whose synaptic weights are all zero.
+/// The activation of those neurons does not depend on the inputs, so it is added to the biases of the next layer.
+/// At least one neuron is kept in each layer.
+/// Returns the number of neurons which have been removed.
+/// @param layers Layers of the neural network to be folded.
+
+Index LayersFolding::fold_constant_neurons(vector<Layer*>& layers) const
+{
+    Index removed_neurons_number = 0;
+
+    const Eigen::array<Index, 1> rows = {0};
+
+    for(size_t i = 0; i+1 < layers.size(); i++)
+    {
+        if(layers[i]->get_type() != Layer::Perceptron || !is_affine(layers[i+1])) continue;
+
+        PerceptronLayer* perceptron_layer_pointer = static_cast<PerceptronLayer*>(layers[i]);
+
+        const Tensor<type, 2>& synaptic_weights = perceptron_layer_pointer->get_synaptic_weights();
+
+        const Index inputs_number = synaptic_weights.dimension(0);
+        const Index neurons_number = synaptic_weights.dimension(1);
+
+        const Tensor<type, 1> maximum_synaptic_weights = synaptic_weights.abs().maximum(rows);
+
+        vector<Index> kept_neurons;
+        vector<Index> constant_neurons;
+
+        for(Index j = 0; j < neurons_number; j++)
+        {
+            if(inputs_number > 0 && maximum_synaptic_weights(j) > pruning_tolerance)
+            {
+                kept_neurons.push_back(j);
+            }
+            else
+            {
+                constant_neurons.push_back(j);
+            }
+        }
+
+        if(constant_neurons.empty()) continue;
+
+        if(kept_neurons.empty())
+        {
+            kept_neurons.push_back(constant_neurons.back());
+
+            constant_neurons.pop_back();
+
+            if(constant_neurons.empty()) continue;
+        }
+
+        // Constant activations
+
+        Tensor<type, 2> zero_inputs(1, inputs_number);
+        zero_inputs.setZero();
+
+        const Tensor<type, 2> activations = perceptron_layer_pointer->calculate_outputs(zero_inputs);
+
+        const Tensor<type, 2> next_synaptic_weights = get_synaptic_weights(layers[i+1]);
+
+        Tensor<type, 2> next_biases = get_biases(layers[i+1]);
+
+        for(size_t k = 0; k < constant_neurons.size(); k++)
+        {
+            const Index neuron_index = constant_neurons[k];
+
+            next_biases.chip(0, 0) += next_synaptic_weights.chip(neuron_index, 0)*activations(0, neuron_index);
+        }
+
+        set_biases(layers[i+1], next_biases);
+
+        // Remove neurons
+
+        Tensor<Index, 1> neurons_indices(static_cast<Index>(kept_neurons.size()));
+
+        copy(kept_neurons.begin(), kept_neurons.end(), neurons_indices.data());
+
+        perceptron_layer_pointer->select_neurons(neurons_indices);
+
+        layers[i+1]->resize_inputs(neurons_indices);
+
+        removed_neurons_number += static_cast<Index>(constant_neurons.size());
+    }
+
+    return removed_neurons_number;
+}
+
+
+/// Removes the hidden neurons whose outputs are multiplied by zero synaptic weights in the next layer.
+/// The layers are processed from the last to the first one,
+/// so that the neurons which only feed removed neurons are also removed.
+/// At least one neuron is kept in each layer.
+/// Returns the number of neurons which have been removed.
+/// @param layers Layers of the neural network to be folded.
+
+Index LayersFolding::remove_dead_neurons(vector<Layer*>& layers) const
+{
+    Index removed_neurons_number = 0;
+
+    const Eigen::array<Index, 1> columns = {1};
+
+    for(size_t i = layers.size(); i-- > 0;)
+    {
+        if(i+1 >= layers.size() || layers[i]->get_type() != Layer::Perceptron || !is_affine(layers[i+1])) continue;
+
+        PerceptronLayer* perceptron_layer_pointer = static_cast<PerceptronLayer*>(layers[i]);
+
+        const Tensor<type, 2> next_synaptic_weights = get_synaptic_weights(layers[i+1]);
+
+        const Index neurons_number = next_synaptic_weights.dimension(0);
+        const Index next_neurons_number = next_synaptic_weights.dimension(1);
+
+        const Tensor<type, 1> maximum_synaptic_weights = next_synaptic_weights.abs().maximum(columns);
+
+        vector<Index> kept_neurons;
+
+        for(Index j = 0; j < neurons_number; j++)
+        {
+            if(next_neurons_number > 0 && maximum_synaptic_weights(j) > pruning_tolerance)
+            {
+                kept_neurons.push_back(j);
+            }
+        }
+
+        if(kept_neurons.empty() && neurons_number > 0) kept_neurons.push_back(0);
+
+        const Index dead_neurons_number = neurons_number - static_cast<Index>(kept_neurons.size());
+
+        if(dead_neurons_number == 0) continue;
+
+        Tensor<Index, 1> neurons_indices(static_cast<Index>(kept_neurons.size()));
+
+        copy(kept_neurons.begin(), kept_neurons.end(), neurons_indices.data());
+
+        perceptron_layer_pointer->select_neurons(neurons_indices);
+
+        layers[i+1]->resize_inputs(neurons_indices);
+
+        removed_neurons_number += dead_neurons_number;
+    }
+
+    return removed_neurons_number;
+}
+
+
+/// Loads the members of the folding object from a XML document.
+/// @param document TinyXML document with the member data.
+
+void LayersFolding::from_XML(const tinyxml2::XMLDocument& document)
+{
+    const tinyxml2::XMLElement* root_element = document.FirstChildElement("LayersFolding");
+
+    if(!root_element)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: LayersFolding class.\n"
+               << "void from_XML(const tinyxml2::XMLDocument&) method.\n"
+               << "LayersFolding element is nullptr.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    // Pruning tolerance
+
+    const tinyxml2::XMLElement* pruning_tolerance_element = root_element->FirstChildElement("PruningTolerance");
+
+    if(pruning_tolerance_element && pruning_tolerance_element->GetText())
+    {
+        set_pruning_tolerance(static_cast<type>(atof(pruning_tolerance_element->GetText())));
+    }
+
+    // Verification tolerance
+
+    const tinyxml2::XMLElement* verification_tolerance_element = root_element->FirstChildElement("VerificationTolerance");
+
+    if(verification_tolerance_element && verification_tolerance_element->GetText())
+    {
+        set_verification_tolerance(static_cast<type>(atof(verification_tolerance_element->GetText())));
+    }
+
+    // Display
+
+    const tinyxml2::XMLElement* display_element = root_element->FirstChildElement("Display");
+
+    if(display_element && display_element->GetText())
+    {
+        set_display(display_element->GetText() != string("0"));
+    }
+}
+
+
+/// Serializes the folding object into a XML document of the TinyXML library without keep the DOM tree in memory.
+
+void LayersFolding::write_XML(tinyxml2::XMLPrinter& file_stream) const
+{
+    ostringstream buffer;
+
+    file_stream.OpenElement("LayersFolding");
+
+    // Pruning tolerance
+
+    file_stream.OpenElement("PruningTolerance");
+
+    buffer.str("");
+    buffer << pruning_tolerance;
+
+    file_stream.PushText(buffer.str().c_str());
+
+    file_stream.CloseElement();
+
+    // Verification tolerance
+
+    file_stream.OpenElement("VerificationTolerance");
+
+    buffer.str("");
+    buffer << verification_tolerance;
+
+    file_stream.PushText(buffer.str().c_str());
+
+    file_stream.CloseElement();
+
+    // Display
+
+    file_stream.OpenElement("Display");
+
+    buffer.str("");
+    buffer << display;
+
+    file_stream.PushText(buffer.str().c_str());
+
+    file_stream.CloseElement();
+
+    file_stream.CloseElement();
+}
+
+}
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
@@ -0,0 +1,186 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   L A Y E R S   F O L D I N G   C L A S S   H E A D E R
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#ifndef LAYERSFOLDING_H
+#define LAYERSFOLDING_H
+
+// System includes
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <sstream>
+#include <vector>
+
+// OpenNN includes
+
+#include "config.h"
+#include "neural_network.h"
+
+namespace OpenNN
+{
+
+/// This class builds a smaller neural network which calculates the same outputs as a deployed neural network.
+
+///
+/// The scaling and principal components layers are affine, so they are folded into the synaptic weights and biases of the first layer.
+/// The unscaling layer is folded into the last layer when its activation function is linear.
+/// Consecutive linear layers are fused when that reduces the number of parameters.
+/// The hidden neurons with constant activations are folded into the biases of the next layer,
+/// and the hidden neurons whose outputs are not used by the next layer are removed.
+/// The bounding layer is not linear and it is kept.
+
+class LayersFolding
+{
+
+public:
+
+   // Constructors
+
+   explicit LayersFolding();
+
+   explicit LayersFolding(NeuralNetwork*);
+
+   // Destructor
+
+   virtual ~LayersFolding();
+
+   /// This structure contains the size of the neural network before and after the folding,
+   /// and the difference between their outputs.
+
+   struct FoldingResults
+   {
+       /// Number of layers of the original neural network.
+
+       Index original_layers_number = 0;
+
+       /// Number of layers of the folded neural network.
+
+       Index folded_layers_number = 0;
+
+       /// Number of parameters of the original neural network.
+
+       Index original_parameters_number = 0;
+
+       /// Number of parameters of the folded neural network.
+
+       Index folded_parameters_number = 0;
+
+       /// Maximum absolute difference between the outputs of the original and the folded neural networks.
+
+       type maximum_outputs_difference = 0;
+
+       void print() const;
+   };
+
+   // Get methods
+
+   NeuralNetwork* get_neural_network_pointer() const;
+
+   bool has_neural_network() const;
+
+   const type& get_pruning_tolerance() const;
+
+   const type& get_verification_tolerance() const;
+
+   const bool& get_display() const;
+
+   // Set methods
+
+   void set();
+   void set(NeuralNetwork*);
+
+   void set_default();
+
+   void set_neural_network_pointer(NeuralNetwork*);
+
+   void set_pruning_tolerance(const type&);
+
+   void set_verification_tolerance(const type&);
+
+   void set_display(const bool&);
+
+   // Folding methods
+
+   void fold(NeuralNetwork&) const;
+
+   type calculate_maximum_outputs_difference(NeuralNetwork&, const Tensor<type, 2>&) const;
+
+   FoldingResults perform_folding(NeuralNetwork&, const Tensor<type, 2>&) const;
+
+   // Serialization methods
+
+   void from_XML(const tinyxml2::XMLDocument&);
+   void write_XML(tinyxml2::XMLPrinter&) const;
+
+protected:
+
+   Layer* copy_layer(const Layer*) const;
+
+   bool is_affine(const Layer*) const;
+
+   Tensor<type, 2> get_biases(const Layer*) const;
+   Tensor<type, 2> get_synaptic_weights(const Layer*) const;
+
+   void set_biases(Layer*, const Tensor<type, 2>&) const;
+   void set_synaptic_weights(Layer*, const Tensor<type, 2>&) const;
+
+   bool fold_principal_components_layer(vector<Layer*>&) const;
+   bool fold_scaling_layer(vector<Layer*>&) const;
+   bool fold_unscaling_layer(vector<Layer*>&) const;
+
+   Index fuse_linear_layers(vector<Layer*>&) const;
+
+   Index fold_constant_neurons(vector<Layer*>&) const;
+   Index remove_dead_neurons(vector<Layer*>&) const;
+
+   // MEMBERS
+
+   /// Pointer to the neural network to be folded.
+
+   NeuralNetwork* neural_network_pointer = nullptr;
+
+   /// Synaptic weights whose absolute value is not greater than this value are considered zero
+   /// when looking for constant and dead neurons.
+
+   type pruning_tolerance = 0;
+
+   /// Maximum difference between the outputs of the original and the folded neural networks,
+   /// relative to the largest absolute output of the original neural network.
+
+   type verification_tolerance = static_cast<type>(1.0e-6);
+
+   /// Display messages to screen.
+
+   bool display = true;
+};
+
+}
+
+#endif
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
@@ -113,6 +113,9 @@ string LearningRateAlgorithm::write_learning_rate_method() const
 
     case BrentMethod:
         return "BrentMethod";
+
+    case StrongWolfe:
+        return "StrongWolfe";
     }
 
     return string();
@@ -125,6 +128,49 @@ const type& LearningRateAlgorithm::get_learning_rate_tolerance() const
 }
 
 
+/// Returns the sufficient decrease parameter (c1) of the strong Wolfe conditions.
+
+const type& LearningRateAlgorithm::get_sufficient_decrease() const
+{
+    return sufficient_decrease;
+}
+
+
+/// Returns the curvature parameter (c2) of the strong Wolfe conditions.
+
+const type& LearningRateAlgorithm::get_curvature() const
+{
+    return curvature;
+}
+
+
+/// Returns the maximum number of trial points evaluated by the strong Wolfe line search.
+
+const Index& LearningRateAlgorithm::get_maximum_line_search_iterations() const
+{
+    return maximum_line_search_iterations;
+}
+
+
+/// Returns the number of instances used to bracket the minimum.
+/// A value of zero means that the whole batch is used.
+
+const Index& LearningRateAlgorithm::get_bracketing_instances_number() const
+{
+    return bracketing_instances_number;
+}
+
+
+/// Returns true if the learning rate method leaves the loss and the gradient at the accepted point
+/// in the back propagation structure, so that the optimization algorithm does not need to calculate them again,
+/// and false otherwise.
+
+bool LearningRateAlgorithm::evaluates_gradient() const
+{
+    return learning_rate_method == StrongWolfe;
+}
+
+
 /// Returns true if messages from this class can be displayed on the screen, or false if messages from
 /// this class can't be displayed on the screen.
 
@@ -174,6 +220,13 @@ void LearningRateAlgorithm::set_default()
     learning_rate_tolerance = static_cast<type>(1.0e-3);
     loss_tolerance = static_cast<type>(1.0e-3);
 
+    sufficient_decrease = static_cast<type>(1.0e-4);
+    curvature = static_cast<type>(0.9);
+
+    maximum_line_search_iterations = 10;
+
+    bracketing_instances_number = 0;
+
     // UTILITIES
 
     display = true;
@@ -208,7 +261,7 @@ void LearningRateAlgorithm::set_learning_rate_method(
 
 
 /// Sets the method for obtaining the learning rate from a string with the name of the method.
-/// @param new_learning_rate_method Name of learning rate method("Fixed", "GoldenSection", "BrentMethod").
+/// @param new_learning_rate_method Name of learning rate method("GoldenSection", "BrentMethod", "StrongWolfe").
 
 void LearningRateAlgorithm::set_learning_rate_method(const string& new_learning_rate_method)
 {
@@ -220,6 +273,10 @@ void LearningRateAlgorithm::set_learning_rate_method(const string& new_learning_
     {
         learning_rate_method = BrentMethod;
     }
+    else if(new_learning_rate_method == "StrongWolfe")
+    {
+        learning_rate_method = StrongWolfe;
+    }
     else
     {
         ostringstream buffer;
@@ -259,6 +316,73 @@ void LearningRateAlgorithm::set_learning_rate_tolerance(const type& new_learning
 }
 
 
+/// Sets the sufficient decrease parameter (c1) of the strong Wolfe conditions.
+/// @param new_sufficient_decrease Sufficient decrease value, between 0 and the curvature parameter.
+
+void LearningRateAlgorithm::set_sufficient_decrease(const type& new_sufficient_decrease)
+{
+#ifdef __OPENNN_DEBUG__
+
+    if(new_sufficient_decrease <= static_cast<type>(0.0) || new_sufficient_decrease >= curvature)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: LearningRateAlgorithm class.\n"
+               << "void set_sufficient_decrease(const type&) method.\n"
+               << "Sufficient decrease must be between 0 and the curvature parameter.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+#endif
+
+    sufficient_decrease = new_sufficient_decrease;
+}
+
+
+/// Sets the curvature parameter (c2) of the strong Wolfe conditions.
+/// @param new_curvature Curvature value, between the sufficient decrease parameter and 1.
+
+void LearningRateAlgorithm::set_curvature(const type& new_curvature)
+{
+#ifdef __OPENNN_DEBUG__
+
+    if(new_curvature <= sufficient_decrease || new_curvature >= static_cast<type>(1.0))
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: LearningRateAlgorithm class.\n"
+               << "void set_curvature(const type&) method.\n"
+               << "Curvature must be between the sufficient decrease parameter and 1.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+#endif
+
+    curvature = new_curvature;
+}
+
+
+/// Sets the maximum number of trial points evaluated by the strong Wolfe line search.
+/// @param new_maximum_line_search_iterations Maximum number of trial points.
+
+void LearningRateAlgorithm::set_maximum_line_search_iterations(const Index& new_maximum_line_search_iterations)
+{
+    maximum_line_search_iterations = new_maximum_line_search_iterations;
+}
+
+
+/// Sets the number of instances of the batch used to bracket the minimum with the golden section and Brent methods.
+/// The triplet found on that subsample is then evaluated on the whole batch before being reduced.
+/// @param new_bracketing_instances_number Number of bracketing instances (0 to use the whole batch).
+
+void LearningRateAlgorithm::set_bracketing_instances_number(const Index& new_bracketing_instances_number)
+{
+    bracketing_instances_number = new_bracketing_instances_number;
+}
+
+
 /// Sets a new display value.
 /// If it is set to true messages from this class are to be displayed on the screen;
 /// if it is set to false messages from this class are not to be displayed on the screen.
@@ -324,15 +448,74 @@ pair<type,type> LearningRateAlgorithm::calculate_directional_point(
 
     ostringstream buffer;
 
-    const type regularization_weight = loss_index_pointer->get_regularization_weight();
+    if(learning_rate_method == StrongWolfe)
+    {
+        return calculate_Wolfe_directional_point(batch, forward_propagation, back_propagation, optimization_data);
+    }
 
+    const Index batch_instances_number = batch.get_instances_number();
 
     // Bracket minimum
 
-    Triplet triplet = calculate_bracketing_triplet(batch,
-                                                   forward_propagation,
-                                                   back_propagation,
-                                                   optimization_data);
+    Triplet triplet;
+
+    if(bracketing_instances_number > 0 && bracketing_instances_number < batch_instances_number)
+    {
+        // Bracket on a subsample of the batch and evaluate the resulting points on the whole batch
+
+        DataSet::Batch& bracketing_batch = optimization_data.bracketing_batch;
+        NeuralNetwork::ForwardPropagation& bracketing_forward_propagation = optimization_data.bracketing_forward_propagation;
+        LossIndex::BackPropagation& bracketing_back_propagation = optimization_data.bracketing_back_propagation;
+
+        if(bracketing_batch.get_instances_number() != bracketing_instances_number)
+        {
+            bracketing_batch = DataSet::Batch(bracketing_instances_number, batch.data_set_pointer);
+
+            bracketing_forward_propagation = NeuralNetwork::ForwardPropagation(bracketing_instances_number, loss_index_pointer->get_neural_network_pointer());
+
+            bracketing_back_propagation.set(bracketing_instances_number, loss_index_pointer);
+        }
+
+        fill_bracketing_batch(batch, bracketing_batch);
+
+        bracketing_back_propagation.loss = calculate_trial_loss(bracketing_batch,
+                                                                bracketing_forward_propagation,
+                                                                bracketing_back_propagation,
+                                                                optimization_data,
+                                                                0);
+
+        triplet = calculate_bracketing_triplet(bracketing_batch,
+                                               bracketing_forward_propagation,
+                                               bracketing_back_propagation,
+                                               optimization_data);
+
+        triplet.A.second = back_propagation.loss;
+
+        if(triplet.U.first > 0)
+        {
+            triplet.U.second = calculate_trial_loss(batch, forward_propagation, back_propagation, optimization_data, triplet.U.first);
+        }
+        else
+        {
+            triplet.U.second = triplet.A.second;
+        }
+
+        if(triplet.B.first > 0)
+        {
+            triplet.B.second = calculate_trial_loss(batch, forward_propagation, back_propagation, optimization_data, triplet.B.first);
+        }
+        else
+        {
+            triplet.B.second = triplet.A.second;
+        }
+    }
+    else
+    {
+        triplet = calculate_bracketing_triplet(batch,
+                                               forward_propagation,
+                                               back_propagation,
+                                               optimization_data);
+    }
 
     try
     {
@@ -361,6 +544,15 @@ pair<type,type> LearningRateAlgorithm::calculate_directional_point(
                 case GoldenSection: V.first = calculate_golden_section_learning_rate(triplet); break;
 
                 case BrentMethod: V.first = calculate_Brent_method_learning_rate(triplet); break;
+
+                case StrongWolfe:
+                {
+                    buffer << "OpenNN Exception: LearningRateAlgorithm class.\n"
+                           << "pair<type, type> calculate_directional_point() const method.\n"
+                           << "Strong Wolfe method does not reduce a bracketing interval.\n";
+
+                    throw logic_error(buffer.str());
+                }
             }
         }
         catch(const logic_error& error)
@@ -374,16 +566,7 @@ pair<type,type> LearningRateAlgorithm::calculate_directional_point(
 
         // Calculate loss for V
 
-        optimization_data.potential_parameters.device(*thread_pool_device)
-                = optimization_data.parameters + optimization_data.training_direction*V.first;
-
-        neural_network_pointer->forward_propagate(batch, optimization_data.potential_parameters, forward_propagation);
-
-        loss_index_pointer->calculate_error(batch, forward_propagation, back_propagation);
-
-        const type regularization = loss_index_pointer->calculate_regularization(optimization_data.potential_parameters);
-
-        V.second = back_propagation.error + regularization_weight*regularization;
+        V.second = calculate_trial_loss(batch, forward_propagation, back_propagation, optimization_data, V.first);
 
         // Update points
 
@@ -557,8 +740,6 @@ LearningRateAlgorithm::Triplet LearningRateAlgorithm::calculate_bracketing_tripl
 
     const type loss = back_propagation.loss;
 
-    const type regularization_weight = loss_index_pointer->get_regularization_weight();
-
     Triplet triplet;
 
     // Left point
@@ -576,16 +757,7 @@ LearningRateAlgorithm::Triplet LearningRateAlgorithm::calculate_bracketing_tripl
 
         triplet.B.first = optimization_data.initial_learning_rate*count;
 
-        optimization_data.potential_parameters.device(*thread_pool_device)
-                = optimization_data.parameters + optimization_data.training_direction*triplet.B.first;
-
-        neural_network_pointer->forward_propagate(batch, optimization_data.potential_parameters, forward_propagation);
-
-        loss_index_pointer->calculate_error(batch, forward_propagation, back_propagation);
-
-        const type regularization = loss_index_pointer->calculate_regularization(optimization_data.potential_parameters);
-
-        triplet.B.second = back_propagation.error + regularization_weight*regularization;
+        triplet.B.second = calculate_trial_loss(batch, forward_propagation, back_propagation, optimization_data, triplet.B.first);
 
     } while(abs(triplet.A.second - triplet.B.second) < numeric_limits<type>::min());
 
@@ -596,16 +768,7 @@ LearningRateAlgorithm::Triplet LearningRateAlgorithm::calculate_bracketing_tripl
 
         triplet.B.first *= golden_ratio;
 
-        optimization_data.potential_parameters.device(*thread_pool_device)
-                = optimization_data.parameters + optimization_data.training_direction*triplet.B.first;
-
-        neural_network_pointer->forward_propagate(batch, optimization_data.potential_parameters, forward_propagation);
-
-        loss_index_pointer->calculate_error(batch, forward_propagation, back_propagation);
-
-        const type regularization = loss_index_pointer->calculate_regularization(optimization_data.potential_parameters);
-
-        triplet.B.second = back_propagation.error + regularization_weight*regularization;
+        triplet.B.second = calculate_trial_loss(batch, forward_propagation, back_propagation, optimization_data, triplet.B.first);
 
         while(triplet.U.second > triplet.B.second)
         {
@@ -614,30 +777,14 @@ LearningRateAlgorithm::Triplet LearningRateAlgorithm::calculate_bracketing_tripl
 
             triplet.B.first *= golden_ratio;
 
-            optimization_data.potential_parameters.device(*thread_pool_device) = optimization_data.parameters + optimization_data.training_direction*triplet.B.first;
-
-            neural_network_pointer->forward_propagate(batch, optimization_data.potential_parameters, forward_propagation);
-
-            loss_index_pointer->calculate_error(batch, forward_propagation, back_propagation);
-
-            const type regularization = loss_index_pointer->calculate_regularization(optimization_data.potential_parameters);
-
-            triplet.B.second = back_propagation.error + regularization_weight*regularization;
+            triplet.B.second = calculate_trial_loss(batch, forward_propagation, back_propagation, optimization_data, triplet.B.first);
         }
     }
     else if(triplet.A.second < triplet.B.second)
     {
         triplet.U.first = triplet.A.first + (triplet.B.first - triplet.A.first)*static_cast<type>(0.382);
 
-        optimization_data.potential_parameters.device(*thread_pool_device) = optimization_data.parameters + optimization_data.training_direction*triplet.U.first;
-
-        neural_network_pointer->forward_propagate(batch, optimization_data.potential_parameters, forward_propagation);
-
-        loss_index_pointer->calculate_error(batch, forward_propagation, back_propagation);
-
-        const type regularization = loss_index_pointer->calculate_regularization(optimization_data.potential_parameters);
-
-        triplet.U.second = back_propagation.error + regularization_weight*regularization;
+        triplet.U.second = calculate_trial_loss(batch, forward_propagation, back_propagation, optimization_data, triplet.U.first);
 
         while(triplet.A.second < triplet.U.second)
         {
@@ -645,16 +792,7 @@ LearningRateAlgorithm::Triplet LearningRateAlgorithm::calculate_bracketing_tripl
 
             triplet.U.first = triplet.A.first + (triplet.B.first-triplet.A.first)*static_cast<type>(0.382);
 
-            optimization_data.potential_parameters.device(*thread_pool_device)
-                    = optimization_data.parameters + optimization_data.training_direction*triplet.U.first;
-
-            neural_network_pointer->forward_propagate(batch, optimization_data.potential_parameters, forward_propagation);
-
-            loss_index_pointer->calculate_error(batch, forward_propagation, back_propagation);
-
-            const type regularization = loss_index_pointer->calculate_regularization(optimization_data.potential_parameters);
-
-            triplet.U.second = back_propagation.error + regularization_weight*regularization;
+            triplet.U.second = calculate_trial_loss(batch, forward_propagation, back_propagation, optimization_data, triplet.U.first);
 
             if(triplet.U.first - triplet.A.first <= learning_rate_tolerance)
             {
@@ -669,6 +807,277 @@ LearningRateAlgorithm::Triplet LearningRateAlgorithm::calculate_bracketing_tripl
     return triplet;
 }
 
+/// Returns a directional point satisfying the strong Wolfe conditions:
+/// sufficient decrease of the loss and a small enough directional derivative.
+/// Each trial point is evaluated with a full back propagation, so that on exit the back propagation structure
+/// contains the loss, the error and the gradient at the accepted point, and the optimization algorithm can reuse them.
+/// If no point satisfies the conditions within the maximum number of iterations,
+/// the best trial point is returned together with its loss and gradient.
+/// @param batch Batch of the data set.
+/// @param forward_propagation Forward propagation structure of the neural network.
+/// @param back_propagation Back propagation structure at the current parameters.
+/// @param optimization_data Parameters, training direction and initial learning rate.
+
+pair<type,type> LearningRateAlgorithm::calculate_Wolfe_directional_point(
+    const DataSet::Batch& batch,
+    NeuralNetwork::ForwardPropagation& forward_propagation,
+    LossIndex::BackPropagation& back_propagation,
+    OptimizationAlgorithm::OptimizationData& optimization_data) const
+{
+    const type initial_loss = back_propagation.loss;
+
+    Tensor<type, 0> initial_slope;
+
+    initial_slope.device(*thread_pool_device) = (back_propagation.gradient*optimization_data.training_direction).sum();
+
+    // Best trial point
+
+    pair<type, type> best_point(0, initial_loss);
+    type best_error = back_propagation.error;
+    Tensor<type, 1> best_gradient = back_propagation.gradient;
+
+    if(initial_slope(0) >= 0) return best_point;
+
+    // Interval of acceptable learning rates
+
+    pair<type, type> low(0, initial_loss);
+    type low_slope = initial_slope(0);
+
+    pair<type, type> high(0, initial_loss);
+    type high_slope = initial_slope(0);
+
+    bool bracketed = false;
+
+    pair<type, type> trial(optimization_data.initial_learning_rate, 0);
+    type trial_slope = 0;
+
+    for(Index iteration = 0; iteration < maximum_line_search_iterations; iteration++)
+    {
+        trial.second = calculate_trial_loss_slope(batch,
+                                                  forward_propagation,
+                                                  back_propagation,
+                                                  optimization_data,
+                                                  trial.first,
+                                                  trial_slope);
+
+        if(trial.second < best_point.second)
+        {
+            best_point = trial;
+            best_error = back_propagation.error;
+            best_gradient = back_propagation.gradient;
+        }
+
+        const bool sufficient_decrease_condition
+                = trial.second <= initial_loss + sufficient_decrease*trial.first*initial_slope(0);
+
+        const bool curvature_condition = abs(trial_slope) <= -curvature*initial_slope(0);
+
+        if(!sufficient_decrease_condition || (trial.second >= low.second && (bracketed || iteration > 0)))
+        {
+            high = trial;
+            high_slope = trial_slope;
+
+            bracketed = true;
+        }
+        else if(curvature_condition)
+        {
+            return trial;
+        }
+        else if(bracketed)
+        {
+            if(trial_slope*(high.first - low.first) >= 0)
+            {
+                high = low;
+                high_slope = low_slope;
+            }
+
+            low = trial;
+            low_slope = trial_slope;
+        }
+        else if(trial_slope >= 0)
+        {
+            high = low;
+            high_slope = low_slope;
+
+            low = trial;
+            low_slope = trial_slope;
+
+            bracketed = true;
+        }
+        else
+        {
+            // Expand the step until the minimum is bracketed
+
+            low = trial;
+            low_slope = trial_slope;
+
+            trial.first *= golden_ratio;
+
+            continue;
+        }
+
+        if(abs(high.first - low.first) <= learning_rate_tolerance*max(low.first, high.first)) break;
+
+        trial.first = calculate_cubic_learning_rate(low.first, low.second, low_slope,
+                                                    high.first, high.second, high_slope);
+    }
+
+    back_propagation.loss = best_point.second;
+    back_propagation.error = best_error;
+    back_propagation.gradient = best_gradient;
+
+    return best_point;
+}
+
+
+/// Returns the minimizer of the cubic interpolating the losses and directional derivatives at two learning rates.
+/// If the cubic has no minimum close enough to the interior of the interval, the middle point is returned instead.
+
+type LearningRateAlgorithm::calculate_cubic_learning_rate(const type& low_learning_rate,
+                                                          const type& low_loss,
+                                                          const type& low_slope,
+                                                          const type& high_learning_rate,
+                                                          const type& high_loss,
+                                                          const type& high_slope) const
+{
+    const type middle_learning_rate = static_cast<type>(0.5)*(low_learning_rate + high_learning_rate);
+
+    const type length = abs(high_learning_rate - low_learning_rate);
+
+    if(length < numeric_limits<type>::min()) return middle_learning_rate;
+
+    const type d1 = low_slope + high_slope - 3*(low_loss - high_loss)/(low_learning_rate - high_learning_rate);
+
+    const type discriminant = d1*d1 - low_slope*high_slope;
+
+    if(discriminant < 0) return middle_learning_rate;
+
+    const type d2 = (high_learning_rate > low_learning_rate ? 1 : -1)*sqrt(discriminant);
+
+    const type denominator = high_slope - low_slope + 2*d2;
+
+    if(abs(denominator) < numeric_limits<type>::min()) return middle_learning_rate;
+
+    const type learning_rate = high_learning_rate - (high_learning_rate - low_learning_rate)*(high_slope + d2 - d1)/denominator;
+
+    // Safeguard: keep the new point away from the ends of the interval
+
+    const type minimum = min(low_learning_rate, high_learning_rate) + static_cast<type>(0.1)*length;
+    const type maximum = max(low_learning_rate, high_learning_rate) - static_cast<type>(0.1)*length;
+
+    if(!isfinite(learning_rate) || learning_rate < minimum || learning_rate > maximum) return middle_learning_rate;
+
+    return learning_rate;
+}
+
+
+/// Fills a bracketing batch with instances evenly spaced along a batch.
+/// The inputs, the targets and, if the batch has them, the sparse inputs are copied.
+/// @param batch Batch from which the instances are taken.
+/// @param bracketing_batch Batch to be filled, with the number of bracketing instances.
+
+void LearningRateAlgorithm::fill_bracketing_batch(const DataSet::Batch& batch, DataSet::Batch& bracketing_batch) const
+{
+    const Index batch_instances_number = batch.get_instances_number();
+    const Index bracketing_batch_instances_number = bracketing_batch.get_instances_number();
+
+    for(Index i = 0; i < bracketing_batch_instances_number; i++)
+    {
+        const Index instance = (i*batch_instances_number)/bracketing_batch_instances_number;
+
+        bracketing_batch.inputs_2d.chip(i,0) = batch.inputs_2d.chip(instance,0);
+        bracketing_batch.targets_2d.chip(i,0) = batch.targets_2d.chip(instance,0);
+    }
+
+    bracketing_batch.sparse_inputs = batch.sparse_inputs;
+
+    if(!batch.sparse_inputs) return;
+
+    bracketing_batch.inputs_csr.resize(bracketing_batch_instances_number, batch.inputs_csr.cols());
+
+    bracketing_batch.inputs_csr.reserve(bracketing_batch_instances_number);
+
+    for(Index i = 0; i < bracketing_batch_instances_number; i++)
+    {
+        const Index instance = (i*batch_instances_number)/bracketing_batch_instances_number;
+
+        bracketing_batch.inputs_csr.startVec(i);
+
+        for(CsrMatrix::InnerIterator iterator(batch.inputs_csr, instance); iterator; ++iterator)
+        {
+            bracketing_batch.inputs_csr.insertBack(i, iterator.col()) = iterator.value();
+        }
+    }
+
+    bracketing_batch.inputs_csr.finalize();
+}
+
+
+/// Returns the loss of the neural network at the parameters moved along the training direction.
+/// Only the error is calculated, not the gradient.
+/// @param learning_rate Learning rate of the trial point.
+
+type LearningRateAlgorithm::calculate_trial_loss(const DataSet::Batch& batch,
+                                                 NeuralNetwork::ForwardPropagation& forward_propagation,
+                                                 LossIndex::BackPropagation& back_propagation,
+                                                 OptimizationAlgorithm::OptimizationData& optimization_data,
+                                                 const type& learning_rate) const
+{
+    const NeuralNetwork* neural_network_pointer = loss_index_pointer->get_neural_network_pointer();
+
+    const type regularization_weight = loss_index_pointer->get_regularization_weight();
+
+    optimization_data.potential_parameters.device(*thread_pool_device)
+            = optimization_data.parameters + optimization_data.training_direction*learning_rate;
+
+    neural_network_pointer->forward_propagate(batch, optimization_data.potential_parameters, forward_propagation);
+
+    {
+        OPENNN_PROFILE_SCOPE(neural_network_pointer->get_profiler_pointer(), TrainingProfiler::CalculateError);
+
+        loss_index_pointer->calculate_error(batch, forward_propagation, back_propagation);
+    }
+
+    const type regularization = loss_index_pointer->calculate_regularization(optimization_data.potential_parameters);
+
+    return back_propagation.error + regularization_weight*regularization;
+}
+
+
+/// Returns the loss of the neural network at the parameters moved along the training direction,
+/// and calculates the gradient and the directional derivative at that point.
+/// The parameters of the neural network are set to the trial point.
+/// @param learning_rate Learning rate of the trial point.
+/// @param slope Directional derivative of the loss along the training direction.
+
+type LearningRateAlgorithm::calculate_trial_loss_slope(const DataSet::Batch& batch,
+                                                       NeuralNetwork::ForwardPropagation& forward_propagation,
+                                                       LossIndex::BackPropagation& back_propagation,
+                                                       OptimizationAlgorithm::OptimizationData& optimization_data,
+                                                       const type& learning_rate,
+                                                       type& slope) const
+{
+    NeuralNetwork* neural_network_pointer = loss_index_pointer->get_neural_network_pointer();
+
+    optimization_data.potential_parameters.device(*thread_pool_device)
+            = optimization_data.parameters + optimization_data.training_direction*learning_rate;
+
+    neural_network_pointer->set_parameters(optimization_data.potential_parameters);
+
+    neural_network_pointer->forward_propagate(batch, forward_propagation);
+
+    loss_index_pointer->back_propagate(batch, forward_propagation, back_propagation);
+
+    Tensor<type, 0> directional_derivative;
+
+    directional_derivative.device(*thread_pool_device) = (back_propagation.gradient*optimization_data.training_direction).sum();
+
+    slope = directional_derivative(0);
+
+    return back_propagation.loss;
+}
+
+
 /// Calculates the golden section point within a minimum interval defined by three points.
 /// @param triplet Triplet containing a minimum.
 
@@ -843,6 +1252,54 @@ tinyxml2::XMLDocument* LearningRateAlgorithm::to_XML() const
         element->LinkEndChild(text);
     }
 
+    // Sufficient decrease
+    {
+        element = document->NewElement("SufficientDecrease");
+        root_element->LinkEndChild(element);
+
+        buffer.str("");
+        buffer << sufficient_decrease;
+
+        text = document->NewText(buffer.str().c_str());
+        element->LinkEndChild(text);
+    }
+
+    // Curvature
+    {
+        element = document->NewElement("Curvature");
+        root_element->LinkEndChild(element);
+
+        buffer.str("");
+        buffer << curvature;
+
+        text = document->NewText(buffer.str().c_str());
+        element->LinkEndChild(text);
+    }
+
+    // Maximum line search iterations
+    {
+        element = document->NewElement("MaximumLineSearchIterations");
+        root_element->LinkEndChild(element);
+
+        buffer.str("");
+        buffer << maximum_line_search_iterations;
+
+        text = document->NewText(buffer.str().c_str());
+        element->LinkEndChild(text);
+    }
+
+    // Bracketing instances number
+    {
+        element = document->NewElement("BracketingInstancesNumber");
+        root_element->LinkEndChild(element);
+
+        buffer.str("");
+        buffer << bracketing_instances_number;
+
+        text = document->NewText(buffer.str().c_str());
+        element->LinkEndChild(text);
+    }
+
     // Display warnings
 //   {
 //   element = document->NewElement("Display");
@@ -890,6 +1347,50 @@ void LearningRateAlgorithm::write_XML(tinyxml2::XMLPrinter& file_stream) const
 
     file_stream.CloseElement();
 
+    // Sufficient decrease
+
+    file_stream.OpenElement("SufficientDecrease");
+
+    buffer.str("");
+    buffer << sufficient_decrease;
+
+    file_stream.PushText(buffer.str().c_str());
+
+    file_stream.CloseElement();
+
+    // Curvature
+
+    file_stream.OpenElement("Curvature");
+
+    buffer.str("");
+    buffer << curvature;
+
+    file_stream.PushText(buffer.str().c_str());
+
+    file_stream.CloseElement();
+
+    // Maximum line search iterations
+
+    file_stream.OpenElement("MaximumLineSearchIterations");
+
+    buffer.str("");
+    buffer << maximum_line_search_iterations;
+
+    file_stream.PushText(buffer.str().c_str());
+
+    file_stream.CloseElement();
+
+    // Bracketing instances number
+
+    file_stream.OpenElement("BracketingInstancesNumber");
+
+    buffer.str("");
+    buffer << bracketing_instances_number;
+
+    file_stream.PushText(buffer.str().c_str());
+
+    file_stream.CloseElement();
+
     // Learning rate algorithm (end tag)
 
     file_stream.CloseElement();
@@ -953,6 +1454,76 @@ void LearningRateAlgorithm::from_XML(const tinyxml2::XMLDocument& document)
         }
     }
 
+    // Sufficient decrease and curvature, set in the order that keeps the first one below the second one
+    {
+        const tinyxml2::XMLElement* sufficient_decrease_element = root_element->FirstChildElement("SufficientDecrease");
+        const tinyxml2::XMLElement* curvature_element = root_element->FirstChildElement("Curvature");
+
+        const type new_sufficient_decrease = sufficient_decrease_element
+                ? static_cast<type>(atof(sufficient_decrease_element->GetText()))
+                : sufficient_decrease;
+
+        const type new_curvature = curvature_element
+                ? static_cast<type>(atof(curvature_element->GetText()))
+                : curvature;
+
+        try
+        {
+            if(new_sufficient_decrease < curvature)
+            {
+                set_sufficient_decrease(new_sufficient_decrease);
+                set_curvature(new_curvature);
+            }
+            else
+            {
+                set_curvature(new_curvature);
+                set_sufficient_decrease(new_sufficient_decrease);
+            }
+        }
+        catch(const logic_error& e)
+        {
+            cerr << e.what() << endl;
+        }
+    }
+
+    // Maximum line search iterations
+    {
+        const tinyxml2::XMLElement* element = root_element->FirstChildElement("MaximumLineSearchIterations");
+
+        if(element)
+        {
+            const Index new_maximum_line_search_iterations = static_cast<Index>(atoi(element->GetText()));
+
+            try
+            {
+                set_maximum_line_search_iterations(new_maximum_line_search_iterations);
+            }
+            catch(const logic_error& e)
+            {
+                cerr << e.what() << endl;
+            }
+        }
+    }
+
+    // Bracketing instances number
+    {
+        const tinyxml2::XMLElement* element = root_element->FirstChildElement("BracketingInstancesNumber");
+
+        if(element)
+        {
+            const Index new_bracketing_instances_number = static_cast<Index>(atoi(element->GetText()));
+
+            try
+            {
+                set_bracketing_instances_number(new_bracketing_instances_number);
+            }
+            catch(const logic_error& e)
+            {
+                cerr << e.what() << endl;
+            }
+        }
+    }
+
     // Display warnings
     {
         const tinyxml2::XMLElement* element = root_element->FirstChildElement("Display");
@@ -36,7 +36,7 @@ namespace OpenNN
 ///
 /// This class is used by many different optimization algorithms to calculate the learning rate given a training direction.
 ///
-/// It implements the golden section method and the Brent's method.
+/// It implements the golden section method, the Brent's method and a strong Wolfe line search.
 
 class LearningRateAlgorithm
 {
@@ -47,7 +47,7 @@ public:
 
    /// Available training operators for obtaining the perform_training rate.
 
-   enum LearningRateMethod{GoldenSection, BrentMethod};
+   enum LearningRateMethod{GoldenSection, BrentMethod, StrongWolfe};
 
    // Constructors
 
@@ -250,6 +250,15 @@ public:
 
    const type& get_learning_rate_tolerance() const;
 
+   const type& get_sufficient_decrease() const;
+   const type& get_curvature() const;
+
+   const Index& get_maximum_line_search_iterations() const;
+
+   const Index& get_bracketing_instances_number() const;
+
+   bool evaluates_gradient() const;
+
    // Utilities
    
    const bool& get_display() const;
@@ -271,6 +280,13 @@ public:
 
    void set_learning_rate_tolerance(const type&);
 
+   void set_sufficient_decrease(const type&);
+   void set_curvature(const type&);
+
+   void set_maximum_line_search_iterations(const Index&);
+
+   void set_bracketing_instances_number(const Index&);
+
    // Utilities
 
    void set_display(const bool&);
@@ -292,6 +308,11 @@ public:
                                                 LossIndex::BackPropagation&,
                                                 OptimizationAlgorithm::OptimizationData&) const;
 
+   pair<type, type> calculate_Wolfe_directional_point(const DataSet::Batch&,
+                                                      NeuralNetwork::ForwardPropagation&,
+                                                      LossIndex::BackPropagation&,
+                                                      OptimizationAlgorithm::OptimizationData&) const;
+
    // Serialization methods
 
    tinyxml2::XMLDocument* to_XML() const;   
@@ -319,6 +340,22 @@ protected:
 
    type loss_tolerance = static_cast<type>(1.0e-3);
 
+   /// Sufficient decrease (Armijo) parameter of the strong Wolfe conditions.
+
+   type sufficient_decrease = static_cast<type>(1.0e-4);
+
+   /// Curvature parameter of the strong Wolfe conditions.
+
+   type curvature = static_cast<type>(0.9);
+
+   /// Maximum number of trial points evaluated by the strong Wolfe line search.
+
+   Index maximum_line_search_iterations = 10;
+
+   /// Number of instances of the batch used to bracket the minimum (0 means the whole batch).
+
+   Index bracketing_instances_number = 0;
+
    // UTILITIES
 
    /// Display messages to screen.
@@ -329,6 +366,24 @@ protected:
 
    ThreadPoolDevice* thread_pool_device = nullptr;
 
+   type calculate_trial_loss(const DataSet::Batch&,
+                             NeuralNetwork::ForwardPropagation&,
+                             LossIndex::BackPropagation&,
+                             OptimizationAlgorithm::OptimizationData&,
+                             const type&) const;
+
+   type calculate_trial_loss_slope(const DataSet::Batch&,
+                                   NeuralNetwork::ForwardPropagation&,
+                                   LossIndex::BackPropagation&,
+                                   OptimizationAlgorithm::OptimizationData&,
+                                   const type&,
+                                   type&) const;
+
+   void fill_bracketing_batch(const DataSet::Batch&, DataSet::Batch&) const;
+
+   type calculate_cubic_learning_rate(const type&, const type&, const type&,
+                                      const type&, const type&, const type&) const;
+
    bool is_zero(const Tensor<type, 1>& tensor) const
    {
        const Index size = tensor.size();
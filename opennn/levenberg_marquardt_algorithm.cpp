@@ -562,7 +562,7 @@ OptimizationAlgorithm::Results LevenbergMarquardtAlgorithm::perform_training()
 
     Results results;
 
-    results.resize_training_history(maximum_epochs_number);
+    results.resize_training_history(maximum_epochs_number+1);
 
     // Data set
 
@@ -581,8 +581,14 @@ OptimizationAlgorithm::Results LevenbergMarquardtAlgorithm::perform_training()
     DataSet::Batch training_batch(training_instances_number, data_set_pointer);
     DataSet::Batch selection_batch(selection_instances_number, data_set_pointer);
 
-    training_batch.fill(training_instances_indices, inputs_indices, target_indices);
-    selection_batch.fill(selection_instances_indices, inputs_indices, target_indices);
+    start_profile();
+
+    {
+        OPENNN_PROFILE_SCOPE(&profiler, TrainingProfiler::BatchFill);
+
+        training_batch.fill(training_instances_indices, inputs_indices, target_indices);
+        selection_batch.fill(selection_instances_indices, inputs_indices, target_indices);
+    }
 
     training_instances_indices.resize(0);
     selection_instances_indices.resize(0);
@@ -629,10 +635,44 @@ OptimizationAlgorithm::Results LevenbergMarquardtAlgorithm::perform_training()
 
     LMOptimizationData optimization_data(this);
 
+    // Checkpoint
+
+    TrainingCheckpoint checkpoint;
+
+    Index initial_epoch = 0;
+
+    if(start_checkpoints(checkpoint, results))
+    {
+        initial_epoch = checkpoint.get_epoch();
+
+        beginning_time -= static_cast<time_t>(checkpoint.get_elapsed_time());
+
+        optimization_data.parameters = checkpoint.get_vector("parameters");
+
+        set_damping_parameter(checkpoint.get_scalar("damping_parameter"));
+
+        old_training_loss = checkpoint.get_scalar("old_training_loss");
+
+        minimal_selection_parameters = checkpoint.get_vector("minimal_selection_parameters");
+        minimum_selection_error = checkpoint.get_scalar("minimum_selection_error");
+        old_selection_error = checkpoint.get_scalar("old_selection_error");
+        selection_failures = checkpoint.get_index("selection_failures");
+
+        neural_network_pointer->set_parameters(optimization_data.parameters);
+    }
+
+    // Observers
+
+    begin_observers();
+
+    TrainingObserver::Metrics metrics;
+
     // Main loop
 
-    for(Index epoch = 0; epoch <= maximum_epochs_number; epoch++)
+    for(Index epoch = initial_epoch; epoch <= maximum_epochs_number; epoch++)
     {
+        begin_epoch_profile(epoch);
+
         optimization_data.epoch = epoch;
 
         // Neural network
@@ -656,13 +696,21 @@ OptimizationAlgorithm::Results LevenbergMarquardtAlgorithm::perform_training()
 
         // Optimization data
 
-        update_epoch(training_batch,
-                     training_forward_propagation,
-                     training_back_propagation,
-                     terms_second_order_loss,
-                     optimization_data);
+        {
+            OPENNN_PROFILE_SCOPE(&profiler, TrainingProfiler::UpdateIteration);
 
-        neural_network_pointer->set_parameters(optimization_data.parameters);
+            update_epoch(training_batch,
+                         training_forward_propagation,
+                         training_back_propagation,
+                         terms_second_order_loss,
+                         optimization_data);
+        }
+
+        {
+            OPENNN_PROFILE_SCOPE(&profiler, TrainingProfiler::SetParameters);
+
+            neural_network_pointer->set_parameters(optimization_data.parameters);
+        }
 
         if(epoch == 0)
         {
@@ -794,6 +842,29 @@ OptimizationAlgorithm::Results LevenbergMarquardtAlgorithm::perform_training()
             results.stopping_condition = MaximumTime;
         }
 
+        if(!stop_training && check_training_control())
+        {
+            if(display) cout << "Epoch " << epoch+1 << ": Stop requested.\n";
+
+            stop_training = true;
+
+            results.stopping_condition = StopRequested;
+        }
+
+        if(has_observers())
+        {
+            metrics.epoch = epoch;
+            metrics.iteration = 0;
+            metrics.iterations_number = epoch + 1;
+            metrics.instances_number = training_instances_number;
+            metrics.training_loss = terms_second_order_loss.loss;
+            metrics.training_error = terms_second_order_loss.error;
+            metrics.selection_error = has_selection ? selection_back_propagation.error : numeric_limits<type>::quiet_NaN();
+            metrics.gradient_norm = gradient_norm;
+
+            notify_epoch(metrics);
+        }
+
         if(epoch != 0 && epoch % save_period == 0)
         {
             neural_network_pointer->save(neural_network_file_name);
@@ -851,8 +922,30 @@ OptimizationAlgorithm::Results LevenbergMarquardtAlgorithm::perform_training()
 
         old_training_loss = terms_second_order_loss.loss;
         old_selection_error = selection_back_propagation.error;
+
+        if(is_checkpoint_epoch(epoch+1))
+        {
+            checkpoint.set_vector("parameters", optimization_data.parameters);
+
+            checkpoint.set_scalar("damping_parameter", damping_parameter);
+
+            checkpoint.set_scalar("old_training_loss", old_training_loss);
+
+            checkpoint.set_vector("minimal_selection_parameters", minimal_selection_parameters);
+            checkpoint.set_scalar("minimum_selection_error", minimum_selection_error);
+            checkpoint.set_scalar("old_selection_error", old_selection_error);
+            checkpoint.set_index("selection_failures", selection_failures);
+
+            write_checkpoint(checkpoint, results, epoch+1, elapsed_time);
+        }
     }
 
+    wait_checkpoint();
+
+    finish_profile(results);
+
+    end_observers(results);
+
     if(choose_best_selection)
     {
 //        parameters = minimal_selection_parameters;
@@ -893,6 +986,8 @@ void LevenbergMarquardtAlgorithm::update_epoch(const DataSet::Batch& batch,
 
          optimization_data.parameters_increment = perform_Householder_QR_decomposition(terms_second_order_loss.hessian,(-1)*terms_second_order_loss.gradient);
 
+         neural_network_pointer->mask_pruned_parameters(optimization_data.parameters_increment);
+
          optimization_data.potential_parameters.device(*thread_pool_device) = optimization_data.parameters + optimization_data.parameters_increment;
 
          neural_network_pointer->forward_propagate(batch, optimization_data.potential_parameters, forward_propagation);
@@ -1245,7 +1340,7 @@ void LevenbergMarquardtAlgorithm::write_XML(tinyxml2::XMLPrinter& file_stream) c
 {
     ostringstream buffer;
 
-    file_stream.OpenElement("LevenbergMarquardt");
+    file_stream.OpenElement("LevenbergMarquardtAlgorithm");
 
     // Damping paramterer factor.
 
@@ -1369,6 +1464,10 @@ void LevenbergMarquardtAlgorithm::write_XML(tinyxml2::XMLPrinter& file_stream) c
 
     file_stream.CloseElement();
 
+    // Checkpoints
+
+    write_checkpoints_XML(file_stream);
+
     file_stream.CloseElement();
 }
 
@@ -1597,6 +1696,10 @@ void LevenbergMarquardtAlgorithm::from_XML(const tinyxml2::XMLDocument& document
             cerr << e.what() << endl;
         }
     }
+
+    // Checkpoints
+
+    checkpoints_from_XML(root_element);
 }
 
 
@@ -668,8 +668,9 @@ void LongShortTermMemoryLayer::set_output_recurrent_weights(const Tensor<type, 2
 
 /// Sets the parameters of this layer.
 /// @param new_parameters Parameters vector for that layer.
+/// @param index Position of the first parameter of this layer in that vector.
 
-void LongShortTermMemoryLayer::set_parameters(const Tensor<type, 1>& new_parameters)
+void LongShortTermMemoryLayer::set_parameters(const Tensor<type, 1>& new_parameters, const Index& index)
 {
     const Index neurons_number = get_neurons_number();
     const Index inputs_number = get_inputs_number();
@@ -680,33 +681,48 @@ void LongShortTermMemoryLayer::set_parameters(const Tensor<type, 1>& new_paramet
 
     const Index new_parameters_size = new_parameters.size();
 
-    if(new_parameters_size != parameters_number)
+    if(new_parameters_size < index + parameters_number)
     {
         ostringstream buffer;
 
         buffer << "OpenNN Exception: LongShortTermMemoryLayer class.\n"
-               << "void set_parameters(const Tensor<type, 1>&) method.\n"
-               << "Size of new parameters (" << new_parameters_size << ") must be equal to number of parameters (" << parameters_number << ").\n";
+               << "void set_parameters(const Tensor<type, 1>&, const Index&) method.\n"
+               << "Size of new parameters (" << new_parameters_size << ") must be at least index plus number of parameters (" << index + parameters_number << ").\n";
 
         throw logic_error(buffer.str());
     }
 
 #endif
 
-       set_forget_weights(new_parameters.slice(Eigen::array<Eigen::Index, 1>({0}), Eigen::array<Eigen::Index, 1>({inputs_number * neurons_number})).reshape(Eigen::array<Index, 2>({inputs_number, neurons_number})));
-       set_input_weights(new_parameters.slice(Eigen::array<Eigen::Index, 1>({inputs_number * neurons_number}), Eigen::array<Eigen::Index, 1>({inputs_number * neurons_number})).reshape(Eigen::array<Index, 2>({inputs_number, neurons_number})));
-       set_state_weights(new_parameters.slice(Eigen::array<Eigen::Index, 1>({2*inputs_number * neurons_number}), Eigen::array<Eigen::Index, 1>({inputs_number * neurons_number})).reshape(Eigen::array<Index, 2>({inputs_number, neurons_number})));
-       set_input_weights(new_parameters.slice(Eigen::array<Eigen::Index, 1>({3*inputs_number * neurons_number}), Eigen::array<Eigen::Index, 1>({inputs_number * neurons_number})).reshape(Eigen::array<Index, 2>({inputs_number, neurons_number})));
+    // Forget, input, state and output gates side by side
 
-       set_forget_recurrent_weights(new_parameters.slice(Eigen::array<Eigen::Index, 1>({4*inputs_number * neurons_number}), Eigen::array<Eigen::Index, 1>({neurons_number*neurons_number})).reshape(Eigen::array<Index, 2>({neurons_number, neurons_number})));
-       set_input_recurrent_weights(new_parameters.slice(Eigen::array<Eigen::Index, 1>({4 * inputs_number * neurons_number + neurons_number * neurons_number}), Eigen::array<Eigen::Index, 1>({neurons_number*neurons_number})).reshape(Eigen::array<Index, 2>({neurons_number, neurons_number})));
-       set_state_recurrent_weights(new_parameters.slice(Eigen::array<Eigen::Index, 1>({4 * inputs_number * neurons_number + 2 * neurons_number * neurons_number}), Eigen::array<Eigen::Index, 1>({neurons_number*neurons_number})).reshape(Eigen::array<Index, 2>({neurons_number, neurons_number})));
-       set_output_recurrent_weights(new_parameters.slice(Eigen::array<Eigen::Index, 1>({4 * inputs_number * neurons_number + 3 * neurons_number * neurons_number}), Eigen::array<Eigen::Index, 1>({neurons_number*neurons_number})).reshape(Eigen::array<Index, 2>({neurons_number, neurons_number})));
+    const TensorMap<Tensor<type, 2>> weights(const_cast<type*>(new_parameters.data()) + index,
+                                             inputs_number, 4*neurons_number);
 
-       set_forget_biases(new_parameters.slice(Eigen::array<Eigen::Index, 1>({4 * neurons_number * (inputs_number + neurons_number)}), Eigen::array<Eigen::Index, 1>({neurons_number})));
-       set_input_biases(new_parameters.slice(Eigen::array<Eigen::Index, 1>({4 * neurons_number * (inputs_number + neurons_number) + neurons_number}), Eigen::array<Eigen::Index, 1>({neurons_number})));
-       set_state_biases(new_parameters.slice(Eigen::array<Eigen::Index, 1>({4 * neurons_number * (inputs_number + neurons_number) + 2 * neurons_number}), Eigen::array<Eigen::Index, 1>({neurons_number})));
-       set_output_biases(new_parameters.slice(Eigen::array<Eigen::Index, 1>({4 * neurons_number * (inputs_number + neurons_number) + 3 * neurons_number}), Eigen::array<Eigen::Index, 1>({neurons_number})));
+    const TensorMap<Tensor<type, 2>> recurrent_weights(const_cast<type*>(new_parameters.data()) + index + 4*inputs_number*neurons_number,
+                                                       neurons_number, 4*neurons_number);
+
+    const TensorMap<Tensor<type, 1>> biases(const_cast<type*>(new_parameters.data()) + index + 4*neurons_number*(inputs_number + neurons_number),
+                                            4*neurons_number);
+
+    const Eigen::array<Index, 2> weights_extents({inputs_number, neurons_number});
+    const Eigen::array<Index, 2> recurrent_weights_extents({neurons_number, neurons_number});
+    const Eigen::array<Index, 1> biases_extents({neurons_number});
+
+    set_forget_weights(weights.slice(Eigen::array<Index, 2>({0, 0}), weights_extents));
+    set_input_weights(weights.slice(Eigen::array<Index, 2>({0, neurons_number}), weights_extents));
+    set_state_weights(weights.slice(Eigen::array<Index, 2>({0, 2*neurons_number}), weights_extents));
+    set_output_weights(weights.slice(Eigen::array<Index, 2>({0, 3*neurons_number}), weights_extents));
+
+    set_forget_recurrent_weights(recurrent_weights.slice(Eigen::array<Index, 2>({0, 0}), recurrent_weights_extents));
+    set_input_recurrent_weights(recurrent_weights.slice(Eigen::array<Index, 2>({0, neurons_number}), recurrent_weights_extents));
+    set_state_recurrent_weights(recurrent_weights.slice(Eigen::array<Index, 2>({0, 2*neurons_number}), recurrent_weights_extents));
+    set_output_recurrent_weights(recurrent_weights.slice(Eigen::array<Index, 2>({0, 3*neurons_number}), recurrent_weights_extents));
+
+    set_forget_biases(biases.slice(Eigen::array<Index, 1>({0}), biases_extents));
+    set_input_biases(biases.slice(Eigen::array<Index, 1>({neurons_number}), biases_extents));
+    set_state_biases(biases.slice(Eigen::array<Index, 1>({2*neurons_number}), biases_extents));
+    set_output_biases(biases.slice(Eigen::array<Index, 1>({3*neurons_number}), biases_extents));
 }
 
 
@@ -1219,81 +1235,6 @@ void LongShortTermMemoryLayer::calculate_output_combinations(const Tensor<type,
 }
 
 
-Tensor<type, 3> LongShortTermMemoryLayer::calculate_activations_states(const Tensor<type, 2>& inputs)
-{  
-    const Index instances_number = inputs.dimension(0);
-    const Index neurons_number = get_neurons_number();
-
-    // forget activations_2d, input activations_2d, state activations_2d, output activations_2d, state, hidden state
-
-    Tensor<type, 3> activations_states(instances_number, neurons_number,6);
-
-    Index forget_activations_index = 0;
-    Index input_activations_index = instances_number*neurons_number;
-    Index state_activations_index = 2*instances_number*neurons_number;
-    Index output_activations_index = 3*instances_number*neurons_number;
-    Index states_index = 4*instances_number*neurons_number;
-    Index hidden_states_index = 5*instances_number*neurons_number;
-
-    Tensor<type, 1> forget_combinations(neurons_number);
-    Tensor<type, 1> forget_activations(neurons_number);
-
-    Tensor<type, 1> input_combinations(neurons_number);
-    Tensor<type, 1> input_activations(neurons_number);
-
-    Tensor<type, 1> state_combinations(neurons_number);
-    Tensor<type, 1> state_activations(neurons_number);
-
-    Tensor<type, 1> output_combinations(neurons_number);
-    Tensor<type, 1> output_activations(neurons_number);
-
-    for(Index i = 0; i < instances_number; i++)
-    {
-        if(i%timesteps == 0)
-        {
-            hidden_states.setZero();
-            cell_states.setZero();
-        }
-
-        const Tensor<type, 1> current_inputs = inputs.chip(i, 0);
-
-        calculate_forget_combinations(current_inputs, forget_weights, forget_recurrent_weights, forget_biases, forget_combinations);
-        calculate_recurrent_activations(forget_combinations, forget_activations);
-
-        calculate_input_combinations(current_inputs, input_weights, input_recurrent_weights, input_biases, input_combinations);
-        calculate_recurrent_activations(input_combinations, input_activations);
-
-        calculate_state_combinations(current_inputs, state_weights, state_recurrent_weights, state_biases, state_combinations);
-        calculate_activations(state_combinations, state_activations);
-
-        calculate_output_combinations(current_inputs, output_weights, output_recurrent_weights, output_biases, output_combinations);
-        calculate_recurrent_activations(output_combinations, output_activations);
-
-        cell_states = forget_activations * cell_states + input_activations * state_activations;
-//        hidden_states = output_activations * calculate_activations(cell_states);
-         calculate_activations(cell_states, hidden_states);
-         hidden_states *= output_activations;
-
-        memcpy(activations_states.data() + forget_activations_index, forget_activations.data(), static_cast<size_t>(forget_activations.size())*sizeof(type));
-        memcpy(activations_states.data() + input_activations_index, input_activations.data(), static_cast<size_t>(input_activations.size())*sizeof(type));
-        memcpy(activations_states.data() + state_activations_index, state_activations.data(), static_cast<size_t>(state_activations.size())*sizeof(type));
-        memcpy(activations_states.data() + output_activations_index, output_activations.data(), static_cast<size_t>(output_activations.size())*sizeof(type));
-        memcpy(activations_states.data() + states_index, cell_states.data(), static_cast<size_t>(cell_states.size())*sizeof(type));
-        memcpy(activations_states.data() + hidden_states_index, hidden_states.data(), static_cast<size_t>(hidden_states.size())*sizeof(type));
-
-        forget_activations_index ++; //= neurons_number;
-        input_activations_index ++; //= neurons_number;
-        state_activations_index ++; //= neurons_number;
-        output_activations_index ++; //= neurons_number;
-        states_index ++; //= neurons_number;
-        hidden_states_index ++; //= neurons_number;
-    }
-
-    return activations_states;
-
-}
-
-
 void LongShortTermMemoryLayer::calculate_activations(const Tensor<type, 2>& combinations_2d, Tensor<type, 2>& activations_2d) const
 {
 #ifdef __OPENNN_DEBUG__
@@ -1317,27 +1258,27 @@ void LongShortTermMemoryLayer::calculate_activations(const Tensor<type, 2>& comb
 
     switch(activation_function)
     {
-        case Linear:  linear(combinations_2d, activations_2d);
+        case Linear: return linear(combinations_2d, activations_2d);
 
-        case Logistic:  logistic(combinations_2d, activations_2d);
+        case Logistic: return logistic(combinations_2d, activations_2d);
 
-        case HyperbolicTangent:  hyperbolic_tangent(combinations_2d, activations_2d);
+        case HyperbolicTangent: return hyperbolic_tangent(combinations_2d, activations_2d);
 
-        case Threshold:  threshold(combinations_2d, activations_2d);
+        case Threshold: return threshold(combinations_2d, activations_2d);
 
-        case SymmetricThreshold:  symmetric_threshold(combinations_2d, activations_2d);
+        case SymmetricThreshold: return symmetric_threshold(combinations_2d, activations_2d);
 
-        case RectifiedLinear:  rectified_linear(combinations_2d, activations_2d);
+        case RectifiedLinear: return rectified_linear(combinations_2d, activations_2d);
 
-        case ScaledExponentialLinear:  scaled_exponential_linear(combinations_2d, activations_2d);
+        case ScaledExponentialLinear: return scaled_exponential_linear(combinations_2d, activations_2d);
 
-        case SoftPlus:  soft_plus(combinations_2d, activations_2d);
+        case SoftPlus: return soft_plus(combinations_2d, activations_2d);
 
-        case SoftSign:  soft_sign(combinations_2d, activations_2d);
+        case SoftSign: return soft_sign(combinations_2d, activations_2d);
 
-        case HardSigmoid:  hard_sigmoid(combinations_2d, activations_2d);
+        case HardSigmoid: return hard_sigmoid(combinations_2d, activations_2d);
 
-        case ExponentialLinear:  exponential_linear(combinations_2d, activations_2d);
+        case ExponentialLinear: return exponential_linear(combinations_2d, activations_2d);
     }
 }
 
@@ -1365,27 +1306,27 @@ void LongShortTermMemoryLayer::calculate_activations(const Tensor<type, 1>& comb
 
     switch(activation_function)
     {
-        case Linear:  linear(combinations_1d, activations_1d);
+        case Linear: return linear(combinations_1d, activations_1d);
 
-        case Logistic:  logistic(combinations_1d, activations_1d);
+        case Logistic: return logistic(combinations_1d, activations_1d);
 
-        case HyperbolicTangent:  hyperbolic_tangent(combinations_1d, activations_1d);
+        case HyperbolicTangent: return hyperbolic_tangent(combinations_1d, activations_1d);
 
-        case Threshold:  threshold(combinations_1d, activations_1d);
+        case Threshold: return threshold(combinations_1d, activations_1d);
 
-        case SymmetricThreshold:  symmetric_threshold(combinations_1d, activations_1d);
+        case SymmetricThreshold: return symmetric_threshold(combinations_1d, activations_1d);
 
-        case RectifiedLinear:  rectified_linear(combinations_1d, activations_1d);
+        case RectifiedLinear: return rectified_linear(combinations_1d, activations_1d);
 
-        case ScaledExponentialLinear:  scaled_exponential_linear(combinations_1d, activations_1d);
+        case ScaledExponentialLinear: return scaled_exponential_linear(combinations_1d, activations_1d);
 
-        case SoftPlus:  soft_plus(combinations_1d, activations_1d);
+        case SoftPlus: return soft_plus(combinations_1d, activations_1d);
 
-        case SoftSign:  soft_sign(combinations_1d, activations_1d);
+        case SoftSign: return soft_sign(combinations_1d, activations_1d);
 
-        case HardSigmoid:  hard_sigmoid(combinations_1d, activations_1d);
+        case HardSigmoid: return hard_sigmoid(combinations_1d, activations_1d);
 
-        case ExponentialLinear:  exponential_linear(combinations_1d, activations_1d);
+        case ExponentialLinear: return exponential_linear(combinations_1d, activations_1d);
     }
 }
 
@@ -1415,27 +1356,27 @@ Tensor<type, 1> LongShortTermMemoryLayer::calculate_activations(const Tensor<typ
 
     switch(activation_function)
     {
-        case Linear:  linear(combinations_1d, activations_1d);
+        case Linear: linear(combinations_1d, activations_1d); break;
 
-        case Logistic:  logistic(combinations_1d, activations_1d);
+        case Logistic: logistic(combinations_1d, activations_1d); break;
 
-        case HyperbolicTangent:  hyperbolic_tangent(combinations_1d, activations_1d);
+        case HyperbolicTangent: hyperbolic_tangent(combinations_1d, activations_1d); break;
 
-        case Threshold:  threshold(combinations_1d, activations_1d);
+        case Threshold: threshold(combinations_1d, activations_1d); break;
 
-        case SymmetricThreshold:  symmetric_threshold(combinations_1d, activations_1d);
+        case SymmetricThreshold: symmetric_threshold(combinations_1d, activations_1d); break;
 
-        case RectifiedLinear:  rectified_linear(combinations_1d, activations_1d);
+        case RectifiedLinear: rectified_linear(combinations_1d, activations_1d); break;
 
-        case ScaledExponentialLinear:  scaled_exponential_linear(combinations_1d, activations_1d);
+        case ScaledExponentialLinear: scaled_exponential_linear(combinations_1d, activations_1d); break;
 
-        case SoftPlus:  soft_plus(combinations_1d, activations_1d);
+        case SoftPlus: soft_plus(combinations_1d, activations_1d); break;
 
-        case SoftSign:  soft_sign(combinations_1d, activations_1d);
+        case SoftSign: soft_sign(combinations_1d, activations_1d); break;
 
-        case HardSigmoid:  hard_sigmoid(combinations_1d, activations_1d);
+        case HardSigmoid: hard_sigmoid(combinations_1d, activations_1d); break;
 
-        case ExponentialLinear:  exponential_linear(combinations_1d, activations_1d);
+        case ExponentialLinear: exponential_linear(combinations_1d, activations_1d); break;
     }
 
     return activations_1d;
@@ -1465,27 +1406,27 @@ void LongShortTermMemoryLayer::calculate_recurrent_activations(const Tensor<type
 
     switch(recurrent_activation_function)
     {
-        case Linear:  linear(combinations_2d, activations_2d);
+        case Linear: return linear(combinations_2d, activations_2d);
 
-        case Logistic:  logistic(combinations_2d, activations_2d);
+        case Logistic: return logistic(combinations_2d, activations_2d);
 
-        case HyperbolicTangent:  hyperbolic_tangent(combinations_2d, activations_2d);
+        case HyperbolicTangent: return hyperbolic_tangent(combinations_2d, activations_2d);
 
-        case Threshold:  threshold(combinations_2d, activations_2d);
+        case Threshold: return threshold(combinations_2d, activations_2d);
 
-        case SymmetricThreshold:  symmetric_threshold(combinations_2d, activations_2d);
+        case SymmetricThreshold: return symmetric_threshold(combinations_2d, activations_2d);
 
-        case RectifiedLinear:  rectified_linear(combinations_2d, activations_2d);
+        case RectifiedLinear: return rectified_linear(combinations_2d, activations_2d);
 
-        case ScaledExponentialLinear:  scaled_exponential_linear(combinations_2d, activations_2d);
+        case ScaledExponentialLinear: return scaled_exponential_linear(combinations_2d, activations_2d);
 
-        case SoftPlus:  soft_plus(combinations_2d, activations_2d);
+        case SoftPlus: return soft_plus(combinations_2d, activations_2d);
 
-        case SoftSign:  soft_sign(combinations_2d, activations_2d);
+        case SoftSign: return soft_sign(combinations_2d, activations_2d);
 
-        case HardSigmoid:  hard_sigmoid(combinations_2d, activations_2d);
+        case HardSigmoid: return hard_sigmoid(combinations_2d, activations_2d);
 
-        case ExponentialLinear:  exponential_linear(combinations_2d, activations_2d);
+        case ExponentialLinear: return exponential_linear(combinations_2d, activations_2d);
     }
 }
 
@@ -1514,27 +1455,27 @@ void LongShortTermMemoryLayer::calculate_recurrent_activations(const Tensor<type
 
     switch(recurrent_activation_function)
     {
-        case Linear:  linear(combinations_1d, recurrent_activations_1d);
+        case Linear: return linear(combinations_1d, recurrent_activations_1d);
 
-        case Logistic:  logistic(combinations_1d, recurrent_activations_1d);
+        case Logistic: return logistic(combinations_1d, recurrent_activations_1d);
 
-        case HyperbolicTangent:  hyperbolic_tangent(combinations_1d, recurrent_activations_1d);
+        case HyperbolicTangent: return hyperbolic_tangent(combinations_1d, recurrent_activations_1d);
 
-        case Threshold:  threshold(combinations_1d, recurrent_activations_1d);
+        case Threshold: return threshold(combinations_1d, recurrent_activations_1d);
 
-        case SymmetricThreshold:  symmetric_threshold(combinations_1d, recurrent_activations_1d);
+        case SymmetricThreshold: return symmetric_threshold(combinations_1d, recurrent_activations_1d);
 
-        case RectifiedLinear:  rectified_linear(combinations_1d, recurrent_activations_1d);
+        case RectifiedLinear: return rectified_linear(combinations_1d, recurrent_activations_1d);
 
-        case ScaledExponentialLinear:  scaled_exponential_linear(combinations_1d, recurrent_activations_1d);
+        case ScaledExponentialLinear: return scaled_exponential_linear(combinations_1d, recurrent_activations_1d);
 
-        case SoftPlus:  soft_plus(combinations_1d, recurrent_activations_1d);
+        case SoftPlus: return soft_plus(combinations_1d, recurrent_activations_1d);
 
-        case SoftSign:  soft_sign(combinations_1d, recurrent_activations_1d);
+        case SoftSign: return soft_sign(combinations_1d, recurrent_activations_1d);
 
-        case HardSigmoid:  hard_sigmoid(combinations_1d, recurrent_activations_1d);
+        case HardSigmoid: return hard_sigmoid(combinations_1d, recurrent_activations_1d);
 
-        case ExponentialLinear:  exponential_linear(combinations_1d, recurrent_activations_1d);
+        case ExponentialLinear: return exponential_linear(combinations_1d, recurrent_activations_1d);
     }
 }
 
@@ -1643,6 +1584,56 @@ void LongShortTermMemoryLayer::calculate_activations_derivatives(const Tensor<ty
     }
 }
 
+void LongShortTermMemoryLayer::calculate_recurrent_activations_derivatives(const Tensor<type, 2>& combinations_2d,
+                                                                           Tensor<type, 2>& activations_2d,
+                                                                           Tensor<type, 2>& activations_derivatives_2d) const
+{
+#ifdef __OPENNN_DEBUG__
+
+    const Index neurons_number = get_neurons_number();
+
+    const Index combinations_columns_number = combinations_2d.dimension(1);
+
+    if(combinations_columns_number != neurons_number)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: LongShortTermMemoryLayer class.\n"
+               << "Tensor<type, 2> calculate_recurrent_activations_derivatives(const Tensor<type, 2>&) const method.\n"
+               << "Number of columns("<< combinations_columns_number <<") of combinations_2d must be equal to number of neurons("<<neurons_number<<").\n";
+
+        throw logic_error(buffer.str());
+    }
+
+#endif
+
+    switch(recurrent_activation_function)
+    {
+        case Linear: return linear_derivatives(combinations_2d, activations_2d, activations_derivatives_2d);
+
+        case Logistic: return logistic_derivatives(combinations_2d, activations_2d, activations_derivatives_2d);
+
+        case HyperbolicTangent: return hyperbolic_tangent_derivatives(combinations_2d, activations_2d, activations_derivatives_2d);
+
+        case Threshold: return threshold_derivatives(combinations_2d, activations_2d, activations_derivatives_2d);
+
+        case SymmetricThreshold: return symmetric_threshold_derivatives(combinations_2d, activations_2d, activations_derivatives_2d);
+
+        case RectifiedLinear: return rectified_linear_derivatives(combinations_2d, activations_2d, activations_derivatives_2d);
+
+        case ScaledExponentialLinear: return scaled_exponential_linear_derivatives(combinations_2d, activations_2d, activations_derivatives_2d);
+
+        case SoftPlus: return soft_plus_derivatives(combinations_2d, activations_2d, activations_derivatives_2d);
+
+        case SoftSign: return soft_sign_derivatives(combinations_2d, activations_2d, activations_derivatives_2d);
+
+        case HardSigmoid: return hard_sigmoid_derivatives(combinations_2d, activations_2d, activations_derivatives_2d);
+
+        case ExponentialLinear: return exponential_linear_derivatives(combinations_2d, activations_2d, activations_derivatives_2d);
+    }
+}
+
+
 void LongShortTermMemoryLayer::calculate_recurrent_activations_derivatives(const Tensor<type, 1>& combinations_1d,
                                                                            Tensor<type, 1>& activations_1d,
                                                                            Tensor<type, 1>& activations_derivatives_1d) const
@@ -1790,154 +1781,190 @@ Tensor<type, 2> LongShortTermMemoryLayer::calculate_outputs(const Tensor<type, 2
     }
     #endif
 
-    const Index instances_number = inputs.dimension(0);
+    ForwardPropagation forward_propagation(inputs.dimension(0), this);
 
-    const Index neurons_number = get_neurons_number();
+    forward_propagate(inputs, forward_propagation);
 
-    Tensor<type, 2> outputs(instances_number, neurons_number);
+    return forward_propagation.activations_2d;
+}
 
-    Tensor<type, 1> forget_combinations(neurons_number);
-    Tensor<type, 1> forget_activations(neurons_number);
 
-    Tensor<type, 1> input_combinations(neurons_number);
-    Tensor<type, 1> input_activations(neurons_number);
+/// Calculates the forward propagation of the layer with its current parameters.
+/// @param inputs Inputs to the layer, where each sequence is made of timesteps consecutive rows.
+/// @param forward_propagation Structure where the outputs and the gates activations and derivatives are saved.
 
-    Tensor<type, 1> state_combinations(neurons_number);
-    Tensor<type, 1> state_activations(neurons_number);
+void LongShortTermMemoryLayer::forward_propagate(const Tensor<type, 2>& inputs, ForwardPropagation& forward_propagation) const
+{
+    Tensor<type, 1> parameters = get_parameters();
 
-    Tensor<type, 1> output_combinations(neurons_number);
-    Tensor<type, 1> output_activations(neurons_number);
+    const TensorMap<Tensor<type, 1>> parameters_map(parameters.data(), parameters.size());
 
-    for(Index i = 0; i < instances_number; i++)
-    {
-        if(i%timesteps == 0)
-        {
-            hidden_states.setZero();
-            cell_states.setZero();
-        }
+    forward_propagate(inputs, parameters_map, forward_propagation);
+}
 
-        const Tensor<type, 1> current_inputs = inputs.chip(i, 0);
 
-    #pragma omp parallel
-        {
-            calculate_forget_combinations(current_inputs, forget_weights, forget_recurrent_weights, forget_biases, forget_combinations); // change combinations, add parameters
-            calculate_recurrent_activations(forget_combinations, forget_activations);
+/// Calculates the forward propagation of the layer with the given parameters.
+/// All the sequences in the inputs are processed at the same time.
+/// The input projections of the four gates are calculated with a single product for all the timesteps,
+/// and then a single product with the recurrent weights of the four gates is done at each timestep.
+/// The gates activations and derivatives are saved ordered by timestep, to be used in the back-propagation through time.
+/// @param inputs Inputs to the layer, where each sequence is made of timesteps consecutive rows.
+/// @param parameters Parameters of the layer, in the same order as get_parameters().
+/// @param forward_propagation Structure where the outputs and the gates activations and derivatives are saved.
 
-            calculate_input_combinations(current_inputs, input_weights, input_recurrent_weights, input_biases, input_combinations); // change combinations, add parameters
-            calculate_recurrent_activations(input_combinations, input_activations);
+void LongShortTermMemoryLayer::forward_propagate(const Tensor<type, 2>& inputs,
+                                                 const TensorMap<Tensor<type, 1>>& parameters,
+                                                 ForwardPropagation& forward_propagation) const
+{
+    const Index instances_number = inputs.dimension(0);
+    const Index inputs_number = get_inputs_number();
+    const Index neurons_number = get_neurons_number();
 
-            calculate_state_combinations(current_inputs, state_weights, state_recurrent_weights, state_biases, state_combinations); // change combinations, add parameters
-            calculate_activations(state_combinations, state_activations);
+#ifdef __OPENNN_DEBUG__
 
-            calculate_output_combinations(current_inputs, output_weights, output_recurrent_weights, output_biases, output_combinations); // change combinations, add parameters
-            calculate_recurrent_activations(output_combinations, output_activations);
-        }
+    if(inputs_number != inputs.dimension(1))
+    {
+        ostringstream buffer;
 
-        cell_states = forget_activations * cell_states + input_activations * state_activations;
-        calculate_activations(cell_states, hidden_states);
-        hidden_states *= output_activations;
+        buffer << "OpenNN Exception: LongShortTermMemoryLayer class.\n"
+               << "void forward_propagate(const Tensor<type, 2>&, const TensorMap<Tensor<type, 1>>&, ForwardPropagation&) method.\n"
+               << "Number of inputs columns (" << inputs.dimension(1) << ") must be equal to number of inputs ("
+               << inputs_number << ").\n";
 
-        for(Index j = 0; j < neurons_number; j++)
-            outputs(i,j) = hidden_states(j);
-      }
+        throw logic_error(buffer.str());
+    }
 
-    return outputs;
-}
+#endif
 
+    // Forget, input, state and output gates side by side
 
+    const TensorMap<Tensor<type, 2>> weights(parameters.data(), inputs_number, 4*neurons_number);
 
-/*
-Layer::ForwardPropagation LongShortTermMemoryLayer::forward_propagate(const Tensor<type, 2>& inputs)
-{
-    const Index instances_number = inputs.dimension(0);
-    const Index neurons_number = get_neurons_number();
+    const TensorMap<Tensor<type, 2>> recurrent_weights(parameters.data() + 4*inputs_number*neurons_number,
+                                                       neurons_number, 4*neurons_number);
+
+    const TensorMap<Tensor<type, 2>> biases(parameters.data() + 4*neurons_number*(inputs_number + neurons_number),
+                                            1, 4*neurons_number);
+
+    Tensor<Index, 1> steps_offsets;
+    Tensor<Index, 1> steps_sizes;
 
-    Tensor<type, 2> activations_2d(instances_number,neurons_number);
+    calculate_steps(instances_number, steps_offsets, steps_sizes);
 
-    // forget, input, state, output and tanh(cell_states) derivatives
-    Tensor<type, 2> activations_derivatives(instances_number,neurons_number, 5);
-    activations_derivatives.setZero();
+    const Index steps_number = steps_sizes.size();
 
-    Index forget_activations_index = 0;
-    Index input_activations_index = instances_number*neurons_number;
-    Index state_activations_index = 2*instances_number*neurons_number;
-    Index output_activations_index = 3*instances_number*neurons_number;
-    Index hidden_states_index = 4*instances_number*neurons_number;
+    const Tensor<type, 2> sorted_inputs = sort_by_timesteps(inputs, steps_offsets, steps_sizes);
 
-    Tensor<type, 1> forget_combinations;
-    Tensor<type, 1> forget_activations;
-    Tensor<type, 1> forget_activations_derivatives;
+    Tensor<type, 2> combinations(instances_number, 4*neurons_number);
 
-    Tensor<type, 1> input_combinations;
-    Tensor<type, 1> input_activations;
-    Tensor<type, 1> input_activations_derivatives;
+    combinations.device(*thread_pool_device) = sorted_inputs.contract(weights, A_B)
+            + biases.broadcast(Eigen::array<Index, 2>({instances_number, 1}));
 
-    Tensor<type, 1> state_combinations;
-    Tensor<type, 1> state_activations;
-    Tensor<type, 1> state_activations_derivatives;
+    // Activations and derivatives, ordered by timestep
 
-    Tensor<type, 1> output_combinations;
-    Tensor<type, 1> output_activations;
-    Tensor<type, 1> output_activations_derivatives;
+    TensorMap<Tensor<type, 2>> forget_activations(forward_propagation.activations_3d.data(), instances_number, neurons_number);
+    TensorMap<Tensor<type, 2>> input_activations(forward_propagation.activations_3d.data() + instances_number*neurons_number, instances_number, neurons_number);
+    TensorMap<Tensor<type, 2>> state_activations(forward_propagation.activations_3d.data() + 2*instances_number*neurons_number, instances_number, neurons_number);
+    TensorMap<Tensor<type, 2>> output_activations(forward_propagation.activations_3d.data() + 3*instances_number*neurons_number, instances_number, neurons_number);
+    TensorMap<Tensor<type, 2>> cell_states(forward_propagation.activations_3d.data() + 4*instances_number*neurons_number, instances_number, neurons_number);
+    TensorMap<Tensor<type, 2>> cell_states_activations(forward_propagation.activations_3d.data() + 5*instances_number*neurons_number, instances_number, neurons_number);
 
-    for(Index i = 0; i < instances_number; i++)
+    TensorMap<Tensor<type, 2>> forget_derivatives(forward_propagation.activations_derivatives_3d.data(), instances_number, neurons_number);
+    TensorMap<Tensor<type, 2>> input_derivatives(forward_propagation.activations_derivatives_3d.data() + instances_number*neurons_number, instances_number, neurons_number);
+    TensorMap<Tensor<type, 2>> state_derivatives(forward_propagation.activations_derivatives_3d.data() + 2*instances_number*neurons_number, instances_number, neurons_number);
+    TensorMap<Tensor<type, 2>> output_derivatives(forward_propagation.activations_derivatives_3d.data() + 3*instances_number*neurons_number, instances_number, neurons_number);
+    TensorMap<Tensor<type, 2>> cell_states_derivatives(forward_propagation.activations_derivatives_3d.data() + 4*instances_number*neurons_number, instances_number, neurons_number);
+
+    Tensor<type, 2> previous_hidden_states;
+    Tensor<type, 2> previous_cell_states;
+
+    for(Index t = 0; t < steps_number; t++)
     {
-        if(i%timesteps == 0)
+        const Index offset = steps_offsets(t);
+        const Index size = steps_sizes(t);
+
+        const Eigen::array<Index, 2> step_offsets({offset, 0});
+        const Eigen::array<Index, 2> step_extents({size, neurons_number});
+
+        Tensor<type, 2> step_combinations = combinations.slice(Eigen::array<Index, 2>({offset, 0}),
+                                                               Eigen::array<Index, 2>({size, 4*neurons_number}));
+
+        if(t != 0)
         {
-            hidden_states.setZero();
-            cell_states.setZero();
+            step_combinations.device(*thread_pool_device) += previous_hidden_states.slice(Eigen::array<Index, 2>({0, 0}), step_extents)
+                                                             .contract(recurrent_weights, A_B);
         }
 
-        const Tensor<type, 1> current_inputs = inputs.chip(i, 0);
+        Tensor<type, 2> gate_combinations(size, neurons_number);
+        Tensor<type, 2> gate_activations(size, neurons_number);
+        Tensor<type, 2> gate_derivatives(size, neurons_number);
 
- #pragma omp parallel
-        {
-            forget_combinations = calculate_forget_combinations(current_inputs);
-            forget_activations = calculate_recurrent_activations(forget_combinations);
-            forget_activations_derivatives = calculate_recurrent_activations_derivatives(forget_combinations);
+        // Forget gate
 
-            input_combinations = calculate_input_combinations(current_inputs);
-            input_activations = calculate_recurrent_activations(input_combinations);
-            input_activations_derivatives = calculate_recurrent_activations_derivatives(input_combinations);
+        gate_combinations = step_combinations.slice(Eigen::array<Index, 2>({0, 0}), step_extents);
+        calculate_recurrent_activations_derivatives(gate_combinations, gate_activations, gate_derivatives);
+        forget_activations.slice(step_offsets, step_extents) = gate_activations;
+        forget_derivatives.slice(step_offsets, step_extents) = gate_derivatives;
 
-            state_combinations = calculate_state_combinations(current_inputs);
-            state_activations = calculate_activations(state_combinations);
-            state_activations_derivatives = calculate_activations_derivatives(state_combinations);
+        // Input gate
 
-            output_combinations = calculate_output_combinations(current_inputs);
-            output_activations = calculate_recurrent_activations(output_combinations);
-            output_activations_derivatives = calculate_recurrent_activations_derivatives(output_combinations);
-        }
+        gate_combinations = step_combinations.slice(Eigen::array<Index, 2>({0, neurons_number}), step_extents);
+        calculate_recurrent_activations_derivatives(gate_combinations, gate_activations, gate_derivatives);
+        input_activations.slice(step_offsets, step_extents) = gate_activations;
+        input_derivatives.slice(step_offsets, step_extents) = gate_derivatives;
 
-        cell_states = forget_activations * cell_states + input_activations * state_activations;
-        hidden_states = output_activations * calculate_activations(cell_states);
-        const Tensor<type, 1> hidden_states_derivatives = calculate_activations_derivatives(cell_states);
+        // State gate
 
-        activations_2d.set_row(i,hidden_states);
+        gate_combinations = step_combinations.slice(Eigen::array<Index, 2>({0, 2*neurons_number}), step_extents);
+        calculate_activations_derivatives(gate_combinations, gate_activations, gate_derivatives);
+        state_activations.slice(step_offsets, step_extents) = gate_activations;
+        state_derivatives.slice(step_offsets, step_extents) = gate_derivatives;
 
-        activations_derivatives.embed(forget_activations_index, forget_activations_derivatives);
-        activations_derivatives.embed(input_activations_index, input_activations_derivatives);
-        activations_derivatives.embed(state_activations_index, state_activations_derivatives);
-        activations_derivatives.embed(output_activations_index, output_activations_derivatives);
-        activations_derivatives.embed(hidden_states_index, hidden_states_derivatives);
+        // Output gate
 
-        forget_activations_index++;
-        input_activations_index++;
-        state_activations_index++;
-        output_activations_index++;
-        hidden_states_index++;
-    }
+        gate_combinations = step_combinations.slice(Eigen::array<Index, 2>({0, 3*neurons_number}), step_extents);
+        calculate_recurrent_activations_derivatives(gate_combinations, gate_activations, gate_derivatives);
+        output_activations.slice(step_offsets, step_extents) = gate_activations;
+        output_derivatives.slice(step_offsets, step_extents) = gate_derivatives;
+
+        // Cell states and hidden states
+
+        Tensor<type, 2> current_cell_states(size, neurons_number);
+
+        current_cell_states.device(*thread_pool_device)
+                = input_activations.slice(step_offsets, step_extents)*state_activations.slice(step_offsets, step_extents);
+
+        if(t != 0)
+        {
+            current_cell_states.device(*thread_pool_device)
+                    += forget_activations.slice(step_offsets, step_extents)
+                     * previous_cell_states.slice(Eigen::array<Index, 2>({0, 0}), step_extents);
+        }
+
+        calculate_activations_derivatives(current_cell_states, gate_activations, gate_derivatives);
+
+        cell_states.slice(step_offsets, step_extents) = current_cell_states;
+        cell_states_activations.slice(step_offsets, step_extents) = gate_activations;
+        cell_states_derivatives.slice(step_offsets, step_extents) = gate_derivatives;
 
-    Layer::ForwardPropagation layers;
+        previous_hidden_states.resize(size, neurons_number);
 
-    layers.activations_2d = activations_2d;
-    layers.activations_derivatives = activations_derivatives;
+        previous_hidden_states.device(*thread_pool_device) = output_activations.slice(step_offsets, step_extents)*gate_activations;
 
-    return layers;
+        previous_cell_states = current_cell_states;
 
-    return Layer::ForwardPropagation();
+        // Outputs, in the original order
+
+        for(Index s = 0; s < size; s++)
+        {
+            for(Index j = 0; j < neurons_number; j++)
+            {
+                forward_propagation.activations_2d(s*timesteps + t, j) = previous_hidden_states(s, j);
+            }
+        }
+    }
 }
-*/
+
 
 Tensor<type, 2> LongShortTermMemoryLayer::calculate_hidden_delta(Layer* next_layer_pointer,
         const Tensor<type, 2>&,
@@ -1973,1351 +2000,333 @@ Tensor<type, 2> LongShortTermMemoryLayer::calculate_hidden_delta(Layer* next_lay
 }
 
 
-Tensor<type, 1> LongShortTermMemoryLayer::calculate_error_gradient(const Tensor<type, 2> &  inputs,
-        const Layer::ForwardPropagation& forward_propagation,
-        const Tensor<type, 2> & deltas)
-{
-
-    const Index parameters_number = get_parameters_number();
-
-    const Index neurons_number = get_neurons_number();
-    const Index inputs_number = get_inputs_number();
-
-    // For each layer
+/// Calculates the delta of the layer when it is the output layer.
+/// The hidden states are the outputs of the layer, so the delta is the output gradient itself.
+/// The derivatives of the gates are taken into account in the back-propagation through time.
 
-    const Index weights_number = inputs_number*neurons_number;
-    const Index recurrent_weights_number = neurons_number*neurons_number;
-    const Index biases_number = neurons_number;
+void LongShortTermMemoryLayer::calculate_output_delta(ForwardPropagation&,
+                                                      const Tensor<type, 2>& output_gradient,
+                                                      Tensor<type, 2>& output_delta) const
+{
+    output_delta.device(*thread_pool_device) = output_gradient;
+}
 
-    Tensor<type, 1> error_gradient(parameters_number);
 
-    const Tensor<type, 3> activations_states = calculate_activations_states(inputs);
+/// Calculates the delta of the layer with respect to its outputs, from the delta of the next layer.
+/// The derivatives of the gates are taken into account in the back-propagation through time.
 
+void LongShortTermMemoryLayer::calculate_hidden_delta(Layer* next_layer_pointer,
+                                                      const Tensor<type, 2>&,
+                                                      ForwardPropagation&,
+                                                      const Tensor<type, 2>& next_layer_delta,
+                                                      Tensor<type, 2>& hidden_delta) const
+{
+    const Type next_layer_type = next_layer_pointer->get_type();
 
-    #pragma omp parallel
+    switch(next_layer_type)
     {
-        // Forget weights
-
-        for(Index i = 0; i < weights_number; i++)
-        {
-            error_gradient(i) = (calculate_forget_weights_error_gradient(inputs,forward_propagation,deltas,activations_states))(i);
-        }
-
-        // Input weights
-
-        for(Index i = 0; i < weights_number; i++)
-        {
-            error_gradient(i + weights_number) = (calculate_input_weights_error_gradient(inputs,forward_propagation,deltas,activations_states))(i);
-        }
-
-        // State weights
-
-        for(Index i = 0; i < weights_number; i++)
-        {
-            error_gradient(i + 2*weights_number) = (calculate_state_weights_error_gradient(inputs,forward_propagation,deltas,activations_states))(i);
-        }
-
-        // Output weights
-
-        for(Index i = 0; i < weights_number; i++)
-        {
-            error_gradient(i + 3*weights_number) = (calculate_output_weights_error_gradient(inputs,forward_propagation,deltas,activations_states))(i);
-        }
-
-        // Forget recurrent weights
-
-        for(Index i = 0; i < recurrent_weights_number; i++)
-        {
-            error_gradient(i + 4*weights_number) = (calculate_forget_recurrent_weights_error_gradient(inputs,forward_propagation,deltas,activations_states))(i);
-        }
-
-        // Input recurrent weights
-
-        for(Index i = 0; i < recurrent_weights_number; i++)
-        {
-            error_gradient(i + 4*weights_number+recurrent_weights_number) = (calculate_input_recurrent_weights_error_gradient(inputs,forward_propagation,deltas,activations_states))(i);
-        }
-
-        // State recurrent weights
-
-        for(Index i = 0; i < recurrent_weights_number; i++)
-        {
-            error_gradient(i + 4*weights_number+2*recurrent_weights_number) = (calculate_state_recurrent_weights_error_gradient(inputs,forward_propagation,deltas,activations_states))(i);
-        }
-
-        // Output recurrent weights
-
-        for(Index i = 0; i < recurrent_weights_number; i++)
+        case Perceptron:
         {
-            error_gradient(i + 4*weights_number+3*recurrent_weights_number) = (calculate_output_recurrent_weights_error_gradient(inputs,forward_propagation,deltas,activations_states))(i);
-        }
+            const PerceptronLayer* next_perceptron_layer = dynamic_cast<PerceptronLayer*>(next_layer_pointer);
 
-        // Forget biases
+            const Tensor<type, 2>& next_synaptic_weights = next_perceptron_layer->get_synaptic_weights();
 
-        for(Index i = 0; i < biases_number; i++)
-        {
-            error_gradient(i + 4*weights_number+4*recurrent_weights_number) = (calculate_forget_biases_error_gradient(inputs,forward_propagation,deltas,activations_states))(i);
+            hidden_delta.device(*thread_pool_device) = next_layer_delta.contract(next_synaptic_weights, A_BT);
         }
+        return;
 
-        // Input biases
-
-        for(Index i = 0; i < biases_number; i++)
+        case Probabilistic:
         {
-            error_gradient(4*weights_number+4*recurrent_weights_number+biases_number) = (calculate_input_biases_error_gradient(inputs,forward_propagation,deltas,activations_states))(i);
-        }
+            const ProbabilisticLayer* next_probabilistic_layer = dynamic_cast<ProbabilisticLayer*>(next_layer_pointer);
 
-        // State biases
+            const Tensor<type, 2>& next_synaptic_weights = next_probabilistic_layer->get_synaptic_weights();
 
-        for(Index i = 0; i < biases_number; i++)
-        {
-            error_gradient(i + 4*weights_number+4*recurrent_weights_number+2*biases_number) = (calculate_state_biases_error_gradient(inputs,forward_propagation,deltas,activations_states))(i);
+            hidden_delta.device(*thread_pool_device) = next_layer_delta.contract(next_synaptic_weights, A_BT);
         }
+        return;
 
-        // Output biases
+        default:
 
-        for(Index i = 0; i < biases_number; i++)
-        {
-            error_gradient(i + 4*weights_number+4*recurrent_weights_number+3*biases_number) = (calculate_output_biases_error_gradient(inputs,forward_propagation,deltas,activations_states))(i);
-        }
+        return;
     }
-
-    return error_gradient;
-
 }
 
 
-Tensor<type, 1> LongShortTermMemoryLayer::calculate_forget_weights_error_gradient(const Tensor<type, 2>& inputs,
-        const Layer::ForwardPropagation& forward_propagation,
-        const Tensor<type, 2>& deltas,
-        const Tensor<type, 3>& activations_states)
-{
+/// Calculates the derivatives of the error with respect to the parameters of the layer by back-propagation through time.
+/// All the sequences are processed at the same time, from the last timestep to the first one.
+/// At each timestep, the derivatives of the four gates are propagated to the previous hidden states with a single product.
+/// The weights derivatives are then calculated with one product for the input weights and another one for the recurrent weights.
+/// @param inputs Inputs to the layer, where each sequence is made of timesteps consecutive rows.
+/// @param forward_propagation Forward propagation of the layer for those inputs.
+/// @param back_propagation Structure with the delta of the layer, where the derivatives are saved.
 
+void LongShortTermMemoryLayer::calculate_error_gradient(const Tensor<type, 2>& inputs,
+                                                        const Layer::ForwardPropagation& forward_propagation,
+                                                        Layer::BackPropagation& back_propagation) const
+{
     const Index instances_number = inputs.dimension(0);
-    const Index inputs_number = get_inputs_number();
     const Index neurons_number = get_neurons_number();
-    const Index parameters_number = inputs_number*neurons_number;
 
-     Tensor<type, 1> forget_weights_error_gradient(parameters_number);
-     forget_weights_error_gradient.setZero();
+    const Tensor<type, 1> parameters = get_parameters();
 
-     Tensor<type, 2> input_combinations_weights_derivatives(parameters_number, neurons_number);
-     Tensor<type, 2> forget_combinations_weights_derivatives(parameters_number, neurons_number);
-     Tensor<type, 2> state_combinations_weights_derivatives(parameters_number, neurons_number);
-     Tensor<type, 2> output_combinations_weights_derivatives(parameters_number, neurons_number);
+    const TensorMap<Tensor<type, 2>> recurrent_weights(const_cast<type*>(parameters.data()) + 4*get_inputs_number()*neurons_number,
+                                                       neurons_number, 4*neurons_number);
 
-     Tensor<type, 2> hidden_states_weights_derivatives(parameters_number, neurons_number);
-     Tensor<type, 2> cell_state_weights_derivatives(parameters_number, neurons_number);
+    Tensor<Index, 1> steps_offsets;
+    Tensor<Index, 1> steps_sizes;
 
-     const Tensor<type, 2> forget_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,0}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));//.get_matrix(0);
-     const Tensor<type, 2> input_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,1}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-     const Tensor<type, 2> state_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,2}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-     const Tensor<type, 2> output_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,3}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-     const Tensor<type, 2> cell_state_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,4}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
+    calculate_steps(instances_number, steps_offsets, steps_sizes);
 
-     const Tensor<type, 2> forget_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,0}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));;
-     const Tensor<type, 2> input_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,1}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-     const Tensor<type, 2> state_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,2}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-     const Tensor<type, 2> output_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,3}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-     const Tensor<type, 2> hidden_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,4}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
+    const Index steps_number = steps_sizes.size();
 
-     Index column_index = 0;
-     Index input_index = 0;
+    const Tensor<type, 2> sorted_inputs = sort_by_timesteps(inputs, steps_offsets, steps_sizes);
 
-     for(Index instance = 0; instance < instances_number; instance++)
-     {
-         const Tensor<type, 1> current_inputs = inputs.chip(instance, 0);
+    const Tensor<type, 2> sorted_deltas = sort_by_timesteps(back_propagation.delta, steps_offsets, steps_sizes);
 
-         const Tensor<type, 1> current_layer_deltas = deltas.chip(instance,0);
+    // Activations and derivatives, ordered by timestep
 
-         const Tensor<type, 1> current_forget_activations = forget_activations.chip(instance, 0);
-         const Tensor<type, 1> current_input_activations = input_activations.chip(instance, 0);
-         const Tensor<type, 1> current_state_activations = state_activations.chip(instance, 0);
-         const Tensor<type, 1> current_output_activations = output_activations.chip(instance, 0);
-         const Tensor<type, 1> current_cell_state_activations = cell_state_activations.chip(instance, 0);
+    type* activations_data = const_cast<type*>(forward_propagation.activations_3d.data());
+    type* activations_derivatives_data = const_cast<type*>(forward_propagation.activations_derivatives_3d.data());
 
-         const Tensor<type, 1> current_forget_derivatives = forget_derivatives.chip(instance, 0);
-         const Tensor<type, 1> current_input_derivatives = input_derivatives.chip(instance, 0);
-         const Tensor<type, 1> current_state_derivatives = state_derivatives.chip(instance, 0);
-         const Tensor<type, 1> current_output_derivatives = output_derivatives.chip(instance, 0);
-         const Tensor<type, 1> current_hidden_derivatives = hidden_derivatives.chip(instance, 0);
+    const TensorMap<Tensor<type, 2>> forget_activations(activations_data, instances_number, neurons_number);
+    const TensorMap<Tensor<type, 2>> input_activations(activations_data + instances_number*neurons_number, instances_number, neurons_number);
+    const TensorMap<Tensor<type, 2>> state_activations(activations_data + 2*instances_number*neurons_number, instances_number, neurons_number);
+    const TensorMap<Tensor<type, 2>> output_activations(activations_data + 3*instances_number*neurons_number, instances_number, neurons_number);
+    const TensorMap<Tensor<type, 2>> cell_states(activations_data + 4*instances_number*neurons_number, instances_number, neurons_number);
+    const TensorMap<Tensor<type, 2>> cell_states_activations(activations_data + 5*instances_number*neurons_number, instances_number, neurons_number);
 
-         Tensor<type, 1> previous_cell_state_activations(neurons_number);
-         previous_cell_state_activations.setZero();
+    const TensorMap<Tensor<type, 2>> forget_derivatives(activations_derivatives_data, instances_number, neurons_number);
+    const TensorMap<Tensor<type, 2>> input_derivatives(activations_derivatives_data + instances_number*neurons_number, instances_number, neurons_number);
+    const TensorMap<Tensor<type, 2>> state_derivatives(activations_derivatives_data + 2*instances_number*neurons_number, instances_number, neurons_number);
+    const TensorMap<Tensor<type, 2>> output_derivatives(activations_derivatives_data + 3*instances_number*neurons_number, instances_number, neurons_number);
+    const TensorMap<Tensor<type, 2>> cell_states_derivatives(activations_derivatives_data + 4*instances_number*neurons_number, instances_number, neurons_number);
 
-         if(instance%timesteps == 0)
-         {
-             forget_combinations_weights_derivatives.setZero();
-             input_combinations_weights_derivatives.setZero();
-             output_combinations_weights_derivatives.setZero();
-             state_combinations_weights_derivatives.setZero();
+    // Derivatives of the error with respect to the combinations of the four gates
 
-             cell_state_weights_derivatives.setZero();
-         }
-         else
-         {
-             previous_cell_state_activations = cell_state_activations.chip(instance-1, 0);
+    Tensor<type, 2> combinations_derivatives(instances_number, 4*neurons_number);
 
-             forget_combinations_weights_derivatives = hidden_states_weights_derivatives.contract(forget_recurrent_weights, A_B);
-             input_combinations_weights_derivatives = multiply_rows(hidden_states_weights_derivatives.contract(input_recurrent_weights, A_B), current_input_derivatives);
-             state_combinations_weights_derivatives = multiply_rows(hidden_states_weights_derivatives.contract(state_recurrent_weights, A_B), current_state_derivatives);
-             output_combinations_weights_derivatives = multiply_rows(hidden_states_weights_derivatives.contract(output_recurrent_weights, A_B), current_output_derivatives);
-         }
+    Tensor<type, 2> next_hidden_states_derivatives;
+    Tensor<type, 2> next_cell_states_derivatives;
 
-         column_index = 0;
-         input_index = 0;
-
-         for(Index i = 0; i < parameters_number; i++)
-         {
-             forget_combinations_weights_derivatives(i, column_index) += current_inputs(input_index);
-
-             input_index++;
-
-             if(input_index == inputs_number)
-             {
-                 input_index = 0;
-                 column_index++;
-             }
-         }
-
-         cell_state_weights_derivatives = multiply_rows(cell_state_weights_derivatives, current_forget_activations);//cell_state_weights_derivatives.multiply_rows(current_forget_activations);
-         cell_state_weights_derivatives += multiply_rows(input_combinations_weights_derivatives, current_state_activations);//input_combinations_weights_derivatives.multiply_rows(current_state_activations);
-         cell_state_weights_derivatives += multiply_rows(state_combinations_weights_derivatives, current_input_activations);//state_combinations_weights_derivatives.multiply_rows(current_input_activations);
-         cell_state_weights_derivatives += multiply_rows(forget_combinations_weights_derivatives, (current_forget_derivatives*previous_cell_state_activations));
+    for(Index t = steps_number-1; t >= 0; t--)
+    {
+        const Index offset = steps_offsets(t);
+        const Index size = steps_sizes(t);
 
-         hidden_states_weights_derivatives = multiply_rows(output_combinations_weights_derivatives, calculate_activations(current_cell_state_activations));
-         hidden_states_weights_derivatives += multiply_rows(cell_state_weights_derivatives, current_output_activations*current_hidden_derivatives);
+        const Eigen::array<Index, 2> step_offsets({offset, 0});
+        const Eigen::array<Index, 2> step_extents({size, neurons_number});
 
-         forget_weights_error_gradient += hidden_states_weights_derivatives.contract(current_layer_deltas, A_BT);
-     }
+        Tensor<type, 2> hidden_states_derivatives = sorted_deltas.slice(step_offsets, step_extents);
 
-     return forget_weights_error_gradient;
-}
+        if(t != steps_number-1)
+        {
+            const Eigen::array<Index, 2> next_extents({steps_sizes(t+1), neurons_number});
 
+            hidden_states_derivatives.slice(Eigen::array<Index, 2>({0, 0}), next_extents) += next_hidden_states_derivatives;
+        }
 
+        Tensor<type, 2> current_cell_states_derivatives(size, neurons_number);
 
-Tensor<type, 1> LongShortTermMemoryLayer::calculate_input_weights_error_gradient(const Tensor<type, 2>& inputs,
-        const Layer::ForwardPropagation& forward_propagation,
-        const Tensor<type, 2>& deltas,
-        const Tensor<type, 3>& activations_states)
-{
+        current_cell_states_derivatives.device(*thread_pool_device) = hidden_states_derivatives
+                * output_activations.slice(step_offsets, step_extents)
+                * cell_states_derivatives.slice(step_offsets, step_extents);
 
-    const Index instances_number = inputs.dimension(0);
-    const Index inputs_number = get_inputs_number();
-    const Index neurons_number = get_neurons_number();
-    const Index parameters_number = inputs_number*neurons_number;
+        if(t != steps_number-1)
+        {
+            const Eigen::array<Index, 2> next_extents({steps_sizes(t+1), neurons_number});
 
-    Tensor<type, 1> input_weights_error_gradient(parameters_number);
-    input_weights_error_gradient.setZero();
+            current_cell_states_derivatives.slice(Eigen::array<Index, 2>({0, 0}), next_extents) += next_cell_states_derivatives;
+        }
 
-    Tensor<type, 2> input_combinations_weights_derivatives(parameters_number, neurons_number);
-    Tensor<type, 2> forget_combinations_weights_derivatives(parameters_number, neurons_number);
-    Tensor<type, 2> state_combinations_weights_derivatives(parameters_number, neurons_number);
-    Tensor<type, 2> output_combinations_weights_derivatives(parameters_number, neurons_number);
+        // Forget gate
 
-    Tensor<type, 2> hidden_states_weights_derivatives(parameters_number, neurons_number);
-    Tensor<type, 2> cell_state_weights_derivatives(parameters_number, neurons_number);
+        if(t != 0)
+        {
+            const Eigen::array<Index, 2> previous_offsets({steps_offsets(t-1), 0});
 
-    const Tensor<type, 2> forget_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,0}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));//.get_matrix(0);
-    const Tensor<type, 2> input_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,1}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> state_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,2}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> output_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,3}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> cell_state_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,4}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
+            combinations_derivatives.slice(step_offsets, step_extents).device(*thread_pool_device)
+                    = current_cell_states_derivatives
+                    * cell_states.slice(previous_offsets, step_extents)
+                    * forget_derivatives.slice(step_offsets, step_extents);
+        }
+        else
+        {
+            combinations_derivatives.slice(step_offsets, step_extents).setZero();
+        }
 
-    const Tensor<type, 2> forget_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,0}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));;
-    const Tensor<type, 2> input_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,1}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> state_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,2}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> output_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,3}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> hidden_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,4}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
+        // Input gate
 
-    Index column_index = 0;
-    Index input_index = 0;
+        combinations_derivatives.slice(Eigen::array<Index, 2>({offset, neurons_number}), step_extents).device(*thread_pool_device)
+                = current_cell_states_derivatives
+                * state_activations.slice(step_offsets, step_extents)
+                * input_derivatives.slice(step_offsets, step_extents);
 
-    for(Index instance = 0; instance < instances_number; instance++)
-    {
-        const Tensor<type, 1> current_inputs = inputs.chip(instance, 0);
+        // State gate
 
-        const Tensor<type, 1> current_layer_deltas = deltas.chip(instance, 0);
+        combinations_derivatives.slice(Eigen::array<Index, 2>({offset, 2*neurons_number}), step_extents).device(*thread_pool_device)
+                = current_cell_states_derivatives
+                * input_activations.slice(step_offsets, step_extents)
+                * state_derivatives.slice(step_offsets, step_extents);
 
-        const Tensor<type, 1> current_forget_activations = forget_activations.chip(instance, 0);
-        const Tensor<type, 1> current_input_activations = input_activations.chip(instance, 0);
-        const Tensor<type, 1> current_state_activations = state_activations.chip(instance, 0);
-        const Tensor<type, 1> current_output_activations = output_activations.chip(instance, 0);
-        const Tensor<type, 1> current_cell_state_activations = cell_state_activations.chip(instance, 0);
+        // Output gate
 
-        const Tensor<type, 1> current_forget_derivatives = forget_derivatives.chip(instance, 0);
-        const Tensor<type, 1> current_input_derivatives = input_derivatives.chip(instance, 0);
-        const Tensor<type, 1> current_state_derivatives = state_derivatives.chip(instance, 0);
-        const Tensor<type, 1> current_output_derivatives = output_derivatives.chip(instance, 0);
-        const Tensor<type, 1> current_hidden_derivatives = hidden_derivatives.chip(instance, 0);
+        combinations_derivatives.slice(Eigen::array<Index, 2>({offset, 3*neurons_number}), step_extents).device(*thread_pool_device)
+                = hidden_states_derivatives
+                * cell_states_activations.slice(step_offsets, step_extents)
+                * output_derivatives.slice(step_offsets, step_extents);
 
-        Tensor<type, 1> previous_cell_state_activations(neurons_number);
-        previous_cell_state_activations.setZero();
+        // Derivatives with respect to the previous hidden and cell states
 
-        if(instance%timesteps == 0)
+        if(t != 0)
         {
-            forget_combinations_weights_derivatives.setZero();
-            input_combinations_weights_derivatives.setZero();
-            output_combinations_weights_derivatives.setZero();
-            state_combinations_weights_derivatives.setZero();
+            next_hidden_states_derivatives.resize(size, neurons_number);
 
-            cell_state_weights_derivatives.setZero();
-        }
-        else
-        {
-            previous_cell_state_activations = cell_state_activations.chip(instance-1, 0);
+            next_hidden_states_derivatives.device(*thread_pool_device)
+                    = combinations_derivatives.slice(Eigen::array<Index, 2>({offset, 0}), Eigen::array<Index, 2>({size, 4*neurons_number}))
+                    .contract(recurrent_weights, A_BT);
+
+            next_cell_states_derivatives.resize(size, neurons_number);
 
-            forget_combinations_weights_derivatives = multiply_rows(hidden_states_weights_derivatives.contract(forget_recurrent_weights, A_B), current_forget_derivatives);
-            input_combinations_weights_derivatives = hidden_states_weights_derivatives.contract(input_recurrent_weights, A_B);
-            state_combinations_weights_derivatives = multiply_rows(hidden_states_weights_derivatives.contract(state_recurrent_weights, A_B),current_state_derivatives);
-            output_combinations_weights_derivatives = multiply_rows(hidden_states_weights_derivatives.contract(output_recurrent_weights, A_B), current_output_derivatives);
+            next_cell_states_derivatives.device(*thread_pool_device)
+                    = current_cell_states_derivatives*forget_activations.slice(step_offsets, step_extents);
         }
+    }
 
-        column_index = 0;
-        input_index = 0;
+    // Hidden states of the previous timestep, which are zero for the first timestep
 
-        for(Index i = 0; i < parameters_number; i++)
-        {
-            input_combinations_weights_derivatives(i, column_index) += current_inputs[input_index];
+    Tensor<type, 2> previous_hidden_states(instances_number, neurons_number);
 
-            input_index++;
+    previous_hidden_states.setZero();
 
-            if(input_index == inputs_number)
-            {
-                input_index = 0;
-                column_index++;
-            }
-        }
+    for(Index t = 1; t < steps_number; t++)
+    {
+        const Eigen::array<Index, 2> step_extents({steps_sizes(t), neurons_number});
+        const Eigen::array<Index, 2> previous_offsets({steps_offsets(t-1), 0});
 
-        cell_state_weights_derivatives = multiply_rows(cell_state_weights_derivatives, current_forget_activations);//cell_state_weights_derivatives.multiply_rows(current_forget_activations);
-        cell_state_weights_derivatives += multiply_rows(forget_combinations_weights_derivatives, previous_cell_state_activations);//input_combinations_weights_derivatives.multiply_rows(current_state_activations);
-        cell_state_weights_derivatives += multiply_rows(state_combinations_weights_derivatives, current_input_activations);//state_combinations_weights_derivatives.multiply_rows(current_input_activations);
-        cell_state_weights_derivatives += multiply_rows(input_combinations_weights_derivatives, (current_input_derivatives*current_state_activations));
+        previous_hidden_states.slice(Eigen::array<Index, 2>({steps_offsets(t), 0}), step_extents).device(*thread_pool_device)
+                = output_activations.slice(previous_offsets, step_extents)*cell_states_activations.slice(previous_offsets, step_extents);
+    }
 
-        hidden_states_weights_derivatives = multiply_rows(output_combinations_weights_derivatives, calculate_activations(current_cell_state_activations));
-        hidden_states_weights_derivatives += multiply_rows(cell_state_weights_derivatives, current_output_activations*current_hidden_derivatives);
+    back_propagation.biases_derivatives.device(*thread_pool_device)
+            = combinations_derivatives.sum(Eigen::array<Index, 1>({0}));
 
-        input_weights_error_gradient += hidden_states_weights_derivatives.contract(current_layer_deltas, A_BT);
-    }
+    back_propagation.synaptic_weights_derivatives.device(*thread_pool_device)
+            = sorted_inputs.contract(combinations_derivatives, AT_B);
 
-    return input_weights_error_gradient;
+    back_propagation.recurrent_weights_derivatives.device(*thread_pool_device)
+            = previous_hidden_states.contract(combinations_derivatives, AT_B);
 }
 
 
-Tensor<type, 1> LongShortTermMemoryLayer::calculate_state_weights_error_gradient(const Tensor<type, 2>& inputs,
-        const Layer::ForwardPropagation& forward_propagation,
-        const Tensor<type, 2>& deltas,
-        const Tensor<type, 3>& activations_states)
-{
+/// Returns the derivatives of the error with respect to the parameters of the layer, in the same order as get_parameters().
+/// @param inputs Inputs to the layer, where each sequence is made of timesteps consecutive rows.
+/// @param deltas Derivatives of the error with respect to the outputs of the layer.
 
+Tensor<type, 1> LongShortTermMemoryLayer::calculate_error_gradient(const Tensor<type, 2>& inputs, const Tensor<type, 2>& deltas)
+{
     const Index instances_number = inputs.dimension(0);
-    const Index inputs_number = get_inputs_number();
-    const Index neurons_number = get_neurons_number();
-    const Index parameters_number = inputs_number*neurons_number;
 
-    Tensor<type, 1> state_weights_error_gradient(parameters_number);
-    state_weights_error_gradient.setZero();
+    ForwardPropagation forward_propagation(instances_number, this);
 
-    Tensor<type, 2> input_combinations_weights_derivatives(parameters_number, neurons_number);
-    Tensor<type, 2> forget_combinations_weights_derivatives(parameters_number, neurons_number);
-    Tensor<type, 2> state_combinations_weights_derivatives(parameters_number, neurons_number);
-    Tensor<type, 2> output_combinations_weights_derivatives(parameters_number, neurons_number);
+    forward_propagate(inputs, forward_propagation);
 
-    Tensor<type, 2> hidden_states_weights_derivatives(parameters_number, neurons_number);
-    Tensor<type, 2> cell_state_weights_derivatives(parameters_number, neurons_number);
+    BackPropagation back_propagation(instances_number, this);
 
-    const Tensor<type, 2> forget_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,0}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));//.get_matrix(0);
-    const Tensor<type, 2> input_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,1}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> state_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,2}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> output_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,3}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> cell_state_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,4}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
+    back_propagation.delta = deltas;
 
-    const Tensor<type, 2> forget_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,0}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));;
-    const Tensor<type, 2> input_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,1}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> state_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,2}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> output_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,3}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> hidden_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,4}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
+    calculate_error_gradient(inputs, forward_propagation, back_propagation);
 
-    Index column_index = 0;
-    Index input_index = 0;
+    Tensor<type, 1> error_gradient(get_parameters_number());
 
-    for(Index instance = 0; instance < instances_number; instance++)
-    {
-        const Tensor<type, 1> current_inputs = inputs.chip(instance, 0);
+    insert_gradient(back_propagation, 0, error_gradient);
 
-        const Tensor<type, 1> current_layer_deltas = deltas.chip(instance, 0);
+    return error_gradient;
+}
 
-        const Tensor<type, 1> current_forget_activations = forget_activations.chip(instance, 0);
-        const Tensor<type, 1> current_input_activations = input_activations.chip(instance, 0);
-        const Tensor<type, 1> current_state_activations = state_activations.chip(instance, 0);
-        const Tensor<type, 1> current_output_activations = output_activations.chip(instance, 0);
-        const Tensor<type, 1> current_cell_state_activations = cell_state_activations.chip(instance, 0);
 
-        const Tensor<type, 1> current_forget_derivatives = forget_derivatives.chip(instance, 0);
-        const Tensor<type, 1> current_input_derivatives = input_derivatives.chip(instance, 0);
-        const Tensor<type, 1> current_state_derivatives = state_derivatives.chip(instance, 0);
-        const Tensor<type, 1> current_output_derivatives = output_derivatives.chip(instance, 0);
-        const Tensor<type, 1> current_hidden_derivatives = hidden_derivatives.chip(instance, 0);
+/// Copies the derivatives of the error with respect to the parameters of the layer into the gradient.
+/// The order is the same as in get_parameters(): weights, recurrent weights and biases.
+/// @param back_propagation Structure with the derivatives of the layer.
+/// @param index Position of the first parameter of the layer in the gradient.
+/// @param gradient Gradient of the whole neural network.
 
-        Tensor<type, 1> previous_cell_state_activations(neurons_number);
-        previous_cell_state_activations.setZero();
+void LongShortTermMemoryLayer::insert_gradient(const BackPropagation& back_propagation, const Index& index, Tensor<type, 1>& gradient) const
+{
+    const Index weights_number = back_propagation.synaptic_weights_derivatives.size();
+    const Index recurrent_weights_number = back_propagation.recurrent_weights_derivatives.size();
+    const Index biases_number = back_propagation.biases_derivatives.size();
 
-        if(instance%timesteps == 0)
-        {
-            forget_combinations_weights_derivatives.setZero();
-            input_combinations_weights_derivatives.setZero();
-            output_combinations_weights_derivatives.setZero();
-            state_combinations_weights_derivatives.setZero();
+    memcpy(gradient.data() + index,
+           back_propagation.synaptic_weights_derivatives.data(),
+           static_cast<size_t>(weights_number)*sizeof(type));
 
-            cell_state_weights_derivatives.setZero();
-        }
-        else
-        {
-            previous_cell_state_activations = cell_state_activations.chip(instance-1, 0);
+    memcpy(gradient.data() + index + weights_number,
+           back_propagation.recurrent_weights_derivatives.data(),
+           static_cast<size_t>(recurrent_weights_number)*sizeof(type));
 
-            forget_combinations_weights_derivatives = multiply_rows(hidden_states_weights_derivatives.contract(forget_recurrent_weights, A_B), current_forget_derivatives);
-            input_combinations_weights_derivatives = multiply_rows(hidden_states_weights_derivatives.contract(input_recurrent_weights, A_B), current_input_derivatives);
-            state_combinations_weights_derivatives = hidden_states_weights_derivatives.contract(state_recurrent_weights, A_B);
-            output_combinations_weights_derivatives = multiply_rows(hidden_states_weights_derivatives.contract(output_recurrent_weights, A_B), current_output_derivatives);
-        }
+    memcpy(gradient.data() + index + weights_number + recurrent_weights_number,
+           back_propagation.biases_derivatives.data(),
+           static_cast<size_t>(biases_number)*sizeof(type));
+}
 
-        column_index = 0;
-        input_index = 0;
 
-        for(Index i = 0; i < parameters_number; i++)
-        {
-            state_combinations_weights_derivatives(i, column_index) += current_inputs[input_index];
+/// Calculates the rows of each timestep when the instances are ordered by timestep.
+/// Each sequence is made of timesteps consecutive instances, and the last sequence might be shorter.
+/// @param instances_number Number of instances.
+/// @param steps_offsets Position of the first row of each timestep.
+/// @param steps_sizes Number of sequences which reach each timestep.
 
-            input_index++;
+void LongShortTermMemoryLayer::calculate_steps(const Index& instances_number,
+                                               Tensor<Index, 1>& steps_offsets,
+                                               Tensor<Index, 1>& steps_sizes) const
+{
+    const Index steps_number = min(timesteps, instances_number);
 
-            if(input_index == inputs_number)
-            {
-                input_index = 0;
-                column_index++;
-            }
-        }
+    steps_offsets.resize(steps_number);
+    steps_sizes.resize(steps_number);
 
-        cell_state_weights_derivatives = multiply_rows(cell_state_weights_derivatives, current_forget_activations);//cell_state_weights_derivatives.multiply_rows(current_forget_activations);
-        cell_state_weights_derivatives += multiply_rows(forget_combinations_weights_derivatives, previous_cell_state_activations);//input_combinations_weights_derivatives.multiply_rows(current_state_activations);
-        cell_state_weights_derivatives += multiply_rows(input_combinations_weights_derivatives, current_state_activations);//state_combinations_weights_derivatives.multiply_rows(current_input_activations);
-        cell_state_weights_derivatives += multiply_rows(state_combinations_weights_derivatives, (current_state_derivatives*current_input_activations));
+    Index offset = 0;
 
-        hidden_states_weights_derivatives = multiply_rows(output_combinations_weights_derivatives, calculate_activations(current_cell_state_activations));
-        hidden_states_weights_derivatives += multiply_rows(cell_state_weights_derivatives, current_output_activations*current_hidden_derivatives);
+    for(Index t = 0; t < steps_number; t++)
+    {
+        steps_offsets(t) = offset;
+        steps_sizes(t) = (instances_number - 1 - t)/timesteps + 1;
 
-        state_weights_error_gradient += hidden_states_weights_derivatives.contract(current_layer_deltas, A_BT);
+        offset += steps_sizes(t);
     }
-
-    return state_weights_error_gradient;
-
 }
 
 
-Tensor<type, 1> LongShortTermMemoryLayer::calculate_output_weights_error_gradient(const Tensor<type, 2>& inputs,
-        const Layer::ForwardPropagation& forward_propagation,
-        const Tensor<type, 2>& deltas,
-        const Tensor<type, 3>& activations_states)
-{
-
-     const Index instances_number = inputs.dimension(0);
-     const Index inputs_number = get_inputs_number();
-     const Index neurons_number = get_neurons_number();
-     const Index parameters_number = inputs_number*neurons_number;
+/// Returns the rows of a matrix ordered by timestep instead of by sequence,
+/// so that the rows of all the sequences at the same timestep are contiguous.
+/// @param matrix Matrix with one row for each instance.
+/// @param steps_offsets Position of the first row of each timestep.
+/// @param steps_sizes Number of sequences which reach each timestep.
 
-     Tensor<type, 1> output_weights_error_gradient(parameters_number);
-     output_weights_error_gradient.setZero();
-
-     Tensor<type, 2> input_combinations_weights_derivatives(parameters_number, neurons_number);
-     Tensor<type, 2> forget_combinations_weights_derivatives(parameters_number, neurons_number);
-     Tensor<type, 2> state_combinations_weights_derivatives(parameters_number, neurons_number);
-     Tensor<type, 2> output_combinations_weights_derivatives(parameters_number, neurons_number);
-
-     Tensor<type, 2> hidden_states_weights_derivatives(parameters_number, neurons_number);
-     Tensor<type, 2> cell_state_weights_derivatives(parameters_number, neurons_number);
-
-     const Tensor<type, 2> forget_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,0}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));//.get_matrix(0);
-     const Tensor<type, 2> input_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,1}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-     const Tensor<type, 2> state_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,2}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-     const Tensor<type, 2> output_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,3}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-     const Tensor<type, 2> cell_state_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,4}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-
-     const Tensor<type, 2> forget_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,0}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));;
-     const Tensor<type, 2> input_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,1}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-     const Tensor<type, 2> state_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,2}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-     const Tensor<type, 2> output_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,3}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-     const Tensor<type, 2> hidden_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,4}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-
-     Index column_index = 0;
-     Index input_index = 0;
-
-     for(Index instance = 0; instance < instances_number; instance++)
-     {
-         const Tensor<type, 1> current_inputs = inputs.chip(instance, 0);
-
-         const Tensor<type, 1> current_layer_deltas = deltas.chip(instance, 0);
-
-         const Tensor<type, 1> current_forget_activations = forget_activations.chip(instance, 0);
-         const Tensor<type, 1> current_input_activations = input_activations.chip(instance, 0);
-         const Tensor<type, 1> current_state_activations = state_activations.chip(instance, 0);
-         const Tensor<type, 1> current_output_activations = output_activations.chip(instance, 0);
-         const Tensor<type, 1> current_cell_state_activations = cell_state_activations.chip(instance, 0);
-
-         const Tensor<type, 1> current_forget_derivatives = forget_derivatives.chip(instance, 0);
-         const Tensor<type, 1> current_input_derivatives = input_derivatives.chip(instance, 0);
-         const Tensor<type, 1> current_state_derivatives = state_derivatives.chip(instance, 0);
-         const Tensor<type, 1> current_output_derivatives = output_derivatives.chip(instance, 0);
-         const Tensor<type, 1> current_hidden_derivatives = hidden_derivatives.chip(instance, 0);
-
-         Tensor<type, 1> previous_cell_state_activations(neurons_number);
-         previous_cell_state_activations.setZero();
-
-         if(instance%timesteps == 0)
-         {
-             forget_combinations_weights_derivatives.setZero();
-             input_combinations_weights_derivatives.setZero();
-             output_combinations_weights_derivatives.setZero();
-             state_combinations_weights_derivatives.setZero();
-
-             cell_state_weights_derivatives.setZero();
-         }
-         else
-         {
-             previous_cell_state_activations = cell_state_activations.chip(instance-1, 0);
-
-             forget_combinations_weights_derivatives = multiply_rows(hidden_states_weights_derivatives.contract(forget_recurrent_weights, A_B), current_forget_derivatives);
-             input_combinations_weights_derivatives = multiply_rows(hidden_states_weights_derivatives.contract(input_recurrent_weights, A_B), current_input_derivatives);
-             state_combinations_weights_derivatives = multiply_rows(hidden_states_weights_derivatives.contract(state_recurrent_weights, A_B), current_state_derivatives);
-             output_combinations_weights_derivatives = hidden_states_weights_derivatives.contract(output_recurrent_weights, A_B);
-         }
-
-         column_index = 0;
-         input_index = 0;
-
-         for(Index i = 0; i < parameters_number; i++)
-         {
-             output_combinations_weights_derivatives(i, column_index) += current_inputs[input_index];
-
-             input_index++;
-
-             if(input_index == inputs_number)
-             {
-                 input_index = 0;
-                 column_index++;
-             }
-         }
-
-         cell_state_weights_derivatives = multiply_rows(cell_state_weights_derivatives, current_forget_activations);//cell_state_weights_derivatives.multiply_rows(current_forget_activations);
-         cell_state_weights_derivatives += multiply_rows(forget_combinations_weights_derivatives, previous_cell_state_activations);//input_combinations_weights_derivatives.multiply_rows(current_state_activations);
-         cell_state_weights_derivatives += multiply_rows(state_combinations_weights_derivatives, current_input_activations);//state_combinations_weights_derivatives.multiply_rows(current_input_activations);
-         cell_state_weights_derivatives += multiply_rows(input_combinations_weights_derivatives, current_state_activations);
-
-         hidden_states_weights_derivatives = multiply_rows(output_combinations_weights_derivatives, current_output_derivatives*calculate_activations(current_cell_state_activations));
-         hidden_states_weights_derivatives += multiply_rows(cell_state_weights_derivatives, current_output_activations*current_hidden_derivatives);
-
-         output_weights_error_gradient += hidden_states_weights_derivatives.contract(current_layer_deltas, A_BT);
-     }
-
-     return output_weights_error_gradient;
-
-}
-
-
-Tensor<type, 1> LongShortTermMemoryLayer::calculate_forget_recurrent_weights_error_gradient(const Tensor<type, 2>& inputs,
-        const Layer::ForwardPropagation& forward_propagation,
-        const Tensor<type, 2>& deltas,
-        const Tensor<type, 3>& activations_states)
-{
-
-    const Index instances_number = inputs.dimension(0);
-    const Index neurons_number = get_neurons_number();
-    const Index parameters_number = neurons_number*neurons_number;
-
-    Tensor<type, 1> forget_recurrent_weights_error_gradient(parameters_number);
-    forget_recurrent_weights_error_gradient.setZero();
-
-    Tensor<type, 2> input_combinations_recurrent_weights_derivatives(parameters_number, neurons_number);
-    Tensor<type, 2> forget_combinations_recurrent_weights_derivatives(parameters_number, neurons_number);
-    Tensor<type, 2> state_combinations_recurrent_weights_derivatives(parameters_number, neurons_number);
-    Tensor<type, 2> output_combinations_recurrent_weights_derivatives(parameters_number, neurons_number);
-
-    Tensor<type, 2> hidden_states_recurrent_weights_derivatives(parameters_number, neurons_number);
-    Tensor<type, 2> cell_state_recurrent_weights_derivatives(parameters_number, neurons_number);
-
-    const Tensor<type, 2> forget_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,0}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));//.get_matrix(0);
-    const Tensor<type, 2> input_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,1}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> state_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,2}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> output_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,3}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> cell_state_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,4}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> hidden_state_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,5}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-
-    const Tensor<type, 2> forget_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,0}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));;
-    const Tensor<type, 2> input_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,1}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> state_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,2}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> output_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,3}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> hidden_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,4}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-
-    Index column_index = 0;
-    Index activation_index = 0;
-
-    for(Index instance = 0; instance < instances_number; instance++)
-    {
-        const Tensor<type, 1> current_layer_deltas = deltas.chip(instance, 0);
-
-        const Tensor<type, 1> current_forget_activations = forget_activations.chip(instance, 0);
-        const Tensor<type, 1> current_input_activations = input_activations.chip(instance, 0);
-        const Tensor<type, 1> current_state_activations = state_activations.chip(instance, 0);
-        const Tensor<type, 1> current_output_activations = output_activations.chip(instance, 0);
-        const Tensor<type, 1> current_cell_state_activations = cell_state_activations.chip(instance, 0);
-
-        const Tensor<type, 1> current_forget_derivatives = forget_derivatives.chip(instance, 0);
-        const Tensor<type, 1> current_input_derivatives = input_derivatives.chip(instance, 0);
-        const Tensor<type, 1> current_state_derivatives = state_derivatives.chip(instance, 0);
-        const Tensor<type, 1> current_output_derivatives = output_derivatives.chip(instance, 0);
-        const Tensor<type, 1> current_hidden_derivatives = hidden_derivatives.chip(instance, 0);
-
-        if(instance%timesteps == 0)
-        {
-            cell_state_recurrent_weights_derivatives.setZero();
-            hidden_states_recurrent_weights_derivatives.setZero();
-        }
-        else
-        {
-            const Tensor<type, 1> previous_hidden_state_activations = hidden_state_activations.chip(instance-1, 0);
-
-            const Tensor<type, 1> previous_cell_state_activations = cell_state_activations.chip(instance-1, 0);
-
-            forget_combinations_recurrent_weights_derivatives = hidden_states_recurrent_weights_derivatives.contract(forget_recurrent_weights, A_B);
-            input_combinations_recurrent_weights_derivatives = multiply_rows(hidden_states_recurrent_weights_derivatives.contract(input_recurrent_weights, A_B), current_input_derivatives);
-            state_combinations_recurrent_weights_derivatives = multiply_rows(hidden_states_recurrent_weights_derivatives.contract(state_recurrent_weights, A_B), current_state_derivatives);
-            output_combinations_recurrent_weights_derivatives = multiply_rows(hidden_states_recurrent_weights_derivatives.contract(output_recurrent_weights, A_B), current_output_derivatives);
-
-            column_index = 0;
-            activation_index = 0;
-
-            for(Index i = 0; i < parameters_number; i++)
-            {
-                forget_combinations_recurrent_weights_derivatives(i, column_index) += previous_hidden_state_activations[activation_index];
-
-                activation_index++;
-
-                if(activation_index == neurons_number)
-                {
-                    activation_index = 0;
-                    column_index++;
-                }
-            }
-
-            cell_state_recurrent_weights_derivatives = multiply_rows(cell_state_recurrent_weights_derivatives, current_forget_activations);//cell_state_weights_derivatives.multiply_rows(current_forget_activations);
-            cell_state_recurrent_weights_derivatives += multiply_rows(input_combinations_recurrent_weights_derivatives, current_state_activations);//input_combinations_weights_derivatives.multiply_rows(current_state_activations);
-            cell_state_recurrent_weights_derivatives += multiply_rows(state_combinations_recurrent_weights_derivatives, current_input_activations);//state_combinations_weights_derivatives.multiply_rows(current_input_activations);
-            cell_state_recurrent_weights_derivatives += multiply_rows(forget_combinations_recurrent_weights_derivatives, (current_forget_derivatives*previous_cell_state_activations));
-
-            hidden_states_recurrent_weights_derivatives = multiply_rows(output_combinations_recurrent_weights_derivatives, calculate_activations(current_cell_state_activations));
-            hidden_states_recurrent_weights_derivatives += multiply_rows(cell_state_recurrent_weights_derivatives, current_output_activations*current_hidden_derivatives);
-
-        }
-
-        forget_recurrent_weights_error_gradient += hidden_states_recurrent_weights_derivatives.contract(current_layer_deltas, A_BT);
-    }
-
-    return forget_recurrent_weights_error_gradient;
-
-}
-
-
-Tensor<type, 1> LongShortTermMemoryLayer::calculate_input_recurrent_weights_error_gradient(const Tensor<type, 2>& inputs,
-        const Layer::ForwardPropagation& forward_propagation,
-        const Tensor<type, 2>& deltas,
-        const Tensor<type, 3>& activations_states)
-{
-
-    const Index instances_number = inputs.dimension(0);
-    const Index neurons_number = get_neurons_number();
-    const Index parameters_number = neurons_number*neurons_number;
-
-    Tensor<type, 1> input_recurrent_weights_error_gradient(parameters_number);
-    input_recurrent_weights_error_gradient.setZero();
-
-    Tensor<type, 2> input_combinations_recurrent_weights_derivatives(parameters_number, neurons_number);
-    Tensor<type, 2> forget_combinations_recurrent_weights_derivatives(parameters_number, neurons_number);
-    Tensor<type, 2> state_combinations_recurrent_weights_derivatives(parameters_number, neurons_number);
-    Tensor<type, 2> output_combinations_recurrent_weights_derivatives(parameters_number, neurons_number);
-
-    Tensor<type, 2> hidden_states_recurrent_weights_derivatives(parameters_number, neurons_number);
-    Tensor<type, 2> cell_state_recurrent_weights_derivatives(parameters_number, neurons_number);
-
-    const Tensor<type, 2> forget_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,0}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));//.get_matrix(0);
-    const Tensor<type, 2> input_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,1}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> state_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,2}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> output_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,3}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> cell_state_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,4}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> hidden_state_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,5}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-
-    const Tensor<type, 2> forget_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,0}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));;
-    const Tensor<type, 2> input_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,1}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> state_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,2}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> output_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,3}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> hidden_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,4}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-
-
-    Index column_index = 0;
-    Index activation_index = 0;
-
-    for(Index instance = 0; instance < instances_number; instance++)
-    {
-       const Tensor<type, 1> current_layer_deltas = deltas.chip(instance, 0);
-
-       const Tensor<type, 1> current_forget_activations = forget_activations.chip(instance, 0);
-       const Tensor<type, 1> current_input_activations = input_activations.chip(instance, 0);
-       const Tensor<type, 1> current_state_activations = state_activations.chip(instance, 0);
-       const Tensor<type, 1> current_output_activations = output_activations.chip(instance, 0);
-       const Tensor<type, 1> current_cell_state_activations = cell_state_activations.chip(instance, 0);
-
-       const Tensor<type, 1> current_forget_derivatives = forget_derivatives.chip(instance, 0);
-       const Tensor<type, 1> current_input_derivatives = input_derivatives.chip(instance, 0);
-       const Tensor<type, 1> current_state_derivatives = state_derivatives.chip(instance, 0);
-       const Tensor<type, 1> current_output_derivatives = output_derivatives.chip(instance, 0);
-       const Tensor<type, 1> current_hidden_derivatives = hidden_derivatives.chip(instance, 0);
-
-       if(instance%timesteps == 0)
-       {
-           cell_state_recurrent_weights_derivatives.setZero();
-           hidden_states_recurrent_weights_derivatives.setZero();
-       }
-       else
-       {
-           const Tensor<type, 1> previous_hidden_state_activations = hidden_state_activations.chip(instance-1, 0);
-           const Tensor<type, 1> previous_cell_state_activations = cell_state_activations.chip(instance-1, 0);
-
-           forget_combinations_recurrent_weights_derivatives = multiply_rows(hidden_states_recurrent_weights_derivatives.contract(forget_recurrent_weights, A_B), current_forget_derivatives);
-           input_combinations_recurrent_weights_derivatives = hidden_states_recurrent_weights_derivatives.contract(input_recurrent_weights, A_B);
-           state_combinations_recurrent_weights_derivatives = multiply_rows(hidden_states_recurrent_weights_derivatives.contract(state_recurrent_weights, A_B), current_state_derivatives);
-           output_combinations_recurrent_weights_derivatives = multiply_rows(hidden_states_recurrent_weights_derivatives.contract(output_recurrent_weights, A_B), current_output_derivatives);
-
-           column_index = 0;
-           activation_index = 0;
-
-           for(Index i = 0; i < parameters_number; i++)
-           {
-               input_combinations_recurrent_weights_derivatives(i, column_index) += previous_hidden_state_activations[activation_index];
-
-               activation_index++;
-
-               if(activation_index == neurons_number)
-               {
-                   activation_index = 0;
-                   column_index++;
-               }
-           }
-
-           cell_state_recurrent_weights_derivatives = multiply_rows(cell_state_recurrent_weights_derivatives, current_forget_activations);//cell_state_weights_derivatives.multiply_rows(current_forget_activations);
-           cell_state_recurrent_weights_derivatives += multiply_rows(input_combinations_recurrent_weights_derivatives, current_input_derivatives*current_state_activations);//input_combinations_weights_derivatives.multiply_rows(current_state_activations);
-           cell_state_recurrent_weights_derivatives += multiply_rows(state_combinations_recurrent_weights_derivatives, current_input_activations);//state_combinations_weights_derivatives.multiply_rows(current_input_activations);
-           cell_state_recurrent_weights_derivatives += multiply_rows(forget_combinations_recurrent_weights_derivatives, previous_cell_state_activations);
-
-           hidden_states_recurrent_weights_derivatives = multiply_rows(output_combinations_recurrent_weights_derivatives, calculate_activations(current_cell_state_activations));
-           hidden_states_recurrent_weights_derivatives += multiply_rows(cell_state_recurrent_weights_derivatives, current_output_activations*current_hidden_derivatives);
-
-       }
-
-       input_recurrent_weights_error_gradient += hidden_states_recurrent_weights_derivatives.contract(current_layer_deltas, A_BT);
-    }
-
-    return input_recurrent_weights_error_gradient;
-
-}
-
-
-Tensor<type, 1> LongShortTermMemoryLayer::calculate_state_recurrent_weights_error_gradient(const Tensor<type, 2>& inputs,
-        const Layer::ForwardPropagation& forward_propagation,
-        const Tensor<type, 2>& deltas,
-        const Tensor<type, 3>& activations_states)
-{
-
-    const Index instances_number = inputs.dimension(0);
-    const Index neurons_number = get_neurons_number();
-    const Index parameters_number = neurons_number*neurons_number;
-
-    Tensor<type, 1> state_recurrent_weights_error_gradient(parameters_number);
-
-    Tensor<type, 2> input_combinations_recurrent_weights_derivatives(parameters_number, neurons_number);
-    Tensor<type, 2> forget_combinations_recurrent_weights_derivatives(parameters_number, neurons_number);
-    Tensor<type, 2> state_combinations_recurrent_weights_derivatives(parameters_number, neurons_number);
-    Tensor<type, 2> output_combinations_recurrent_weights_derivatives(parameters_number, neurons_number);
-
-    Tensor<type, 2> hidden_states_recurrent_weights_derivatives(parameters_number, neurons_number);
-    Tensor<type, 2> cell_state_recurrent_weights_derivatives(parameters_number, neurons_number);
-
-    const Tensor<type, 2> forget_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,0}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));//.get_matrix(0);
-    const Tensor<type, 2> input_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,1}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> state_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,2}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> output_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,3}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> cell_state_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,4}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> hidden_state_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,5}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-
-    const Tensor<type, 2> forget_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,0}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));;
-    const Tensor<type, 2> input_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,1}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> state_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,2}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> output_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,3}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> hidden_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,4}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-
-
-    Index column_index = 0;
-    Index activation_index = 0;
-
-    for(Index instance = 0; instance < instances_number; instance++)
-    {
-       const Tensor<type, 1> current_layer_deltas = deltas.chip(instance, 0);
-
-       const Tensor<type, 1> current_forget_activations = forget_activations.chip(instance, 0);
-       const Tensor<type, 1> current_input_activations = input_activations.chip(instance, 0);
-       const Tensor<type, 1> current_state_activations = state_activations.chip(instance, 0);
-       const Tensor<type, 1> current_output_activations = output_activations.chip(instance, 0);
-       const Tensor<type, 1> current_cell_state_activations = cell_state_activations.chip(instance, 0);
-
-       const Tensor<type, 1> current_forget_derivatives = forget_derivatives.chip(instance, 0);
-       const Tensor<type, 1> current_input_derivatives = input_derivatives.chip(instance, 0);
-       const Tensor<type, 1> current_state_derivatives = state_derivatives.chip(instance, 0);
-       const Tensor<type, 1> current_output_derivatives = output_derivatives.chip(instance, 0);
-       const Tensor<type, 1> current_hidden_derivatives = hidden_derivatives.chip(instance, 0);
-
-       if(instance%timesteps == 0)
-       {
-           cell_state_recurrent_weights_derivatives.setZero();
-           hidden_states_recurrent_weights_derivatives.setZero();
-       }
-       else
-       {
-           const Tensor<type, 1> previous_hidden_state_activations = hidden_state_activations.chip(instance-1, 0);
-           const Tensor<type, 1> previous_cell_state_activations = cell_state_activations.chip(instance-1, 0);
-
-           forget_combinations_recurrent_weights_derivatives = multiply_rows(hidden_states_recurrent_weights_derivatives.contract(forget_recurrent_weights, A_B), current_forget_derivatives);
-           input_combinations_recurrent_weights_derivatives = multiply_rows(hidden_states_recurrent_weights_derivatives.contract(input_recurrent_weights, A_B), current_input_derivatives);
-           state_combinations_recurrent_weights_derivatives = hidden_states_recurrent_weights_derivatives.contract(state_recurrent_weights, A_B);
-           output_combinations_recurrent_weights_derivatives = multiply_rows(hidden_states_recurrent_weights_derivatives.contract(output_recurrent_weights, A_B), current_output_derivatives);
-
-           column_index = 0;
-           activation_index = 0;
-
-           for(Index i = 0; i < parameters_number; i++)
-           {
-               state_combinations_recurrent_weights_derivatives(i, column_index) += previous_hidden_state_activations[activation_index];
-
-               activation_index++;
-
-               if(activation_index == neurons_number)
-               {
-                   activation_index = 0;
-                   column_index++;
-               }
-           }
-
-           cell_state_recurrent_weights_derivatives = multiply_rows(cell_state_recurrent_weights_derivatives, current_forget_activations);//cell_state_weights_derivatives.multiply_rows(current_forget_activations);
-           cell_state_recurrent_weights_derivatives += multiply_rows(input_combinations_recurrent_weights_derivatives, current_state_activations);//input_combinations_weights_derivatives.multiply_rows(current_state_activations);
-           cell_state_recurrent_weights_derivatives += multiply_rows(state_combinations_recurrent_weights_derivatives, current_state_derivatives*current_input_activations);//state_combinations_weights_derivatives.multiply_rows(current_input_activations);
-           cell_state_recurrent_weights_derivatives += multiply_rows(forget_combinations_recurrent_weights_derivatives, previous_cell_state_activations);
-
-           hidden_states_recurrent_weights_derivatives = multiply_rows(output_combinations_recurrent_weights_derivatives, calculate_activations(current_cell_state_activations));
-           hidden_states_recurrent_weights_derivatives += multiply_rows(cell_state_recurrent_weights_derivatives, current_output_activations*current_hidden_derivatives);
-
-       }
-
-       state_recurrent_weights_error_gradient += hidden_states_recurrent_weights_derivatives.contract(current_layer_deltas, A_BT);
-    }
-
-    return state_recurrent_weights_error_gradient;
-}
-
-
-Tensor<type, 1> LongShortTermMemoryLayer::calculate_output_recurrent_weights_error_gradient(const Tensor<type, 2>& inputs,
-        const Layer::ForwardPropagation& forward_propagation,
-        const Tensor<type, 2>& deltas,
-        const Tensor<type, 3>& activations_states)
+Tensor<type, 2> LongShortTermMemoryLayer::sort_by_timesteps(const Tensor<type, 2>& matrix,
+                                                            const Tensor<Index, 1>& steps_offsets,
+                                                            const Tensor<Index, 1>& steps_sizes) const
 {
+    const Index rows_number = matrix.dimension(0);
+    const Index columns_number = matrix.dimension(1);
 
-        const Index instances_number = inputs.dimension(0);
-        const Index neurons_number = get_neurons_number();
-        const Index parameters_number = neurons_number*neurons_number;
-
-        Tensor<type, 1> output_recurrent_weights_error_gradient(parameters_number);
-
-        Tensor<type, 2> input_combinations_recurrent_weights_derivatives(parameters_number, neurons_number);
-        Tensor<type, 2> forget_combinations_recurrent_weights_derivatives(parameters_number, neurons_number);
-        Tensor<type, 2> state_combinations_recurrent_weights_derivatives(parameters_number, neurons_number);
-        Tensor<type, 2> output_combinations_recurrent_weights_derivatives(parameters_number, neurons_number);
-
-        Tensor<type, 2> hidden_states_recurrent_weights_derivatives(parameters_number, neurons_number);
-        Tensor<type, 2> cell_state_recurrent_weights_derivatives(parameters_number, neurons_number);
-
-        const Tensor<type, 2> forget_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,0}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));//.get_matrix(0);
-        const Tensor<type, 2> input_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,1}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-        const Tensor<type, 2> state_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,2}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-        const Tensor<type, 2> output_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,3}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-        const Tensor<type, 2> cell_state_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,4}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-        const Tensor<type, 2> hidden_state_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,5}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-
-        const Tensor<type, 2> forget_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,0}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));;
-        const Tensor<type, 2> input_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,1}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-        const Tensor<type, 2> state_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,2}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-        const Tensor<type, 2> output_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,3}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-        const Tensor<type, 2> hidden_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,4}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-
-        Index column_index = 0;
-        Index activation_index = 0;
-
-        for(Index instance = 0; instance < instances_number; instance++)
-        {
-            const Tensor<type, 1> current_layer_deltas = deltas.chip(instance, 0);
-
-            const Tensor<type, 1> current_forget_activations = forget_activations.chip(instance, 0);
-            const Tensor<type, 1> current_input_activations = input_activations.chip(instance, 0);
-            const Tensor<type, 1> current_state_activations = state_activations.chip(instance, 0);
-            const Tensor<type, 1> current_output_activations = output_activations.chip(instance, 0);
-            const Tensor<type, 1> current_cell_state_activations = cell_state_activations.chip(instance, 0);
-
-            const Tensor<type, 1> current_forget_derivatives = forget_derivatives.chip(instance, 0);
-            const Tensor<type, 1> current_input_derivatives = input_derivatives.chip(instance, 0);
-            const Tensor<type, 1> current_state_derivatives = state_derivatives.chip(instance, 0);
-            const Tensor<type, 1> current_output_derivatives = output_derivatives.chip(instance, 0);
-            const Tensor<type, 1> current_hidden_derivatives = hidden_derivatives.chip(instance, 0);
-
-            if(instance%timesteps == 0)
-            {
-                cell_state_recurrent_weights_derivatives.setZero();
-                hidden_states_recurrent_weights_derivatives.setZero();
-            }
-            else
-            {
-                const Tensor<type, 1> previous_hidden_state_activations = hidden_state_activations.chip(instance-1, 0);
-                const Tensor<type, 1> previous_cell_state_activations = cell_state_activations.chip(instance-1, 0);
-
-                forget_combinations_recurrent_weights_derivatives = multiply_rows(hidden_states_recurrent_weights_derivatives.contract(forget_recurrent_weights, A_B), current_forget_derivatives);
-                input_combinations_recurrent_weights_derivatives = multiply_rows(hidden_states_recurrent_weights_derivatives.contract(input_recurrent_weights, A_B), current_input_derivatives);
-                state_combinations_recurrent_weights_derivatives = multiply_rows(hidden_states_recurrent_weights_derivatives.contract(state_recurrent_weights, A_B), current_state_derivatives);
-                output_combinations_recurrent_weights_derivatives = hidden_states_recurrent_weights_derivatives.contract(output_recurrent_weights, A_B);
-
-                column_index = 0;
-                activation_index = 0;
-
-                for(Index i = 0; i < parameters_number; i++)
-                {
-                    output_combinations_recurrent_weights_derivatives(i, column_index) += previous_hidden_state_activations[activation_index];
-
-                    activation_index++;
-
-                    if(activation_index == neurons_number)
-                    {
-                        activation_index = 0;
-                        column_index++;
-                    }
-                }
-
-                cell_state_recurrent_weights_derivatives = multiply_rows(cell_state_recurrent_weights_derivatives, current_forget_activations);//cell_state_weights_derivatives.multiply_rows(current_forget_activations);
-                cell_state_recurrent_weights_derivatives += multiply_rows(input_combinations_recurrent_weights_derivatives, current_state_activations);//input_combinations_weights_derivatives.multiply_rows(current_state_activations);
-                cell_state_recurrent_weights_derivatives += multiply_rows(state_combinations_recurrent_weights_derivatives, current_input_activations);//state_combinations_weights_derivatives.multiply_rows(current_input_activations);
-                cell_state_recurrent_weights_derivatives += multiply_rows(forget_combinations_recurrent_weights_derivatives, previous_cell_state_activations);
-
-                hidden_states_recurrent_weights_derivatives = multiply_rows(output_combinations_recurrent_weights_derivatives, current_output_derivatives*calculate_activations(current_cell_state_activations));
-                hidden_states_recurrent_weights_derivatives += multiply_rows(cell_state_recurrent_weights_derivatives, current_output_activations*current_hidden_derivatives);
-
-            }
-
-            output_recurrent_weights_error_gradient += hidden_states_recurrent_weights_derivatives.contract(current_layer_deltas, A_B);
-        }
-
-        return output_recurrent_weights_error_gradient;
-}
-
-
-Tensor<type, 1> LongShortTermMemoryLayer::calculate_forget_biases_error_gradient(const Tensor<type, 2>& inputs,
-        const Layer::ForwardPropagation& forward_propagation,
-        const Tensor<type, 2>& deltas,
-        const Tensor<type, 3>& activations_states)
-{
-
-    const Index instances_number = inputs.dimension(0);
-    const Index neurons_number = get_neurons_number();
-    const Index parameters_number = neurons_number;
-
-    Tensor<type, 1> forget_biases_error_gradient(parameters_number);
-
-    Tensor<type, 2> input_combinations_biases_derivatives(parameters_number, neurons_number);
-    Tensor<type, 2> forget_combinations_biases_derivatives(parameters_number, neurons_number);
-    Tensor<type, 2> state_combinations_biases_derivatives(parameters_number, neurons_number);
-    Tensor<type, 2> output_combinations_biases_derivatives(parameters_number, neurons_number);
-
-    Tensor<type, 2> hidden_states_biases_derivatives(parameters_number, neurons_number);
-    Tensor<type, 2> cell_state_biases_derivatives(parameters_number, neurons_number);
-
-    const Tensor<type, 2> forget_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,0}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));//.get_matrix(0);
-    const Tensor<type, 2> input_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,1}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> state_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,2}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> output_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,3}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> cell_state_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,4}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-
-    const Tensor<type, 2> forget_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,0}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));;
-    const Tensor<type, 2> input_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,1}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> state_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,2}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> output_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,3}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> hidden_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,4}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-
-    for(Index instance = 0; instance < instances_number; instance++)
-    {
-        const Tensor<type, 1> current_layer_deltas = deltas.chip(instance, 0);
-
-        const Tensor<type, 1> current_forget_activations = forget_activations.chip(instance, 0);
-        const Tensor<type, 1> current_input_activations = input_activations.chip(instance, 0);
-        const Tensor<type, 1> current_state_activations = state_activations.chip(instance, 0);
-        const Tensor<type, 1> current_output_activations = output_activations.chip(instance, 0);
-        const Tensor<type, 1> current_cell_state_activations = cell_state_activations.chip(instance, 0);
-
-        const Tensor<type, 1> current_forget_derivatives = forget_derivatives.chip(instance, 0);
-        const Tensor<type, 1> current_input_derivatives = input_derivatives.chip(instance, 0);
-        const Tensor<type, 1> current_state_derivatives = state_derivatives.chip(instance, 0);
-        const Tensor<type, 1> current_output_derivatives = output_derivatives.chip(instance, 0);
-        const Tensor<type, 1> current_hidden_derivatives = hidden_derivatives.chip(instance, 0);
-
-        Tensor<type, 1> previous_cell_state_activations(neurons_number);
-
-        if(instance%timesteps == 0)
-        {
-            forget_combinations_biases_derivatives.setZero();
-            input_combinations_biases_derivatives.setZero();
-            state_combinations_biases_derivatives.setZero();
-            output_combinations_biases_derivatives.setZero();
-
-            cell_state_biases_derivatives.setZero();
-        }
-        else
-        {
-            previous_cell_state_activations = cell_state_activations.chip(instance-1, 0);
-
-            forget_combinations_biases_derivatives = hidden_states_biases_derivatives.contract(forget_recurrent_weights, A_B);
-            input_combinations_biases_derivatives = multiply_rows(hidden_states_biases_derivatives.contract(input_recurrent_weights, A_B), current_input_derivatives);
-            state_combinations_biases_derivatives = multiply_rows(hidden_states_biases_derivatives.contract(state_recurrent_weights, A_B), current_state_derivatives);
-            output_combinations_biases_derivatives = multiply_rows(hidden_states_biases_derivatives.contract(output_recurrent_weights, A_B), current_output_derivatives);
-        }
-
-        for(Index row = 0; row < parameters_number; row++)
-        {
-            for(Index column = 0; column < neurons_number; column++)
-            {
-                if(row == column) forget_combinations_biases_derivatives(row, row) += static_cast<type>(1.0);
-            }
-        }
-
-        cell_state_biases_derivatives = multiply_rows(cell_state_biases_derivatives, current_forget_activations);//cell_state_weights_derivatives.multiply_rows(current_forget_activations);
-        cell_state_biases_derivatives += multiply_rows(input_combinations_biases_derivatives, current_state_activations);//input_combinations_weights_derivatives.multiply_rows(current_state_activations);
-        cell_state_biases_derivatives += multiply_rows(state_combinations_biases_derivatives, current_input_activations);//state_combinations_weights_derivatives.multiply_rows(current_input_activations);
-        cell_state_biases_derivatives += multiply_rows(forget_combinations_biases_derivatives, current_forget_derivatives*previous_cell_state_activations);
-
-        hidden_states_biases_derivatives = multiply_rows(output_combinations_biases_derivatives, current_output_derivatives*calculate_activations(current_cell_state_activations));
-        hidden_states_biases_derivatives += multiply_rows(cell_state_biases_derivatives, current_output_activations*current_hidden_derivatives);
-
-        forget_biases_error_gradient += hidden_states_biases_derivatives.contract(current_layer_deltas, A_B);
-    }
-
-    return forget_biases_error_gradient;
-}
-
-
-Tensor<type, 1> LongShortTermMemoryLayer::calculate_input_biases_error_gradient(const Tensor<type, 2>& inputs,
-        const Layer::ForwardPropagation& forward_propagation,
-        const Tensor<type, 2>& deltas,
-        const Tensor<type, 3>& activations_states)
-{
-    const Index instances_number = inputs.dimension(0);
-    const Index neurons_number = get_neurons_number();
-    const Index parameters_number = neurons_number;
-
-    Tensor<type, 1> input_biases_error_gradient(parameters_number);
-
-    Tensor<type, 2> input_combinations_biases_derivatives(parameters_number, neurons_number);
-    Tensor<type, 2> forget_combinations_biases_derivatives(parameters_number, neurons_number);
-    Tensor<type, 2> state_combinations_biases_derivatives(parameters_number, neurons_number);
-    Tensor<type, 2> output_combinations_biases_derivatives(parameters_number, neurons_number);
-
-    Tensor<type, 2> hidden_states_biases_derivatives(parameters_number, neurons_number);
-    Tensor<type, 2> cell_state_biases_derivatives(parameters_number, neurons_number);
-
-    const Tensor<type, 2> forget_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,0}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));//.get_matrix(0);
-    const Tensor<type, 2> input_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,1}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> state_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,2}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> output_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,3}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> cell_state_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,4}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-
-    const Tensor<type, 2> forget_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,0}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));;
-    const Tensor<type, 2> input_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,1}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> state_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,2}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> output_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,3}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> hidden_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,4}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-
-   for(Index instance = 0; instance < instances_number; instance++)
-   {
-       const Tensor<type, 1> current_layer_deltas = deltas.chip(instance, 0);
-
-       const Tensor<type, 1> current_forget_activations = forget_activations.chip(instance, 0);
-       const Tensor<type, 1> current_input_activations = input_activations.chip(instance, 0);
-       const Tensor<type, 1> current_state_activations = state_activations.chip(instance, 0);
-       const Tensor<type, 1> current_output_activations = output_activations.chip(instance, 0);
-       const Tensor<type, 1> current_cell_state_activations = cell_state_activations.chip(instance, 0);
-
-       const Tensor<type, 1> current_forget_derivatives = forget_derivatives.chip(instance, 0);
-       const Tensor<type, 1> current_input_derivatives = input_derivatives.chip(instance, 0);
-       const Tensor<type, 1> current_state_derivatives = state_derivatives.chip(instance, 0);
-       const Tensor<type, 1> current_output_derivatives = output_derivatives.chip(instance, 0);
-       const Tensor<type, 1> current_hidden_derivatives = hidden_derivatives.chip(instance, 0);
-
-       Tensor<type, 1> previous_cell_state_activations(neurons_number);
-
-       if(instance%timesteps == 0)
-       {
-           forget_combinations_biases_derivatives.setZero();
-           input_combinations_biases_derivatives.setZero();
-           state_combinations_biases_derivatives.setZero();
-           output_combinations_biases_derivatives.setZero();
-
-           cell_state_biases_derivatives.setZero();
-       }
-       else
-       {
-           previous_cell_state_activations = cell_state_activations.chip(instance-1, 0);
-
-           forget_combinations_biases_derivatives = multiply_rows(hidden_states_biases_derivatives.contract(forget_recurrent_weights, A_B), current_forget_derivatives);
-           input_combinations_biases_derivatives = hidden_states_biases_derivatives.contract(input_recurrent_weights, A_B);
-           state_combinations_biases_derivatives = multiply_rows(hidden_states_biases_derivatives.contract(state_recurrent_weights, A_B), current_state_derivatives);
-           output_combinations_biases_derivatives = multiply_rows(hidden_states_biases_derivatives.contract(output_recurrent_weights, A_B), current_output_derivatives);
-       }
-
-       for(Index row = 0; row < parameters_number; row++)
-       {
-           for(Index column = 0; column < neurons_number; column++)
-           {
-               if(row == column) input_combinations_biases_derivatives(row, row) += static_cast<type>(1.0);
-           }
-       }
-
-       cell_state_biases_derivatives = multiply_rows(cell_state_biases_derivatives, current_forget_activations);//cell_state_weights_derivatives.multiply_rows(current_forget_activations);
-       cell_state_biases_derivatives += multiply_rows(forget_combinations_biases_derivatives, previous_cell_state_activations);//input_combinations_weights_derivatives.multiply_rows(current_state_activations);
-       cell_state_biases_derivatives += multiply_rows(state_combinations_biases_derivatives, current_input_activations);//state_combinations_weights_derivatives.multiply_rows(current_input_activations);
-       cell_state_biases_derivatives += multiply_rows(input_combinations_biases_derivatives, current_input_derivatives*current_state_activations);
-
-       hidden_states_biases_derivatives = multiply_rows(output_combinations_biases_derivatives, current_output_derivatives*calculate_activations(current_cell_state_activations));
-       hidden_states_biases_derivatives += multiply_rows(cell_state_biases_derivatives, current_output_activations*current_hidden_derivatives);
-
-       input_biases_error_gradient += hidden_states_biases_derivatives.contract(current_layer_deltas, A_B);
-   }
-
-   return input_biases_error_gradient;
-}
-
-
-
-Tensor<type, 1> LongShortTermMemoryLayer::calculate_state_biases_error_gradient(const Tensor<type, 2>& inputs,
-        const Layer::ForwardPropagation& forward_propagation,
-        const Tensor<type, 2>& deltas,
-        const Tensor<type, 3>& activations_states)
-{
-
-    const Index instances_number = inputs.dimension(0);
-    const Index neurons_number = get_neurons_number();
-    const Index parameters_number = neurons_number;
-
-    Tensor<type, 1> state_biases_error_gradient(parameters_number);
-
-    Tensor<type, 2> input_combinations_biases_derivatives(parameters_number, neurons_number);
-    Tensor<type, 2> forget_combinations_biases_derivatives(parameters_number, neurons_number);
-    Tensor<type, 2> state_combinations_biases_derivatives(parameters_number, neurons_number);
-    Tensor<type, 2> output_combinations_biases_derivatives(parameters_number, neurons_number);
-
-    Tensor<type, 2> hidden_states_biases_derivatives(parameters_number, neurons_number);
-    Tensor<type, 2> cell_state_biases_derivatives(parameters_number, neurons_number);
-
-    const Tensor<type, 2> forget_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,0}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));//.get_matrix(0);
-    const Tensor<type, 2> input_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,1}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> state_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,2}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> output_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,3}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> cell_state_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,4}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-
-    const Tensor<type, 2> forget_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,0}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));;
-    const Tensor<type, 2> input_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,1}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> state_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,2}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> output_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,3}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> hidden_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,4}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-
-
-   for(Index instance = 0; instance < instances_number; instance++)
-   {
-       const Tensor<type, 1> current_layer_deltas = deltas.chip(instance, 0);
-
-       const Tensor<type, 1> current_forget_activations = forget_activations.chip(instance, 0);
-       const Tensor<type, 1> current_input_activations = input_activations.chip(instance, 0);
-       const Tensor<type, 1> current_state_activations = state_activations.chip(instance, 0);
-       const Tensor<type, 1> current_output_activations = output_activations.chip(instance, 0);
-       const Tensor<type, 1> current_cell_state_activations = cell_state_activations.chip(instance, 0);
-
-       const Tensor<type, 1> current_forget_derivatives = forget_derivatives.chip(instance, 0);
-       const Tensor<type, 1> current_input_derivatives = input_derivatives.chip(instance, 0);
-       const Tensor<type, 1> current_state_derivatives = state_derivatives.chip(instance, 0);
-       const Tensor<type, 1> current_output_derivatives = output_derivatives.chip(instance, 0);
-       const Tensor<type, 1> current_hidden_derivatives = hidden_derivatives.chip(instance, 0);
-
-       Tensor<type, 1> previous_cell_state_activations(neurons_number);
-
-       if(instance%timesteps == 0)
-       {
-           forget_combinations_biases_derivatives.setZero();
-           input_combinations_biases_derivatives.setZero();
-           state_combinations_biases_derivatives.setZero();
-           output_combinations_biases_derivatives.setZero();
-
-           cell_state_biases_derivatives.setZero();
-       }
-       else
-       {
-           previous_cell_state_activations = cell_state_activations.chip(instance-1, 0);
-
-           forget_combinations_biases_derivatives = multiply_rows(hidden_states_biases_derivatives.contract(forget_recurrent_weights, A_B), current_forget_derivatives);
-           input_combinations_biases_derivatives = multiply_rows(hidden_states_biases_derivatives.contract(input_recurrent_weights, A_B), current_input_derivatives);
-           state_combinations_biases_derivatives = hidden_states_biases_derivatives.contract(state_recurrent_weights, A_B);
-           output_combinations_biases_derivatives = multiply_rows(hidden_states_biases_derivatives.contract(output_recurrent_weights, A_B), current_output_derivatives);
-       }
-
-       for(Index row = 0; row < parameters_number; row++)
-       {
-           for(Index column = 0; column < neurons_number; column++)
-           {
-               if(row == column) state_combinations_biases_derivatives(row, row) += static_cast<type>(1.0);
-           }
-       }
-
-       cell_state_biases_derivatives = multiply_rows(cell_state_biases_derivatives, current_forget_activations);//cell_state_weights_derivatives.multiply_rows(current_forget_activations);
-       cell_state_biases_derivatives += multiply_rows(forget_combinations_biases_derivatives, previous_cell_state_activations);//input_combinations_weights_derivatives.multiply_rows(current_state_activations);
-       cell_state_biases_derivatives += multiply_rows(input_combinations_biases_derivatives, current_state_activations);//state_combinations_weights_derivatives.multiply_rows(current_input_activations);
-       cell_state_biases_derivatives += multiply_rows(state_combinations_biases_derivatives, current_state_derivatives*current_input_activations);
-
-       hidden_states_biases_derivatives = multiply_rows(output_combinations_biases_derivatives, current_output_derivatives*calculate_activations(current_cell_state_activations));
-       hidden_states_biases_derivatives += multiply_rows(cell_state_biases_derivatives, current_output_activations*current_hidden_derivatives);
-
-       state_biases_error_gradient += hidden_states_biases_derivatives.contract(current_layer_deltas, A_B);
-   }
-
-   return state_biases_error_gradient;
-}
-
-
-Tensor<type, 1> LongShortTermMemoryLayer::calculate_output_biases_error_gradient(const Tensor<type, 2>& inputs,
-        const Layer::ForwardPropagation& forward_propagation,
-        const Tensor<type, 2>& deltas,
-        const Tensor<type, 3>& activations_states)
-{
-    const Index instances_number = inputs.dimension(0);
-    const Index neurons_number = get_neurons_number();
-    const Index parameters_number = neurons_number;
-
-    Tensor<type, 1> output_biases_error_gradient(parameters_number);
-
-    Tensor<type, 2> input_combinations_biases_derivatives(parameters_number, neurons_number);
-    Tensor<type, 2> forget_combinations_biases_derivatives(parameters_number, neurons_number);
-    Tensor<type, 2> state_combinations_biases_derivatives(parameters_number, neurons_number);
-    Tensor<type, 2> output_combinations_biases_derivatives(parameters_number, neurons_number);
-
-    Tensor<type, 2> hidden_states_biases_derivatives(parameters_number, neurons_number);
-    Tensor<type, 2> cell_state_biases_derivatives(parameters_number, neurons_number);
-
-    const Tensor<type, 2> forget_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,0}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));//.get_matrix(0);
-    const Tensor<type, 2> input_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,1}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> state_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,2}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> output_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,3}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> cell_state_activations = activations_states.slice(Eigen::array<Eigen::Index, 3>({0,0,4}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-
-    const Tensor<type, 2> forget_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,0}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));;
-    const Tensor<type, 2> input_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,1}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> state_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,2}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> output_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,3}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
-    const Tensor<type, 2> hidden_derivatives = forward_propagation.activations_derivatives_3d.slice(Eigen::array<Eigen::Index, 3>({0,0,4}), Eigen::array<Eigen::Index, 3>({instances_number,neurons_number,1})).reshape(Eigen::array<Index, 2>({instances_number, neurons_number}));
+    Tensor<type, 2> sorted_matrix(rows_number, columns_number);
 
-    for(Index instance = 0; instance < instances_number; instance++)
+    for(Index t = 0; t < steps_sizes.size(); t++)
     {
-        const Tensor<type, 1> current_layer_deltas = deltas.chip(instance, 0);
-
-        const Tensor<type, 1> current_forget_activations = forget_activations.chip(instance, 0);
-        const Tensor<type, 1> current_input_activations = input_activations.chip(instance, 0);
-        const Tensor<type, 1> current_state_activations = state_activations.chip(instance, 0);
-        const Tensor<type, 1> current_output_activations = output_activations.chip(instance, 0);
-        const Tensor<type, 1> current_cell_state_activations = cell_state_activations.chip(instance, 0);
-
-        const Tensor<type, 1> current_forget_derivatives = forget_derivatives.chip(instance, 0);
-        const Tensor<type, 1> current_input_derivatives = input_derivatives.chip(instance, 0);
-        const Tensor<type, 1> current_state_derivatives = state_derivatives.chip(instance, 0);
-        const Tensor<type, 1> current_output_derivatives = output_derivatives.chip(instance, 0);
-        const Tensor<type, 1> current_hidden_derivatives = hidden_derivatives.chip(instance, 0);
-
-        Tensor<type, 1> previous_cell_state_activations(neurons_number);
-
-        if(instance%timesteps == 0)
+        for(Index s = 0; s < steps_sizes(t); s++)
         {
-            forget_combinations_biases_derivatives.setZero();
-            input_combinations_biases_derivatives.setZero();
-            state_combinations_biases_derivatives.setZero();
-            output_combinations_biases_derivatives.setZero();
-
-            cell_state_biases_derivatives.setZero();
-        }
-        else
-        {
-            previous_cell_state_activations = cell_state_activations.chip(instance-1, 0);
-
-            forget_combinations_biases_derivatives = multiply_rows(hidden_states_biases_derivatives.contract(forget_recurrent_weights, A_B), current_forget_derivatives);
-            input_combinations_biases_derivatives = multiply_rows(hidden_states_biases_derivatives.contract(input_recurrent_weights, A_B), current_input_derivatives);
-            state_combinations_biases_derivatives = multiply_rows(hidden_states_biases_derivatives.contract(state_recurrent_weights, A_B), current_state_derivatives);
-            output_combinations_biases_derivatives = hidden_states_biases_derivatives.contract(output_recurrent_weights, A_B);
-        }
-
-        for(Index row = 0; row < parameters_number; row++)
-        {
-            for(Index column = 0; column < neurons_number; column++)
+            for(Index j = 0; j < columns_number; j++)
             {
-                if(row == column) output_combinations_biases_derivatives(row, row) += static_cast<type>(1.0);
+                sorted_matrix(steps_offsets(t) + s, j) = matrix(s*timesteps + t, j);
             }
         }
-
-        cell_state_biases_derivatives = multiply_rows(cell_state_biases_derivatives, current_forget_activations);//cell_state_weights_derivatives.multiply_rows(current_forget_activations);
-        cell_state_biases_derivatives += multiply_rows(forget_combinations_biases_derivatives, previous_cell_state_activations);//input_combinations_weights_derivatives.multiply_rows(current_state_activations);
-        cell_state_biases_derivatives += multiply_rows(state_combinations_biases_derivatives, current_input_activations);//state_combinations_weights_derivatives.multiply_rows(current_input_activations);
-        cell_state_biases_derivatives += multiply_rows(input_combinations_biases_derivatives, current_state_activations);
-
-        hidden_states_biases_derivatives = multiply_rows(output_combinations_biases_derivatives, current_output_derivatives*calculate_activations(current_cell_state_activations));
-        hidden_states_biases_derivatives += multiply_rows(cell_state_biases_derivatives, current_output_activations*current_hidden_derivatives);
-
-        output_biases_error_gradient += hidden_states_biases_derivatives.contract(current_layer_deltas, A_B);
-    }
-
-    return output_biases_error_gradient;
-}
-
-Tensor<type, 2> LongShortTermMemoryLayer::multiply_rows(const Tensor<type, 2>& matrix, const Tensor<type, 1>& vector) const
-{
-    const Index columns_number = matrix.dimension(1);
-    const Index rows_number = matrix.dimension(0);
-
-    Tensor<type, 2> new_matrix(rows_number, columns_number);
-
-    for(Index i = 0; i < rows_number; i++)
-    {
-        for(Index j = 0; j < columns_number; j++)
-        {
-           new_matrix(i,j) = matrix(i,j) * vector(j);
-        }
     }
 
-    return new_matrix;
+    return sorted_matrix;
 }
 
 
-/// Returns a string with the expression of the inputs-outputs relationship of the layer.
-/// @param inputs_names Vector of strings with the name of the layer inputs.
-/// @param outputs_names Vector of strings with the name of the layer outputs.
-
 string LongShortTermMemoryLayer::write_expression(const Tensor<string, 1>& inputs_names, const Tensor<string, 1>& outputs_names) const
 {
 
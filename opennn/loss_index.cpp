@@ -7,6 +7,7 @@
 //   artelnics@artelnics.com
 
 #include "loss_index.h"
+#include "gradient_checker.h"
 
 
 namespace OpenNN
@@ -518,13 +519,25 @@ void LossIndex::back_propagate(const DataSet::Batch& batch,
 {
     // Loss index
 
-    calculate_error(batch, forward_propagation, back_propagation);
+    {
+        OPENNN_PROFILE_SCOPE(neural_network_pointer->get_profiler_pointer(), TrainingProfiler::CalculateError);
+
+        calculate_error(batch, forward_propagation, back_propagation);
+    }
+
+    {
+        OPENNN_PROFILE_SCOPE(neural_network_pointer->get_profiler_pointer(), TrainingProfiler::CalculateLayersDelta);
 
-    calculate_output_gradient(batch, forward_propagation, back_propagation);
+        calculate_output_gradient(batch, forward_propagation, back_propagation);
 
-    calculate_layers_delta(forward_propagation, back_propagation);
+        calculate_layers_delta(forward_propagation, back_propagation);
+    }
 
-    calculate_error_gradient(batch, forward_propagation, back_propagation);
+    {
+        OPENNN_PROFILE_SCOPE(neural_network_pointer->get_profiler_pointer(), TrainingProfiler::CalculateErrorGradient);
+
+        calculate_error_gradient(batch, forward_propagation, back_propagation);
+    }
 
     // Loss
 
@@ -554,19 +567,31 @@ void LossIndex::calculate_terms_second_order_loss(const DataSet::Batch& batch,
 {
     // First Order
 
-    calculate_error_terms(batch, forward_propagation, second_order_loss);
+    {
+        OPENNN_PROFILE_SCOPE(neural_network_pointer->get_profiler_pointer(), TrainingProfiler::CalculateError);
 
-    calculate_error_terms_output_gradient(batch, forward_propagation, back_propagation, second_order_loss);
+        calculate_error_terms(batch, forward_propagation, second_order_loss);
+    }
+
+    {
+        OPENNN_PROFILE_SCOPE(neural_network_pointer->get_profiler_pointer(), TrainingProfiler::CalculateLayersDelta);
 
-    calculate_layers_delta(forward_propagation, back_propagation);
+        calculate_error_terms_output_gradient(batch, forward_propagation, back_propagation, second_order_loss);
+
+        calculate_layers_delta(forward_propagation, back_propagation);
+    }
 
     // Second Order
 
-    calculate_error_terms_Jacobian(batch, forward_propagation, back_propagation, second_order_loss);
+    {
+        OPENNN_PROFILE_SCOPE(neural_network_pointer->get_profiler_pointer(), TrainingProfiler::CalculateErrorGradient);
+
+        calculate_error_terms_Jacobian(batch, forward_propagation, back_propagation, second_order_loss);
 
-    calculate_Jacobian_gradient(batch, second_order_loss);
+        calculate_Jacobian_gradient(batch, second_order_loss);
 
-    calculate_hessian_approximation(batch, second_order_loss);
+        calculate_hessian_approximation(batch, second_order_loss);
+    }
 
     // Loss
 
@@ -594,7 +619,12 @@ void LossIndex::calculate_error_terms_output_gradient(const DataSet::Batch& batc
 
     const Tensor<type, 2>& outputs = forward_propagation.layers(trainable_layers_number-1).activations_2d;
     const Tensor<type, 2>& targets = batch.targets_2d;
-    back_propagation.output_gradient.device(*thread_pool_device) = (outputs-targets)/second_order_loss.error_terms;
+
+    const Eigen::array<Index, 2> error_terms_dimensions = {outputs.dimension(0), 1};
+    const Eigen::array<Index, 2> error_terms_broadcast = {1, outputs.dimension(1)};
+
+    back_propagation.output_gradient.device(*thread_pool_device)
+            = (outputs-targets)/second_order_loss.error_terms.reshape(error_terms_dimensions).broadcast(error_terms_broadcast);
 
 }
 
@@ -717,6 +747,23 @@ Tensor<type, 2> LossIndex::calculate_regularization_hessian(const Tensor<type, 1
 }
 
 
+/// Calculates the delta of the output layer from the output gradient.
+/// Error functions whose output gradient is already taken with respect to the combinations of the output layer
+/// override this method.
+
+void LossIndex::calculate_output_delta(NeuralNetwork::ForwardPropagation& forward_propagation,
+                                       BackPropagation& back_propagation) const
+{
+     const Index trainable_layers_number = neural_network_pointer->get_trainable_layers_number();
+
+     Layer* output_layer_pointer = forward_propagation.layers(trainable_layers_number-1).layer_pointer;
+
+     output_layer_pointer->calculate_output_delta(forward_propagation.layers(trainable_layers_number-1),
+                                                  back_propagation.output_gradient,
+                                                  back_propagation.neural_network.layers(trainable_layers_number-1).delta);
+}
+
+
 void LossIndex::calculate_layers_delta(NeuralNetwork::ForwardPropagation& forward_propagation,
                             BackPropagation& back_propagation) const
 {
@@ -726,17 +773,25 @@ void LossIndex::calculate_layers_delta(NeuralNetwork::ForwardPropagation& forwar
 
      const Tensor<Layer*, 1> trainable_layers_pointers = neural_network_pointer->get_trainable_layers_pointers();
 
+     OPENNN_PROFILE_COUNT(neural_network_pointer->get_profiler_pointer(), TrainingProfiler::CalculateLayersDelta, -1, 0, 0, 1);
+
      // Output layer
 
-     trainable_layers_pointers(trainable_layers_number-1)
-     ->calculate_output_delta(forward_propagation.layers(trainable_layers_number-1),
-                              back_propagation.output_gradient,
-                              back_propagation.neural_network.layers(trainable_layers_number-1).delta);
+     {
+         OPENNN_PROFILE_SCOPE(neural_network_pointer->get_profiler_pointer(), TrainingProfiler::CalculateLayersDelta,
+                              trainable_layers_number-1, trainable_layers_pointers(trainable_layers_number-1),
+                              forward_propagation.batch_instances_number);
+
+         calculate_output_delta(forward_propagation, back_propagation);
+     }
 
      // Hidden layers
 
    for(Index i = static_cast<Index>(trainable_layers_number)-2; i >= 0; i--)
    {
+       OPENNN_PROFILE_SCOPE(neural_network_pointer->get_profiler_pointer(), TrainingProfiler::CalculateLayersDelta,
+                            i, trainable_layers_pointers(i), forward_propagation.batch_instances_number);
+
        Layer* previous_layer_pointer = trainable_layers_pointers(static_cast<Index>(i+1));
 
        trainable_layers_pointers(i)
@@ -767,19 +822,38 @@ void LossIndex::calculate_error_gradient(const DataSet::Batch& batch,
     const Tensor<Index, 1> trainable_layers_parameters_number
             = neural_network_pointer->get_trainable_layers_parameters_numbers();
 
-    trainable_layers_pointers(0)->calculate_error_gradient(batch.inputs_2d,
-                                                           forward_propagation.layers(0),
-                                                           back_propagation.neural_network.layers(0));
+    OPENNN_PROFILE_COUNT(neural_network_pointer->get_profiler_pointer(), TrainingProfiler::CalculateErrorGradient, -1, 0, 0, 2);
 
     Index index = 0;
 
-    trainable_layers_pointers(0)->insert_gradient(back_propagation.neural_network.layers(0),
-            index, back_propagation.gradient);
+    {
+        OPENNN_PROFILE_SCOPE(neural_network_pointer->get_profiler_pointer(), TrainingProfiler::CalculateErrorGradient,
+                             0, trainable_layers_pointers(0), forward_propagation.batch_instances_number);
+
+        if(batch.sparse_inputs)
+        {
+            trainable_layers_pointers(0)->calculate_error_gradient(batch.inputs_csr,
+                                                                   forward_propagation.layers(0),
+                                                                   back_propagation.neural_network.layers(0));
+        }
+        else
+        {
+            trainable_layers_pointers(0)->calculate_error_gradient(batch.inputs_2d,
+                                                                   forward_propagation.layers(0),
+                                                                   back_propagation.neural_network.layers(0));
+        }
+
+        trainable_layers_pointers(0)->insert_gradient(back_propagation.neural_network.layers(0),
+                index, back_propagation.gradient);
+    }
 
     index += trainable_layers_parameters_number(0);
 
     for(Index i = 1; i < trainable_layers_number; i++)
     {
+        OPENNN_PROFILE_SCOPE(neural_network_pointer->get_profiler_pointer(), TrainingProfiler::CalculateErrorGradient,
+                             i, trainable_layers_pointers(i), forward_propagation.batch_instances_number);
+
         trainable_layers_pointers(i)->calculate_error_gradient(
                 forward_propagation.layers(i-1).activations_2d,
                 forward_propagation.layers(i-1),
@@ -951,59 +1025,15 @@ LossIndex::BackPropagation::~BackPropagation()
 }
 
 
-Tensor<type, 1> LossIndex:: calculate_error_gradient_numerical_differentiation(LossIndex* loss_index_pointer) const
-{
-    const Index instances_number = data_set_pointer->get_training_instances_number();
-
-    DataSet::Batch batch(instances_number, data_set_pointer);
-
-    Tensor<Index, 1> instances_indices = data_set_pointer->get_training_instances_indices();
-    const Tensor<Index, 1> input_indices = data_set_pointer->get_input_variables_indices();
-    const Tensor<Index, 1> target_indices = data_set_pointer->get_target_variables_indices();
-
-    batch.fill(instances_indices, input_indices, target_indices);
-
-    NeuralNetwork::ForwardPropagation forward_propagation(instances_number, neural_network_pointer);
-
-    BackPropagation back_propagation(instances_number, loss_index_pointer);
-
-    const Tensor<type, 1> parameters = neural_network_pointer->get_parameters();
-
-    const Index parameters_number = parameters.size();
-
-    type h;
-    Tensor<type, 1> parameters_forward(parameters);
-    Tensor<type, 1> parameters_backward(parameters);
-
-    type error_forward;
-    type error_backward;
-
-    Tensor<type, 1> numerical_gradient(parameters_number);
-
-    for(Index i = 0; i < parameters_number; i++)
-    {
-       h = calculate_h(parameters(i));
-
-       parameters_forward(i) += h;
-
-       neural_network_pointer->forward_propagate(batch, parameters_forward, forward_propagation);
-       loss_index_pointer->calculate_error(batch, forward_propagation, back_propagation);
-       error_forward = back_propagation.error;
-
-       parameters_forward(i) -= h;
-
-       parameters_backward(i) -= h;
+/// Returns the derivatives of the error of the training instances with respect to the parameters, by central differences.
+/// The perturbed errors are evaluated in parallel by a gradient checker.
+/// @param loss_index_pointer Pointer to the loss index whose error is differentiated.
 
-       neural_network_pointer->forward_propagate(batch, parameters_backward, forward_propagation);
-       loss_index_pointer->calculate_error(batch, forward_propagation, back_propagation);
-       error_backward = back_propagation.error;
-
-       parameters_backward(i) += h;
-
-       numerical_gradient(i) = (error_forward - error_backward)/(2*h);
-    }
+Tensor<type, 1> LossIndex::calculate_error_gradient_numerical_differentiation(LossIndex* loss_index_pointer) const
+{
+    const GradientChecker gradient_checker(loss_index_pointer);
 
-    return numerical_gradient;
+    return gradient_checker.calculate_numerical_gradient();
 }
 
 
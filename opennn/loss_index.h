@@ -324,6 +324,9 @@ public:
 
    // Delta methods
 
+   virtual void calculate_output_delta(NeuralNetwork::ForwardPropagation& forward_propagation,
+                                       BackPropagation& back_propagation) const;
+
    void calculate_layers_delta(NeuralNetwork::ForwardPropagation& forward_propagation,
                                BackPropagation& back_propagation) const;
 
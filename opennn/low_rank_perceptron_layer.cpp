@@ -0,0 +1,1017 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   L O W   R A N K   P E R C E P T R O N   L A Y E R   C L A S S
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#include "low_rank_perceptron_layer.h"
+
+namespace OpenNN
+{
+
+/// Default constructor.
+/// It creates a empty layer object, with no perceptrons.
+/// This constructor also initializes the rest of class members to their default values.
+
+LowRankPerceptronLayer::LowRankPerceptronLayer() : PerceptronLayer()
+{
+    set();
+}
+
+
+/// Layer architecture constructor.
+/// It creates a layer object with given numbers of inputs, perceptrons and rank of the synaptic weights.
+/// The parameters are initialized at random.
+/// @param new_inputs_number Number of inputs in the layer.
+/// @param new_neurons_number Number of perceptrons in the layer.
+/// @param new_rank Rank of the synaptic weights.
+/// @param new_activation_function Activation function of the perceptrons.
+
+LowRankPerceptronLayer::LowRankPerceptronLayer(const Index& new_inputs_number,
+                                               const Index& new_neurons_number,
+                                               const Index& new_rank,
+                                               const ActivationFunction& new_activation_function) : PerceptronLayer()
+{
+    set(new_inputs_number, new_neurons_number, new_rank, new_activation_function);
+}
+
+
+/// Copy constructor.
+/// It creates a copy of an existing low rank perceptron layer object.
+/// @param other_low_rank_perceptron_layer Low rank perceptron layer object to be copied.
+
+LowRankPerceptronLayer::LowRankPerceptronLayer(const LowRankPerceptronLayer& other_low_rank_perceptron_layer)
+    : PerceptronLayer()
+{
+    set(other_low_rank_perceptron_layer);
+}
+
+
+/// Destructor.
+/// This destructor does not delete any pointer.
+
+LowRankPerceptronLayer::~LowRankPerceptronLayer()
+{
+}
+
+
+/// Returns the number of inputs to the layer.
+
+Index LowRankPerceptronLayer::get_inputs_number() const
+{
+    return input_factors.dimension(0);
+}
+
+
+/// Returns the rank of the synaptic weights, which is the number of columns of the input factors.
+
+Index LowRankPerceptronLayer::get_rank() const
+{
+    return input_factors.dimension(1);
+}
+
+
+/// Returns the inputs_number x rank matrix with the first factor of the synaptic weights.
+
+const Tensor<type, 2>& LowRankPerceptronLayer::get_input_factors() const
+{
+    return input_factors;
+}
+
+
+/// Returns the rank x neurons_number matrix with the second factor of the synaptic weights.
+
+const Tensor<type, 2>& LowRankPerceptronLayer::get_output_factors() const
+{
+    return output_factors;
+}
+
+
+/// Returns the inputs_number x neurons_number synaptic weights, as the product of both factors.
+/// This is only intended for inspection, since the layer never forms that matrix.
+
+Tensor<type, 2> LowRankPerceptronLayer::get_synaptic_weights() const
+{
+    Tensor<type, 2> synaptic_weights_product(get_inputs_number(), get_neurons_number());
+
+    synaptic_weights_product.device(*thread_pool_device) = input_factors.contract(output_factors, A_B);
+
+    return synaptic_weights_product;
+}
+
+
+/// Returns the number of parameters in the factors of the synaptic weights.
+
+Index LowRankPerceptronLayer::get_synaptic_weights_number() const
+{
+    return input_factors.size() + output_factors.size();
+}
+
+
+/// Returns the number of parameters (biases, input factors and output factors) of the layer.
+
+Index LowRankPerceptronLayer::get_parameters_number() const
+{
+    return biases.size() + input_factors.size() + output_factors.size();
+}
+
+
+/// Returns a single vector with the biases, the input factors and the output factors of the layer.
+
+Tensor<type, 1> LowRankPerceptronLayer::get_parameters() const
+{
+    const Index biases_number = biases.size();
+    const Index input_factors_number = input_factors.size();
+    const Index output_factors_number = output_factors.size();
+
+    Tensor<type, 1> parameters(biases_number + input_factors_number + output_factors_number);
+
+    memcpy(parameters.data(),
+           biases.data(),
+           static_cast<size_t>(biases_number)*sizeof(type));
+
+    memcpy(parameters.data() + biases_number,
+           input_factors.data(),
+           static_cast<size_t>(input_factors_number)*sizeof(type));
+
+    memcpy(parameters.data() + biases_number + input_factors_number,
+           output_factors.data(),
+           static_cast<size_t>(output_factors_number)*sizeof(type));
+
+    return parameters;
+}
+
+
+/// Sets an empty layer, wihtout any perceptron.
+/// It also sets the rest of members to their default values.
+
+void LowRankPerceptronLayer::set()
+{
+    biases.resize(0, 0);
+
+    synaptic_weights.resize(0, 0);
+
+    input_factors.resize(0, 0);
+
+    output_factors.resize(0, 0);
+
+    set_default();
+}
+
+
+/// Sets new numbers of inputs, perceptrons and rank in the layer.
+/// The parameters are initialized at random, so that the synaptic weights have unit variance.
+/// @param new_inputs_number Number of inputs.
+/// @param new_neurons_number Number of perceptron neurons.
+/// @param new_rank Rank of the synaptic weights.
+/// @param new_activation_function Activation function of the perceptrons.
+
+void LowRankPerceptronLayer::set(const Index& new_inputs_number,
+                                 const Index& new_neurons_number,
+                                 const Index& new_rank,
+                                 const ActivationFunction& new_activation_function)
+{
+    biases.resize(1, new_neurons_number);
+
+    synaptic_weights.resize(0, 0);
+
+    input_factors.resize(new_inputs_number, new_rank);
+
+    output_factors.resize(new_rank, new_neurons_number);
+
+    set_parameters_random();
+
+    activation_function = new_activation_function;
+
+    set_default();
+}
+
+
+/// Sets the members of this layer with those from another low rank perceptron layer.
+/// @param other_low_rank_perceptron_layer Low rank perceptron layer object to be copied.
+
+void LowRankPerceptronLayer::set(const LowRankPerceptronLayer& other_low_rank_perceptron_layer)
+{
+    biases = other_low_rank_perceptron_layer.biases;
+
+    synaptic_weights.resize(0, 0);
+
+    input_factors = other_low_rank_perceptron_layer.input_factors;
+
+    output_factors = other_low_rank_perceptron_layer.output_factors;
+
+    activation_function = other_low_rank_perceptron_layer.activation_function;
+
+    set_default();
+
+    display = other_low_rank_perceptron_layer.display;
+}
+
+
+/// Sets those members not related to the perceptrons to their default value.
+
+void LowRankPerceptronLayer::set_default()
+{
+    layer_name = "low_rank_perceptron_layer";
+
+    display = true;
+
+    layer_type = LowRankPerceptron;
+}
+
+
+/// Sets a new number of inputs in the layer.
+/// @param new_inputs_number Number of layer inputs.
+
+void LowRankPerceptronLayer::set_inputs_number(const Index& new_inputs_number)
+{
+    const Index rank = get_rank();
+
+    input_factors.resize(new_inputs_number, rank);
+}
+
+
+/// Sets a new number of perceptrons in the layer.
+/// @param new_neurons_number New number of neurons in the layer.
+
+void LowRankPerceptronLayer::set_neurons_number(const Index& new_neurons_number)
+{
+    const Index rank = get_rank();
+
+    biases.resize(1, new_neurons_number);
+
+    output_factors.resize(rank, new_neurons_number);
+}
+
+
+/// Sets a new rank of the synaptic weights.
+/// @param new_rank Number of columns of the input factors and rows of the output factors.
+
+void LowRankPerceptronLayer::set_rank(const Index& new_rank)
+{
+    const Index inputs_number = get_inputs_number();
+    const Index neurons_number = get_neurons_number();
+
+    input_factors.resize(inputs_number, new_rank);
+
+    output_factors.resize(new_rank, neurons_number);
+}
+
+
+/// Sets a new number of inputs keeping the input factors of the inputs which remain.
+/// The input factors of the new inputs are set to zero, so that the outputs do not change.
+/// @param inputs_indices Index of each new input among the previous inputs, or -1 for a new input.
+
+void LowRankPerceptronLayer::resize_inputs(const Tensor<Index, 1>& inputs_indices)
+{
+    const Index new_inputs_number = inputs_indices.size();
+
+    const Index inputs_number = get_inputs_number();
+    const Index rank = get_rank();
+
+    Tensor<type, 2> new_input_factors(new_inputs_number, rank);
+    new_input_factors.setZero();
+
+    for(Index i = 0; i < new_inputs_number; i++)
+    {
+        if(inputs_indices(i) < 0 || inputs_indices(i) >= inputs_number) continue;
+
+        new_input_factors.chip(i,0) = input_factors.chip(inputs_indices(i),0);
+    }
+
+    input_factors = new_input_factors;
+}
+
+
+/// Sets a new number of neurons keeping the biases and output factors of the first ones.
+/// The new neurons have zero biases and small random output factors, so that they can start learning.
+/// @param new_neurons_number Number of neurons.
+
+void LowRankPerceptronLayer::resize_neurons(const Index& new_neurons_number)
+{
+    const Index neurons_number = get_neurons_number();
+    const Index rank = get_rank();
+
+    const Index kept_neurons_number = min(neurons_number, new_neurons_number);
+
+    Tensor<type, 2> new_biases(1, new_neurons_number);
+    new_biases.setZero();
+
+    Tensor<type, 2> new_output_factors(rank, new_neurons_number);
+    new_output_factors.setRandom<Eigen::internal::NormalRandomGenerator<type>>();
+    new_output_factors = new_output_factors*static_cast<type>(0.01);
+
+    for(Index j = 0; j < kept_neurons_number; j++)
+    {
+        new_biases(0,j) = biases(0,j);
+
+        new_output_factors.chip(j,1) = output_factors.chip(j,1);
+    }
+
+    biases = new_biases;
+    output_factors = new_output_factors;
+}
+
+
+/// Sets the inputs_number x rank matrix with the first factor of the synaptic weights.
+/// @param new_input_factors New input factors.
+
+void LowRankPerceptronLayer::set_input_factors(const Tensor<type, 2>& new_input_factors)
+{
+    input_factors = new_input_factors;
+}
+
+
+/// Sets the rank x neurons_number matrix with the second factor of the synaptic weights.
+/// @param new_output_factors New output factors.
+
+void LowRankPerceptronLayer::set_output_factors(const Tensor<type, 2>& new_output_factors)
+{
+    output_factors = new_output_factors;
+}
+
+
+/// Sets the parameters of this layer.
+/// @param new_parameters Parameters vector, with the biases, the input factors and the output factors.
+/// @param index Position of the parameters of this layer in the vector.
+
+void LowRankPerceptronLayer::set_parameters(const Tensor<type, 1>& new_parameters, const Index& index)
+{
+    const Index biases_number = biases.size();
+    const Index input_factors_number = input_factors.size();
+    const Index output_factors_number = output_factors.size();
+
+#ifdef __OPENNN_DEBUG__
+
+    if(new_parameters.size() - index < biases_number + input_factors_number + output_factors_number)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: LowRankPerceptronLayer class.\n"
+               << "void set_parameters(const Tensor<type, 1>&, const Index&) method.\n"
+               << "Size of new parameters (" << new_parameters.size() << ") is too small.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+#endif
+
+    memcpy(biases.data(),
+           new_parameters.data() + index,
+           static_cast<size_t>(biases_number)*sizeof(type));
+
+    memcpy(input_factors.data(),
+           new_parameters.data() + index + biases_number,
+           static_cast<size_t>(input_factors_number)*sizeof(type));
+
+    memcpy(output_factors.data(),
+           new_parameters.data() + index + biases_number + input_factors_number,
+           static_cast<size_t>(output_factors_number)*sizeof(type));
+}
+
+
+/// Initializes the factors of the synaptic weights with Glorot uniform distributions, and the biases with zero.
+
+void LowRankPerceptronLayer::set_synaptic_weights_constant_glorot_uniform()
+{
+    const Index inputs_number = get_inputs_number();
+    const Index neurons_number = get_neurons_number();
+    const Index rank = get_rank();
+
+    const type input_factors_limit = sqrt(static_cast<type>(6)/static_cast<type>(inputs_number + rank));
+    const type output_factors_limit = sqrt(static_cast<type>(6)/static_cast<type>(rank + neurons_number));
+
+    biases.setZero();
+
+    input_factors.setRandom<Eigen::internal::UniformRandomGenerator<type>>();
+    input_factors = (input_factors*static_cast<type>(2) - static_cast<type>(1))*input_factors_limit;
+
+    output_factors.setRandom<Eigen::internal::UniformRandomGenerator<type>>();
+    output_factors = (output_factors*static_cast<type>(2) - static_cast<type>(1))*output_factors_limit;
+}
+
+
+/// Initializes the biases and both factors of the synaptic weights with a given value.
+/// @param value Parameters initialization value.
+
+void LowRankPerceptronLayer::set_parameters_constant(const type& value)
+{
+    biases.setConstant(value);
+
+    input_factors.setConstant(value);
+
+    output_factors.setConstant(value);
+}
+
+
+/// Initializes the parameters at random with a normal distribution.
+/// The output factors are scaled with the rank, so that the synaptic weights have unit variance.
+
+void LowRankPerceptronLayer::set_parameters_random()
+{
+    const Index rank = get_rank();
+
+    biases.setRandom<Eigen::internal::NormalRandomGenerator<type>>();
+
+    input_factors.setRandom<Eigen::internal::NormalRandomGenerator<type>>();
+
+    output_factors.setRandom<Eigen::internal::NormalRandomGenerator<type>>();
+
+    if(rank > 0) output_factors = output_factors/sqrt(static_cast<type>(rank));
+}
+
+
+/// Calculates the projections of a batch of inputs on the input factors.
+
+void LowRankPerceptronLayer::calculate_projections(const Tensor<type, 2>& inputs,
+                                                   const TensorMap<Tensor<type, 2>>& input_factors,
+                                                   Tensor<type, 2>& projections) const
+{
+    projections.device(*thread_pool_device) = inputs.contract(input_factors, A_B);
+}
+
+
+/// Calculates the projections of a batch of sparse inputs on the input factors.
+/// Only the rows of the input factors of the nonzero inputs are visited.
+
+void LowRankPerceptronLayer::calculate_projections(const CsrMatrix& inputs,
+                                                   const TensorMap<Tensor<type, 2>>& input_factors,
+                                                   Tensor<type, 2>& projections) const
+{
+    const Eigen::Map<const Eigen::Matrix<type, Eigen::Dynamic, Eigen::Dynamic>>
+            input_factors_matrix(input_factors.data(), input_factors.dimension(0), input_factors.dimension(1));
+
+    Eigen::Map<Eigen::Matrix<type, Eigen::Dynamic, Eigen::Dynamic>>
+            projections_matrix(projections.data(), projections.dimension(0), projections.dimension(1));
+
+    projections_matrix.noalias() = inputs*input_factors_matrix;
+}
+
+
+/// Calculates the outputs of the layer for a batch of inputs.
+
+Tensor<type, 2> LowRankPerceptronLayer::calculate_outputs(const Tensor<type, 2>& inputs)
+{
+    const Index batch_instances_number = inputs.dimension(0);
+
+    ForwardPropagation forward_propagation(batch_instances_number, this);
+
+    forward_propagate(inputs, forward_propagation);
+
+    return forward_propagation.activations_2d;
+}
+
+
+/// Calculates the forward propagation of the layer with its current parameters.
+/// @param inputs Inputs to the layer.
+/// @param forward_propagation Structure where the combinations, activations and activations derivatives are saved.
+
+void LowRankPerceptronLayer::forward_propagate(const Tensor<type, 2>& inputs,
+                                               ForwardPropagation& forward_propagation) const
+{
+    Tensor<type, 1> parameters = get_parameters();
+
+    const TensorMap<Tensor<type, 1>> parameters_map(parameters.data(), parameters.size());
+
+    forward_propagate(inputs, parameters_map, forward_propagation);
+}
+
+
+/// Calculates the forward propagation of the layer with the given parameters.
+/// The inputs are first projected on the input factors, and then the projections go through
+/// the fused forward propagation of the perceptron layer with the output factors as synaptic weights.
+/// @param inputs Inputs to the layer.
+/// @param potential_parameters Parameters of the layer, in the same order as get_parameters().
+/// @param forward_propagation Structure where the combinations, activations and activations derivatives are saved.
+
+void LowRankPerceptronLayer::forward_propagate(const Tensor<type, 2>& inputs,
+                                               const TensorMap<Tensor<type, 1>>& potential_parameters,
+                                               ForwardPropagation& forward_propagation) const
+{
+    const Index batch_instances_number = inputs.dimension(0);
+    const Index inputs_number = get_inputs_number();
+    const Index neurons_number = get_neurons_number();
+    const Index rank = get_rank();
+
+#ifdef __OPENNN_DEBUG__
+
+    if(inputs_number != inputs.dimension(1))
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: LowRankPerceptronLayer class.\n"
+               << "void forward_propagate(const Tensor<type, 2>&, const TensorMap<Tensor<type, 1>>&, ForwardPropagation&) method.\n"
+               << "Number of inputs columns (" << inputs.dimension(1) << ") must be equal to number of inputs ("
+               << inputs_number << ").\n";
+
+        throw logic_error(buffer.str());
+    }
+
+#endif
+
+    const TensorMap<Tensor<type, 2>> potential_biases(potential_parameters.data(), neurons_number, 1);
+
+    const TensorMap<Tensor<type, 2>> potential_input_factors(potential_parameters.data() + neurons_number,
+                                                             inputs_number, rank);
+
+    const TensorMap<Tensor<type, 2>> potential_output_factors(potential_parameters.data() + neurons_number + inputs_number*rank,
+                                                              rank, neurons_number);
+
+    Tensor<type, 2> projections(batch_instances_number, rank);
+
+    calculate_projections(inputs, potential_input_factors, projections);
+
+    PerceptronLayer::forward_propagate(projections, potential_biases, potential_output_factors, forward_propagation);
+}
+
+
+/// Calculates the forward propagation of a batch of sparse inputs with the current parameters.
+/// @param inputs Inputs to the layer, in compressed sparse row format.
+/// @param forward_propagation Structure where the combinations, activations and activations derivatives are saved.
+
+void LowRankPerceptronLayer::forward_propagate(const CsrMatrix& inputs,
+                                               ForwardPropagation& forward_propagation) const
+{
+    Tensor<type, 1> parameters = get_parameters();
+
+    const TensorMap<Tensor<type, 1>> parameters_map(parameters.data(), parameters.size());
+
+    forward_propagate(inputs, parameters_map, forward_propagation);
+}
+
+
+/// Calculates the forward propagation of a batch of sparse inputs with the given parameters.
+/// @param inputs Inputs to the layer, in compressed sparse row format.
+/// @param potential_parameters Parameters of the layer, in the same order as get_parameters().
+/// @param forward_propagation Structure where the combinations, activations and activations derivatives are saved.
+
+void LowRankPerceptronLayer::forward_propagate(const CsrMatrix& inputs,
+                                               const TensorMap<Tensor<type, 1>>& potential_parameters,
+                                               ForwardPropagation& forward_propagation) const
+{
+    const Index batch_instances_number = inputs.rows();
+    const Index inputs_number = get_inputs_number();
+    const Index neurons_number = get_neurons_number();
+    const Index rank = get_rank();
+
+#ifdef __OPENNN_DEBUG__
+
+    if(inputs_number != inputs.cols())
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: LowRankPerceptronLayer class.\n"
+               << "void forward_propagate(const CsrMatrix&, const TensorMap<Tensor<type, 1>>&, ForwardPropagation&) method.\n"
+               << "Number of inputs columns (" << inputs.cols() << ") must be equal to number of inputs ("
+               << inputs_number << ").\n";
+
+        throw logic_error(buffer.str());
+    }
+
+#endif
+
+    const TensorMap<Tensor<type, 2>> potential_biases(potential_parameters.data(), neurons_number, 1);
+
+    const TensorMap<Tensor<type, 2>> potential_input_factors(potential_parameters.data() + neurons_number,
+                                                             inputs_number, rank);
+
+    const TensorMap<Tensor<type, 2>> potential_output_factors(potential_parameters.data() + neurons_number + inputs_number*rank,
+                                                              rank, neurons_number);
+
+    Tensor<type, 2> projections(batch_instances_number, rank);
+
+    calculate_projections(inputs, potential_input_factors, projections);
+
+    PerceptronLayer::forward_propagate(projections, potential_biases, potential_output_factors, forward_propagation);
+}
+
+
+/// Calculates the biases and output factors derivatives from the projections of the inputs,
+/// and returns in the back-propagation delta the deltas of the projections.
+
+void LowRankPerceptronLayer::calculate_output_factors_derivatives(const Tensor<type, 2>& projections,
+                                                                  BackPropagation& back_propagation) const
+{
+    back_propagation.biases_derivatives.device(*thread_pool_device)
+            = back_propagation.delta.sum(Eigen::array<Index, 1>({0}));
+
+    back_propagation.output_factors_derivatives.device(*thread_pool_device)
+            = projections.contract(back_propagation.delta, AT_B);
+}
+
+
+/// Calculates the error gradient of the layer.
+/// The projections of the inputs are calculated again, so they need not be kept in the forward propagation.
+/// @param inputs Inputs to the layer.
+/// @param back_propagation Structure with the layer delta, where the derivatives are saved.
+
+void LowRankPerceptronLayer::calculate_error_gradient(const Tensor<type, 2>& inputs,
+                                                      const Layer::ForwardPropagation&,
+                                                      Layer::BackPropagation& back_propagation) const
+{
+    const Index batch_instances_number = inputs.dimension(0);
+    const Index rank = get_rank();
+
+    const TensorMap<Tensor<type, 2>> input_factors_map(const_cast<type*>(input_factors.data()),
+                                                       input_factors.dimension(0), input_factors.dimension(1));
+
+    Tensor<type, 2> projections(batch_instances_number, rank);
+
+    calculate_projections(inputs, input_factors_map, projections);
+
+    calculate_output_factors_derivatives(projections, back_propagation);
+
+    Tensor<type, 2>& projections_delta = projections;
+
+    projections_delta.device(*thread_pool_device) = back_propagation.delta.contract(output_factors, A_BT);
+
+    back_propagation.input_factors_derivatives.device(*thread_pool_device) = inputs.contract(projections_delta, AT_B);
+}
+
+
+/// Calculates the error gradient of the layer for a batch of sparse inputs.
+/// The input factors derivatives are a sum of outer products of the nonzero inputs and the projections deltas.
+/// @param inputs Inputs to the layer, in compressed sparse row format.
+/// @param back_propagation Structure with the layer delta, where the derivatives are saved.
+
+void LowRankPerceptronLayer::calculate_error_gradient(const CsrMatrix& inputs,
+                                                      const Layer::ForwardPropagation&,
+                                                      Layer::BackPropagation& back_propagation) const
+{
+    const Index batch_instances_number = inputs.rows();
+    const Index inputs_number = get_inputs_number();
+    const Index rank = get_rank();
+
+    const TensorMap<Tensor<type, 2>> input_factors_map(const_cast<type*>(input_factors.data()), inputs_number, rank);
+
+    Tensor<type, 2> projections(batch_instances_number, rank);
+
+    calculate_projections(inputs, input_factors_map, projections);
+
+    calculate_output_factors_derivatives(projections, back_propagation);
+
+    Tensor<type, 2>& projections_delta = projections;
+
+    projections_delta.device(*thread_pool_device) = back_propagation.delta.contract(output_factors, A_BT);
+
+    const Eigen::Map<const Eigen::Matrix<type, Eigen::Dynamic, Eigen::Dynamic>>
+            projections_delta_matrix(projections_delta.data(), batch_instances_number, rank);
+
+    Eigen::Map<Eigen::Matrix<type, Eigen::Dynamic, Eigen::Dynamic>>
+            input_factors_derivatives_matrix(back_propagation.input_factors_derivatives.data(), inputs_number, rank);
+
+    input_factors_derivatives_matrix.noalias() = inputs.transpose()*projections_delta_matrix;
+}
+
+
+/// Copies the biases, input factors and output factors derivatives to the gradient of the neural network.
+
+void LowRankPerceptronLayer::insert_gradient(const BackPropagation& back_propagation,
+                                             const Index& index,
+                                             Tensor<type, 1>& gradient) const
+{
+    const Index biases_number = biases.size();
+    const Index input_factors_number = input_factors.size();
+    const Index output_factors_number = output_factors.size();
+
+    memcpy(gradient.data() + index,
+           back_propagation.biases_derivatives.data(),
+           static_cast<size_t>(biases_number)*sizeof(type));
+
+    memcpy(gradient.data() + index + biases_number,
+           back_propagation.input_factors_derivatives.data(),
+           static_cast<size_t>(input_factors_number)*sizeof(type));
+
+    memcpy(gradient.data() + index + biases_number + input_factors_number,
+           back_propagation.output_factors_derivatives.data(),
+           static_cast<size_t>(output_factors_number)*sizeof(type));
+}
+
+
+/// Returns a string with the C function of the layer, which projects the inputs on the input factors
+/// before calculating the combinations.
+
+string LowRankPerceptronLayer::write_expression_c() const
+{
+    ostringstream buffer;
+
+    const Index inputs_number = get_inputs_number();
+    const Index neurons_number = get_neurons_number();
+    const Index rank = get_rank();
+
+    buffer << "vector<float> " << layer_name << "(const vector<float>& inputs)\n{" << endl;
+
+    buffer << "\tvector<float> projections(" << rank << ");\n" << endl;
+
+    for(Index k = 0; k < rank; k++)
+    {
+        buffer << "\tprojections[" << k << "] = 0";
+
+        for(Index j = 0; j < inputs_number; j++)
+        {
+             buffer << " +" << input_factors(j, k) << "*inputs[" << j << "]";
+        }
+
+        buffer << ";" << endl;
+    }
+
+    buffer << "\n\tvector<float> combinations(" << neurons_number << ");\n" << endl;
+
+    for(Index i = 0; i < neurons_number; i++)
+    {
+        buffer << "\tcombinations[" << i << "] = " << biases(i);
+
+        for(Index k = 0; k < rank; k++)
+        {
+             buffer << " +" << output_factors(k, i) << "*projections[" << k << "]";
+        }
+
+        buffer << ";" << endl;
+    }
+
+    buffer << write_activations_c();
+
+    buffer << "\n\treturn activations;\n}" << endl;
+
+    return buffer.str();
+}
+
+
+/// Returns the C function of the layer for a batch of inputs, which are stored by rows.
+/// The inputs of each instance are projected on the input factors in a small array on the stack,
+/// and the combinations are calculated from the projections and the output factors.
+
+string LowRankPerceptronLayer::write_batch_expression_c() const
+{
+    const Index inputs_number = get_inputs_number();
+    const Index neurons_number = get_neurons_number();
+    const Index rank = get_rank();
+
+    const Eigen::array<Index, 2> shuffle_dimensions = {1, 0};
+
+    const Tensor<type, 2> input_factors_transpose = input_factors.shuffle(shuffle_dimensions);
+    const Tensor<type, 2> output_factors_transpose = output_factors.shuffle(shuffle_dimensions);
+
+    ostringstream buffer;
+
+    buffer << write_array_c(layer_name + "_biases", biases.data(), neurons_number);
+    buffer << write_array_c(layer_name + "_input_factors", input_factors_transpose.data(), inputs_number*rank);
+    buffer << write_array_c(layer_name + "_output_factors", output_factors_transpose.data(), rank*neurons_number);
+
+    buffer << "static void " << layer_name << "(const float* inputs, float* outputs, int batch_size)\n{" << endl;
+
+    buffer << "\tfor(int i = 0; i < batch_size; i++)\n\t{" << endl;
+
+    buffer << "\t\tfloat projections[" << (rank > 0 ? rank : 1) << "];\n" << endl;
+
+    buffer << "\t\tcalculate_combinations(inputs + i*" << inputs_number << ", 1, " << inputs_number << ", " << rank << ", "
+           << "0, " << layer_name << "_input_factors, projections);" << endl;
+
+    buffer << "\t\tcalculate_combinations(projections, 1, " << rank << ", " << neurons_number << ", "
+           << layer_name << "_biases, " << layer_name << "_output_factors, outputs + i*" << neurons_number << ");" << endl;
+
+    buffer << "\t}" << endl;
+
+    buffer << write_batch_activations_c();
+
+    buffer << "}\n" << endl;
+
+    return buffer.str();
+}
+
+
+/// Returns a string with the python function of the layer, which projects the inputs on the input factors
+/// before calculating the combinations.
+
+string LowRankPerceptronLayer::write_expression_python() const
+{
+    ostringstream buffer;
+
+    const Index inputs_number = get_inputs_number();
+    const Index neurons_number = get_neurons_number();
+    const Index rank = get_rank();
+
+    buffer << "def " << layer_name << "(inputs):\n" << endl;
+
+    buffer << "\tprojections = [None] * " << rank << "\n" << endl;
+
+    for(Index k = 0; k < rank; k++)
+    {
+        buffer << "\tprojections[" << k << "] = 0";
+
+        for(Index j = 0; j < inputs_number; j++)
+        {
+             buffer << " +" << input_factors(j, k) << "*inputs[" << j << "]";
+        }
+
+        buffer << " " << endl;
+    }
+
+    buffer << "\n\tcombinations = [None] * " << neurons_number << "\n" << endl;
+
+    for(Index i = 0; i < neurons_number; i++)
+    {
+        buffer << "\tcombinations[" << i << "] = " << biases(i);
+
+        for(Index k = 0; k < rank; k++)
+        {
+             buffer << " +" << output_factors(k, i) << "*projections[" << k << "]";
+        }
+
+        buffer << " " << endl;
+    }
+
+    buffer << "\t" << endl;
+
+    buffer << write_activations_python();
+
+    buffer << "\n\treturn activations;\n" << endl;
+
+    return buffer.str();
+}
+
+
+/// Loads the low rank perceptron layer from a XML document.
+/// @param document TinyXML document with the member data.
+
+void LowRankPerceptronLayer::from_XML(const tinyxml2::XMLDocument& document)
+{
+    ostringstream buffer;
+
+    // Low rank perceptron layer
+
+    const tinyxml2::XMLElement* low_rank_perceptron_layer_element = document.FirstChildElement("LowRankPerceptronLayer");
+
+    if(!low_rank_perceptron_layer_element)
+    {
+        buffer << "OpenNN Exception: LowRankPerceptronLayer class.\n"
+               << "void from_XML(const tinyxml2::XMLDocument&) method.\n"
+               << "LowRankPerceptronLayer element is nullptr.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    // Inputs number, neurons number and rank
+
+    const string elements_names[] = {"InputsNumber", "NeuronsNumber", "Rank"};
+
+    Index architecture[3] = {0, 0, 0};
+
+    for(Index i = 0; i < 3; i++)
+    {
+        const tinyxml2::XMLElement* element = low_rank_perceptron_layer_element->FirstChildElement(elements_names[i].c_str());
+
+        if(!element)
+        {
+            buffer << "OpenNN Exception: LowRankPerceptronLayer class.\n"
+                   << "void from_XML(const tinyxml2::XMLDocument&) method.\n"
+                   << elements_names[i] << " element is nullptr.\n";
+
+            throw logic_error(buffer.str());
+        }
+
+        if(element->GetText())
+        {
+            architecture[i] = static_cast<Index>(stoi(element->GetText()));
+        }
+    }
+
+    set(architecture[0], architecture[1], architecture[2]);
+
+    // Activation function
+
+    const tinyxml2::XMLElement* activation_function_element = low_rank_perceptron_layer_element->FirstChildElement("ActivationFunction");
+
+    if(!activation_function_element)
+    {
+        buffer << "OpenNN Exception: LowRankPerceptronLayer class.\n"
+               << "void from_XML(const tinyxml2::XMLDocument&) method.\n"
+               << "ActivationFunction element is nullptr.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    if(activation_function_element->GetText())
+    {
+        set_activation_function(activation_function_element->GetText());
+    }
+
+    // Parameters
+
+    const tinyxml2::XMLElement* parameters_element = low_rank_perceptron_layer_element->FirstChildElement("Parameters");
+
+    if(!parameters_element)
+    {
+        buffer << "OpenNN Exception: LowRankPerceptronLayer class.\n"
+               << "void from_XML(const tinyxml2::XMLDocument&) method.\n"
+               << "Parameters element is nullptr.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    if(parameters_element->GetText())
+    {
+        const string parameters_string = parameters_element->GetText();
+
+        set_parameters(to_type_vector(parameters_string, ' '));
+    }
+}
+
+
+/// Serializes the low rank perceptron layer object into a XML document of the TinyXML library without keep the DOM tree in memory.
+/// See the OpenNN manual for more information about the format of this document.
+
+void LowRankPerceptronLayer::write_XML(tinyxml2::XMLPrinter& file_stream) const
+{
+    ostringstream buffer;
+
+    // Low rank perceptron layer
+
+    file_stream.OpenElement("LowRankPerceptronLayer");
+
+    // Inputs number
+
+    file_stream.OpenElement("InputsNumber");
+
+    buffer.str("");
+    buffer << get_inputs_number();
+
+    file_stream.PushText(buffer.str().c_str());
+
+    file_stream.CloseElement();
+
+    // Outputs number
+
+    file_stream.OpenElement("NeuronsNumber");
+
+    buffer.str("");
+    buffer << get_neurons_number();
+
+    file_stream.PushText(buffer.str().c_str());
+
+    file_stream.CloseElement();
+
+    // Rank
+
+    file_stream.OpenElement("Rank");
+
+    buffer.str("");
+    buffer << get_rank();
+
+    file_stream.PushText(buffer.str().c_str());
+
+    file_stream.CloseElement();
+
+    // Activation function
+
+    file_stream.OpenElement("ActivationFunction");
+
+    file_stream.PushText(write_activation_function().c_str());
+
+    file_stream.CloseElement();
+
+    // Parameters
+
+    file_stream.OpenElement("Parameters");
+
+    buffer.str("");
+
+    const Tensor<type, 1> parameters = get_parameters();
+    const Index parameters_size = parameters.size();
+
+    for(Index i = 0; i < parameters_size; i++)
+    {
+        buffer << parameters(i);
+
+        if(i != (parameters_size-1)) buffer << " ";
+    }
+
+    file_stream.PushText(buffer.str().c_str());
+
+    file_stream.CloseElement();
+
+    // Low rank peceptron layer (end tag)
+
+    file_stream.CloseElement();
+}
+
+}
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
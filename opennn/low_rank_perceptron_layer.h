@@ -0,0 +1,186 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   L O W   R A N K   P E R C E P T R O N   L A Y E R   C L A S S   H E A D E R
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#ifndef LOWRANKPERCEPTRONLAYER_H
+#define LOWRANKPERCEPTRONLAYER_H
+
+// System includes
+
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <sstream>
+
+// OpenNN includes
+
+#include "config.h"
+#include "layer.h"
+#include "perceptron_layer.h"
+#include "opennn_strings.h"
+
+namespace OpenNN
+{
+
+/// This class represents a layer of perceptrons whose synaptic weights are factorized with a low rank.
+
+///
+/// The synaptic weights are the product of an inputs_number x rank matrix of input factors
+/// and a rank x neurons_number matrix of output factors.
+/// For very wide inputs, this reduces the number of parameters and the operations
+/// from inputs_number*neurons_number to rank*(inputs_number + neurons_number).
+/// The activation functions are those of the perceptron layer.
+
+class LowRankPerceptronLayer : public PerceptronLayer
+{
+
+public:
+
+   // Constructors
+
+   explicit LowRankPerceptronLayer();
+
+   explicit LowRankPerceptronLayer(const Index&, const Index&, const Index&,
+                                   const ActivationFunction& = PerceptronLayer::HyperbolicTangent);
+
+   LowRankPerceptronLayer(const LowRankPerceptronLayer&);
+
+   // Destructor
+
+   virtual ~LowRankPerceptronLayer();
+
+   // Get methods
+
+   Index get_inputs_number() const;
+
+   Index get_rank() const;
+
+   // Parameters
+
+   const Tensor<type, 2>& get_input_factors() const;
+   const Tensor<type, 2>& get_output_factors() const;
+
+   Tensor<type, 2> get_synaptic_weights() const;
+
+   Index get_synaptic_weights_number() const;
+   Index get_parameters_number() const;
+   Tensor<type, 1> get_parameters() const;
+
+   // Set methods
+
+   void set();
+   void set(const Index&, const Index&, const Index&, const ActivationFunction& = PerceptronLayer::HyperbolicTangent);
+   void set(const LowRankPerceptronLayer&);
+
+   void set_default();
+
+   // Architecture
+
+   void set_inputs_number(const Index&);
+   void set_neurons_number(const Index&);
+   void set_rank(const Index&);
+
+   void resize_inputs(const Tensor<Index, 1>&);
+   void resize_neurons(const Index&);
+
+   // Parameters
+
+   void set_input_factors(const Tensor<type, 2>&);
+   void set_output_factors(const Tensor<type, 2>&);
+
+   void set_parameters(const Tensor<type, 1>&, const Index& index=0);
+
+   // Parameters initialization methods
+
+   void set_synaptic_weights_constant_glorot_uniform();
+
+   void set_parameters_constant(const type&);
+
+   void set_parameters_random();
+
+   // Low rank perceptron layer outputs
+
+   Tensor<type, 2> calculate_outputs(const Tensor<type, 2>&);
+
+   void forward_propagate(const Tensor<type, 2>& inputs,
+                          ForwardPropagation& forward_propagation) const;
+
+   void forward_propagate(const Tensor<type, 2>& inputs,
+                          const TensorMap<Tensor<type, 1>>& potential_parameters,
+                          ForwardPropagation& forward_propagation) const;
+
+   void forward_propagate(const CsrMatrix& inputs,
+                          ForwardPropagation& forward_propagation) const;
+
+   void forward_propagate(const CsrMatrix& inputs,
+                          const TensorMap<Tensor<type, 1>>& potential_parameters,
+                          ForwardPropagation& forward_propagation) const;
+
+   // Gradient methods
+
+   void calculate_error_gradient(const Tensor<type, 2>& inputs,
+                                 const Layer::ForwardPropagation&,
+                                 Layer::BackPropagation& back_propagation) const;
+
+   void calculate_error_gradient(const CsrMatrix& inputs,
+                                 const Layer::ForwardPropagation&,
+                                 Layer::BackPropagation& back_propagation) const;
+
+   void insert_gradient(const BackPropagation& back_propagation, const Index& index, Tensor<type, 1>& gradient) const;
+
+   // Expression methods
+
+   string write_expression_c() const;
+   string write_batch_expression_c() const;
+   string write_expression_python() const;
+
+   // Serialization methods
+
+   void from_XML(const tinyxml2::XMLDocument&);
+   void write_XML(tinyxml2::XMLPrinter&) const;
+
+protected:
+
+   void calculate_projections(const Tensor<type, 2>&, const TensorMap<Tensor<type, 2>>&, Tensor<type, 2>&) const;
+   void calculate_projections(const CsrMatrix&, const TensorMap<Tensor<type, 2>>&, Tensor<type, 2>&) const;
+
+   void calculate_output_factors_derivatives(const Tensor<type, 2>&, BackPropagation&) const;
+
+   // MEMBERS
+
+   /// Inputs_number x rank matrix with the first factor of the synaptic weights.
+
+   Tensor<type, 2> input_factors;
+
+   /// Rank x neurons_number matrix with the second factor of the synaptic weights.
+
+   Tensor<type, 2> output_factors;
+};
+
+}
+
+#endif
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
@@ -0,0 +1,1607 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   M O D E L   S E R V E R   C L A S S
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#include "model_server.h"
+
+#ifndef _WIN32
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#endif
+
+namespace OpenNN
+{
+
+/// Default constructor.
+/// It creates a stopped model server without model file.
+
+ModelServer::ModelServer()
+{
+    running = false;
+
+    set();
+}
+
+
+/// Model file constructor.
+/// It creates a stopped model server for a model file.
+/// @param new_model_file_name Name of the model file, in the binary model format or in XML.
+
+ModelServer::ModelServer(const string& new_model_file_name)
+{
+    running = false;
+
+    set(new_model_file_name);
+}
+
+
+/// Destructor.
+/// It stops the server if it is running.
+
+ModelServer::~ModelServer()
+{
+    stop();
+}
+
+
+/// Returns the name of the model file.
+
+const string& ModelServer::get_model_file_name() const
+{
+    return model_file_name;
+}
+
+
+/// Returns the address of the TCP socket.
+
+const string& ModelServer::get_address() const
+{
+    return address;
+}
+
+
+/// Returns the port of the TCP socket. While the server runs, it is the bound port, also when an ephemeral port was asked.
+
+int ModelServer::get_port() const
+{
+    return port;
+}
+
+
+/// Returns the path of the Unix socket, or an empty string if the server listens on the TCP socket.
+
+const string& ModelServer::get_unix_socket_path() const
+{
+    return unix_socket_path;
+}
+
+
+/// Returns the maximum number of instances of a batch.
+
+const Index& ModelServer::get_maximum_batch_instances_number() const
+{
+    return maximum_batch_instances_number;
+}
+
+
+/// Returns the maximum time that a request waits for a batch to be filled, in seconds.
+
+const type& ModelServer::get_maximum_batch_delay() const
+{
+    return maximum_batch_delay;
+}
+
+
+/// Returns the number of workers which calculate the batches.
+
+const Index& ModelServer::get_workers_number() const
+{
+    return workers_number;
+}
+
+
+/// Returns the number of threads of the thread pools of the copy of the neural network of each worker.
+
+const Index& ModelServer::get_worker_threads_number() const
+{
+    return worker_threads_number;
+}
+
+
+/// Returns true if messages from this class are to be displayed on the screen, or false if messages
+/// from this class are not to be displayed on the screen.
+
+const bool& ModelServer::get_display() const
+{
+    return display;
+}
+
+
+/// Returns true if the server is running, and false otherwise.
+
+bool ModelServer::is_running() const
+{
+    return running;
+}
+
+
+/// Returns the counters of the server since it started, the latency percentiles of the latest requests,
+/// and the throughputs since the server started.
+
+ModelServer::Statistics ModelServer::get_statistics() const
+{
+    lock_guard<mutex> lock(statistics_mutex);
+
+    Statistics statistics = counters;
+
+    const size_t latencies_number = min(static_cast<size_t>(latencies_count), latencies.size());
+
+    if(latencies_number != 0)
+    {
+        vector<type> sorted_latencies(latencies.begin(), latencies.begin() + static_cast<ptrdiff_t>(latencies_number));
+
+        const size_t p50_index = (latencies_number - 1)/2;
+        const size_t p99_index = static_cast<size_t>(ceil(0.99*static_cast<double>(latencies_number))) - 1;
+
+        nth_element(sorted_latencies.begin(), sorted_latencies.begin() + static_cast<ptrdiff_t>(p50_index), sorted_latencies.end());
+
+        statistics.latency_p50 = sorted_latencies[p50_index];
+
+        nth_element(sorted_latencies.begin(), sorted_latencies.begin() + static_cast<ptrdiff_t>(p99_index), sorted_latencies.end());
+
+        statistics.latency_p99 = sorted_latencies[p99_index];
+    }
+
+    if(beginning_time != chrono::steady_clock::time_point())
+    {
+        statistics.elapsed_time = static_cast<type>(chrono::duration<double>(chrono::steady_clock::now() - beginning_time).count());
+    }
+
+    if(statistics.elapsed_time > 0)
+    {
+        statistics.requests_per_second = static_cast<type>(statistics.requests_number)/statistics.elapsed_time;
+        statistics.instances_per_second = static_cast<type>(statistics.instances_number)/statistics.elapsed_time;
+    }
+
+    return statistics;
+}
+
+
+/// Sets a model server without model file, with the default values.
+
+void ModelServer::set()
+{
+    check_stopped("void set()");
+
+    model_file_name.clear();
+
+    set_default();
+}
+
+
+/// Sets a model server for a model file, with the default values.
+/// @param new_model_file_name Name of the model file, in the binary model format or in XML.
+
+void ModelServer::set(const string& new_model_file_name)
+{
+    check_stopped("void set(const string&)");
+
+    model_file_name = new_model_file_name;
+
+    set_default();
+}
+
+
+/// Sets the members of the model server to their default values:
+/// <ul>
+/// <li> TCP socket on 127.0.0.1 and an ephemeral port.
+/// <li> Batches of up to 64 instances, which wait for at most 1 millisecond.
+/// <li> As many workers as OpenMP threads, with one thread each.
+/// <li> Display: true.
+/// </ul>
+
+void ModelServer::set_default()
+{
+    check_stopped("void set_default()");
+
+    address = "127.0.0.1";
+
+    port = 0;
+
+    unix_socket_path.clear();
+
+    maximum_batch_instances_number = 64;
+
+    maximum_batch_delay = static_cast<type>(0.001);
+
+    workers_number = omp_get_max_threads();
+
+    worker_threads_number = 1;
+
+    display = true;
+}
+
+
+/// Sets a new model file. It is loaded when the server starts.
+/// @param new_model_file_name Name of the model file, in the binary model format or in XML.
+
+void ModelServer::set_model_file_name(const string& new_model_file_name)
+{
+    check_stopped("void set_model_file_name(const string&)");
+
+    model_file_name = new_model_file_name;
+}
+
+
+/// Sets a new IPv4 address for the TCP socket.
+/// @param new_address Address, such as "127.0.0.1".
+
+void ModelServer::set_address(const string& new_address)
+{
+    check_stopped("void set_address(const string&)");
+
+    address = new_address;
+}
+
+
+/// Sets a new port for the TCP socket.
+/// @param new_port Port, or 0 for an ephemeral port.
+
+void ModelServer::set_port(const int& new_port)
+{
+    check_stopped("void set_port(const int&)");
+
+    if(new_port < 0 || new_port > 65535)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: ModelServer class.\n"
+               << "void set_port(const int&) method.\n"
+               << "Port (" << new_port << ") must be between 0 and 65535.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    port = new_port;
+}
+
+
+/// Sets the path of a Unix socket on which to listen instead of the TCP socket.
+/// @param new_unix_socket_path Path of the socket, or an empty string to listen on the TCP socket.
+
+void ModelServer::set_unix_socket_path(const string& new_unix_socket_path)
+{
+    check_stopped("void set_unix_socket_path(const string&)");
+
+    unix_socket_path = new_unix_socket_path;
+}
+
+
+/// Sets the maximum number of instances of a batch.
+/// Larger requests are calculated alone.
+/// @param new_maximum_batch_instances_number Maximum number of instances.
+
+void ModelServer::set_maximum_batch_instances_number(const Index& new_maximum_batch_instances_number)
+{
+    check_stopped("void set_maximum_batch_instances_number(const Index&)");
+
+    if(new_maximum_batch_instances_number <= 0)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: ModelServer class.\n"
+               << "void set_maximum_batch_instances_number(const Index&) method.\n"
+               << "Maximum number of instances of a batch must be greater than 0.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    maximum_batch_instances_number = new_maximum_batch_instances_number;
+}
+
+
+/// Sets the maximum time that a request waits for a batch to be filled.
+/// @param new_maximum_batch_delay Maximum delay in seconds, or 0 to calculate the requests as they are.
+
+void ModelServer::set_maximum_batch_delay(const type& new_maximum_batch_delay)
+{
+    check_stopped("void set_maximum_batch_delay(const type&)");
+
+    if(new_maximum_batch_delay < 0)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: ModelServer class.\n"
+               << "void set_maximum_batch_delay(const type&) method.\n"
+               << "Maximum batch delay (" << new_maximum_batch_delay << ") must be equal or greater than 0.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    maximum_batch_delay = new_maximum_batch_delay;
+}
+
+
+/// Sets the number of workers which calculate the batches.
+/// @param new_workers_number Number of workers.
+
+void ModelServer::set_workers_number(const Index& new_workers_number)
+{
+    check_stopped("void set_workers_number(const Index&)");
+
+    if(new_workers_number <= 0)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: ModelServer class.\n"
+               << "void set_workers_number(const Index&) method.\n"
+               << "Number of workers must be greater than 0.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    workers_number = new_workers_number;
+}
+
+
+/// Sets the number of threads of the thread pools of the copy of the neural network of each worker.
+/// @param new_worker_threads_number Number of threads per worker.
+
+void ModelServer::set_worker_threads_number(const Index& new_worker_threads_number)
+{
+    check_stopped("void set_worker_threads_number(const Index&)");
+
+    if(new_worker_threads_number <= 0)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: ModelServer class.\n"
+               << "void set_worker_threads_number(const Index&) method.\n"
+               << "Number of threads per worker must be greater than 0.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    worker_threads_number = new_worker_threads_number;
+}
+
+
+/// Sets a new display value.
+/// If it is set to true messages from this class are to be displayed on the screen;
+/// if it is set to false messages from this class are not to be displayed on the screen.
+/// @param new_display Display value.
+
+void ModelServer::set_display(const bool& new_display)
+{
+    display = new_display;
+}
+
+
+/// Loads a copy of the neural network for each worker, opens the socket and starts serving.
+/// The statistics are reset.
+
+void ModelServer::start()
+{
+    check_stopped("void start()");
+
+#ifdef _WIN32
+
+    ostringstream buffer;
+
+    buffer << "OpenNN Exception: ModelServer class.\n"
+           << "void start() method.\n"
+           << "The model server is not supported on this platform.\n";
+
+    throw logic_error(buffer.str());
+
+#else
+
+    load_neural_networks();
+
+    try
+    {
+        open_listening_socket();
+    }
+    catch(const logic_error&)
+    {
+        delete_neural_networks();
+
+        throw;
+    }
+
+    {
+        lock_guard<mutex> lock(statistics_mutex);
+
+        counters = Statistics();
+
+        latencies.assign(10000, 0);
+
+        latencies_count = 0;
+
+        beginning_time = chrono::steady_clock::now();
+    }
+
+    running = true;
+
+    workers.clear();
+
+    for(Index i = 0; i < workers_number; i++)
+    {
+        workers.push_back(thread(&ModelServer::calculate_batches, this, i));
+    }
+
+    acceptor = thread(&ModelServer::accept_connections, this);
+
+    if(display)
+    {
+        cout << "Serving " << model_file_name << " on ";
+
+        if(unix_socket_path.empty())
+        {
+            cout << address << ":" << port;
+        }
+        else
+        {
+            cout << unix_socket_path;
+        }
+
+        cout << " with " << workers_number << " workers.\n";
+    }
+
+#endif
+}
+
+
+/// Stops accepting connections, answers the queued requests, closes the connections and stops the workers.
+
+void ModelServer::stop()
+{
+#ifndef _WIN32
+
+    if(!acceptor.joinable()) return;
+
+    {
+        lock_guard<mutex> lock(requests_mutex);
+
+        running = false;
+    }
+
+    requests_condition.notify_all();
+
+    acceptor.join();
+
+    if(listening_socket >= 0)
+    {
+        close(listening_socket);
+
+        listening_socket = -1;
+    }
+
+    if(!unix_socket_path.empty()) unlink(unix_socket_path.c_str());
+
+    {
+        lock_guard<mutex> lock(connections_mutex);
+
+        for(auto& connection : connections)
+        {
+            if(connection->socket >= 0) shutdown(connection->socket, SHUT_RDWR);
+        }
+    }
+
+    join_finished_connections(true);
+
+    for(size_t i = 0; i < workers.size(); i++)
+    {
+        workers[i].join();
+    }
+
+    workers.clear();
+
+    delete_neural_networks();
+
+    if(display) cout << "Model server stopped.\n";
+
+#endif
+}
+
+
+/// Throws an exception if the server is running.
+/// @param method Signature of the calling method.
+
+void ModelServer::check_stopped(const string& method) const
+{
+    if(running)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: ModelServer class.\n"
+               << method << " method.\n"
+               << "Model server must be stopped.\n";
+
+        throw logic_error(buffer.str());
+    }
+}
+
+
+/// Loads a copy of the neural network for each worker from the model file, with a thread pool of the threads budget of one worker.
+/// Files which begin with the magic of the binary model format are loaded as binary models, and the rest as XML.
+
+void ModelServer::load_neural_networks()
+{
+    ifstream file(model_file_name.c_str(), ios::binary);
+
+    if(!file.is_open() || model_file_name.empty())
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: ModelServer class.\n"
+               << "void load_neural_networks() method.\n"
+               << "Cannot open model file: " << model_file_name << "\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    char magic[8] = {0};
+
+    file.read(magic, 8);
+
+    const bool is_binary_model = file.gcount() == 8 && string(magic, 8) == "OPENNNBM";
+
+    file.close();
+
+    const int threads_number = static_cast<int>(worker_threads_number);
+
+    thread_pools.resize(static_cast<size_t>(workers_number));
+    thread_pool_devices.resize(static_cast<size_t>(workers_number));
+    neural_networks.resize(static_cast<size_t>(workers_number));
+
+    try
+    {
+        for(size_t i = 0; i < neural_networks.size(); i++)
+        {
+            thread_pools[i].reset(new NonBlockingThreadPool(threads_number));
+
+            thread_pool_devices[i].reset(new ThreadPoolDevice(thread_pools[i].get(), threads_number));
+
+            neural_networks[i].reset(new NeuralNetwork);
+
+            if(is_binary_model)
+            {
+                neural_networks[i]->load_binary(model_file_name);
+            }
+            else
+            {
+                neural_networks[i]->load(model_file_name);
+            }
+
+            neural_networks[i]->set_display(false);
+
+            neural_networks[i]->set_thread_pool_device(thread_pool_devices[i].get());
+        }
+    }
+    catch(const logic_error&)
+    {
+        delete_neural_networks();
+
+        throw;
+    }
+
+    inputs_number = neural_networks[0]->get_inputs_number();
+    outputs_number = neural_networks[0]->get_outputs_number();
+
+    if(inputs_number == 0 || neural_networks[0]->get_layers_number() == 0)
+    {
+        delete_neural_networks();
+
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: ModelServer class.\n"
+               << "void load_neural_networks() method.\n"
+               << "Neural network of " << model_file_name << " has no inputs or no layers.\n";
+
+        throw logic_error(buffer.str());
+    }
+}
+
+
+/// Deletes the copies of the neural network, and then their thread pools.
+
+void ModelServer::delete_neural_networks()
+{
+    neural_networks.clear();
+
+    thread_pool_devices.clear();
+
+    thread_pools.clear();
+}
+
+
+/// Opens the listening socket on the Unix socket path if it is set, or on the TCP address and port otherwise.
+
+void ModelServer::open_listening_socket()
+{
+#ifndef _WIN32
+
+    ostringstream buffer;
+
+    buffer << "OpenNN Exception: ModelServer class.\n"
+           << "void open_listening_socket() method.\n";
+
+    if(!unix_socket_path.empty())
+    {
+        sockaddr_un socket_address;
+
+        memset(&socket_address, 0, sizeof(socket_address));
+
+        if(unix_socket_path.size() >= sizeof(socket_address.sun_path))
+        {
+            buffer << "Unix socket path is too long: " << unix_socket_path << "\n";
+
+            throw logic_error(buffer.str());
+        }
+
+        socket_address.sun_family = AF_UNIX;
+
+        strncpy(socket_address.sun_path, unix_socket_path.c_str(), sizeof(socket_address.sun_path) - 1);
+
+        unlink(unix_socket_path.c_str());
+
+        listening_socket = socket(AF_UNIX, SOCK_STREAM, 0);
+
+        if(listening_socket < 0
+        || ::bind(listening_socket, reinterpret_cast<sockaddr*>(&socket_address), sizeof(socket_address)) < 0
+        || listen(listening_socket, 128) < 0)
+        {
+            if(listening_socket >= 0) close(listening_socket);
+
+            listening_socket = -1;
+
+            buffer << "Cannot listen on Unix socket: " << unix_socket_path << "\n";
+
+            throw logic_error(buffer.str());
+        }
+
+        return;
+    }
+
+    sockaddr_in socket_address;
+
+    memset(&socket_address, 0, sizeof(socket_address));
+
+    socket_address.sin_family = AF_INET;
+    socket_address.sin_port = htons(static_cast<uint16_t>(port));
+
+    if(inet_pton(AF_INET, address.c_str(), &socket_address.sin_addr) != 1)
+    {
+        buffer << "Invalid IPv4 address: " << address << "\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    listening_socket = socket(AF_INET, SOCK_STREAM, 0);
+
+    const int reuse_address = 1;
+
+    if(listening_socket >= 0)
+    {
+        setsockopt(listening_socket, SOL_SOCKET, SO_REUSEADDR, &reuse_address, sizeof(reuse_address));
+    }
+
+    socklen_t address_length = sizeof(socket_address);
+
+    if(listening_socket < 0
+    || ::bind(listening_socket, reinterpret_cast<sockaddr*>(&socket_address), sizeof(socket_address)) < 0
+    || listen(listening_socket, 128) < 0
+    || getsockname(listening_socket, reinterpret_cast<sockaddr*>(&socket_address), &address_length) < 0)
+    {
+        if(listening_socket >= 0) close(listening_socket);
+
+        listening_socket = -1;
+
+        buffer << "Cannot listen on " << address << ":" << port << ".\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    port = ntohs(socket_address.sin_port);
+
+#endif
+}
+
+
+/// Accepts the connections while the server runs, and starts a thread for each one.
+/// It polls the listening socket with a timeout, so that it notices when the server is stopped.
+
+void ModelServer::accept_connections()
+{
+#ifndef _WIN32
+
+    while(running)
+    {
+        pollfd poll_descriptor;
+
+        poll_descriptor.fd = listening_socket;
+        poll_descriptor.events = POLLIN;
+        poll_descriptor.revents = 0;
+
+        const int ready = poll(&poll_descriptor, 1, 100);
+
+        join_finished_connections(false);
+
+        if(ready <= 0 || !(poll_descriptor.revents & POLLIN)) continue;
+
+        const int connection_socket = accept(listening_socket, nullptr, nullptr);
+
+        if(connection_socket < 0) continue;
+
+        if(unix_socket_path.empty())
+        {
+            const int no_delay = 1;
+
+            setsockopt(connection_socket, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+        }
+
+        lock_guard<mutex> lock(connections_mutex);
+
+        connections.push_back(unique_ptr<Connection>(new Connection));
+
+        Connection* connection = connections.back().get();
+
+        connection->socket = connection_socket;
+
+        connection->reader = thread(&ModelServer::serve_connection, this, connection);
+    }
+
+#endif
+}
+
+
+/// Joins the threads of the finished connections, or of all of them, and deletes them.
+/// @param all True to join all the connections, which must have been shut down.
+
+void ModelServer::join_finished_connections(const bool& all)
+{
+    list<unique_ptr<Connection>> finished_connections;
+
+    {
+        lock_guard<mutex> lock(connections_mutex);
+
+        for(auto iterator = connections.begin(); iterator != connections.end();)
+        {
+            if(all || (*iterator)->finished)
+            {
+                finished_connections.push_back(move(*iterator));
+
+                iterator = connections.erase(iterator);
+            }
+            else
+            {
+                ++iterator;
+            }
+        }
+    }
+
+    for(auto& connection : finished_connections)
+    {
+        if(connection->reader.joinable()) connection->reader.join();
+    }
+}
+
+
+/// Reads and answers the requests of a connection until it is closed, a request is malformed or the server stops.
+/// @param connection Connection to serve.
+
+void ModelServer::serve_connection(Connection* connection)
+{
+#ifndef _WIN32
+
+    while(running)
+    {
+        if(!receive(connection, 1)) break;
+
+        const char first_byte = connection->buffer[0];
+
+        if(first_byte == '\n' || first_byte == '\r' || first_byte == ' ' || first_byte == '\t')
+        {
+            connection->buffer.erase(0, 1);
+
+            continue;
+        }
+
+        bool keep_open = false;
+
+        if(first_byte == 'O')
+        {
+            keep_open = serve_binary_request(connection);
+        }
+        else if(first_byte == '{')
+        {
+            keep_open = serve_json_request(connection);
+        }
+        else
+        {
+            send_all(connection->socket, "{\"error\": \"Unknown protocol.\"}\n");
+        }
+
+        if(!keep_open) break;
+    }
+
+    lock_guard<mutex> lock(connections_mutex);
+
+    close(connection->socket);
+
+    connection->socket = -1;
+
+    connection->finished = true;
+
+#endif
+}
+
+
+/// Reads and answers a binary request.
+/// Returns false if the connection must be closed.
+/// @param connection Connection of the request.
+
+bool ModelServer::serve_binary_request(Connection* connection)
+{
+    const size_t header_size = 4 + 2*sizeof(uint32_t);
+
+    // The response header has the magic, the status and two sizes
+
+    const auto write_response = [&](const uint32_t& status, const uint32_t& rows_number, const uint32_t& columns_number, const string& payload)
+    {
+        string response("ONNB", 4);
+
+        response.append(reinterpret_cast<const char*>(&status), sizeof(uint32_t));
+        response.append(reinterpret_cast<const char*>(&rows_number), sizeof(uint32_t));
+        response.append(reinterpret_cast<const char*>(&columns_number), sizeof(uint32_t));
+        response.append(payload);
+
+        return send_all(connection->socket, response);
+    };
+
+    const auto write_error = [&](const string& message)
+    {
+        return write_response(1, 0, static_cast<uint32_t>(message.size()), message);
+    };
+
+    if(!receive(connection, header_size)) return false;
+
+    if(connection->buffer.compare(0, 4, "ONNB") != 0)
+    {
+        write_error("Unknown binary magic.");
+
+        return false;
+    }
+
+    uint32_t request_instances_number = 0;
+    uint32_t request_inputs_number = 0;
+
+    memcpy(&request_instances_number, connection->buffer.data() + 4, sizeof(uint32_t));
+    memcpy(&request_inputs_number, connection->buffer.data() + 4 + sizeof(uint32_t), sizeof(uint32_t));
+
+    const uint64_t payload_size = static_cast<uint64_t>(request_instances_number)*request_inputs_number*sizeof(type);
+
+    if(payload_size > (static_cast<uint64_t>(1) << 30))
+    {
+        write_error("Request is larger than 1 GiB.");
+
+        return false;
+    }
+
+    if(!receive(connection, header_size + static_cast<size_t>(payload_size))) return false;
+
+    const char* payload = connection->buffer.data() + header_size;
+
+    if(request_inputs_number != static_cast<uint32_t>(inputs_number) || request_instances_number == 0)
+    {
+        connection->buffer.erase(0, header_size + static_cast<size_t>(payload_size));
+
+        lock_guard<mutex> lock(statistics_mutex);
+
+        counters.errors_number++;
+
+        ostringstream message;
+
+        message << "Request must have instances of " << inputs_number << " inputs.";
+
+        return write_error(message.str());
+    }
+
+    Request request;
+
+    request.inputs.resize(request_instances_number, inputs_number);
+
+    for(Index i = 0; i < static_cast<Index>(request_instances_number); i++)
+    {
+        for(Index j = 0; j < inputs_number; j++)
+        {
+            memcpy(&request.inputs(i, j), payload + static_cast<size_t>(i*inputs_number + j)*sizeof(type), sizeof(type));
+        }
+    }
+
+    connection->buffer.erase(0, header_size + static_cast<size_t>(payload_size));
+
+    queue_request(request);
+
+    if(!request.error_message.empty()) return write_error(request.error_message);
+
+    const Index response_instances_number = request.outputs.dimension(0);
+    const Index response_outputs_number = request.outputs.dimension(1);
+
+    string outputs_payload(static_cast<size_t>(response_instances_number*response_outputs_number)*sizeof(type), '\0');
+
+    char* outputs_data = &outputs_payload[0];
+
+    for(Index i = 0; i < response_instances_number; i++)
+    {
+        for(Index j = 0; j < response_outputs_number; j++)
+        {
+            const type value = request.outputs(i, j);
+
+            memcpy(outputs_data + static_cast<size_t>(i*response_outputs_number + j)*sizeof(type), &value, sizeof(type));
+        }
+    }
+
+    return write_response(0,
+                          static_cast<uint32_t>(response_instances_number),
+                          static_cast<uint32_t>(response_outputs_number),
+                          outputs_payload);
+}
+
+
+/// Reads and answers a JSON line request.
+/// Returns false if the connection must be closed.
+/// @param connection Connection of the request.
+
+bool ModelServer::serve_json_request(Connection* connection)
+{
+    const size_t maximum_line_size = static_cast<size_t>(1) << 28;
+
+    size_t line_end = connection->buffer.find('\n');
+
+    while(line_end == string::npos)
+    {
+        if(connection->buffer.size() > maximum_line_size)
+        {
+            send_all(connection->socket, "{\"error\": \"Request line is too long.\"}\n");
+
+            return false;
+        }
+
+        const size_t size = connection->buffer.size();
+
+        if(!receive(connection, size + 1)) return false;
+
+        line_end = connection->buffer.find('\n', size);
+    }
+
+    const string line = connection->buffer.substr(0, line_end);
+
+    connection->buffer.erase(0, line_end + 1);
+
+    // Commands
+
+    if(line.find("\"command\"") != string::npos)
+    {
+        if(line.find("\"statistics\"") != string::npos)
+        {
+            return send_all(connection->socket, get_statistics().to_JSON() + "\n");
+        }
+
+        return send_all(connection->socket, "{\"error\": \"Unknown command.\"}\n");
+    }
+
+    // Inputs
+
+    Request request;
+
+    bool single_instance = false;
+
+    try
+    {
+        request.inputs = parse_json_inputs(line, single_instance);
+
+        if(request.inputs.dimension(1) != inputs_number)
+        {
+            ostringstream buffer;
+
+            buffer << "Request must have instances of " << inputs_number << " inputs.";
+
+            throw logic_error(buffer.str());
+        }
+    }
+    catch(const logic_error& e)
+    {
+        {
+            lock_guard<mutex> lock(statistics_mutex);
+
+            counters.errors_number++;
+        }
+
+        return send_all(connection->socket, "{\"error\": " + write_json_string(e.what()) + "}\n");
+    }
+
+    queue_request(request);
+
+    if(!request.error_message.empty())
+    {
+        return send_all(connection->socket, "{\"error\": " + write_json_string(request.error_message) + "}\n");
+    }
+
+    string response = "{\"outputs\": ";
+
+    if(!single_instance) response += "[";
+
+    for(Index i = 0; i < request.outputs.dimension(0); i++)
+    {
+        if(i != 0) response += ", ";
+
+        response += "[";
+
+        for(Index j = 0; j < request.outputs.dimension(1); j++)
+        {
+            if(j != 0) response += ", ";
+
+            response += write_json_number(request.outputs(i, j));
+        }
+
+        response += "]";
+    }
+
+    if(!single_instance) response += "]";
+
+    response += "}\n";
+
+    return send_all(connection->socket, response);
+}
+
+
+/// Receives bytes from a connection until its buffer has a given size.
+/// Returns false if the connection is closed first.
+/// @param connection Connection to read from.
+/// @param size Size of the buffer.
+
+bool ModelServer::receive(Connection* connection, const size_t& size)
+{
+#ifndef _WIN32
+
+    char chunk[65536];
+
+    while(connection->buffer.size() < size)
+    {
+        const ssize_t received = recv(connection->socket, chunk, sizeof(chunk), 0);
+
+        if(received <= 0) return false;
+
+        connection->buffer.append(chunk, static_cast<size_t>(received));
+    }
+
+    return true;
+
+#else
+
+    return false;
+
+#endif
+}
+
+
+/// Sends all the bytes of a message through a socket.
+/// Returns false if the connection is closed first.
+/// @param connection_socket Socket of the connection.
+/// @param message Bytes to send.
+
+bool ModelServer::send_all(const int& connection_socket, const string& message) const
+{
+#ifndef _WIN32
+
+#ifdef MSG_NOSIGNAL
+    const int flags = MSG_NOSIGNAL;
+#else
+    const int flags = 0;
+#endif
+
+    size_t sent_size = 0;
+
+    while(sent_size < message.size())
+    {
+        const ssize_t sent = send(connection_socket, message.data() + sent_size, message.size() - sent_size, flags);
+
+        if(sent <= 0) return false;
+
+        sent_size += static_cast<size_t>(sent);
+    }
+
+    return true;
+
+#else
+
+    return false;
+
+#endif
+}
+
+
+/// Queues a request and waits until a worker has calculated its outputs or set its error.
+/// @param request Request to be calculated.
+
+void ModelServer::queue_request(Request& request)
+{
+    future<void> done = request.done.get_future();
+
+    request.arrival_time = chrono::steady_clock::now();
+
+    {
+        lock_guard<mutex> lock(requests_mutex);
+
+        if(!running)
+        {
+            request.error_message = "Model server is stopping.";
+
+            return;
+        }
+
+        requests.push_back(&request);
+
+        queued_instances_number += request.inputs.dimension(0);
+    }
+
+    requests_condition.notify_all();
+
+    done.wait();
+}
+
+
+/// Calculates the batches of requests of a worker until the server stops and the queue is empty.
+/// A batch takes the queued requests in order, up to the maximum number of instances, once it is full
+/// or its oldest request has waited for the maximum batch delay. The inputs are gathered in a preallocated matrix.
+/// @param worker_index Index of the worker.
+
+void ModelServer::calculate_batches(const Index& worker_index)
+{
+    // The number of threads of the OpenMP regions is set for each thread
+
+    omp_set_num_threads(static_cast<int>(worker_threads_number));
+
+    NeuralNetwork& neural_network = *neural_networks[static_cast<size_t>(worker_index)];
+
+    Tensor<type, 2> batch_inputs(maximum_batch_instances_number, inputs_number);
+
+    vector<Request*> batch;
+
+    const chrono::steady_clock::duration delay
+            = chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(maximum_batch_delay));
+
+    while(true)
+    {
+        batch.clear();
+
+        Index batch_instances_number = 0;
+
+        {
+            unique_lock<mutex> lock(requests_mutex);
+
+            requests_condition.wait(lock, [&]{return !requests.empty() || !running;});
+
+            if(requests.empty()) break;
+
+            const chrono::steady_clock::time_point deadline = requests.front()->arrival_time + delay;
+
+            while(running
+               && !requests.empty()
+               && queued_instances_number < maximum_batch_instances_number
+               && chrono::steady_clock::now() < deadline)
+            {
+                requests_condition.wait_until(lock, deadline);
+            }
+
+            // Another worker may have taken the requests
+
+            if(requests.empty()) continue;
+
+            while(!requests.empty())
+            {
+                Request* request = requests.front();
+
+                const Index request_instances_number = request->inputs.dimension(0);
+
+                if(!batch.empty() && batch_instances_number + request_instances_number > maximum_batch_instances_number) break;
+
+                batch.push_back(request);
+
+                requests.pop_front();
+
+                queued_instances_number -= request_instances_number;
+
+                batch_instances_number += request_instances_number;
+            }
+        }
+
+        requests_condition.notify_all();
+
+        try
+        {
+            Tensor<type, 2> outputs;
+
+            if(batch_instances_number > maximum_batch_instances_number)
+            {
+                outputs = neural_network.calculate_outputs(batch[0]->inputs);
+            }
+            else
+            {
+                Index row_index = 0;
+
+                for(size_t i = 0; i < batch.size(); i++)
+                {
+                    const Tensor<type, 2>& inputs = batch[i]->inputs;
+
+                    for(Index j = 0; j < inputs_number; j++)
+                    {
+                        for(Index k = 0; k < inputs.dimension(0); k++)
+                        {
+                            batch_inputs(row_index + k, j) = inputs(k, j);
+                        }
+                    }
+
+                    row_index += inputs.dimension(0);
+                }
+
+                if(batch_instances_number == maximum_batch_instances_number)
+                {
+                    outputs = neural_network.calculate_outputs(batch_inputs);
+                }
+                else
+                {
+                    const Eigen::array<Index, 2> offsets = {0, 0};
+                    const Eigen::array<Index, 2> extents = {batch_instances_number, inputs_number};
+
+                    const Tensor<type, 2> inputs = batch_inputs.slice(offsets, extents);
+
+                    outputs = neural_network.calculate_outputs(inputs);
+                }
+            }
+
+            Index row_index = 0;
+
+            for(size_t i = 0; i < batch.size(); i++)
+            {
+                const Index request_instances_number = batch[i]->inputs.dimension(0);
+
+                const Eigen::array<Index, 2> offsets = {row_index, 0};
+                const Eigen::array<Index, 2> extents = {request_instances_number, outputs.dimension(1)};
+
+                batch[i]->outputs = outputs.slice(offsets, extents);
+
+                row_index += request_instances_number;
+            }
+        }
+        catch(const exception& e)
+        {
+            for(size_t i = 0; i < batch.size(); i++) batch[i]->error_message = e.what();
+        }
+
+        const chrono::steady_clock::time_point calculation_time = chrono::steady_clock::now();
+
+        {
+            lock_guard<mutex> lock(statistics_mutex);
+
+            counters.batches_number++;
+
+            for(size_t i = 0; i < batch.size(); i++)
+            {
+                if(batch[i]->error_message.empty())
+                {
+                    counters.requests_number++;
+                    counters.instances_number += batch[i]->inputs.dimension(0);
+                }
+                else
+                {
+                    counters.errors_number++;
+                }
+
+                record_latency(static_cast<type>(chrono::duration<double>(calculation_time - batch[i]->arrival_time).count()));
+            }
+        }
+
+        for(size_t i = 0; i < batch.size(); i++) batch[i]->done.set_value();
+    }
+}
+
+
+/// Records the latency of a request in the ring of the latest latencies. The statistics mutex must be locked.
+/// @param latency Latency in seconds.
+
+void ModelServer::record_latency(const type& latency)
+{
+    if(latencies.empty()) return;
+
+    latencies[static_cast<size_t>(latencies_count)%latencies.size()] = latency;
+
+    latencies_count++;
+}
+
+
+/// Returns a number in JSON, with enough digits to read back the same value. NaN and infinite values are written as null.
+/// @param value Number to write.
+
+string ModelServer::write_json_number(const type& value)
+{
+    if(::isnan(value) || ::isinf(value)) return "null";
+
+    char number[64];
+
+    const int length = snprintf(number, sizeof(number), "%.*g", numeric_limits<type>::max_digits10, static_cast<double>(value));
+
+    return string(number, static_cast<size_t>(length));
+}
+
+
+/// Returns a quoted and escaped JSON string.
+/// @param text Text to write.
+
+string ModelServer::write_json_string(const string& text)
+{
+    string json = "\"";
+
+    for(size_t i = 0; i < text.size(); i++)
+    {
+        const char character = text[i];
+
+        if(character == '"') json += "\\\"";
+        else if(character == '\\') json += "\\\\";
+        else if(character == '\n') json += "\\n";
+        else if(character == '\r') json += "\\r";
+        else if(character == '\t') json += "\\t";
+        else if(static_cast<unsigned char>(character) < 0x20) json += " ";
+        else json += character;
+    }
+
+    return json + "\"";
+}
+
+
+/// Parses the "inputs" member of a JSON request, which is an array of numbers for a single instance,
+/// or an array of arrays of numbers for several instances. Null values are read as missing values.
+/// @param line JSON line of the request.
+/// @param single_instance Set to true if the inputs are a single instance.
+
+Tensor<type, 2> ModelServer::parse_json_inputs(const string& line, bool& single_instance)
+{
+    ostringstream buffer;
+
+    buffer << "OpenNN Exception: ModelServer class.\n"
+           << "static Tensor<type, 2> parse_json_inputs(const string&, bool&) method.\n";
+
+    const size_t key_position = line.find("\"inputs\"");
+
+    if(key_position == string::npos)
+    {
+        buffer << "Request has no inputs.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    size_t position = line.find(':', key_position);
+
+    const auto skip_spaces = [&]()
+    {
+        while(position < line.size() && isspace(static_cast<unsigned char>(line[position]))) position++;
+    };
+
+    const auto expect = [&](const char& character)
+    {
+        skip_spaces();
+
+        if(position >= line.size() || line[position] != character)
+        {
+            buffer << "Expected '" << character << "' at position " << position << " of the request.\n";
+
+            throw logic_error(buffer.str());
+        }
+
+        position++;
+    };
+
+    // Parses an array of numbers, whose opening bracket has been read
+
+    const auto parse_row = [&](vector<type>& row)
+    {
+        skip_spaces();
+
+        if(position < line.size() && line[position] == ']')
+        {
+            position++;
+
+            return;
+        }
+
+        while(true)
+        {
+            skip_spaces();
+
+            if(line.compare(position, 4, "null") == 0)
+            {
+                row.push_back(numeric_limits<type>::quiet_NaN());
+
+                position += 4;
+            }
+            else
+            {
+                char* end = nullptr;
+
+                const type value = static_cast<type>(strtod(line.c_str() + position, &end));
+
+                if(end == line.c_str() + position)
+                {
+                    buffer << "Expected a number at position " << position << " of the request.\n";
+
+                    throw logic_error(buffer.str());
+                }
+
+                row.push_back(value);
+
+                position = static_cast<size_t>(end - line.c_str());
+            }
+
+            skip_spaces();
+
+            if(position < line.size() && line[position] == ',')
+            {
+                position++;
+
+                continue;
+            }
+
+            expect(']');
+
+            return;
+        }
+    };
+
+    if(position == string::npos)
+    {
+        buffer << "Request has no inputs.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    position++;
+
+    expect('[');
+
+    skip_spaces();
+
+    vector<vector<type>> rows;
+
+    if(position < line.size() && line[position] == '[')
+    {
+        single_instance = false;
+
+        while(true)
+        {
+            expect('[');
+
+            rows.push_back(vector<type>());
+
+            parse_row(rows.back());
+
+            skip_spaces();
+
+            if(position < line.size() && line[position] == ',')
+            {
+                position++;
+
+                continue;
+            }
+
+            expect(']');
+
+            break;
+        }
+    }
+    else
+    {
+        single_instance = true;
+
+        rows.push_back(vector<type>());
+
+        parse_row(rows.back());
+    }
+
+    const Index columns_number = static_cast<Index>(rows[0].size());
+
+    for(size_t i = 0; i < rows.size(); i++)
+    {
+        if(static_cast<Index>(rows[i].size()) != columns_number || columns_number == 0)
+        {
+            buffer << "All the instances of the request must have the same number of inputs.\n";
+
+            throw logic_error(buffer.str());
+        }
+    }
+
+    Tensor<type, 2> inputs(static_cast<Index>(rows.size()), columns_number);
+
+    for(size_t i = 0; i < rows.size(); i++)
+    {
+        for(Index j = 0; j < columns_number; j++)
+        {
+            inputs(static_cast<Index>(i), j) = rows[i][static_cast<size_t>(j)];
+        }
+    }
+
+    return inputs;
+}
+
+
+/// Prints to the screen the statistics of the server.
+
+void ModelServer::Statistics::print() const
+{
+    cout << "Model server statistics\n"
+         << "Requests: " << requests_number << "\n"
+         << "Instances: " << instances_number << "\n"
+         << "Batches: " << batches_number << "\n"
+         << "Errors: " << errors_number << "\n"
+         << "Latency p50: " << latency_p50*1e6 << " us\n"
+         << "Latency p99: " << latency_p99*1e6 << " us\n"
+         << "Requests per second: " << requests_per_second << "\n"
+         << "Instances per second: " << instances_per_second << "\n"
+         << "Elapsed time: " << elapsed_time << " s" << endl;
+}
+
+
+/// Returns the statistics as a JSON object, with the latencies and the elapsed time in seconds.
+
+string ModelServer::Statistics::to_JSON() const
+{
+    ostringstream json;
+
+    json << "{\"requests_number\": " << requests_number
+         << ", \"instances_number\": " << instances_number
+         << ", \"batches_number\": " << batches_number
+         << ", \"errors_number\": " << errors_number
+         << ", \"latency_p50\": " << write_json_number(latency_p50)
+         << ", \"latency_p99\": " << write_json_number(latency_p99)
+         << ", \"requests_per_second\": " << write_json_number(requests_per_second)
+         << ", \"instances_per_second\": " << write_json_number(instances_per_second)
+         << ", \"elapsed_time\": " << write_json_number(elapsed_time) << "}";
+
+    return json.str();
+}
+
+}
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
@@ -0,0 +1,401 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   M O D E L   S E R V E R   C L A S S   H E A D E R
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#ifndef MODELSERVER_H
+#define MODELSERVER_H
+
+// System includes
+
+#include <cmath>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <sstream>
+#include <limits>
+#include <vector>
+#include <deque>
+#include <list>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <chrono>
+#include <algorithm>
+#include <omp.h>
+
+// OpenNN includes
+
+#include "config.h"
+#include "neural_network.h"
+
+using namespace std;
+using namespace Eigen;
+
+namespace OpenNN
+{
+
+/// This class serves the outputs of a saved neural network over a local TCP or Unix socket.
+
+///
+/// Each connection sends requests one after the other, in any of two protocols, which are told apart by their first byte:
+/// <ul>
+/// <li> Binary: a header with the magic "ONNB" and the numbers of instances and inputs as 32 bits unsigned integers,
+/// followed by the inputs by rows as native scalars. The response has the magic, a status which is 0 on success,
+/// and the numbers of instances and outputs, followed by the outputs by rows. Failed responses have no instances,
+/// and the length of the error message in place of the outputs number, followed by the message.
+/// <li> JSON lines: {"inputs": [[...], ...]} or {"inputs": [...]} for a single instance, answered by the same layout of "outputs";
+/// and {"command": "statistics"}, answered by the statistics of the server. Errors are answered by {"error": "..."}.
+/// </ul>
+/// The requests of all the connections are queued and grouped into batches by a fixed pool of workers,
+/// each one owning a copy of the neural network loaded from the model file and a preallocated batch of inputs.
+/// A batch is calculated as soon as it is full, or when its oldest request has waited for the maximum batch delay.
+/// The server is only available on POSIX systems.
+
+class ModelServer
+{
+
+public:
+
+   // Constructors
+
+   explicit ModelServer();
+
+   explicit ModelServer(const string&);
+
+   // Destructor
+
+   virtual ~ModelServer();
+
+   /// This structure contains the counters and the latency percentiles of the server.
+
+   struct Statistics
+   {
+       /// Default constructor.
+
+       explicit Statistics() {}
+
+       virtual ~Statistics() {}
+
+       void print() const;
+
+       string to_JSON() const;
+
+       /// Number of requests answered with outputs.
+
+       Index requests_number = 0;
+
+       /// Number of instances calculated.
+
+       Index instances_number = 0;
+
+       /// Number of batches calculated.
+
+       Index batches_number = 0;
+
+       /// Number of requests answered with an error.
+
+       Index errors_number = 0;
+
+       /// Median and 99th percentile of the time between the arrival and the calculation of the latest requests, in seconds.
+
+       type latency_p50 = 0;
+
+       type latency_p99 = 0;
+
+       /// Requests and instances per second since the server started.
+
+       type requests_per_second = 0;
+
+       type instances_per_second = 0;
+
+       /// Time since the server started, in seconds.
+
+       type elapsed_time = 0;
+   };
+
+   // Get methods
+
+   const string& get_model_file_name() const;
+
+   const string& get_address() const;
+
+   int get_port() const;
+
+   const string& get_unix_socket_path() const;
+
+   const Index& get_maximum_batch_instances_number() const;
+
+   const type& get_maximum_batch_delay() const;
+
+   const Index& get_workers_number() const;
+   const Index& get_worker_threads_number() const;
+
+   const bool& get_display() const;
+
+   bool is_running() const;
+
+   Statistics get_statistics() const;
+
+   // Set methods
+
+   void set();
+   void set(const string&);
+
+   void set_default();
+
+   void set_model_file_name(const string&);
+
+   void set_address(const string&);
+
+   void set_port(const int&);
+
+   void set_unix_socket_path(const string&);
+
+   void set_maximum_batch_instances_number(const Index&);
+
+   void set_maximum_batch_delay(const type&);
+
+   void set_workers_number(const Index&);
+   void set_worker_threads_number(const Index&);
+
+   void set_display(const bool&);
+
+   // Serving methods
+
+   void start();
+
+   void stop();
+
+private:
+
+   /// Request of a connection waiting in the queue.
+
+   struct Request
+   {
+       explicit Request() {}
+
+       virtual ~Request() {}
+
+       /// Inputs of the request.
+
+       Tensor<type, 2> inputs;
+
+       /// Outputs of the request, set by a worker.
+
+       Tensor<type, 2> outputs;
+
+       /// Error of the request, set by a worker.
+
+       string error_message;
+
+       /// Time at which the request was queued.
+
+       chrono::steady_clock::time_point arrival_time;
+
+       /// Promise fulfilled by the worker when the outputs or the error are set.
+
+       promise<void> done;
+   };
+
+   /// Client connection with the bytes received but not yet parsed.
+
+   struct Connection
+   {
+       explicit Connection() {finished = false;}
+
+       virtual ~Connection() {}
+
+       /// Socket of the connection.
+
+       int socket = -1;
+
+       /// Bytes received but not yet parsed.
+
+       string buffer;
+
+       /// Thread which reads and answers the requests of the connection.
+
+       thread reader;
+
+       /// True when the connection thread has finished.
+
+       atomic<bool> finished;
+   };
+
+   void check_stopped(const string&) const;
+
+   void load_neural_networks();
+
+   void delete_neural_networks();
+
+   void open_listening_socket();
+
+   void accept_connections();
+
+   void join_finished_connections(const bool&);
+
+   void serve_connection(Connection*);
+
+   bool serve_binary_request(Connection*);
+
+   bool serve_json_request(Connection*);
+
+   bool receive(Connection*, const size_t&);
+
+   bool send_all(const int&, const string&) const;
+
+   void queue_request(Request&);
+
+   void calculate_batches(const Index&);
+
+   void record_latency(const type&);
+
+   static string write_json_number(const type&);
+
+   static string write_json_string(const string&);
+
+   static Tensor<type, 2> parse_json_inputs(const string&, bool&);
+
+   // MEMBERS
+
+   /// Name of the model file, in the binary model format or in XML.
+
+   string model_file_name;
+
+   /// Address of the TCP socket.
+
+   string address = "127.0.0.1";
+
+   /// Port of the TCP socket, or 0 for an ephemeral port. It is the bound port while the server runs.
+
+   int port = 0;
+
+   /// Path of the Unix socket, or empty to listen on the TCP socket.
+
+   string unix_socket_path;
+
+   /// Maximum number of instances of a batch.
+
+   Index maximum_batch_instances_number = 64;
+
+   /// Maximum time that a request waits for a batch to be filled, in seconds.
+
+   type maximum_batch_delay = static_cast<type>(0.001);
+
+   /// Number of workers which calculate the batches.
+
+   Index workers_number = 1;
+
+   /// Number of threads of the thread pools of the copy of the neural network of each worker.
+
+   Index worker_threads_number = 1;
+
+   /// Display messages to screen.
+
+   bool display = true;
+
+   /// True while the server runs.
+
+   atomic<bool> running;
+
+   /// Listening socket, or -1 if it is closed.
+
+   int listening_socket = -1;
+
+   /// Thread which accepts the connections.
+
+   thread acceptor;
+
+   /// Thread pools of the workers, with the threads budget of one worker, declared before the copies so that they are destroyed after them.
+
+   vector<unique_ptr<NonBlockingThreadPool>> thread_pools;
+
+   /// Devices of the thread pools of the workers, used by the copies of the neural network.
+
+   vector<unique_ptr<ThreadPoolDevice>> thread_pool_devices;
+
+   /// Copies of the neural network, one for each worker.
+
+   vector<unique_ptr<NeuralNetwork>> neural_networks;
+
+   /// Numbers of inputs and outputs of the neural network.
+
+   Index inputs_number = 0;
+
+   Index outputs_number = 0;
+
+   /// Workers which calculate the batches.
+
+   vector<thread> workers;
+
+   /// Mutex and condition of the queue of requests.
+
+   mutex requests_mutex;
+
+   condition_variable requests_condition;
+
+   /// Queue of requests waiting to be calculated.
+
+   deque<Request*> requests;
+
+   /// Number of instances of the requests in the queue.
+
+   Index queued_instances_number = 0;
+
+   /// Mutex of the connections.
+
+   mutex connections_mutex;
+
+   /// Open connections.
+
+   list<unique_ptr<Connection>> connections;
+
+   /// Mutex of the statistics.
+
+   mutable mutex statistics_mutex;
+
+   /// Counters of the statistics.
+
+   Statistics counters;
+
+   /// Latencies of the latest requests, in seconds, as a ring.
+
+   vector<type> latencies;
+
+   /// Number of latencies recorded since the server started.
+
+   Index latencies_count = 0;
+
+   /// Time at which the server started.
+
+   chrono::steady_clock::time_point beginning_time;
+};
+
+}
+
+#endif
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
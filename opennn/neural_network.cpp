@@ -8,6 +8,13 @@
 
 #include "neural_network.h"
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace OpenNN
 {
 
@@ -559,6 +566,14 @@ const bool& NeuralNetwork::get_display() const
 }
 
 
+/// Returns the pointer to the profiler of the training, or nullptr if the neural network is not being profiled.
+
+TrainingProfiler* NeuralNetwork::get_profiler_pointer() const
+{
+    return profiler_pointer;
+}
+
+
 /// This method deletes all the pointers in the neural network.
 /// It also sets the rest of members to their default values.
 
@@ -687,10 +702,9 @@ void NeuralNetwork::set(const Tensor<Index, 1>& input_variables_dimensions,
         outputs_dimensions = pooling_layer_1->get_outputs_dimensions();
     }
 
-    //    PerceptronLayer* perceptron_layer = new PerceptronLayer(outputs_dimensions.sum(), 18);
-    const Tensor<Index, 0> outputs_dimensions_sum = outputs_dimensions.sum();
+    const Tensor<Index, 0> outputs_dimensions_product = outputs_dimensions.prod();
 
-    PerceptronLayer* perceptron_layer = new PerceptronLayer(outputs_dimensions_sum(0), 18);
+    PerceptronLayer* perceptron_layer = new PerceptronLayer(outputs_dimensions_product(0), 18);
     add_layer(perceptron_layer);
 
     const Index perceptron_layer_outputs = perceptron_layer->get_neurons_number();
@@ -807,6 +821,122 @@ void NeuralNetwork::set_inputs_number(const Tensor<bool, 1>& inputs)
 }
 
 
+/// Sets a new number of inputs keeping the parameters learned for the inputs which remain.
+/// The synaptic weights of the new inputs are set to zero, and those of the removed inputs are dropped.
+/// @param inputs_indices Index of each new input among the previous inputs, or -1 for a new input.
+
+void NeuralNetwork::resize_inputs(const Tensor<Index, 1>& inputs_indices)
+{
+    const Index new_inputs_number = inputs_indices.size();
+
+#ifdef __OPENNN_DEBUG__
+
+    if(new_inputs_number == 0)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: NeuralNetwork class.\n"
+               << "void resize_inputs(const Tensor<Index, 1>&) method.\n"
+               << "The number of inputs must be greater than 0.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+#endif
+
+    inputs_names.resize(new_inputs_number);
+
+    if(has_scaling_layer())
+    {
+        ScalingLayer* scaling_layer_pointer = get_scaling_layer_pointer();
+
+        scaling_layer_pointer->set_inputs_number(new_inputs_number);
+    }
+
+    const Index trainable_layers_number = get_trainable_layers_number();
+    Tensor<Layer*, 1> trainable_layers_pointers = get_trainable_layers_pointers();
+
+    if(trainable_layers_number > 0)
+    {
+        trainable_layers_pointers[0]->resize_inputs(inputs_indices);
+    }
+}
+
+
+/// Sets a new number of neurons in the last hidden layer keeping the parameters learned by the neurons which remain.
+/// The new neurons do not contribute to the outputs at first, and the removed neurons are dropped.
+/// @param new_neurons_number Number of neurons of the last hidden layer.
+
+void NeuralNetwork::resize_hidden_neurons(const Index& new_neurons_number)
+{
+    const Index trainable_layers_number = get_trainable_layers_number();
+
+#ifdef __OPENNN_DEBUG__
+
+    if(trainable_layers_number < 2)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: NeuralNetwork class.\n"
+               << "void resize_hidden_neurons(const Index&) method.\n"
+               << "The neural network must have a hidden layer.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+#endif
+
+    Tensor<Layer*, 1> trainable_layers_pointers = get_trainable_layers_pointers();
+
+    const Index neurons_number = trainable_layers_pointers[trainable_layers_number-2]->get_neurons_number();
+
+    Tensor<Index, 1> inputs_indices(new_neurons_number);
+
+    for(Index i = 0; i < new_neurons_number; i++)
+    {
+        inputs_indices(i) = i < neurons_number ? i : -1;
+    }
+
+    trainable_layers_pointers[trainable_layers_number-2]->resize_neurons(new_neurons_number);
+    trainable_layers_pointers[trainable_layers_number-1]->resize_inputs(inputs_indices);
+}
+
+
+/// Keeps only some neurons of a hidden perceptron layer, together with the synaptic weights of the next layer which connect to them.
+/// The removed neurons are dropped, so that the outputs do not change if they had no effect.
+/// @param trainable_layer_index Index of the perceptron layer among the trainable layers.
+/// @param neurons_indices Indices of the neurons which are kept, in their new order.
+
+void NeuralNetwork::select_hidden_neurons(const Index& trainable_layer_index, const Tensor<Index, 1>& neurons_indices)
+{
+    Tensor<Layer*, 1> trainable_layers_pointers = get_trainable_layers_pointers();
+
+#ifdef __OPENNN_DEBUG__
+
+    const Index trainable_layers_number = get_trainable_layers_number();
+
+    if(trainable_layer_index >= trainable_layers_number-1
+    || trainable_layers_pointers[trainable_layer_index]->get_type() != Layer::Perceptron)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: NeuralNetwork class.\n"
+               << "void select_hidden_neurons(const Index&, const Tensor<Index, 1>&) method.\n"
+               << "Layer " << trainable_layer_index << " must be a hidden perceptron layer.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+#endif
+
+    PerceptronLayer* perceptron_layer_pointer = static_cast<PerceptronLayer*>(trainable_layers_pointers[trainable_layer_index]);
+
+    perceptron_layer_pointer->select_neurons(neurons_indices);
+
+    trainable_layers_pointers[trainable_layer_index+1]->resize_inputs(neurons_indices);
+}
+
+
 /// Sets those members which are not pointer to their default values.
 
 void NeuralNetwork::set_default()
@@ -1141,6 +1271,34 @@ void NeuralNetwork::set_parameters(Tensor<type, 1>& new_parameters)
 }
 
 
+/// Sets to zero the entries of a vector laid out as the parameters which correspond to pruned synaptic weights.
+/// Optimizers whose training direction mixes the gradient entries use it to keep the pruned weights at zero.
+/// @param parameters Vector with the size of the parameters, such as a training direction.
+
+void NeuralNetwork::mask_pruned_parameters(Tensor<type, 1>& parameters) const
+{
+    const Index trainable_layers_number = get_trainable_layers_number();
+
+    const Tensor<Layer*, 1> trainable_layers_pointers = get_trainable_layers_pointers();
+
+    const Tensor<Index, 1> trainable_layers_parameters_numbers = get_trainable_layers_parameters_numbers();
+
+    Index index = 0;
+
+    for(Index i = 0; i < trainable_layers_number; i++)
+    {
+        if(trainable_layers_pointers(i)->get_type() == Layer::Perceptron)
+        {
+            const PerceptronLayer* perceptron_layer_pointer = static_cast<PerceptronLayer*>(trainable_layers_pointers(i));
+
+            perceptron_layer_pointer->mask_synaptic_weights(parameters.data() + index + perceptron_layer_pointer->get_biases_number());
+        }
+
+        index += trainable_layers_parameters_numbers(i);
+    }
+}
+
+
 /// Sets a new display value.
 /// If it is set to true messages from this class are to be displayed on the screen;
 /// if it is set to false messages from this class are not to be displayed on the screen.
@@ -1152,6 +1310,16 @@ void NeuralNetwork::set_display(const bool& new_display)
 }
 
 
+/// Sets the profiler which times the forward propagation of each layer.
+/// The optimization algorithms set it during the training when OPENNN_PROFILE is defined.
+/// @param new_profiler_pointer Pointer to the profiler, or nullptr to stop profiling.
+
+void NeuralNetwork::set_profiler_pointer(TrainingProfiler* new_profiler_pointer)
+{
+    profiler_pointer = new_profiler_pointer;
+}
+
+
 /// Returns the number of layers in the neural network.
 /// That includes perceptron, scaling, unscaling, inputs trending, outputs trending, bounding, probabilistic or conditions layers.
 
@@ -1335,14 +1503,33 @@ void NeuralNetwork::perturbate_parameters(const type& perturbation)
 void NeuralNetwork::forward_propagate(const DataSet::Batch& batch,
                                    ForwardPropagation& forward_propagation) const
 {
+    OPENNN_PROFILE_SCOPE(profiler_pointer, TrainingProfiler::ForwardPropagate);
+
     const Tensor<Layer*, 1> trainable_layers_pointers = get_trainable_layers_pointers();
 
     const Index trainable_layers_number = trainable_layers_pointers.size();
 
-    trainable_layers_pointers(0)->forward_propagate(batch.inputs_2d, forward_propagation.layers(0));
+    OPENNN_PROFILE_COUNT(profiler_pointer, TrainingProfiler::ForwardPropagate, -1, 0, 0, 1);
+
+    {
+        OPENNN_PROFILE_SCOPE(profiler_pointer, TrainingProfiler::ForwardPropagate, 0,
+                             trainable_layers_pointers(0), forward_propagation.batch_instances_number);
+
+        if(batch.sparse_inputs)
+        {
+            trainable_layers_pointers(0)->forward_propagate(batch.inputs_csr, forward_propagation.layers(0));
+        }
+        else
+        {
+            trainable_layers_pointers(0)->forward_propagate(batch.inputs_2d, forward_propagation.layers(0));
+        }
+    }
 
     for(Index i = 1; i < trainable_layers_number; i++)
     {
+        OPENNN_PROFILE_SCOPE(profiler_pointer, TrainingProfiler::ForwardPropagate, i,
+                             trainable_layers_pointers(i), forward_propagation.batch_instances_number);
+
          trainable_layers_pointers(i)->forward_propagate(forward_propagation.layers(i-1).activations_2d,
                                                                      forward_propagation.layers(i));
 
@@ -1359,20 +1546,39 @@ void NeuralNetwork::forward_propagate(const DataSet::Batch& batch,
                                    Tensor<type, 1>& parameters,
                                    ForwardPropagation& forward_propagation) const
 {
+    OPENNN_PROFILE_SCOPE(profiler_pointer, TrainingProfiler::ForwardPropagate);
+
     const Tensor<Layer*, 1> trainable_layers_pointers = get_trainable_layers_pointers();
 
     const Index trainable_layers_number = trainable_layers_pointers.size();
 
+    OPENNN_PROFILE_COUNT(profiler_pointer, TrainingProfiler::ForwardPropagate, -1, 0, 0, 1);
+
     const Index parameters_number = trainable_layers_pointers(0)->get_parameters_number();
 
     const TensorMap<Tensor<type, 1>> potential_parameters(parameters.data(), parameters_number);
 
-    trainable_layers_pointers(0)->forward_propagate(batch.inputs_2d, potential_parameters, forward_propagation.layers(0));
+    {
+        OPENNN_PROFILE_SCOPE(profiler_pointer, TrainingProfiler::ForwardPropagate, 0,
+                             trainable_layers_pointers(0), forward_propagation.batch_instances_number);
+
+        if(batch.sparse_inputs)
+        {
+            trainable_layers_pointers(0)->forward_propagate(batch.inputs_csr, potential_parameters, forward_propagation.layers(0));
+        }
+        else
+        {
+            trainable_layers_pointers(0)->forward_propagate(batch.inputs_2d, potential_parameters, forward_propagation.layers(0));
+        }
+    }
 
     Index index = parameters_number;
 
     for(Index i = 1; i < trainable_layers_number; i++)
     {
+        OPENNN_PROFILE_SCOPE(profiler_pointer, TrainingProfiler::ForwardPropagate, i,
+                             trainable_layers_pointers(i), forward_propagation.batch_instances_number);
+
         const Index parameters_number = trainable_layers_pointers(i)->get_parameters_number();
 
         const TensorMap<Tensor<type, 1>> potential_parameters(parameters.data() + index, parameters_number);
@@ -2024,6 +2230,27 @@ void NeuralNetwork::layers_from_XML(const tinyxml2::XMLDocument& document)
 
             add_layer(perceptron_layer);
         }
+        else if(layers_types(i) == "LowRankPerceptron")
+        {
+            LowRankPerceptronLayer* low_rank_perceptron_layer = new LowRankPerceptronLayer();
+
+            const tinyxml2::XMLElement* low_rank_perceptron_element = start_element->NextSiblingElement("LowRankPerceptronLayer");
+            start_element = low_rank_perceptron_element;
+
+            if(low_rank_perceptron_element)
+            {
+                tinyxml2::XMLDocument low_rank_perceptron_document;
+                tinyxml2::XMLNode* element_clone;
+
+                element_clone = low_rank_perceptron_element->DeepClone(&low_rank_perceptron_document);
+
+                low_rank_perceptron_document.InsertFirstChild(element_clone);
+
+                low_rank_perceptron_layer->from_XML(low_rank_perceptron_document);
+            }
+
+            add_layer(low_rank_perceptron_layer);
+        }
         else if(layers_types(i) == "Pooling")
         {
             PoolingLayer* pooling_layer = new PoolingLayer();
@@ -2346,7 +2573,7 @@ void NeuralNetwork::load(const string& file_name)
 /// Loads the neural network parameters from a data file.
 /// The format of this file is just a sequence of numbers.
 /// @param file_name Name of parameters data file.
-/// @todo
+
 void NeuralNetwork::load_parameters(const string& file_name)
 {
     ifstream file(file_name.c_str());
@@ -2365,17 +2592,29 @@ void NeuralNetwork::load_parameters(const string& file_name)
     const Index parameters_number = get_parameters_number();
 
     Tensor<type, 1> new_parameters(parameters_number);
-    /*
-        new_parameters.load(file_name);
-    */
+
+    for(Index i = 0; i < parameters_number; i++)
+    {
+        if(!(file >> new_parameters(i)))
+        {
+            ostringstream buffer;
+
+            buffer << "OpenNN Exception: NeuralNetwork class.\n"
+                   << "void load_parameters(const string&) method.\n"
+                   << "Number of parameters in file (" << i << ") is less than number of parameters (" << parameters_number << ").\n";
+
+            throw logic_error(buffer.str());
+        }
+    }
+
     set_parameters(new_parameters);
 
     file.close();
 }
 
 
-/// Loads the neural network parameters from a data file.
-/// The format of this file is just a sequence of numbers.
+/// Loads the neural network parameters from a binary data file.
+/// The format of this file is just a sequence of values of the type used by OpenNN.
 /// @param file_name Name of parameters data file.
 
 void NeuralNetwork::load_parameters_binary(const string& file_name)
@@ -2395,22 +2634,395 @@ void NeuralNetwork::load_parameters_binary(const string& file_name)
         throw logic_error(buffer.str());
     }
 
-    streamsize size = sizeof(double);
-
     const Index parameters_number = get_parameters_number();
 
     Tensor<type, 1> new_parameters(parameters_number);
 
-    type value;
+    const streamsize size = static_cast<streamsize>(parameters_number)*static_cast<streamsize>(sizeof(type));
 
-    for(Index i = 0; i < parameters_number; i++)
+    file.read(reinterpret_cast<char*>(new_parameters.data()), size);
+
+    if(file.gcount() != size)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: NeuralNetwork template.\n"
+               << "void load_parameters_binary(const string&) method.\n"
+               << "Binary file is smaller than " << parameters_number << " parameters: " << file_name << "\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    set_parameters(new_parameters);
+}
+
+
+/// Saves the neural network to a binary model file.
+/// The file has a header with a version, an endianness tag and checksums, followed by the architecture,
+/// which is the XML of the neural network without the parameters, and by the parameters,
+/// which are stored in a single blob aligned to binary_model_alignment bytes.
+/// Loading this file does not parse the parameters from text, so it is much faster than loading the XML file.
+/// @param file_name Name of binary model file.
+
+void NeuralNetwork::save_binary(const string& file_name) const
+{
+    ofstream file(file_name.c_str(), ios::binary);
+
+    if(!file.is_open())
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: NeuralNetwork class.\n"
+               << "void save_binary(const string&) const method.\n"
+               << "Cannot open binary model file: " << file_name << "\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    const string architecture = write_binary_architecture();
+
+    const Tensor<type, 1> parameters = get_parameters();
+
+    const size_t parameters_size = static_cast<size_t>(parameters.size())*sizeof(type);
+
+    const size_t architecture_end = sizeof(BinaryModelHeader) + architecture.size();
+
+    const size_t parameters_offset
+            = (architecture_end + binary_model_alignment - 1)/binary_model_alignment*binary_model_alignment;
+
+    BinaryModelHeader header;
+
+    memcpy(header.magic, "OPENNNBM", 8);
+
+    header.version = binary_model_version;
+    header.endianness = 0x01020304;
+    header.scalar_size = static_cast<uint32_t>(sizeof(type));
+    header.alignment = binary_model_alignment;
+    header.architecture_size = architecture.size();
+    header.architecture_checksum = calculate_checksum(architecture.data(), architecture.size());
+    header.parameters_number = static_cast<uint64_t>(parameters.size());
+    header.parameters_offset = parameters_offset;
+    header.parameters_checksum = calculate_checksum(reinterpret_cast<const char*>(parameters.data()), parameters_size);
+
+    const string padding(parameters_offset - architecture_end, '\0');
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(BinaryModelHeader));
+    file.write(architecture.data(), static_cast<streamsize>(architecture.size()));
+    file.write(padding.data(), static_cast<streamsize>(padding.size()));
+    file.write(reinterpret_cast<const char*>(parameters.data()), static_cast<streamsize>(parameters_size));
+
+    if(!file)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: NeuralNetwork class.\n"
+               << "void save_binary(const string&) const method.\n"
+               << "Cannot write binary model file: " << file_name << "\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    file.close();
+}
+
+
+/// Loads the neural network from a binary model file written by save_binary.
+/// The file is memory-mapped when the system supports it, and the parameters are copied from the mapping into the layers.
+/// The checksums are verified, and files written with a different byte order or parameter type are converted.
+/// @param file_name Name of binary model file.
+
+void NeuralNetwork::load_binary(const string& file_name)
+{
+#if defined(__unix__) || defined(__APPLE__)
+
+    const int file_descriptor = open(file_name.c_str(), O_RDONLY);
+
+    struct stat file_status;
+
+    if(file_descriptor < 0 || fstat(file_descriptor, &file_status) != 0)
+    {
+        if(file_descriptor >= 0) close(file_descriptor);
+
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: NeuralNetwork class.\n"
+               << "void load_binary(const string&) method.\n"
+               << "Cannot open binary model file: " << file_name << "\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    const size_t file_size = static_cast<size_t>(file_status.st_size);
+
+    void* mapping = file_size == 0 ? MAP_FAILED : mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+
+    close(file_descriptor);
+
+    if(mapping == MAP_FAILED)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: NeuralNetwork class.\n"
+               << "void load_binary(const string&) method.\n"
+               << "Cannot map binary model file: " << file_name << "\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    try
+    {
+        load_binary_model(static_cast<const char*>(mapping), file_size);
+    }
+    catch(const logic_error&)
+    {
+        munmap(mapping, file_size);
+
+        throw;
+    }
+
+    munmap(mapping, file_size);
+
+#else
+
+    ifstream file(file_name.c_str(), ios::binary | ios::ate);
+
+    if(!file.is_open())
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: NeuralNetwork class.\n"
+               << "void load_binary(const string&) method.\n"
+               << "Cannot open binary model file: " << file_name << "\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    const size_t file_size = static_cast<size_t>(file.tellg());
+
+    vector<char> data(file_size);
+
+    file.seekg(0);
+    file.read(data.data(), static_cast<streamsize>(file_size));
+
+    if(file.gcount() != static_cast<streamsize>(file_size))
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: NeuralNetwork class.\n"
+               << "void load_binary(const string&) method.\n"
+               << "Cannot read binary model file: " << file_name << "\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    load_binary_model(data.data(), file_size);
+
+#endif
+}
+
+
+/// Returns the XML of the neural network without the parameters of the layers, which is the architecture of the binary model files.
+
+string NeuralNetwork::write_binary_architecture() const
+{
+    tinyxml2::XMLDocument document;
+
+    write_XML_document(*this, document);
+
+    tinyxml2::XMLElement* layers_element = document.FirstChildElement("NeuralNetwork")->FirstChildElement("Layers");
+
+    for(tinyxml2::XMLElement* layer_element = layers_element->FirstChildElement();
+        layer_element;
+        layer_element = layer_element->NextSiblingElement())
+    {
+        tinyxml2::XMLElement* parameters_element = layer_element->FirstChildElement("Parameters");
+
+        if(parameters_element) parameters_element->DeleteChildren();
+    }
+
+    tinyxml2::XMLPrinter architecture_printer;
+
+    document.Print(&architecture_printer);
+
+    return string(architecture_printer.CStr());
+}
+
+
+/// Sets the architecture and the parameters of the neural network from the contents of a binary model file.
+/// @param data Pointer to the contents of the file.
+/// @param size Size in bytes of the file.
+
+void NeuralNetwork::load_binary_model(const char* data, const size_t& size)
+{
+    ostringstream buffer;
+
+    buffer << "OpenNN Exception: NeuralNetwork class.\n"
+           << "void load_binary(const string&) method.\n";
+
+    if(size < sizeof(BinaryModelHeader) || memcmp(data, "OPENNNBM", 8) != 0)
+    {
+        buffer << "File is not a binary model.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    BinaryModelHeader header;
+
+    memcpy(&header, data, sizeof(BinaryModelHeader));
+
+    // Byte order
+
+    const bool swap_bytes = header.endianness != 0x01020304;
+
+    if(swap_bytes)
+    {
+        if(header.endianness != 0x04030201)
+        {
+            buffer << "Unknown endianness tag.\n";
+
+            throw logic_error(buffer.str());
+        }
+
+        reverse(reinterpret_cast<char*>(&header.version), reinterpret_cast<char*>(&header.version) + 4);
+        reverse(reinterpret_cast<char*>(&header.scalar_size), reinterpret_cast<char*>(&header.scalar_size) + 4);
+        reverse(reinterpret_cast<char*>(&header.alignment), reinterpret_cast<char*>(&header.alignment) + 4);
+
+        uint64_t* values = &header.architecture_size;
+
+        for(Index i = 0; i < 5; i++) reverse(reinterpret_cast<char*>(values + i), reinterpret_cast<char*>(values + i) + 8);
+    }
+
+    if(header.version > binary_model_version)
+    {
+        buffer << "Binary model version (" << header.version << ") is not supported.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    if(header.scalar_size != sizeof(float) && header.scalar_size != sizeof(double))
+    {
+        buffer << "Size of parameters (" << header.scalar_size << ") is not supported.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    const size_t parameters_size = static_cast<size_t>(header.parameters_number)*header.scalar_size;
+
+    if(sizeof(BinaryModelHeader) + header.architecture_size > header.parameters_offset
+    || header.parameters_offset + parameters_size > size)
+    {
+        buffer << "File is truncated.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    // Checksums
+
+    const char* architecture_data = data + sizeof(BinaryModelHeader);
+    const char* parameters_data = data + header.parameters_offset;
+
+    if(calculate_checksum(architecture_data, header.architecture_size) != header.architecture_checksum
+    || calculate_checksum(parameters_data, parameters_size) != header.parameters_checksum)
+    {
+        buffer << "Checksum does not match.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    // Architecture
+
+    tinyxml2::XMLDocument document;
+
+    if(document.Parse(architecture_data, header.architecture_size))
+    {
+        buffer << "Cannot parse architecture.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    set_default();
+
+    from_XML(document);
+
+    if(static_cast<uint64_t>(get_parameters_number()) != header.parameters_number)
+    {
+        buffer << "Number of parameters (" << header.parameters_number << ") does not match architecture.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    // Parameters
+
+    const Index parameters_number = static_cast<Index>(header.parameters_number);
+
+    Tensor<type, 1> new_parameters(parameters_number);
+
+    if(!swap_bytes && header.scalar_size == sizeof(type))
+    {
+        memcpy(new_parameters.data(), parameters_data, parameters_size);
+    }
+    else
     {
-        file.read(reinterpret_cast<char*>(&value), size);
+        char value[sizeof(double)];
+
+        for(Index i = 0; i < parameters_number; i++)
+        {
+            memcpy(value, parameters_data + static_cast<size_t>(i)*header.scalar_size, header.scalar_size);
+
+            if(swap_bytes) reverse(value, value + header.scalar_size);
 
-        new_parameters(i) = value;
+            if(header.scalar_size == sizeof(float))
+            {
+                float single_value;
+                memcpy(&single_value, value, sizeof(float));
+                new_parameters(i) = static_cast<type>(single_value);
+            }
+            else
+            {
+                double double_value;
+                memcpy(&double_value, value, sizeof(double));
+                new_parameters(i) = static_cast<type>(double_value);
+            }
+        }
     }
 
     set_parameters(new_parameters);
+
+    // The pruned synaptic weights are saved as zeros
+
+    for(Index i = 0; i < layers_pointers.size(); i++)
+    {
+        PerceptronLayer* perceptron_layer_pointer = dynamic_cast<PerceptronLayer*>(layers_pointers(i));
+
+        if(perceptron_layer_pointer && perceptron_layer_pointer->is_pruned())
+        {
+            const Tensor<type, 2>& synaptic_weights = perceptron_layer_pointer->get_synaptic_weights();
+
+            const Tensor<bool, 2> new_pruning_mask(synaptic_weights != synaptic_weights.constant(0));
+
+            perceptron_layer_pointer->set_pruning_mask(new_pruning_mask);
+        }
+    }
+}
+
+
+/// Returns the 64 bits FNV-1a hash of a block of memory, which is used as checksum by the binary model files.
+/// @param data Pointer to the block of memory.
+/// @param size Size in bytes of the block of memory.
+
+uint64_t NeuralNetwork::calculate_checksum(const char* data, const size_t& size)
+{
+    uint64_t checksum = 14695981039346656037ULL;
+
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+
+    for(size_t i = 0; i < size; i++)
+    {
+        checksum ^= bytes[i];
+        checksum *= 1099511628211ULL;
+    }
+
+    return checksum;
 }
 
 
@@ -2481,6 +3093,146 @@ string NeuralNetwork::write_expression_c() const
 }
 
 
+/// Returns a string with the C code of the neural network for batches of inputs.
+/// The parameters are written as static aligned arrays, and the combinations of all the layers are calculated by a single loop kernel,
+/// so that the code is compact and fast to compile and the compiler can vectorize it.
+/// The instances are processed in blocks, and the outputs of the layers are stored in a workspace given by the caller,
+/// so that the function does not allocate memory.
+
+string NeuralNetwork::write_batch_expression_c() const
+{
+    const Index layers_number = get_layers_number();
+
+    const Index inputs_number = get_inputs_number();
+    const Index outputs_number = get_outputs_number();
+
+    Tensor<Layer*, 1> layers_pointers = get_layers_pointers();
+    Tensor<string, 1> layers_names = get_layers_names();
+
+    const Index batch_block_size = 64;
+
+    Index maximum_neurons_number = 1;
+
+    for(Index i = 0; i < layers_number; i++)
+    {
+        maximum_neurons_number = max(maximum_neurons_number, layers_pointers[i]->get_inputs_number());
+        maximum_neurons_number = max(maximum_neurons_number, layers_pointers[i]->get_neurons_number());
+    }
+
+    ostringstream buffer;
+
+    buffer <<"/*"<<endl;
+    buffer <<"Artificial Intelligence Techniques SL\t"<<endl;
+    buffer <<"artelnics@artelnics.com\t"<<endl;
+    buffer <<""<<endl;
+    buffer <<"Your model has been exported to this file." <<endl;
+    buffer <<"You can manage it with the 'neural_network' function, which calculates the outputs of a batch of instances.\t"<<endl;
+    buffer <<"The inputs and the outputs of the instances are stored by rows.\t"<<endl;
+    buffer <<"Example:"<<endl;
+    buffer <<""<<endl;
+    buffer <<"\tstatic float workspace[NEURAL_NETWORK_WORKSPACE_SIZE];\t"<<endl;
+    buffer <<"\tfloat inputs[2*NEURAL_NETWORK_INPUTS_NUMBER] = {...};\t"<<endl;
+    buffer <<"\tfloat outputs[2*NEURAL_NETWORK_OUTPUTS_NUMBER];\t"<<endl;
+    buffer <<"\tneural_network(inputs, outputs, 2, workspace);"<<endl;
+    buffer <<""<<endl;
+    buffer <<"The function does not allocate memory. The workspace can be reused by calls which are not concurrent.\t"<<endl;
+    buffer <<"*/"<<endl;
+    buffer <<""<<endl;
+
+    buffer << "#include <float.h>" << endl;
+    buffer << "#include <math.h>\n" << endl;
+
+    buffer << "#define NEURAL_NETWORK_INPUTS_NUMBER " << inputs_number << endl;
+    buffer << "#define NEURAL_NETWORK_OUTPUTS_NUMBER " << outputs_number << endl;
+    buffer << "#define NEURAL_NETWORK_BATCH_BLOCK_SIZE " << batch_block_size << endl;
+    buffer << "#define NEURAL_NETWORK_WORKSPACE_SIZE " << 2*batch_block_size*maximum_neurons_number << "\n" << endl;
+
+    buffer << "#if defined(_MSC_VER)" << endl;
+    buffer << "#define ALIGNED __declspec(align(32))" << endl;
+    buffer << "#else" << endl;
+    buffer << "#define ALIGNED __attribute__((aligned(32)))" << endl;
+    buffer << "#endif\n" << endl;
+
+    // Combinations kernel
+
+    buffer << "static inline void calculate_combinations(const float* __restrict inputs, int batch_size, int inputs_number, int neurons_number,"
+           << "\n\tconst float* __restrict biases, const float* __restrict synaptic_weights, float* __restrict combinations)\n{" << endl;
+    buffer << "\tfor(int i = 0; i < batch_size; i++)\n\t{" << endl;
+    buffer << "\t\tfloat* row = combinations + i*neurons_number;\n" << endl;
+    buffer << "\t\tfor(int j = 0; j < neurons_number; j++) row[j] = biases ? biases[j] : 0.0f;" << endl;
+    buffer << "\t}\n" << endl;
+    buffer << "\tfor(int k = 0; k < inputs_number; k++)\n\t{" << endl;
+    buffer << "\t\tconst float* __restrict weights = synaptic_weights + k*neurons_number;\n" << endl;
+    buffer << "\t\tfor(int i = 0; i < batch_size; i++)\n\t\t{" << endl;
+    buffer << "\t\t\tconst float input = inputs[i*inputs_number + k];\n" << endl;
+    buffer << "\t\t\tfloat* __restrict row = combinations + i*neurons_number;\n" << endl;
+    buffer << "\t\t\tfor(int j = 0; j < neurons_number; j++) row[j] += input*weights[j];" << endl;
+    buffer << "\t\t}" << endl;
+    buffer << "\t}" << endl;
+    buffer << "}\n" << endl;
+
+    // Layers
+
+    for(Index i = 0; i < layers_number; i++)
+    {
+        const string layer_expression = layers_pointers[i]->write_batch_expression_c();
+
+        if(layer_expression.empty())
+        {
+            ostringstream exception_buffer;
+
+            exception_buffer << "OpenNN Exception: NeuralNetwork class.\n"
+                             << "string write_batch_expression_c() const method.\n"
+                             << "Layer type (" << layers_pointers[i]->get_type_string() << ") cannot be written for batches.\n";
+
+            throw logic_error(exception_buffer.str());
+        }
+
+        buffer << layer_expression << endl;
+    }
+
+    // Neural network
+
+    buffer << "void neural_network(const float* inputs, float* outputs, int batch_size, float* workspace)\n{" << endl;
+
+    if(layers_number == 0)
+    {
+        buffer << "\tfor(int i = 0; i < batch_size*NEURAL_NETWORK_INPUTS_NUMBER; i++) outputs[i] = inputs[i];\n}" << endl;
+
+        return buffer.str();
+    }
+
+    if(layers_number > 1)
+    {
+        buffer << "\tfloat* buffers[2] = {workspace, workspace + NEURAL_NETWORK_BATCH_BLOCK_SIZE*" << maximum_neurons_number << "};\n" << endl;
+    }
+    else
+    {
+        buffer << "\t(void)workspace;\n" << endl;
+    }
+
+    buffer << "\tfor(int i = 0; i < batch_size; i += NEURAL_NETWORK_BATCH_BLOCK_SIZE)\n\t{" << endl;
+    buffer << "\t\tconst int block_size = batch_size - i < NEURAL_NETWORK_BATCH_BLOCK_SIZE ? batch_size - i : NEURAL_NETWORK_BATCH_BLOCK_SIZE;\n" << endl;
+
+    for(Index i = 0; i < layers_number; i++)
+    {
+        const string layer_inputs = i == 0
+                ? "inputs + i*NEURAL_NETWORK_INPUTS_NUMBER"
+                : "buffers[" + to_string((i-1)%2) + "]";
+
+        const string layer_outputs = i == layers_number-1
+                ? "outputs + i*NEURAL_NETWORK_OUTPUTS_NUMBER"
+                : "buffers[" + to_string(i%2) + "]";
+
+        buffer << "\t\t" << layers_names[i] << "(" << layer_inputs << ", " << layer_outputs << ", block_size);" << endl;
+    }
+
+    buffer << "\t}\n}" << endl;
+
+    return buffer.str();
+}
+
+
 /// Returns a string with the python function of the expression represented by the neural network.
 
 string NeuralNetwork::write_expression_python() const
@@ -2564,6 +3316,30 @@ void NeuralNetwork::save_expression_c(const string& file_name)
 }
 
 
+/// Saves the C code of the neural network for batches of inputs to a text file.
+/// @param file_name Name of expression text file.
+
+void NeuralNetwork::save_batch_expression_c(const string& file_name)
+{
+    ofstream file(file_name.c_str());
+
+    if(!file.is_open())
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: NeuralNetwork class.\n"
+               << "void save_batch_expression_c(const string&) method.\n"
+               << "Cannot open expression text file.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    file << write_batch_expression_c();
+
+    file.close();
+}
+
+
 /// Saves the python function of the expression represented by the neural network to a text file.
 /// @param file_name Name of expression text file.
 
@@ -18,6 +18,7 @@
 #include <string>
 #include <sstream>
 #include <errno.h>
+#include <stdint.h>
 
 // OpenNN includes
 
@@ -25,6 +26,7 @@
 #include "data_set.h"
 #include "layer.h"
 #include "perceptron_layer.h"
+#include "low_rank_perceptron_layer.h"
 #include "scaling_layer.h"
 #include "principal_components_layer.h"
 #include "unscaling_layer.h"
@@ -34,10 +36,27 @@
 #include "pooling_layer.h"
 #include "long_short_term_memory_layer.h"
 #include "recurrent_layer.h"
+#include "training_profiler.h"
 
 namespace OpenNN
 {
 
+/// Writes the XML of an object, such as a neural network or a training strategy, into a document which its from_XML() method reads.
+/// The documents of to_XML() are not read back by from_XML(), so the XML is printed and parsed again.
+/// @param object Object with a write_XML(tinyxml2::XMLPrinter&) method.
+/// @param document Document where the XML is parsed.
+
+template<class T>
+void write_XML_document(const T& object, tinyxml2::XMLDocument& document)
+{
+    tinyxml2::XMLPrinter printer;
+
+    object.write_XML(printer);
+
+    document.Parse(printer.CStr());
+}
+
+
 /// This class represents the concept of neural network in the OpenNN library.
 
 ///
@@ -218,6 +237,8 @@ public:
 
    const bool& get_display() const;
 
+   TrainingProfiler* get_profiler_pointer() const;
+
    // Set methods
 
    void set();
@@ -234,6 +255,10 @@ public:
    void set_inputs_number(const Index&);
    void set_inputs_number(const Tensor<bool, 1>&);
 
+   void resize_inputs(const Tensor<Index, 1>&);
+   void resize_hidden_neurons(const Index&);
+   void select_hidden_neurons(const Index&, const Tensor<Index, 1>&);
+
    virtual void set_default();
 
    void set_thread_pool_device(ThreadPoolDevice*);
@@ -244,6 +269,8 @@ public:
 
    void set_display(const bool&);
 
+   void set_profiler_pointer(TrainingProfiler*);
+
    // Layers 
 
    Index get_layers_number() const;
@@ -277,6 +304,8 @@ public:
 
    void set_parameters(Tensor<type, 1>&);
 
+   void mask_pruned_parameters(Tensor<type, 1>&) const;
+
    // Parameters initialization methods
 
    void set_parameters_constant(const type&);
@@ -325,6 +354,58 @@ public:
    void load_parameters(const string&);
    void load_parameters_binary(const string&);
 
+   // Binary model methods
+
+   /// This structure is the header of the binary model files.
+   /// It is followed by the architecture, which is the XML of the neural network without the parameters,
+   /// and by the parameters, which start at an offset aligned to binary_model_alignment bytes.
+
+   struct BinaryModelHeader
+   {
+       /// File signature, "OPENNNBM".
+
+       char magic[8];
+
+       /// Version of the binary model format.
+
+       uint32_t version;
+
+       /// Endianness tag, which is 0x01020304 when written by a machine with the same byte order.
+
+       uint32_t endianness;
+
+       /// Size in bytes of each parameter.
+
+       uint32_t scalar_size;
+
+       /// Alignment in bytes of the parameters.
+
+       uint32_t alignment;
+
+       /// Size in bytes of the architecture.
+
+       uint64_t architecture_size;
+
+       /// Checksum of the architecture.
+
+       uint64_t architecture_checksum;
+
+       /// Number of parameters.
+
+       uint64_t parameters_number;
+
+       /// Offset in bytes of the parameters from the beginning of the file.
+
+       uint64_t parameters_offset;
+
+       /// Checksum of the parameters, as written in the file.
+
+       uint64_t parameters_checksum;
+   };
+
+   void save_binary(const string&) const;
+   void load_binary(const string&);
+
    void save_data(const string&) const;
 
    Tensor<string, 1> get_layers_names() const
@@ -349,8 +430,10 @@ public:
    string write_expression_python() const;
    string write_expression_R() const;
    string write_expression_c() const;
+   string write_batch_expression_c() const;
 
    void save_expression_c(const string&);
+   void save_batch_expression_c(const string&);
    void save_expression_python(const string&);
    void save_expression_R(const string&);
 
@@ -478,6 +561,24 @@ protected:
 
    bool display = true;
 
+   /// Pointer to the profiler which times the forward propagation of each layer during a training, or nullptr.
+
+   TrainingProfiler* profiler_pointer = nullptr;
+
+   /// Version of the binary model files written by this class.
+
+   static const uint32_t binary_model_version = 1;
+
+   /// Alignment in bytes of the parameters in the binary model files.
+
+   static const uint32_t binary_model_alignment = 64;
+
+   string write_binary_architecture() const;
+
+   void load_binary_model(const char*, const size_t&);
+
+   static uint64_t calculate_checksum(const char*, const size_t&);
+
 #ifdef OPENNN_CUDA
     #include "../../opennn-cuda/opennn_cuda/neural_network_cuda.h"
 #endif
@@ -99,6 +99,15 @@ bool NeuronsSelection::has_training_strategy() const
 }
 
 
+/// Returns a pointer to the scheduler which trains the candidates concurrently.
+/// It can be used to set the number of workers and the threads of each worker.
+
+TrainingScheduler* NeuronsSelection::get_training_scheduler_pointer()
+{
+    return &training_scheduler;
+}
+
+
 /// Returns the maximum of the hidden perceptrons number used in the neurons selection.
 
 const Index& NeuronsSelection::get_maximum_neurons() const
@@ -123,6 +132,15 @@ const Index& NeuronsSelection::get_trials_number() const
 }
 
 
+/// Returns true if each step of the selection starts training from the parameters of the previous one,
+/// and false if the parameters are initialized at random.
+
+const bool& NeuronsSelection::get_warm_start() const
+{
+    return warm_start;
+}
+
+
 /// Returns true if the loss index losses are to be reserved, and false otherwise.
 
 const bool& NeuronsSelection::get_reserve_training_error_data() const
@@ -224,6 +242,8 @@ void NeuronsSelection::set_default()
     maximum_neurons = 2*(inputs_number + outputs_number);
     trials_number = 1;
 
+    warm_start = false;
+
     // Neurons selection results
 
     reserve_training_error_data = true;
@@ -335,6 +355,16 @@ void NeuronsSelection::set_trials_number(const Index& new_trials_number)
 }
 
 
+/// Sets whether each step of the selection starts training from the parameters of the previous one.
+/// The parameters of the inputs or neurons which remain are kept, and those of the new ones are initialized near zero.
+/// @param new_warm_start True to start from the previous parameters, false to start from random parameters.
+
+void NeuronsSelection::set_warm_start(const bool& new_warm_start)
+{
+    warm_start = new_warm_start;
+}
+
+
 /// Sets the reserve flag for the loss data.
 /// @param new_reserve_training_error_data Flag value.
 
@@ -506,93 +536,75 @@ Tensor<type, 1> NeuronsSelection::calculate_losses(const Index& neurons_number,
 
     const Tensor<Layer*, 1> trainable_layers_pointers = neural_network.get_trainable_layers_pointers();
 
-    // Loss index
+    trainable_layers_pointers[trainable_layers_number-2]->set_neurons_number(neurons_number); // Fix
+    trainable_layers_pointers[trainable_layers_number-1]->set_inputs_number(neurons_number); // Fix
 
-    type optimum_selection_error = numeric_limits<type>::max();
-    type optimum_training_error = numeric_limits<type>::max();
-    Tensor<type, 1> optimum_parameters;
+    // Trials
 
-    // Optimization algorithm
+    Tensor<Index, 1> neurons_numbers(1);
+    neurons_numbers.setConstant(neurons_number);
 
-    OptimizationAlgorithm::Results results;
+    const OptimizationAlgorithm::Results optimum_results = perform_trials(neurons_numbers)(0);
 
     Tensor<type, 1> final_losses(2);
 
-    final_losses.setConstant(numeric_limits<type>::max());
+    final_losses[0] = optimum_results.final_training_error;
+    final_losses[1] = optimum_results.final_selection_error;
 
-    Tensor<type, 1> current_loss(2);
+    return final_losses;
+}
 
-    Tensor<type, 1> final_parameters;
 
-    bool flag_training = false;
-    bool flag_selection = false;
+/// Trains trials_number times the neural network with each of the given numbers of hidden neurons,
+/// and returns the results of the trial with the minimum selection error for each neurons number.
+/// The trainings run concurrently on the training scheduler, which does not train again the neurons numbers already evaluated.
+/// The results are appended to the histories.
+/// @param neurons_numbers Neurons numbers of the last hidden layer of each candidate.
+/// @param parameters Initial parameters of each candidate for its first trial. If empty, all the trials start from random parameters.
 
-    for(Index i = 0; i < neurons_history.size(); i++)
-    {
-        if(neurons_history[i] == neurons_number)
-        {
-            final_losses[0] = training_error_history[i];
-            flag_training = true;
-        }
-    }
+Tensor<OptimizationAlgorithm::Results, 1> NeuronsSelection::perform_trials(const Tensor<Index, 1>& neurons_numbers,
+                                                                           const Tensor<Tensor<type, 1>, 1>& parameters)
+{
+    const Index candidates_number = neurons_numbers.size();
+
+    Tensor<TrainingScheduler::Candidate, 1> candidates(candidates_number);
 
-    for(Index i = 0; i < neurons_history.size(); i++)
+    for(Index i = 0; i < candidates_number; i++)
     {
-        if(neurons_history[i] == neurons_number)
-        {
-            final_losses[1] = selection_error_history[i];
-            flag_selection = true;
-        }
+        candidates(i).neurons_number = neurons_numbers(i);
+
+        if(parameters.size() != 0) candidates(i).parameters = parameters(i);
     }
 
-    if(flag_training && flag_selection)
+    if(training_scheduler.get_training_strategy_pointer() != training_strategy_pointer)
     {
-        return final_losses;
+        training_scheduler.set_training_strategy_pointer(training_strategy_pointer);
     }
 
-    trainable_layers_pointers[trainable_layers_number-2]->set_neurons_number(neurons_number); // Fix
-    trainable_layers_pointers[trainable_layers_number-1]->set_inputs_number(neurons_number); // Fix
+    const Tensor<OptimizationAlgorithm::Results, 1> optimum_results = training_scheduler.perform_trials(candidates, trials_number);
 
-    for(Index i = 0; i < trials_number; i++)
+    for(Index i = 0; i < candidates_number; i++)
     {
-        neural_network.set_parameters_random();
-
-        const OptimizationAlgorithm::Results optimization_algorithm_results = training_strategy_pointer->perform_training();
-
-        const type current_training_error = optimization_algorithm_results.final_training_error;
-        const type current_selection_error = optimization_algorithm_results.final_selection_error;
-        const Tensor<type, 1> current_parameters = optimization_algorithm_results.final_parameters;
-
-        if(current_selection_error < optimum_selection_error)
-        {
-            optimum_training_error = current_training_error;
-            optimum_selection_error = current_selection_error;
-            optimum_parameters = current_parameters; // Optimum parameters = final_parameters
-        }
+        const OptimizationAlgorithm::Results& results = optimum_results(i);
 
         if(display)
         {
-            cout << "Trial number: " << i << endl;
-            cout << "Training error: " << current_training_error << endl;
-            cout << "Selection error: " << current_selection_error << endl;
-            cout << "Stopping condition: " << optimization_algorithm_results.write_stopping_condition() << endl << endl;
+            cout << "Neurons number: " << neurons_numbers(i) << endl;
+            cout << "Training error: " << results.final_training_error << endl;
+            cout << "Selection error: " << results.final_selection_error << endl;
+            cout << "Stopping condition: " << results.write_stopping_condition() << endl << endl;
         }
-    }
-
-    // Save results
 
-    final_losses[0] = optimum_training_error;
-    final_losses[1] = optimum_selection_error;
+        neurons_history.push_back(neurons_numbers(i));
 
-    neurons_history = insert_result(neurons_number, neurons_history.cast<type>()).cast<Index>();
+        training_error_history.push_back(results.final_training_error);
 
-    training_error_history = insert_result(final_losses(0), training_error_history);
+        selection_error_history.push_back(results.final_selection_error);
 
-    selection_error_history = insert_result(final_losses(1), selection_error_history);
-
-    parameters_history = insert_result(optimum_parameters, parameters_history);
+        parameters_history.push_back(results.final_parameters);
+    }
 
-    return final_losses;
+    return optimum_results;
 }
 
 
@@ -660,7 +672,7 @@ string NeuronsSelection::write_stopping_condition(const OptimizationAlgorithm::R
 
 void NeuronsSelection::delete_selection_history()
 {
-    selection_error_history.resize(0);
+    selection_error_history.clear();
 }
 
 
@@ -668,9 +680,7 @@ void NeuronsSelection::delete_selection_history()
 
 void NeuronsSelection::delete_training_error_history()
 {
-
-    training_error_history.resize(0);
-
+    training_error_history.clear();
 }
 
 
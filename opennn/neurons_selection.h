@@ -17,11 +17,13 @@
 #include <sstream>
 #include <cmath>
 #include <ctime>
+#include <vector>
 
 // OpenNN includes
 
 #include "config.h"
 #include "training_strategy.h"
+#include "training_scheduler.h"
 
 namespace OpenNN
 {
@@ -118,9 +120,12 @@ public:
 
     bool has_training_strategy() const;
 
+    TrainingScheduler* get_training_scheduler_pointer();
+
     const Index& get_maximum_neurons() const;
     const Index& get_minimum_neurons() const;
     const Index& get_trials_number() const;
+    const bool& get_warm_start() const;
 
     const bool& get_reserve_training_error_data() const;
     const bool& get_reserve_selection_error_data() const;
@@ -142,6 +147,7 @@ public:
     void set_maximum_neurons(const Index&);
     void set_minimum_neurons(const Index&);
     void set_trials_number(const Index&);
+    void set_warm_start(const bool&);
 
     void set_reserve_training_error_data(const bool&);
     void set_reserve_selection_error_data(const bool&);
@@ -158,6 +164,8 @@ public:
 
     Tensor<type, 1> calculate_losses(const Index&, NeuralNetwork&);
 
+    Tensor<OptimizationAlgorithm::Results, 1> perform_trials(const Tensor<Index, 1>&, const Tensor<Tensor<type, 1>, 1>& = Tensor<Tensor<type, 1>, 1>());
+
     string write_stopping_condition(const OptimizationAlgorithm::Results&) const;
 
     // Neuron selection methods
@@ -188,21 +196,25 @@ protected:
 
     TrainingStrategy* training_strategy_pointer = nullptr;
 
+    /// Scheduler which trains the candidates concurrently on copies of the training strategy.
+
+    TrainingScheduler training_scheduler;
+
     /// Neurons of all the neural networks trained.
 
-    Tensor<Index, 1> neurons_history;
+    vector<Index> neurons_history;
 
     /// Selection loss of all the neural networks trained.
 
-    Tensor<type, 1> selection_error_history;
+    vector<type> selection_error_history;
 
     /// Performance of all the neural networks trained.
 
-    Tensor<type, 1> training_error_history;
+    vector<type> training_error_history;
 
     /// Parameters of all the neural networks trained.
 
-    Tensor<Tensor<type, 1>, 1> parameters_history;
+    vector<Tensor<type, 1>> parameters_history;
 
     /// Minimum number of hidden neurons.
 
@@ -216,6 +228,10 @@ protected:
 
     Index trials_number;
 
+    /// True if each step of the selection starts training from the parameters of the previous one.
+
+    bool warm_start = false;
+
     // Neurons selection results
 
     /// True if the loss of all neural networks are to be reserved.
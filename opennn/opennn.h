@@ -25,6 +25,7 @@
 #include "convolutional_layer.h"
 #include "bounding_layer.h"
 #include "perceptron_layer.h"
+#include "low_rank_perceptron_layer.h"
 #include "long_short_term_memory_layer.h"
 #include "recurrent_layer.h"
 #include "probabilistic_layer.h"
@@ -47,11 +48,24 @@
 #include "gradient_descent.h"
 #include "levenberg_marquardt_algorithm.h"
 #include "quasi_newton_method.h"
+#include "training_checkpoint.h"
+#include "training_profiler.h"
+#include "training_control.h"
+#include "training_observer.h"
+#include "async_training_observer.h"
+#include "csv_training_observer.h"
+#include "json_lines_training_observer.h"
+#include "prometheus_training_observer.h"
 #include "optimization_algorithm.h"
 #include "learning_rate_algorithm.h"
 
 // Model selection
 
+#include "training_scheduler.h"
+#include "cross_validation.h"
+#include "batch_predictor.h"
+#include "model_server.h"
+#include "gradient_checker.h"
 #include "model_selection.h"
 #include "neurons_selection.h"
 #include "incremental_neurons.h"
@@ -64,6 +78,18 @@
 
 #include "testing_analysis.h"
 
+// Pruning
+
+#include "pruning_weights.h"
+
+// Folding
+
+#include "layers_folding.h"
+
+// Quantization
+
+#include "quantized_neural_network.h"
+
 // Utilities
 
 #include "numerical_differentiation.h"
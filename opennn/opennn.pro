@@ -58,6 +58,7 @@ HEADERS += \
     scaling_layer.h \
     unscaling_layer.h \
     perceptron_layer.h \
+    low_rank_perceptron_layer.h \
     probabilistic_layer.h \
     pooling_layer.h \
     convolutional_layer.h \
@@ -71,6 +72,19 @@ HEADERS += \
     optimization_algorithm.h \
     stochastic_gradient_descent.h\
     training_strategy.h \
+    training_scheduler.h \
+    cross_validation.h \
+    batch_predictor.h \
+    model_server.h \
+    gradient_checker.h \
+    training_checkpoint.h \
+    training_profiler.h \
+    training_control.h \
+    training_observer.h \
+    async_training_observer.h \
+    csv_training_observer.h \
+    json_lines_training_observer.h \
+    prometheus_training_observer.h \
     neural_network.h \
     sum_squared_error.h\
     normalized_squared_error.h\
@@ -92,8 +106,11 @@ HEADERS += \
     inputs_selection.h \
     growing_inputs.h \
     pruning_inputs.h \
+    pruning_weights.h \
+    layers_folding.h \
     genetic_algorithm.h \
     testing_analysis.h \
+    quantized_neural_network.h \
     response_optimization.h \
     unit_testing.h \
     opennn.h
@@ -109,6 +126,7 @@ SOURCES += \
     scaling_layer.cpp \
     unscaling_layer.cpp \
     perceptron_layer.cpp \
+    low_rank_perceptron_layer.cpp \
     probabilistic_layer.cpp \
     pooling_layer.cpp \
     bounding_layer.cpp \
@@ -121,6 +139,19 @@ SOURCES += \
     mean_squared_error.cpp \
     stochastic_gradient_descent.cpp \
     training_strategy.cpp \
+    training_scheduler.cpp \
+    cross_validation.cpp \
+    batch_predictor.cpp \
+    model_server.cpp \
+    gradient_checker.cpp \
+    training_checkpoint.cpp \
+    training_profiler.cpp \
+    training_control.cpp \
+    training_observer.cpp \
+    async_training_observer.cpp \
+    csv_training_observer.cpp \
+    json_lines_training_observer.cpp \
+    prometheus_training_observer.cpp \
     optimization_algorithm.cpp \
     data_set.cpp \
     sum_squared_error.cpp \
@@ -142,8 +173,11 @@ SOURCES += \
     inputs_selection.cpp \
     growing_inputs.cpp \
     pruning_inputs.cpp \
+    pruning_weights.cpp \
+    layers_folding.cpp \
     genetic_algorithm.cpp \
     testing_analysis.cpp \
+    quantized_neural_network.cpp \
     response_optimization.cpp \
     unit_testing.cpp
 
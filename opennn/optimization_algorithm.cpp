@@ -57,9 +57,11 @@ OptimizationAlgorithm::OptimizationAlgorithm(const tinyxml2::XMLDocument& docume
 
 
 /// Destructor.
+/// It waits for the last checkpoint to be written.
 
 OptimizationAlgorithm::~OptimizationAlgorithm()
 {
+    wait_checkpoint();
 }
 
 
@@ -136,6 +138,64 @@ const string& OptimizationAlgorithm::get_neural_network_file_name() const
 }
 
 
+/// Returns the number of epochs between the training checkpoints.
+
+const Index& OptimizationAlgorithm::get_checkpoint_period() const
+{
+    return checkpoint_period;
+}
+
+
+/// Returns the path of the checkpoints, to which the epoch number and the extension are appended.
+
+const string& OptimizationAlgorithm::get_checkpoint_file_name() const
+{
+    return checkpoint_file_name;
+}
+
+
+/// Returns the number of most recent checkpoints which are kept.
+
+const Index& OptimizationAlgorithm::get_maximum_checkpoints_number() const
+{
+    return maximum_checkpoints_number;
+}
+
+
+/// Returns the path of the checkpoint from which the training is resumed.
+
+const string& OptimizationAlgorithm::get_resume_file_name() const
+{
+    return resume_file_name;
+}
+
+
+/// Returns a reference to the profiler of the training phases.
+/// It can be used to record the timeline of a training and save it in the Chrome trace format.
+
+TrainingProfiler& OptimizationAlgorithm::get_profiler()
+{
+    return profiler;
+}
+
+
+/// Returns the observers of the training metrics.
+
+const vector<TrainingObserver*>& OptimizationAlgorithm::get_observers() const
+{
+    return observers;
+}
+
+
+/// Returns a reference to the training control, with which another thread or an observer can stop or pause the training.
+/// The signals are cleared when a training begins.
+
+TrainingControl& OptimizationAlgorithm::get_training_control()
+{
+    return training_control;
+}
+
+
 /// Sets the loss index pointer to nullptr.
 /// It also sets the rest of members to their default values.
 
@@ -251,6 +311,530 @@ void OptimizationAlgorithm::set_neural_network_file_name(const string& new_neura
 }
 
 
+/// Sets the number of epochs between the training checkpoints.
+/// The checkpoints contain the full state of the optimization algorithm, and they are written by a separate thread.
+/// @param new_checkpoint_period Number of epochs between checkpoints. Zero disables the checkpoints.
+
+void OptimizationAlgorithm::set_checkpoint_period(const Index& new_checkpoint_period)
+{
+    if(new_checkpoint_period < 0)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: OptimizationAlgorithm class.\n"
+               << "void set_checkpoint_period(const Index&) method.\n"
+               << "Checkpoint period must be equal or greater than 0.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    checkpoint_period = new_checkpoint_period;
+}
+
+
+/// Sets the path of the checkpoints.
+/// Each checkpoint is written to this path followed by "_", the epoch number and ".bin".
+/// @param new_checkpoint_file_name Path of the checkpoints.
+
+void OptimizationAlgorithm::set_checkpoint_file_name(const string& new_checkpoint_file_name)
+{
+    checkpoint_file_name = new_checkpoint_file_name;
+}
+
+
+/// Sets the number of most recent checkpoints which are kept on disk.
+/// @param new_maximum_checkpoints_number Number of checkpoints. Zero keeps all the checkpoints.
+
+void OptimizationAlgorithm::set_maximum_checkpoints_number(const Index& new_maximum_checkpoints_number)
+{
+    if(new_maximum_checkpoints_number < 0)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: OptimizationAlgorithm class.\n"
+               << "void set_maximum_checkpoints_number(const Index&) method.\n"
+               << "Maximum number of checkpoints must be equal or greater than 0.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    maximum_checkpoints_number = new_maximum_checkpoints_number;
+}
+
+
+/// Sets the checkpoint from which the next training is resumed.
+/// The resumed training calculates the same parameters as the training which wrote the checkpoint.
+/// @param new_resume_file_name Path of a checkpoint file. Empty starts the training from the beginning.
+
+void OptimizationAlgorithm::set_resume_file_name(const string& new_resume_file_name)
+{
+    resume_file_name = new_resume_file_name;
+}
+
+
+/// Waits until the last checkpoint has been written.
+
+void OptimizationAlgorithm::wait_checkpoint()
+{
+    if(checkpoint_thread.joinable()) checkpoint_thread.join();
+}
+
+
+/// Prepares the checkpoints at the beginning of a training.
+/// If the training is resumed, it loads the checkpoint and the error histories,
+/// and the optimization algorithm must read the rest of its state from the checkpoint.
+/// Returns true if the training is resumed, and false otherwise.
+/// @param checkpoint Checkpoint which is loaded.
+/// @param results Results whose error histories are loaded.
+
+bool OptimizationAlgorithm::start_checkpoints(TrainingCheckpoint& checkpoint, Results& results)
+{
+    wait_checkpoint();
+
+    checkpoints_files_names.clear();
+
+    checkpoint.set_optimization_algorithm_type(write_optimization_algorithm_type());
+
+    if(resume_file_name.empty())
+    {
+        if(checkpoint_period > 0) checkpoint_random_seed = static_cast<unsigned>(rand());
+
+        return false;
+    }
+
+    checkpoint.load(resume_file_name);
+
+    if(checkpoint.get_optimization_algorithm_type() != write_optimization_algorithm_type())
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: OptimizationAlgorithm class.\n"
+               << "bool start_checkpoints(TrainingCheckpoint&, Results&) method.\n"
+               << "Checkpoint was written by " << checkpoint.get_optimization_algorithm_type() << ".\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    checkpoint_random_seed = checkpoint.get_random_seed();
+
+    const Index epochs_number = checkpoint.get_epoch();
+
+    if(checkpoint.has_vector("training_error_history") && results.training_error_history.size() >= epochs_number)
+    {
+        const Tensor<type, 1>& training_error_history = checkpoint.get_vector("training_error_history");
+
+        for(Index i = 0; i < epochs_number; i++) results.training_error_history(i) = training_error_history(i);
+    }
+
+    if(checkpoint.has_vector("selection_error_history") && results.selection_error_history.size() >= epochs_number)
+    {
+        const Tensor<type, 1>& selection_error_history = checkpoint.get_vector("selection_error_history");
+
+        for(Index i = 0; i < epochs_number; i++) results.selection_error_history(i) = selection_error_history(i);
+    }
+
+    return true;
+}
+
+
+/// Returns true if a checkpoint is written after the given number of epochs, and false otherwise.
+/// @param epochs_number Number of epochs done.
+
+bool OptimizationAlgorithm::is_checkpoint_epoch(const Index& epochs_number) const
+{
+    return checkpoint_period > 0 && epochs_number % checkpoint_period == 0;
+}
+
+
+/// Returns the random generator of the shuffles of the batches of an epoch when the checkpoints are enabled,
+/// so that the batches of a resumed training are the same as those of the training which wrote the checkpoint.
+/// The generator depends only on the checkpoint seed and the epoch, and the global random numbers are not seeded.
+/// It returns nullptr when the checkpoints are disabled, and then the global random numbers are used.
+/// @param epoch Epoch number.
+
+mt19937* OptimizationAlgorithm::get_epoch_random_generator(const Index& epoch)
+{
+    if(checkpoint_period == 0 && resume_file_name.empty()) return nullptr;
+
+    epoch_random_generator.seed(checkpoint_random_seed + static_cast<unsigned>(epoch));
+
+    return &epoch_random_generator;
+}
+
+
+/// Writes a checkpoint in a separate thread, so that the training is not blocked.
+/// The optimization algorithm sets its state in the checkpoint, and this method sets the error histories.
+/// It waits for the previous checkpoint to be written, and copies the checkpoint for the thread.
+/// @param checkpoint Checkpoint with the state of the optimization algorithm.
+/// @param results Results with the error histories.
+/// @param epochs_number Number of epochs done, from which the training is resumed.
+/// @param elapsed_time Elapsed time of the training.
+
+void OptimizationAlgorithm::write_checkpoint(TrainingCheckpoint& checkpoint,
+                                             const Results& results,
+                                             const Index& epochs_number,
+                                             const type& elapsed_time)
+{
+    checkpoint.set_epoch(epochs_number);
+    checkpoint.set_elapsed_time(elapsed_time);
+    checkpoint.set_random_seed(checkpoint_random_seed);
+
+    const Eigen::array<Index, 1> offsets = {0};
+    const Eigen::array<Index, 1> extents = {epochs_number};
+
+    if(results.training_error_history.size() >= epochs_number)
+    {
+        checkpoint.set_vector("training_error_history", results.training_error_history.slice(offsets, extents));
+    }
+
+    if(results.selection_error_history.size() >= epochs_number)
+    {
+        checkpoint.set_vector("selection_error_history", results.selection_error_history.slice(offsets, extents));
+    }
+
+    wait_checkpoint();
+
+    checkpoint_thread = thread(&OptimizationAlgorithm::save_checkpoint, this, checkpoint);
+}
+
+
+/// Saves a checkpoint and removes the oldest checkpoints.
+/// The checkpoint is saved to a temporary file which is then renamed, so that an interrupted write does not leave a broken checkpoint.
+/// @param checkpoint Checkpoint to be saved.
+
+void OptimizationAlgorithm::save_checkpoint(const TrainingCheckpoint& checkpoint)
+{
+    const string file_name = checkpoint_file_name + "_" + to_string(checkpoint.get_epoch()) + ".bin";
+    const string temporary_file_name = file_name + ".tmp";
+
+    try
+    {
+        checkpoint.save(temporary_file_name);
+
+        remove(file_name.c_str());
+
+        if(rename(temporary_file_name.c_str(), file_name.c_str()) != 0)
+        {
+            ostringstream buffer;
+
+            buffer << "OpenNN Exception: OptimizationAlgorithm class.\n"
+                   << "void save_checkpoint(const TrainingCheckpoint&) method.\n"
+                   << "Cannot rename checkpoint file: " << file_name << "\n";
+
+            throw logic_error(buffer.str());
+        }
+    }
+    catch(const logic_error& e)
+    {
+        cerr << e.what() << endl;
+
+        return;
+    }
+
+    checkpoints_files_names.push_back(file_name);
+
+    while(maximum_checkpoints_number > 0 && static_cast<Index>(checkpoints_files_names.size()) > maximum_checkpoints_number)
+    {
+        remove(checkpoints_files_names.front().c_str());
+
+        checkpoints_files_names.pop_front();
+    }
+}
+
+
+/// Serializes the checkpoint settings into the element of an optimization algorithm.
+/// The checkpoint from which the training is resumed is not serialized, since it depends on each training.
+/// @param file_stream XML printer, whose current element is that of the optimization algorithm.
+
+void OptimizationAlgorithm::write_checkpoints_XML(tinyxml2::XMLPrinter& file_stream) const
+{
+    ostringstream buffer;
+
+    // Checkpoint period
+
+    file_stream.OpenElement("CheckpointPeriod");
+
+    buffer.str("");
+    buffer << checkpoint_period;
+
+    file_stream.PushText(buffer.str().c_str());
+
+    file_stream.CloseElement();
+
+    // Checkpoint file name
+
+    file_stream.OpenElement("CheckpointFileName");
+
+    file_stream.PushText(checkpoint_file_name.c_str());
+
+    file_stream.CloseElement();
+
+    // Maximum checkpoints number
+
+    file_stream.OpenElement("MaximumCheckpointsNumber");
+
+    buffer.str("");
+    buffer << maximum_checkpoints_number;
+
+    file_stream.PushText(buffer.str().c_str());
+
+    file_stream.CloseElement();
+}
+
+
+/// Loads the checkpoint settings from the element of an optimization algorithm.
+/// The settings which are not in the element are not changed.
+/// @param root_element Element of the optimization algorithm.
+
+void OptimizationAlgorithm::checkpoints_from_XML(const tinyxml2::XMLElement* root_element)
+{
+    // Checkpoint period
+    {
+        const tinyxml2::XMLElement* element = root_element->FirstChildElement("CheckpointPeriod");
+
+        if(element && element->GetText())
+        {
+            const Index new_checkpoint_period = static_cast<Index>(atoi(element->GetText()));
+
+            try
+            {
+                set_checkpoint_period(new_checkpoint_period);
+            }
+            catch(const logic_error& e)
+            {
+                cerr << e.what() << endl;
+            }
+        }
+    }
+
+    // Checkpoint file name
+    {
+        const tinyxml2::XMLElement* element = root_element->FirstChildElement("CheckpointFileName");
+
+        if(element && element->GetText())
+        {
+            const string new_checkpoint_file_name = element->GetText();
+
+            try
+            {
+                set_checkpoint_file_name(new_checkpoint_file_name);
+            }
+            catch(const logic_error& e)
+            {
+                cerr << e.what() << endl;
+            }
+        }
+    }
+
+    // Maximum checkpoints number
+    {
+        const tinyxml2::XMLElement* element = root_element->FirstChildElement("MaximumCheckpointsNumber");
+
+        if(element && element->GetText())
+        {
+            const Index new_maximum_checkpoints_number = static_cast<Index>(atoi(element->GetText()));
+
+            try
+            {
+                set_maximum_checkpoints_number(new_maximum_checkpoints_number);
+            }
+            catch(const logic_error& e)
+            {
+                cerr << e.what() << endl;
+            }
+        }
+    }
+}
+
+
+/// Starts the profiler and sets it to the neural network, so that the phases of the training are timed.
+/// It does nothing unless OPENNN_PROFILE is defined.
+
+void OptimizationAlgorithm::start_profile()
+{
+#ifdef OPENNN_PROFILE
+
+    NeuralNetwork* neural_network_pointer = loss_index_pointer->get_neural_network_pointer();
+
+    profiler.start(neural_network_pointer->get_trainable_layers_number());
+
+    neural_network_pointer->set_profiler_pointer(&profiler);
+
+#endif
+}
+
+
+/// Begins the profile of an epoch. The measures of the previous epoch are aggregated.
+/// It does nothing unless OPENNN_PROFILE is defined.
+/// @param epoch Epoch number.
+
+void OptimizationAlgorithm::begin_epoch_profile(const Index& epoch)
+{
+#ifdef OPENNN_PROFILE
+
+    profiler.begin_epoch(epoch);
+
+#else
+
+    (void)epoch;
+
+#endif
+}
+
+
+/// Finishes the profile of the training and copies the measures of each epoch to the results.
+/// It does nothing unless OPENNN_PROFILE is defined.
+/// @param results Results of the training.
+
+void OptimizationAlgorithm::finish_profile(Results& results)
+{
+#ifdef OPENNN_PROFILE
+
+    profiler.finish();
+
+    loss_index_pointer->get_neural_network_pointer()->set_profiler_pointer(nullptr);
+
+    results.profile_history = profiler.get_epochs_profiles();
+
+#else
+
+    (void)results;
+
+#endif
+}
+
+
+/// Adds an observer of the training metrics. The optimization algorithm does not take its ownership,
+/// so the observer must live until the training ends.
+/// @param observer_pointer Pointer to the observer.
+
+void OptimizationAlgorithm::add_observer(TrainingObserver* observer_pointer)
+{
+    if(observer_pointer == nullptr)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: OptimizationAlgorithm class.\n"
+               << "void add_observer(TrainingObserver*) method.\n"
+               << "Observer pointer is nullptr.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    observers.push_back(observer_pointer);
+}
+
+
+/// Removes all the observers of the training metrics.
+
+void OptimizationAlgorithm::clear_observers()
+{
+    observers.clear();
+}
+
+
+/// Returns true if the optimization algorithm has observers, so that the metrics which are only needed by them can be skipped.
+
+bool OptimizationAlgorithm::has_observers() const
+{
+    return !observers.empty();
+}
+
+
+/// Clears the signals of the training control, starts the clocks of the metrics and notifies the beginning of the training.
+
+void OptimizationAlgorithm::begin_observers()
+{
+    training_control.reset();
+
+    training_beginning_time = chrono::steady_clock::now();
+    last_iteration_time = training_beginning_time;
+    last_epoch_time = training_beginning_time;
+
+    last_epoch_metrics = TrainingObserver::Metrics();
+
+    if(observers.empty()) return;
+
+    const string optimization_algorithm_type = write_optimization_algorithm_type();
+
+    for(size_t i = 0; i < observers.size(); i++)
+    {
+        observers[i]->on_training_begin(optimization_algorithm_type);
+    }
+}
+
+
+/// Sets the times and the throughput of an iteration and notifies it to the observers.
+/// @param metrics Metrics of the iteration, with the instances number, the losses and the rates already set.
+
+void OptimizationAlgorithm::notify_iteration(TrainingObserver::Metrics& metrics)
+{
+    if(observers.empty()) return;
+
+    const chrono::steady_clock::time_point current_time = chrono::steady_clock::now();
+
+    metrics.time = static_cast<type>(chrono::duration<double>(current_time - last_iteration_time).count());
+    metrics.elapsed_time = static_cast<type>(chrono::duration<double>(current_time - training_beginning_time).count());
+    metrics.instances_per_second = metrics.time > 0 ? static_cast<type>(metrics.instances_number)/metrics.time : 0;
+
+    last_iteration_time = current_time;
+
+    for(size_t i = 0; i < observers.size(); i++)
+    {
+        observers[i]->on_iteration(metrics);
+    }
+}
+
+
+/// Sets the times and the throughput of an epoch and notifies it to the observers.
+/// @param metrics Metrics of the epoch, with the instances number, the losses and the rates already set.
+
+void OptimizationAlgorithm::notify_epoch(TrainingObserver::Metrics& metrics)
+{
+    if(observers.empty()) return;
+
+    const chrono::steady_clock::time_point current_time = chrono::steady_clock::now();
+
+    metrics.time = static_cast<type>(chrono::duration<double>(current_time - last_epoch_time).count());
+    metrics.elapsed_time = static_cast<type>(chrono::duration<double>(current_time - training_beginning_time).count());
+    metrics.instances_per_second = metrics.time > 0 ? static_cast<type>(metrics.instances_number)/metrics.time : 0;
+
+    last_epoch_time = current_time;
+    last_iteration_time = current_time;
+
+    last_epoch_metrics = metrics;
+
+    for(size_t i = 0; i < observers.size(); i++)
+    {
+        observers[i]->on_epoch(metrics);
+    }
+}
+
+
+/// Notifies the end of the training to the observers, with the metrics of the last epoch.
+/// @param results Results of the training.
+
+void OptimizationAlgorithm::end_observers(const Results& results)
+{
+    if(observers.empty()) return;
+
+    const string stopping_condition = results.write_stopping_condition();
+
+    for(size_t i = 0; i < observers.size(); i++)
+    {
+        observers[i]->on_training_end(last_epoch_metrics, stopping_condition);
+    }
+}
+
+
+/// Waits while the training is paused and returns true if it has been requested to stop.
+
+bool OptimizationAlgorithm::check_training_control() const
+{
+    return training_control.wait_while_paused();
+}
+
+
 /// Sets the members of the optimization algorithm object to their default values.
 
 void OptimizationAlgorithm::set_default()
@@ -477,6 +1061,9 @@ string OptimizationAlgorithm::Results::write_stopping_condition() const
 
     case MaximumTime:
         return "Maximum training time";
+
+    case StopRequested:
+        return "Stop requested";
     }
 
     return string();
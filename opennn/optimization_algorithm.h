@@ -19,11 +19,19 @@
 #include <cmath>
 #include <ctime>
 #include <iomanip>
+#include <cstdio>
+#include <deque>
+#include <thread>
+#include <random>
 
 // OpenNN includes
 
 #include "config.h"
 #include "loss_index.h"
+#include "training_checkpoint.h"
+#include "training_profiler.h"
+#include "training_observer.h"
+#include "training_control.h"
 
 using namespace std;
 using namespace Eigen;
@@ -53,7 +61,7 @@ public:
     /// Enumeration of all possibles condition of stop for the algorithms.
 
     enum StoppingCondition{MinimumParametersIncrementNorm, MinimumLossDecrease, LossGoal, GradientNormGoal,
-                           MaximumSelectionErrorIncreases, MaximumEpochsNumber, MaximumTime};
+                           MaximumSelectionErrorIncreases, MaximumEpochsNumber, MaximumTime, StopRequested};
 
     struct OptimizationData
     {
@@ -85,7 +93,12 @@ public:
         Tensor<type, 1> training_direction;
         type initial_learning_rate = 0;
 
+        /// Subsample of the batch on which the learning rate algorithm brackets the minimum, with its propagations.
+        /// They are allocated by the learning rate algorithm the first time they are used.
 
+        DataSet::Batch bracketing_batch;
+        NeuralNetwork::ForwardPropagation bracketing_forward_propagation;
+        LossIndex::BackPropagation bracketing_back_propagation;
     };
 
    /// This structure contains the optimization algorithm results.    
@@ -180,6 +193,10 @@ public:
        /// Stopping criterion.
 
        string stopping_criterion;
+
+       /// Time and counters of the phases of each epoch. It is only filled when OPENNN_PROFILE is defined.
+
+       vector<TrainingProfiler::EpochProfile> profile_history;
    };
 
 
@@ -199,6 +216,17 @@ public:
 
    const string& get_neural_network_file_name() const;
 
+   const Index& get_checkpoint_period() const;
+   const string& get_checkpoint_file_name() const;
+   const Index& get_maximum_checkpoints_number() const;
+   const string& get_resume_file_name() const;
+
+   TrainingProfiler& get_profiler();
+
+   const vector<TrainingObserver*>& get_observers() const;
+
+   TrainingControl& get_training_control();
+
    /// Writes the time from seconds in format HH:mm:ss.
 
    const string write_elapsed_time(const type&) const;
@@ -221,8 +249,23 @@ public:
    void set_save_period(const Index&);
    void set_neural_network_file_name(const string&);
 
+   void set_checkpoint_period(const Index&);
+   void set_checkpoint_file_name(const string&);
+   void set_maximum_checkpoints_number(const Index&);
+   void set_resume_file_name(const string&);
+
    virtual void set_reserve_selection_error_history(const bool&) = 0;
 
+   // Observer methods
+
+   void add_observer(TrainingObserver*);
+
+   void clear_observers();
+
+   // Checkpoint methods
+
+   void wait_checkpoint();
+
    // Training methods
 
    virtual void check() const;
@@ -278,6 +321,100 @@ protected:
 
    bool display;
 
+   // CHECKPOINTS
+
+   /// Number of epochs between the training checkpoints. Zero means that no checkpoints are written.
+
+   Index checkpoint_period = 0;
+
+   /// Path of the checkpoints, to which the epoch number and the extension are appended.
+
+   string checkpoint_file_name = "checkpoint";
+
+   /// Number of most recent checkpoints which are kept. The older ones are removed.
+
+   Index maximum_checkpoints_number = 3;
+
+   /// Path of the checkpoint from which the training is resumed. Empty means that the training starts from the beginning.
+
+   string resume_file_name;
+
+   /// Seed of the shuffles of the batches, which is kept in the checkpoints so that the training can be resumed exactly.
+
+   unsigned checkpoint_random_seed = 0;
+
+   /// Random generator of the shuffles of the batches when the checkpoints are enabled, which does not seed the global random numbers.
+
+   mt19937 epoch_random_generator;
+
+   /// Thread which writes the last checkpoint.
+
+   thread checkpoint_thread;
+
+   /// Names of the checkpoint files which have been written, from the oldest to the newest.
+
+   deque<string> checkpoints_files_names;
+
+   bool start_checkpoints(TrainingCheckpoint&, Results&);
+
+   bool is_checkpoint_epoch(const Index&) const;
+
+   mt19937* get_epoch_random_generator(const Index&);
+
+   void write_checkpoint(TrainingCheckpoint&, const Results&, const Index&, const type&);
+
+   void save_checkpoint(const TrainingCheckpoint&);
+
+   void write_checkpoints_XML(tinyxml2::XMLPrinter&) const;
+
+   void checkpoints_from_XML(const tinyxml2::XMLElement*);
+
+   // PROFILE
+
+   /// Profiler of the phases of the training, which is only used when OPENNN_PROFILE is defined.
+
+   TrainingProfiler profiler;
+
+   void start_profile();
+
+   void begin_epoch_profile(const Index&);
+
+   void finish_profile(Results&);
+
+   // OBSERVERS
+
+   /// Observers of the training metrics, which are not owned by the optimization algorithm.
+
+   vector<TrainingObserver*> observers;
+
+   /// Stop and pause signals of the training.
+
+   TrainingControl training_control;
+
+   /// Time at which the training began, and at which the last iteration and the last epoch ended.
+
+   chrono::steady_clock::time_point training_beginning_time;
+
+   chrono::steady_clock::time_point last_iteration_time;
+
+   chrono::steady_clock::time_point last_epoch_time;
+
+   /// Metrics of the last epoch, which are passed to the observers when the training ends.
+
+   TrainingObserver::Metrics last_epoch_metrics;
+
+   bool has_observers() const;
+
+   void begin_observers();
+
+   void notify_iteration(TrainingObserver::Metrics&);
+
+   void notify_epoch(TrainingObserver::Metrics&);
+
+   void end_observers(const Results&);
+
+   bool check_training_control() const;
+
    const Eigen::array<IndexPair<Index>, 1> AT_B = {IndexPair<Index>(0, 0)};
    const Eigen::array<IndexPair<Index>, 1> product_vector_matrix = {IndexPair<Index>(0, 1)}; // Normal product vector times matrix
    const Eigen::array<IndexPair<Index>, 1> A_B = {IndexPair<Index>(1, 0)};
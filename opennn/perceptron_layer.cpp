@@ -7,10 +7,48 @@
 //   artelnics@artelnics.com
 
 #include "perceptron_layer.h"
+#include "low_rank_perceptron_layer.h"
 
 namespace OpenNN
 {
 
+namespace
+{
+
+// The combinations of the forward propagation are calculated by a single product, and the biases and the activation function
+// are applied in tiles of neurons, so that the combinations of a tile stay in the L2 cache while the activations are written.
+
+const Index tile_size = 8192;
+
+const Index minimum_tile_neurons = 16;
+
+
+/// Adds the bias of each neuron to its column of combinations.
+
+void add_biases(const type* biases_data, TensorMap<Tensor<type, 2>>& combinations)
+{
+    const Index rows_number = combinations.dimension(0);
+    const Index columns_number = combinations.dimension(1);
+
+    type* combinations_data = combinations.data();
+
+    #pragma omp parallel for if(combinations.size() > tile_size)
+
+    for(Index j = 0; j < columns_number; j++)
+    {
+        const type bias = biases_data[j];
+
+        type* column_data = combinations_data + j*rows_number;
+
+        for(Index i = 0; i < rows_number; i++)
+        {
+            column_data[i] += bias;
+        }
+    }
+}
+
+}
+
 /// Default constructor.
 /// It creates a empty layer object, with no perceptrons.
 /// This constructor also initializes the rest of class members to their default values.
@@ -254,6 +292,55 @@ string PerceptronLayer::write_activation_function() const
 }
 
 
+/// Returns true if some synaptic weights of the layer are pruned, and false otherwise.
+
+bool PerceptronLayer::is_pruned() const
+{
+    return pruning_mask.size() != 0;
+}
+
+
+/// Returns the inputs_number x neurons_number matrix which is true for the synaptic weights which are kept.
+/// It is empty if the layer is not pruned.
+
+const Tensor<bool, 2>& PerceptronLayer::get_pruning_mask() const
+{
+    return pruning_mask;
+}
+
+
+/// Returns the number of consecutive inputs of a neuron which are pruned and stored together.
+
+const Index& PerceptronLayer::get_sparse_block_size() const
+{
+    return sparse_block_size;
+}
+
+
+/// Returns the number of synaptic weights which are pruned.
+
+Index PerceptronLayer::get_pruned_synaptic_weights_number() const
+{
+    if(!is_pruned()) return 0;
+
+    const Tensor<Index, 0> kept_synaptic_weights_number = pruning_mask.cast<Index>().sum();
+
+    return pruning_mask.size() - kept_synaptic_weights_number(0);
+}
+
+
+/// Returns the fraction of synaptic weights which are pruned.
+
+type PerceptronLayer::calculate_sparsity() const
+{
+    const Index synaptic_weights_number = get_synaptic_weights_number();
+
+    if(synaptic_weights_number == 0) return 0;
+
+    return static_cast<type>(get_pruned_synaptic_weights_number())/static_cast<type>(synaptic_weights_number);
+}
+
+
 /// Returns true if messages from this class are to be displayed on the screen,
 /// or false if messages from this class are not to be displayed on the screen.
 
@@ -272,6 +359,8 @@ void PerceptronLayer::set()
 
     synaptic_weights.resize(0, 0);
 
+    remove_pruning_mask();
+
     set_default();
 }
 
@@ -294,6 +383,8 @@ void PerceptronLayer::set(const Index& new_inputs_number, const Index& new_neuro
 
     activation_function = new_activation_function;
 
+    remove_pruning_mask();
+
     set_default();
 }
 
@@ -309,6 +400,12 @@ void PerceptronLayer::set(const PerceptronLayer& other_perceptron_layer)
 
     activation_function = other_perceptron_layer.activation_function;
 
+    pruning_mask = other_perceptron_layer.pruning_mask;
+
+    sparse_block_size = other_perceptron_layer.sparse_block_size;
+
+    set_sparse_synaptic_weights();
+
     display = other_perceptron_layer.display;
 
     set_default();
@@ -343,6 +440,8 @@ void PerceptronLayer::set_inputs_number(const Index& new_inputs_number)
     biases.resize(1,neurons_number);
 
     synaptic_weights.resize(new_inputs_number, neurons_number);
+
+    remove_pruning_mask();
 }
 
 
@@ -357,6 +456,148 @@ void PerceptronLayer::set_neurons_number(const Index& new_neurons_number)
     biases.resize(1, new_neurons_number);
 
     synaptic_weights.resize(inputs_number, new_neurons_number);
+
+    remove_pruning_mask();
+}
+
+
+/// Sets a new number of inputs keeping the synaptic weights of the inputs which remain.
+/// The synaptic weights of the new inputs are set to zero, so that the outputs do not change.
+/// @param inputs_indices Index of each new input among the previous inputs, or -1 for a new input.
+
+void PerceptronLayer::resize_inputs(const Tensor<Index, 1>& inputs_indices)
+{
+    const Index new_inputs_number = inputs_indices.size();
+
+    const Index inputs_number = get_inputs_number();
+    const Index neurons_number = get_neurons_number();
+
+    Tensor<type, 2> new_synaptic_weights(new_inputs_number, neurons_number);
+    new_synaptic_weights.setZero();
+
+    for(Index i = 0; i < new_inputs_number; i++)
+    {
+        if(inputs_indices(i) < 0 || inputs_indices(i) >= inputs_number) continue;
+
+        new_synaptic_weights.chip(i,0) = synaptic_weights.chip(inputs_indices(i),0);
+    }
+
+    synaptic_weights = new_synaptic_weights;
+
+    if(is_pruned())
+    {
+        Tensor<bool, 2> new_pruning_mask(new_inputs_number, neurons_number);
+        new_pruning_mask.setConstant(true);
+
+        for(Index i = 0; i < new_inputs_number; i++)
+        {
+            if(inputs_indices(i) < 0 || inputs_indices(i) >= inputs_number) continue;
+
+            new_pruning_mask.chip(i,0) = pruning_mask.chip(inputs_indices(i),0);
+        }
+
+        set_pruning_mask(new_pruning_mask);
+    }
+}
+
+
+/// Sets a new number of neurons keeping the biases and synaptic weights of the first ones.
+/// The new neurons have zero biases and small random synaptic weights, so that they can start learning.
+/// @param new_neurons_number Number of neurons.
+
+void PerceptronLayer::resize_neurons(const Index& new_neurons_number)
+{
+    const Index inputs_number = get_inputs_number();
+    const Index neurons_number = get_neurons_number();
+
+    const Index kept_neurons_number = min(neurons_number, new_neurons_number);
+
+    Tensor<type, 2> new_biases(1, new_neurons_number);
+    new_biases.setZero();
+
+    Tensor<type, 2> new_synaptic_weights(inputs_number, new_neurons_number);
+    new_synaptic_weights.setRandom<Eigen::internal::NormalRandomGenerator<type>>();
+    new_synaptic_weights = new_synaptic_weights*static_cast<type>(0.01);
+
+    for(Index j = 0; j < kept_neurons_number; j++)
+    {
+        new_biases(0,j) = biases(0,j);
+
+        new_synaptic_weights.chip(j,1) = synaptic_weights.chip(j,1);
+    }
+
+    biases = new_biases;
+    synaptic_weights = new_synaptic_weights;
+
+    if(is_pruned())
+    {
+        Tensor<bool, 2> new_pruning_mask(inputs_number, new_neurons_number);
+        new_pruning_mask.setConstant(true);
+
+        for(Index j = 0; j < kept_neurons_number; j++)
+        {
+            new_pruning_mask.chip(j,1) = pruning_mask.chip(j,1);
+        }
+
+        set_pruning_mask(new_pruning_mask);
+    }
+}
+
+
+/// Keeps only some neurons of the layer, with their biases and synaptic weights.
+/// This is used to remove the neurons pruned from a trained layer.
+/// @param neurons_indices Indices of the neurons which are kept, in their new order.
+
+void PerceptronLayer::select_neurons(const Tensor<Index, 1>& neurons_indices)
+{
+    const Index new_neurons_number = neurons_indices.size();
+
+    const Index inputs_number = get_inputs_number();
+
+#ifdef __OPENNN_DEBUG__
+
+    const Index neurons_number = get_neurons_number();
+
+    for(Index j = 0; j < new_neurons_number; j++)
+    {
+        if(neurons_indices(j) < 0 || neurons_indices(j) >= neurons_number)
+        {
+            ostringstream buffer;
+
+            buffer << "OpenNN Exception: PerceptronLayer class.\n"
+                   << "void select_neurons(const Tensor<Index, 1>&) method.\n"
+                   << "Neuron index (" << neurons_indices(j) << ") must be less than number of neurons (" << neurons_number << ").\n";
+
+            throw logic_error(buffer.str());
+        }
+    }
+
+#endif
+
+    Tensor<type, 2> new_biases(1, new_neurons_number);
+    Tensor<type, 2> new_synaptic_weights(inputs_number, new_neurons_number);
+
+    for(Index j = 0; j < new_neurons_number; j++)
+    {
+        new_biases(0,j) = biases(0,neurons_indices(j));
+
+        new_synaptic_weights.chip(j,1) = synaptic_weights.chip(neurons_indices(j),1);
+    }
+
+    biases = new_biases;
+    synaptic_weights = new_synaptic_weights;
+
+    if(is_pruned())
+    {
+        Tensor<bool, 2> new_pruning_mask(inputs_number, new_neurons_number);
+
+        for(Index j = 0; j < new_neurons_number; j++)
+        {
+            new_pruning_mask.chip(j,1) = pruning_mask.chip(neurons_indices(j),1);
+        }
+
+        set_pruning_mask(new_pruning_mask);
+    }
 }
 
 
@@ -378,6 +619,8 @@ void PerceptronLayer::set_biases(const Tensor<type, 2>& new_biases)
 void PerceptronLayer::set_synaptic_weights(const Tensor<type, 2>& new_synaptic_weights)
 {
     synaptic_weights = new_synaptic_weights;
+
+    apply_pruning_mask();
 }
 
 
@@ -410,6 +653,8 @@ void PerceptronLayer::set_parameters(const Tensor<type, 1>& new_parameters, cons
     memcpy(synaptic_weights.data(),
            new_parameters.data() + biases_number + index,
            static_cast<size_t>(synaptic_weights_number)*sizeof(type));
+
+    apply_pruning_mask();
 }
 
 
@@ -511,6 +756,8 @@ void PerceptronLayer::set_biases_constant(const type& value)
 void PerceptronLayer::set_synaptic_weights_constant(const type& value)
 {
     synaptic_weights.setConstant(value);
+
+    apply_pruning_mask();
 }
 
 
@@ -540,6 +787,8 @@ void PerceptronLayer::set_synaptic_weights_constant_glorot_uniform()
 
     synaptic_weights = (synaptic_weights - synaptic_weights.constant(min_weight(0))) / (synaptic_weights.constant(max_weight(0))- synaptic_weights.constant(min_weight(0)));
     synaptic_weights = (synaptic_weights * synaptic_weights.constant(2. * limit)) - synaptic_weights.constant(limit);
+
+    apply_pruning_mask();
 }
 
 
@@ -553,6 +802,7 @@ void PerceptronLayer::set_parameters_constant(const type& value)
 
     synaptic_weights.setConstant(value);
 
+    apply_pruning_mask();
 }
 
 
@@ -564,6 +814,244 @@ void PerceptronLayer::set_parameters_random()
     biases.setRandom<Eigen::internal::NormalRandomGenerator<type>>();
     synaptic_weights.setRandom<Eigen::internal::NormalRandomGenerator<type>>();
 
+    apply_pruning_mask();
+}
+
+
+/// Prunes some synaptic weights of the layer, which are set to zero and kept at zero when the parameters change.
+/// The outputs of the layer are then calculated with the synaptic weights which are kept in a blocked sparse format.
+/// @param new_pruning_mask Inputs_number x neurons_number matrix which is true for the synaptic weights which are kept.
+
+void PerceptronLayer::set_pruning_mask(const Tensor<bool, 2>& new_pruning_mask)
+{
+#ifdef __OPENNN_DEBUG__
+
+    if(new_pruning_mask.dimension(0) != get_inputs_number() || new_pruning_mask.dimension(1) != get_neurons_number())
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: PerceptronLayer class.\n"
+               << "void set_pruning_mask(const Tensor<bool, 2>&) method.\n"
+               << "Dimensions of pruning mask (" << new_pruning_mask.dimension(0) << "," << new_pruning_mask.dimension(1)
+               << ") must be equal to dimensions of synaptic weights (" << get_inputs_number() << "," << get_neurons_number() << ").\n";
+
+        throw logic_error(buffer.str());
+    }
+
+#endif
+
+    pruning_mask = new_pruning_mask;
+
+    apply_pruning_mask();
+}
+
+
+/// Sets the number of consecutive inputs of a neuron which are pruned and stored together.
+/// Larger blocks make the sparse outputs faster, and smaller blocks prune the synaptic weights more selectively.
+/// @param new_sparse_block_size Number of inputs in each block.
+
+void PerceptronLayer::set_sparse_block_size(const Index& new_sparse_block_size)
+{
+#ifdef __OPENNN_DEBUG__
+
+    if(new_sparse_block_size < 1)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: PerceptronLayer class.\n"
+               << "void set_sparse_block_size(const Index&) method.\n"
+               << "Sparse block size (" << new_sparse_block_size << ") must be greater than 0.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+#endif
+
+    sparse_block_size = new_sparse_block_size;
+
+    set_sparse_synaptic_weights();
+}
+
+
+/// Removes the pruning of the layer, so that all the synaptic weights can change again.
+/// The synaptic weights which were pruned remain zero until the parameters are set.
+
+void PerceptronLayer::remove_pruning_mask()
+{
+    pruning_mask.resize(0, 0);
+
+    set_sparse_synaptic_weights();
+}
+
+
+/// Prunes the blocks of synaptic weights with the smallest magnitude.
+/// The blocks are sparse_block_size consecutive inputs of a neuron, and their magnitude is the sum of the squared weights.
+/// The blocks which were already pruned have zero magnitude, so that the pruning can be done in several steps.
+/// @param sparsity Fraction of blocks of synaptic weights which are pruned, between 0 and 1.
+
+void PerceptronLayer::prune_synaptic_weights(const type& sparsity)
+{
+#ifdef __OPENNN_DEBUG__
+
+    if(sparsity < 0 || sparsity > 1)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: PerceptronLayer class.\n"
+               << "void prune_synaptic_weights(const type&) method.\n"
+               << "Sparsity (" << sparsity << ") must be between 0 and 1.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+#endif
+
+    const Index inputs_number = get_inputs_number();
+    const Index neurons_number = get_neurons_number();
+
+    const Index neuron_blocks_number = (inputs_number + sparse_block_size - 1)/sparse_block_size;
+    const Index blocks_number = neuron_blocks_number*neurons_number;
+
+    const Index pruned_blocks_number = static_cast<Index>(round(sparsity*static_cast<type>(blocks_number)));
+
+    Tensor<type, 1> blocks_magnitudes(blocks_number);
+    blocks_magnitudes.setZero();
+
+    for(Index j = 0; j < neurons_number; j++)
+    {
+        for(Index i = 0; i < inputs_number; i++)
+        {
+            blocks_magnitudes(j*neuron_blocks_number + i/sparse_block_size) += synaptic_weights(i,j)*synaptic_weights(i,j);
+        }
+    }
+
+    vector<Index> blocks_indices(static_cast<size_t>(blocks_number));
+
+    iota(blocks_indices.begin(), blocks_indices.end(), 0);
+
+    nth_element(blocks_indices.begin(), blocks_indices.begin() + pruned_blocks_number, blocks_indices.end(),
+                [&](const Index& a, const Index& b){return blocks_magnitudes(a) < blocks_magnitudes(b);});
+
+    Tensor<bool, 2> new_pruning_mask(inputs_number, neurons_number);
+    new_pruning_mask.setConstant(true);
+
+    for(Index k = 0; k < pruned_blocks_number; k++)
+    {
+        const Index neuron_index = blocks_indices[static_cast<size_t>(k)]/neuron_blocks_number;
+        const Index first_input_index = (blocks_indices[static_cast<size_t>(k)]%neuron_blocks_number)*sparse_block_size;
+
+        for(Index i = first_input_index; i < min(first_input_index + sparse_block_size, inputs_number); i++)
+        {
+            new_pruning_mask(i, neuron_index) = false;
+        }
+    }
+
+    set_pruning_mask(new_pruning_mask);
+}
+
+
+/// Sets to zero the synaptic weights which are pruned, and updates the sparse synaptic weights.
+
+void PerceptronLayer::apply_pruning_mask()
+{
+    if(!is_pruned()) return;
+
+    mask_synaptic_weights(synaptic_weights.data());
+
+    set_sparse_synaptic_weights();
+}
+
+
+/// Sets to zero the pruned entries of a vector laid out as the synaptic weights of this layer,
+/// such as the synaptic weights part of a parameters vector or of a training direction.
+/// It does nothing if the layer is not pruned.
+/// @param synaptic_weights_data Pointer to the first synaptic weight.
+
+void PerceptronLayer::mask_synaptic_weights(type* synaptic_weights_data) const
+{
+    if(!is_pruned()) return;
+
+    const Index synaptic_weights_number = pruning_mask.size();
+
+    const bool* pruning_mask_data = pruning_mask.data();
+
+    for(Index i = 0; i < synaptic_weights_number; i++)
+    {
+        if(!pruning_mask_data[i]) synaptic_weights_data[i] = 0;
+    }
+}
+
+
+/// Stores the blocks of synaptic weights with some weight which is not pruned, neuron by neuron.
+/// The last block of each neuron is padded with zeros.
+
+void PerceptronLayer::set_sparse_synaptic_weights()
+{
+    if(!is_pruned())
+    {
+        sparse_neurons_blocks.resize(0);
+        sparse_blocks_inputs.resize(0);
+        sparse_synaptic_weights.resize(0);
+
+        return;
+    }
+
+    const Index inputs_number = get_inputs_number();
+    const Index neurons_number = get_neurons_number();
+
+    Index blocks_number = 0;
+
+    for(Index j = 0; j < neurons_number; j++)
+    {
+        for(Index first_input_index = 0; first_input_index < inputs_number; first_input_index += sparse_block_size)
+        {
+            for(Index i = first_input_index; i < min(first_input_index + sparse_block_size, inputs_number); i++)
+            {
+                if(pruning_mask(i,j))
+                {
+                    blocks_number++;
+                    break;
+                }
+            }
+        }
+    }
+
+    sparse_neurons_blocks.resize(neurons_number + 1);
+    sparse_blocks_inputs.resize(blocks_number);
+    sparse_synaptic_weights.resize(blocks_number*sparse_block_size);
+    sparse_synaptic_weights.setZero();
+
+    Index block_index = 0;
+
+    for(Index j = 0; j < neurons_number; j++)
+    {
+        sparse_neurons_blocks(j) = block_index;
+
+        for(Index first_input_index = 0; first_input_index < inputs_number; first_input_index += sparse_block_size)
+        {
+            const Index last_input_index = min(first_input_index + sparse_block_size, inputs_number);
+
+            bool kept_block = false;
+
+            for(Index i = first_input_index; i < last_input_index; i++)
+            {
+                if(pruning_mask(i,j)) kept_block = true;
+            }
+
+            if(!kept_block) continue;
+
+            sparse_blocks_inputs(block_index) = first_input_index;
+
+            for(Index i = first_input_index; i < last_input_index; i++)
+            {
+                sparse_synaptic_weights(block_index*sparse_block_size + i - first_input_index) = synaptic_weights(i,j);
+            }
+
+            block_index++;
+        }
+    }
+
+    sparse_neurons_blocks(neurons_number) = block_index;
 }
 
 
@@ -572,15 +1060,95 @@ void PerceptronLayer::calculate_combinations(const Tensor<type, 2>& inputs,
                             const Tensor<type, 2>& synaptic_weights,
                             Tensor<type, 2>& combinations_2d) const
 {
-    const Index batch_instances_number = inputs.dimension(0);
-    const Index biases_number = get_biases_number();
+    combinations_2d.device(*thread_pool_device) = inputs.contract(synaptic_weights, A_B);
+
+    TensorMap<Tensor<type, 2>> combinations(combinations_2d.data(), combinations_2d.dimension(0), combinations_2d.dimension(1));
+
+    add_biases(biases.data(), combinations);
+}
+
+
+/// Calculates the combinations of a pruned layer with the blocks of synaptic weights which are kept,
+/// so that the work of the pruned synaptic weights is skipped.
+/// Small batches accumulate each combination in turn, and larger batches are processed in tiles of instances
+/// which add each input column scaled by the weight to the combinations column.
+/// @param inputs Batch_size x inputs_number matrix.
+/// @param combinations_2d Batch_size x neurons_number matrix.
 
-    for(Index i = 0; i < biases_number; i++)
+void PerceptronLayer::calculate_sparse_combinations(const Tensor<type, 2>& inputs, Tensor<type, 2>& combinations_2d) const
+{
+    const Index batch_size = inputs.dimension(0);
+
+    const Index inputs_number = get_inputs_number();
+    const Index neurons_number = get_neurons_number();
+
+    const Index tile_size = 256;
+
+    const type* inputs_data = inputs.data();
+    const type* sparse_synaptic_weights_data = sparse_synaptic_weights.data();
+
+    #pragma omp parallel for
+    for(Index j = 0; j < neurons_number; j++)
     {
-        fill_n(combinations_2d.data() + i*batch_instances_number, batch_instances_number, biases(i));
-    }
+        type* combinations_column = combinations_2d.data() + j*batch_size;
+
+        const Index first_block_index = sparse_neurons_blocks(j);
+        const Index last_block_index = sparse_neurons_blocks(j+1);
+
+        if(batch_size < 8)
+        {
+            for(Index k = 0; k < batch_size; k++)
+            {
+                type combination = biases(0,j);
+
+                for(Index block_index = first_block_index; block_index < last_block_index; block_index++)
+                {
+                    const Index first_input_index = sparse_blocks_inputs(block_index);
+                    const Index block_inputs_number = min(sparse_block_size, inputs_number - first_input_index);
+
+                    const type* block_synaptic_weights = sparse_synaptic_weights_data + block_index*sparse_block_size;
+
+                    for(Index i = 0; i < block_inputs_number; i++)
+                    {
+                        combination += block_synaptic_weights[i]*inputs_data[(first_input_index + i)*batch_size + k];
+                    }
+                }
+
+                combinations_column[k] = combination;
+            }
 
-    combinations_2d.device(*thread_pool_device) += inputs.contract(synaptic_weights, A_B);
+            continue;
+        }
+
+        for(Index first_instance_index = 0; first_instance_index < batch_size; first_instance_index += tile_size)
+        {
+            const Index tile_instances_number = min(tile_size, batch_size - first_instance_index);
+
+            type* combinations_tile = combinations_column + first_instance_index;
+
+            fill(combinations_tile, combinations_tile + tile_instances_number, biases(0,j));
+
+            for(Index block_index = first_block_index; block_index < last_block_index; block_index++)
+            {
+                const Index first_input_index = sparse_blocks_inputs(block_index);
+                const Index block_inputs_number = min(sparse_block_size, inputs_number - first_input_index);
+
+                const type* block_synaptic_weights = sparse_synaptic_weights_data + block_index*sparse_block_size;
+
+                for(Index i = 0; i < block_inputs_number; i++)
+                {
+                    const type synaptic_weight = block_synaptic_weights[i];
+
+                    const type* inputs_tile = inputs_data + (first_input_index + i)*batch_size + first_instance_index;
+
+                    for(Index k = 0; k < tile_instances_number; k++)
+                    {
+                        combinations_tile[k] += synaptic_weight*inputs_tile[k];
+                    }
+                }
+            }
+        }
+    }
 }
 
 
@@ -656,6 +1224,25 @@ void PerceptronLayer::calculate_activations_derivatives(const Tensor<type, 2>& c
 
      #endif
 
+     const TensorMap<Tensor<type, 2>> combinations_map(const_cast<type*>(combinations_2d.data()),
+                                                       combinations_2d.dimension(0), combinations_2d.dimension(1));
+
+     TensorMap<Tensor<type, 2>> activations_map(activations.data(), activations.dimension(0), activations.dimension(1));
+
+     TensorMap<Tensor<type, 2>> activations_derivatives_map(activations_derivatives.data(),
+                                                            activations_derivatives.dimension(0), activations_derivatives.dimension(1));
+
+     calculate_tile_activations_derivatives(combinations_map, activations_map, activations_derivatives_map);
+}
+
+
+/// Calculates the activations and activations derivatives of a tile of combinations,
+/// which can have fewer columns than neurons in the layer.
+
+void PerceptronLayer::calculate_tile_activations_derivatives(const TensorMap<Tensor<type, 2>>& combinations_2d,
+                                                             TensorMap<Tensor<type, 2>>& activations,
+                                                             TensorMap<Tensor<type, 2>>& activations_derivatives) const
+{
      switch(activation_function)
      {
          case Linear: linear_derivatives(combinations_2d, activations, activations_derivatives); return;
@@ -722,7 +1309,14 @@ Tensor<type, 2> PerceptronLayer::calculate_outputs(const Tensor<type, 2>& inputs
 
     Tensor<type, 2> outputs(batch_size, outputs_number);
 
-    calculate_combinations(inputs, biases, synaptic_weights, outputs);
+    if(is_pruned())
+    {
+        calculate_sparse_combinations(inputs, outputs);
+    }
+    else
+    {
+        calculate_combinations(inputs, biases, synaptic_weights, outputs);
+    }
 
     calculate_activations(outputs, outputs);
 
@@ -733,16 +1327,64 @@ Tensor<type, 2> PerceptronLayer::calculate_outputs(const Tensor<type, 2>& inputs
 void PerceptronLayer::forward_propagate(const Tensor<type, 2>& inputs,
                                    ForwardPropagation& forward_propagation) const
  {
-#ifdef __OPENNN_DEBUG__
+    const TensorMap<Tensor<type, 2>> biases_map(const_cast<type*>(biases.data()), biases.dimension(0), biases.dimension(1));
+
+    const TensorMap<Tensor<type, 2>> synaptic_weights_map(const_cast<type*>(synaptic_weights.data()),
+                                                          synaptic_weights.dimension(0), synaptic_weights.dimension(1));
+
+    forward_propagate(inputs, biases_map, synaptic_weights_map, forward_propagation);
+}
+
+
+/// Calculates the forward propagation of the layer with the given parameters.
+/// The biases and synaptic weights are views of the parameters, so nothing is copied.
+/// @param inputs Inputs to the layer.
+/// @param potential_parameters Parameters of the layer, in the same order as get_parameters().
+/// @param forward_propagation Structure where the combinations, activations and activations derivatives are saved.
 
+void PerceptronLayer::forward_propagate(const Tensor<type, 2>& inputs,
+                                   const TensorMap<Tensor<type, 1>>& potential_parameters,
+                                   ForwardPropagation& forward_propagation) const
+   {
+    const Index neurons_number = get_neurons_number();
     const Index inputs_number = get_inputs_number();
 
+    const TensorMap<Tensor<type, 2>> potential_biases(potential_parameters.data(), neurons_number, 1);
+
+    const TensorMap<Tensor<type, 2>> potential_synaptic_weights(potential_parameters.data()+neurons_number,
+                                                                inputs_number, neurons_number);
+
+    forward_propagate(inputs, potential_biases, potential_synaptic_weights, forward_propagation);
+}
+
+
+/// Calculates the combinations, activations and activations derivatives of the layer, written in place in the forward propagation.
+/// The product of the inputs and the synaptic weights is calculated at once, since splitting it into narrow products
+/// reads the inputs again for each of them. Then the biases and the activation function are applied in tiles of neurons,
+/// while the combinations of each tile are still in cache.
+/// @param inputs Inputs to the layer.
+/// @param biases View of the biases of the layer.
+/// @param synaptic_weights View of the synaptic weights of the layer.
+/// @param forward_propagation Structure where the combinations, activations and activations derivatives are saved.
+
+void PerceptronLayer::forward_propagate(const Tensor<type, 2>& inputs,
+                                   const TensorMap<Tensor<type, 2>>& biases,
+                                   const TensorMap<Tensor<type, 2>>& synaptic_weights,
+                                   ForwardPropagation& forward_propagation) const
+{
+    const Index batch_instances_number = inputs.dimension(0);
+    const Index neurons_number = synaptic_weights.dimension(1);
+
+#ifdef __OPENNN_DEBUG__
+
+    const Index inputs_number = synaptic_weights.dimension(0);
+
     if(inputs_number != inputs.dimension(1))
     {
         ostringstream buffer;
 
         buffer << "OpenNN Exception: PerceptronLayer class.\n"
-               << "void forward_propagate(const Tensor<type, 2>&, ForwardPropagation&) method.\n"
+               << "void forward_propagate(const Tensor<type, 2>&, const TensorMap<Tensor<type, 2>>&, const TensorMap<Tensor<type, 2>>&, ForwardPropagation&) method.\n"
                << "Number of inputs columns (" << inputs.dimension(1) << ") must be equal to number of inputs ("
                << inputs_number << ").\n";
 
@@ -751,33 +1393,99 @@ void PerceptronLayer::forward_propagate(const Tensor<type, 2>& inputs,
 
 #endif
 
-    calculate_combinations(inputs,
-                           biases,
-                           synaptic_weights,
-                           forward_propagation.combinations_2d);
+    type* combinations_data = forward_propagation.combinations_2d.data();
+    type* activations_data = forward_propagation.activations_2d.data();
+    type* activations_derivatives_data = forward_propagation.activations_derivatives_2d.data();
+
+    TensorMap<Tensor<type, 2>> combinations(combinations_data, batch_instances_number, neurons_number);
+
+    combinations.device(*thread_pool_device) = inputs.contract(synaptic_weights, A_B);
 
-    calculate_activations_derivatives(forward_propagation.combinations_2d,
-                                      forward_propagation.activations_2d,
-                                      forward_propagation.activations_derivatives_2d);
+    const Index tile_neurons_number
+            = min(neurons_number, max(minimum_tile_neurons, tile_size/max(batch_instances_number, static_cast<Index>(1))));
+
+    for(Index first_neuron = 0; first_neuron < neurons_number; first_neuron += tile_neurons_number)
+    {
+        const Index tile_columns_number = min(tile_neurons_number, neurons_number - first_neuron);
+
+        // Columns of the outputs are contiguous
+
+        const Index offset = first_neuron*batch_instances_number;
+
+        TensorMap<Tensor<type, 2>> tile_combinations(combinations_data + offset, batch_instances_number, tile_columns_number);
+        TensorMap<Tensor<type, 2>> tile_activations(activations_data + offset, batch_instances_number, tile_columns_number);
+        TensorMap<Tensor<type, 2>> tile_activations_derivatives(activations_derivatives_data + offset,
+                                                                batch_instances_number, tile_columns_number);
+
+        add_biases(biases.data() + first_neuron, tile_combinations);
+
+        calculate_tile_activations_derivatives(tile_combinations, tile_activations, tile_activations_derivatives);
+    }
 }
 
 
-void PerceptronLayer::forward_propagate(const Tensor<type, 2>& inputs,
-                                   Tensor<type, 1> potential_parameters,
-                                   ForwardPropagation& forward_propagation) const
-   {
+/// Calculates the forward propagation of a batch of sparse inputs with the current parameters.
+/// @param inputs Inputs to the layer, in compressed sparse row format.
+/// @param forward_propagation Structure where the combinations, activations and activations derivatives are saved.
+
+void PerceptronLayer::forward_propagate(const CsrMatrix& inputs,
+                                        ForwardPropagation& forward_propagation) const
+{
+    const TensorMap<Tensor<type, 2>> biases_map(const_cast<type*>(biases.data()), biases.dimension(0), biases.dimension(1));
+
+    const TensorMap<Tensor<type, 2>> synaptic_weights_map(const_cast<type*>(synaptic_weights.data()),
+                                                          synaptic_weights.dimension(0), synaptic_weights.dimension(1));
+
+    forward_propagate(inputs, biases_map, synaptic_weights_map, forward_propagation);
+}
+
+
+/// Calculates the forward propagation of a batch of sparse inputs with the given parameters.
+/// @param inputs Inputs to the layer, in compressed sparse row format.
+/// @param potential_parameters Parameters of the layer, in the same order as get_parameters().
+/// @param forward_propagation Structure where the combinations, activations and activations derivatives are saved.
+
+void PerceptronLayer::forward_propagate(const CsrMatrix& inputs,
+                                        const TensorMap<Tensor<type, 1>>& potential_parameters,
+                                        ForwardPropagation& forward_propagation) const
+{
     const Index neurons_number = get_neurons_number();
     const Index inputs_number = get_inputs_number();
 
+    const TensorMap<Tensor<type, 2>> potential_biases(potential_parameters.data(), neurons_number, 1);
+
+    const TensorMap<Tensor<type, 2>> potential_synaptic_weights(potential_parameters.data()+neurons_number,
+                                                                inputs_number, neurons_number);
+
+    forward_propagate(inputs, potential_biases, potential_synaptic_weights, forward_propagation);
+}
+
+
+/// Calculates the forward propagation of a batch of sparse inputs.
+/// The combinations are calculated with a sparse times dense product, which only visits the nonzero inputs.
+/// @param inputs Inputs to the layer, in compressed sparse row format.
+/// @param biases View of the biases of the layer.
+/// @param synaptic_weights View of the synaptic weights of the layer.
+/// @param forward_propagation Structure where the combinations, activations and activations derivatives are saved.
+
+void PerceptronLayer::forward_propagate(const CsrMatrix& inputs,
+                                        const TensorMap<Tensor<type, 2>>& biases,
+                                        const TensorMap<Tensor<type, 2>>& synaptic_weights,
+                                        ForwardPropagation& forward_propagation) const
+{
+    const Index batch_instances_number = inputs.rows();
+    const Index inputs_number = synaptic_weights.dimension(0);
+    const Index neurons_number = synaptic_weights.dimension(1);
+
 #ifdef __OPENNN_DEBUG__
 
-    if(inputs_number != inputs.dimension(1))
+    if(inputs_number != inputs.cols())
     {
         ostringstream buffer;
 
         buffer << "OpenNN Exception: PerceptronLayer class.\n"
-               << "void forward_propagate(const Tensor<type, 2>&, Tensor<type, 1>&, ForwardPropagation&) method.\n"
-               << "Number of inputs columns (" << inputs.dimension(1) << ") must be equal to number of inputs ("
+               << "void forward_propagate(const CsrMatrix&, const TensorMap<Tensor<type, 2>>&, const TensorMap<Tensor<type, 2>>&, ForwardPropagation&) method.\n"
+               << "Number of inputs columns (" << inputs.cols() << ") must be equal to number of inputs ("
                << inputs_number << ").\n";
 
         throw logic_error(buffer.str());
@@ -785,19 +1493,22 @@ void PerceptronLayer::forward_propagate(const Tensor<type, 2>& inputs,
 
 #endif
 
-    const TensorMap<Tensor<type, 2>> potential_biases(potential_parameters.data(), neurons_number, 1);
+    const Eigen::Map<const Eigen::Matrix<type, Eigen::Dynamic, Eigen::Dynamic>>
+            synaptic_weights_matrix(synaptic_weights.data(), inputs_number, neurons_number);
 
-    const TensorMap<Tensor<type, 2>> potential_synaptic_weights(potential_parameters.data()+neurons_number,
-                                                                inputs_number, neurons_number);
+    Eigen::Map<Eigen::Matrix<type, Eigen::Dynamic, Eigen::Dynamic>>
+            combinations_matrix(forward_propagation.combinations_2d.data(), batch_instances_number, neurons_number);
+
+    combinations_matrix.noalias() = inputs*synaptic_weights_matrix;
 
-    calculate_combinations(inputs,
-                           potential_biases,
-                           potential_synaptic_weights,
-                           forward_propagation.combinations_2d);
+    TensorMap<Tensor<type, 2>> combinations(forward_propagation.combinations_2d.data(), batch_instances_number, neurons_number);
+    TensorMap<Tensor<type, 2>> activations(forward_propagation.activations_2d.data(), batch_instances_number, neurons_number);
+    TensorMap<Tensor<type, 2>> activations_derivatives(forward_propagation.activations_derivatives_2d.data(),
+                                                       batch_instances_number, neurons_number);
 
-    calculate_activations_derivatives(forward_propagation.combinations_2d,
-                                      forward_propagation.activations_2d,
-                                      forward_propagation.activations_derivatives_2d);
+    add_biases(biases.data(), combinations);
+
+    calculate_tile_activations_derivatives(combinations, activations, activations_derivatives);
 }
 
 
@@ -833,6 +1544,12 @@ void PerceptronLayer::calculate_hidden_delta(Layer* next_layer_pointer,
 
          return;
 
+         case LowRankPerceptron:
+
+         calculate_hidden_delta_low_rank_perceptron(next_layer_pointer, forward_propagation.activations_derivatives_2d, next_layer_delta, hidden_delta);
+
+         return;
+
          default:
 
          return;
@@ -869,6 +1586,29 @@ void PerceptronLayer::calculate_hidden_delta_probabilistic(Layer* next_layer_poi
 }
 
 
+/// Calculates the hidden delta when the next layer has low rank synaptic weights.
+/// The next layer delta is multiplied by the transposes of both factors, so the full weights are never formed.
+
+void PerceptronLayer::calculate_hidden_delta_low_rank_perceptron(Layer* next_layer_pointer,
+                                                                 const Tensor<type, 2>& activations_derivatives,
+                                                                 const Tensor<type, 2>& next_layer_delta,
+                                                                 Tensor<type, 2>& hidden_delta) const
+{
+    const LowRankPerceptronLayer* next_low_rank_perceptron_layer = dynamic_cast<LowRankPerceptronLayer*>(next_layer_pointer);
+
+    const Tensor<type, 2>& next_input_factors = next_low_rank_perceptron_layer->get_input_factors();
+    const Tensor<type, 2>& next_output_factors = next_low_rank_perceptron_layer->get_output_factors();
+
+    Tensor<type, 2> next_projections_delta(next_layer_delta.dimension(0), next_output_factors.dimension(0));
+
+    next_projections_delta.device(*thread_pool_device) = next_layer_delta.contract(next_output_factors, A_BT);
+
+    hidden_delta.device(*thread_pool_device) = next_projections_delta.contract(next_input_factors, A_BT);
+
+    hidden_delta.device(*thread_pool_device) = hidden_delta*activations_derivatives;
+}
+
+
 // Gradient methods
 
 void PerceptronLayer::calculate_error_gradient(const Tensor<type, 2>& inputs,
@@ -883,6 +1623,31 @@ void PerceptronLayer::calculate_error_gradient(const Tensor<type, 2>& inputs,
 
 }
 
+
+/// Calculates the error gradient of the layer for a batch of sparse inputs.
+/// The synaptic weights derivatives are a sum of outer products of the nonzero inputs and the deltas,
+/// so only the rows of the inputs which are not zero are visited.
+
+void PerceptronLayer::calculate_error_gradient(const CsrMatrix& inputs,
+                                               const Layer::ForwardPropagation&,
+                                               Layer::BackPropagation& back_propagation) const
+{
+    const Index batch_instances_number = inputs.rows();
+    const Index inputs_number = get_inputs_number();
+    const Index neurons_number = get_neurons_number();
+
+    back_propagation.biases_derivatives.device(*thread_pool_device)
+            = back_propagation.delta.sum(Eigen::array<Index, 1>({0}));
+
+    const Eigen::Map<const Eigen::Matrix<type, Eigen::Dynamic, Eigen::Dynamic>>
+            delta_matrix(back_propagation.delta.data(), batch_instances_number, neurons_number);
+
+    Eigen::Map<Eigen::Matrix<type, Eigen::Dynamic, Eigen::Dynamic>>
+            synaptic_weights_derivatives_matrix(back_propagation.synaptic_weights_derivatives.data(), inputs_number, neurons_number);
+
+    synaptic_weights_derivatives_matrix.noalias() = inputs.transpose()*delta_matrix;
+}
+
 ///
 
 void PerceptronLayer::insert_gradient(const BackPropagation& back_propagation, const Index& index, Tensor<type, 1>& gradient) const
@@ -897,6 +1662,18 @@ void PerceptronLayer::insert_gradient(const BackPropagation& back_propagation, c
     memcpy(gradient.data() + index + biases_number,
            back_propagation.synaptic_weights_derivatives.data(),
            static_cast<size_t>(synaptic_weights_number)*sizeof(type));
+
+    // The pruned synaptic weights do not change
+
+    if(is_pruned())
+    {
+        const bool* pruning_mask_data = pruning_mask.data();
+
+        for(Index i = 0; i < synaptic_weights_number; i++)
+        {
+            if(!pruning_mask_data[i]) gradient(index + biases_number + i) = 0;
+        }
+    }
 }
 
 
@@ -1113,6 +1890,21 @@ void PerceptronLayer::from_XML(const tinyxml2::XMLDocument& document)
 
         set_parameters(to_type_vector(parameters_string, ' '));
     }
+
+    // Sparse block size
+
+    const tinyxml2::XMLElement* sparse_block_size_element = perceptron_layer_element->FirstChildElement("SparseBlockSize");
+
+    if(sparse_block_size_element && sparse_block_size_element->GetText())
+    {
+        // The pruned synaptic weights are saved as zeros
+
+        sparse_block_size = static_cast<Index>(stoi(sparse_block_size_element->GetText()));
+
+        const Tensor<bool, 2> new_pruning_mask(synaptic_weights != synaptic_weights.constant(0));
+
+        set_pruning_mask(new_pruning_mask);
+    }
 }
 
 
@@ -1174,6 +1966,20 @@ void PerceptronLayer::write_XML(tinyxml2::XMLPrinter& file_stream) const
 
     file_stream.CloseElement();
 
+    // Sparse block size
+
+    if(is_pruned())
+    {
+        file_stream.OpenElement("SparseBlockSize");
+
+        buffer.str("");
+        buffer << sparse_block_size;
+
+        file_stream.PushText(buffer.str().c_str());
+
+        file_stream.CloseElement();
+    }
+
     // Peceptron layer (end tag)
 
     file_stream.CloseElement();
@@ -1422,6 +2228,108 @@ string PerceptronLayer::write_expression_c() const
 }
 
 
+/// Returns the C function of the layer for a batch of inputs, which are stored by rows.
+/// The synaptic weights are written as a static array with the weights of each input stored contiguously,
+/// and the combinations are calculated by the calculate_combinations kernel written by the neural network.
+/// The function writes the outputs in a buffer given by the caller, so that it does not allocate memory.
+
+string PerceptronLayer::write_batch_expression_c() const
+{
+    const Index inputs_number = get_inputs_number();
+    const Index neurons_number = get_neurons_number();
+
+    ostringstream buffer;
+
+    buffer << write_array_c(layer_name + "_biases", biases.data(), neurons_number);
+
+    const Eigen::array<Index, 2> shuffle_dimensions = {1, 0};
+
+    const Tensor<type, 2> synaptic_weights_transpose = synaptic_weights.shuffle(shuffle_dimensions);
+
+    buffer << write_array_c(layer_name + "_synaptic_weights", synaptic_weights_transpose.data(), inputs_number*neurons_number);
+
+    buffer << "static void " << layer_name << "(const float* inputs, float* outputs, int batch_size)\n{" << endl;
+
+    buffer << "\tcalculate_combinations(inputs, batch_size, " << inputs_number << ", " << neurons_number << ", "
+           << layer_name << "_biases, " << layer_name << "_synaptic_weights, outputs);" << endl;
+
+    buffer << write_batch_activations_c();
+
+    buffer << "}\n" << endl;
+
+    return buffer.str();
+}
+
+
+/// Returns the C loop which applies the activation function to the combinations of a batch, stored in the outputs buffer.
+
+string PerceptronLayer::write_batch_activations_c() const
+{
+    if(activation_function == Linear) return string();
+
+    const Index neurons_number = get_neurons_number();
+
+    ostringstream buffer;
+
+    buffer << "\n\tfor(int i = 0; i < batch_size*" << neurons_number << "; i++)\n\t{" << endl;
+
+    buffer << "\t\tconst float x = outputs[i];\n" << endl;
+
+    buffer << "\t\toutputs[i] = ";
+
+    switch(activation_function)
+    {
+    case HyperbolicTangent:
+        buffer << "tanhf(x);";
+        break;
+
+    case RectifiedLinear:
+        buffer << "x < 0.0f ? 0.0f : x;";
+        break;
+
+    case Logistic:
+        buffer << "1.0f/(1.0f + expf(-x));";
+        break;
+
+    case Threshold:
+        buffer << "x >= 0.0f ? 1.0f : 0.0f;";
+        break;
+
+    case SymmetricThreshold:
+        buffer << "x > 0.0f ? 1.0f : -1.0f;";
+        break;
+
+    case Linear:
+        buffer << "x;";
+        break;
+
+    case ScaledExponentialLinear:
+        buffer << "x < 0.0f ? 1.0507f*1.67326f*(expf(x) - 1.0f) : 1.0507f*x;";
+        break;
+
+    case SoftPlus:
+        buffer << "logf(1.0f + expf(x));";
+        break;
+
+    case SoftSign:
+        buffer << "x < 0.0f ? x/(1.0f - x) : x/(1.0f + x);";
+        break;
+
+    case ExponentialLinear:
+        buffer << "x < 0.0f ? expf(x) - 1.0f : x;";
+        break;
+
+    case HardSigmoid:
+        buffer << "x < -2.5f ? 0.0f : (x > 2.5f ? 1.0f : 0.2f*x + 0.5f);";
+        break;
+    }
+
+    buffer << "\n\t}" << endl;
+
+    return buffer.str();
+}
+
+
 string PerceptronLayer::write_expression_python() const
 {
     ostringstream buffer;
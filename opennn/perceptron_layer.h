@@ -11,12 +11,15 @@
 
 // System includes
 
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <numeric>
 #include <string>
 #include <sstream>
+#include <vector>
 
 // OpenNN includes
 
@@ -87,6 +90,18 @@ public:
 
    string write_activation_function() const;
 
+   // Pruning
+
+   bool is_pruned() const;
+
+   const Tensor<bool, 2>& get_pruning_mask() const;
+
+   const Index& get_sparse_block_size() const;
+
+   Index get_pruned_synaptic_weights_number() const;
+
+   type calculate_sparsity() const;
+
    // Display messages
 
    const bool& get_display() const;
@@ -104,6 +119,11 @@ public:
    void set_inputs_number(const Index&);
    void set_neurons_number(const Index&);
 
+   void resize_inputs(const Tensor<Index, 1>&);
+   void resize_neurons(const Index&);
+
+   void select_neurons(const Tensor<Index, 1>&);
+
    // Parameters
 
    void set_biases(const Tensor<type, 2>&);
@@ -129,6 +149,17 @@ public:
 
    void set_parameters_random();
 
+   // Pruning
+
+   void set_pruning_mask(const Tensor<bool, 2>&);
+   void set_sparse_block_size(const Index&);
+
+   void remove_pruning_mask();
+
+   void prune_synaptic_weights(const type&);
+
+   void mask_synaptic_weights(type*) const;
+
    // Perceptron layer combinations_2d
 
    void calculate_combinations(const Tensor<type, 2>& inputs,
@@ -136,6 +167,8 @@ public:
                                const Tensor<type, 2>& synaptic_weights,
                                Tensor<type, 2>& combinations_2d) const;
 
+   void calculate_sparse_combinations(const Tensor<type, 2>& inputs, Tensor<type, 2>& combinations_2d) const;
+
    // Perceptron layer activations_2d
 
    void calculate_activations(const Tensor<type, 2>& combinations_2d, Tensor<type, 2>& activations_2d) const;
@@ -144,6 +177,10 @@ public:
                                           Tensor<type, 2>& activations,
                                           Tensor<type, 2>& activations_derivatives) const;
 
+   void calculate_tile_activations_derivatives(const TensorMap<Tensor<type, 2>>& combinations_2d,
+                                               TensorMap<Tensor<type, 2>>& activations,
+                                               TensorMap<Tensor<type, 2>>& activations_derivatives) const;
+
    // Perceptron layer outputs
 
    Tensor<type, 2> calculate_outputs(const Tensor<type, 2>&);
@@ -154,9 +191,26 @@ public:
 
 
    void forward_propagate(const Tensor<type, 2>& inputs,
-                                      Tensor<type, 1> potential_parameters,
+                                      const TensorMap<Tensor<type, 1>>& potential_parameters,
                                       ForwardPropagation& forward_propagation) const;
 
+   void forward_propagate(const Tensor<type, 2>& inputs,
+                          const TensorMap<Tensor<type, 2>>& biases,
+                          const TensorMap<Tensor<type, 2>>& synaptic_weights,
+                          ForwardPropagation& forward_propagation) const;
+
+   void forward_propagate(const CsrMatrix& inputs,
+                          ForwardPropagation& forward_propagation) const;
+
+   void forward_propagate(const CsrMatrix& inputs,
+                          const TensorMap<Tensor<type, 1>>& potential_parameters,
+                          ForwardPropagation& forward_propagation) const;
+
+   void forward_propagate(const CsrMatrix& inputs,
+                          const TensorMap<Tensor<type, 2>>& biases,
+                          const TensorMap<Tensor<type, 2>>& synaptic_weights,
+                          ForwardPropagation& forward_propagation) const;
+
    // Delta methods
 
    void calculate_output_delta(ForwardPropagation& forward_propagation,
@@ -179,12 +233,21 @@ public:
                                              const Tensor<type, 2>& next_layer_delta,
                                              Tensor<type, 2>& hidden_delta) const;
 
+   void calculate_hidden_delta_low_rank_perceptron(Layer* next_layer_pointer,
+                                                   const Tensor<type, 2>& activations_derivatives,
+                                                   const Tensor<type, 2>& next_layer_delta,
+                                                   Tensor<type, 2>& hidden_delta) const;
+
    // Gradient methods
 
    void calculate_error_gradient(const Tensor<type, 2>& inputs,
                                  const Layer::ForwardPropagation&,
                                  Layer::BackPropagation& back_propagation) const;
 
+   void calculate_error_gradient(const CsrMatrix& inputs,
+                                 const Layer::ForwardPropagation&,
+                                 Layer::BackPropagation& back_propagation) const;
+
    void insert_gradient(const BackPropagation& back_propagation, const Index& index, Tensor<type, 1>& gradient) const;
 
    // Expression methods   
@@ -200,6 +263,9 @@ public:
    string write_combinations_c() const;
    string write_activations_c() const;
 
+   string write_batch_expression_c() const;
+   string write_batch_activations_c() const;
+
    string write_combinations_python() const;
    string write_activations_python() const;
    string write_expression_python() const;
@@ -213,6 +279,10 @@ public:
 
 protected:
 
+   void apply_pruning_mask();
+
+   void set_sparse_synaptic_weights();
+
    // MEMBERS
 
    /// Bias is a neuron parameter that is summed with the neuron's weighted inputs
@@ -228,6 +298,27 @@ protected:
 
    ActivationFunction activation_function;
 
+   /// Inputs_number x neurons_number matrix which is true for the synaptic weights which are kept.
+   /// It is empty if the layer is not pruned.
+
+   Tensor<bool, 2> pruning_mask;
+
+   /// Number of consecutive inputs of a neuron which are stored together in the sparse synaptic weights.
+
+   Index sparse_block_size = 4;
+
+   /// Position of the first block of each neuron in the sparse synaptic weights, with the number of blocks at the end.
+
+   Tensor<Index, 1> sparse_neurons_blocks;
+
+   /// First input of each block in the sparse synaptic weights.
+
+   Tensor<Index, 1> sparse_blocks_inputs;
+
+   /// Synaptic weights of the blocks with some weight which is not pruned, sparse_block_size values for each block.
+
+   Tensor<type, 1> sparse_synaptic_weights;
+
    /// Layer type variable.
 
    PerceptronLayerType perceptron_layer_type = OutputLayer;
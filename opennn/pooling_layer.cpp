@@ -7,6 +7,7 @@
 //   artelnics@artelnics.com
 
 #include "pooling_layer.h"
+#include "probabilistic_layer.h"
 
 namespace OpenNN
 {
@@ -56,621 +57,365 @@ PoolingLayer::~PoolingLayer()
 
 
 /// Returns the output of the pooling layer applied to a batch of images.
-/// @param inputs The batch of images.
+/// @param inputs The batch of images, with one flattened image in each row.
 
 Tensor<type, 2> PoolingLayer::calculate_outputs(const Tensor<type, 2>& inputs)
 {
-#ifdef __OPENNN_DEBUG__
-
-    const Index input_variables_dimensions_number = inputs.rank();
+    ForwardPropagation forward_propagation(inputs.dimension(0), this);
 
-    if(input_variables_dimensions_number != 4)
-    {
-        ostringstream buffer;
+    forward_propagate(inputs, forward_propagation);
 
-        buffer << "OpenNN Exception: ConvolutionalLayer class.\n"
-               << "Tensor<type, 2> calculate_outputs(const Tensor<type, 2>&) method.\n"
-               << "Number of inputs dimensions (" << input_variables_dimensions_number << ") must be 4 (batch, filters, rows, columns).\n";
-
-        throw logic_error(buffer.str());
-    }
+    return forward_propagation.activations_2d;
+}
 
-#endif
 
-    switch(pooling_method)
-    {
-    case NoPooling:
-        return calculate_no_pooling_outputs(inputs);
+/// Returns the output of the pooling layer applied to a batch of images.
+/// @param inputs The batch of images, with dimensions (images, channels, rows, columns).
 
-    case MaxPooling:
-        return calculate_max_pooling_outputs(inputs);
+Tensor<type, 4> PoolingLayer::calculate_outputs(const Tensor<type, 4>& inputs)
+{
+    ForwardPropagation forward_propagation(inputs.dimension(0), this);
 
-    case AveragePooling:
-        return calculate_average_pooling_outputs(inputs);
-    }
+    forward_propagate(inputs, forward_propagation);
 
-    return Tensor<type, 2>();
+    return forward_propagation.activations_4d;
 }
 
 
-/// Returns the result of applying average pooling to a batch of images.
-/// @param inputs The batch of images.
+/// Calculates the result of applying average pooling to a batch of images.
+/// @param inputs The batch of images, with one flattened image in each row.
+/// @param outputs Matrix where the pooled images are saved.
 
-Tensor<type, 2> PoolingLayer::calculate_average_pooling_outputs(const Tensor<type, 2>& inputs) const
+void PoolingLayer::calculate_average_pooling_outputs(const Tensor<type, 2>& inputs, Tensor<type, 2>& outputs) const
 {
-    /*
-        const Index images_number = inputs.dimension(0);
-
-        const Index channels_number = inputs.dimension(1);
+    const Index images_number = inputs.dimension(0);
 
-        const Index inputs_rows_number = inputs.dimension(2);
+    const Index channels_number = get_inputs_channels_number();
+    const Index inputs_rows_number = get_inputs_rows_number();
 
-        const Index inputs_columns_number = inputs.dimension(3);
+    const Index outputs_rows_number = get_outputs_rows_number();
+    const Index outputs_columns_number = get_outputs_columns_number();
 
-        const Index outputs_rows_number = (inputs_rows_number - pool_rows_number)/row_stride + 1;
+    const type pool_size = static_cast<type>(pool_rows_number*pool_columns_number);
 
-        const Index outputs_columns_number = (inputs_columns_number - pool_columns_number)/column_stride + 1;
+    #pragma omp parallel for
 
-        Tensor<type, 2> outputs(images_number, channels_number, outputs_rows_number, outputs_columns_number);
+    for(Index index = 0; index < channels_number*outputs_columns_number; index++)
+    {
+        const Index channel = index%channels_number;
+        const Index output_column = index/channels_number;
 
-        for(Index image_index = 0; image_index < images_number; image_index ++)
+        for(Index output_row = 0; output_row < outputs_rows_number; output_row++)
         {
-            for(Index channel_index = 0; channel_index < channels_number; channel_index ++)
-            {
-                for(Index row_index = 0; row_index < outputs_rows_number; row_index ++)
-                {
-                    for(Index column_index = 0; column_index < outputs_columns_number; column_index ++)
-                    {
-                        outputs(image_index, channel_index, row_index, column_index) = 0;
+            type* output_data = outputs.data() + images_number*(channel + channels_number*(output_row + outputs_rows_number*output_column));
 
-                        for(Index window_row = 0; window_row < pool_rows_number; window_row ++)
-                        {
-                            const Index row = row_index*row_stride + window_row;
+            fill_n(output_data, images_number, static_cast<type>(0.0));
 
-                            for(Index window_column = 0; window_column < pool_columns_number; window_column ++)
-                            {
-                                const Index column = column_index*column_stride + window_column;
+            for(Index window_column = 0; window_column < pool_columns_number; window_column++)
+            {
+                const Index column = output_column*column_stride + window_column;
 
-                                outputs(image_index, channel_index, row_index, column_index) += inputs(image_index, channel_index, row, column);
-                            }
-                        }
+                for(Index window_row = 0; window_row < pool_rows_number; window_row++)
+                {
+                    const Index row = output_row*row_stride + window_row;
 
-                        outputs(image_index, channel_index, row_index, column_index) /= pool_rows_number*pool_columns_number;
-                    }
+                    const type* input_data = inputs.data() + images_number*(channel + channels_number*(row + inputs_rows_number*column));
+
+                    for(Index i = 0; i < images_number; i++) output_data[i] += input_data[i];
                 }
             }
-        }
 
-        return outputs;
-    */
-    return Tensor<type, 2>();
+            for(Index i = 0; i < images_number; i++) output_data[i] /= pool_size;
+        }
+    }
 }
 
 
-/// Returns the result of applying no pooling to a batch of images.
-/// @param inputs The batch of images.
+/// Calculates the result of applying no pooling to a batch of images.
+/// @param inputs The batch of images, with one flattened image in each row.
+/// @param outputs Matrix where the images are saved.
 
-Tensor<type, 2> PoolingLayer::calculate_no_pooling_outputs(const Tensor<type, 2>& inputs) const
+void PoolingLayer::calculate_no_pooling_outputs(const Tensor<type, 2>& inputs, Tensor<type, 2>& outputs) const
 {
-    return inputs;
+    outputs = inputs;
 }
 
 
-/// Returns the result of applying max pooling to a batch of images.
-/// @param inputs The batch of images.
+/// Calculates the result of applying max pooling to a batch of images.
+/// The input column of each maximum is saved, so that the deltas can be routed back without searching the pools again.
+/// @param inputs The batch of images, with one flattened image in each row.
+/// @param outputs Matrix where the pooled images are saved.
+/// @param maximal_indices Matrix where the input columns of the maxima are saved.
 
-Tensor<type, 2> PoolingLayer::calculate_max_pooling_outputs(const Tensor<type, 2>& inputs) const
+void PoolingLayer::calculate_max_pooling_outputs(const Tensor<type, 2>& inputs,
+                                                 Tensor<type, 2>& outputs,
+                                                 Tensor<Index, 2>& maximal_indices) const
 {
-    /*
-        const Index images_number = inputs.dimension(0);
+    const Index images_number = inputs.dimension(0);
 
-        const Index channels_number = inputs.dimension(1);
+    const Index channels_number = get_inputs_channels_number();
+    const Index inputs_rows_number = get_inputs_rows_number();
 
-        const Index inputs_rows_number = inputs.dimension(2);
+    const Index outputs_rows_number = get_outputs_rows_number();
+    const Index outputs_columns_number = get_outputs_columns_number();
 
-        const Index inputs_columns_number = inputs.dimension(3);
+    #pragma omp parallel for
 
-        const Index outputs_rows_number = (inputs_rows_number - pool_rows_number)/row_stride + 1;
+    for(Index index = 0; index < channels_number*outputs_columns_number; index++)
+    {
+        const Index channel = index%channels_number;
+        const Index output_column = index/channels_number;
 
-        const Index outputs_columns_number = (inputs_columns_number - pool_columns_number)/column_stride + 1;
+        for(Index output_row = 0; output_row < outputs_rows_number; output_row++)
+        {
+            const Index output_index = images_number*(channel + channels_number*(output_row + outputs_rows_number*output_column));
 
-        Tensor<type, 2> outputs(images_number, channels_number, outputs_rows_number, outputs_columns_number);
+            type* output_data = outputs.data() + output_index;
+            Index* maximal_indices_data = maximal_indices.data() + output_index;
 
-        for(Index image_index = 0; image_index < images_number; image_index ++)
-        {
-            for(Index channel_index = 0; channel_index < channels_number; channel_index ++)
+            for(Index window_column = 0; window_column < pool_columns_number; window_column++)
             {
-                for(Index row_index = 0; row_index < outputs_rows_number; row_index ++)
+                const Index column = output_column*column_stride + window_column;
+
+                for(Index window_row = 0; window_row < pool_rows_number; window_row++)
                 {
-                    for(Index column_index = 0; column_index < outputs_columns_number; column_index ++)
-                    {
-                        outputs(image_index, channel_index, row_index, column_index) =
-                                inputs(image_index, channel_index, row_index*row_stride, column_index*column_stride);
+                    const Index row = output_row*row_stride + window_row;
 
-                        for(Index window_row = 0; window_row < pool_rows_number; window_row ++)
-                        {
-                            const Index row = row_index*row_stride + window_row;
+                    const Index input_column = channel + channels_number*(row + inputs_rows_number*column);
 
-                            for(Index window_column = 0; window_column < pool_columns_number; window_column ++)
-                            {
-                                const Index column = column_index*column_stride + window_column;
+                    const type* input_data = inputs.data() + images_number*input_column;
 
-                                if(inputs(image_index, channel_index, row, column) > outputs(image_index, channel_index, row_index, column_index))
-                                {
-                                    outputs(image_index, channel_index, row_index, column_index) = inputs(image_index, channel_index, row, column);
-                                }
+                    if(window_row == 0 && window_column == 0)
+                    {
+                        copy(input_data, input_data + images_number, output_data);
+                        fill_n(maximal_indices_data, images_number, input_column);
 
-                            }
+                        continue;
+                    }
+
+                    for(Index i = 0; i < images_number; i++)
+                    {
+                        if(input_data[i] > output_data[i])
+                        {
+                            output_data[i] = input_data[i];
+                            maximal_indices_data[i] = input_column;
                         }
                     }
                 }
             }
         }
+    }
+}
 
-        return outputs;
-    */
-    return Tensor<type, 2>();
 
-}
+/// Calculates the forward propagation of a batch of images.
+/// The pooled images are saved both as images, in the 4D activations, and flattened, in the 2D activations used by the next layers.
+/// @param inputs The batch of images, with one flattened image in each row.
+/// @param forward_propagation Structure where the outputs and the positions of the maxima are saved.
 
-/*
-Layer::ForwardPropagation PoolingLayer::forward_propagate(const Tensor<type, 2>& inputs)
+void PoolingLayer::forward_propagate(const Tensor<type, 2>& inputs, ForwardPropagation& forward_propagation) const
 {
-    ForwardPropagation layers;
+#ifdef __OPENNN_DEBUG__
 
-    layers.activations_2d = calculate_outputs(inputs);
+    if(inputs.dimension(1) != get_inputs_number())
+    {
+        ostringstream buffer;
 
-    layers.activations_derivatives = calculate_activations_derivatives(layers.activations_2d);
+        buffer << "OpenNN Exception: PoolingLayer class.\n"
+               << "void forward_propagate(const Tensor<type, 2>&, ForwardPropagation&) const method.\n"
+               << "Number of inputs columns (" << inputs.dimension(1) << ") must be equal to number of inputs (" << get_inputs_number() << ").\n";
 
-    return layers;
-}
-*/
+        throw logic_error(buffer.str());
+    }
 
-/// Returns the result of applying the derivative of the previously set activation method to a batch of images.
-/// @param inputs The batch of images.
+#endif
 
-Tensor<type, 2> PoolingLayer::calculate_activations_derivatives(const Tensor<type, 2>& inputs) const
-{
     switch(pooling_method)
     {
-    case NoPooling:
-    {
-        return calculate_no_pooling_activations_derivatives(inputs);
-    }
-    case AveragePooling:
-    {
-        return calculate_average_pooling_activations_derivatives(inputs);
-    }
-    case MaxPooling:
-    {
-        return calculate_max_pooling_activations_derivatives(inputs);
-    }
+        case NoPooling:
+            calculate_no_pooling_outputs(inputs, forward_propagation.activations_2d);
+            break;
+
+        case MaxPooling:
+            calculate_max_pooling_outputs(inputs, forward_propagation.activations_2d, forward_propagation.maximal_indices);
+            break;
+
+        case AveragePooling:
+            calculate_average_pooling_outputs(inputs, forward_propagation.activations_2d);
+            break;
     }
 
-    return Tensor<type, 2>();
+    forward_propagation.activations_4d = forward_propagation.activations_2d.reshape(forward_propagation.activations_4d.dimensions());
 }
 
 
-/// Returns the result of applying the no pooling activation method derivative to a batch of images.
-/// @param inputs The batch of images.
+/// Calculates the forward propagation of a batch of images.
+/// @param inputs The batch of images, with dimensions (images, channels, rows, columns).
+/// @param forward_propagation Structure where the outputs and the positions of the maxima are saved.
 
-Tensor<type, 2> PoolingLayer::calculate_no_pooling_activations_derivatives(const Tensor<type, 2>& inputs) const
+void PoolingLayer::forward_propagate(const Tensor<type, 4>& inputs, ForwardPropagation& forward_propagation) const
 {
-    /*
-        return Tensor<type, 2>(inputs.dimensions(), 1.0);
-    */
-    return Tensor<type, 2>();
+    const Index images_number = inputs.dimension(0);
+
+    const Tensor<type, 2> inputs_2d = inputs.reshape(Eigen::array<Index, 2>({images_number, inputs.size()/images_number}));
+
+    forward_propagate(inputs_2d, forward_propagation);
 }
 
 
-/// Returns the result of applying the no pooling activation method derivative to a batch of images.
-/// @param inputs The batch of images.
+/// The pooling layer has no parameters, so this is the same as the forward propagation with the current parameters.
 
-Tensor<type, 2> PoolingLayer::calculate_average_pooling_activations_derivatives(const Tensor<type, 2>& inputs) const
+void PoolingLayer::forward_propagate(const Tensor<type, 2>& inputs, const TensorMap<Tensor<type, 1>>&, ForwardPropagation& forward_propagation) const
 {
-    /*
-        return Tensor<type, 2>(inputs.dimensions(), 1.0);
-    */
-    return Tensor<type, 2>();
+    forward_propagate(inputs, forward_propagation);
 }
 
 
-Tensor<type, 2> PoolingLayer::calculate_max_pooling_activations_derivatives(const Tensor<type, 2>& inputs) const
+/// Calculates the delta of the pooling layer when it is the output layer.
+/// As for the hidden deltas, it is taken with respect to the inputs of the layer.
+
+void PoolingLayer::calculate_output_delta(ForwardPropagation& forward_propagation,
+                                          const Tensor<type, 2>& output_gradient,
+                                          Tensor<type, 2>& output_delta) const
 {
-    /*
-        return Tensor<type, 2>(inputs.dimensions(), 1.0);
-    */
-    return Tensor<type, 2>();
+    calculate_inputs_delta(forward_propagation, output_gradient, output_delta);
 }
 
 
-Tensor<type, 2> PoolingLayer::calculate_hidden_delta(Layer* next_layer_pointer,
-        const Tensor<type, 2>& activations_2d,
-        const Tensor<type, 2>& activations_derivatives,
-        const Tensor<type, 2>& next_layer_delta) const
+/// Calculates the delta of the pooling layer, with respect to its inputs.
+/// First the derivatives of the error with respect to the outputs are obtained from the next layer,
+/// and then they are routed back to the pools.
+/// @param next_layer_pointer Pointer to the next layer.
+/// @param forward_propagation Forward propagation of this layer, with the positions of the maxima.
+/// @param next_layer_delta Delta of the next layer.
+/// @param hidden_delta Matrix where the delta is saved.
+
+void PoolingLayer::calculate_hidden_delta(Layer* next_layer_pointer,
+                                          const Tensor<type, 2>&,
+                                          ForwardPropagation& forward_propagation,
+                                          const Tensor<type, 2>& next_layer_delta,
+                                          Tensor<type, 2>& hidden_delta) const
 {
-    if(pooling_method == NoPooling) return next_layer_delta;
-    else
-    {
-        const Type layer_type = next_layer_pointer->get_type();
+    const Index images_number = next_layer_delta.dimension(0);
+
+    const Type next_layer_type = next_layer_pointer->get_type();
+
+    Tensor<type, 2> outputs_delta(images_number, get_neurons_number());
 
-        if(layer_type == Convolutional)
+    switch(next_layer_type)
+    {
+        case Convolutional:
         {
-            ConvolutionalLayer* convolutional_layer = dynamic_cast<ConvolutionalLayer*>(next_layer_pointer);
+            const ConvolutionalLayer* convolutional_layer = dynamic_cast<ConvolutionalLayer*>(next_layer_pointer);
 
-            return calculate_hidden_delta_convolutional(convolutional_layer, activations_2d, activations_derivatives, next_layer_delta);
+            convolutional_layer->calculate_inputs_delta(next_layer_delta, outputs_delta);
         }
-        else if(layer_type == Pooling)
-        {
-            PoolingLayer* pooling_layer = dynamic_cast<PoolingLayer*>(next_layer_pointer);
+        break;
 
-            return calculate_hidden_delta_pooling(pooling_layer, activations_2d, activations_derivatives, next_layer_delta);
+        case Pooling:
+        {
+            outputs_delta = next_layer_delta;
         }
-        else if(layer_type == Perceptron)
+        break;
+
+        case Perceptron:
         {
-            PerceptronLayer* perceptron_layer = dynamic_cast<PerceptronLayer*>(next_layer_pointer);
+            const Tensor<type, 2>& next_synaptic_weights = dynamic_cast<PerceptronLayer*>(next_layer_pointer)->get_synaptic_weights();
 
-            return calculate_hidden_delta_perceptron(perceptron_layer, activations_2d, activations_derivatives, next_layer_delta);
+            outputs_delta.device(*thread_pool_device) = next_layer_delta.contract(next_synaptic_weights, A_BT);
         }
-        else if(layer_type == Probabilistic)
+        break;
+
+        case Probabilistic:
         {
-            ProbabilisticLayer* probabilistic_layer = dynamic_cast<ProbabilisticLayer*>(next_layer_pointer);
+            const Tensor<type, 2>& next_synaptic_weights = dynamic_cast<ProbabilisticLayer*>(next_layer_pointer)->get_synaptic_weights();
 
-            return calculate_hidden_delta_probabilistic(probabilistic_layer, activations_2d, activations_derivatives, next_layer_delta);
+            outputs_delta.device(*thread_pool_device) = next_layer_delta.contract(next_synaptic_weights, A_BT);
         }
+        break;
+
+        default:
+
+        return;
     }
 
-    return Tensor<type, 2>();
+    calculate_inputs_delta(forward_propagation, outputs_delta, hidden_delta);
 }
 
 
-Tensor<type, 2> PoolingLayer::calculate_hidden_delta_convolutional(ConvolutionalLayer* next_layer_pointer,
-        const Tensor<type, 2>&,
-        const Tensor<type, 2>&,
-        const Tensor<type, 2>& next_layer_delta) const
+/// Routes the derivatives of the error with respect to the outputs back to the inputs of the layer.
+/// With max pooling each output derivative goes to the input which was the maximum,
+/// and with average pooling it is shared among all the inputs of the pool.
+/// @param forward_propagation Forward propagation of this layer, with the positions of the maxima.
+/// @param outputs_delta Derivatives of the error with respect to the outputs, with one flattened image in each row.
+/// @param inputs_delta Matrix where the derivatives with respect to the inputs are saved.
+
+void PoolingLayer::calculate_inputs_delta(const ForwardPropagation& forward_propagation,
+                                          const Tensor<type, 2>& outputs_delta,
+                                          Tensor<type, 2>& inputs_delta) const
 {
-    // Current layer's values
+    const Index images_number = outputs_delta.dimension(0);
 
-    const Index images_number = next_layer_delta.dimension(0);
     const Index channels_number = get_inputs_channels_number();
-    const Index output_rows_number = get_outputs_rows_number();
-    const Index output_columns_number = get_outputs_columns_number();
-
-    // Next layer's values
+    const Index inputs_rows_number = get_inputs_rows_number();
 
-    const Index next_layers_filters_number = next_layer_pointer->get_filters_number();
-    const Index next_layers_filter_rows = next_layer_pointer->get_filters_rows_number();
-    const Index next_layers_filter_columns = next_layer_pointer->get_filters_columns_number();
-    const Index next_layers_output_rows = next_layer_pointer->get_outputs_rows_number();
-    const Index next_layers_output_columns = next_layer_pointer->get_outputs_columns_number();
-    const Index next_layers_row_stride = next_layer_pointer->get_row_stride();
-    const Index next_layers_column_stride = next_layer_pointer->get_column_stride();
-
-    const Tensor<type, 2> next_layers_weights = next_layer_pointer->get_synaptic_weights();
-
-    // Hidden delta calculation
-    /*
-        Tensor<type, 2> hidden_delta(Tensor<Index, 1>({images_number, channels_number, output_rows_number, output_columns_number}));
-
-        const Index size = hidden_delta.size();
-
-        #pragma omp parallel for
-
-        for(Index tensor_index = 0; tensor_index < size; tensor_index++)
-        {
-            const Index image_index = tensor_index/(channels_number*output_rows_number*output_columns_number);
-            const Index channel_index = (tensor_index/(output_rows_number*output_columns_number))%channels_number;
-            const Index row_index = (tensor_index/output_columns_number)%output_rows_number;
-            const Index column_index = tensor_index%output_columns_number;
+    const Index outputs_rows_number = get_outputs_rows_number();
+    const Index outputs_columns_number = get_outputs_columns_number();
 
-            type sum = 0;
-
-            const Index lower_row_index = (row_index - next_layers_filter_rows)/next_layers_row_stride + 1;
-            const Index upper_row_index = min(row_index/next_layers_row_stride + 1, next_layers_output_rows);
-            const Index lower_column_index = (column_index - next_layers_filter_columns)/next_layers_column_stride + 1;
-            const Index upper_column_index = min(column_index/next_layers_column_stride + 1, next_layers_output_columns);
-
-            for(Index i = 0; i < next_layers_filters_number; i++)
-            {
-                for(Index j = lower_row_index; j < upper_row_index; j++)
-                {
-                    for(Index k = lower_column_index; k < upper_column_index; k++)
-                    {
-                        const type delta_element = next_layer_delta(image_index, i, j, k);
-
-                        const type weight = next_layers_weights(i, channel_index, row_index - j*next_layers_row_stride, column_index - k*next_layers_column_stride);
+    if(pooling_method == NoPooling)
+    {
+        inputs_delta = outputs_delta;
 
-                        sum += delta_element*weight;
-                    }
-                }
-            }
+        return;
+    }
 
-            hidden_delta(image_index, channel_index, row_index, column_index) = sum;
-        }
+    inputs_delta.resize(images_number, get_inputs_number());
+    inputs_delta.setZero();
 
-        return hidden_delta;
-    */
-    return Tensor<type, 2>();
+    const type pool_size = static_cast<type>(pool_rows_number*pool_columns_number);
 
-}
+    // Pools overlap only within a channel, so the channels are processed in parallel
 
+    #pragma omp parallel for
 
-Tensor<type, 2> PoolingLayer::calculate_hidden_delta_pooling(PoolingLayer* next_layer_pointer,
-        const Tensor<type, 2>& activations_2d,
-        const Tensor<type, 2>&,
-        const Tensor<type, 2>& next_layer_delta) const
-{
-    /*
-        switch(next_layer_pointer->get_pooling_method())
+    for(Index channel = 0; channel < channels_number; channel++)
+    {
+        for(Index output_column = 0; output_column < outputs_columns_number; output_column++)
         {
-            case OpenNN::PoolingLayer::PoolingMethod::NoPooling:
-            {
-                return next_layer_delta;
-            }
-
-            case OpenNN::PoolingLayer::PoolingMethod::AveragePooling:
+            for(Index output_row = 0; output_row < outputs_rows_number; output_row++)
             {
-                // Current layer's values
+                const Index output_index = images_number*(channel + channels_number*(output_row + outputs_rows_number*output_column));
 
-                const Index images_number = next_layer_delta.dimension(0);
-                const Index channels_number = get_inputs_channels_number();
-                const Index output_rows_number = get_outputs_rows_number();
-                const Index output_columns_number = get_outputs_columns_number();
+                const type* output_delta_data = outputs_delta.data() + output_index;
 
-                // Next layer's values
-
-                const Index next_layers_pool_rows = next_layer_pointer->get_pool_rows_number();
-                const Index next_layers_pool_columns = next_layer_pointer->get_pool_columns_number();
-                const Index next_layers_output_rows = next_layer_pointer->get_outputs_rows_number();
-                const Index next_layers_output_columns = next_layer_pointer->get_outputs_columns_number();
-                const Index next_layers_row_stride = next_layer_pointer->get_row_stride();
-                const Index next_layers_column_stride = next_layer_pointer->get_column_stride();
-
-                // Hidden delta calculation
-
-                Tensor<type, 2> hidden_delta(Tensor<Index, 1>({images_number, channels_number, output_rows_number, output_columns_number}));
-
-                const Index size = hidden_delta.size();
-
-                #pragma omp parallel for
-
-                for(Index tensor_index = 0; tensor_index < size; tensor_index++)
+                if(pooling_method == MaxPooling)
                 {
-                    const Index image_index = tensor_index/(channels_number*output_rows_number*output_columns_number);
-                    const Index channel_index = (tensor_index/(output_rows_number*output_columns_number))%channels_number;
-                    const Index row_index = (tensor_index/output_columns_number)%output_rows_number;
-                    const Index column_index = tensor_index%output_columns_number;
-
-                    type sum = 0;
+                    const Index* maximal_indices_data = forward_propagation.maximal_indices.data() + output_index;
 
-                    const Index lower_row_index = (row_index - next_layers_pool_rows)/next_layers_row_stride + 1;
-                    const Index upper_row_index = min(row_index/next_layers_row_stride + 1, next_layers_output_rows);
-                    const Index lower_column_index = (column_index - next_layers_pool_columns)/next_layers_column_stride + 1;
-                    const Index upper_column_index = min(column_index/next_layers_column_stride + 1, next_layers_output_columns);
-
-                    for(Index i = lower_row_index; i < upper_row_index; i++)
+                    for(Index i = 0; i < images_number; i++)
                     {
-                        for(Index j = lower_column_index; j < upper_column_index; j++)
-                        {
-                            const type delta_element = next_layer_delta(image_index, channel_index, i, j);
-
-                            sum += delta_element;
-                        }
+                        inputs_delta(i, maximal_indices_data[i]) += output_delta_data[i];
                     }
 
-                    hidden_delta(image_index, channel_index, row_index, column_index) = sum;
+                    continue;
                 }
 
-                return hidden_delta/(next_layers_pool_rows*next_layers_pool_columns);
-            }
-
-            case OpenNN::PoolingLayer::PoolingMethod::MaxPooling:
-            {
-                // Current layer's values
-
-                const Index images_number = next_layer_delta.dimension(0);
-                const Index channels_number = get_inputs_channels_number();
-                const Index output_rows_number = get_outputs_rows_number();
-                const Index output_columns_number = get_outputs_columns_number();
-
-                // Next layer's values
-
-                const Index next_layers_pool_rows = next_layer_pointer->get_pool_rows_number();
-                const Index next_layers_pool_columns = next_layer_pointer->get_pool_columns_number();
-                const Index next_layers_output_rows = next_layer_pointer->get_outputs_rows_number();
-                const Index next_layers_output_columns = next_layer_pointer->get_outputs_columns_number();
-                const Index next_layers_row_stride = next_layer_pointer->get_row_stride();
-                const Index next_layers_column_stride = next_layer_pointer->get_column_stride();
-
-                // Hidden delta calculation
-
-                Tensor<type, 2> hidden_delta(Tensor<Index, 1>({images_number, channels_number, output_rows_number, output_columns_number}));
-
-                const Index size = hidden_delta.size();
-
-                #pragma omp parallel for
-
-                for(Index tensor_index = 0; tensor_index < size; tensor_index++)
+                for(Index window_column = 0; window_column < pool_columns_number; window_column++)
                 {
-                    const Index image_index = tensor_index/(channels_number*output_rows_number*output_columns_number);
-                    const Index channel_index = (tensor_index/(output_rows_number*output_columns_number))%channels_number;
-                    const Index row_index = (tensor_index/output_columns_number)%output_rows_number;
-                    const Index column_index = tensor_index%output_columns_number;
-
-                    type sum = 0;
-
-                    const Index lower_row_index = (row_index - next_layers_pool_rows)/next_layers_row_stride + 1;
-                    const Index upper_row_index = min(row_index/next_layers_row_stride + 1, next_layers_output_rows);
-                    const Index lower_column_index = (column_index - next_layers_pool_columns)/next_layers_column_stride + 1;
-                    const Index upper_column_index = min(column_index/next_layers_column_stride + 1, next_layers_output_columns);
+                    const Index column = output_column*column_stride + window_column;
 
-                    for(Index i = lower_row_index; i < upper_row_index; i++)
+                    for(Index window_row = 0; window_row < pool_rows_number; window_row++)
                     {
-                        for(Index j = lower_column_index; j < upper_column_index; j++)
-                        {
-                            Tensor<type, 2> activations_current_submatrix(next_layers_pool_rows, next_layers_pool_columns);
-
-                            for(Index submatrix_row_index = 0; submatrix_row_index < next_layers_pool_rows; submatrix_row_index++)
-                            {
-                                for(Index submatrix_column_index = 0; submatrix_column_index < next_layers_pool_columns; submatrix_column_index++)
-                                {
-                                    activations_current_submatrix(submatrix_row_index, submatrix_column_index) =
-                                            activations_2d(image_index, channel_index, i*next_layers_row_stride + submatrix_row_index, j*next_layers_column_stride + submatrix_column_index);
-                                }
-                            }
-
-                            Tensor<type, 2> multiply_not_multiply(next_layers_pool_rows, next_layers_pool_columns);
+                        const Index row = output_row*row_stride + window_row;
 
-                            type max_value = activations_current_submatrix(0,0);
+                        type* input_delta_data = inputs_delta.data() + images_number*(channel + channels_number*(row + inputs_rows_number*column));
 
-                            for(Index submatrix_row_index = 0; submatrix_row_index < next_layers_pool_rows; submatrix_row_index++)
-                            {
-                                for(Index submatrix_column_index = 0; submatrix_column_index < next_layers_pool_columns; submatrix_column_index++)
-                                {
-                                    if(activations_current_submatrix(submatrix_row_index, submatrix_column_index) > max_value)
-                                    {
-                                        max_value = activations_current_submatrix(submatrix_row_index, submatrix_column_index);
-
-                                        multiply_not_multiply = Tensor<type, 2>(next_layers_pool_rows, next_layers_pool_columns, 0.0);
-                                        multiply_not_multiply(submatrix_row_index, submatrix_column_index) = 1.0;
-                                    }
-                                }
-                            }
-
-                            const type delta_element = next_layer_delta(image_index, channel_index, i, j);
-
-                            const type max_derivative = multiply_not_multiply(row_index - i*next_layers_row_stride, column_index - j*next_layers_column_stride);
-
-                            sum += delta_element*max_derivative;
-                        }
+                        for(Index i = 0; i < images_number; i++) input_delta_data[i] += output_delta_data[i]/pool_size;
                     }
-
-                    hidden_delta(image_index, channel_index, row_index, column_index) = sum;
                 }
-
-                return hidden_delta;
-            }
-        }
-    */
-    return Tensor<type, 2>();
-}
-
-
-Tensor<type, 2> PoolingLayer::calculate_hidden_delta_perceptron(PerceptronLayer* next_layer_pointer,
-        const Tensor<type, 2>&,
-        const Tensor<type, 2>&,
-        const Tensor<type, 2>& next_layer_delta) const
-{
-    /*
-        // Current layer's values
-
-        const Index images_number = next_layer_delta.dimension(0);
-        const Index channels_number = get_inputs_channels_number();
-        const Index output_rows_number = get_outputs_rows_number();
-        const Index output_columns_number = get_outputs_columns_number();
-
-        // Next layer's values
-
-        const Index next_layers_output_columns = next_layer_delta.dimension(1);
-
-        const Tensor<type, 2> next_layers_weights = next_layer_pointer->get_synaptic_weights();
-
-        // Hidden delta calculation
-
-        Tensor<type, 2> hidden_delta(Tensor<Index, 1>({images_number, channels_number, output_rows_number, output_columns_number}));
-
-        const Index size = hidden_delta.size();
-
-        #pragma omp parallel for
-
-        for(Index tensor_index = 0; tensor_index < size; tensor_index++)
-        {
-            Index image_index = tensor_index/(channels_number*output_rows_number*output_columns_number);
-            Index channel_index = (tensor_index/(output_rows_number*output_columns_number))%channels_number;
-            Index row_index = (tensor_index/output_columns_number)%output_rows_number;
-            Index column_index = tensor_index%output_columns_number;
-
-            type sum = 0;
-
-            for(Index sum_index = 0; sum_index < next_layers_output_columns; sum_index++)
-            {
-                const type delta_element = next_layer_delta(image_index, sum_index);
-
-                const type weight = next_layers_weights(channel_index + row_index*channels_number + column_index*channels_number*output_rows_number, sum_index);
-
-                sum += delta_element*weight;
-            }
-
-            hidden_delta(image_index, channel_index, row_index, column_index) = sum;
-        }
-
-        return hidden_delta;
-     */
-    return Tensor<type, 2>();
-
-}
-
-
-Tensor<type, 2> PoolingLayer::calculate_hidden_delta_probabilistic(ProbabilisticLayer* next_layer_pointer,
-        const Tensor<type, 2>&,
-        const Tensor<type, 2>&,
-        const Tensor<type, 2>& next_layer_delta) const
-{
-    /*
-        // Current layer's values
-
-        const Index images_number = next_layer_delta.dimension(0);
-        const Index channels_number = get_inputs_channels_number();
-        const Index output_rows_number = get_outputs_rows_number();
-        const Index output_columns_number = get_outputs_columns_number();
-
-        // Next layer's values
-
-        const Index next_layers_output_columns = next_layer_delta.dimension(1);
-
-        const Tensor<type, 2> next_layers_weights = next_layer_pointer->get_synaptic_weights();
-
-        // Hidden delta calculation
-
-        Tensor<type, 2> hidden_delta(Tensor<Index, 1>({images_number, channels_number, output_rows_number, output_columns_number}));
-
-        const Index size = hidden_delta.size();
-
-        #pragma omp parallel for
-
-        for(Index tensor_index = 0; tensor_index < size; tensor_index++)
-        {
-            const Index image_index = tensor_index/(channels_number*output_rows_number*output_columns_number);
-            const Index channel_index = (tensor_index/(output_rows_number*output_columns_number))%channels_number;
-            const Index row_index = (tensor_index/output_columns_number)%output_rows_number;
-            const Index column_index = tensor_index%output_columns_number;
-
-            type sum = 0;
-
-            for(Index sum_index = 0; sum_index < next_layers_output_columns; sum_index++)
-            {
-                const type delta_element = next_layer_delta(image_index, sum_index);
-
-                const type weight = next_layers_weights(channel_index + row_index*channels_number + column_index*channels_number*output_rows_number, sum_index);
-
-                sum += delta_element*weight;
             }
-
-            hidden_delta(image_index, channel_index, row_index, column_index) = sum;
         }
-
-        return hidden_delta;
-    */
-    return Tensor<type, 2>();
-
-}
-
-
-Tensor<type, 1> PoolingLayer::calculate_error_gradient(const Tensor<type, 2>&,
-        const Layer::ForwardPropagation&,
-        const Tensor<type, 2>&)
-{
-    return Tensor<type, 1>();
+    }
 }
 
 
@@ -678,7 +423,7 @@ Tensor<type, 1> PoolingLayer::calculate_error_gradient(const Tensor<type, 2>&,
 
 Index PoolingLayer::get_neurons_number() const
 {
-    return get_outputs_rows_number() * get_outputs_columns_number();
+    return get_inputs_channels_number()*get_outputs_rows_number()*get_outputs_columns_number();
 }
 
 
@@ -715,16 +460,7 @@ Tensor<Index, 1> PoolingLayer::get_inputs_indices(const Index& neuron) const
 
 Tensor<Index, 1> PoolingLayer::get_input_variables_dimensions() const
 {
-    /*
-        const Index batch_instances_number = 0;
-        const Index filters_number = 0;
-        const Index outputs_rows_number = get_outputs_rows_number();
-        const Index outputs_columns_number = get_outputs_columns_number();
-
-        return Tensor<Index, 1>({batch_instances_number, filters_number, outputs_rows_number, outputs_columns_number});
-    */
-
-    return Tensor<Index, 1>();
+    return input_variables_dimensions;
 }
 
 
@@ -745,10 +481,7 @@ Tensor<Index, 1> PoolingLayer::get_outputs_dimensions() const
 
 Index PoolingLayer::get_inputs_number() const
 {
-    /*
-        return input_variables_dimensions.calculate_product();
-    */
-    return 0;
+    return get_inputs_channels_number()*get_inputs_rows_number()*get_inputs_columns_number();
 }
 
 
@@ -780,6 +513,8 @@ Index PoolingLayer::get_inputs_columns_number() const
 
 Index PoolingLayer::get_outputs_rows_number() const
 {
+    if(pooling_method == NoPooling) return input_variables_dimensions[1];
+
     return (input_variables_dimensions[1] - pool_rows_number)/row_stride + 1;
 }
 
@@ -788,6 +523,8 @@ Index PoolingLayer::get_outputs_rows_number() const
 
 Index PoolingLayer::get_outputs_columns_number() const
 {
+    if(pooling_method == NoPooling) return input_variables_dimensions[2];
+
     return (input_variables_dimensions[2] - pool_columns_number)/column_stride + 1;
 }
 
@@ -46,32 +46,6 @@ public:
 
     enum PoolingMethod {NoPooling, MaxPooling, AveragePooling};
 
-    struct PoolingLayerForwardPropagation : ForwardPropagation
-    {
-        /// Default constructor.
-
-        explicit PoolingLayerForwardPropagation() : ForwardPropagation(){}
-
-        virtual ~PoolingLayerForwardPropagation() {}
-
-        void allocate()
-        {
-/*
-            const PoolingLayer* pooling_layer = dynamic_cast<PoolingLayer*>(trainable_layers_pointers[i]);
-
-            const Index outputs_channels_number = pooling_layer->get_inputs_channels_number();
-            const Index outputs_rows_number = pooling_layer->get_outputs_rows_number();
-            const Index outputs_columns_number = pooling_layer->get_outputs_columns_number();
-
-            layers[i].combinations_2d.resize(Tensor<Index, 1>({batch_instances_number, outputs_channels_number, outputs_rows_number, outputs_columns_number}));
-            layers[i].activations_2d.resize(Tensor<Index, 1>({batch_instances_number, outputs_channels_number, outputs_rows_number, outputs_columns_number}));
-            layers[i].activations_derivatives.resize(Tensor<Index, 1>({batch_instances_number, outputs_channels_number, outputs_rows_number, outputs_columns_number}));
-*/
-        }
-
-    };
-
-
     // Constructors
 
     explicit PoolingLayer();
@@ -140,58 +114,41 @@ public:
 
     void set_default();
 
-    // Outputs
-
-    Tensor<type, 2> calculate_outputs(const Tensor<type, 2>&);
+    // Parameters
 
-    void calculate_activations(const Tensor<type, 2>&,  Tensor<type, 2>&) {}
+    void set_parameters(const Tensor<type, 1>&, const Index&) {}
 
-    Tensor<type, 2> calculate_no_pooling_outputs(const Tensor<type, 2>&) const;
+    void set_parameters_constant(const type&) {}
 
-    Tensor<type, 2> calculate_max_pooling_outputs(const Tensor<type, 2>&) const;
+    void set_parameters_random() {}
 
-    Tensor<type, 2> calculate_average_pooling_outputs(const Tensor<type, 2>&) const;    
+    // Outputs
 
-    // Activations derivatives
+    Tensor<type, 2> calculate_outputs(const Tensor<type, 2>&);
 
-    Tensor<type, 2> calculate_activations_derivatives(const Tensor<type, 2>&) const;
+    Tensor<type, 4> calculate_outputs(const Tensor<type, 4>&);
 
-    void calculate_activations_derivatives(const Tensor<type, 2>&, Tensor<type, 2>&) const
-    {
+    void calculate_no_pooling_outputs(const Tensor<type, 2>&, Tensor<type, 2>&) const;
 
-    }
+    void calculate_max_pooling_outputs(const Tensor<type, 2>&, Tensor<type, 2>&, Tensor<Index, 2>&) const;
 
-    Tensor<type, 2> calculate_no_pooling_activations_derivatives(const Tensor<type, 2>&) const;
+    void calculate_average_pooling_outputs(const Tensor<type, 2>&, Tensor<type, 2>&) const;
 
-    Tensor<type, 2> calculate_average_pooling_activations_derivatives(const Tensor<type, 2>&) const;
+    // Forward propagation
 
-    Tensor<type, 2> calculate_max_pooling_activations_derivatives(const Tensor<type, 2>&) const;
+    void forward_propagate(const Tensor<type, 2>&, ForwardPropagation&) const;
 
-    // First order activations_2d
-/*
-    ForwardPropagation forward_propagate(const Tensor<type, 2>&);
-*/
-    void forward_propagate(const Tensor<type, 2>&, ForwardPropagation&)
-    {
-/*
-        calculate_activations(inputs, forward_propagation.activations_2d);
+    void forward_propagate(const Tensor<type, 4>&, ForwardPropagation&) const;
 
-        calculate_activations_derivatives(forward_propagation.activations_2d, forward_propagation.activations_derivatives);
-*/
-    }
+    void forward_propagate(const Tensor<type, 2>&, const TensorMap<Tensor<type, 1>>&, ForwardPropagation&) const;
 
     // Delta methods
 
-    Tensor<type, 2> calculate_hidden_delta(Layer*, const Tensor<type, 2>&, const Tensor<type, 2>&, const Tensor<type, 2>&) const;
-
-    Tensor<type, 2> calculate_hidden_delta_convolutional(ConvolutionalLayer*, const Tensor<type, 2>&, const Tensor<type, 2>&, const Tensor<type, 2>&) const;
-    Tensor<type, 2> calculate_hidden_delta_pooling(PoolingLayer*, const Tensor<type, 2>&, const Tensor<type, 2>&, const Tensor<type, 2>&) const;
-    Tensor<type, 2> calculate_hidden_delta_perceptron(PerceptronLayer*, const Tensor<type, 2>&, const Tensor<type, 2>&, const Tensor<type, 2>&) const;
-    Tensor<type, 2> calculate_hidden_delta_probabilistic(ProbabilisticLayer*, const Tensor<type, 2>&, const Tensor<type, 2>&, const Tensor<type, 2>&) const;
+    void calculate_output_delta(ForwardPropagation&, const Tensor<type, 2>&, Tensor<type, 2>&) const;
 
-    // Gradient methods
+    void calculate_hidden_delta(Layer*, const Tensor<type, 2>&, ForwardPropagation&, const Tensor<type, 2>&, Tensor<type, 2>&) const;
 
-    Tensor<type, 1> calculate_error_gradient(const Tensor<type, 2>&, const Layer::ForwardPropagation&, const Tensor<type, 2>&);
+    void calculate_inputs_delta(const ForwardPropagation&, const Tensor<type, 2>&, Tensor<type, 2>&) const;
 
 protected:
 
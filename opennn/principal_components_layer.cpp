@@ -164,74 +164,49 @@ Index PrincipalComponentsLayer::get_neurons_number() const
 
 Tensor<type, 2> PrincipalComponentsLayer::calculate_outputs(const Tensor<type, 2>& inputs)
 {
-    /*
-        const Index inputs_number = inputs.dimension(1);
-
-        #ifdef __OPENNN_DEBUG__
+#ifdef __OPENNN_DEBUG__
 
+    if(inputs.dimension(1) != inputs_number)
+    {
         ostringstream buffer;
 
-        if(principal_components.dimension(0) != inputs_number)
-        {
-           buffer << "OpenNN Exception: PrincipalComponentsLayer class.\n"
-                  << "Tensor<type, 2> calculate_outputs(Matrix Tensor<type, 1>&) const method.\n"
-                  << "Size of inputs must be equal to the number of rows of the principal components matrix.\n";
-
-           throw logic_error(buffer.str());
-        }
-
-        #endif
-
-        if(write_principal_components_method() != "PrincipalComponents")
-        {
-            return inputs;
-        }
-
-            const Tensor<Index, 1> principal_components_indices(0, 1.0, get_principal_components_number()-1);
-
-            const Tensor<Index, 1> input_variables_indices(0, 1.0, inputs_number-1);
-
-            const Tensor<type, 2> used_principal_components = principal_components.get_submatrix(principal_components_indices, input_variables_indices);
-
-            const Tensor<type, 2> inputs_adjust = inputs.subtract_rows(means);
-
-            return dot(inputs_adjust, used_principal_components.calculate_transpose());
+        buffer << "OpenNN Exception: PrincipalComponentsLayer class.\n"
+               << "Tensor<type, 2> calculate_outputs(const Tensor<type, 2>&) method.\n"
+               << "Number of columns of inputs (" << inputs.dimension(1) << ") must be equal to number of inputs (" << inputs_number << ").\n";
 
-            for(Index i = 0;  i < points_number; i++)
-            {
-                const Tensor<Index, 1> principal_components_indices(0, 1.0, get_principal_components_number()-1);
+        throw logic_error(buffer.str());
+    }
 
-                const Tensor<Index, 1> input_variables_indices(0, 1.0, inputs_number-1);
+#endif
 
-                const Tensor<type, 2> used_principal_components = principal_components.get_submatrix(principal_components_indices, input_variables_indices);
+    if(principal_components_method == NoPrincipalComponents)
+    {
+        return inputs;
+    }
 
-                // Data adjust
+    const Index points_number = inputs.dimension(0);
 
-                const Tensor<type, 2> inputs_adjust = inputs.subtract_rows(means);
+    // Data adjust
 
-    //            Tensor<type, 1> inputs_adjust(inputs_number);
+    Tensor<type, 2> inputs_adjust(points_number, inputs_number);
 
-    //            for(Index j = 0; j < inputs_number; j++)
-    //            {
-    //                inputs_adjust[j] = inputs[j] - means[j];
-    //            }
+    for(Index j = 0; j < inputs_number; j++)
+    {
+        inputs_adjust.chip(j, 1) = inputs.chip(j, 1) - means(j);
+    }
 
-                // Outputs
+    // Outputs
 
-                const Index principal_components_number = used_principal_components.dimension(0);
+    const Eigen::array<Index, 2> offsets = {0, 0};
+    const Eigen::array<Index, 2> extents = {principal_components_number, inputs_number};
 
-                Tensor<type, 2> outputs(points_number, principal_components_number);
+    const Tensor<type, 2> used_principal_components = principal_components.slice(offsets, extents);
 
-                for(Index j = 0; j < principal_components_number; j++)
-                {
-                    outputs(i,j) = inputs_adjust.dot(used_principal_components.chip(j, 0));
-                }
+    Tensor<type, 2> outputs(points_number, principal_components_number);
 
-            }
+    outputs.device(*thread_pool_device) = inputs_adjust.contract(used_principal_components, A_BT);
 
-            return outputs;
-        */
-    return Tensor<type, 2>();
+    return outputs;
 }
 
 
@@ -314,6 +289,53 @@ string PrincipalComponentsLayer::write_principal_components_expression(const Ten
 }
 
 
+/// Returns the C function of the principal components layer for a batch of inputs, which are stored by rows.
+/// The principal components are an affine function of the inputs,
+/// so they are calculated by the calculate_combinations kernel written by the neural network.
+
+string PrincipalComponentsLayer::write_batch_expression_c() const
+{
+    ostringstream buffer;
+
+    if(principal_components_method == NoPrincipalComponents)
+    {
+        buffer << "static void " << layer_name << "(const float* inputs, float* outputs, int batch_size)\n{" << endl;
+
+        buffer << "\tfor(int i = 0; i < batch_size*" << inputs_number << "; i++)\n\t{" << endl;
+        buffer << "\t\toutputs[i] = inputs[i];" << endl;
+        buffer << "\t}" << endl;
+
+        buffer << "}\n" << endl;
+
+        return buffer.str();
+    }
+
+    const Eigen::array<Index, 2> offsets = {0, 0};
+    const Eigen::array<Index, 2> extents = {principal_components_number, inputs_number};
+
+    const Tensor<type, 2> used_principal_components = principal_components.slice(offsets, extents);
+
+    const Eigen::array<IndexPair<Index>, 1> product_dimensions = {IndexPair<Index>(0, 1)};
+
+    const Tensor<type, 1> biases = -means.contract(used_principal_components, product_dimensions);
+
+    buffer << write_array_c(layer_name + "_biases", biases.data(), principal_components_number);
+
+    // The principal components matrix stored by columns has the components of each input contiguous
+
+    buffer << write_array_c(layer_name + "_principal_components", used_principal_components.data(), principal_components_number*inputs_number);
+
+    buffer << "static void " << layer_name << "(const float* inputs, float* outputs, int batch_size)\n{" << endl;
+
+    buffer << "\tcalculate_combinations(inputs, batch_size, " << inputs_number << ", " << principal_components_number << ", "
+           << layer_name << "_biases, " << layer_name << "_principal_components, outputs);" << endl;
+
+    buffer << "}\n" << endl;
+
+    return buffer.str();
+}
+
+
 // const bool& get_display() const method
 
 /// Returns true if messages from this class are to be displayed on the screen, or false if messages
@@ -351,13 +373,16 @@ void PrincipalComponentsLayer::set(const Index& new_inputs_number, const Index&
 {
     set_inputs_number(new_inputs_number);
     set_principal_components_number(new_principal_components_number);
-    /*
-        means.set(new_inputs_number, 0.0);
 
-        explained_variance.set(new_inputs_number, 0.0);
+    means.resize(new_inputs_number);
+    means.setZero();
+
+    explained_variance.resize(new_inputs_number);
+    explained_variance.setZero();
+
+    principal_components.resize(new_principal_components_number, new_inputs_number);
+    principal_components.setZero();
 
-        principal_components.set(new_principal_components_number, new_inputs_number, 0.0);
-    */
     set_default();
 }
 
@@ -369,12 +394,20 @@ void PrincipalComponentsLayer::set(const Index& new_inputs_number, const Index&
 
 void PrincipalComponentsLayer::set(const PrincipalComponentsLayer& new_principal_components_layer)
 {
+    set_default();
+
+    inputs_number = new_principal_components_layer.inputs_number;
+
+    principal_components_number = new_principal_components_layer.principal_components_number;
+
     principal_components_method = new_principal_components_layer.principal_components_method;
 
     principal_components = new_principal_components_layer.principal_components;
 
     means = new_principal_components_layer.means;
 
+    explained_variance = new_principal_components_layer.explained_variance;
+
     display = new_principal_components_layer.display;
 }
 
@@ -454,6 +487,7 @@ void PrincipalComponentsLayer::set_explained_variance(const Tensor<type, 1>& new
 
 /// Sets the members to their default value.
 /// <ul>
+/// <li> Principal components method: No principal components.
 /// <li> Display: true.
 /// </ul>
 
@@ -461,6 +495,10 @@ void PrincipalComponentsLayer::set_explained_variance(const Tensor<type, 1>& new
 
 void PrincipalComponentsLayer::set_default()
 {
+    layer_name = "principal_components_layer";
+
+    layer_type = Layer::PrincipalComponents;
+
     principal_components_method = NoPrincipalComponents;
 
     set_display(true);
@@ -124,6 +124,8 @@ public:
    string write_no_principal_components_expression(const Tensor<string, 1>&, const Tensor<string, 1>&) const;
    string write_principal_components_expression(const Tensor<string, 1>&, const Tensor<string, 1>&) const;
 
+   string write_batch_expression_c() const;
+
    // Serialization methods
 
    tinyxml2::XMLDocument* to_XML() const;
@@ -330,6 +330,10 @@ void ProbabilisticLayer::set(const Index& new_inputs_number, const Index& new_ne
 
 void ProbabilisticLayer::set(const ProbabilisticLayer& other_probabilistic_layer)
 {
+    biases = other_probabilistic_layer.biases;
+
+    synaptic_weights = other_probabilistic_layer.synaptic_weights;
+
     set_default();
 
     activation_function = other_probabilistic_layer.activation_function;
@@ -360,6 +364,61 @@ void ProbabilisticLayer::set_neurons_number(const Index& new_neurons_number)
 }
 
 
+/// Sets a new number of inputs keeping the synaptic weights of the inputs which remain.
+/// The synaptic weights of the new inputs are set to zero, so that the outputs do not change.
+/// @param inputs_indices Index of each new input among the previous inputs, or -1 for a new input.
+
+void ProbabilisticLayer::resize_inputs(const Tensor<Index, 1>& inputs_indices)
+{
+    const Index new_inputs_number = inputs_indices.size();
+
+    const Index inputs_number = get_inputs_number();
+    const Index neurons_number = get_neurons_number();
+
+    Tensor<type, 2> new_synaptic_weights(new_inputs_number, neurons_number);
+    new_synaptic_weights.setZero();
+
+    for(Index i = 0; i < new_inputs_number; i++)
+    {
+        if(inputs_indices(i) < 0 || inputs_indices(i) >= inputs_number) continue;
+
+        new_synaptic_weights.chip(i,0) = synaptic_weights.chip(inputs_indices(i),0);
+    }
+
+    synaptic_weights = new_synaptic_weights;
+}
+
+
+/// Sets a new number of neurons keeping the biases and synaptic weights of the first ones.
+/// The new neurons have zero biases and small random synaptic weights, so that they can start learning.
+/// @param new_neurons_number Number of neurons.
+
+void ProbabilisticLayer::resize_neurons(const Index& new_neurons_number)
+{
+    const Index inputs_number = get_inputs_number();
+    const Index neurons_number = get_neurons_number();
+
+    const Index kept_neurons_number = min(neurons_number, new_neurons_number);
+
+    Tensor<type, 2> new_biases(1, new_neurons_number);
+    new_biases.setZero();
+
+    Tensor<type, 2> new_synaptic_weights(inputs_number, new_neurons_number);
+    new_synaptic_weights.setRandom<Eigen::internal::NormalRandomGenerator<type>>();
+    new_synaptic_weights = new_synaptic_weights*static_cast<type>(0.01);
+
+    for(Index j = 0; j < kept_neurons_number; j++)
+    {
+        new_biases(0,j) = biases(0,j);
+
+        new_synaptic_weights.chip(j,1) = synaptic_weights.chip(j,1);
+    }
+
+    biases = new_biases;
+    synaptic_weights = new_synaptic_weights;
+}
+
+
 void ProbabilisticLayer::set_biases(const Tensor<type, 2>& new_biases)
 {
     biases = new_biases;
@@ -705,6 +764,53 @@ void ProbabilisticLayer::calculate_activations(const Tensor<type, 2>& combinatio
      throw logic_error(buffer.str());
 }
 
+/// Calculates the activations and the element-wise activations derivatives of the layer.
+/// Softmax has no element-wise derivatives, and its deltas are computed from the activations alone,
+/// so only the activations are calculated in that case.
+
+void ProbabilisticLayer::calculate_activations_derivatives(const Tensor<type, 2>& combinations_2d,
+                                       Tensor<type, 2>& activations,
+                                       Tensor<type, 2>& activations_derivatives) const
+{
+     #ifdef __OPENNN_DEBUG__
+
+     const Index neurons_number = get_neurons_number();
+
+     const Index combinations_columns_number = combinations_2d.dimension(1);
+
+     if(combinations_columns_number != neurons_number)
+     {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: ProbabilisticLayer class.\n"
+               << "void calculate_activations_derivatives(const Tensor<type, 2>&, Tensor<type, 2>&, Tensor<type, 2>&) const method.\n"
+               << "Number of combinations_2d columns (" << combinations_columns_number
+               << ") must be equal to number of neurons (" << neurons_number << ").\n";
+
+        throw logic_error(buffer.str());
+     }
+
+     #endif
+
+     switch(activation_function)
+     {
+         case Logistic: logistic_derivatives(combinations_2d, activations, activations_derivatives); return;
+
+         case Softmax: softmax(combinations_2d, activations); return;
+
+         default:
+
+             calculate_activations(combinations_2d, activations);
+
+             activations_derivatives.setZero();
+
+             return;
+    }
+}
+
+
+/// Calculates the activations and the full Jacobian of the activations of each instance.
+
 void ProbabilisticLayer::calculate_activations_derivatives(const Tensor<type, 2>& combinations_2d,
                                        Tensor<type, 2>& activations,
                                        Tensor<type, 3>& activations_derivatives) const
@@ -765,12 +871,12 @@ void ProbabilisticLayer::forward_propagate(const Tensor<type, 2>& inputs, Forwar
 
     calculate_activations_derivatives(forward_propagation.combinations_2d,
                                       forward_propagation.activations_2d,
-                                      forward_propagation.activations_derivatives_3d);
+                                      forward_propagation.activations_derivatives_2d);
 }
 
 
 void ProbabilisticLayer::forward_propagate(const Tensor<type, 2>& inputs,
-                                   Tensor<type, 1> potential_parameters,
+                                   const TensorMap<Tensor<type, 1>>& potential_parameters,
                                    ForwardPropagation& forward_propagation) const
    {
     const Index neurons_number = get_neurons_number();
@@ -783,7 +889,7 @@ void ProbabilisticLayer::forward_propagate(const Tensor<type, 2>& inputs,
         ostringstream buffer;
 
         buffer << "OpenNN Exception: ProbabilisticLayer class.\n"
-               << "void forward_propagate(const Tensor<type, 2>&, Tensor<type, 1>&, ForwardPropagation&) method.\n"
+               << "void forward_propagate(const Tensor<type, 2>&, const TensorMap<Tensor<type, 1>>&, ForwardPropagation&) method.\n"
                << "Number of inputs columns (" << inputs.dimension(1) << ") must be equal to number of inputs ("
                << inputs_number << ").\n";
 
@@ -801,90 +907,60 @@ void ProbabilisticLayer::forward_propagate(const Tensor<type, 2>& inputs,
 
     calculate_activations_derivatives(forward_propagation.combinations_2d,
                                       forward_propagation.activations_2d,
-                                      forward_propagation.activations_derivatives_3d);
+                                      forward_propagation.activations_derivatives_2d);
 }
 
 
 
 
+/// Calculates the output delta of the layer from the gradient of the error with respect to its outputs.
+/// For softmax the product with the Jacobian of each instance is computed as
+/// activations*(output_gradient - sum(output_gradient*activations)), which is linear in the number of neurons.
+
 void ProbabilisticLayer::calculate_output_delta(ForwardPropagation& forward_propagation,
                             const Tensor<type, 2>& output_gradient,
                             Tensor<type, 2>& output_delta) const
 {
     const Index neurons_number = get_neurons_number();
-    const Index batch_instances_number = forward_propagation.activations_derivatives_3d.dimension(0);
 
-    if(neurons_number == 1)
-    {
-        TensorMap< Tensor<type, 2> > activations_derivatives(forward_propagation.activations_derivatives_3d.data(), batch_instances_number, neurons_number);
+#ifdef __OPENNN_DEBUG__
 
-        output_delta.device(*thread_pool_device) = activations_derivatives*output_gradient;
+    const Index outputs_number = output_gradient.dimension(1);
 
-        return;
-    }
-    else
+    if(outputs_number != neurons_number)
     {
-        const Index outputs_number = output_gradient.dimension(1); // outputs_number = neurons_number and activations.dimension(1)
-
-        if(outputs_number != neurons_number)
-        {
-            ostringstream buffer;
-
-            buffer << "OpenNN Exception: ProbabilisticLayer class.\n"
-                   << "void calculate_output_delta(ForwardPropagation& ,const Tensor<type, 2>& ,Tensor<type, 2>& ) const.\n"
-                   << "Number of columns in output gradient (" << outputs_number << ") must be equal to number of neurons in probabilistic layer (" << neurons_number << ").\n";
-
-            throw logic_error(buffer.str());
-        }
-
-        if(forward_propagation.activations_derivatives_3d.dimension(1) != neurons_number)
-        {
-            ostringstream buffer;
-
-            buffer << "OpenNN Exception: ProbabilisticLayer class.\n"
-                   << "void calculate_output_delta(ForwardPropagation& ,const Tensor<type, 2>& ,Tensor<type, 2>& ) const.\n"
-                   << "Dimension 1 of activations derivatives 3d (" << outputs_number << ") must be equal to number of neurons in probabilistic layer (" << neurons_number << ").\n";
-
-            throw logic_error(buffer.str());
-        }
-
-        if(forward_propagation.activations_derivatives_3d.dimension(2) != neurons_number)
-        {
-            ostringstream buffer;
+        ostringstream buffer;
 
-            buffer << "OpenNN Exception: ProbabilisticLayer class.\n"
-                   << "void calculate_output_delta(ForwardPropagation& ,const Tensor<type, 2>& ,Tensor<type, 2>& ) const.\n"
-                   << "Dimension 2 of activations derivatives 3d (" << outputs_number << ") must be equal to number of neurons in probabilistic layer (" << neurons_number << ").\n";
+        buffer << "OpenNN Exception: ProbabilisticLayer class.\n"
+               << "void calculate_output_delta(ForwardPropagation& ,const Tensor<type, 2>& ,Tensor<type, 2>& ) const.\n"
+               << "Number of columns in output gradient (" << outputs_number << ") must be equal to number of neurons in probabilistic layer (" << neurons_number << ").\n";
 
-            throw logic_error(buffer.str());
-        }
+        throw logic_error(buffer.str());
+    }
 
-        Tensor<type, 1> output_gradient_row(neurons_number);
-        Tensor<type, 1> output_delta_row(neurons_number);
+#endif
 
-        Index index = 0;
-        Index step = neurons_number*neurons_number;
+    if(activation_function != Softmax)
+    {
+        output_delta.device(*thread_pool_device) = forward_propagation.activations_derivatives_2d*output_gradient;
 
-        for(Index i = 0; i < batch_instances_number; i++)
-        {
-            output_gradient_row = output_gradient.chip(i,0);
+        return;
+    }
 
-            TensorMap< Tensor<type, 2> > activations_derivatives_matrix(forward_propagation.activations_derivatives_3d.data()+index,
-                                                                        neurons_number, neurons_number);
+    const Index batch_instances_number = output_gradient.dimension(0);
 
-            output_delta_row.device(*thread_pool_device) = output_gradient_row.contract(activations_derivatives_matrix, AT_B);
+    const Tensor<type, 2>& activations = forward_propagation.activations_2d;
 
-            for(Index j = 0; j < neurons_number; j++)
-            {
-                output_delta(i,j) = output_delta_row(j);
-            }
+    const Eigen::array<Index, 1> columns_dimension({1});
+    const Eigen::array<Index, 2> column_shape({batch_instances_number, 1});
+    const Eigen::array<Index, 2> columns_broadcast({1, neurons_number});
 
+    Tensor<type, 1> projections(batch_instances_number);
 
-            index += step;
-        }
+    projections.device(*thread_pool_device) = (output_gradient*activations).sum(columns_dimension);
 
-        return;
-    }
+    output_delta.device(*thread_pool_device)
+            = activations*(output_gradient - projections.reshape(column_shape).broadcast(columns_broadcast));
 }
 
 
@@ -1500,6 +1576,91 @@ string ProbabilisticLayer::write_expression_c() const
 }
 
 
+/// Returns the C function of the layer for a batch of inputs, which are stored by rows.
+/// The synaptic weights are written as a static array with the weights of each input stored contiguously,
+/// and the combinations are calculated by the calculate_combinations kernel written by the neural network.
+/// The competitive and softmax activations are calculated for each instance.
+
+string ProbabilisticLayer::write_batch_expression_c() const
+{
+    const Index inputs_number = get_inputs_number();
+    const Index neurons_number = get_neurons_number();
+
+    ostringstream buffer;
+
+    buffer << write_array_c(layer_name + "_biases", biases.data(), neurons_number);
+
+    const Eigen::array<Index, 2> shuffle_dimensions = {1, 0};
+
+    const Tensor<type, 2> synaptic_weights_transpose = synaptic_weights.shuffle(shuffle_dimensions);
+
+    buffer << write_array_c(layer_name + "_synaptic_weights", synaptic_weights_transpose.data(), inputs_number*neurons_number);
+
+    buffer << "static void " << layer_name << "(const float* inputs, float* outputs, int batch_size)\n{" << endl;
+
+    buffer << "\tcalculate_combinations(inputs, batch_size, " << inputs_number << ", " << neurons_number << ", "
+           << layer_name << "_biases, " << layer_name << "_synaptic_weights, outputs);\n" << endl;
+
+    switch(activation_function)
+    {
+    case Binary:
+
+        buffer << "\tfor(int i = 0; i < batch_size*" << neurons_number << "; i++)\n\t{" << endl;
+        buffer << "\t\toutputs[i] = outputs[i] < 0.5f ? 0.0f : 1.0f;" << endl;
+        buffer << "\t}" << endl;
+
+        break;
+
+    case Logistic:
+
+        buffer << "\tfor(int i = 0; i < batch_size*" << neurons_number << "; i++)\n\t{" << endl;
+        buffer << "\t\toutputs[i] = 1.0f/(1.0f + expf(-outputs[i]));" << endl;
+        buffer << "\t}" << endl;
+
+        break;
+
+    case Competitive:
+
+        buffer << "\tfor(int i = 0; i < batch_size; i++)\n\t{" << endl;
+        buffer << "\t\tfloat* row = outputs + i*" << neurons_number << ";\n" << endl;
+        buffer << "\t\tint maximal_index = 0;\n" << endl;
+        buffer << "\t\tfor(int j = 1; j < " << neurons_number << "; j++)\n\t\t{" << endl;
+        buffer << "\t\t\tif(row[j] > row[maximal_index]) maximal_index = j;" << endl;
+        buffer << "\t\t}\n" << endl;
+        buffer << "\t\tfor(int j = 0; j < " << neurons_number << "; j++)\n\t\t{" << endl;
+        buffer << "\t\t\trow[j] = j == maximal_index ? 1.0f : 0.0f;" << endl;
+        buffer << "\t\t}" << endl;
+        buffer << "\t}" << endl;
+
+        break;
+
+    case Softmax:
+
+        buffer << "\tfor(int i = 0; i < batch_size; i++)\n\t{" << endl;
+        buffer << "\t\tfloat* row = outputs + i*" << neurons_number << ";\n" << endl;
+        buffer << "\t\tfloat maximum = row[0];\n" << endl;
+        buffer << "\t\tfor(int j = 1; j < " << neurons_number << "; j++)\n\t\t{" << endl;
+        buffer << "\t\t\tif(row[j] > maximum) maximum = row[j];" << endl;
+        buffer << "\t\t}\n" << endl;
+        buffer << "\t\tfloat sum = 0.0f;\n" << endl;
+        buffer << "\t\tfor(int j = 0; j < " << neurons_number << "; j++)\n\t\t{" << endl;
+        buffer << "\t\t\trow[j] = expf(row[j] - maximum);" << endl;
+        buffer << "\t\t\tsum += row[j];" << endl;
+        buffer << "\t\t}\n" << endl;
+        buffer << "\t\tfor(int j = 0; j < " << neurons_number << "; j++)\n\t\t{" << endl;
+        buffer << "\t\t\trow[j] /= sum;" << endl;
+        buffer << "\t\t}" << endl;
+        buffer << "\t}" << endl;
+
+        break;
+    }
+
+    buffer << "}\n" << endl;
+
+    return buffer.str();
+}
+
+
 string ProbabilisticLayer::write_expression_python() const
 {
     ostringstream buffer;
@@ -86,6 +86,9 @@ public:
    void set_inputs_number(const Index&);
    void set_neurons_number(const Index&);
 
+   void resize_inputs(const Tensor<Index, 1>&);
+   void resize_neurons(const Index&);
+
    void set_biases(const Tensor<type, 2>&);
    void set_synaptic_weights(const Tensor<type, 2>&);
 
@@ -136,6 +139,10 @@ public:
 
    void calculate_activations(const Tensor<type, 2>& combinations_2d, Tensor<type, 2>& activations_2d) const;
 
+   void calculate_activations_derivatives(const Tensor<type, 2>& combinations_2d,
+                                          Tensor<type, 2>& activations,
+                                          Tensor<type, 2>& activations_derivatives) const;
+
    void calculate_activations_derivatives(const Tensor<type, 2>& combinations_2d,
                                           Tensor<type, 2>& activations,
                                           Tensor<type, 3>& activations_derivatives) const;
@@ -148,7 +155,7 @@ public:
    void forward_propagate(const Tensor<type, 2>& inputs, ForwardPropagation& forward_propagation) const;
 
    void forward_propagate(const Tensor<type, 2>& inputs,
-                                      Tensor<type, 1> potential_parameters,
+                                      const TensorMap<Tensor<type, 1>>& potential_parameters,
                                       ForwardPropagation& forward_propagation) const;
 
    void calculate_output_delta(ForwardPropagation& forward_propagation,
@@ -178,6 +185,8 @@ public:
    string write_combinations_c() const;
    string write_activations_c() const;
 
+   string write_batch_expression_c() const;
+
    string write_expression_python() const;
    string write_combinations_python() const;
    string write_activations_python() const;
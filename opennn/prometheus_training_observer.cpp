@@ -0,0 +1,377 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   P R O M E T H E U S   T R A I N I N G   O B S E R V E R   C L A S S
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#include "prometheus_training_observer.h"
+
+#ifndef _WIN32
+
+#include <cstring>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#endif
+
+namespace OpenNN
+{
+
+/// Constructor. It binds the server to the local host and starts the server thread.
+/// @param new_port Port of the server, or 0 for an ephemeral port.
+/// @param new_maximum_queue_size Maximum number of pending events.
+
+PrometheusTrainingObserver::PrometheusTrainingObserver(const int& new_port, const Index& new_maximum_queue_size)
+    : AsyncTrainingObserver(new_maximum_queue_size)
+{
+    serving = false;
+
+    ostringstream buffer;
+
+    buffer << "OpenNN Exception: PrometheusTrainingObserver class.\n"
+           << "explicit PrometheusTrainingObserver(const int&, const Index&) constructor.\n";
+
+#ifdef _WIN32
+
+    stop();
+
+    buffer << "The metrics server is not supported on this platform.\n";
+
+    throw logic_error(buffer.str());
+
+#else
+
+    if(new_port < 0 || new_port > 65535)
+    {
+        stop();
+
+        buffer << "Port (" << new_port << ") must be between 0 and 65535.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    listening_socket = socket(AF_INET, SOCK_STREAM, 0);
+
+    if(listening_socket < 0)
+    {
+        stop();
+
+        buffer << "Cannot create socket.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    const int reuse_address = 1;
+
+    setsockopt(listening_socket, SOL_SOCKET, SO_REUSEADDR, &reuse_address, sizeof(reuse_address));
+
+    sockaddr_in address;
+
+    memset(&address, 0, sizeof(address));
+
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(static_cast<uint16_t>(new_port));
+
+    socklen_t address_length = sizeof(address);
+
+    if(::bind(listening_socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0
+    || listen(listening_socket, 16) < 0
+    || getsockname(listening_socket, reinterpret_cast<sockaddr*>(&address), &address_length) < 0)
+    {
+        close_server();
+
+        stop();
+
+        buffer << "Cannot listen on port " << new_port << ".\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    port = ntohs(address.sin_port);
+
+    serving = true;
+
+    server = thread(&PrometheusTrainingObserver::serve, this);
+
+#endif
+}
+
+
+/// Destructor. It stops the server and the worker thread.
+
+PrometheusTrainingObserver::~PrometheusTrainingObserver()
+{
+    serving = false;
+
+    if(server.joinable()) server.join();
+
+    close_server();
+
+    stop();
+}
+
+
+/// Returns the port on which the server listens.
+
+int PrometheusTrainingObserver::get_port() const
+{
+    return port;
+}
+
+
+/// Writes the latest metrics in the Prometheus text exposition format. NaN values are written as NaN.
+/// @param stream Output stream.
+
+void PrometheusTrainingObserver::write_metrics(ostream& stream) const
+{
+    Metrics metrics;
+    string algorithm;
+    bool is_training;
+    Index epochs;
+    Index trainings;
+
+    {
+        lock_guard<mutex> lock(metrics_mutex);
+
+        metrics = last_metrics;
+        algorithm = optimization_algorithm_type;
+        is_training = training;
+        epochs = epochs_total;
+        trainings = trainings_total;
+    }
+
+    const streamsize precision = stream.precision(10);
+
+    stream << "# HELP opennn_training_info Optimization algorithm of the current or last training.\n"
+           << "# TYPE opennn_training_info gauge\n"
+           << "opennn_training_info{optimization_algorithm=\"" << algorithm << "\"} 1\n";
+
+    stream << "# HELP opennn_training_running Whether a training is running.\n"
+           << "# TYPE opennn_training_running gauge\n"
+           << "opennn_training_running " << (is_training ? 1 : 0) << "\n";
+
+    stream << "# HELP opennn_trainings_total Number of trainings ended.\n"
+           << "# TYPE opennn_trainings_total counter\n"
+           << "opennn_trainings_total " << trainings << "\n";
+
+    stream << "# HELP opennn_training_epochs_total Number of epochs ended.\n"
+           << "# TYPE opennn_training_epochs_total counter\n"
+           << "opennn_training_epochs_total " << epochs << "\n";
+
+    stream << "# HELP opennn_training_epoch Epoch of the latest metrics.\n"
+           << "# TYPE opennn_training_epoch gauge\n"
+           << "opennn_training_epoch " << metrics.epoch << "\n";
+
+    stream << "# HELP opennn_training_iterations Iterations since the beginning of the training.\n"
+           << "# TYPE opennn_training_iterations gauge\n"
+           << "opennn_training_iterations " << metrics.iterations_number << "\n";
+
+    const Index gauges_number = 7;
+
+    const string gauges_names[gauges_number] = {"opennn_training_loss",
+                                                "opennn_training_error",
+                                                "opennn_training_selection_error",
+                                                "opennn_training_gradient_norm",
+                                                "opennn_training_learning_rate",
+                                                "opennn_training_instances_per_second",
+                                                "opennn_training_elapsed_seconds"};
+
+    const string gauges_descriptions[gauges_number] = {"Training loss.",
+                                                       "Training error.",
+                                                       "Selection error of the latest epoch.",
+                                                       "Norm of the loss gradient.",
+                                                       "Learning rate.",
+                                                       "Instances processed per second.",
+                                                       "Time since the beginning of the training, in seconds."};
+
+    const type gauges_values[gauges_number] = {metrics.training_loss,
+                                               metrics.training_error,
+                                               metrics.selection_error,
+                                               metrics.gradient_norm,
+                                               metrics.learning_rate,
+                                               metrics.instances_per_second,
+                                               metrics.elapsed_time};
+
+    for(Index i = 0; i < gauges_number; i++)
+    {
+        stream << "# HELP " << gauges_names[i] << " " << gauges_descriptions[i] << "\n"
+               << "# TYPE " << gauges_names[i] << " gauge\n"
+               << gauges_names[i] << " ";
+
+        write_number(stream, gauges_values[i], "NaN");
+
+        stream << "\n";
+    }
+
+    stream << "# HELP opennn_training_dropped_events_total Iteration events dropped because the queue was full.\n"
+           << "# TYPE opennn_training_dropped_events_total counter\n"
+           << "opennn_training_dropped_events_total " << get_dropped_events_number() << "\n";
+
+    stream.precision(precision);
+}
+
+
+/// Updates the latest metrics with an event.
+
+void PrometheusTrainingObserver::write_event(const Event& event)
+{
+    lock_guard<mutex> lock(metrics_mutex);
+
+    switch(event.type)
+    {
+    case TrainingBegin:
+
+        optimization_algorithm_type = event.text;
+        last_metrics = Metrics();
+        training = true;
+
+        return;
+
+    case Iteration:
+
+        last_metrics.epoch = event.metrics.epoch;
+        last_metrics.iteration = event.metrics.iteration;
+        last_metrics.iterations_number = event.metrics.iterations_number;
+        last_metrics.training_loss = event.metrics.training_loss;
+        last_metrics.training_error = event.metrics.training_error;
+        last_metrics.gradient_norm = event.metrics.gradient_norm;
+        last_metrics.learning_rate = event.metrics.learning_rate;
+        last_metrics.instances_per_second = event.metrics.instances_per_second;
+        last_metrics.elapsed_time = event.metrics.elapsed_time;
+
+        return;
+
+    case Epoch:
+
+        last_metrics = event.metrics;
+        epochs_total++;
+
+        return;
+
+    case TrainingEnd:
+
+        last_metrics = event.metrics;
+        training = false;
+        trainings_total++;
+
+        return;
+    }
+}
+
+
+/// Loop of the server thread. It answers each connection with the latest metrics and closes it.
+/// The listening socket is polled with a timeout, so that the thread notices when the server is stopped.
+
+void PrometheusTrainingObserver::serve()
+{
+#ifndef _WIN32
+
+    while(serving)
+    {
+        pollfd poll_descriptor;
+
+        poll_descriptor.fd = listening_socket;
+        poll_descriptor.events = POLLIN;
+        poll_descriptor.revents = 0;
+
+        if(poll(&poll_descriptor, 1, 100) <= 0) continue;
+
+        const int client_socket = accept(listening_socket, nullptr, nullptr);
+
+        if(client_socket < 0) continue;
+
+        // Read the request, which is not needed to answer it
+
+        pollfd client_descriptor;
+
+        client_descriptor.fd = client_socket;
+        client_descriptor.events = POLLIN;
+        client_descriptor.revents = 0;
+
+        char request[4096];
+
+        if(poll(&client_descriptor, 1, 1000) > 0)
+        {
+            recv(client_socket, request, sizeof(request), 0);
+        }
+
+        ostringstream body;
+
+        write_metrics(body);
+
+        ostringstream response;
+
+        response << "HTTP/1.1 200 OK\r\n"
+                 << "Content-Type: text/plain; version=0.0.4\r\n"
+                 << "Content-Length: " << body.str().size() << "\r\n"
+                 << "Connection: close\r\n\r\n"
+                 << body.str();
+
+        const string response_string = response.str();
+
+#ifdef MSG_NOSIGNAL
+        const int flags = MSG_NOSIGNAL;
+#else
+        const int flags = 0;
+#endif
+
+        size_t sent_bytes = 0;
+
+        while(sent_bytes < response_string.size())
+        {
+            const ssize_t result = send(client_socket, response_string.data() + sent_bytes, response_string.size() - sent_bytes, flags);
+
+            if(result <= 0) break;
+
+            sent_bytes += static_cast<size_t>(result);
+        }
+
+        close(client_socket);
+    }
+
+#endif
+}
+
+
+/// Closes the listening socket.
+
+void PrometheusTrainingObserver::close_server()
+{
+#ifndef _WIN32
+
+    if(listening_socket >= 0)
+    {
+        close(listening_socket);
+
+        listening_socket = -1;
+    }
+
+#endif
+}
+
+}
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
@@ -0,0 +1,132 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   P R O M E T H E U S   T R A I N I N G   O B S E R V E R   C L A S S   H E A D E R
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#ifndef PROMETHEUSTRAININGOBSERVER_H
+#define PROMETHEUSTRAININGOBSERVER_H
+
+// System includes
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// OpenNN includes
+
+#include "config.h"
+#include "async_training_observer.h"
+
+using namespace std;
+using namespace Eigen;
+
+namespace OpenNN
+{
+
+/// This class serves the latest training metrics in the Prometheus text format over HTTP on the local host.
+
+///
+/// The metrics are kept by the worker thread of the observer and served by a server thread which listens on 127.0.0.1,
+/// so that neither the scrapes nor the slow clients reach the training thread. Any path is answered with the metrics.
+/// The port 0 binds an ephemeral port, which is returned by get_port().
+/// The server is only available on POSIX systems.
+
+class PrometheusTrainingObserver : public AsyncTrainingObserver
+{
+
+public:
+
+   // Constructors
+
+   explicit PrometheusTrainingObserver(const int& = 0, const Index& = 10000);
+
+   // Destructor
+
+   virtual ~PrometheusTrainingObserver();
+
+   // Get methods
+
+   int get_port() const;
+
+   // Serialization methods
+
+   void write_metrics(ostream&) const;
+
+protected:
+
+   void write_event(const Event&);
+
+private:
+
+   void serve();
+
+   void close_server();
+
+   // MEMBERS
+
+   /// Port on which the server listens.
+
+   int port = 0;
+
+   /// Socket on which the server listens, or -1 if it is closed.
+
+   int listening_socket = -1;
+
+   /// True until the server is stopped.
+
+   atomic<bool> serving;
+
+   /// Server thread.
+
+   thread server;
+
+   /// Mutex of the metrics.
+
+   mutable mutex metrics_mutex;
+
+   /// Metrics of the latest iteration or epoch.
+
+   Metrics last_metrics;
+
+   /// Optimization algorithm of the current training.
+
+   string optimization_algorithm_type;
+
+   /// True between the beginning and the end of a training.
+
+   bool training = false;
+
+   /// Number of epochs ended since the observer was created.
+
+   Index epochs_total = 0;
+
+   /// Number of trainings ended since the observer was created.
+
+   Index trainings_total = 0;
+};
+
+}
+
+#endif
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
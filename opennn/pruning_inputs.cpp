@@ -264,6 +264,8 @@ PruningInputs::PruningInputsResults* PruningInputs::perform_inputs_selection()
     time_t beginning_time, current_time;
     type elapsed_time = 0;
 
+    training_scheduler.set_training_strategy_pointer(training_strategy_pointer);
+
     time(&beginning_time);
 
     bool end_algorithm = false;
@@ -272,6 +274,8 @@ PruningInputs::PruningInputsResults* PruningInputs::perform_inputs_selection()
 
     if(used_columns_number < maximum_iterations_number) maximum_iterations_number = used_columns_number;
 
+    Tensor<type, 1> previous_parameters;
+
     for(Index iteration = 0; iteration < maximum_iterations_number; iteration++)
     {
         OptimizationAlgorithm::Results training_results;
@@ -283,20 +287,16 @@ PruningInputs::PruningInputsResults* PruningInputs::perform_inputs_selection()
         Index column_index;
         string column_name;
 
-        if(iteration == 0)
-        {
-            training_results = training_strategy_pointer->perform_training();
+        Tensor<Tensor<type, 1>, 1> initial_parameters;
 
-            current_training_error = training_results.final_training_error;
-            current_selection_error = training_results.final_selection_error;
-            current_parameters = training_results.final_parameters;
-        }
-        else
+        if(iteration != 0)
         {
             column_index = correlations_ascending_indices[iteration-1];
 
             column_name = used_columns_names[column_index];
 
+            const Tensor<Index, 1> previous_input_variables_indices = data_set_pointer->get_input_variables_indices();
+
             data_set_pointer->set_column_use(column_name, DataSet::UnusedVariable);
 
             current_columns_indices = delete_result(column_index, current_columns_indices);
@@ -305,17 +305,38 @@ PruningInputs::PruningInputsResults* PruningInputs::perform_inputs_selection()
 
             data_set_pointer->set_input_variables_dimensions({input_variables_number});
 
-            neural_network_pointer->set_inputs_number(input_variables_number);
+            // Warm start
 
-            // Trial
+            if(warm_start)
+            {
+                neural_network_pointer->set_parameters(previous_parameters);
 
-            training_results = training_strategy_pointer->perform_training();
+                neural_network_pointer->resize_inputs(get_inputs_indices(previous_input_variables_indices,
+                                                                         data_set_pointer->get_input_variables_indices()));
 
-            current_training_error = training_results.final_training_error;
-            current_selection_error = training_results.final_selection_error;
-            current_parameters = training_results.final_parameters;
+                initial_parameters.resize(1);
+                initial_parameters(0) = neural_network_pointer->get_parameters();
+            }
+            else
+            {
+                neural_network_pointer->set_inputs_number(input_variables_number);
+            }
         }
 
+        // Trials
+
+        Tensor<Tensor<DataSet::VariableUse, 1>, 1> columns_uses(1);
+
+        columns_uses(0) = data_set_pointer->get_columns_uses();
+
+        training_results = perform_trials(columns_uses, initial_parameters)(0);
+
+        current_training_error = training_results.final_training_error;
+        current_selection_error = training_results.final_selection_error;
+        current_parameters = training_results.final_parameters;
+
+        previous_parameters = current_parameters;
+
 
         if(display)
         {
@@ -653,6 +674,18 @@ tinyxml2::XMLDocument* PruningInputs::to_XML() const
         element->LinkEndChild(text);
     }
 
+    // Warm start
+    {
+        element = document->NewElement("WarmStart");
+        root_element->LinkEndChild(element);
+
+        buffer.str("");
+        buffer << warm_start;
+
+        text = document->NewText(buffer.str().c_str());
+        element->LinkEndChild(text);
+    }
+
     // Tolerance
     {
         element = document->NewElement("Tolerance");
@@ -847,6 +880,17 @@ void PruningInputs::write_XML(tinyxml2::XMLPrinter& file_stream) const
 
     file_stream.CloseElement();
 
+    // Warm start
+
+    file_stream.OpenElement("WarmStart");
+
+    buffer.str("");
+    buffer << warm_start;
+
+    file_stream.PushText(buffer.str().c_str());
+
+    file_stream.CloseElement();
+
     // Tolerance
 
     file_stream.OpenElement("Tolerance");
@@ -1031,6 +1075,25 @@ void PruningInputs::from_XML(const tinyxml2::XMLDocument& document)
         }
     }
 
+    // Warm start
+    {
+        const tinyxml2::XMLElement* element = root_element->FirstChildElement("WarmStart");
+
+        if(element)
+        {
+            const string new_warm_start = element->GetText();
+
+            try
+            {
+                set_warm_start(new_warm_start != "0");
+            }
+            catch(const logic_error& e)
+            {
+                cerr << e.what() << endl;
+            }
+        }
+    }
+
     // Reserve loss data
     {
         const tinyxml2::XMLElement* element = root_element->FirstChildElement("ReserveTrainingErrorHistory");
@@ -0,0 +1,717 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   P R U N I N G   W E I G H T S   C L A S S
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#include "pruning_weights.h"
+
+namespace OpenNN
+{
+
+/// Default constructor.
+
+PruningWeights::PruningWeights()
+{
+    set();
+}
+
+
+/// Training strategy constructor.
+/// @param new_training_strategy_pointer Pointer to a training strategy object, which has the neural network to be pruned.
+
+PruningWeights::PruningWeights(TrainingStrategy* new_training_strategy_pointer)
+{
+    set(new_training_strategy_pointer);
+}
+
+
+/// Destructor.
+
+PruningWeights::~PruningWeights()
+{
+}
+
+
+/// Returns a pointer to the training strategy object.
+
+TrainingStrategy* PruningWeights::get_training_strategy_pointer() const
+{
+#ifdef __OPENNN_DEBUG__
+
+    if(!training_strategy_pointer)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: PruningWeights class.\n"
+               << "TrainingStrategy* get_training_strategy_pointer() const method.\n"
+               << "Training strategy pointer is nullptr.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+#endif
+
+    return training_strategy_pointer;
+}
+
+
+/// Returns true if this object has a training strategy associated, and false otherwise.
+
+bool PruningWeights::has_training_strategy() const
+{
+    return training_strategy_pointer != nullptr;
+}
+
+
+/// Returns the method used to prune the neural network.
+
+const PruningWeights::PruningMethod& PruningWeights::get_pruning_method() const
+{
+    return pruning_method;
+}
+
+
+/// Returns a string with the name of the method used to prune the neural network.
+
+string PruningWeights::write_pruning_method() const
+{
+    switch(pruning_method)
+    {
+    case MagnitudePruning:
+        return "MagnitudePruning";
+
+    case NeuronsPruning:
+        return "NeuronsPruning";
+    }
+
+    return string();
+}
+
+
+/// Returns the fraction of synaptic weights or hidden neurons which are pruned.
+
+const type& PruningWeights::get_sparsity() const
+{
+    return sparsity;
+}
+
+
+/// Returns the number of consecutive inputs of a neuron which are pruned together by the magnitude pruning.
+
+const Index& PruningWeights::get_sparse_block_size() const
+{
+    return sparse_block_size;
+}
+
+
+/// Returns true if the neural network is trained after each pruning step, and false otherwise.
+
+const bool& PruningWeights::get_fine_tuning() const
+{
+    return fine_tuning;
+}
+
+
+/// Returns the number of steps in which the sparsity is reached when the neural network is fine tuned.
+
+const Index& PruningWeights::get_pruning_steps_number() const
+{
+    return pruning_steps_number;
+}
+
+
+/// Returns true if messages from this class are to be displayed on the screen,
+/// or false if messages from this class are not to be displayed on the screen.
+
+const bool& PruningWeights::get_display() const
+{
+    return display;
+}
+
+
+/// Sets a pruning object not associated to any training strategy.
+
+void PruningWeights::set()
+{
+    training_strategy_pointer = nullptr;
+
+    set_default();
+}
+
+
+/// Sets a pruning object associated to a training strategy.
+/// @param new_training_strategy_pointer Pointer to a training strategy object.
+
+void PruningWeights::set(TrainingStrategy* new_training_strategy_pointer)
+{
+    training_strategy_pointer = new_training_strategy_pointer;
+
+    set_default();
+}
+
+
+/// Sets the members of the pruning object to their default values:
+/// <ul>
+/// <li> Pruning method: Magnitude pruning.
+/// <li> Sparsity: 0.9.
+/// <li> Sparse block size: 4.
+/// <li> Fine tuning: True.
+/// <li> Pruning steps number: 5.
+/// <li> Display: True.
+/// </ul>
+
+void PruningWeights::set_default()
+{
+    pruning_method = MagnitudePruning;
+
+    sparsity = static_cast<type>(0.9);
+
+    sparse_block_size = 4;
+
+    fine_tuning = true;
+
+    pruning_steps_number = 5;
+
+    display = true;
+}
+
+
+/// Sets a new training strategy pointer.
+/// @param new_training_strategy_pointer Pointer to a training strategy object.
+
+void PruningWeights::set_training_strategy_pointer(TrainingStrategy* new_training_strategy_pointer)
+{
+    training_strategy_pointer = new_training_strategy_pointer;
+}
+
+
+/// Sets a new method to prune the neural network.
+/// @param new_pruning_method Pruning method.
+
+void PruningWeights::set_pruning_method(const PruningMethod& new_pruning_method)
+{
+    pruning_method = new_pruning_method;
+}
+
+
+/// Sets a new method to prune the neural network from a string.
+/// @param new_pruning_method Name of the pruning method ("MagnitudePruning" or "NeuronsPruning").
+
+void PruningWeights::set_pruning_method(const string& new_pruning_method)
+{
+    if(new_pruning_method == "MagnitudePruning")
+    {
+        pruning_method = MagnitudePruning;
+    }
+    else if(new_pruning_method == "NeuronsPruning")
+    {
+        pruning_method = NeuronsPruning;
+    }
+    else
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: PruningWeights class.\n"
+               << "void set_pruning_method(const string&) method.\n"
+               << "Unknown pruning method: " << new_pruning_method << ".\n";
+
+        throw logic_error(buffer.str());
+    }
+}
+
+
+/// Sets the fraction of synaptic weights or hidden neurons which are pruned.
+/// @param new_sparsity Sparsity, between 0 and 1.
+
+void PruningWeights::set_sparsity(const type& new_sparsity)
+{
+#ifdef __OPENNN_DEBUG__
+
+    if(new_sparsity < 0 || new_sparsity >= 1)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: PruningWeights class.\n"
+               << "void set_sparsity(const type&) method.\n"
+               << "Sparsity (" << new_sparsity << ") must be equal or greater than 0 and less than 1.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+#endif
+
+    sparsity = new_sparsity;
+}
+
+
+/// Sets the number of consecutive inputs of a neuron which are pruned together by the magnitude pruning.
+/// @param new_sparse_block_size Number of inputs in each block.
+
+void PruningWeights::set_sparse_block_size(const Index& new_sparse_block_size)
+{
+#ifdef __OPENNN_DEBUG__
+
+    if(new_sparse_block_size < 1)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: PruningWeights class.\n"
+               << "void set_sparse_block_size(const Index&) method.\n"
+               << "Sparse block size (" << new_sparse_block_size << ") must be greater than 0.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+#endif
+
+    sparse_block_size = new_sparse_block_size;
+}
+
+
+/// Sets whether the neural network is trained after each pruning step.
+/// @param new_fine_tuning True to fine tune the neural network, and false otherwise.
+
+void PruningWeights::set_fine_tuning(const bool& new_fine_tuning)
+{
+    fine_tuning = new_fine_tuning;
+}
+
+
+/// Sets the number of steps in which the sparsity is reached when the neural network is fine tuned.
+/// @param new_pruning_steps_number Number of pruning steps.
+
+void PruningWeights::set_pruning_steps_number(const Index& new_pruning_steps_number)
+{
+#ifdef __OPENNN_DEBUG__
+
+    if(new_pruning_steps_number < 1)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: PruningWeights class.\n"
+               << "void set_pruning_steps_number(const Index&) method.\n"
+               << "Number of pruning steps (" << new_pruning_steps_number << ") must be greater than 0.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+#endif
+
+    pruning_steps_number = new_pruning_steps_number;
+}
+
+
+/// Sets a new display value.
+/// If it is set to true messages from this class are to be displayed on the screen;
+/// if it is set to false messages from this class are not to be displayed on the screen.
+/// @param new_display Display value.
+
+void PruningWeights::set_display(const bool& new_display)
+{
+    display = new_display;
+}
+
+
+/// Prunes the blocks of synaptic weights with the smallest magnitude in each perceptron layer of the neural network.
+/// @param new_sparsity Fraction of synaptic weights which are pruned in each layer.
+
+void PruningWeights::prune_synaptic_weights(const type& new_sparsity) const
+{
+    NeuralNetwork* neural_network_pointer = training_strategy_pointer->get_neural_network_pointer();
+
+    const Index trainable_layers_number = neural_network_pointer->get_trainable_layers_number();
+
+    const Tensor<Layer*, 1> trainable_layers_pointers = neural_network_pointer->get_trainable_layers_pointers();
+
+    for(Index i = 0; i < trainable_layers_number; i++)
+    {
+        if(trainable_layers_pointers(i)->get_type() != Layer::Perceptron) continue;
+
+        PerceptronLayer* perceptron_layer_pointer = static_cast<PerceptronLayer*>(trainable_layers_pointers(i));
+
+        perceptron_layer_pointer->set_sparse_block_size(sparse_block_size);
+
+        perceptron_layer_pointer->prune_synaptic_weights(new_sparsity);
+    }
+}
+
+
+/// Removes the hidden neurons with the smallest incoming and outgoing synaptic weights in each hidden perceptron layer.
+/// The importance of a neuron is the norm of its synaptic weights times the norm of the synaptic weights of the next layer from it.
+/// @param new_sparsity Fraction of the initial neurons which are removed in each layer.
+/// @param initial_neurons_numbers Number of neurons of each trainable layer before the pruning.
+
+void PruningWeights::prune_neurons(const type& new_sparsity, const Tensor<Index, 1>& initial_neurons_numbers) const
+{
+    NeuralNetwork* neural_network_pointer = training_strategy_pointer->get_neural_network_pointer();
+
+    const Index trainable_layers_number = neural_network_pointer->get_trainable_layers_number();
+
+    for(Index i = 0; i < trainable_layers_number-1; i++)
+    {
+        const Tensor<Layer*, 1> trainable_layers_pointers = neural_network_pointer->get_trainable_layers_pointers();
+
+        if(trainable_layers_pointers(i)->get_type() != Layer::Perceptron) continue;
+
+        const Index neurons_number = trainable_layers_pointers(i)->get_neurons_number();
+
+        const Index kept_neurons_number
+                = max(static_cast<Index>(1), static_cast<Index>(round((1 - new_sparsity)*static_cast<type>(initial_neurons_numbers(i)))));
+
+        if(kept_neurons_number >= neurons_number) continue;
+
+        // Importance of the neurons
+
+        const PerceptronLayer* perceptron_layer_pointer = static_cast<PerceptronLayer*>(trainable_layers_pointers(i));
+
+        const Eigen::array<Index, 1> rows = {0};
+
+        const Tensor<type, 1> inputs_norms = perceptron_layer_pointer->get_synaptic_weights().square().sum(rows).sqrt();
+
+        Tensor<type, 1> outputs_norms(neurons_number);
+        outputs_norms.setConstant(1);
+
+        const Eigen::array<Index, 1> columns = {1};
+
+        if(trainable_layers_pointers(i+1)->get_type() == Layer::Perceptron)
+        {
+            const PerceptronLayer* next_layer_pointer = static_cast<PerceptronLayer*>(trainable_layers_pointers(i+1));
+
+            outputs_norms = next_layer_pointer->get_synaptic_weights().square().sum(columns).sqrt();
+        }
+        else if(trainable_layers_pointers(i+1)->get_type() == Layer::Probabilistic)
+        {
+            const ProbabilisticLayer* next_layer_pointer = static_cast<ProbabilisticLayer*>(trainable_layers_pointers(i+1));
+
+            outputs_norms = next_layer_pointer->get_synaptic_weights().square().sum(columns).sqrt();
+        }
+
+        const Tensor<type, 1> importances = inputs_norms*outputs_norms;
+
+        vector<Index> neurons_indices(static_cast<size_t>(neurons_number));
+
+        iota(neurons_indices.begin(), neurons_indices.end(), 0);
+
+        nth_element(neurons_indices.begin(), neurons_indices.begin() + kept_neurons_number, neurons_indices.end(),
+                    [&](const Index& a, const Index& b){return importances(a) > importances(b);});
+
+        sort(neurons_indices.begin(), neurons_indices.begin() + kept_neurons_number);
+
+        Tensor<Index, 1> kept_neurons_indices(kept_neurons_number);
+
+        copy(neurons_indices.begin(), neurons_indices.begin() + kept_neurons_number, kept_neurons_indices.data());
+
+        neural_network_pointer->select_hidden_neurons(i, kept_neurons_indices);
+    }
+}
+
+
+/// Prunes the neural network of the training strategy.
+/// If fine tuning is enabled, the sparsity is increased in several steps, and the neural network is trained after each step.
+/// The pruned synaptic weights are kept at zero during the training.
+
+PruningWeights::PruningWeightsResults PruningWeights::perform_weights_pruning()
+{
+#ifdef __OPENNN_DEBUG__
+
+    if(!training_strategy_pointer)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: PruningWeights class.\n"
+               << "PruningWeightsResults perform_weights_pruning() method.\n"
+               << "Training strategy pointer is nullptr.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+#endif
+
+    PruningWeightsResults results;
+
+    time_t beginning_time, current_time;
+
+    time(&beginning_time);
+
+    NeuralNetwork* neural_network_pointer = training_strategy_pointer->get_neural_network_pointer();
+
+    const Index trainable_layers_number = neural_network_pointer->get_trainable_layers_number();
+
+    const Tensor<Layer*, 1> initial_trainable_layers_pointers = neural_network_pointer->get_trainable_layers_pointers();
+
+    Tensor<Index, 1> initial_neurons_numbers(trainable_layers_number);
+
+    for(Index i = 0; i < trainable_layers_number; i++)
+    {
+        initial_neurons_numbers(i) = initial_trainable_layers_pointers(i)->get_neurons_number();
+    }
+
+    results.initial_parameters_number = neural_network_pointer->get_parameters_number();
+
+    results.initial_selection_error = calculate_selection_error();
+
+    if(display) cout << "Performing " << write_pruning_method() << "..." << endl;
+
+    const Index steps_number = fine_tuning ? pruning_steps_number : 1;
+
+    for(Index step = 1; step <= steps_number; step++)
+    {
+        const type step_sparsity = sparsity*static_cast<type>(step)/static_cast<type>(steps_number);
+
+        if(pruning_method == MagnitudePruning)
+        {
+            prune_synaptic_weights(step_sparsity);
+        }
+        else
+        {
+            prune_neurons(step_sparsity, initial_neurons_numbers);
+        }
+
+        if(fine_tuning) training_strategy_pointer->perform_training();
+
+        if(display)
+        {
+            cout << "Pruning step " << step << " of " << steps_number << endl
+                 << "Sparsity: " << step_sparsity << endl
+                 << "Parameters number: " << neural_network_pointer->get_parameters_number() << endl;
+        }
+    }
+
+    // Results
+
+    const Tensor<Layer*, 1> trainable_layers_pointers = neural_network_pointer->get_trainable_layers_pointers();
+
+    Index synaptic_weights_number = 0;
+
+    for(Index i = 0; i < trainable_layers_number; i++)
+    {
+        if(trainable_layers_pointers(i)->get_type() != Layer::Perceptron) continue;
+
+        const PerceptronLayer* perceptron_layer_pointer = static_cast<PerceptronLayer*>(trainable_layers_pointers(i));
+
+        synaptic_weights_number += perceptron_layer_pointer->get_synaptic_weights_number();
+
+        results.pruned_synaptic_weights_number += perceptron_layer_pointer->get_pruned_synaptic_weights_number();
+    }
+
+    if(synaptic_weights_number != 0)
+    {
+        results.sparsity = static_cast<type>(results.pruned_synaptic_weights_number)/static_cast<type>(synaptic_weights_number);
+    }
+
+    results.final_parameters_number = neural_network_pointer->get_parameters_number();
+
+    results.final_selection_error = calculate_selection_error();
+
+    time(&current_time);
+
+    results.elapsed_time = static_cast<type>(difftime(current_time, beginning_time));
+
+    if(display) results.print();
+
+    return results;
+}
+
+
+/// Returns the normalized squared error of the neural network on the selection instances,
+/// or zero if the data set has no selection instances.
+
+type PruningWeights::calculate_selection_error() const
+{
+    NeuralNetwork* neural_network_pointer = training_strategy_pointer->get_neural_network_pointer();
+
+    DataSet* data_set_pointer = training_strategy_pointer->get_loss_index_pointer()->get_data_set_pointer();
+
+    if(data_set_pointer->get_selection_instances_number() == 0) return 0;
+
+    TestingAnalysis testing_analysis(neural_network_pointer, data_set_pointer);
+
+    return testing_analysis.calculate_selection_errors()(3);
+}
+
+
+/// Prints the results of the pruning to the screen.
+
+void PruningWeights::PruningWeightsResults::print() const
+{
+    cout << "Initial parameters number: " << initial_parameters_number << endl;
+    cout << "Final parameters number: " << final_parameters_number << endl;
+    cout << "Pruned synaptic weights number: " << pruned_synaptic_weights_number << endl;
+    cout << "Sparsity: " << sparsity << endl;
+    cout << "Initial selection error: " << initial_selection_error << endl;
+    cout << "Final selection error: " << final_selection_error << endl;
+    cout << "Elapsed time: " << elapsed_time << endl;
+}
+
+
+/// Loads the members of the pruning object from a XML document.
+/// @param document TinyXML document with the member data.
+
+void PruningWeights::from_XML(const tinyxml2::XMLDocument& document)
+{
+    const tinyxml2::XMLElement* root_element = document.FirstChildElement("PruningWeights");
+
+    if(!root_element)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: PruningWeights class.\n"
+               << "void from_XML(const tinyxml2::XMLDocument&) method.\n"
+               << "PruningWeights element is nullptr.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    // Pruning method
+
+    const tinyxml2::XMLElement* pruning_method_element = root_element->FirstChildElement("PruningMethod");
+
+    if(pruning_method_element && pruning_method_element->GetText())
+    {
+        set_pruning_method(pruning_method_element->GetText());
+    }
+
+    // Sparsity
+
+    const tinyxml2::XMLElement* sparsity_element = root_element->FirstChildElement("Sparsity");
+
+    if(sparsity_element && sparsity_element->GetText())
+    {
+        set_sparsity(static_cast<type>(atof(sparsity_element->GetText())));
+    }
+
+    // Sparse block size
+
+    const tinyxml2::XMLElement* sparse_block_size_element = root_element->FirstChildElement("SparseBlockSize");
+
+    if(sparse_block_size_element && sparse_block_size_element->GetText())
+    {
+        set_sparse_block_size(static_cast<Index>(atoi(sparse_block_size_element->GetText())));
+    }
+
+    // Fine tuning
+
+    const tinyxml2::XMLElement* fine_tuning_element = root_element->FirstChildElement("FineTuning");
+
+    if(fine_tuning_element && fine_tuning_element->GetText())
+    {
+        set_fine_tuning(fine_tuning_element->GetText() != string("0"));
+    }
+
+    // Pruning steps number
+
+    const tinyxml2::XMLElement* pruning_steps_number_element = root_element->FirstChildElement("PruningStepsNumber");
+
+    if(pruning_steps_number_element && pruning_steps_number_element->GetText())
+    {
+        set_pruning_steps_number(static_cast<Index>(atoi(pruning_steps_number_element->GetText())));
+    }
+
+    // Display
+
+    const tinyxml2::XMLElement* display_element = root_element->FirstChildElement("Display");
+
+    if(display_element && display_element->GetText())
+    {
+        set_display(display_element->GetText() != string("0"));
+    }
+}
+
+
+/// Serializes the pruning object into a XML document of the TinyXML library without keep the DOM tree in memory.
+/// See the OpenNN manual for more information about the format of this document.
+
+void PruningWeights::write_XML(tinyxml2::XMLPrinter& file_stream) const
+{
+    ostringstream buffer;
+
+    file_stream.OpenElement("PruningWeights");
+
+    // Pruning method
+
+    file_stream.OpenElement("PruningMethod");
+
+    file_stream.PushText(write_pruning_method().c_str());
+
+    file_stream.CloseElement();
+
+    // Sparsity
+
+    file_stream.OpenElement("Sparsity");
+
+    buffer.str("");
+    buffer << sparsity;
+
+    file_stream.PushText(buffer.str().c_str());
+
+    file_stream.CloseElement();
+
+    // Sparse block size
+
+    file_stream.OpenElement("SparseBlockSize");
+
+    buffer.str("");
+    buffer << sparse_block_size;
+
+    file_stream.PushText(buffer.str().c_str());
+
+    file_stream.CloseElement();
+
+    // Fine tuning
+
+    file_stream.OpenElement("FineTuning");
+
+    buffer.str("");
+    buffer << fine_tuning;
+
+    file_stream.PushText(buffer.str().c_str());
+
+    file_stream.CloseElement();
+
+    // Pruning steps number
+
+    file_stream.OpenElement("PruningStepsNumber");
+
+    buffer.str("");
+    buffer << pruning_steps_number;
+
+    file_stream.PushText(buffer.str().c_str());
+
+    file_stream.CloseElement();
+
+    // Display
+
+    file_stream.OpenElement("Display");
+
+    buffer.str("");
+    buffer << display;
+
+    file_stream.PushText(buffer.str().c_str());
+
+    file_stream.CloseElement();
+
+    file_stream.CloseElement();
+}
+
+}
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
@@ -0,0 +1,203 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   P R U N I N G   W E I G H T S   C L A S S   H E A D E R
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#ifndef PRUNINGWEIGHTS_H
+#define PRUNINGWEIGHTS_H
+
+// System includes
+
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <sstream>
+#include <vector>
+
+// OpenNN includes
+
+#include "config.h"
+#include "training_strategy.h"
+#include "testing_analysis.h"
+
+namespace OpenNN
+{
+
+/// This class prunes the connections of the perceptron layers of a trained neural network.
+
+///
+/// The magnitude pruning sets to zero the blocks of synaptic weights with the smallest magnitude,
+/// and the pruned perceptron layers then calculate their outputs with the blocks which are kept.
+/// The neurons pruning removes the hidden neurons whose incoming and outgoing synaptic weights are the smallest.
+/// The pruning can be done in several steps, with the neural network trained by the training strategy after each step.
+
+class PruningWeights
+{
+
+public:
+
+   /// Enumeration of available pruning methods.
+
+   enum PruningMethod{MagnitudePruning, NeuronsPruning};
+
+   // Constructors
+
+   explicit PruningWeights();
+
+   explicit PruningWeights(TrainingStrategy*);
+
+   // Destructor
+
+   virtual ~PruningWeights();
+
+   /// This structure contains the results of the pruning.
+
+   struct PruningWeightsResults
+   {
+       /// Number of parameters of the neural network before the pruning.
+
+       Index initial_parameters_number = 0;
+
+       /// Number of parameters of the neural network after the pruning.
+
+       Index final_parameters_number = 0;
+
+       /// Number of synaptic weights of the perceptron layers which are pruned.
+
+       Index pruned_synaptic_weights_number = 0;
+
+       /// Fraction of synaptic weights of the perceptron layers which are pruned.
+
+       type sparsity = 0;
+
+       /// Normalized squared error on the selection instances before the pruning.
+
+       type initial_selection_error = 0;
+
+       /// Normalized squared error on the selection instances after the pruning.
+
+       type final_selection_error = 0;
+
+       /// Elapsed time of the pruning process.
+
+       type elapsed_time = 0;
+
+       void print() const;
+   };
+
+   // Get methods
+
+   TrainingStrategy* get_training_strategy_pointer() const;
+
+   bool has_training_strategy() const;
+
+   const PruningMethod& get_pruning_method() const;
+   string write_pruning_method() const;
+
+   const type& get_sparsity() const;
+
+   const Index& get_sparse_block_size() const;
+
+   const bool& get_fine_tuning() const;
+
+   const Index& get_pruning_steps_number() const;
+
+   const bool& get_display() const;
+
+   // Set methods
+
+   void set();
+   void set(TrainingStrategy*);
+
+   void set_default();
+
+   void set_training_strategy_pointer(TrainingStrategy*);
+
+   void set_pruning_method(const PruningMethod&);
+   void set_pruning_method(const string&);
+
+   void set_sparsity(const type&);
+
+   void set_sparse_block_size(const Index&);
+
+   void set_fine_tuning(const bool&);
+
+   void set_pruning_steps_number(const Index&);
+
+   void set_display(const bool&);
+
+   // Pruning methods
+
+   void prune_synaptic_weights(const type&) const;
+   void prune_neurons(const type&, const Tensor<Index, 1>&) const;
+
+   PruningWeightsResults perform_weights_pruning();
+
+   // Serialization methods
+
+   void from_XML(const tinyxml2::XMLDocument&);
+   void write_XML(tinyxml2::XMLPrinter&) const;
+
+protected:
+
+   type calculate_selection_error() const;
+
+   // MEMBERS
+
+   /// Pointer to the training strategy, which has the neural network to be pruned.
+
+   TrainingStrategy* training_strategy_pointer = nullptr;
+
+   /// Method used to prune the neural network.
+
+   PruningMethod pruning_method = MagnitudePruning;
+
+   /// Fraction of synaptic weights or hidden neurons which are pruned.
+
+   type sparsity = static_cast<type>(0.9);
+
+   /// Number of consecutive inputs of a neuron which are pruned together by the magnitude pruning.
+
+   Index sparse_block_size = 4;
+
+   /// True if the neural network is trained after each pruning step, and false otherwise.
+
+   bool fine_tuning = true;
+
+   /// Number of steps in which the sparsity is reached when the neural network is fine tuned.
+
+   Index pruning_steps_number = 5;
+
+   /// Display messages to screen.
+
+   bool display = true;
+};
+
+}
+
+#endif
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
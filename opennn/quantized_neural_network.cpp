@@ -0,0 +1,991 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   Q U A N T I Z E D   N E U R A L   N E T W O R K   C L A S S
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#include "quantized_neural_network.h"
+
+// With GCC or Clang on x86-64, the AVX2 products are built for any target and chosen at run time
+// if the processor supports them. Other compilers use them only when AVX2 is enabled at compile time.
+
+#if defined(__GNUC__) && defined(__x86_64__)
+    #include <immintrin.h>
+    #define OPENNN_AVX2_TARGET __attribute__((target("avx2")))
+#elif defined(__AVX2__)
+    #include <immintrin.h>
+    #define OPENNN_AVX2_TARGET
+#endif
+
+namespace OpenNN
+{
+
+namespace
+{
+
+/// Largest absolute value of the quantized numbers.
+/// The range is symmetric, so that -128 is never used.
+
+const type quantization_limit = static_cast<type>(127);
+
+
+/// Returns the 8 bit integer nearest to value/scale, saturated to the quantization range.
+
+inline int8_t quantize_value(const type& value, const type& inverse_scale)
+{
+    const type quantized_value = round(value*inverse_scale);
+
+    if(quantized_value > quantization_limit) return static_cast<int8_t>(quantization_limit);
+    if(quantized_value < -quantization_limit) return static_cast<int8_t>(-quantization_limit);
+
+    return static_cast<int8_t>(quantized_value);
+}
+
+
+/// Returns the dot product of two vectors of 8 bit integers, accumulated in 32 bit integers.
+
+inline int32_t dot_int8_generic(const int8_t* x, const int8_t* y, const Index& size)
+{
+    int32_t sum = 0;
+
+    for(Index i = 0; i < size; i++)
+    {
+        sum += static_cast<int32_t>(x[i])*static_cast<int32_t>(y[i]);
+    }
+
+    return sum;
+}
+
+#ifdef OPENNN_AVX2_TARGET
+
+/// Returns the dot product of two vectors of 8 bit integers with AVX2, accumulated in 32 bit integers.
+/// Sixteen products are calculated at once by widening to 16 bits and multiplying and adding pairs.
+
+OPENNN_AVX2_TARGET int32_t dot_int8_avx2(const int8_t* x, const int8_t* y, const Index& size)
+{
+    __m256i sums = _mm256_setzero_si256();
+
+    Index i = 0;
+
+    for(; i + 16 <= size; i += 16)
+    {
+        const __m256i x_16 = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i)));
+        const __m256i y_16 = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(y + i)));
+
+        sums = _mm256_add_epi32(sums, _mm256_madd_epi16(x_16, y_16));
+    }
+
+    int32_t partial_sums[8];
+
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(partial_sums), sums);
+
+    int32_t sum = 0;
+
+    for(Index j = 0; j < 8; j++) sum += partial_sums[j];
+
+    return sum + dot_int8_generic(x + i, y + i, size - i);
+}
+
+
+/// Returns true if the processor running the program supports AVX2.
+
+bool is_avx2_supported()
+{
+#if defined(__GNUC__) && defined(__x86_64__)
+    __builtin_cpu_init();
+
+    return __builtin_cpu_supports("avx2") != 0;
+#else
+    return true;
+#endif
+}
+
+const bool avx2_supported = is_avx2_supported();
+
+#endif
+
+
+/// Returns the dot product of two vectors of 8 bit integers, accumulated in 32 bit integers.
+/// The AVX2 products are used if they are requested and the processor supports them.
+
+inline int32_t dot_int8(const int8_t* x, const int8_t* y, const Index& size, const bool& vectorized)
+{
+#ifdef OPENNN_AVX2_TARGET
+
+    if(vectorized && avx2_supported) return dot_int8_avx2(x, y, size);
+
+#endif
+
+    return dot_int8_generic(x, y, size);
+}
+
+}
+
+
+/// Default constructor.
+/// It creates a quantized neural network object not associated to any neural network.
+
+QuantizedNeuralNetwork::QuantizedNeuralNetwork()
+{
+    set();
+}
+
+
+/// Neural network constructor.
+/// It creates a quantized neural network object associated to a neural network, which has not been quantized yet.
+/// @param new_neural_network_pointer Pointer to the floating point neural network.
+
+QuantizedNeuralNetwork::QuantizedNeuralNetwork(NeuralNetwork* new_neural_network_pointer)
+{
+    set(new_neural_network_pointer);
+}
+
+
+/// Destructor.
+
+QuantizedNeuralNetwork::~QuantizedNeuralNetwork()
+{
+}
+
+
+/// Returns a pointer to the floating point neural network.
+
+NeuralNetwork* QuantizedNeuralNetwork::get_neural_network_pointer() const
+{
+    return neural_network_pointer;
+}
+
+
+/// Returns the quantized perceptron and probabilistic layers.
+
+const Tensor<QuantizedNeuralNetwork::QuantizedLayer, 1>& QuantizedNeuralNetwork::get_quantized_layers() const
+{
+    return quantized_layers;
+}
+
+
+/// Returns the number of quantized layers.
+
+Index QuantizedNeuralNetwork::get_quantized_layers_number() const
+{
+    return quantized_layers.size();
+}
+
+
+/// Returns the maximum number of training instances used to calibrate the inputs scales.
+
+const Index& QuantizedNeuralNetwork::get_calibration_instances_number() const
+{
+    return calibration_instances_number;
+}
+
+
+/// Returns true if the products of 8 bit integers use the AVX2 instructions when the processor supports them,
+/// and false if they are always calculated one by one.
+
+const bool& QuantizedNeuralNetwork::get_vectorized() const
+{
+    return vectorized;
+}
+
+
+/// Returns true if messages from this class are displayed on the screen, or false if messages
+/// from this class are not displayed on the screen.
+
+const bool& QuantizedNeuralNetwork::get_display() const
+{
+    return display;
+}
+
+
+/// Sets a quantized neural network object not associated to any neural network.
+
+void QuantizedNeuralNetwork::set()
+{
+    neural_network_pointer = nullptr;
+
+    quantized_layers.resize(0);
+
+    set_default();
+}
+
+
+/// Sets a quantized neural network object associated to a neural network, which has not been quantized yet.
+/// @param new_neural_network_pointer Pointer to the floating point neural network.
+
+void QuantizedNeuralNetwork::set(NeuralNetwork* new_neural_network_pointer)
+{
+    neural_network_pointer = new_neural_network_pointer;
+
+    quantized_layers.resize(0);
+
+    set_default();
+}
+
+
+/// Sets the members of this object to their default values.
+
+void QuantizedNeuralNetwork::set_default()
+{
+    calibration_instances_number = 1000;
+
+    vectorized = true;
+
+    display = true;
+}
+
+
+/// Sets a new floating point neural network.
+/// The quantized layers are kept, so that they can be loaded before or after the neural network.
+/// @param new_neural_network_pointer Pointer to the floating point neural network.
+
+void QuantizedNeuralNetwork::set_neural_network_pointer(NeuralNetwork* new_neural_network_pointer)
+{
+    neural_network_pointer = new_neural_network_pointer;
+}
+
+
+/// Sets the maximum number of training instances used to calibrate the inputs scales.
+/// @param new_calibration_instances_number Number of calibration instances.
+
+void QuantizedNeuralNetwork::set_calibration_instances_number(const Index& new_calibration_instances_number)
+{
+#ifdef __OPENNN_DEBUG__
+
+    if(new_calibration_instances_number <= 0)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: QuantizedNeuralNetwork class.\n"
+               << "void set_calibration_instances_number(const Index&) method.\n"
+               << "Number of calibration instances must be greater than zero.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+#endif
+
+    calibration_instances_number = new_calibration_instances_number;
+}
+
+
+/// Sets whether the products of 8 bit integers use the AVX2 instructions when the processor supports them.
+/// Both ways give the same outputs, as the products are accumulated exactly in 32 bit integers.
+/// @param new_vectorized True to use the AVX2 instructions, false to calculate the products one by one.
+
+void QuantizedNeuralNetwork::set_vectorized(const bool& new_vectorized)
+{
+    vectorized = new_vectorized;
+}
+
+
+/// Sets a new display value.
+/// If it is set to true messages from this class are to be displayed on the screen;
+/// if it is set to false messages from this class are not to be displayed on the screen.
+/// @param new_display Display value.
+
+void QuantizedNeuralNetwork::set_display(const bool& new_display)
+{
+    display = new_display;
+}
+
+
+/// Returns true if the layer is calculated with 8 bit integers, that is, if it is a perceptron or a probabilistic layer.
+
+bool QuantizedNeuralNetwork::is_quantizable(const Layer* layer_pointer)
+{
+    return layer_pointer->get_type() == Layer::Perceptron || layer_pointer->get_type() == Layer::Probabilistic;
+}
+
+
+/// Quantizes the perceptron and probabilistic layers of the neural network.
+/// The synaptic weights of each neuron are scaled with their maximum absolute value.
+/// The inputs of each layer are scaled with their maximum absolute value on the calibration inputs,
+/// which are propagated through the floating point neural network.
+/// @param calibration_inputs Sample of inputs to the neural network.
+
+void QuantizedNeuralNetwork::quantize(const Tensor<type, 2>& calibration_inputs)
+{
+#ifdef __OPENNN_DEBUG__
+
+    if(!neural_network_pointer)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: QuantizedNeuralNetwork class.\n"
+               << "void quantize(const Tensor<type, 2>&) method.\n"
+               << "Pointer to neural network is nullptr.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+#endif
+
+    const Tensor<Layer*, 1> layers_pointers = neural_network_pointer->get_layers_pointers();
+
+    const Index layers_number = layers_pointers.size();
+
+    Index quantized_layers_number = 0;
+
+    for(Index i = 0; i < layers_number; i++)
+    {
+        if(is_quantizable(layers_pointers(i))) quantized_layers_number++;
+    }
+
+    quantized_layers.resize(quantized_layers_number);
+
+    Tensor<type, 2> outputs = calibration_inputs;
+
+    Index quantized_layer_index = 0;
+
+    for(Index i = 0; i < layers_number; i++)
+    {
+        if(is_quantizable(layers_pointers(i)))
+        {
+            QuantizedLayer& quantized_layer = quantized_layers(quantized_layer_index);
+
+            quantized_layer.layer_index = i;
+
+            // Inputs scale
+
+            const Tensor<type, 0> maximum_input = outputs.abs().maximum();
+
+            quantized_layer.inputs_scale = maximum_input(0) > static_cast<type>(0)
+                    ? maximum_input(0)/quantization_limit
+                    : static_cast<type>(1);
+
+            // Synaptic weights and biases
+
+            const Tensor<type, 2>& synaptic_weights = layers_pointers(i)->get_type() == Layer::Perceptron
+                    ? static_cast<PerceptronLayer*>(layers_pointers(i))->get_synaptic_weights()
+                    : static_cast<ProbabilisticLayer*>(layers_pointers(i))->get_synaptic_weights();
+
+            const Tensor<type, 2>& biases = layers_pointers(i)->get_type() == Layer::Perceptron
+                    ? static_cast<PerceptronLayer*>(layers_pointers(i))->get_biases()
+                    : static_cast<ProbabilisticLayer*>(layers_pointers(i))->get_biases();
+
+            const Index inputs_number = synaptic_weights.dimension(0);
+            const Index neurons_number = synaptic_weights.dimension(1);
+
+            quantized_layer.weights_scales.resize(neurons_number);
+            quantized_layer.weights.resize(inputs_number, neurons_number);
+            quantized_layer.biases.resize(neurons_number);
+
+            for(Index j = 0; j < neurons_number; j++)
+            {
+                const Tensor<type, 0> maximum_weight = synaptic_weights.chip(j,1).abs().maximum();
+
+                const type weights_scale = maximum_weight(0) > static_cast<type>(0)
+                        ? maximum_weight(0)/quantization_limit
+                        : static_cast<type>(1);
+
+                const type inverse_weights_scale = static_cast<type>(1)/weights_scale;
+
+                for(Index k = 0; k < inputs_number; k++)
+                {
+                    quantized_layer.weights(k,j) = quantize_value(synaptic_weights(k,j), inverse_weights_scale);
+                }
+
+                quantized_layer.weights_scales(j) = weights_scale;
+
+                quantized_layer.biases(j) = biases(j);
+            }
+
+            quantized_layer_index++;
+        }
+
+        outputs = layers_pointers(i)->calculate_outputs(outputs);
+    }
+}
+
+
+/// Quantizes the perceptron and probabilistic layers of the neural network,
+/// calibrating the inputs scales on the training instances of a data set.
+/// If there are more training instances than the calibration instances number, they are subsampled evenly.
+/// @param data_set_pointer Pointer to a data set with the inputs to the neural network.
+
+void QuantizedNeuralNetwork::quantize(DataSet* data_set_pointer)
+{
+    const Tensor<Index, 1> training_instances_indices = data_set_pointer->get_training_instances_indices();
+
+    const Index training_instances_number = training_instances_indices.size();
+
+    const Index instances_number = min(training_instances_number, calibration_instances_number);
+
+    Tensor<Index, 1> calibration_instances_indices(instances_number);
+
+    for(Index i = 0; i < instances_number; i++)
+    {
+        calibration_instances_indices(i) = training_instances_indices((i*training_instances_number)/instances_number);
+    }
+
+    if(display) cout << "Calibrating quantization on " << instances_number << " instances..." << endl;
+
+    quantize(data_set_pointer->get_input_data(calibration_instances_indices));
+}
+
+
+/// Calculates the combinations of a quantized layer.
+/// The inputs are quantized with the scale of the layer, the dot products with the quantized synaptic weights
+/// are accumulated in 32 bit integers, and then the result is scaled back and the biases are added.
+/// @param quantized_layer Quantized layer.
+/// @param inputs Floating point inputs to the layer.
+/// @param combinations Floating point combinations of the layer.
+
+void QuantizedNeuralNetwork::calculate_combinations(const QuantizedLayer& quantized_layer,
+                                                    const Tensor<type, 2>& inputs,
+                                                    Tensor<type, 2>& combinations) const
+{
+    const Index batch_instances_number = inputs.dimension(0);
+    const Index inputs_number = quantized_layer.weights.dimension(0);
+    const Index neurons_number = quantized_layer.weights.dimension(1);
+
+#ifdef __OPENNN_DEBUG__
+
+    if(inputs.dimension(1) != inputs_number)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: QuantizedNeuralNetwork class.\n"
+               << "void calculate_combinations(const QuantizedLayer&, const Tensor<type, 2>&, Tensor<type, 2>&) const method.\n"
+               << "Number of inputs columns (" << inputs.dimension(1) << ") must be equal to number of inputs ("
+               << inputs_number << ").\n";
+
+        throw logic_error(buffer.str());
+    }
+
+#endif
+
+    // Quantized inputs of each instance are contiguous in memory
+
+    Tensor<int8_t, 2> quantized_inputs(inputs_number, batch_instances_number);
+
+    const type inverse_inputs_scale = static_cast<type>(1)/quantized_layer.inputs_scale;
+
+    #pragma omp parallel for
+
+    for(Index i = 0; i < batch_instances_number; i++)
+    {
+        for(Index k = 0; k < inputs_number; k++)
+        {
+            quantized_inputs(k,i) = quantize_value(inputs(i,k), inverse_inputs_scale);
+        }
+    }
+
+    const int8_t* quantized_inputs_data = quantized_inputs.data();
+    const int8_t* quantized_weights_data = quantized_layer.weights.data();
+
+    #pragma omp parallel for
+
+    for(Index i = 0; i < batch_instances_number; i++)
+    {
+        for(Index j = 0; j < neurons_number; j++)
+        {
+            const int32_t sum = dot_int8(quantized_inputs_data + i*inputs_number,
+                                         quantized_weights_data + j*inputs_number,
+                                         inputs_number,
+                                         vectorized);
+
+            combinations(i,j) = quantized_layer.biases(j)
+                    + quantized_layer.inputs_scale*quantized_layer.weights_scales(j)*static_cast<type>(sum);
+        }
+    }
+}
+
+
+/// Calculates the outputs of the neural network with the quantized layers.
+/// The layers which are not quantized are calculated in floating point by the neural network.
+/// @param inputs Inputs to the neural network.
+
+Tensor<type, 2> QuantizedNeuralNetwork::calculate_outputs(const Tensor<type, 2>& inputs) const
+{
+    const Tensor<Layer*, 1> layers_pointers = neural_network_pointer->get_layers_pointers();
+
+    const Index layers_number = layers_pointers.size();
+
+    const Index batch_instances_number = inputs.dimension(0);
+
+    Tensor<type, 2> outputs = inputs;
+
+    Index quantized_layer_index = 0;
+
+    for(Index i = 0; i < layers_number; i++)
+    {
+        if(quantized_layer_index < quantized_layers.size() && quantized_layers(quantized_layer_index).layer_index == i)
+        {
+            const QuantizedLayer& quantized_layer = quantized_layers(quantized_layer_index);
+
+#ifdef __OPENNN_DEBUG__
+
+            if(!is_quantizable(layers_pointers(i))
+            || layers_pointers(i)->get_neurons_number() != quantized_layer.weights.dimension(1))
+            {
+                ostringstream buffer;
+
+                buffer << "OpenNN Exception: QuantizedNeuralNetwork class.\n"
+                       << "Tensor<type, 2> calculate_outputs(const Tensor<type, 2>&) const method.\n"
+                       << "Layer " << i << " does not match its quantized layer.\n";
+
+                throw logic_error(buffer.str());
+            }
+
+#endif
+
+            const Index neurons_number = quantized_layer.weights.dimension(1);
+
+            Tensor<type, 2> combinations(batch_instances_number, neurons_number);
+
+            calculate_combinations(quantized_layer, outputs, combinations);
+
+            outputs.resize(batch_instances_number, neurons_number);
+
+            if(layers_pointers(i)->get_type() == Layer::Perceptron)
+            {
+                static_cast<PerceptronLayer*>(layers_pointers(i))->calculate_activations(combinations, outputs);
+            }
+            else
+            {
+                static_cast<ProbabilisticLayer*>(layers_pointers(i))->calculate_activations(combinations, outputs);
+            }
+
+            quantized_layer_index++;
+        }
+        else
+        {
+            outputs = layers_pointers(i)->calculate_outputs(outputs);
+        }
+    }
+
+    return outputs;
+}
+
+
+/// Compares the quantized neural network with the floating point one on the testing instances of a data set.
+/// The testing errors are the normalized squared errors calculated by the testing analysis.
+/// @param data_set_pointer Pointer to a data set with testing instances.
+
+QuantizedNeuralNetwork::QuantizationResults QuantizedNeuralNetwork::calculate_quantization_results(DataSet* data_set_pointer) const
+{
+    QuantizationResults quantization_results;
+
+    TestingAnalysis testing_analysis(neural_network_pointer, data_set_pointer);
+
+    const Tensor<type, 2> inputs = data_set_pointer->get_testing_input_data();
+    const Tensor<type, 2> targets = data_set_pointer->get_testing_target_data();
+
+    const Tensor<type, 2> float_outputs = neural_network_pointer->calculate_outputs(inputs);
+    const Tensor<type, 2> quantized_outputs = calculate_outputs(inputs);
+
+    quantization_results.float_testing_error = testing_analysis.calculate_normalized_squared_error(targets, float_outputs);
+    quantization_results.quantized_testing_error = testing_analysis.calculate_normalized_squared_error(targets, quantized_outputs);
+
+    const Tensor<type, 2> outputs_differences = (quantized_outputs - float_outputs).abs();
+
+    const Tensor<type, 0> maximum_outputs_difference = outputs_differences.maximum();
+    const Tensor<type, 0> mean_outputs_difference = outputs_differences.mean();
+
+    quantization_results.maximum_outputs_difference = maximum_outputs_difference(0);
+    quantization_results.mean_outputs_difference = mean_outputs_difference(0);
+
+    // Decisions
+
+    const Index testing_instances_number = inputs.dimension(0);
+    const Index outputs_number = float_outputs.dimension(1);
+
+    if(testing_instances_number == 0) return quantization_results;
+
+    Index equal_decisions_number = 0;
+
+    for(Index i = 0; i < testing_instances_number; i++)
+    {
+        if(outputs_number == 1)
+        {
+            const bool float_decision = float_outputs(i,0) >= static_cast<type>(0.5);
+            const bool quantized_decision = quantized_outputs(i,0) >= static_cast<type>(0.5);
+
+            if(float_decision == quantized_decision) equal_decisions_number++;
+        }
+        else
+        {
+            Index float_decision = 0;
+            Index quantized_decision = 0;
+
+            for(Index j = 1; j < outputs_number; j++)
+            {
+                if(float_outputs(i,j) > float_outputs(i,float_decision)) float_decision = j;
+                if(quantized_outputs(i,j) > quantized_outputs(i,quantized_decision)) quantized_decision = j;
+            }
+
+            if(float_decision == quantized_decision) equal_decisions_number++;
+        }
+    }
+
+    quantization_results.decisions_agreement = static_cast<type>(equal_decisions_number)/static_cast<type>(testing_instances_number);
+
+    return quantization_results;
+}
+
+
+/// Prints to the screen the accuracy of the quantized neural network.
+
+void QuantizedNeuralNetwork::QuantizationResults::print() const
+{
+    cout << "Float testing error: " << float_testing_error << endl;
+    cout << "Quantized testing error: " << quantized_testing_error << endl;
+    cout << "Maximum outputs difference: " << maximum_outputs_difference << endl;
+    cout << "Mean outputs difference: " << mean_outputs_difference << endl;
+    cout << "Decisions agreement: " << decisions_agreement << endl;
+}
+
+
+/// Loads the quantized layers from a XML document.
+/// The neural network is not part of the document, so it must be loaded separately.
+/// @param document TinyXML document with the member data.
+
+void QuantizedNeuralNetwork::from_XML(const tinyxml2::XMLDocument& document)
+{
+    ostringstream buffer;
+
+    const tinyxml2::XMLElement* root_element = document.FirstChildElement("QuantizedNeuralNetwork");
+
+    if(!root_element)
+    {
+        buffer << "OpenNN Exception: QuantizedNeuralNetwork class.\n"
+               << "void from_XML(const tinyxml2::XMLDocument&) method.\n"
+               << "QuantizedNeuralNetwork element is nullptr.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    // Calibration instances number
+
+    const tinyxml2::XMLElement* calibration_instances_number_element = root_element->FirstChildElement("CalibrationInstancesNumber");
+
+    if(calibration_instances_number_element && calibration_instances_number_element->GetText())
+    {
+        set_calibration_instances_number(static_cast<Index>(atoi(calibration_instances_number_element->GetText())));
+    }
+
+    // Quantized layers number
+
+    const tinyxml2::XMLElement* quantized_layers_number_element = root_element->FirstChildElement("QuantizedLayersNumber");
+
+    if(!quantized_layers_number_element)
+    {
+        buffer << "OpenNN Exception: QuantizedNeuralNetwork class.\n"
+               << "void from_XML(const tinyxml2::XMLDocument&) method.\n"
+               << "QuantizedLayersNumber element is nullptr.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    const Index quantized_layers_number = quantized_layers_number_element->GetText()
+            ? static_cast<Index>(atoi(quantized_layers_number_element->GetText()))
+            : 0;
+
+    quantized_layers.resize(quantized_layers_number);
+
+    // Quantized layers
+
+    const tinyxml2::XMLElement* start_element = quantized_layers_number_element;
+
+    for(Index i = 0; i < quantized_layers_number; i++)
+    {
+        const tinyxml2::XMLElement* quantized_layer_element = start_element->NextSiblingElement("QuantizedLayer");
+        start_element = quantized_layer_element;
+
+        if(!quantized_layer_element)
+        {
+            buffer << "OpenNN Exception: QuantizedNeuralNetwork class.\n"
+                   << "void from_XML(const tinyxml2::XMLDocument&) method.\n"
+                   << "QuantizedLayer element " << i+1 << " is nullptr.\n";
+
+            throw logic_error(buffer.str());
+        }
+
+        const string elements_names[] = {"LayerIndex", "InputsNumber", "NeuronsNumber", "InputsScale",
+                                         "WeightsScales", "Biases", "Weights"};
+
+        string elements_texts[7];
+
+        for(Index j = 0; j < 7; j++)
+        {
+            const tinyxml2::XMLElement* element = quantized_layer_element->FirstChildElement(elements_names[j].c_str());
+
+            if(!element)
+            {
+                buffer << "OpenNN Exception: QuantizedNeuralNetwork class.\n"
+                       << "void from_XML(const tinyxml2::XMLDocument&) method.\n"
+                       << elements_names[j] << " element is nullptr.\n";
+
+                throw logic_error(buffer.str());
+            }
+
+            if(element->GetText()) elements_texts[j] = element->GetText();
+        }
+
+        QuantizedLayer& quantized_layer = quantized_layers(i);
+
+        quantized_layer.layer_index = static_cast<Index>(stoi(elements_texts[0]));
+
+        const Index inputs_number = static_cast<Index>(stoi(elements_texts[1]));
+        const Index neurons_number = static_cast<Index>(stoi(elements_texts[2]));
+
+        quantized_layer.inputs_scale = static_cast<type>(stod(elements_texts[3]));
+
+        // Scales and biases are read in double precision, so that the outputs are reproduced exactly
+
+        const Tensor<string, 1> weights_scales_tokens = get_tokens(elements_texts[4], ' ');
+        const Tensor<string, 1> biases_tokens = get_tokens(elements_texts[5], ' ');
+        const Tensor<string, 1> weights_tokens = get_tokens(elements_texts[6], ' ');
+
+        if(weights_scales_tokens.size() != neurons_number
+        || biases_tokens.size() != neurons_number
+        || weights_tokens.size() != inputs_number*neurons_number)
+        {
+            buffer << "OpenNN Exception: QuantizedNeuralNetwork class.\n"
+                   << "void from_XML(const tinyxml2::XMLDocument&) method.\n"
+                   << "Sizes of quantized layer " << i+1 << " do not match its inputs and neurons numbers.\n";
+
+            throw logic_error(buffer.str());
+        }
+
+        quantized_layer.weights_scales.resize(neurons_number);
+        quantized_layer.biases.resize(neurons_number);
+
+        for(Index j = 0; j < neurons_number; j++)
+        {
+            quantized_layer.weights_scales(j) = static_cast<type>(stod(weights_scales_tokens(j)));
+            quantized_layer.biases(j) = static_cast<type>(stod(biases_tokens(j)));
+        }
+
+        quantized_layer.weights.resize(inputs_number, neurons_number);
+
+        for(Index j = 0; j < weights_tokens.size(); j++)
+        {
+            quantized_layer.weights.data()[j] = static_cast<int8_t>(stoi(weights_tokens(j)));
+        }
+    }
+}
+
+
+/// Serializes the quantized layers into a XML document of the TinyXML library without keeping the DOM tree in memory.
+/// The quantized synaptic weights are written as integers, with the synaptic weights of each neuron together.
+
+void QuantizedNeuralNetwork::write_XML(tinyxml2::XMLPrinter& file_stream) const
+{
+    ostringstream buffer;
+
+    file_stream.OpenElement("QuantizedNeuralNetwork");
+
+    // Calibration instances number
+
+    file_stream.OpenElement("CalibrationInstancesNumber");
+
+    buffer.str("");
+    buffer << calibration_instances_number;
+
+    file_stream.PushText(buffer.str().c_str());
+
+    file_stream.CloseElement();
+
+    // Quantized layers number
+
+    const Index quantized_layers_number = quantized_layers.size();
+
+    file_stream.OpenElement("QuantizedLayersNumber");
+
+    buffer.str("");
+    buffer << quantized_layers_number;
+
+    file_stream.PushText(buffer.str().c_str());
+
+    file_stream.CloseElement();
+
+    // Quantized layers
+
+    for(Index i = 0; i < quantized_layers_number; i++)
+    {
+        const QuantizedLayer& quantized_layer = quantized_layers(i);
+
+        const Index inputs_number = quantized_layer.weights.dimension(0);
+        const Index neurons_number = quantized_layer.weights.dimension(1);
+
+        file_stream.OpenElement("QuantizedLayer");
+
+        file_stream.PushAttribute("Index", to_string(i+1).c_str());
+
+        // Layer index
+
+        file_stream.OpenElement("LayerIndex");
+
+        buffer.str("");
+        buffer << quantized_layer.layer_index;
+
+        file_stream.PushText(buffer.str().c_str());
+
+        file_stream.CloseElement();
+
+        // Inputs number
+
+        file_stream.OpenElement("InputsNumber");
+
+        buffer.str("");
+        buffer << inputs_number;
+
+        file_stream.PushText(buffer.str().c_str());
+
+        file_stream.CloseElement();
+
+        // Neurons number
+
+        file_stream.OpenElement("NeuronsNumber");
+
+        buffer.str("");
+        buffer << neurons_number;
+
+        file_stream.PushText(buffer.str().c_str());
+
+        file_stream.CloseElement();
+
+        // Inputs scale
+
+        file_stream.OpenElement("InputsScale");
+
+        buffer.str("");
+        buffer << setprecision(17) << quantized_layer.inputs_scale;
+
+        file_stream.PushText(buffer.str().c_str());
+
+        file_stream.CloseElement();
+
+        // Weights scales
+
+        file_stream.OpenElement("WeightsScales");
+
+        buffer.str("");
+
+        for(Index j = 0; j < neurons_number; j++)
+        {
+            buffer << setprecision(17) << quantized_layer.weights_scales(j);
+
+            if(j != neurons_number-1) buffer << " ";
+        }
+
+        file_stream.PushText(buffer.str().c_str());
+
+        file_stream.CloseElement();
+
+        // Biases
+
+        file_stream.OpenElement("Biases");
+
+        buffer.str("");
+
+        for(Index j = 0; j < neurons_number; j++)
+        {
+            buffer << setprecision(17) << quantized_layer.biases(j);
+
+            if(j != neurons_number-1) buffer << " ";
+        }
+
+        file_stream.PushText(buffer.str().c_str());
+
+        file_stream.CloseElement();
+
+        // Weights
+
+        file_stream.OpenElement("Weights");
+
+        buffer.str("");
+
+        const Index weights_number = quantized_layer.weights.size();
+
+        for(Index j = 0; j < weights_number; j++)
+        {
+            buffer << static_cast<int>(quantized_layer.weights.data()[j]);
+
+            if(j != weights_number-1) buffer << " ";
+        }
+
+        file_stream.PushText(buffer.str().c_str());
+
+        file_stream.CloseElement();
+
+        // Quantized layer (end tag)
+
+        file_stream.CloseElement();
+    }
+
+    file_stream.CloseElement();
+}
+
+
+/// Saves to a XML file the quantized layers.
+/// @param file_name Name of quantized neural network XML file.
+
+void QuantizedNeuralNetwork::save(const string& file_name) const
+{
+    FILE* file = fopen(file_name.c_str(), "w");
+
+    if(!file)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: QuantizedNeuralNetwork class.\n"
+               << "void save(const string&) const method.\n"
+               << "Cannot open file " << file_name << ".\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    tinyxml2::XMLPrinter document(file);
+
+    write_XML(document);
+
+    fclose(file);
+}
+
+
+/// Loads the quantized layers from a XML file.
+/// @param file_name Name of quantized neural network XML file.
+
+void QuantizedNeuralNetwork::load(const string& file_name)
+{
+    tinyxml2::XMLDocument document;
+
+    if(document.LoadFile(file_name.c_str()))
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: QuantizedNeuralNetwork class.\n"
+               << "void load(const string&) method.\n"
+               << "Cannot load XML file " << file_name << ".\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    from_XML(document);
+}
+
+}
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
@@ -0,0 +1,211 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   Q U A N T I Z E D   N E U R A L   N E T W O R K   C L A S S   H E A D E R
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#ifndef QUANTIZEDNEURALNETWORK_H
+#define QUANTIZEDNEURALNETWORK_H
+
+// System includes
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <sstream>
+
+// OpenNN includes
+
+#include "config.h"
+#include "data_set.h"
+#include "neural_network.h"
+#include "testing_analysis.h"
+#include "opennn_strings.h"
+
+namespace OpenNN
+{
+
+/// This class performs the post-training quantization of a neural network to 8 bit integers.
+
+///
+/// The synaptic weights of the perceptron and probabilistic layers are converted to int8 with a scale for each neuron,
+/// and the inputs to those layers are converted to int8 with a scale for each layer, which is calibrated on a sample of inputs.
+/// The products are accumulated in int32 and scaled back to floating point before adding the biases and applying the activation functions.
+/// The rest of layers, such as the scaling and unscaling layers, are calculated in floating point by the neural network.
+
+class QuantizedNeuralNetwork
+{
+
+public:
+
+   // Constructors
+
+   explicit QuantizedNeuralNetwork();
+
+   explicit QuantizedNeuralNetwork(NeuralNetwork*);
+
+   // Destructor
+
+   virtual ~QuantizedNeuralNetwork();
+
+   /// This structure contains the quantized synaptic weights of a perceptron or probabilistic layer.
+
+   struct QuantizedLayer
+   {
+       /// Index of the layer in the neural network.
+
+       Index layer_index = 0;
+
+       /// Scale of the layer inputs, so that input = inputs_scale*quantized_input.
+
+       type inputs_scale = 1;
+
+       /// Scale of the synaptic weights of each neuron.
+
+       Tensor<type, 1> weights_scales;
+
+       /// Inputs_number x neurons_number matrix with the quantized synaptic weights.
+       /// The synaptic weights of each neuron are contiguous in memory.
+
+       Tensor<int8_t, 2> weights;
+
+       /// Biases of the neurons, which are kept in floating point.
+
+       Tensor<type, 1> biases;
+   };
+
+
+   /// This structure contains the accuracy of the quantized neural network compared to the floating point one.
+
+   struct QuantizationResults
+   {
+       /// Normalized squared error of the floating point neural network on the testing instances.
+
+       type float_testing_error = 0;
+
+       /// Normalized squared error of the quantized neural network on the testing instances.
+
+       type quantized_testing_error = 0;
+
+       /// Maximum absolute difference between the outputs of both neural networks.
+
+       type maximum_outputs_difference = 0;
+
+       /// Mean absolute difference between the outputs of both neural networks.
+
+       type mean_outputs_difference = 0;
+
+       /// Fraction of testing instances where both neural networks choose the same output.
+       /// It is only meaningful for classification.
+
+       type decisions_agreement = 1;
+
+       void print() const;
+   };
+
+   // Get methods
+
+   NeuralNetwork* get_neural_network_pointer() const;
+
+   const Tensor<QuantizedLayer, 1>& get_quantized_layers() const;
+
+   Index get_quantized_layers_number() const;
+
+   const Index& get_calibration_instances_number() const;
+
+   const bool& get_vectorized() const;
+
+   const bool& get_display() const;
+
+   // Set methods
+
+   void set();
+   void set(NeuralNetwork*);
+
+   void set_default();
+
+   void set_neural_network_pointer(NeuralNetwork*);
+
+   void set_calibration_instances_number(const Index&);
+
+   void set_vectorized(const bool&);
+
+   void set_display(const bool&);
+
+   // Quantization methods
+
+   void quantize(const Tensor<type, 2>&);
+   void quantize(DataSet*);
+
+   // Outputs
+
+   Tensor<type, 2> calculate_outputs(const Tensor<type, 2>&) const;
+
+   // Accuracy methods
+
+   QuantizationResults calculate_quantization_results(DataSet*) const;
+
+   // Serialization methods
+
+   void from_XML(const tinyxml2::XMLDocument&);
+   void write_XML(tinyxml2::XMLPrinter&) const;
+
+   void save(const string&) const;
+   void load(const string&);
+
+protected:
+
+   static bool is_quantizable(const Layer*);
+
+   void calculate_combinations(const QuantizedLayer&, const Tensor<type, 2>&, Tensor<type, 2>&) const;
+
+   // MEMBERS
+
+   /// Pointer to the floating point neural network.
+
+   NeuralNetwork* neural_network_pointer = nullptr;
+
+   /// Quantized perceptron and probabilistic layers, in the order of the neural network.
+
+   Tensor<QuantizedLayer, 1> quantized_layers;
+
+   /// Maximum number of training instances used to calibrate the inputs scales.
+
+   Index calibration_instances_number = 1000;
+
+   /// True if the products of 8 bit integers use the AVX2 instructions when the processor supports them.
+
+   bool vectorized = true;
+
+   /// Display messages to screen.
+
+   bool display = true;
+};
+
+}
+
+#endif
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
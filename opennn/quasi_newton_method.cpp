@@ -710,6 +710,10 @@ void QuasiNewtonMethod::update_epoch(
     optimization_data.training_direction.device(*thread_pool_device)
             = -optimization_data.inverse_hessian.contract(back_propagation.gradient, A_B);
 
+    // The pruned synaptic weights are kept at zero whatever the inverse hessian approximation
+
+    loss_index_pointer->get_neural_network_pointer()->mask_pruned_parameters(optimization_data.training_direction);
+
     // Calculate training slope
 
     optimization_data.training_slope.device(*thread_pool_device)
@@ -732,6 +736,8 @@ void QuasiNewtonMethod::update_epoch(
             ? optimization_data.initial_learning_rate = first_learning_rate
             : optimization_data.initial_learning_rate = optimization_data.old_learning_rate;
 
+    optimization_data.old_gradient = back_propagation.gradient;
+
     pair<type,type> directional_point = learning_rate_algorithm.calculate_directional_point(
              batch,
              forward_propagation,
@@ -754,8 +760,6 @@ void QuasiNewtonMethod::update_epoch(
 
     // Update stuff
 
-    optimization_data.old_gradient = back_propagation.gradient;
-
     optimization_data.old_inverse_hessian = optimization_data.inverse_hessian;
 
     optimization_data.old_learning_rate = optimization_data.learning_rate;
@@ -781,7 +785,7 @@ OptimizationAlgorithm::Results QuasiNewtonMethod::perform_training()
 
     Results results;
 
-    results.resize_training_history(maximum_epochs_number);
+    results.resize_training_history(maximum_epochs_number+1);
 
     // Data set
 
@@ -800,8 +804,14 @@ OptimizationAlgorithm::Results QuasiNewtonMethod::perform_training()
     DataSet::Batch training_batch(training_instances_number, data_set_pointer);
     DataSet::Batch selection_batch(selection_instances_number, data_set_pointer);
 
-    training_batch.fill(training_instances_indices, inputs_indices, target_indices);
-    selection_batch.fill(selection_instances_indices, inputs_indices, target_indices);
+    start_profile();
+
+    {
+        OPENNN_PROFILE_SCOPE(&profiler, TrainingProfiler::BatchFill);
+
+        training_batch.fill(training_instances_indices, inputs_indices, target_indices);
+        selection_batch.fill(selection_instances_indices, inputs_indices, target_indices);
+    }
 
     training_instances_indices.resize(0);
     selection_instances_indices.resize(0);
@@ -842,21 +852,61 @@ OptimizationAlgorithm::Results QuasiNewtonMethod::perform_training()
 
     QNMOptimizationData optimization_data(this);
 
-    if(has_selection) results.resize_selection_history(maximum_epochs_number);
+    if(has_selection) results.resize_selection_history(maximum_epochs_number+1);
+
+    // Checkpoint
+
+    TrainingCheckpoint checkpoint;
+
+    Index initial_epoch = 0;
+
+    if(start_checkpoints(checkpoint, results))
+    {
+        initial_epoch = checkpoint.get_epoch();
+
+        beginning_time -= static_cast<time_t>(checkpoint.get_elapsed_time());
+
+        optimization_data.parameters = checkpoint.get_vector("parameters");
+        optimization_data.old_parameters = checkpoint.get_vector("old_parameters");
+        optimization_data.old_gradient = checkpoint.get_vector("old_gradient");
+        optimization_data.old_inverse_hessian = checkpoint.get_matrix("old_inverse_hessian");
+        optimization_data.old_learning_rate = checkpoint.get_scalar("old_learning_rate");
+        optimization_data.old_training_loss = checkpoint.get_scalar("old_training_loss");
+
+        minimal_selection_parameters = checkpoint.get_vector("minimal_selection_parameters");
+        minimum_selection_error = checkpoint.get_scalar("minimum_selection_error");
+        old_selection_error = checkpoint.get_scalar("old_selection_error");
+        selection_failures = checkpoint.get_index("selection_failures");
+
+        neural_network_pointer->set_parameters(optimization_data.parameters);
+    }
+
+    // Observers
+
+    begin_observers();
+
+    TrainingObserver::Metrics metrics;
 
     // Main loop
 
-    for(Index epoch = 0; epoch <= maximum_epochs_number; epoch++)
+    for(Index epoch = initial_epoch; epoch <= maximum_epochs_number; epoch++)
     {
+        begin_epoch_profile(epoch);
+
         optimization_data.epoch = epoch;
 
         // Neural network
 
         parameters_norm = l2_norm(optimization_data.parameters);
 
-        neural_network_pointer->forward_propagate(training_batch, training_forward_propagation);
+        // The strong Wolfe line search already left the loss and gradient at the new parameters
+
+        if(epoch == initial_epoch || !learning_rate_algorithm.evaluates_gradient())
+        {
+            neural_network_pointer->forward_propagate(training_batch, training_forward_propagation);
 
-        loss_index_pointer->back_propagate(training_batch, training_forward_propagation, training_back_propagation);
+            loss_index_pointer->back_propagate(training_batch, training_forward_propagation, training_back_propagation);
+        }
 
         gradient_norm = l2_norm(training_back_propagation.gradient);
 
@@ -886,9 +936,17 @@ OptimizationAlgorithm::Results QuasiNewtonMethod::perform_training()
 
         // Optimization data
 
-        update_epoch(training_batch, training_forward_propagation, training_back_propagation, optimization_data);
+        {
+            OPENNN_PROFILE_SCOPE(&profiler, TrainingProfiler::UpdateIteration);
 
-        neural_network_pointer->set_parameters(optimization_data.parameters);
+            update_epoch(training_batch, training_forward_propagation, training_back_propagation, optimization_data);
+        }
+
+        {
+            OPENNN_PROFILE_SCOPE(&profiler, TrainingProfiler::SetParameters);
+
+            neural_network_pointer->set_parameters(optimization_data.parameters);
+        }
 
         // Training history
 
@@ -981,6 +1039,30 @@ OptimizationAlgorithm::Results QuasiNewtonMethod::perform_training()
             results.stopping_condition = MaximumTime;
         }
 
+        if(!stop_training && check_training_control())
+        {
+            if(display) cout << "Epoch " << epoch+1 << ": Stop requested.\n";
+
+            stop_training = true;
+
+            results.stopping_condition = StopRequested;
+        }
+
+        if(has_observers())
+        {
+            metrics.epoch = epoch;
+            metrics.iteration = 0;
+            metrics.iterations_number = epoch + 1;
+            metrics.instances_number = training_instances_number;
+            metrics.training_loss = training_back_propagation.loss;
+            metrics.training_error = training_back_propagation.error;
+            metrics.selection_error = has_selection ? selection_back_propagation.error : numeric_limits<type>::quiet_NaN();
+            metrics.gradient_norm = gradient_norm;
+            metrics.learning_rate = optimization_data.learning_rate;
+
+            notify_epoch(metrics);
+        }
+
         if(epoch != 0 && epoch % save_period == 0)
         {
             neural_network_pointer->save(neural_network_file_name);
@@ -1038,8 +1120,31 @@ OptimizationAlgorithm::Results QuasiNewtonMethod::perform_training()
         old_selection_error = selection_back_propagation.error;
 
         if(stop_training) break;
+
+        if(is_checkpoint_epoch(epoch+1))
+        {
+            checkpoint.set_vector("parameters", optimization_data.parameters);
+            checkpoint.set_vector("old_parameters", optimization_data.old_parameters);
+            checkpoint.set_vector("old_gradient", optimization_data.old_gradient);
+            checkpoint.set_matrix("old_inverse_hessian", optimization_data.old_inverse_hessian);
+            checkpoint.set_scalar("old_learning_rate", optimization_data.old_learning_rate);
+            checkpoint.set_scalar("old_training_loss", optimization_data.old_training_loss);
+
+            checkpoint.set_vector("minimal_selection_parameters", minimal_selection_parameters);
+            checkpoint.set_scalar("minimum_selection_error", minimum_selection_error);
+            checkpoint.set_scalar("old_selection_error", old_selection_error);
+            checkpoint.set_index("selection_failures", selection_failures);
+
+            write_checkpoint(checkpoint, results, epoch+1, elapsed_time);
+        }
     }
 
+    wait_checkpoint();
+
+    finish_profile(results);
+
+    end_observers(results);
+
     if(choose_best_selection)
     {
         //optimization_data.parameters = minimal_selection_parameters;
@@ -1439,6 +1544,10 @@ void QuasiNewtonMethod::write_XML(tinyxml2::XMLPrinter& file_stream) const
 
     file_stream.CloseElement();
 
+    // Checkpoints
+
+    write_checkpoints_XML(file_stream);
+
     file_stream.CloseElement();
 }
 
@@ -1859,6 +1968,10 @@ void QuasiNewtonMethod::from_XML(const tinyxml2::XMLDocument& document)
            }
         }
     }    
+
+    // Checkpoints
+
+    checkpoints_from_XML(root_element);
 }
 
 }
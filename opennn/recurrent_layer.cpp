@@ -78,14 +78,6 @@ Index RecurrentLayer::get_neurons_number() const
 }
 
 
-/// Returns the hidden states of the layer.
-
-Tensor<type, 1> RecurrentLayer::get_hidden_states() const
-{
-    return hidden_states;
-}
-
-
 /// Returns the number of parameters (biases and weights) of the layer.
 
 Index RecurrentLayer::get_parameters_number() const
@@ -341,10 +333,6 @@ void RecurrentLayer::set(const Index& new_inputs_number, const Index& new_neuron
 
     recurrent_weights.resize(new_neurons_number, new_neurons_number);
 
-    hidden_states.resize(new_neurons_number); // memory
-
-    hidden_states.setConstant(0.0);
-
     set_default();
 }
 
@@ -454,13 +442,13 @@ void RecurrentLayer::set_parameters(const Tensor<type, 1>& new_parameters, const
 
     const Index new_parameters_size = new_parameters.size();
 
-    if(new_parameters_size != parameters_number)
+    if(new_parameters_size < index + parameters_number)
     {
         ostringstream buffer;
 
         buffer << "OpenNN Exception: RecurrentLayer class.\n"
-               << "void set_parameters(const Tensor<type, 1>&) method.\n"
-               << "Size of new parameters (" << new_parameters_size << ") must be equal to number of parameters (" << parameters_number << ").\n";
+               << "void set_parameters(const Tensor<type, 1>&, const Index&) method.\n"
+               << "Size of new parameters (" << new_parameters_size << ") must be at least index plus number of parameters (" << index + parameters_number << ").\n";
 
         throw logic_error(buffer.str());
     }
@@ -576,12 +564,6 @@ void RecurrentLayer::set_display(const bool& new_display)
 /// Initializes the hidden states of in the layer of neurons with a given value.
 /// @param value Hidden states initialization value.
 
-void RecurrentLayer::initialize_hidden_states(const type& value)
-{
-    hidden_states.setConstant(value);
-}
-
-
 /// Initializes the biases of all the neurons in the layer of neurons with a given value.
 /// @param value Biases initialization value.
 
@@ -625,8 +607,6 @@ void RecurrentLayer::set_parameters_constant(const type& value)
     input_weights.setConstant(value);
 
     recurrent_weights.setConstant(value);
-
-    hidden_states.setZero();
 }
 
 
@@ -645,50 +625,6 @@ void RecurrentLayer::set_parameters_random()
 }
 
 
-// Combinations
-
-void RecurrentLayer::calculate_combinations(const Tensor<type, 2>& inputs,
-                            const Tensor<type, 2>& input_weights,
-                            const Tensor<type, 2>& biases,
-                            const Tensor<type, 2>& recurrent_weights,
-                            Tensor<type, 2>& combinations_2d)
-{
-
-    const Index instances_number = inputs.dimension(0);
-    const Index neurons_number = get_neurons_number();
-
-    Tensor<type, 1> combinations_1d(combinations_2d.dimension(1));
-
-    for(Index i = 0; i < instances_number; i++)
-    {
-        if(i%timesteps == 0) hidden_states.setZero();
-
-        const Tensor<type, 1> current_inputs = inputs.chip(i, 0);
-
-        calculate_combinations(current_inputs, input_weights, biases, recurrent_weights, combinations_1d);
-
-        calculate_activations(combinations_1d, hidden_states);
-
-        for(Index j = 0; j < neurons_number; j++)
-            combinations_2d(i,j) = combinations_1d(j);
-    }
-}
-
-void RecurrentLayer::calculate_combinations(const Tensor<type, 1>& inputs,
-                            const Tensor<type, 2>& input_weights,
-                            const Tensor<type, 2>& biases,
-                            const Tensor<type, 2>& recurrent_weights,
-                            Tensor<type, 1>& combinations_1d) const
-{
-
-    combinations_1d.device(*thread_pool_device) = inputs.contract(input_weights, AT_B).eval();
-
-    combinations_1d.device(*thread_pool_device) += biases.chip(0,0);
-
-    combinations_1d.device(*thread_pool_device) += hidden_states.contract(recurrent_weights, AT_B).eval();
-}
-
-
 // Activations
 
 void RecurrentLayer::calculate_activations(const Tensor<type, 1>& combinations_1d, Tensor<type, 1>& activations_1d) const
@@ -1210,16 +1146,6 @@ Tensor<type, 2> RecurrentLayer::calculate_activations_derivatives(const Tensor<t
 */
 
 
-void RecurrentLayer::update_hidden_states(const Tensor<type, 1>& inputs)
-{
-    Tensor<type, 1> combinations_1d(inputs.dimension(0));
-
-    calculate_combinations(inputs, input_weights, biases, recurrent_weights, combinations_1d);
-
-    calculate_activations(combinations_1d, hidden_states);
-}
-
-
 Tensor<type, 2> RecurrentLayer::calculate_outputs(const Tensor<type, 2>& inputs)
 {
 #ifdef __OPENNN_DEBUG__
@@ -1240,31 +1166,117 @@ Tensor<type, 2> RecurrentLayer::calculate_outputs(const Tensor<type, 2>& inputs)
     }
 #endif
 
-    const Index instances_number = inputs.dimension(0);
+    ForwardPropagation forward_propagation(inputs.dimension(0), this);
+
+    forward_propagate(inputs, forward_propagation);
+
+    return forward_propagation.activations_2d;
+}
+
 
+/// Calculates the forward propagation of the layer with its current parameters.
+/// @param inputs Inputs to the layer, where each sequence is made of timesteps consecutive rows.
+/// @param forward_propagation Structure where the combinations, hidden states and activations derivatives are saved.
+
+void RecurrentLayer::forward_propagate(const Tensor<type, 2>& inputs, ForwardPropagation& forward_propagation) const
+{
+    Tensor<type, 1> parameters = get_parameters();
+
+    const TensorMap<Tensor<type, 1>> parameters_map(parameters.data(), parameters.size());
+
+    forward_propagate(inputs, parameters_map, forward_propagation);
+}
+
+
+/// Calculates the forward propagation of the layer with the given parameters.
+/// All the sequences in the inputs are processed at the same time.
+/// The input projections are calculated with a single product for all the timesteps,
+/// and then a single product with the recurrent weights is done at each timestep.
+/// The hidden states are kept in the forward propagation structure, so the layer itself is not modified.
+/// @param inputs Inputs to the layer, where each sequence is made of timesteps consecutive rows.
+/// @param parameters Parameters of the layer, in the same order as get_parameters().
+/// @param forward_propagation Structure where the combinations, hidden states and activations derivatives are saved.
+
+void RecurrentLayer::forward_propagate(const Tensor<type, 2>& inputs,
+                                       const TensorMap<Tensor<type, 1>>& parameters,
+                                       ForwardPropagation& forward_propagation) const
+{
+    const Index instances_number = inputs.dimension(0);
+    const Index inputs_number = get_inputs_number();
     const Index neurons_number = get_neurons_number();
 
-    Tensor<type, 2> outputs(instances_number, neurons_number);
+#ifdef __OPENNN_DEBUG__
+
+    if(inputs_number != inputs.dimension(1))
+    {
+        ostringstream buffer;
 
-    Tensor<type, 1> current_outputs(neurons_number);
+        buffer << "OpenNN Exception: RecurrentLayer class.\n"
+               << "void forward_propagate(const Tensor<type, 2>&, const TensorMap<Tensor<type, 1>>&, ForwardPropagation&) method.\n"
+               << "Number of inputs columns (" << inputs.dimension(1) << ") must be equal to number of inputs ("
+               << inputs_number << ").\n";
 
-    for(Index i = 0; i < instances_number; i++)
+        throw logic_error(buffer.str());
+    }
+
+#endif
+
+    const TensorMap<Tensor<type, 2>> new_input_weights(parameters.data(), inputs_number, neurons_number);
+
+    const TensorMap<Tensor<type, 2>> new_biases(parameters.data() + inputs_number*neurons_number, 1, neurons_number);
+
+    const TensorMap<Tensor<type, 2>> new_recurrent_weights(parameters.data() + (inputs_number + 1)*neurons_number,
+                                                           neurons_number, neurons_number);
+
+    Tensor<Index, 1> steps_offsets;
+    Tensor<Index, 1> steps_sizes;
+
+    calculate_steps(instances_number, steps_offsets, steps_sizes);
+
+    const Index steps_number = steps_sizes.size();
+
+    const Tensor<type, 2> sorted_inputs = sort_by_timesteps(inputs, steps_offsets, steps_sizes);
+
+    Tensor<type, 2> combinations(instances_number, neurons_number);
+
+    combinations.device(*thread_pool_device) = sorted_inputs.contract(new_input_weights, A_B)
+            + new_biases.broadcast(Eigen::array<Index, 2>({instances_number, 1}));
+
+    Tensor<type, 2> step_combinations;
+    Tensor<type, 2> hidden_states;
+    Tensor<type, 2> activations_derivatives;
+
+    for(Index t = 0; t < steps_number; t++)
     {
-        if(i%timesteps == 0) hidden_states.setZero();
+        const Index size = steps_sizes(t);
 
-        const Tensor<type, 1> current_inputs = inputs.chip(i, 0);
+        const Eigen::array<Index, 2> step_extents({size, neurons_number});
 
-        calculate_combinations(current_inputs, input_weights, biases, recurrent_weights, current_outputs);
+        step_combinations = combinations.slice(Eigen::array<Index, 2>({steps_offsets(t), 0}), step_extents);
 
-        calculate_activations(current_outputs, current_outputs);
+        if(t != 0)
+        {
+            step_combinations.device(*thread_pool_device)
+                    += hidden_states.slice(Eigen::array<Index, 2>({0, 0}), step_extents).contract(new_recurrent_weights, A_B);
+        }
 
-        for(Index j = 0; j < neurons_number; j++)
-            outputs(i,j) = current_outputs(j);
+        hidden_states.resize(size, neurons_number);
+        activations_derivatives.resize(size, neurons_number);
 
-        hidden_states = current_outputs;
-    }
+        calculate_activations_derivatives(step_combinations, hidden_states, activations_derivatives);
+
+        // Back to the original order
 
-    return outputs;
+        for(Index s = 0; s < size; s++)
+        {
+            for(Index j = 0; j < neurons_number; j++)
+            {
+                forward_propagation.combinations_2d(s*timesteps + t, j) = step_combinations(s, j);
+                forward_propagation.activations_2d(s*timesteps + t, j) = hidden_states(s, j);
+                forward_propagation.activations_derivatives_2d(s*timesteps + t, j) = activations_derivatives(s, j);
+            }
+        }
+    }
 }
 
 
@@ -1294,7 +1306,7 @@ Tensor<type, 2> RecurrentLayer::calculate_hidden_delta(Layer* next_layer_pointer
         synaptic_weights = probabilistic_layer->get_synaptic_weights();
     }
 
-    Tensor<type, 2> hidden_delta(next_layer_delta.dimension(0), synaptic_weights.dimension(1));
+    Tensor<type, 2> hidden_delta(next_layer_delta.dimension(0), synaptic_weights.dimension(0));
 
     hidden_delta.device(*thread_pool_device) = next_layer_delta.contract(synaptic_weights, A_BT);
 
@@ -1304,235 +1316,231 @@ Tensor<type, 2> RecurrentLayer::calculate_hidden_delta(Layer* next_layer_pointer
 }
 
 
+void RecurrentLayer::calculate_output_delta(ForwardPropagation& forward_propagation,
+                                            const Tensor<type, 2>& output_gradient,
+                                            Tensor<type, 2>& output_delta) const
+{
+    output_delta.device(*thread_pool_device) = forward_propagation.activations_derivatives_2d*output_gradient;
+}
+
 
-Tensor<type, 1> RecurrentLayer::calculate_error_gradient(const Tensor<type, 2> & inputs,
-        const Layer::ForwardPropagation& layers,
-        const Tensor<type, 2> & deltas)
+void RecurrentLayer::calculate_hidden_delta(Layer* next_layer_pointer,
+                                            const Tensor<type, 2>&,
+                                            ForwardPropagation& forward_propagation,
+                                            const Tensor<type, 2>& next_layer_delta,
+                                            Tensor<type, 2>& hidden_delta) const
 {
-    const Index input_weights_number = get_input_weights_number();
-    const Index recurrent_weights_number = get_recurrent_weights_number();
+    const Type next_layer_type = next_layer_pointer->get_type();
 
-    const Index parameters_number = get_parameters_number();
+    switch(next_layer_type)
+    {
+        case Perceptron:
+        {
+            const PerceptronLayer* next_perceptron_layer = dynamic_cast<PerceptronLayer*>(next_layer_pointer);
 
-    Tensor<type, 1> error_gradient(parameters_number);
+            const Tensor<type, 2>& next_synaptic_weights = next_perceptron_layer->get_synaptic_weights();
 
-    // Input weights
+            hidden_delta.device(*thread_pool_device) = next_layer_delta.contract(next_synaptic_weights, A_BT);
 
-//    error_gradient.embed(0, calculate_input_weights_error_gradient(inputs,layers,deltas));
-    for(Index i = 0; i < calculate_input_weights_error_gradient(inputs,layers,deltas).size(); i++)
-    {
-        error_gradient(i) = (calculate_input_weights_error_gradient(inputs, layers, deltas))(i);
-    }
+            hidden_delta.device(*thread_pool_device) = hidden_delta*forward_propagation.activations_derivatives_2d;
+        }
+        return;
 
-    // Recurent weights
+        case Probabilistic:
+        {
+            const ProbabilisticLayer* next_probabilistic_layer = dynamic_cast<ProbabilisticLayer*>(next_layer_pointer);
 
-//    error_gradient.embed(input_weights_number, calculate_recurrent_weights_error_gradient(inputs,layers,deltas));
-    for(Index i = 0; i < calculate_recurrent_weights_error_gradient(inputs, layers, deltas).size(); i++)
-    {
-        error_gradient(i + input_weights_number) = (calculate_recurrent_weights_error_gradient(inputs, layers, deltas))(i);
-    }
+            const Tensor<type, 2>& next_synaptic_weights = next_probabilistic_layer->get_synaptic_weights();
 
-    // Biases
+            hidden_delta.device(*thread_pool_device) = next_layer_delta.contract(next_synaptic_weights, A_BT);
 
-//    error_gradient.embed(input_weights_number+recurrent_weights_number, calculate_biases_error_gradient(inputs,layers,deltas));
-    for(Index i = 0; i < calculate_biases_error_gradient(inputs, layers, deltas).size(); i++)
-    {
-        error_gradient(i + input_weights_number+recurrent_weights_number) = (calculate_biases_error_gradient(inputs, layers, deltas))(i);
-    }
+            hidden_delta.device(*thread_pool_device) = hidden_delta*forward_propagation.activations_derivatives_2d;
+        }
+        return;
 
-    return error_gradient;
+        default:
 
+        return;
+    }
 }
 
 
-Tensor<type, 1> RecurrentLayer::calculate_input_weights_error_gradient(const Tensor<type, 2> & inputs,
-        const Layer::ForwardPropagation& layers,
-        const Tensor<type, 2> & deltas)
+/// Calculates the derivatives of the error with respect to the parameters of the layer by back-propagation through time.
+/// All the sequences are processed at the same time, from the last timestep to the first one,
+/// with a single product with the recurrent weights at each timestep.
+/// The weights derivatives are then calculated with one product for the input weights and another one for the recurrent weights.
+/// @param inputs Inputs to the layer, where each sequence is made of timesteps consecutive rows.
+/// @param forward_propagation Forward propagation of the layer for those inputs.
+/// @param back_propagation Structure with the delta of the layer, where the derivatives are saved.
+
+void RecurrentLayer::calculate_error_gradient(const Tensor<type, 2>& inputs,
+                                              const Layer::ForwardPropagation& forward_propagation,
+                                              Layer::BackPropagation& back_propagation) const
 {
     const Index instances_number = inputs.dimension(0);
-    const Index inputs_number = get_inputs_number();
     const Index neurons_number = get_neurons_number();
 
-    const Index parameters_number = inputs_number*neurons_number;
+    Tensor<Index, 1> steps_offsets;
+    Tensor<Index, 1> steps_sizes;
 
-    // Derivatives of combinations_2d with respect to input weights
+    calculate_steps(instances_number, steps_offsets, steps_sizes);
 
-    Tensor<type, 2> combinations_weights_derivatives(parameters_number, neurons_number);
+    const Index steps_number = steps_sizes.size();
 
-    Index column_index = 0;
-    Index input_index = 0;
+    const Tensor<type, 2> sorted_inputs = sort_by_timesteps(inputs, steps_offsets, steps_sizes);
 
-    Tensor<type, 1> input_weights_gradient(parameters_number);
+    const Tensor<type, 2> sorted_activations
+            = sort_by_timesteps(forward_propagation.activations_2d, steps_offsets, steps_sizes);
 
-    for(Index instance = 0; instance < instances_number; instance++)
-    {
-        const Tensor<type, 1> current_inputs = inputs.chip(instance, 0);
+    const Tensor<type, 2> sorted_activations_derivatives
+            = sort_by_timesteps(forward_propagation.activations_derivatives_2d, steps_offsets, steps_sizes);
 
-        const Tensor<type, 1> current_layer_deltas = deltas.chip(instance, 0);//get_row(instance).to_column_matrix();
+    // Derivatives of the error with respect to the combinations
 
-        if(instance%timesteps == 0)
-        {
-            combinations_weights_derivatives.setZero();
-        }
-        else
-        {
-            const Tensor<type, 1> previous_activation_derivatives = layers.activations_derivatives_2d.chip(instance-1, 0);//.get_row(instance-1);
+    Tensor<type, 2> combinations_derivatives = sort_by_timesteps(back_propagation.delta, steps_offsets, steps_sizes);
 
-//            combinations_weights_derivatives = dot(combinations_weights_derivatives.multiply_rows(previous_activation_derivatives), recurrent_weights);
-            combinations_weights_derivatives = (multiply_rows(combinations_weights_derivatives, previous_activation_derivatives)).contract(recurrent_weights,A_B);
-        }
+    for(Index t = steps_number-1; t > 0; t--)
+    {
+        const Eigen::array<Index, 2> step_offsets({steps_offsets(t), 0});
+        const Eigen::array<Index, 2> previous_offsets({steps_offsets(t-1), 0});
+        const Eigen::array<Index, 2> step_extents({steps_sizes(t), neurons_number});
 
-        column_index = 0;
-        input_index = 0;
+        combinations_derivatives.slice(previous_offsets, step_extents).device(*thread_pool_device)
+                += combinations_derivatives.slice(step_offsets, step_extents).contract(recurrent_weights, A_BT)
+                 * sorted_activations_derivatives.slice(previous_offsets, step_extents);
+    }
 
-        for(Index i = 0; i < parameters_number; i++)
-        {
-            combinations_weights_derivatives(i, column_index) += current_inputs(input_index);
+    // Hidden states of the previous timestep, which are zero for the first timestep
 
-            input_index++;
+    Tensor<type, 2> previous_hidden_states(instances_number, neurons_number);
 
-            if(input_index == inputs_number)
-            {
-                input_index = 0;
-                column_index++;
-            }
-        }
+    previous_hidden_states.setZero();
 
-//        input_weights_gradient += dot(combinations_weights_derivatives, current_layer_deltas).to_vector();
-        input_weights_gradient += combinations_weights_derivatives.contract(current_layer_deltas, A_BT);
+    for(Index t = 1; t < steps_number; t++)
+    {
+        const Eigen::array<Index, 2> step_extents({steps_sizes(t), neurons_number});
 
+        previous_hidden_states.slice(Eigen::array<Index, 2>({steps_offsets(t), 0}), step_extents)
+                = sorted_activations.slice(Eigen::array<Index, 2>({steps_offsets(t-1), 0}), step_extents);
     }
 
-    return input_weights_gradient;
-}
+    back_propagation.biases_derivatives.device(*thread_pool_device)
+            = combinations_derivatives.sum(Eigen::array<Index, 1>({0}));
 
+    back_propagation.synaptic_weights_derivatives.device(*thread_pool_device)
+            = sorted_inputs.contract(combinations_derivatives, AT_B);
 
-Tensor<type, 1> RecurrentLayer::calculate_recurrent_weights_error_gradient(const Tensor<type, 2> &,
-        const Layer::ForwardPropagation& forward_propagation,
-        const Tensor<type, 2> & deltas)
-{
-    const Index instances_number = deltas.dimension(0);
-    const Index neurons_number = get_neurons_number();
+    back_propagation.recurrent_weights_derivatives.device(*thread_pool_device)
+            = previous_hidden_states.contract(combinations_derivatives, AT_B);
+}
 
-    const Index parameters_number = neurons_number*neurons_number;
 
-    // Derivatives of combinations_2d with respect to recurrent weights
+/// Returns the derivatives of the error with respect to the parameters of the layer, in the same order as get_parameters().
+/// @param inputs Inputs to the layer, where each sequence is made of timesteps consecutive rows.
+/// @param forward_propagation Forward propagation of the layer for those inputs.
+/// @param deltas Derivatives of the error with respect to the combinations of the layer.
 
-    Tensor<type, 2> combinations_recurrent_weights_derivatives(parameters_number, neurons_number);
+Tensor<type, 1> RecurrentLayer::calculate_error_gradient(const Tensor<type, 2>& inputs,
+                                                         const Layer::ForwardPropagation& forward_propagation,
+                                                         const Tensor<type, 2>& deltas)
+{
+    BackPropagation back_propagation(inputs.dimension(0), this);
 
-    Tensor<type, 1> recurrent_weights_gradient(parameters_number);
+    back_propagation.delta = deltas;
 
-    for(Index instance = 0; instance < instances_number-1; instance++)
-    {
-        Tensor<type, 1> current_activations = forward_propagation.activations_2d.chip(instance, 0);
+    calculate_error_gradient(inputs, forward_propagation, back_propagation);
 
-        const Tensor<type, 1> next_layer_deltas = deltas.chip(instance+1,0);//get_row(instance+1).to_column_matrix();
+    Tensor<type, 1> error_gradient(get_parameters_number());
 
-        if((instance+1)%timesteps == 0)
-        {
-            combinations_recurrent_weights_derivatives.setZero();
-        }
-        else
-        {
-            const Tensor<type, 1> activation_derivatives = forward_propagation.activations_derivatives_2d.chip(instance, 0);
+    insert_gradient(back_propagation, 0, error_gradient);
 
-//            combinations_recurrent_weights_derivatives = dot(combinations_recurrent_weights_derivatives.multiply_rows(activation_derivatives), recurrent_weights);
-            combinations_recurrent_weights_derivatives = (multiply_rows(combinations_recurrent_weights_derivatives, activation_derivatives)).contract(recurrent_weights,A_B);
+    return error_gradient;
+}
 
-            Index column_index = 0;
-            Index activation_index = 0;
 
-            for(Index i = 0; i < parameters_number; i++)
-            {
-                combinations_recurrent_weights_derivatives(i, column_index) += current_activations(activation_index);
+/// Copies the derivatives of the error with respect to the parameters of the layer into the gradient.
+/// The order is the same as in get_parameters(): input weights, biases and recurrent weights.
+/// @param back_propagation Structure with the derivatives of the layer.
+/// @param index Position of the first parameter of the layer in the gradient.
+/// @param gradient Gradient of the whole neural network.
 
-                activation_index++;
+void RecurrentLayer::insert_gradient(const BackPropagation& back_propagation, const Index& index, Tensor<type, 1>& gradient) const
+{
+    const Index input_weights_number = get_input_weights_number();
+    const Index biases_number = get_biases_number();
+    const Index recurrent_weights_number = get_recurrent_weights_number();
 
-                if(activation_index == neurons_number)
-                {
-                    activation_index = 0;
-                    column_index++;
-                }
-            }
-        }
+    memcpy(gradient.data() + index,
+           back_propagation.synaptic_weights_derivatives.data(),
+           static_cast<size_t>(input_weights_number)*sizeof(type));
 
-//        recurrent_weights_gradient += dot(combinations_recurrent_weights_derivatives, next_layer_deltas).to_vector();
-        recurrent_weights_gradient += combinations_recurrent_weights_derivatives.contract(next_layer_deltas, A_BT);
-    }
+    memcpy(gradient.data() + index + input_weights_number,
+           back_propagation.biases_derivatives.data(),
+           static_cast<size_t>(biases_number)*sizeof(type));
 
-    return recurrent_weights_gradient;
+    memcpy(gradient.data() + index + input_weights_number + biases_number,
+           back_propagation.recurrent_weights_derivatives.data(),
+           static_cast<size_t>(recurrent_weights_number)*sizeof(type));
 }
 
 
+/// Calculates the rows of each timestep when the instances are ordered by timestep.
+/// Each sequence is made of timesteps consecutive instances, and the last sequence might be shorter.
+/// @param instances_number Number of instances.
+/// @param steps_offsets Position of the first row of each timestep.
+/// @param steps_sizes Number of sequences which reach each timestep.
 
-Tensor<type, 1> RecurrentLayer::calculate_biases_error_gradient(const Tensor<type, 2> & inputs,
-        const Layer::ForwardPropagation& layers,
-        const Tensor<type, 2> & deltas)
+void RecurrentLayer::calculate_steps(const Index& instances_number,
+                                     Tensor<Index, 1>& steps_offsets,
+                                     Tensor<Index, 1>& steps_sizes) const
 {
-    const Index instances_number = inputs.dimension(0);
-    const Index neurons_number = get_neurons_number();
-
-    const Index biases_number = get_biases_number();
+    const Index steps_number = min(timesteps, instances_number);
 
-    // Derivatives of combinations_2d with respect to biases
+    steps_offsets.resize(steps_number);
+    steps_sizes.resize(steps_number);
 
-    Tensor<type, 2> combinations_biases_derivatives(biases_number, neurons_number);
+    Index offset = 0;
 
-    Tensor<type, 1> biases_gradient(biases_number);
-    biases_gradient.setZero();
-
-    for(Index instance = 0; instance < instances_number; instance++)
+    for(Index t = 0; t < steps_number; t++)
     {
-        const Tensor<type, 1> current_inputs = inputs.chip(instance, 0);
-
-        const Tensor<type, 1> current_layer_deltas = deltas.chip(instance,0);//.get_row(instance).to_column_matrix();
-
-        if(instance%timesteps == 0)
-        {
-            combinations_biases_derivatives.setZero();
-        }
-        else
-        {
-            const Tensor<type, 1> previous_activation_derivatives = layers.activations_derivatives_2d.chip(instance-1,0);//get_row(instance-1);
-
-//            combinations_biases_derivatives = dot(combinations_biases_derivatives.multiply_rows(previous_activation_derivatives), recurrent_weights);
-              combinations_biases_derivatives = (multiply_rows(combinations_biases_derivatives,previous_activation_derivatives)).contract(recurrent_weights, A_B);
-        }
-
-//        combinations_biases_derivatives.sum_diagonal(1.0);
-        for(Index i = 0; i < biases_number; i++)
-            combinations_biases_derivatives(i,i) += static_cast<type>(1.0);
+        steps_offsets(t) = offset;
+        steps_sizes(t) = (instances_number - 1 - t)/timesteps + 1;
 
-//        biases_gradient += dot(combinations_biases_derivatives, current_layer_deltas).to_vector();
-        biases_gradient += combinations_biases_derivatives.contract(current_layer_deltas, A_BT);
+        offset += steps_sizes(t);
     }
-
-    return biases_gradient;
 }
 
-Tensor<type, 2> RecurrentLayer::multiply_rows(const Tensor<type, 2>& matrix, const Tensor<type, 1>& vector) const
+
+/// Returns the rows of a matrix ordered by timestep instead of by sequence,
+/// so that the rows of all the sequences at the same timestep are contiguous.
+/// @param matrix Matrix with one row for each instance.
+/// @param steps_offsets Position of the first row of each timestep.
+/// @param steps_sizes Number of sequences which reach each timestep.
+
+Tensor<type, 2> RecurrentLayer::sort_by_timesteps(const Tensor<type, 2>& matrix,
+                                                  const Tensor<Index, 1>& steps_offsets,
+                                                  const Tensor<Index, 1>& steps_sizes) const
 {
-    const Index columns_number = matrix.dimension(1);
     const Index rows_number = matrix.dimension(0);
+    const Index columns_number = matrix.dimension(1);
 
-    Tensor<type, 2> new_matrix(rows_number, columns_number);
+    Tensor<type, 2> sorted_matrix(rows_number, columns_number);
 
-    for(Index i = 0; i < rows_number; i++)
+    for(Index t = 0; t < steps_sizes.size(); t++)
     {
-        for(Index j = 0; j < columns_number; j++)
+        for(Index s = 0; s < steps_sizes(t); s++)
         {
-           new_matrix(i,j) = matrix(i,j) * vector(j);
+            for(Index j = 0; j < columns_number; j++)
+            {
+                sorted_matrix(steps_offsets(t) + s, j) = matrix(s*timesteps + t, j);
+            }
         }
     }
 
-    return new_matrix;
+    return sorted_matrix;
 }
 
 
-/// Returns a string with the expression of the inputs-outputs relationship of the layer.
-/// @param inputs_names Vector of strings with the name of the layer inputs.
-/// @param outputs_names Vector of strings with the name of the layer outputs.
-
 string RecurrentLayer::write_expression(const Tensor<string, 1>& inputs_names, const Tensor<string, 1>& outputs_names) const
 {
 #ifdef __OPENNN_DEBUG__
@@ -84,7 +84,6 @@ public:
    Index get_inputs_number() const;
    Index get_neurons_number() const;
 
-   Tensor<type, 1> get_hidden_states() const;
 
    // Parameters
 
@@ -152,7 +151,6 @@ public:
 
    // Parameters initialization methods
 
-   void initialize_hidden_states(const type&);
 
    void set_biases_constant(const type&);
 
@@ -164,21 +162,6 @@ public:
 
    void set_parameters_random();
 
-   // neuron layer combinations_2d
-
-   void calculate_combinations(const Tensor<type, 2>& inputs,
-                               const Tensor<type, 2>& input_weights,
-                               const Tensor<type, 2>& biases,
-                               const Tensor<type, 2>& recurrent_weights,
-                               Tensor<type, 2>& combinations_2d);
-
-   void calculate_combinations(const Tensor<type, 1>& inputs,
-                               const Tensor<type, 2>& input_weights,
-                               const Tensor<type, 2>& biases,
-                               const Tensor<type, 2>& recurrent_weights,
-                               Tensor<type, 1>& combinations_1d) const;
-
-
    // neuron layer activations_2d
 
    void calculate_activations(const Tensor<type, 1>& combinations_1d, Tensor<type, 1>& activations_1d) const;
@@ -194,48 +177,33 @@ public:
 
    // neuron layer outputs
 
-   void update_hidden_states(const Tensor<type, 1>&);
-
    Tensor<type, 2> calculate_outputs(const Tensor<type, 2>&);
 
    Tensor<type, 2> calculate_hidden_delta(Layer*, const Tensor<type, 2>&, const Tensor<type, 2>&, const Tensor<type, 2>&) const;
 
-   void forward_propagate(const Tensor<type, 2>& inputs, ForwardPropagation& forward_propagation)
-   {/*
+   // Recurrent layer forward propagation
 
-       const Index instances_number = inputs.dimension(0);
-       const Index neurons_number = get_neurons_number();
+   void forward_propagate(const Tensor<type, 2>&, ForwardPropagation&) const;
 
-       Tensor<type, 1> combinations_1d(forward_propagation.combinations_2d.dimension(1));
-       Tensor<type, 1> activations_derivatives_1d(forward_propagation.combinations_2d.dimension(1));
+   void forward_propagate(const Tensor<type, 2>&, const TensorMap<Tensor<type, 1>>&, ForwardPropagation&) const;
 
-       for(Index i = 0; i < instances_number; i++)
-       {
-           if(i%timesteps == 0) hidden_states.setZero();
+   // Recurrent layer delta methods
 
-           const Tensor<type, 1> current_inputs = inputs.chip(i, 1);
+   void calculate_output_delta(ForwardPropagation&, const Tensor<type, 2>&, Tensor<type, 2>&) const;
 
-           calculate_combinations(current_inputs, input_weights, biases, recurrent_weights, combinations_1d);
-
-           calculate_activations_derivatives(combinations_1d, hidden_states, activations_derivatives_1d);
-
-           for(Index j = 0; j < neurons_number; j++)
-           {
-               forward_propagation.combinations_2d(i,j) = combinations_1d(j);
-               forward_propagation.activations_2d(i,j) = hidden_states(j);
-               forward_propagation.activations_derivatives_2d(i,j) = activations_derivatives_1d(j);
-           }
-       }
-       */
-   }
+   void calculate_hidden_delta(Layer*,
+                               const Tensor<type, 2>&,
+                               ForwardPropagation&,
+                               const Tensor<type, 2>&,
+                               Tensor<type, 2>&) const;
 
    // Gradient
 
+   void calculate_error_gradient(const Tensor<type, 2>&, const Layer::ForwardPropagation&, Layer::BackPropagation&) const;
+
    Tensor<type, 1> calculate_error_gradient(const Tensor<type, 2>&, const Layer::ForwardPropagation&, const Tensor<type, 2>&);
 
-   Tensor<type, 1> calculate_input_weights_error_gradient(const Tensor<type, 2>&, const Layer::ForwardPropagation&, const Tensor<type, 2>&);
-   Tensor<type, 1> calculate_recurrent_weights_error_gradient(const Tensor<type, 2>&, const Layer::ForwardPropagation&, const Tensor<type, 2>&);
-   Tensor<type, 1> calculate_biases_error_gradient(const Tensor<type, 2>&, const Layer::ForwardPropagation&, const Tensor<type, 2>&);
+   void insert_gradient(const BackPropagation&, const Index&, Tensor<type, 1>&) const;
 
    // Expression methods
 
@@ -244,7 +212,9 @@ public:
 
    // Utilities
 
-   Tensor<type, 2> multiply_rows(const Tensor<type,2>&, const Tensor<type,1>&) const;
+   void calculate_steps(const Index&, Tensor<Index, 1>&, Tensor<Index, 1>&) const;
+
+   Tensor<type, 2> sort_by_timesteps(const Tensor<type, 2>&, const Tensor<Index, 1>&, const Tensor<Index, 1>&) const;
 
    // Serialization methods
 
@@ -271,8 +241,6 @@ protected:
 
    ActivationFunction activation_function = HyperbolicTangent;
 
-   Tensor<type, 1> hidden_states;
-
    /// Display messages to screen.
 
    bool display;
@@ -835,7 +835,7 @@ Tensor<type, 2> ScalingLayer::calculate_outputs(const Tensor<type, 2>& inputs)
                              << "Those variables won't be scaled.\n";
                     }
 
-                    outputs(j) = inputs(j);
+                    outputs(i,j) = inputs(i,j);
                 }
                 else
                 {
@@ -1223,6 +1223,63 @@ string ScalingLayer::write_expression_c() const
 }
 
 
+/// Returns the C function of the scaling layer for a batch of inputs, which are stored by rows.
+/// Each scaling method is written as a slope and an intercept for each input.
+
+string ScalingLayer::write_batch_expression_c() const
+{
+    const Index neurons_number = get_neurons_number();
+
+    Tensor<type, 1> slopes(neurons_number);
+    Tensor<type, 1> intercepts(neurons_number);
+
+    slopes.setConstant(1);
+    intercepts.setZero();
+
+    for(Index i = 0; i < neurons_number; i++)
+    {
+        if(abs(descriptives(i).minimum - descriptives(i).maximum) < numeric_limits<type>::min())
+        {
+            continue;
+        }
+        else if(scaling_methods(i) == MinimumMaximum)
+        {
+            slopes(i) = static_cast<type>(2)/(descriptives(i).maximum-descriptives(i).minimum);
+
+            intercepts(i) = -(descriptives(i).maximum + descriptives(i).minimum)/(descriptives(i).maximum - descriptives(i).minimum);
+        }
+        else if(scaling_methods(i) == MeanStandardDeviation)
+        {
+            slopes(i) = static_cast<type>(2)/descriptives(i).standard_deviation;
+
+            intercepts(i) = -static_cast<type>(2)*descriptives(i).mean/descriptives(i).standard_deviation;
+        }
+        else if(scaling_methods(i) == StandardDeviation)
+        {
+            slopes(i) = static_cast<type>(1)/descriptives(i).standard_deviation;
+        }
+    }
+
+    ostringstream buffer;
+
+    buffer << write_array_c(layer_name + "_slopes", slopes.data(), neurons_number);
+    buffer << write_array_c(layer_name + "_intercepts", intercepts.data(), neurons_number);
+
+    buffer << "static void " << layer_name << "(const float* inputs, float* outputs, int batch_size)\n{" << endl;
+
+    buffer << "\tfor(int i = 0; i < batch_size; i++)\n\t{" << endl;
+    buffer << "\t\tfor(int j = 0; j < " << neurons_number << "; j++)\n\t\t{" << endl;
+    buffer << "\t\t\toutputs[i*" << neurons_number << " + j] = inputs[i*" << neurons_number << " + j]*"
+           << layer_name << "_slopes[j] + " << layer_name << "_intercepts[j];" << endl;
+    buffer << "\t\t}" << endl;
+    buffer << "\t}" << endl;
+
+    buffer << "}\n" << endl;
+
+    return buffer.str();
+}
+
+
 string ScalingLayer::write_expression_python() const
 {
     const Index neurons_number = get_neurons_number();
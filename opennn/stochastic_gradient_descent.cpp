@@ -104,6 +104,14 @@ const type& StochasticGradientDescent::get_maximum_time() const
 }
 
 
+/// Returns the maximum number of epochs for training.
+
+const Index& StochasticGradientDescent::get_maximum_epochs_number() const
+{
+    return maximum_epochs_number;
+}
+
+
 /// Returns true if the final model will be the neural network with the minimum selection error, false otherwise.
 
 const bool& StochasticGradientDescent::get_choose_best_selection() const
@@ -474,7 +482,14 @@ OptimizationAlgorithm::Results StochasticGradientDescent::perform_training()
     Tensor<Index, 2> training_batches(training_batches_number, batch_instances_number);
 
     DataSet::Batch selection_batch(selection_instances_number, data_set_pointer);
-    selection_batch.fill(selection_instances_indices, input_variables_indices, target_variables_indices);
+
+    start_profile();
+
+    {
+        OPENNN_PROFILE_SCOPE(&profiler, TrainingProfiler::BatchFill);
+
+        selection_batch.fill(selection_instances_indices, input_variables_indices, target_variables_indices);
+    }
 
     // Neural network
 
@@ -514,13 +529,47 @@ OptimizationAlgorithm::Results StochasticGradientDescent::perform_training()
 
     bool shuffle = false;
 
+    // Checkpoint
+
+    TrainingCheckpoint checkpoint;
+
+    Index initial_epoch = 0;
+
+    if(start_checkpoints(checkpoint, results))
+    {
+        initial_epoch = checkpoint.get_epoch();
+
+        beginning_time -= static_cast<time_t>(checkpoint.get_elapsed_time());
+
+        optimization_data.parameters = checkpoint.get_vector("parameters");
+        optimization_data.last_parameters_increment = checkpoint.get_vector("last_parameters_increment");
+
+        minimal_selection_parameters = checkpoint.get_vector("minimal_selection_parameters");
+        minimum_selection_error = checkpoint.get_scalar("minimum_selection_error");
+        old_selection_error = checkpoint.get_scalar("old_selection_error");
+        selection_error_increases = checkpoint.get_index("selection_error_increases");
+
+        neural_network_pointer->set_parameters(optimization_data.parameters);
+    }
+
+    // Observers
+
+    begin_observers();
+
+    TrainingObserver::Metrics metrics;
+
+    bool stop_requested = false;
+
     // Main loop
 
-    for(Index epoch = 0; epoch <= epochs_number; epoch++)
+    for(Index epoch = initial_epoch; epoch <= epochs_number; epoch++)
     {
+        begin_epoch_profile(epoch);
+
         training_batches = data_set_pointer->get_batches(training_instances_indices,
                                                          batch_instances_number,
-                                                         shuffle);
+                                                         shuffle,
+                                                         get_epoch_random_generator(epoch));
 
         training_error = 0;
         training_loss = 0;
@@ -529,10 +578,23 @@ OptimizationAlgorithm::Results StochasticGradientDescent::perform_training()
 
         for(Index iteration = 0; iteration < training_batches_number; iteration++)
         {
+            // Training control
+
+            if(iteration != 0 && check_training_control())
+            {
+                stop_requested = true;
+
+                break;
+            }
+
             // Data set
 
-            batch.fill(training_batches.chip(iteration,0),
-                       input_variables_indices, target_variables_indices);
+            {
+                OPENNN_PROFILE_SCOPE(&profiler, TrainingProfiler::BatchFill);
+
+                batch.fill(training_batches.chip(iteration,0),
+                           input_variables_indices, target_variables_indices);
+            }
 
             // Neural network
 
@@ -547,19 +609,40 @@ OptimizationAlgorithm::Results StochasticGradientDescent::perform_training()
             training_error += back_propagation.error;
             training_loss += back_propagation.loss;
 
+            if(has_observers())
+            {
+                metrics.epoch = epoch;
+                metrics.iteration = iteration;
+                metrics.iterations_number = epoch*training_batches_number + iteration + 1;
+                metrics.instances_number = batch_instances_number;
+                metrics.training_loss = back_propagation.loss;
+                metrics.training_error = back_propagation.error;
+                metrics.selection_error = numeric_limits<type>::quiet_NaN();
+                metrics.gradient_norm = l2_norm(back_propagation.gradient);
+                metrics.learning_rate = initial_learning_rate/(1 + optimization_data.iteration*initial_decay);
+            }
+
             // Optimization algorithm
 
-            update_iteration(back_propagation, optimization_data);
+            {
+                OPENNN_PROFILE_SCOPE(&profiler, TrainingProfiler::UpdateIteration);
+
+                update_iteration(back_propagation, optimization_data);
+            }
 
-            neural_network_pointer->set_parameters(optimization_data.parameters);
+            {
+                OPENNN_PROFILE_SCOPE(&profiler, TrainingProfiler::SetParameters);
 
+                neural_network_pointer->set_parameters(optimization_data.parameters);
+            }
 
+            notify_iteration(metrics);
         }
 
         // Loss
 
-        training_error /= static_cast<type>(training_batches_number);
-        training_loss /= static_cast<type>(training_batches_number);
+        training_error /= static_cast<type>(optimization_data.iteration);
+        training_loss /= static_cast<type>(optimization_data.iteration);
 
         if(has_selection)
         {
@@ -621,6 +704,30 @@ OptimizationAlgorithm::Results StochasticGradientDescent::perform_training()
             results.stopping_condition = MaximumTime;
         }
 
+        if(!stop_training && (stop_requested || check_training_control()))
+        {
+            if(display) cout << "Epoch " << epoch+1 << ": Stop requested.\n";
+
+            stop_training = true;
+
+            results.stopping_condition = StopRequested;
+        }
+
+        if(has_observers())
+        {
+            metrics.epoch = epoch;
+            metrics.iteration = optimization_data.iteration;
+            metrics.iterations_number = epoch*training_batches_number + optimization_data.iteration;
+            metrics.instances_number = optimization_data.iteration*batch_instances_number;
+            metrics.training_loss = training_loss;
+            metrics.training_error = training_error;
+            metrics.selection_error = has_selection ? selection_back_propagation.error : numeric_limits<type>::quiet_NaN();
+            metrics.gradient_norm = l2_norm(back_propagation.gradient);
+            metrics.learning_rate = initial_learning_rate/(1 + (optimization_data.iteration-1)*initial_decay);
+
+            notify_epoch(metrics);
+        }
+
         if(epoch != 0 && epoch % save_period == 0)
         {
             neural_network_pointer->save(neural_network_file_name);
@@ -663,8 +770,27 @@ OptimizationAlgorithm::Results StochasticGradientDescent::perform_training()
         old_selection_error = selection_back_propagation.error;
 
         if(stop_training) break;
+
+        if(is_checkpoint_epoch(epoch+1))
+        {
+            checkpoint.set_vector("parameters", optimization_data.parameters);
+            checkpoint.set_vector("last_parameters_increment", optimization_data.last_parameters_increment);
+
+            checkpoint.set_vector("minimal_selection_parameters", minimal_selection_parameters);
+            checkpoint.set_scalar("minimum_selection_error", minimum_selection_error);
+            checkpoint.set_scalar("old_selection_error", old_selection_error);
+            checkpoint.set_index("selection_error_increases", selection_error_increases);
+
+            write_checkpoint(checkpoint, results, epoch+1, elapsed_time);
+        }
     }
 
+    wait_checkpoint();
+
+    finish_profile(results);
+
+    end_observers(results);
+
     if(has_selection && choose_best_selection)
     {
         optimization_data.parameters = minimal_selection_parameters;
@@ -1011,6 +1137,11 @@ void StochasticGradientDescent::write_XML(tinyxml2::XMLPrinter& file_stream) con
     file_stream.PushText(buffer.str().c_str());
 
     file_stream.CloseElement();
+
+    // Checkpoints
+
+    write_checkpoints_XML(file_stream);
+
     file_stream.CloseElement();
 }
 
@@ -1196,6 +1327,10 @@ void StochasticGradientDescent::from_XML(const tinyxml2::XMLDocument& document)
             }
         }
     }
+
+    // Checkpoints
+
+    checkpoints_from_XML(root_element);
 }
 
 }
@@ -133,6 +133,7 @@ public:
 
    const type& get_loss_goal() const;
    const type& get_maximum_time() const;
+   const Index& get_maximum_epochs_number() const;
    const bool& get_choose_best_selection() const;
 
    // Reserve training history
@@ -0,0 +1,616 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   T R A I N I N G   C H E C K P O I N T   C L A S S
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#include "training_checkpoint.h"
+
+namespace OpenNN
+{
+
+/// Default constructor.
+/// It creates an empty training checkpoint.
+
+TrainingCheckpoint::TrainingCheckpoint()
+{
+}
+
+
+/// Destructor.
+
+TrainingCheckpoint::~TrainingCheckpoint()
+{
+}
+
+
+/// Returns the type of the optimization algorithm which wrote the checkpoint.
+
+const string& TrainingCheckpoint::get_optimization_algorithm_type() const
+{
+    return optimization_algorithm_type;
+}
+
+
+/// Returns the epoch from which the training is resumed.
+
+const Index& TrainingCheckpoint::get_epoch() const
+{
+    return epoch;
+}
+
+
+/// Returns the elapsed time of the training before the epoch from which it is resumed.
+
+const type& TrainingCheckpoint::get_elapsed_time() const
+{
+    return elapsed_time;
+}
+
+
+/// Returns the seed of the random numbers of the training.
+
+const unsigned& TrainingCheckpoint::get_random_seed() const
+{
+    return random_seed;
+}
+
+
+/// Returns true if the checkpoint has a vector with the given name, and false otherwise.
+/// @param name Name of the vector.
+
+bool TrainingCheckpoint::has_vector(const string& name) const
+{
+    return vectors.find(name) != vectors.end();
+}
+
+
+/// Returns true if the checkpoint has a matrix with the given name, and false otherwise.
+/// @param name Name of the matrix.
+
+bool TrainingCheckpoint::has_matrix(const string& name) const
+{
+    return matrices.find(name) != matrices.end();
+}
+
+
+/// Returns true if the checkpoint has a scalar with the given name, and false otherwise.
+/// @param name Name of the scalar.
+
+bool TrainingCheckpoint::has_scalar(const string& name) const
+{
+    return scalars.find(name) != scalars.end();
+}
+
+
+/// Returns true if the checkpoint has an index with the given name, and false otherwise.
+/// @param name Name of the index.
+
+bool TrainingCheckpoint::has_index(const string& name) const
+{
+    return indices.find(name) != indices.end();
+}
+
+
+/// Returns the vector with the given name.
+/// @param name Name of the vector.
+
+const Tensor<type, 1>& TrainingCheckpoint::get_vector(const string& name) const
+{
+    const map<string, Tensor<type, 1>>::const_iterator iterator = vectors.find(name);
+
+    if(iterator == vectors.end())
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: TrainingCheckpoint class.\n"
+               << "const Tensor<type, 1>& get_vector(const string&) const method.\n"
+               << "Checkpoint does not have vector " << name << ".\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    return iterator->second;
+}
+
+
+/// Returns the matrix with the given name.
+/// @param name Name of the matrix.
+
+const Tensor<type, 2>& TrainingCheckpoint::get_matrix(const string& name) const
+{
+    const map<string, Tensor<type, 2>>::const_iterator iterator = matrices.find(name);
+
+    if(iterator == matrices.end())
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: TrainingCheckpoint class.\n"
+               << "const Tensor<type, 2>& get_matrix(const string&) const method.\n"
+               << "Checkpoint does not have matrix " << name << ".\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    return iterator->second;
+}
+
+
+/// Returns the scalar with the given name.
+/// @param name Name of the scalar.
+
+const type& TrainingCheckpoint::get_scalar(const string& name) const
+{
+    const map<string, type>::const_iterator iterator = scalars.find(name);
+
+    if(iterator == scalars.end())
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: TrainingCheckpoint class.\n"
+               << "const type& get_scalar(const string&) const method.\n"
+               << "Checkpoint does not have scalar " << name << ".\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    return iterator->second;
+}
+
+
+/// Returns the index with the given name.
+/// @param name Name of the index.
+
+const Index& TrainingCheckpoint::get_index(const string& name) const
+{
+    const map<string, Index>::const_iterator iterator = indices.find(name);
+
+    if(iterator == indices.end())
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: TrainingCheckpoint class.\n"
+               << "const Index& get_index(const string&) const method.\n"
+               << "Checkpoint does not have index " << name << ".\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    return iterator->second;
+}
+
+
+/// Sets the type of the optimization algorithm which writes the checkpoint.
+/// @param new_optimization_algorithm_type Type of the optimization algorithm.
+
+void TrainingCheckpoint::set_optimization_algorithm_type(const string& new_optimization_algorithm_type)
+{
+    optimization_algorithm_type = new_optimization_algorithm_type;
+}
+
+
+/// Sets the epoch from which the training is resumed.
+/// @param new_epoch Epoch number.
+
+void TrainingCheckpoint::set_epoch(const Index& new_epoch)
+{
+    epoch = new_epoch;
+}
+
+
+/// Sets the elapsed time of the training before the epoch from which it is resumed.
+/// @param new_elapsed_time Elapsed time in seconds.
+
+void TrainingCheckpoint::set_elapsed_time(const type& new_elapsed_time)
+{
+    elapsed_time = new_elapsed_time;
+}
+
+
+/// Sets the seed of the random numbers of the training.
+/// @param new_random_seed Random seed.
+
+void TrainingCheckpoint::set_random_seed(const unsigned& new_random_seed)
+{
+    random_seed = new_random_seed;
+}
+
+
+/// Sets a vector of the state of the optimization algorithm.
+/// @param name Name of the vector.
+/// @param new_vector Values of the vector.
+
+void TrainingCheckpoint::set_vector(const string& name, const Tensor<type, 1>& new_vector)
+{
+    vectors[name] = new_vector;
+}
+
+
+/// Sets a matrix of the state of the optimization algorithm.
+/// @param name Name of the matrix.
+/// @param new_matrix Values of the matrix.
+
+void TrainingCheckpoint::set_matrix(const string& name, const Tensor<type, 2>& new_matrix)
+{
+    matrices[name] = new_matrix;
+}
+
+
+/// Sets a scalar of the state of the optimization algorithm.
+/// @param name Name of the scalar.
+/// @param new_scalar Value of the scalar.
+
+void TrainingCheckpoint::set_scalar(const string& name, const type& new_scalar)
+{
+    scalars[name] = new_scalar;
+}
+
+
+/// Sets an index of the state of the optimization algorithm.
+/// @param name Name of the index.
+/// @param new_index Value of the index.
+
+void TrainingCheckpoint::set_index(const string& name, const Index& new_index)
+{
+    indices[name] = new_index;
+}
+
+
+/// Saves the checkpoint to a binary file.
+/// The file has a header with the sizes of the types, an endianness tag and the checksum of the contents.
+/// @param file_name Name of checkpoint file.
+
+void TrainingCheckpoint::save(const string& file_name) const
+{
+    ostringstream contents;
+
+    write_string(contents, optimization_algorithm_type);
+
+    contents.write(reinterpret_cast<const char*>(&epoch), sizeof(Index));
+    contents.write(reinterpret_cast<const char*>(&elapsed_time), sizeof(type));
+    contents.write(reinterpret_cast<const char*>(&random_seed), sizeof(unsigned));
+
+    // Vectors
+
+    uint64_t entries_number = vectors.size();
+
+    contents.write(reinterpret_cast<const char*>(&entries_number), sizeof(uint64_t));
+
+    for(map<string, Tensor<type, 1>>::const_iterator iterator = vectors.begin(); iterator != vectors.end(); ++iterator)
+    {
+        const Index size = iterator->second.size();
+
+        write_string(contents, iterator->first);
+
+        contents.write(reinterpret_cast<const char*>(&size), sizeof(Index));
+        contents.write(reinterpret_cast<const char*>(iterator->second.data()), static_cast<streamsize>(size*sizeof(type)));
+    }
+
+    // Matrices
+
+    entries_number = matrices.size();
+
+    contents.write(reinterpret_cast<const char*>(&entries_number), sizeof(uint64_t));
+
+    for(map<string, Tensor<type, 2>>::const_iterator iterator = matrices.begin(); iterator != matrices.end(); ++iterator)
+    {
+        const Index rows_number = iterator->second.dimension(0);
+        const Index columns_number = iterator->second.dimension(1);
+
+        write_string(contents, iterator->first);
+
+        contents.write(reinterpret_cast<const char*>(&rows_number), sizeof(Index));
+        contents.write(reinterpret_cast<const char*>(&columns_number), sizeof(Index));
+        contents.write(reinterpret_cast<const char*>(iterator->second.data()),
+                       static_cast<streamsize>(rows_number*columns_number*sizeof(type)));
+    }
+
+    // Scalars
+
+    entries_number = scalars.size();
+
+    contents.write(reinterpret_cast<const char*>(&entries_number), sizeof(uint64_t));
+
+    for(map<string, type>::const_iterator iterator = scalars.begin(); iterator != scalars.end(); ++iterator)
+    {
+        write_string(contents, iterator->first);
+
+        contents.write(reinterpret_cast<const char*>(&iterator->second), sizeof(type));
+    }
+
+    // Indices
+
+    entries_number = indices.size();
+
+    contents.write(reinterpret_cast<const char*>(&entries_number), sizeof(uint64_t));
+
+    for(map<string, Index>::const_iterator iterator = indices.begin(); iterator != indices.end(); ++iterator)
+    {
+        write_string(contents, iterator->first);
+
+        contents.write(reinterpret_cast<const char*>(&iterator->second), sizeof(Index));
+    }
+
+    // Header
+
+    const string contents_string = contents.str();
+
+    const uint32_t version = 1;
+    const uint32_t endianness = 0x01020304;
+    const uint32_t scalar_size = sizeof(type);
+    const uint32_t index_size = sizeof(Index);
+    const uint64_t contents_size = contents_string.size();
+    const uint64_t contents_checksum = calculate_checksum(contents_string.data(), contents_string.size());
+
+    ofstream file(file_name.c_str(), ios::binary);
+
+    if(!file.is_open())
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: TrainingCheckpoint class.\n"
+               << "void save(const string&) const method.\n"
+               << "Cannot open checkpoint file: " << file_name << "\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    file.write("OPENNNCP", 8);
+    file.write(reinterpret_cast<const char*>(&version), sizeof(uint32_t));
+    file.write(reinterpret_cast<const char*>(&endianness), sizeof(uint32_t));
+    file.write(reinterpret_cast<const char*>(&scalar_size), sizeof(uint32_t));
+    file.write(reinterpret_cast<const char*>(&index_size), sizeof(uint32_t));
+    file.write(reinterpret_cast<const char*>(&contents_size), sizeof(uint64_t));
+    file.write(reinterpret_cast<const char*>(&contents_checksum), sizeof(uint64_t));
+    file.write(contents_string.data(), static_cast<streamsize>(contents_string.size()));
+
+    file.close();
+
+    if(!file)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: TrainingCheckpoint class.\n"
+               << "void save(const string&) const method.\n"
+               << "Cannot write checkpoint file: " << file_name << "\n";
+
+        throw logic_error(buffer.str());
+    }
+}
+
+
+/// Loads the checkpoint from a binary file written by save.
+/// @param file_name Name of checkpoint file.
+
+void TrainingCheckpoint::load(const string& file_name)
+{
+    ostringstream buffer;
+
+    buffer << "OpenNN Exception: TrainingCheckpoint class.\n"
+           << "void load(const string&) method.\n";
+
+    ifstream file(file_name.c_str(), ios::binary);
+
+    if(!file.is_open())
+    {
+        buffer << "Cannot open checkpoint file: " << file_name << "\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    const string file_string((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+
+    const size_t header_size = 8 + 4*sizeof(uint32_t) + 2*sizeof(uint64_t);
+
+    if(file_string.size() < header_size || file_string.compare(0, 8, "OPENNNCP") != 0)
+    {
+        buffer << "File is not a checkpoint: " << file_name << "\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    const char* data = file_string.data() + 8;
+    const char* end = file_string.data() + file_string.size();
+
+    uint32_t version;
+    uint32_t endianness;
+    uint32_t scalar_size;
+    uint32_t index_size;
+    uint64_t contents_size;
+    uint64_t contents_checksum;
+
+    read_values(data, end, &version, sizeof(uint32_t));
+    read_values(data, end, &endianness, sizeof(uint32_t));
+    read_values(data, end, &scalar_size, sizeof(uint32_t));
+    read_values(data, end, &index_size, sizeof(uint32_t));
+    read_values(data, end, &contents_size, sizeof(uint64_t));
+    read_values(data, end, &contents_checksum, sizeof(uint64_t));
+
+    if(version != 1 || endianness != 0x01020304 || scalar_size != sizeof(type) || index_size != sizeof(Index))
+    {
+        buffer << "Checkpoint was written by a different version, byte order or type: " << file_name << "\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    if(static_cast<uint64_t>(end - data) != contents_size || calculate_checksum(data, contents_size) != contents_checksum)
+    {
+        buffer << "Checksum does not match: " << file_name << "\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    optimization_algorithm_type = read_string(data, end);
+
+    read_values(data, end, &epoch, sizeof(Index));
+    read_values(data, end, &elapsed_time, sizeof(type));
+    read_values(data, end, &random_seed, sizeof(unsigned));
+
+    vectors.clear();
+    matrices.clear();
+    scalars.clear();
+    indices.clear();
+
+    // Vectors
+
+    uint64_t entries_number;
+
+    read_values(data, end, &entries_number, sizeof(uint64_t));
+
+    for(uint64_t i = 0; i < entries_number; i++)
+    {
+        const string name = read_string(data, end);
+
+        Index size;
+
+        read_values(data, end, &size, sizeof(Index));
+
+        Tensor<type, 1>& new_vector = vectors[name];
+
+        new_vector.resize(size);
+
+        read_values(data, end, new_vector.data(), static_cast<size_t>(size)*sizeof(type));
+    }
+
+    // Matrices
+
+    read_values(data, end, &entries_number, sizeof(uint64_t));
+
+    for(uint64_t i = 0; i < entries_number; i++)
+    {
+        const string name = read_string(data, end);
+
+        Index rows_number;
+        Index columns_number;
+
+        read_values(data, end, &rows_number, sizeof(Index));
+        read_values(data, end, &columns_number, sizeof(Index));
+
+        Tensor<type, 2>& new_matrix = matrices[name];
+
+        new_matrix.resize(rows_number, columns_number);
+
+        read_values(data, end, new_matrix.data(), static_cast<size_t>(rows_number*columns_number)*sizeof(type));
+    }
+
+    // Scalars
+
+    read_values(data, end, &entries_number, sizeof(uint64_t));
+
+    for(uint64_t i = 0; i < entries_number; i++)
+    {
+        const string name = read_string(data, end);
+
+        read_values(data, end, &scalars[name], sizeof(type));
+    }
+
+    // Indices
+
+    read_values(data, end, &entries_number, sizeof(uint64_t));
+
+    for(uint64_t i = 0; i < entries_number; i++)
+    {
+        const string name = read_string(data, end);
+
+        read_values(data, end, &indices[name], sizeof(Index));
+    }
+}
+
+
+/// Writes a string to a binary stream, preceded by its size.
+
+void TrainingCheckpoint::write_string(ostream& stream, const string& text) const
+{
+    const uint64_t size = text.size();
+
+    stream.write(reinterpret_cast<const char*>(&size), sizeof(uint64_t));
+    stream.write(text.data(), static_cast<streamsize>(size));
+}
+
+
+/// Reads a string written by write_string and advances the data pointer.
+
+string TrainingCheckpoint::read_string(const char*& data, const char* end) const
+{
+    uint64_t size;
+
+    read_values(data, end, &size, sizeof(uint64_t));
+
+    if(static_cast<uint64_t>(end - data) < size)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: TrainingCheckpoint class.\n"
+               << "string read_string(const char*&, const char*) const method.\n"
+               << "Checkpoint is truncated.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    const string text(data, static_cast<size_t>(size));
+
+    data += size;
+
+    return text;
+}
+
+
+/// Copies a number of bytes from the data pointer and advances it.
+
+void TrainingCheckpoint::read_values(const char*& data, const char* end, void* values, const size_t& size) const
+{
+    if(static_cast<size_t>(end - data) < size)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: TrainingCheckpoint class.\n"
+               << "void read_values(const char*&, const char*, void*, const size_t&) const method.\n"
+               << "Checkpoint is truncated.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    memcpy(values, data, size);
+
+    data += size;
+}
+
+
+/// Returns the 64 bits FNV-1a hash of a block of memory, which is used as checksum of the checkpoint files.
+
+uint64_t TrainingCheckpoint::calculate_checksum(const char* data, const size_t& size)
+{
+    uint64_t checksum = 14695981039346656037ULL;
+
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+
+    for(size_t i = 0; i < size; i++)
+    {
+        checksum ^= bytes[i];
+        checksum *= 1099511628211ULL;
+    }
+
+    return checksum;
+}
+
+}
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
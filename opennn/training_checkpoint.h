@@ -0,0 +1,159 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   T R A I N I N G   C H E C K P O I N T   C L A S S   H E A D E R
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#ifndef TRAININGCHECKPOINT_H
+#define TRAININGCHECKPOINT_H
+
+// System includes
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <stdint.h>
+
+// OpenNN includes
+
+#include "config.h"
+
+using namespace std;
+using namespace Eigen;
+
+namespace OpenNN
+{
+
+/// This class contains the state of an optimization algorithm at the beginning of an epoch,
+/// so that an interrupted training can be resumed exactly from that epoch.
+
+///
+/// The state is a set of named vectors, matrices, scalars and indices, which are chosen by each optimization algorithm.
+/// The values are saved in binary, so that the resumed training is bitwise identical to the uninterrupted one.
+/// The files have a checksum, and they can only be loaded by a machine with the same byte order and type.
+
+class TrainingCheckpoint
+{
+
+public:
+
+   // Constructors
+
+   explicit TrainingCheckpoint();
+
+   // Destructor
+
+   virtual ~TrainingCheckpoint();
+
+   // Get methods
+
+   const string& get_optimization_algorithm_type() const;
+
+   const Index& get_epoch() const;
+
+   const type& get_elapsed_time() const;
+
+   const unsigned& get_random_seed() const;
+
+   bool has_vector(const string&) const;
+   bool has_matrix(const string&) const;
+   bool has_scalar(const string&) const;
+   bool has_index(const string&) const;
+
+   const Tensor<type, 1>& get_vector(const string&) const;
+   const Tensor<type, 2>& get_matrix(const string&) const;
+   const type& get_scalar(const string&) const;
+   const Index& get_index(const string&) const;
+
+   // Set methods
+
+   void set_optimization_algorithm_type(const string&);
+
+   void set_epoch(const Index&);
+
+   void set_elapsed_time(const type&);
+
+   void set_random_seed(const unsigned&);
+
+   void set_vector(const string&, const Tensor<type, 1>&);
+   void set_matrix(const string&, const Tensor<type, 2>&);
+   void set_scalar(const string&, const type&);
+   void set_index(const string&, const Index&);
+
+   // Serialization methods
+
+   void save(const string&) const;
+   void load(const string&);
+
+private:
+
+   void write_string(ostream&, const string&) const;
+   string read_string(const char*&, const char*) const;
+
+   void read_values(const char*&, const char*, void*, const size_t&) const;
+
+   static uint64_t calculate_checksum(const char*, const size_t&);
+
+   // MEMBERS
+
+   /// Type of the optimization algorithm which wrote the checkpoint.
+
+   string optimization_algorithm_type;
+
+   /// Epoch from which the training is resumed.
+
+   Index epoch = 0;
+
+   /// Elapsed time of the training before the epoch.
+
+   type elapsed_time = 0;
+
+   /// Seed of the random numbers of the training.
+
+   unsigned random_seed = 0;
+
+   /// Named vectors of the state of the optimization algorithm.
+
+   map<string, Tensor<type, 1>> vectors;
+
+   /// Named matrices of the state of the optimization algorithm.
+
+   map<string, Tensor<type, 2>> matrices;
+
+   /// Named scalars of the state of the optimization algorithm.
+
+   map<string, type> scalars;
+
+   /// Named indices of the state of the optimization algorithm.
+
+   map<string, Index> indices;
+};
+
+}
+
+#endif
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
@@ -0,0 +1,131 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   T R A I N I N G   C O N T R O L   C L A S S
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#include "training_control.h"
+
+namespace OpenNN
+{
+
+/// Default constructor. No signal is requested.
+
+TrainingControl::TrainingControl()
+{
+    stop_requested = false;
+    pause_requested = false;
+}
+
+
+/// Destructor.
+
+TrainingControl::~TrainingControl()
+{
+}
+
+
+/// Returns true if the training has been requested to stop, and false otherwise.
+
+bool TrainingControl::is_stop_requested() const
+{
+    return stop_requested;
+}
+
+
+/// Returns true if the training has been requested to pause, and false otherwise.
+
+bool TrainingControl::is_pause_requested() const
+{
+    return pause_requested;
+}
+
+
+/// Requests the training to stop at the next check. A paused training is woken up to stop.
+
+void TrainingControl::request_stop()
+{
+    {
+        lock_guard<mutex> lock(pause_mutex);
+
+        stop_requested = true;
+    }
+
+    pause_condition.notify_all();
+}
+
+
+/// Requests the training to wait at the next check until it is resumed or stopped.
+
+void TrainingControl::request_pause()
+{
+    lock_guard<mutex> lock(pause_mutex);
+
+    pause_requested = true;
+}
+
+
+/// Resumes a paused training.
+
+void TrainingControl::request_resume()
+{
+    {
+        lock_guard<mutex> lock(pause_mutex);
+
+        pause_requested = false;
+    }
+
+    pause_condition.notify_all();
+}
+
+
+/// Clears the stop and pause signals. The optimization algorithms call it when a training begins.
+
+void TrainingControl::reset()
+{
+    {
+        lock_guard<mutex> lock(pause_mutex);
+
+        stop_requested = false;
+        pause_requested = false;
+    }
+
+    pause_condition.notify_all();
+}
+
+
+/// Blocks the calling thread while the training is paused.
+/// Returns true if the training has been requested to stop, and false otherwise.
+
+bool TrainingControl::wait_while_paused() const
+{
+    if(!pause_requested) return stop_requested;
+
+    unique_lock<mutex> lock(pause_mutex);
+
+    pause_condition.wait(lock, [this]{return !pause_requested || stop_requested;});
+
+    return stop_requested;
+}
+
+}
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
@@ -0,0 +1,105 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   T R A I N I N G   C O N T R O L   C L A S S   H E A D E R
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#ifndef TRAININGCONTROL_H
+#define TRAININGCONTROL_H
+
+// System includes
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+// OpenNN includes
+
+#include "config.h"
+
+using namespace std;
+using namespace Eigen;
+
+namespace OpenNN
+{
+
+/// This class contains the signals with which another thread can stop or pause a training.
+
+///
+/// The signals are cooperative: the optimization algorithms check them between iterations,
+/// so that a stopped training ends with consistent results and a paused training holds its state until it is resumed.
+/// All the methods can be called from any thread.
+
+class TrainingControl
+{
+
+public:
+
+   // Constructors
+
+   explicit TrainingControl();
+
+   // Destructor
+
+   virtual ~TrainingControl();
+
+   // Get methods
+
+   bool is_stop_requested() const;
+
+   bool is_pause_requested() const;
+
+   // Signal methods
+
+   void request_stop();
+
+   void request_pause();
+
+   void request_resume();
+
+   void reset();
+
+   bool wait_while_paused() const;
+
+private:
+
+   /// True if the training must stop at the next check.
+
+   atomic<bool> stop_requested;
+
+   /// True if the training must wait at the next check until it is resumed or stopped.
+
+   atomic<bool> pause_requested;
+
+   /// Mutex of the condition variable.
+
+   mutable mutex pause_mutex;
+
+   /// Condition variable which wakes up a paused training.
+
+   mutable condition_variable pause_condition;
+};
+
+}
+
+#endif
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
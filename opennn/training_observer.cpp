@@ -0,0 +1,78 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   T R A I N I N G   O B S E R V E R   C L A S S
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#include "training_observer.h"
+
+namespace OpenNN
+{
+
+/// Default constructor.
+
+TrainingObserver::TrainingObserver()
+{
+}
+
+
+/// Destructor.
+
+TrainingObserver::~TrainingObserver()
+{
+}
+
+
+/// Called when a training begins.
+/// @param optimization_algorithm_type Name of the optimization algorithm, as written by write_optimization_algorithm_type().
+
+void TrainingObserver::on_training_begin(const string&)
+{
+}
+
+
+/// Called after each iteration of the stochastic algorithms, which make several iterations per epoch.
+/// @param metrics Metrics of the iteration. The selection error is NaN.
+
+void TrainingObserver::on_iteration(const Metrics&)
+{
+}
+
+
+/// Called after each epoch.
+/// @param metrics Metrics of the epoch.
+
+void TrainingObserver::on_epoch(const Metrics&)
+{
+}
+
+
+/// Called when a training ends.
+/// @param metrics Metrics of the last epoch.
+/// @param stopping_condition Stopping condition of the training, as written by Results::write_stopping_condition().
+
+void TrainingObserver::on_training_end(const Metrics&, const string&)
+{
+}
+
+}
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
@@ -0,0 +1,127 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   T R A I N I N G   O B S E R V E R   C L A S S   H E A D E R
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#ifndef TRAININGOBSERVER_H
+#define TRAININGOBSERVER_H
+
+// System includes
+
+#include <limits>
+#include <string>
+
+// OpenNN includes
+
+#include "config.h"
+
+using namespace std;
+using namespace Eigen;
+
+namespace OpenNN
+{
+
+/// This abstract class receives the metrics of a training from the optimization algorithms.
+
+///
+/// The optimization algorithms call the observers which have been added to them on the training thread,
+/// so the callbacks must return quickly. The observers which write files or serve the metrics derive from AsyncTrainingObserver,
+/// which moves that work to a thread of its own.
+/// An observer can end a training by requesting a stop to the training control of the optimization algorithm.
+
+class TrainingObserver
+{
+
+public:
+
+   /// This structure contains the metrics of an iteration or of an epoch.
+   /// The values which an optimization algorithm does not have are NaN.
+
+   struct Metrics
+   {
+       /// Epoch number.
+
+       Index epoch = 0;
+
+       /// Iteration within the epoch. The batch algorithms make one iteration per epoch.
+
+       Index iteration = 0;
+
+       /// Number of iterations since the beginning of the training.
+
+       Index iterations_number = 0;
+
+       /// Number of instances processed by the iteration or the epoch.
+
+       Index instances_number = 0;
+
+       /// Loss, error and selection error.
+
+       type training_loss = numeric_limits<type>::quiet_NaN();
+
+       type training_error = numeric_limits<type>::quiet_NaN();
+
+       type selection_error = numeric_limits<type>::quiet_NaN();
+
+       /// Norm of the gradient of the loss.
+
+       type gradient_norm = numeric_limits<type>::quiet_NaN();
+
+       /// Learning rate, or NaN for the algorithms without it.
+
+       type learning_rate = numeric_limits<type>::quiet_NaN();
+
+       /// Instances processed per second during the iteration or the epoch.
+
+       type instances_per_second = 0;
+
+       /// Duration of the iteration or the epoch, and time since the beginning of the training, in seconds.
+
+       type time = 0;
+
+       type elapsed_time = 0;
+   };
+
+   // Constructors
+
+   explicit TrainingObserver();
+
+   // Destructor
+
+   virtual ~TrainingObserver();
+
+   // Callback methods
+
+   virtual void on_training_begin(const string&);
+
+   virtual void on_iteration(const Metrics&);
+
+   virtual void on_epoch(const Metrics&);
+
+   virtual void on_training_end(const Metrics&, const string&);
+};
+
+}
+
+#endif
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
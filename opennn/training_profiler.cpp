@@ -0,0 +1,465 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   T R A I N I N G   P R O F I L E R   C L A S S
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#include "training_profiler.h"
+
+namespace OpenNN
+{
+
+const Index TrainingProfiler::phases_number;
+
+
+/// Scoped timer constructor. It begins to time a phase, or a layer of a phase.
+/// If the profiler pointer is nullptr or the profiler is not started, nothing is measured.
+/// @param new_profiler_pointer Pointer to the profiler.
+/// @param new_phase Timed phase.
+/// @param new_layer_index Index of the timed trainable layer, or -1 to time the whole phase.
+/// @param layer_pointer Pointer to the timed layer, whose counters are estimated. Nullptr adds no counters.
+/// @param instances_number Number of instances of the batch processed by the layer.
+
+TrainingProfiler::ScopedTimer::ScopedTimer(TrainingProfiler* new_profiler_pointer,
+                                           const Phase& new_phase,
+                                           const Index& new_layer_index,
+                                           const Layer* layer_pointer,
+                                           const Index& instances_number)
+    : phase(new_phase),
+      layer_index(new_layer_index)
+{
+    if(new_profiler_pointer == nullptr || !new_profiler_pointer->is_started()) return;
+
+    profiler_pointer = new_profiler_pointer;
+
+    if(layer_pointer != nullptr) profiler_pointer->add_layer_counts(phase, layer_index, layer_pointer, instances_number);
+
+    beginning_time = chrono::steady_clock::now();
+}
+
+
+/// Scoped timer destructor. It adds the time of the scope to the profiler.
+
+TrainingProfiler::ScopedTimer::~ScopedTimer()
+{
+    if(profiler_pointer == nullptr) return;
+
+    profiler_pointer->add_time(phase, layer_index, beginning_time, chrono::steady_clock::now());
+}
+
+
+/// Default constructor.
+
+TrainingProfiler::TrainingProfiler()
+{
+}
+
+
+/// Destructor.
+
+TrainingProfiler::~TrainingProfiler()
+{
+}
+
+
+/// Returns true if the timed scopes are recorded as a timeline, and false otherwise.
+
+const bool& TrainingProfiler::get_record_trace() const
+{
+    return record_trace;
+}
+
+
+/// Returns true if the profiler is measuring a training, and false otherwise.
+
+bool TrainingProfiler::is_started() const
+{
+    return started;
+}
+
+
+/// Returns the measures of the epochs which have ended.
+
+const vector<TrainingProfiler::EpochProfile>& TrainingProfiler::get_epochs_profiles() const
+{
+    return epochs_profiles;
+}
+
+
+/// Returns the sum of the measures of all the epochs which have ended.
+/// The epoch member of the returned profile is the number of epochs.
+
+TrainingProfiler::EpochProfile TrainingProfiler::calculate_total_profile() const
+{
+    EpochProfile total_profile;
+
+    total_profile.epoch = static_cast<Index>(epochs_profiles.size());
+    total_profile.phases.resize(phases_number);
+    total_profile.layers.assign(phases_number, vector<Counters>(static_cast<size_t>(layers_number)));
+
+    for(size_t i = 0; i < epochs_profiles.size(); i++)
+    {
+        total_profile.time += epochs_profiles[i].time;
+
+        for(size_t j = 0; j < static_cast<size_t>(phases_number); j++)
+        {
+            Counters& phase_counters = total_profile.phases[j];
+            const Counters& epoch_phase_counters = epochs_profiles[i].phases[j];
+
+            phase_counters.time += epoch_phase_counters.time;
+            phase_counters.calls_number += epoch_phase_counters.calls_number;
+            phase_counters.flops_number += epoch_phase_counters.flops_number;
+            phase_counters.bytes_number += epoch_phase_counters.bytes_number;
+            phase_counters.allocations_number += epoch_phase_counters.allocations_number;
+
+            for(size_t k = 0; k < static_cast<size_t>(layers_number); k++)
+            {
+                Counters& layer_counters = total_profile.layers[j][k];
+                const Counters& epoch_layer_counters = epochs_profiles[i].layers[j][k];
+
+                layer_counters.time += epoch_layer_counters.time;
+                layer_counters.calls_number += epoch_layer_counters.calls_number;
+                layer_counters.flops_number += epoch_layer_counters.flops_number;
+                layer_counters.bytes_number += epoch_layer_counters.bytes_number;
+                layer_counters.allocations_number += epoch_layer_counters.allocations_number;
+            }
+        }
+    }
+
+    return total_profile;
+}
+
+
+/// Returns a string with the name of a phase.
+/// @param phase Phase of a training iteration.
+
+string TrainingProfiler::write_phase_name(const Phase& phase)
+{
+    switch(phase)
+    {
+        case BatchFill: return "batch_fill";
+
+        case ForwardPropagate: return "forward_propagate";
+
+        case CalculateError: return "calculate_error";
+
+        case CalculateLayersDelta: return "calculate_layers_delta";
+
+        case CalculateErrorGradient: return "calculate_error_gradient";
+
+        case UpdateIteration: return "update_iteration";
+
+        case SetParameters: return "set_parameters";
+    }
+
+    return string();
+}
+
+
+/// Sets whether the timed scopes are recorded as a timeline, which can be saved with save_trace().
+/// The timeline grows with every timed scope, so it is only recorded on demand.
+/// @param new_record_trace True to record the timeline, false otherwise.
+
+void TrainingProfiler::set_record_trace(const bool& new_record_trace)
+{
+    record_trace = new_record_trace;
+}
+
+
+/// Clears the measures and starts to measure a training.
+/// The measures taken before the first epoch begins are added to the first epoch.
+/// @param new_layers_number Number of trainable layers of the neural network.
+
+void TrainingProfiler::start(const Index& new_layers_number)
+{
+    layers_number = new_layers_number;
+
+    epochs_profiles.clear();
+    trace_events.clear();
+
+    current_profile = EpochProfile();
+    current_profile.phases.resize(phases_number);
+    current_profile.layers.assign(phases_number, vector<Counters>(static_cast<size_t>(layers_number)));
+
+    starting_time = chrono::steady_clock::now();
+    epoch_beginning_time = starting_time;
+
+    epoch_open = false;
+    started = true;
+}
+
+
+/// Ends the current epoch, if any, and begins a new one.
+/// @param epoch Number of the new epoch.
+
+void TrainingProfiler::begin_epoch(const Index& epoch)
+{
+    if(!started) return;
+
+    if(epoch_open) end_epoch(chrono::steady_clock::now());
+
+    current_profile.epoch = epoch;
+
+    epoch_open = true;
+}
+
+
+/// Ends the current epoch and stops measuring.
+
+void TrainingProfiler::finish()
+{
+    if(!started) return;
+
+    if(epoch_open) end_epoch(chrono::steady_clock::now());
+
+    started = false;
+}
+
+
+/// Adds the time of a scope to a phase, or to a layer of a phase.
+/// @param phase Timed phase.
+/// @param layer_index Index of the timed trainable layer, or -1 for the whole phase.
+/// @param beginning_time Time at which the scope began.
+/// @param ending_time Time at which the scope ended.
+
+void TrainingProfiler::add_time(const Phase& phase,
+                                const Index& layer_index,
+                                const chrono::steady_clock::time_point& beginning_time,
+                                const chrono::steady_clock::time_point& ending_time)
+{
+    if(!started) return;
+
+    Counters& counters = get_counters(phase, layer_index);
+
+    counters.time += static_cast<type>(chrono::duration<double>(ending_time - beginning_time).count());
+    counters.calls_number++;
+
+    if(!record_trace) return;
+
+    TraceEvent trace_event;
+
+    trace_event.name = layer_index < 0 ? write_phase_name(phase) : write_phase_name(phase) + " layer " + to_string(layer_index);
+    trace_event.category = layer_index < 0 ? "phase" : "layer";
+    trace_event.epoch = current_profile.epoch;
+    trace_event.beginning_time = calculate_microseconds(beginning_time);
+    trace_event.duration = calculate_microseconds(ending_time) - trace_event.beginning_time;
+
+    trace_events.push_back(trace_event);
+}
+
+
+/// Adds counters to a phase. The counters of a layer are also added to the whole phase.
+/// @param phase Phase of the counters.
+/// @param layer_index Index of the trainable layer, or -1 for the whole phase.
+/// @param flops_number Number of floating point operations.
+/// @param bytes_number Number of bytes read and written.
+/// @param allocations_number Number of allocations.
+
+void TrainingProfiler::add_counts(const Phase& phase,
+                                  const Index& layer_index,
+                                  const Index& flops_number,
+                                  const Index& bytes_number,
+                                  const Index& allocations_number)
+{
+    if(!started) return;
+
+    if(layer_index >= 0)
+    {
+        Counters& layer_counters = get_counters(phase, layer_index);
+
+        layer_counters.flops_number += flops_number;
+        layer_counters.bytes_number += bytes_number;
+        layer_counters.allocations_number += allocations_number;
+    }
+
+    Counters& phase_counters = get_counters(phase, -1);
+
+    phase_counters.flops_number += flops_number;
+    phase_counters.bytes_number += bytes_number;
+    phase_counters.allocations_number += allocations_number;
+}
+
+
+/// Adds the estimated counters of a layer which processes a batch.
+/// Each parameter takes a multiplication and an addition per instance, and each neuron an activation per instance.
+/// The bytes are those of the inputs, the outputs and the parameters.
+/// @param phase Phase of the counters.
+/// @param layer_index Index of the trainable layer.
+/// @param layer_pointer Pointer to the layer.
+/// @param instances_number Number of instances of the batch.
+
+void TrainingProfiler::add_layer_counts(const Phase& phase,
+                                        const Index& layer_index,
+                                        const Layer* layer_pointer,
+                                        const Index& instances_number)
+{
+    const Index parameters_number = layer_pointer->get_parameters_number();
+    const Index inputs_number = layer_pointer->get_inputs_number();
+    const Index neurons_number = layer_pointer->get_neurons_number();
+
+    const Index flops_number = instances_number*(2*parameters_number + neurons_number);
+
+    const Index bytes_number
+            = static_cast<Index>(sizeof(type))*(instances_number*(inputs_number + neurons_number) + parameters_number);
+
+    add_counts(phase, layer_index, flops_number, bytes_number, 0);
+}
+
+
+/// Writes the recorded timeline in the Chrome trace event format.
+/// Each epoch and each timed scope is a complete event, with the epoch number as argument.
+/// @param stream Output stream.
+
+void TrainingProfiler::write_trace(ostream& stream) const
+{
+    stream << fixed << setprecision(3);
+
+    stream << "{\"traceEvents\": [";
+
+    double epoch_beginning = 0;
+
+    for(size_t i = 0; i < epochs_profiles.size(); i++)
+    {
+        const double epoch_duration = static_cast<double>(epochs_profiles[i].time)*1.0e6;
+
+        stream << (i == 0 ? "\n" : ",\n")
+               << "{\"name\": \"epoch " << epochs_profiles[i].epoch << "\", \"cat\": \"epoch\", \"ph\": \"X\", "
+               << "\"ts\": " << epoch_beginning << ", \"dur\": " << epoch_duration << ", "
+               << "\"pid\": 0, \"tid\": 0, \"args\": {\"epoch\": " << epochs_profiles[i].epoch << "}}";
+
+        epoch_beginning += epoch_duration;
+    }
+
+    for(size_t i = 0; i < trace_events.size(); i++)
+    {
+        const TraceEvent& trace_event = trace_events[i];
+
+        stream << (i == 0 && epochs_profiles.empty() ? "\n" : ",\n")
+               << "{\"name\": \"" << trace_event.name << "\", \"cat\": \"" << trace_event.category << "\", \"ph\": \"X\", "
+               << "\"ts\": " << trace_event.beginning_time << ", \"dur\": " << trace_event.duration << ", "
+               << "\"pid\": 0, \"tid\": " << (trace_event.category == "layer" ? 2 : 1) << ", "
+               << "\"args\": {\"epoch\": " << trace_event.epoch << "}}";
+    }
+
+    stream << "\n],\n\"displayTimeUnit\": \"ms\"}\n";
+}
+
+
+/// Saves the recorded timeline to a JSON file in the Chrome trace event format.
+/// @param file_name Name of the trace file.
+
+void TrainingProfiler::save_trace(const string& file_name) const
+{
+    ofstream file(file_name.c_str());
+
+    if(!file.is_open())
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: TrainingProfiler class.\n"
+               << "void save_trace(const string&) const method.\n"
+               << "Cannot open trace file: " << file_name << "\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    write_trace(file);
+
+    file.close();
+}
+
+
+/// Prints to the screen the time and the counters of each phase, summed over all the epochs.
+
+void TrainingProfiler::print() const
+{
+    const EpochProfile total_profile = calculate_total_profile();
+
+    cout << "Training profile of " << total_profile.epoch << " epochs: " << total_profile.time << " s" << endl;
+
+    for(Index i = 0; i < phases_number; i++)
+    {
+        const Counters& counters = total_profile.phases[static_cast<size_t>(i)];
+
+        cout << left << setw(26) << write_phase_name(static_cast<Phase>(i))
+             << right << setw(14) << counters.time << " s"
+             << setw(10) << counters.calls_number << " calls"
+             << setw(16) << counters.flops_number << " flops"
+             << setw(16) << counters.bytes_number << " bytes"
+             << setw(10) << counters.allocations_number << " allocations" << endl;
+    }
+}
+
+
+/// Returns the counters of a phase in the current epoch, or of a layer of that phase.
+/// @param phase Phase of the counters.
+/// @param layer_index Index of the trainable layer, or -1 for the whole phase.
+
+TrainingProfiler::Counters& TrainingProfiler::get_counters(const Phase& phase, const Index& layer_index)
+{
+    const size_t phase_index = static_cast<size_t>(phase);
+
+    if(layer_index < 0) return current_profile.phases[phase_index];
+
+    if(layer_index >= layers_number)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: TrainingProfiler class.\n"
+               << "Counters& get_counters(const Phase&, const Index&) method.\n"
+               << "Layer index (" << layer_index << ") must be less than the number of layers (" << layers_number << ").\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    return current_profile.layers[phase_index][static_cast<size_t>(layer_index)];
+}
+
+
+/// Appends the measures of the current epoch to the epochs profiles, and clears them for the next epoch.
+/// @param ending_time Time at which the epoch ends.
+
+void TrainingProfiler::end_epoch(const chrono::steady_clock::time_point& ending_time)
+{
+    current_profile.time = static_cast<type>(chrono::duration<double>(ending_time - epoch_beginning_time).count());
+
+    epochs_profiles.push_back(current_profile);
+
+    current_profile.time = 0;
+    current_profile.phases.assign(phases_number, Counters());
+    current_profile.layers.assign(phases_number, vector<Counters>(static_cast<size_t>(layers_number)));
+
+    epoch_beginning_time = ending_time;
+
+    epoch_open = false;
+}
+
+
+/// Returns the microseconds elapsed from the start of the profiler to a time point.
+
+double TrainingProfiler::calculate_microseconds(const chrono::steady_clock::time_point& time_point) const
+{
+    return chrono::duration<double, micro>(time_point - starting_time).count();
+}
+
+}
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
@@ -0,0 +1,288 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   T R A I N I N G   P R O F I L E R   C L A S S   H E A D E R
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#ifndef TRAININGPROFILER_H
+#define TRAININGPROFILER_H
+
+// System includes
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <vector>
+
+// OpenNN includes
+
+#include "config.h"
+#include "layer.h"
+
+using namespace std;
+using namespace Eigen;
+
+// Instrumentation macros. They expand to nothing unless OPENNN_PROFILE is defined in config.h or in the build.
+
+#ifdef OPENNN_PROFILE
+
+#define OPENNN_PROFILE_CONCATENATE_NAME(name, line) name##line
+#define OPENNN_PROFILE_TIMER_NAME(line) OPENNN_PROFILE_CONCATENATE_NAME(profile_scoped_timer_, line)
+
+/// Times the rest of the enclosing scope as a phase, or as a layer of a phase.
+
+#define OPENNN_PROFILE_SCOPE(profiler_pointer, ...) \
+    OpenNN::TrainingProfiler::ScopedTimer OPENNN_PROFILE_TIMER_NAME(__LINE__)(profiler_pointer, __VA_ARGS__)
+
+/// Adds floating point operations, bytes and allocations to a phase, or to a layer of a phase.
+
+#define OPENNN_PROFILE_COUNT(profiler_pointer, ...) \
+    do { OpenNN::TrainingProfiler* counted_profiler_pointer = (profiler_pointer); \
+         if(counted_profiler_pointer != nullptr) counted_profiler_pointer->add_counts(__VA_ARGS__); } while(0)
+
+#else
+
+#define OPENNN_PROFILE_SCOPE(profiler_pointer, ...)
+#define OPENNN_PROFILE_COUNT(profiler_pointer, ...)
+
+#endif
+
+namespace OpenNN
+{
+
+/// This class measures how the time of a training splits between its phases and between the layers of the neural network.
+
+///
+/// The phases are timed with scoped timers of high resolution, and they carry estimated counters of floating point operations,
+/// bytes moved and allocations. The measures are aggregated per epoch, and they can also be recorded as a timeline
+/// which is saved in the Chrome trace format, to be opened with chrome://tracing or Perfetto.
+/// The phases may nest: the update of the optimization algorithms with a line search includes the forward propagations
+/// and the errors of the trial points, which are also added to their own phases.
+/// The instrumentation of the library is only compiled when OPENNN_PROFILE is defined.
+
+class TrainingProfiler
+{
+
+public:
+
+   /// Enumeration of the timed phases of a training iteration.
+
+   enum Phase{BatchFill, ForwardPropagate, CalculateError, CalculateLayersDelta, CalculateErrorGradient, UpdateIteration, SetParameters};
+
+   /// Number of phases.
+
+   static const Index phases_number = 7;
+
+   /// This structure contains the time and the counters of a phase, or of a layer in a phase.
+
+   struct Counters
+   {
+       /// Total time, in seconds.
+
+       type time = 0;
+
+       /// Number of timed calls.
+
+       Index calls_number = 0;
+
+       /// Estimated number of floating point operations.
+
+       Index flops_number = 0;
+
+       /// Estimated number of bytes read and written.
+
+       Index bytes_number = 0;
+
+       /// Number of allocations made by the instrumented code.
+
+       Index allocations_number = 0;
+   };
+
+   /// This structure contains the measures of an epoch.
+
+   struct EpochProfile
+   {
+       /// Epoch number.
+
+       Index epoch = 0;
+
+       /// Time from the beginning of the epoch to the beginning of the next one, in seconds.
+
+       type time = 0;
+
+       /// Counters of each phase.
+
+       vector<Counters> phases;
+
+       /// Counters of each trainable layer in each phase. Only the propagation phases are measured per layer.
+
+       vector<vector<Counters>> layers;
+   };
+
+   /// This class times the scope in which it is declared.
+
+   class ScopedTimer
+   {
+
+   public:
+
+       explicit ScopedTimer(TrainingProfiler*, const Phase&, const Index& = -1, const Layer* = nullptr, const Index& = 0);
+
+       virtual ~ScopedTimer();
+
+   private:
+
+       /// Pointer to the profiler, or nullptr if nothing is measured.
+
+       TrainingProfiler* profiler_pointer = nullptr;
+
+       /// Timed phase.
+
+       Phase phase;
+
+       /// Index of the timed layer, or -1 if the whole phase is timed.
+
+       Index layer_index = -1;
+
+       /// Time at which the scope begins.
+
+       chrono::steady_clock::time_point beginning_time;
+   };
+
+   // Constructors
+
+   explicit TrainingProfiler();
+
+   // Destructor
+
+   virtual ~TrainingProfiler();
+
+   // Get methods
+
+   const bool& get_record_trace() const;
+
+   bool is_started() const;
+
+   const vector<EpochProfile>& get_epochs_profiles() const;
+
+   EpochProfile calculate_total_profile() const;
+
+   static string write_phase_name(const Phase&);
+
+   // Set methods
+
+   void set_record_trace(const bool&);
+
+   // Measure methods
+
+   void start(const Index&);
+
+   void begin_epoch(const Index&);
+
+   void finish();
+
+   void add_time(const Phase&, const Index&, const chrono::steady_clock::time_point&, const chrono::steady_clock::time_point&);
+
+   void add_counts(const Phase&, const Index&, const Index&, const Index&, const Index&);
+
+   void add_layer_counts(const Phase&, const Index&, const Layer*, const Index&);
+
+   // Serialization methods
+
+   void write_trace(ostream&) const;
+
+   void save_trace(const string&) const;
+
+   void print() const;
+
+private:
+
+   /// This structure contains a timed scope of the timeline.
+
+   struct TraceEvent
+   {
+       /// Name and category of the scope, which are the phase and the layer, or the epoch.
+
+       string name;
+
+       string category;
+
+       Index epoch = 0;
+
+       /// Beginning and duration of the scope, in microseconds from the start of the profiler.
+
+       double beginning_time = 0;
+       double duration = 0;
+   };
+
+   Counters& get_counters(const Phase&, const Index&);
+
+   void end_epoch(const chrono::steady_clock::time_point&);
+
+   double calculate_microseconds(const chrono::steady_clock::time_point&) const;
+
+   // MEMBERS
+
+   /// True between the start and the finish of a training.
+
+   bool started = false;
+
+   /// True if the scopes are recorded as a timeline.
+
+   bool record_trace = false;
+
+   /// Number of trainable layers of the neural network.
+
+   Index layers_number = 0;
+
+   /// Time at which the profiler was started.
+
+   chrono::steady_clock::time_point starting_time;
+
+   /// Time at which the current epoch began.
+
+   chrono::steady_clock::time_point epoch_beginning_time;
+
+   /// True if an epoch has begun and has not ended.
+
+   bool epoch_open = false;
+
+   /// Measures of the current epoch.
+
+   EpochProfile current_profile;
+
+   /// Measures of the epochs which have ended.
+
+   vector<EpochProfile> epochs_profiles;
+
+   /// Timeline of the timed scopes.
+
+   vector<TraceEvent> trace_events;
+};
+
+}
+
+#endif
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
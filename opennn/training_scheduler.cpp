@@ -0,0 +1,884 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   T R A I N I N G   S C H E D U L E R   C L A S S
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#include "training_scheduler.h"
+
+namespace OpenNN
+{
+
+/// Default constructor.
+/// It creates a training scheduler not associated to any training strategy.
+
+TrainingScheduler::TrainingScheduler()
+{
+    set();
+}
+
+
+/// Training strategy constructor.
+/// @param new_training_strategy_pointer Pointer to the training strategy to be copied by the workers.
+
+TrainingScheduler::TrainingScheduler(TrainingStrategy* new_training_strategy_pointer)
+{
+    set(new_training_strategy_pointer);
+}
+
+
+/// Destructor.
+/// It deletes the copies made by the workers.
+
+TrainingScheduler::~TrainingScheduler()
+{
+    delete_workers();
+}
+
+
+/// Returns a pointer to the training strategy copied by the workers.
+
+TrainingStrategy* TrainingScheduler::get_training_strategy_pointer() const
+{
+    return training_strategy_pointer;
+}
+
+
+/// Returns the number of candidates which are trained at the same time.
+
+const Index& TrainingScheduler::get_workers_number() const
+{
+    return workers_number;
+}
+
+
+/// Returns the number of threads used by the thread pools of each worker.
+
+const Index& TrainingScheduler::get_worker_threads_number() const
+{
+    return worker_threads_number;
+}
+
+
+/// Returns the epochs number of the first round of successive halving.
+/// If it is zero, all the trials are trained with the maximum epochs number of the training strategy.
+
+const Index& TrainingScheduler::get_racing_epochs_number() const
+{
+    return racing_epochs_number;
+}
+
+
+/// Returns the number of candidates whose results are stored in the cache.
+
+Index TrainingScheduler::get_cache_size() const
+{
+    return static_cast<Index>(cache.size());
+}
+
+
+/// Sets the training strategy pointer to nullptr and the rest of members to their default values.
+
+void TrainingScheduler::set()
+{
+    delete_workers();
+
+    clear_cache();
+
+    training_strategy_pointer = nullptr;
+
+    set_default();
+}
+
+
+/// Sets a new training strategy to be copied by the workers.
+/// The copies of the previous training strategy are deleted.
+/// @param new_training_strategy_pointer Pointer to a training strategy object.
+
+void TrainingScheduler::set(TrainingStrategy* new_training_strategy_pointer)
+{
+    delete_workers();
+
+    clear_cache();
+
+    training_strategy_pointer = new_training_strategy_pointer;
+
+    set_default();
+}
+
+
+/// Sets the members to their default values.
+/// All the available threads are used, with one thread per worker.
+
+void TrainingScheduler::set_default()
+{
+    workers_number = omp_get_max_threads();
+
+    worker_threads_number = 1;
+
+    racing_epochs_number = 0;
+}
+
+
+/// Sets a new training strategy to be copied by the workers, keeping the rest of members.
+/// The copies of the previous training strategy are deleted, so that the next candidates start from the current state of the originals.
+/// The cache is kept if the training strategy is the same one.
+/// @param new_training_strategy_pointer Pointer to a training strategy object.
+
+void TrainingScheduler::set_training_strategy_pointer(TrainingStrategy* new_training_strategy_pointer)
+{
+    delete_workers();
+
+    if(new_training_strategy_pointer != training_strategy_pointer) clear_cache();
+
+    training_strategy_pointer = new_training_strategy_pointer;
+}
+
+
+/// Sets the number of candidates which are trained at the same time.
+/// @param new_workers_number Number of workers.
+
+void TrainingScheduler::set_workers_number(const Index& new_workers_number)
+{
+#ifdef __OPENNN_DEBUG__
+
+    if(new_workers_number <= 0)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: TrainingScheduler class.\n"
+               << "void set_workers_number(const Index&) method.\n"
+               << "Number of workers must be greater than 0.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+#endif
+
+    if(new_workers_number != workers_number) delete_workers();
+
+    workers_number = new_workers_number;
+}
+
+
+/// Sets the number of threads used by the thread pools of each worker.
+/// @param new_worker_threads_number Number of threads per worker.
+
+void TrainingScheduler::set_worker_threads_number(const Index& new_worker_threads_number)
+{
+#ifdef __OPENNN_DEBUG__
+
+    if(new_worker_threads_number <= 0)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: TrainingScheduler class.\n"
+               << "void set_worker_threads_number(const Index&) method.\n"
+               << "Number of threads per worker must be greater than 0.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+#endif
+
+    if(new_worker_threads_number != worker_threads_number) delete_workers();
+
+    worker_threads_number = new_worker_threads_number;
+}
+
+
+/// Sets the epochs number of the first round of successive halving.
+/// @param new_racing_epochs_number Epochs number of the first round, or zero for no racing.
+
+void TrainingScheduler::set_racing_epochs_number(const Index& new_racing_epochs_number)
+{
+    racing_epochs_number = new_racing_epochs_number;
+}
+
+
+/// Deletes the copies of the data set, the neural network and the training strategy.
+/// They are made again from the originals the next time candidates are trained.
+
+void TrainingScheduler::delete_workers()
+{
+    for(Index i = 0; i < workers.size(); i++)
+    {
+        delete workers(i);
+    }
+
+    workers.resize(0);
+}
+
+
+/// Deletes the results of the candidates already trained.
+/// It must be called if the data set or the training strategy are modified between model selection runs.
+
+void TrainingScheduler::clear_cache()
+{
+    cache.clear();
+}
+
+
+/// Saves the results of the candidates already trained to a XML-type file.
+/// The parameters are written with full precision, so that the loaded results are the same as the saved ones.
+/// @param file_name Name of the cache file.
+
+void TrainingScheduler::save_cache(const string& file_name) const
+{
+    tinyxml2::XMLPrinter file_stream;
+
+    ostringstream buffer;
+
+    buffer << setprecision(numeric_limits<type>::max_digits10);
+
+    file_stream.OpenElement("TrainingSchedulerCache");
+
+    for(const auto& entry : cache)
+    {
+        const CandidateKey& key = entry.first;
+        const OptimizationAlgorithm::Results& results = entry.second;
+
+        file_stream.OpenElement("Candidate");
+
+        // Inputs mask
+
+        file_stream.OpenElement("InputsMask");
+
+        buffer.str("");
+
+        for(size_t i = 0; i < key.first.size(); i++)
+        {
+            buffer << (key.first[i] ? "1" : "0");
+        }
+
+        file_stream.PushText(buffer.str().c_str());
+
+        file_stream.CloseElement();
+
+        // Neurons number
+
+        file_stream.OpenElement("NeuronsNumber");
+
+        buffer.str("");
+        buffer << key.second;
+
+        file_stream.PushText(buffer.str().c_str());
+
+        file_stream.CloseElement();
+
+        // Final parameters
+
+        file_stream.OpenElement("FinalParameters");
+
+        buffer.str("");
+
+        for(Index i = 0; i < results.final_parameters.size(); i++)
+        {
+            buffer << results.final_parameters(i);
+
+            if(i != results.final_parameters.size()-1) buffer << " ";
+        }
+
+        file_stream.PushText(buffer.str().c_str());
+
+        file_stream.CloseElement();
+
+        // Final values
+
+        buffer.str("");
+        buffer << results.final_parameters_norm << " "
+               << results.final_training_error << " "
+               << results.final_selection_error << " "
+               << results.final_gradient_norm << " "
+               << results.elapsed_time << " "
+               << results.epochs_number << " "
+               << static_cast<int>(results.stopping_condition);
+
+        file_stream.OpenElement("FinalValues");
+
+        file_stream.PushText(buffer.str().c_str());
+
+        file_stream.CloseElement();
+
+        // Stopping criterion
+
+        file_stream.OpenElement("StoppingCriterion");
+
+        file_stream.PushText(results.stopping_criterion.c_str());
+
+        file_stream.CloseElement();
+
+        file_stream.CloseElement();
+    }
+
+    file_stream.CloseElement();
+
+    ofstream file(file_name.c_str());
+
+    if(!file.is_open())
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: TrainingScheduler class.\n"
+               << "void save_cache(const string&) const method.\n"
+               << "Cannot open cache file " << file_name << ".\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    file << file_stream.CStr();
+}
+
+
+/// Loads the results of candidates from a XML-type file written by save_cache, and adds them to the cache.
+/// The data set and the training strategy must be the same as those of the run which saved the file.
+/// @param file_name Name of the cache file.
+
+void TrainingScheduler::load_cache(const string& file_name)
+{
+    tinyxml2::XMLDocument document;
+
+    if(document.LoadFile(file_name.c_str()))
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: TrainingScheduler class.\n"
+               << "void load_cache(const string&) method.\n"
+               << "Cannot load XML file " << file_name << ".\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    const tinyxml2::XMLElement* root_element = document.FirstChildElement("TrainingSchedulerCache");
+
+    if(!root_element)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: TrainingScheduler class.\n"
+               << "void load_cache(const string&) method.\n"
+               << "Training scheduler cache element is nullptr.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+    for(const tinyxml2::XMLElement* candidate_element = root_element->FirstChildElement("Candidate");
+        candidate_element;
+        candidate_element = candidate_element->NextSiblingElement("Candidate"))
+    {
+        const tinyxml2::XMLElement* inputs_mask_element = candidate_element->FirstChildElement("InputsMask");
+        const tinyxml2::XMLElement* neurons_number_element = candidate_element->FirstChildElement("NeuronsNumber");
+        const tinyxml2::XMLElement* final_parameters_element = candidate_element->FirstChildElement("FinalParameters");
+        const tinyxml2::XMLElement* final_values_element = candidate_element->FirstChildElement("FinalValues");
+        const tinyxml2::XMLElement* stopping_criterion_element = candidate_element->FirstChildElement("StoppingCriterion");
+
+        if(!inputs_mask_element || !neurons_number_element || !final_parameters_element || !final_values_element)
+        {
+            ostringstream buffer;
+
+            buffer << "OpenNN Exception: TrainingScheduler class.\n"
+                   << "void load_cache(const string&) method.\n"
+                   << "Candidate element is incomplete.\n";
+
+            throw logic_error(buffer.str());
+        }
+
+        // Key
+
+        const string inputs_mask = inputs_mask_element->GetText() ? inputs_mask_element->GetText() : "";
+
+        vector<bool> mask(inputs_mask.size());
+
+        for(size_t i = 0; i < inputs_mask.size(); i++)
+        {
+            mask[i] = inputs_mask[i] == '1';
+        }
+
+        const Index neurons_number = static_cast<Index>(atoi(neurons_number_element->GetText()));
+
+        // Results
+
+        OptimizationAlgorithm::Results results;
+
+        // The values are read with atof, which also reads infinite and not a number values
+
+        vector<type> parameters;
+
+        string token;
+
+        if(final_parameters_element->GetText())
+        {
+            istringstream parameters_stream(final_parameters_element->GetText());
+
+            while(parameters_stream >> token) parameters.push_back(static_cast<type>(atof(token.c_str())));
+        }
+
+        results.final_parameters.resize(static_cast<Index>(parameters.size()));
+
+        for(size_t i = 0; i < parameters.size(); i++)
+        {
+            results.final_parameters(static_cast<Index>(i)) = parameters[i];
+        }
+
+        vector<string> final_values;
+
+        istringstream final_values_stream(final_values_element->GetText());
+
+        while(final_values_stream >> token) final_values.push_back(token);
+
+        if(final_values.size() != 7)
+        {
+            ostringstream buffer;
+
+            buffer << "OpenNN Exception: TrainingScheduler class.\n"
+                   << "void load_cache(const string&) method.\n"
+                   << "Final values element must have 7 values.\n";
+
+            throw logic_error(buffer.str());
+        }
+
+        results.final_parameters_norm = static_cast<type>(atof(final_values[0].c_str()));
+        results.final_training_error = static_cast<type>(atof(final_values[1].c_str()));
+        results.final_selection_error = static_cast<type>(atof(final_values[2].c_str()));
+        results.final_gradient_norm = static_cast<type>(atof(final_values[3].c_str()));
+        results.elapsed_time = static_cast<type>(atof(final_values[4].c_str()));
+        results.epochs_number = static_cast<Index>(atol(final_values[5].c_str()));
+        results.stopping_condition = static_cast<OptimizationAlgorithm::StoppingCondition>(atoi(final_values[6].c_str()));
+
+        if(stopping_criterion_element && stopping_criterion_element->GetText())
+        {
+            results.stopping_criterion = stopping_criterion_element->GetText();
+        }
+
+        cache[CandidateKey(mask, neurons_number)] = results;
+    }
+}
+
+
+/// Makes the copies of the data set, the neural network and the training strategy for each worker.
+/// The copies share a thread pool with the threads budget of one worker.
+
+void TrainingScheduler::create_workers()
+{
+    DataSet* data_set_pointer = training_strategy_pointer->get_loss_index_pointer()->get_data_set_pointer();
+
+    NeuralNetwork* neural_network_pointer = training_strategy_pointer->get_neural_network_pointer();
+
+    tinyxml2::XMLDocument neural_network_document;
+
+    write_XML_document(*neural_network_pointer, neural_network_document);
+
+    tinyxml2::XMLDocument training_strategy_document;
+
+    write_XML_document(*training_strategy_pointer, training_strategy_document);
+
+    const int threads_number = static_cast<int>(worker_threads_number);
+
+    workers.resize(workers_number);
+
+    for(Index i = 0; i < workers_number; i++)
+    {
+        workers(i) = new Worker(worker_threads_number);
+
+        workers(i)->data_set.set(*data_set_pointer);
+        workers(i)->data_set.set_display(false);
+
+        workers(i)->neural_network.from_XML(neural_network_document);
+        workers(i)->neural_network.set_display(false);
+
+        workers(i)->training_strategy.set_neural_network_pointer(&workers(i)->neural_network);
+        workers(i)->training_strategy.set_data_set_pointer(&workers(i)->data_set);
+        workers(i)->training_strategy.from_XML(training_strategy_document);
+        workers(i)->training_strategy.set_display(false);
+
+        workers(i)->data_set.set_thread_pool_device(new ThreadPoolDevice(&workers(i)->thread_pool, threads_number));
+        workers(i)->neural_network.set_thread_pool_device(new ThreadPoolDevice(&workers(i)->thread_pool, threads_number));
+        workers(i)->training_strategy.set_thread_pool_device(new ThreadPoolDevice(&workers(i)->thread_pool, threads_number));
+    }
+}
+
+
+/// Sets the input columns, the hidden neurons, the initial parameters and the epochs number of a candidate in a worker.
+/// The members which are not given by the candidate are taken from the original data set, neural network and training strategy.
+
+void TrainingScheduler::set_candidate(const Candidate& candidate, Worker* worker) const
+{
+    const DataSet* original_data_set_pointer = training_strategy_pointer->get_loss_index_pointer()->get_data_set_pointer();
+
+    const NeuralNetwork* original_neural_network_pointer = training_strategy_pointer->get_neural_network_pointer();
+
+    DataSet* data_set_pointer = &worker->data_set;
+
+    NeuralNetwork* neural_network_pointer = &worker->neural_network;
+
+    // Input columns
+
+    if(candidate.columns_uses.size() != 0)
+    {
+        data_set_pointer->set_columns_uses(candidate.columns_uses);
+    }
+    else
+    {
+        data_set_pointer->set_columns_uses(original_data_set_pointer->get_columns_uses());
+    }
+
+    const Index input_variables_number = data_set_pointer->get_input_variables_number();
+
+    Tensor<Index, 1> input_variables_dimensions(1);
+    input_variables_dimensions.setConstant(input_variables_number);
+
+    data_set_pointer->set_input_variables_dimensions(input_variables_dimensions);
+
+    neural_network_pointer->set_inputs_number(input_variables_number);
+
+    // Hidden neurons
+
+    const Index trainable_layers_number = neural_network_pointer->get_trainable_layers_number();
+
+    if(trainable_layers_number >= 2)
+    {
+        const Tensor<Layer*, 1> trainable_layers_pointers = neural_network_pointer->get_trainable_layers_pointers();
+
+        const Index neurons_number = candidate.neurons_number != 0
+                ? candidate.neurons_number
+                : original_neural_network_pointer->get_trainable_layers_pointers()(trainable_layers_number-2)->get_neurons_number();
+
+        trainable_layers_pointers(trainable_layers_number-2)->set_neurons_number(neurons_number);
+        trainable_layers_pointers(trainable_layers_number-1)->set_inputs_number(neurons_number);
+    }
+
+    // Parameters
+
+    if(candidate.parameters.size() != 0)
+    {
+        Tensor<type, 1> parameters = candidate.parameters;
+
+        neural_network_pointer->set_parameters(parameters);
+    }
+    else
+    {
+        neural_network_pointer->set_parameters_random();
+    }
+
+    // Epochs
+
+    const Index maximum_epochs_number = candidate.maximum_epochs_number != 0
+            ? candidate.maximum_epochs_number
+            : training_strategy_pointer->get_maximum_epochs_number();
+
+    worker->training_strategy.set_maximum_epochs_number(static_cast<int>(maximum_epochs_number));
+}
+
+
+/// Returns the key of a candidate in the cache.
+/// The members which are not given by the candidate are taken from the original data set and neural network.
+
+TrainingScheduler::CandidateKey TrainingScheduler::get_key(const Candidate& candidate) const
+{
+    const DataSet* original_data_set_pointer = training_strategy_pointer->get_loss_index_pointer()->get_data_set_pointer();
+
+    const NeuralNetwork* original_neural_network_pointer = training_strategy_pointer->get_neural_network_pointer();
+
+    const Tensor<DataSet::VariableUse, 1> columns_uses = candidate.columns_uses.size() != 0
+            ? candidate.columns_uses
+            : original_data_set_pointer->get_columns_uses();
+
+    const Index columns_number = columns_uses.size();
+
+    vector<bool> inputs_mask(static_cast<size_t>(columns_number));
+
+    for(Index i = 0; i < columns_number; i++)
+    {
+        inputs_mask[static_cast<size_t>(i)] = columns_uses(i) == DataSet::Input;
+    }
+
+    Index neurons_number = candidate.neurons_number;
+
+    const Index trainable_layers_number = original_neural_network_pointer->get_trainable_layers_number();
+
+    if(neurons_number == 0 && trainable_layers_number >= 2)
+    {
+        neurons_number = original_neural_network_pointer->get_trainable_layers_pointers()(trainable_layers_number-2)->get_neurons_number();
+    }
+
+    return CandidateKey(inputs_mask, neurons_number);
+}
+
+
+/// Trains all the candidates, as many at the same time as workers, and returns their training results.
+/// The original data set, neural network and training strategy are not modified.
+/// @param candidates Models to be trained.
+
+Tensor<OptimizationAlgorithm::Results, 1> TrainingScheduler::perform_trainings(const Tensor<Candidate, 1>& candidates)
+{
+#ifdef __OPENNN_DEBUG__
+
+    if(!training_strategy_pointer)
+    {
+        ostringstream buffer;
+
+        buffer << "OpenNN Exception: TrainingScheduler class.\n"
+               << "Tensor<OptimizationAlgorithm::Results, 1> perform_trainings(const Tensor<Candidate, 1>&) method.\n"
+               << "Pointer to training strategy is nullptr.\n";
+
+        throw logic_error(buffer.str());
+    }
+
+#endif
+
+    const Index candidates_number = candidates.size();
+
+    Tensor<OptimizationAlgorithm::Results, 1> results(candidates_number);
+
+    if(candidates_number == 0) return results;
+
+    if(workers.size() == 0) create_workers();
+
+    const int threads_number = static_cast<int>(min(workers_number, candidates_number));
+
+    string error_message;
+
+    #pragma omp parallel for schedule(dynamic) num_threads(threads_number)
+    for(Index i = 0; i < candidates_number; i++)
+    {
+        Worker* worker = workers(omp_get_thread_num());
+
+        try
+        {
+            set_candidate(candidates(i), worker);
+
+            results(i) = worker->training_strategy.perform_training();
+        }
+        catch(const exception& e)
+        {
+            #pragma omp critical
+            error_message = e.what();
+        }
+    }
+
+    if(!error_message.empty())
+    {
+        throw logic_error(error_message);
+    }
+
+    return results;
+}
+
+
+/// Trains a single candidate with the first worker and returns its training results.
+/// @param candidate Model to be trained.
+
+OptimizationAlgorithm::Results TrainingScheduler::perform_training(const Candidate& candidate)
+{
+    Tensor<Candidate, 1> candidates(1);
+
+    candidates(0) = candidate;
+
+    return perform_trainings(candidates)(0);
+}
+
+
+/// Trains the candidates by successive halving, and returns their training results.
+/// All the candidates are trained for racing_epochs_number epochs. Then, the best half according to the selection error
+/// goes on training from its current parameters up to twice the epochs, and so on until the maximum epochs number of the training strategy.
+/// The results of the candidates which are stopped are those of the last round they ran.
+/// @param candidates Models to be trained.
+
+Tensor<OptimizationAlgorithm::Results, 1> TrainingScheduler::perform_racing(const Tensor<Candidate, 1>& candidates)
+{
+    Tensor<Index, 1> rungs;
+
+    return perform_racing(candidates, rungs);
+}
+
+
+/// Trains the candidates by successive halving, and returns their training results.
+/// Only the selection errors of candidates which have run the same rounds are compared.
+/// @param candidates Models to be trained.
+/// @param rungs Index of the last round run by each candidate. It is zero for all of them if the candidates do not race.
+
+Tensor<OptimizationAlgorithm::Results, 1> TrainingScheduler::perform_racing(const Tensor<Candidate, 1>& candidates, Tensor<Index, 1>& rungs)
+{
+    const Index candidates_number = candidates.size();
+
+    const Index maximum_epochs_number = training_strategy_pointer->get_maximum_epochs_number();
+
+    rungs.resize(candidates_number);
+    rungs.setZero();
+
+    if(racing_epochs_number == 0 || racing_epochs_number >= maximum_epochs_number || candidates_number <= 1)
+    {
+        return perform_trainings(candidates);
+    }
+
+    Tensor<Candidate, 1> racers = candidates;
+
+    Tensor<OptimizationAlgorithm::Results, 1> results(candidates_number);
+
+    vector<Index> survivors(static_cast<size_t>(candidates_number));
+
+    for(Index i = 0; i < candidates_number; i++) survivors[static_cast<size_t>(i)] = i;
+
+    Index trained_epochs_number = 0;
+
+    Index epochs_number = racing_epochs_number;
+
+    Index rung = 0;
+
+    while(true)
+    {
+        const Index survivors_number = static_cast<Index>(survivors.size());
+
+        Tensor<Candidate, 1> round_candidates(survivors_number);
+
+        for(Index i = 0; i < survivors_number; i++)
+        {
+            round_candidates(i) = racers(survivors[static_cast<size_t>(i)]);
+            round_candidates(i).maximum_epochs_number = epochs_number - trained_epochs_number;
+        }
+
+        const Tensor<OptimizationAlgorithm::Results, 1> round_results = perform_trainings(round_candidates);
+
+        for(Index i = 0; i < survivors_number; i++)
+        {
+            const Index index = survivors[static_cast<size_t>(i)];
+
+            results(index) = round_results(i);
+
+            rungs(index) = rung;
+
+            racers(index).parameters = round_results(i).final_parameters;
+        }
+
+        if(epochs_number >= maximum_epochs_number) break;
+
+        // Keep the best half, all the survivors have run the same rounds
+
+        sort(survivors.begin(), survivors.end(), [&results](const Index& a, const Index& b)
+        {
+            return results(a).final_selection_error < results(b).final_selection_error;
+        });
+
+        survivors.resize((survivors.size() + 1)/2);
+
+        trained_epochs_number = epochs_number;
+
+        epochs_number = min(2*epochs_number, maximum_epochs_number);
+
+        rung++;
+    }
+
+    return results;
+}
+
+
+/// Trains trials_number times each candidate and returns the results of the trial with the minimum selection error for each one.
+/// Candidates already in the cache, or repeated, are not trained again.
+/// All the trials of the new candidates race together if racing_epochs_number is not zero,
+/// and the optimum trial of a candidate is chosen among those which reached its furthest rung.
+/// If a candidate has initial parameters, only its first trial starts from them, and the rest start from random parameters.
+/// @param candidates Models to be trained.
+/// @param trials_number Number of trainings of each candidate, starting from different random parameters.
+
+Tensor<OptimizationAlgorithm::Results, 1> TrainingScheduler::perform_trials(const Tensor<Candidate, 1>& candidates, const Index& trials_number)
+{
+    const Index candidates_number = candidates.size();
+
+    // New candidates
+
+    vector<CandidateKey> keys(static_cast<size_t>(candidates_number));
+
+    vector<Index> new_candidates;
+
+    unordered_map<CandidateKey, Index, CandidateKeyHash> new_keys;
+
+    for(Index i = 0; i < candidates_number; i++)
+    {
+        const CandidateKey& key = keys[static_cast<size_t>(i)] = get_key(candidates(i));
+
+        if(cache.count(key) != 0 || new_keys.count(key) != 0) continue;
+
+        new_keys[key] = static_cast<Index>(new_candidates.size());
+
+        new_candidates.push_back(i);
+    }
+
+    // Trials
+
+    const Index new_candidates_number = static_cast<Index>(new_candidates.size());
+
+    Tensor<Candidate, 1> trials(new_candidates_number*trials_number);
+
+    for(Index i = 0; i < new_candidates_number; i++)
+    {
+        for(Index j = 0; j < trials_number; j++)
+        {
+            trials(i*trials_number+j) = candidates(new_candidates[static_cast<size_t>(i)]);
+
+            if(j != 0) trials(i*trials_number+j).parameters.resize(0);
+        }
+    }
+
+    Tensor<Index, 1> trials_rungs;
+
+    const Tensor<OptimizationAlgorithm::Results, 1> trials_results = perform_racing(trials, trials_rungs);
+
+    for(Index i = 0; i < new_candidates_number; i++)
+    {
+        Index optimum_trial = i*trials_number;
+
+        for(Index j = 0; j < trials_number; j++)
+        {
+            const Index trial = i*trials_number+j;
+
+            // A trial which has run more rounds of the race is better than one stopped before
+
+            if(trials_rungs(trial) > trials_rungs(optimum_trial)
+            || (trials_rungs(trial) == trials_rungs(optimum_trial)
+            && trials_results(trial).final_selection_error < trials_results(optimum_trial).final_selection_error))
+            {
+                optimum_trial = trial;
+            }
+        }
+
+        OptimizationAlgorithm::Results optimum_results = trials_results(optimum_trial);
+
+        optimum_results.training_error_history.resize(0);
+        optimum_results.selection_error_history.resize(0);
+
+        cache[keys[static_cast<size_t>(new_candidates[static_cast<size_t>(i)])]] = optimum_results;
+    }
+
+    // Results
+
+    Tensor<OptimizationAlgorithm::Results, 1> results(candidates_number);
+
+    for(Index i = 0; i < candidates_number; i++)
+    {
+        results(i) = cache.at(keys[static_cast<size_t>(i)]);
+    }
+
+    return results;
+}
+
+}
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
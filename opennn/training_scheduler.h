@@ -0,0 +1,220 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   T R A I N I N G   S C H E D U L E R   C L A S S   H E A D E R
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#ifndef TRAININGSCHEDULER_H
+#define TRAININGSCHEDULER_H
+
+// System includes
+
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <limits>
+#include <vector>
+#include <fstream>
+#include <iomanip>
+#include <unordered_map>
+#include <functional>
+#include <utility>
+#include <algorithm>
+#include <omp.h>
+
+// OpenNN includes
+
+#include "config.h"
+#include "data_set.h"
+#include "neural_network.h"
+#include "training_strategy.h"
+
+namespace OpenNN
+{
+
+/// This class trains several candidate models concurrently for the model selection algorithms.
+
+///
+/// Each worker owns a copy of the data set, the neural network and the training strategy,
+/// so that candidates can change the input columns or the hidden neurons without touching the originals.
+/// The workers run on an OpenMP team, and each one is given a budget of threads for its own thread pools.
+/// The results of the trials are cached by input columns mask and neurons number, so that repeated candidates are not trained again.
+/// The cache can be saved to a file and loaded back, so that it is kept between model selection runs.
+/// Optionally, the trials race by successive halving: all of them are trained for a few epochs, and only the best half goes on
+/// with twice the epochs, until the maximum epochs number of the training strategy is reached.
+/// Each round of the race is a rung, and the results of trials stopped at different rungs are compared by rung first.
+
+class TrainingScheduler
+{
+
+public:
+
+   // Constructors
+
+   explicit TrainingScheduler();
+
+   explicit TrainingScheduler(TrainingStrategy*);
+
+   // Destructor
+
+   virtual ~TrainingScheduler();
+
+   /// This structure describes a model to be trained.
+
+   struct Candidate
+   {
+       /// Default constructor.
+
+       explicit Candidate() {}
+
+       virtual ~Candidate() {}
+
+       /// Uses of the data set columns. If empty, the uses of the original data set are kept.
+
+       Tensor<DataSet::VariableUse, 1> columns_uses;
+
+       /// Neurons number of the last hidden layer. If zero, the original neurons number is kept.
+
+       Index neurons_number = 0;
+
+       /// Initial parameters of the neural network. If empty, the parameters are initialized at random.
+
+       Tensor<type, 1> parameters;
+
+       /// Maximum epochs number of the training. If zero, the one of the training strategy is used.
+
+       Index maximum_epochs_number = 0;
+   };
+
+   // Get methods
+
+   TrainingStrategy* get_training_strategy_pointer() const;
+
+   const Index& get_workers_number() const;
+   const Index& get_worker_threads_number() const;
+   const Index& get_racing_epochs_number() const;
+
+   Index get_cache_size() const;
+
+   // Set methods
+
+   void set();
+   void set(TrainingStrategy*);
+
+   void set_default();
+
+   void set_training_strategy_pointer(TrainingStrategy*);
+
+   void set_workers_number(const Index&);
+   void set_worker_threads_number(const Index&);
+   void set_racing_epochs_number(const Index&);
+
+   // Training methods
+
+   Tensor<OptimizationAlgorithm::Results, 1> perform_trainings(const Tensor<Candidate, 1>&);
+
+   OptimizationAlgorithm::Results perform_training(const Candidate&);
+
+   Tensor<OptimizationAlgorithm::Results, 1> perform_racing(const Tensor<Candidate, 1>&);
+   Tensor<OptimizationAlgorithm::Results, 1> perform_racing(const Tensor<Candidate, 1>&, Tensor<Index, 1>&);
+
+   Tensor<OptimizationAlgorithm::Results, 1> perform_trials(const Tensor<Candidate, 1>&, const Index&);
+
+   void delete_workers();
+
+   void clear_cache();
+
+   // Serialization methods
+
+   void save_cache(const string&) const;
+   void load_cache(const string&);
+
+private:
+
+   /// Copy of the data set, neural network and training strategy used by one thread.
+
+   struct Worker
+   {
+       explicit Worker(const Index& threads_number) : thread_pool(static_cast<int>(threads_number)) {}
+
+       virtual ~Worker() {}
+
+       /// Thread pool of the copies, declared first so that it is destroyed after them.
+
+       NonBlockingThreadPool thread_pool;
+
+       DataSet data_set;
+
+       NeuralNetwork neural_network;
+
+       TrainingStrategy training_strategy;
+   };
+
+   /// Key of a candidate in the cache, made of the input columns mask and the neurons number.
+
+   typedef pair<vector<bool>, Index> CandidateKey;
+
+   /// Hash function of the candidates keys.
+
+   struct CandidateKeyHash
+   {
+       size_t operator()(const CandidateKey& key) const
+       {
+           return hash<vector<bool>>()(key.first) ^ (hash<Index>()(key.second) << 1);
+       }
+   };
+
+   void create_workers();
+
+   void set_candidate(const Candidate&, Worker*) const;
+
+   CandidateKey get_key(const Candidate&) const;
+
+   /// Pointer to the training strategy to be copied by the workers.
+
+   TrainingStrategy* training_strategy_pointer = nullptr;
+
+   /// Copies of the training strategy, one for each worker.
+
+   Tensor<Worker*, 1> workers;
+
+   /// Number of candidates trained at the same time.
+
+   Index workers_number = 1;
+
+   /// Number of threads of the thread pools of each worker.
+
+   Index worker_threads_number = 1;
+
+   /// Epochs number of the first round of successive halving. If zero, the candidates do not race.
+
+   Index racing_epochs_number = 0;
+
+   /// Optimum results of the candidates already trained.
+
+   unordered_map<CandidateKey, OptimizationAlgorithm::Results, CandidateKeyHash> cache;
+};
+
+}
+
+#endif
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
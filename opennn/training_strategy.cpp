@@ -358,6 +358,29 @@ const TrainingStrategy::OptimizationMethod& TrainingStrategy::get_optimization_m
 }
 
 
+/// Returns the maximum number of epochs of the main optimization algorithm.
+
+const Index& TrainingStrategy::get_maximum_epochs_number() const
+{
+    switch(optimization_method)
+    {
+        case GRADIENT_DESCENT: return gradient_descent.get_maximum_epochs_number();
+
+        case CONJUGATE_GRADIENT: return conjugate_gradient.get_maximum_epochs_number();
+
+        case QUASI_NEWTON_METHOD: return quasi_Newton_method.get_maximum_epochs_number();
+
+        case LEVENBERG_MARQUARDT_ALGORITHM: return Levenberg_Marquardt_algorithm.get_maximum_epochs_number();
+
+        case STOCHASTIC_GRADIENT_DESCENT: return stochastic_gradient_descent.get_maximum_epochs_number();
+
+        case ADAPTIVE_MOMENT_ESTIMATION: return adaptive_moment_estimation.get_maximum_epochs_number();
+    }
+
+    return quasi_Newton_method.get_maximum_epochs_number();
+}
+
+
 /// Returns a string with the type of the main loss algorithm composing this training strategy object.
 
 string TrainingStrategy::write_loss_method() const
@@ -127,6 +127,8 @@ public:
    const LossMethod& get_loss_method() const;
    const OptimizationMethod& get_optimization_method() const;
 
+   const Index& get_maximum_epochs_number() const;
+
    string write_loss_method() const;
    string write_optimization_method() const;
 
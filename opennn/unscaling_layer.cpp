@@ -323,6 +323,10 @@ void UnscalingLayer::set(const tinyxml2::XMLDocument& new_unscaling_layer_docume
 
 void UnscalingLayer::set(const UnscalingLayer& new_unscaling_layer)
 {
+    layer_name = "unscaling_layer";
+
+    layer_type = Unscaling;
+
     descriptives = new_unscaling_layer.descriptives;
 
     unscaling_methods = new_unscaling_layer.unscaling_methods;
@@ -708,7 +712,7 @@ Tensor<type, 2> UnscalingLayer::calculate_outputs(const Tensor<type, 2>& inputs)
                              << "Those variables won't be scaled.\n";
                     }
 
-                    outputs(j) = inputs(j);
+                    outputs(i,j) = inputs(i,j);
                 }
                 else
                 {
@@ -1208,6 +1212,88 @@ string UnscalingLayer::write_expression_c() const
 }
 
 
+/// Returns the C function of the unscaling layer for a batch of inputs, which are stored by rows.
+/// Each unscaling method is written as a slope and an intercept for each output.
+/// The logarithmic method is affine in the exponential of the input, which is calculated only for those outputs.
+
+string UnscalingLayer::write_batch_expression_c() const
+{
+    const Index neurons_number = get_neurons_number();
+
+    Tensor<type, 1> slopes(neurons_number);
+    Tensor<type, 1> intercepts(neurons_number);
+    Tensor<type, 1> logarithmic(neurons_number);
+
+    slopes.setConstant(1);
+    intercepts.setZero();
+    logarithmic.setZero();
+
+    for(Index i = 0; i < neurons_number; i++)
+    {
+        if(abs(descriptives(i).minimum - descriptives(i).maximum) < numeric_limits<type>::min())
+        {
+            continue;
+        }
+        else if(unscaling_methods(i) == MinimumMaximum)
+        {
+            slopes(i) = (descriptives(i).maximum - descriptives(i).minimum)/static_cast<type>(2);
+
+            intercepts(i) = (descriptives(i).minimum + descriptives(i).maximum)/static_cast<type>(2);
+        }
+        else if(unscaling_methods(i) == MeanStandardDeviation)
+        {
+            slopes(i) = descriptives(i).standard_deviation/static_cast<type>(2);
+
+            intercepts(i) = descriptives(i).mean;
+        }
+        else if(unscaling_methods(i) == Logarithmic)
+        {
+            slopes(i) = static_cast<type>(0.5)*(descriptives(i).maximum - descriptives(i).minimum);
+
+            intercepts(i) = static_cast<type>(0.5)*(descriptives(i).maximum - descriptives(i).minimum) + descriptives(i).minimum;
+
+            logarithmic(i) = 1;
+        }
+    }
+
+    const Tensor<type, 0> logarithmic_number = logarithmic.sum();
+
+    ostringstream buffer;
+
+    buffer << write_array_c(layer_name + "_slopes", slopes.data(), neurons_number);
+    buffer << write_array_c(layer_name + "_intercepts", intercepts.data(), neurons_number);
+
+    if(logarithmic_number(0) > 0)
+    {
+        buffer << write_array_c(layer_name + "_logarithmic", logarithmic.data(), neurons_number);
+    }
+
+    buffer << "static void " << layer_name << "(const float* inputs, float* outputs, int batch_size)\n{" << endl;
+
+    buffer << "\tfor(int i = 0; i < batch_size; i++)\n\t{" << endl;
+    buffer << "\t\tfor(int j = 0; j < " << neurons_number << "; j++)\n\t\t{" << endl;
+
+    if(logarithmic_number(0) > 0)
+    {
+        buffer << "\t\t\tconst float x = inputs[i*" << neurons_number << " + j];\n" << endl;
+        buffer << "\t\t\toutputs[i*" << neurons_number << " + j] = (" << layer_name << "_logarithmic[j] != 0.0f ? expf(x) : x)*"
+               << layer_name << "_slopes[j] + " << layer_name << "_intercepts[j];" << endl;
+    }
+    else
+    {
+        buffer << "\t\t\toutputs[i*" << neurons_number << " + j] = inputs[i*" << neurons_number << " + j]*"
+               << layer_name << "_slopes[j] + " << layer_name << "_intercepts[j];" << endl;
+    }
+
+    buffer << "\t\t}" << endl;
+    buffer << "\t}" << endl;
+
+    buffer << "}\n" << endl;
+
+    return buffer.str();
+}
+
+
 /// Returns a string with the expression of the unscaling process in this layer.
 /// @param inputs_names Name of inputs to the unscaling layer. The size of this vector must be equal to the number of unscaling neurons.
 /// @param outputs_names Name of outputs from the unscaling layer. The size of this vector must be equal to the number of unscaling neurons.
@@ -0,0 +1,124 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   S E R V E   A P P L I C A T I O N
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+// This application serves the outputs of a saved neural network on a local socket,
+// until it is interrupted, and then prints the statistics of the server.
+
+// System includes
+
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <csignal>
+#include <atomic>
+#include <thread>
+#include <chrono>
+
+// OpenNN includes
+
+#include "../opennn/opennn.h"
+
+using namespace OpenNN;
+
+atomic<bool> interrupted(false);
+
+
+/// Asks the application to stop serving.
+
+void interrupt(int)
+{
+    interrupted = true;
+}
+
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        if(argc < 2)
+        {
+            cout << "Usage: opennn_serve model_file [--address address] [--port number] [--unix path]\n"
+                 << "                   [--workers number] [--worker-threads number]\n"
+                 << "                   [--max-batch instances] [--max-delay seconds]" << endl;
+
+            return 1;
+        }
+
+        ModelServer model_server(argv[1]);
+
+        for(int i = 2; i < argc; i++)
+        {
+            const string argument = argv[i];
+
+            if(i + 1 == argc)
+            {
+                cout << "Missing value of argument: " << argument << endl;
+
+                return 1;
+            }
+
+            const string value = argv[++i];
+
+            if(argument == "--address") model_server.set_address(value);
+            else if(argument == "--port") model_server.set_port(atoi(value.c_str()));
+            else if(argument == "--unix") model_server.set_unix_socket_path(value);
+            else if(argument == "--workers") model_server.set_workers_number(atol(value.c_str()));
+            else if(argument == "--worker-threads") model_server.set_worker_threads_number(atol(value.c_str()));
+            else if(argument == "--max-batch") model_server.set_maximum_batch_instances_number(atol(value.c_str()));
+            else if(argument == "--max-delay") model_server.set_maximum_batch_delay(static_cast<type>(atof(value.c_str())));
+            else
+            {
+                cout << "Unknown argument: " << argument << endl;
+
+                return 1;
+            }
+        }
+
+        cout << "OpenNN. Model server." << endl;
+
+        signal(SIGINT, interrupt);
+        signal(SIGTERM, interrupt);
+
+        model_server.start();
+
+        while(!interrupted)
+        {
+            this_thread::sleep_for(chrono::milliseconds(100));
+        }
+
+        model_server.stop();
+
+        model_server.get_statistics().print();
+
+        return 0;
+    }
+    catch(exception& e)
+    {
+        cerr << e.what() << endl;
+
+        return 1;
+    }
+}
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
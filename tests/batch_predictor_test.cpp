@@ -0,0 +1,446 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   B A T C H   P R E D I C T O R   T E S T   C L A S S
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#include "batch_predictor_test.h"
+
+
+/// Reads the values of a CSV file of numbers separated by commas.
+
+static Tensor<type, 2> read_csv_values(const string& file_name, const bool& has_columns_names)
+{
+    ifstream file(file_name.c_str());
+
+    vector<vector<type>> rows;
+    string line;
+
+    if(has_columns_names) getline(file, line);
+
+    while(getline(file, line))
+    {
+        istringstream line_stream(line);
+        string field;
+        vector<type> row;
+
+        while(getline(line_stream, field, ',')) row.push_back(static_cast<type>(strtod(field.c_str(), nullptr)));
+
+        rows.push_back(row);
+    }
+
+    const Index columns_number = rows.empty() ? 0 : static_cast<Index>(rows[0].size());
+
+    Tensor<type, 2> values(static_cast<Index>(rows.size()), columns_number);
+
+    for(size_t i = 0; i < rows.size(); i++)
+    {
+        for(size_t j = 0; j < rows[i].size() && static_cast<Index>(j) < columns_number; j++)
+        {
+            values(static_cast<Index>(i), static_cast<Index>(j)) = rows[i][j];
+        }
+    }
+
+    return values;
+}
+
+
+/// Reads the values of a binary data file, which are stored by columns after the numbers of columns and rows.
+
+static Tensor<type, 2> read_binary_values(const string& file_name)
+{
+    ifstream file(file_name.c_str(), ios::binary);
+
+    Index columns_number = 0;
+    Index rows_number = 0;
+
+    file.read(reinterpret_cast<char*>(&columns_number), sizeof(Index));
+    file.read(reinterpret_cast<char*>(&rows_number), sizeof(Index));
+
+    Tensor<type, 2> values(rows_number, columns_number);
+
+    file.read(reinterpret_cast<char*>(values.data()), static_cast<streamsize>(values.size()*static_cast<Index>(sizeof(type))));
+
+    return values;
+}
+
+
+/// Returns true if two matrices have the same dimensions and their values differ less than a tolerance.
+
+static bool are_equal(const Tensor<type, 2>& a, const Tensor<type, 2>& b)
+{
+    if(a.dimension(0) != b.dimension(0) || a.dimension(1) != b.dimension(1)) return false;
+
+    const Tensor<type, 0> maximum_difference = (a - b).abs().maximum();
+
+    return maximum_difference(0) < static_cast<type>(1e-10);
+}
+
+
+BatchPredictorTest::BatchPredictorTest() : UnitTesting()
+{
+}
+
+
+BatchPredictorTest::~BatchPredictorTest()
+{
+}
+
+
+void BatchPredictorTest::test_constructor()
+{
+    cout << "test_constructor\n";
+
+    Tensor<Index, 1> architecture(3);
+    architecture.setValues({3, 4, 2});
+
+    NeuralNetwork neural_network(NeuralNetwork::Approximation, architecture);
+
+    BatchPredictor batch_predictor_1(&neural_network);
+
+    assert_true(batch_predictor_1.get_neural_network_pointer() == &neural_network, LOG);
+
+    BatchPredictor batch_predictor_2;
+
+    assert_true(batch_predictor_2.get_neural_network_pointer() == nullptr, LOG);
+}
+
+
+void BatchPredictorTest::test_destructor()
+{
+    cout << "test_destructor\n";
+
+    BatchPredictor* batch_predictor = new BatchPredictor;
+
+    delete batch_predictor;
+}
+
+
+void BatchPredictorTest::test_set_default()
+{
+    cout << "test_set_default\n";
+
+    BatchPredictor batch_predictor;
+
+    batch_predictor.set_inputs_file_format("Binary");
+    batch_predictor.set_outputs_file_format("Binary");
+    batch_predictor.set_chunk_instances_number(10);
+    batch_predictor.set_workers_number(3);
+
+    assert_true(batch_predictor.get_inputs_file_format() == BatchPredictor::Binary, LOG);
+    assert_true(batch_predictor.write_outputs_file_format() == "Binary", LOG);
+
+    batch_predictor.set_default();
+
+    assert_true(batch_predictor.get_inputs_file_format() == BatchPredictor::CSV, LOG);
+    assert_true(batch_predictor.get_outputs_file_format() == BatchPredictor::CSV, LOG);
+    assert_true(batch_predictor.get_separator() == ',', LOG);
+    assert_true(!batch_predictor.get_has_columns_names(), LOG);
+    assert_true(batch_predictor.get_input_variables_indices().size() == 0, LOG);
+    assert_true(batch_predictor.get_chunk_instances_number() == 1000, LOG);
+    assert_true(batch_predictor.get_workers_number() == omp_get_max_threads(), LOG);
+    assert_true(batch_predictor.get_worker_threads_number() == 1, LOG);
+
+    // Wrong values
+
+    try
+    {
+        batch_predictor.set_chunk_instances_number(0);
+
+        assert_true(false, LOG);
+    }
+    catch(const logic_error&)
+    {
+        assert_true(true, LOG);
+    }
+
+    try
+    {
+        batch_predictor.set_outputs_file_format("Parquet");
+
+        assert_true(false, LOG);
+    }
+    catch(const logic_error&)
+    {
+        assert_true(true, LOG);
+    }
+}
+
+
+void BatchPredictorTest::test_predict_csv()
+{
+    cout << "test_predict_csv\n";
+
+    const string inputs_file_name = "../data/batch_predictor_inputs.csv";
+    const string outputs_file_name = "../data/batch_predictor_outputs.csv";
+
+    Tensor<Index, 1> architecture(3);
+    architecture.setValues({3, 4, 2});
+
+    NeuralNetwork neural_network(NeuralNetwork::Approximation, architecture);
+    neural_network.set_parameters_random();
+
+    // The last column is not an input, and the last line is empty
+
+    Tensor<type, 2> data(53, 4);
+    data.setRandom();
+
+    ofstream inputs_file(inputs_file_name.c_str());
+
+    inputs_file << "a,b,c,target\n";
+
+    inputs_file.precision(17);
+
+    for(Index i = 0; i < data.dimension(0); i++)
+    {
+        inputs_file << data(i, 0) << "," << data(i, 1) << ", " << data(i, 2) << "," << data(i, 3) << "\n";
+    }
+
+    inputs_file << "\n";
+
+    inputs_file.close();
+
+    const Eigen::array<Index, 2> offsets = {0, 0};
+    const Eigen::array<Index, 2> extents = {53, 3};
+
+    const Tensor<type, 2> inputs = data.slice(offsets, extents);
+
+    const Tensor<type, 2> outputs = neural_network.calculate_outputs(inputs);
+
+    Tensor<Index, 1> input_variables_indices(3);
+    input_variables_indices.setValues({0, 1, 2});
+
+    BatchPredictor batch_predictor(&neural_network);
+
+    batch_predictor.set_has_columns_names(true);
+    batch_predictor.set_input_variables_indices(input_variables_indices);
+    batch_predictor.set_chunk_instances_number(7);
+    batch_predictor.set_workers_number(3);
+    batch_predictor.set_display(false);
+
+    assert_true(batch_predictor.predict(inputs_file_name, outputs_file_name) == 53, LOG);
+
+    ifstream outputs_file(outputs_file_name.c_str());
+
+    string header;
+
+    getline(outputs_file, header);
+
+    outputs_file.close();
+
+    assert_true(header.find(',') != string::npos, LOG);
+    assert_true(are_equal(read_csv_values(outputs_file_name, true), outputs), LOG);
+
+    // Binary outputs of CSV inputs
+
+    batch_predictor.set_outputs_file_format(BatchPredictor::Binary);
+
+    assert_true(batch_predictor.predict(inputs_file_name, outputs_file_name) == 53, LOG);
+
+    assert_true(are_equal(read_binary_values(outputs_file_name), outputs), LOG);
+
+    // Wrong number of values
+
+    ofstream wrong_inputs_file(inputs_file_name.c_str());
+
+    wrong_inputs_file << "1,2,3\n4,5\n";
+
+    wrong_inputs_file.close();
+
+    batch_predictor.set_has_columns_names(false);
+    batch_predictor.set_input_variables_indices(Tensor<Index, 1>());
+    batch_predictor.set_outputs_file_format(BatchPredictor::CSV);
+
+    try
+    {
+        batch_predictor.predict(inputs_file_name, outputs_file_name);
+
+        assert_true(false, LOG);
+    }
+    catch(const logic_error&)
+    {
+        assert_true(true, LOG);
+    }
+
+    remove(inputs_file_name.c_str());
+    remove(outputs_file_name.c_str());
+}
+
+
+void BatchPredictorTest::test_predict_binary()
+{
+    cout << "test_predict_binary\n";
+
+    const string inputs_file_name = "../data/batch_predictor_inputs.bin";
+    const string outputs_file_name = "../data/batch_predictor_outputs.bin";
+
+    Tensor<Index, 1> architecture(3);
+    architecture.setValues({2, 3, 1});
+
+    NeuralNetwork neural_network(NeuralNetwork::Approximation, architecture);
+    neural_network.set_parameters_random();
+
+    // The inputs are the second and the fourth columns
+
+    Tensor<type, 2> data(41, 4);
+    data.setRandom();
+
+    DataSet data_set;
+    data_set.set_display(false);
+    data_set.set_data(data);
+    data_set.save_data_binary(inputs_file_name);
+
+    Tensor<type, 2> inputs(41, 2);
+
+    for(Index i = 0; i < 41; i++)
+    {
+        inputs(i, 0) = data(i, 1);
+        inputs(i, 1) = data(i, 3);
+    }
+
+    const Tensor<type, 2> outputs = neural_network.calculate_outputs(inputs);
+
+    Tensor<Index, 1> input_variables_indices(2);
+    input_variables_indices.setValues({1, 3});
+
+    BatchPredictor batch_predictor(&neural_network);
+
+    batch_predictor.set_inputs_file_format(BatchPredictor::Binary);
+    batch_predictor.set_outputs_file_format(BatchPredictor::Binary);
+    batch_predictor.set_input_variables_indices(input_variables_indices);
+    batch_predictor.set_chunk_instances_number(10);
+    batch_predictor.set_workers_number(2);
+    batch_predictor.set_display(false);
+
+    assert_true(batch_predictor.predict(inputs_file_name, outputs_file_name) == 41, LOG);
+
+    assert_true(are_equal(read_binary_values(outputs_file_name), outputs), LOG);
+
+    // CSV outputs of binary inputs
+
+    batch_predictor.set_outputs_file_format(BatchPredictor::CSV);
+
+    assert_true(batch_predictor.predict(inputs_file_name, outputs_file_name) == 41, LOG);
+
+    assert_true(are_equal(read_csv_values(outputs_file_name, false), outputs), LOG);
+
+    // Missing inputs file
+
+    try
+    {
+        batch_predictor.predict("../data/missing_batch_predictor_inputs.bin", outputs_file_name);
+
+        assert_true(false, LOG);
+    }
+    catch(const logic_error&)
+    {
+        assert_true(true, LOG);
+    }
+
+    remove(inputs_file_name.c_str());
+    remove(outputs_file_name.c_str());
+}
+
+
+void BatchPredictorTest::test_predict_data_set()
+{
+    cout << "test_predict_data_set\n";
+
+    const string outputs_file_name = "../data/batch_predictor_outputs.csv";
+
+    Tensor<type, 2> data(29, 4);
+    data.setRandom();
+
+    DataSet data_set;
+    data_set.set_data(data);
+
+    Tensor<Index, 1> architecture(3);
+    architecture.setValues({3, 5, 2});
+
+    NeuralNetwork neural_network(NeuralNetwork::Approximation, architecture);
+    neural_network.set_parameters_random();
+
+    const Tensor<type, 2> outputs = neural_network.calculate_outputs(data_set.get_input_data());
+
+    BatchPredictor batch_predictor(&neural_network);
+
+    batch_predictor.set_chunk_instances_number(4);
+    batch_predictor.set_workers_number(4);
+    batch_predictor.set_display(false);
+
+    assert_true(batch_predictor.predict(data_set, outputs_file_name) == 29, LOG);
+
+    assert_true(are_equal(read_csv_values(outputs_file_name, false), outputs), LOG);
+
+    // One chunk with more instances than the data set
+
+    batch_predictor.set_chunk_instances_number(100);
+    batch_predictor.set_workers_number(1);
+
+    assert_true(batch_predictor.predict(data_set, outputs_file_name) == 29, LOG);
+
+    assert_true(are_equal(read_csv_values(outputs_file_name, false), outputs), LOG);
+
+    // Input variables which do not match the neural network
+
+    Tensor<Index, 1> input_variables_indices(3);
+    input_variables_indices.setValues({0, 1, 7});
+
+    batch_predictor.set_input_variables_indices(input_variables_indices);
+
+    try
+    {
+        batch_predictor.predict(data_set, outputs_file_name);
+
+        assert_true(false, LOG);
+    }
+    catch(const logic_error&)
+    {
+        assert_true(true, LOG);
+    }
+
+    remove(outputs_file_name.c_str());
+}
+
+
+void BatchPredictorTest::run_test_case()
+{
+    cout << "Running batch predictor test case...\n";
+
+    // Constructor and destructor methods
+
+    test_constructor();
+    test_destructor();
+
+    // Set methods
+
+    test_set_default();
+
+    // Prediction methods
+
+    test_predict_csv();
+    test_predict_binary();
+    test_predict_data_set();
+
+    cout << "End of batch predictor test case.\n";
+}
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
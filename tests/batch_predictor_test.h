@@ -0,0 +1,74 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   B A T C H   P R E D I C T O R   T E S T   C L A S S   H E A D E R
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#ifndef BATCHPREDICTORTEST_H
+#define BATCHPREDICTORTEST_H
+
+// Unit testing includes
+
+#include "unit_testing.h"
+
+using namespace OpenNN;
+
+
+class BatchPredictorTest : public UnitTesting
+{
+
+#define	STRING(x) #x
+#define TOSTRING(x) STRING(x)
+#define LOG __FILE__ ":" TOSTRING(__LINE__)"\n"
+
+public:
+
+   // CONSTRUCTOR
+
+   explicit BatchPredictorTest();
+
+   virtual ~BatchPredictorTest();
+
+   // Constructor and destructor methods
+
+   void test_constructor();
+   void test_destructor();
+
+   // Set methods
+
+   void test_set_default();
+
+   // Prediction methods
+
+   void test_predict_csv();
+   void test_predict_binary();
+   void test_predict_data_set();
+
+   // Unit testing methods
+
+   void run_test_case();
+
+};
+
+
+#endif
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
@@ -98,74 +98,103 @@ void ConvolutionalLayerTest::test_get_parameters() // @todo
 }
 
 
-void ConvolutionalLayerTest::test_get_outputs_dimensions() // @todo
+void ConvolutionalLayerTest::test_get_outputs_dimensions()
 {
     cout << "test_get_outputs_dimensions\n";
 
-//    ConvolutionalLayer convolutional_layer = OpenNN::ConvolutionalLayer({3,500,600}, {10,2,3});
+    Tensor<Index, 1> inputs_dimensions(3);
+    inputs_dimensions.setValues({3, 500, 600});
 
-//    // Test
+    Tensor<Index, 1> filters_dimensions(3);
+    filters_dimensions.setValues({10, 2, 3});
 
-//    convolutional_layer.set_row_stride(1);
-//    convolutional_layer.set_column_stride(1);
-//    convolutional_layer.set_padding_option(OpenNN::ConvolutionalLayer::NoPadding);
+    ConvolutionalLayer convolutional_layer(inputs_dimensions, filters_dimensions);
 
-//    assert_true(convolutional_layer.get_outputs_dimensions()[0] == 10 &&
-//                convolutional_layer.get_outputs_dimensions()[1] == 499 &&
-//                convolutional_layer.get_outputs_dimensions()[2] == 598, LOG);
+    // Test
 
-//    // Test
+    convolutional_layer.set_row_stride(1);
+    convolutional_layer.set_column_stride(1);
+    convolutional_layer.set_padding_option(OpenNN::ConvolutionalLayer::NoPadding);
 
-//    convolutional_layer.set_row_stride(2);
-//    convolutional_layer.set_column_stride(3);
-//    convolutional_layer.set_padding_option(OpenNN::ConvolutionalLayer::NoPadding);
+    assert_true(convolutional_layer.get_outputs_dimensions()[0] == 10 &&
+                convolutional_layer.get_outputs_dimensions()[1] == 499 &&
+                convolutional_layer.get_outputs_dimensions()[2] == 598, LOG);
 
-//    assert_true(convolutional_layer.get_outputs_dimensions()[0] == 10 &&
-//                convolutional_layer.get_outputs_dimensions()[1] == 250 &&
-//                convolutional_layer.get_outputs_dimensions()[2] == 200, LOG);
+    // Test
 
-//    // Test
+    convolutional_layer.set_row_stride(2);
+    convolutional_layer.set_column_stride(3);
+    convolutional_layer.set_padding_option(OpenNN::ConvolutionalLayer::NoPadding);
 
-//    convolutional_layer.set_row_stride(1);
-//    convolutional_layer.set_column_stride(1);
-//    convolutional_layer.set_padding_option(OpenNN::ConvolutionalLayer::Same);
+    assert_true(convolutional_layer.get_outputs_dimensions()[0] == 10 &&
+                convolutional_layer.get_outputs_dimensions()[1] == 250 &&
+                convolutional_layer.get_outputs_dimensions()[2] == 200, LOG);
 
-//    assert_true(convolutional_layer.get_outputs_dimensions()[0] == 10 &&
-//                convolutional_layer.get_outputs_dimensions()[1] == 500 &&
-//                convolutional_layer.get_outputs_dimensions()[2] == 600, LOG);
+    // Test
 
-//    // Test
+    convolutional_layer.set_row_stride(1);
+    convolutional_layer.set_column_stride(1);
+    convolutional_layer.set_padding_option(OpenNN::ConvolutionalLayer::Same);
 
-//    convolutional_layer.set_row_stride(2);
-//    convolutional_layer.set_column_stride(3);
-//    convolutional_layer.set_padding_option(OpenNN::ConvolutionalLayer::Same);
+    assert_true(convolutional_layer.get_outputs_dimensions()[0] == 10 &&
+                convolutional_layer.get_outputs_dimensions()[1] == 500 &&
+                convolutional_layer.get_outputs_dimensions()[2] == 600, LOG);
+
+    // Test
+
+    convolutional_layer.set_row_stride(2);
+    convolutional_layer.set_column_stride(3);
+    convolutional_layer.set_padding_option(OpenNN::ConvolutionalLayer::Same);
+
+    assert_true(convolutional_layer.get_outputs_dimensions()[0] == 10 &&
+                convolutional_layer.get_outputs_dimensions()[1] == 250 &&
+                convolutional_layer.get_outputs_dimensions()[2] == 200, LOG);
 
-//    assert_true(convolutional_layer.get_outputs_dimensions()[0] == 10 &&
-//                convolutional_layer.get_outputs_dimensions()[1] == 500 &&
-//                convolutional_layer.get_outputs_dimensions()[2] == 600, LOG);
+    // Test, the outputs have ceil(inputs/stride) rows and columns
+
+    inputs_dimensions.setValues({3, 7, 8});
+
+    convolutional_layer.set(inputs_dimensions, filters_dimensions);
+
+    convolutional_layer.set_row_stride(2);
+    convolutional_layer.set_column_stride(3);
+    convolutional_layer.set_padding_option(OpenNN::ConvolutionalLayer::Same);
+
+    assert_true(convolutional_layer.get_outputs_dimensions()[1] == 4 &&
+                convolutional_layer.get_outputs_dimensions()[2] == 3, LOG);
 }
 
 
-void ConvolutionalLayerTest::test_get_parameters_number() // @todo
+
+void ConvolutionalLayerTest::test_get_parameters_number()
 {
     cout << "test_get_parameters_number\n";
 
-//    ConvolutionalLayer convolutional_layer;
+    Tensor<Index, 1> inputs_dimensions(3);
+    Tensor<Index, 1> filters_dimensions(3);
 
-//    // Test
+    // Test
 
-//    convolutional_layer = OpenNN::ConvolutionalLayer({3,32,64}, {1,2,3});
+    inputs_dimensions.setValues({3, 32, 64});
+    filters_dimensions.setValues({1, 2, 3});
 
-//    assert_true(convolutional_layer.get_parameters_number() == 19, LOG);
+    ConvolutionalLayer convolutional_layer(inputs_dimensions, filters_dimensions);
 
-//    // Test
+    assert_true(convolutional_layer.get_parameters_number() == 19, LOG);
+
+    // Test
+
+    inputs_dimensions.setValues({3, 500, 600});
+    filters_dimensions.setValues({10, 2, 3});
 
-//    convolutional_layer = OpenNN::ConvolutionalLayer({3,500,600}, {10,2,3});
+    convolutional_layer.set(inputs_dimensions, filters_dimensions);
 
-//    assert_true(convolutional_layer.get_parameters_number() == 190, LOG);
+    assert_true(convolutional_layer.get_parameters_number() == 190, LOG);
+    assert_true(convolutional_layer.get_parameters().size() == 190, LOG);
 }
 
 
+
 void ConvolutionalLayerTest::test_set() // @todo
 {
     cout << "test_set\n";
@@ -1242,291 +1271,271 @@ void ConvolutionalLayerTest::test_calculate_activations_derivatives() // @todo
 }
 
 
-void ConvolutionalLayerTest::test_calculate_outputs() // @todo
+void ConvolutionalLayerTest::test_calculate_outputs()
 {
     cout << "test_calculate_outputs\n";
 
-//    ConvolutionalLayer convolutional_layer;
+    Tensor<Index, 1> inputs_dimensions(3);
+    inputs_dimensions.setValues({2, 3, 3});
 
-//    Tensor<type, 2> images;
-//    Tensor<type, 2> filters;
-//    Tensor<type, 2> outputs;
+    Tensor<Index, 1> filters_dimensions(3);
+    filters_dimensions.setValues({2, 2, 2});
 
-//    // Test
+    ConvolutionalLayer convolutional_layer(inputs_dimensions, filters_dimensions);
 
-//    images.set(Tensor<Index, 1>({2,2,3,3}));
-//    images(0,0,0,0) = 1.1;
-//    images(0,0,0,1) = 1.1;
-//    images(0,0,0,2) = 1.1;
-//    images(0,0,1,0) = 1.1;
-//    images(0,0,1,1) = 1.1;
-//    images(0,0,1,2) = 1.1;
-//    images(0,0,2,0) = 1.1;
-//    images(0,0,2,1) = 1.1;
-//    images(0,0,2,2) = 1.1;
-//    images(0,1,0,0) = 1.2;
-//    images(0,1,0,1) = 1.2;
-//    images(0,1,0,2) = 1.2;
-//    images(0,1,1,0) = 1.2;
-//    images(0,1,1,1) = 1.2;
-//    images(0,1,1,2) = 1.2;
-//    images(0,1,2,0) = 1.2;
-//    images(0,1,2,1) = 1.2;
-//    images(0,1,2,2) = 1.2;
-//    images(1,0,0,0) = 2.1;
-//    images(1,0,0,1) = 2.1;
-//    images(1,0,0,2) = 2.1;
-//    images(1,0,1,0) = 2.1;
-//    images(1,0,1,1) = 2.1;
-//    images(1,0,1,2) = 2.1;
-//    images(1,0,2,0) = 2.1;
-//    images(1,0,2,1) = 2.1;
-//    images(1,0,2,2) = 2.1;
-//    images(1,1,0,0) = 2.2;
-//    images(1,1,0,1) = 2.2;
-//    images(1,1,0,2) = 2.2;
-//    images(1,1,1,0) = 2.2;
-//    images(1,1,1,1) = 2.2;
-//    images(1,1,1,2) = 2.2;
-//    images(1,1,2,0) = 2.2;
-//    images(1,1,2,1) = 2.2;
-//    images(1,1,2,2) = 2.2;
+    Tensor<type, 4> images(2, 2, 3, 3);
+    Tensor<type, 4> filters(2, 2, 2, 2);
+    Tensor<type, 1> biases(2);
+    Tensor<type, 4> outputs;
 
-//    filters.set({2,2,2,2}, 0);
+    // Test
 
-//    convolutional_layer.set({2,3,3}, {2,2,2});
-//    convolutional_layer.set_synaptic_weights(filters);
-//    convolutional_layer.set_biases({-1,1});
-//    convolutional_layer.set_activation_function(OpenNN::ConvolutionalLayer::Logistic);
-
-//    outputs = convolutional_layer.calculate_outputs(images);
-
-//    assert_true(abs(outputs(0,0,0,0) - 0.268941) < 1e-6 &&
-//                abs(outputs(0,0,0,1) - 0.268941) < 1e-6 &&
-//                abs(outputs(0,0,1,0) - 0.268941) < 1e-6 &&
-//                abs(outputs(0,0,1,1) - 0.268941) < 1e-6 &&
-//                abs(outputs(0,1,0,0) - 0.731059) < 1e-6 &&
-//                abs(outputs(0,1,0,1) - 0.731059) < 1e-6 &&
-//                abs(outputs(0,1,1,0) - 0.731059) < 1e-6 &&
-//                abs(outputs(0,1,1,1) - 0.731059) < 1e-6 &&
-//                abs(outputs(1,0,0,0) - 0.268941) < 1e-6 &&
-//                abs(outputs(1,0,0,1) - 0.268941) < 1e-6 &&
-//                abs(outputs(1,0,1,0) - 0.268941) < 1e-6 &&
-//                abs(outputs(1,0,1,1) - 0.268941) < 1e-6 &&
-//                abs(outputs(1,1,0,0) - 0.731059) < 1e-6 &&
-//                abs(outputs(1,1,0,1) - 0.731059) < 1e-6 &&
-//                abs(outputs(1,1,1,0) - 0.731059) < 1e-6 &&
-//                abs(outputs(1,1,1,1) - 0.731059) < 1e-6, LOG);
+    images.chip(0, 0).chip(0, 0).setConstant(1.1);
+    images.chip(0, 0).chip(1, 0).setConstant(1.2);
+    images.chip(1, 0).chip(0, 0).setConstant(2.1);
+    images.chip(1, 0).chip(1, 0).setConstant(2.2);
 
-//    // Test
+    filters.setZero();
+    biases.setValues({-1, 1});
 
-//    images.set(Tensor<Index, 1>({2,1,6,6}));
-//    images(0,0,0,0) = 1;
-//    images(0,0,0,1) = 2;
-//    images(0,0,0,2) = 3;
-//    images(0,0,0,3) = 4;
-//    images(0,0,0,4) = 5;
-//    images(0,0,0,5) = 6;
-//    images(0,0,1,0) = 7;
-//    images(0,0,1,1) = 8;
-//    images(0,0,1,2) = 9;
-//    images(0,0,1,3) = 10;
-//    images(0,0,1,4) = 11;
-//    images(0,0,1,5) = 12;
-//    images(0,0,2,0) = 13;
-//    images(0,0,2,1) = 14;
-//    images(0,0,2,2) = 15;
-//    images(0,0,2,3) = 16;
-//    images(0,0,2,4) = 17;
-//    images(0,0,2,5) = 18;
-//    images(0,0,3,0) = 19;
-//    images(0,0,3,1) = 20;
-//    images(0,0,3,2) = 21;
-//    images(0,0,3,3) = 22;
-//    images(0,0,3,4) = 23;
-//    images(0,0,3,5) = 24;
-//    images(0,0,4,0) = 25;
-//    images(0,0,4,1) = 26;
-//    images(0,0,4,2) = 27;
-//    images(0,0,4,3) = 28;
-//    images(0,0,4,4) = 29;
-//    images(0,0,4,5) = 30;
-//    images(0,0,5,0) = 31;
-//    images(0,0,5,1) = 32;
-//    images(0,0,5,2) = 33;
-//    images(0,0,5,3) = 34;
-//    images(0,0,5,4) = 35;
-//    images(0,0,5,5) = 36;
-//    images(1,0,0,0) = -1;
-//    images(1,0,0,1) = -2;
-//    images(1,0,0,2) = -3;
-//    images(1,0,0,3) = -4;
-//    images(1,0,0,4) = -5;
-//    images(1,0,0,5) = -6;
-//    images(1,0,1,0) = -7;
-//    images(1,0,1,1) = -8;
-//    images(1,0,1,2) = -9;
-//    images(1,0,1,3) = -10;
-//    images(1,0,1,4) = -11;
-//    images(1,0,1,5) = -12;
-//    images(1,0,2,0) = -13;
-//    images(1,0,2,1) = -14;
-//    images(1,0,2,2) = -15;
-//    images(1,0,2,3) = -16;
-//    images(1,0,2,4) = -17;
-//    images(1,0,2,5) = -18;
-//    images(1,0,3,0) = -19;
-//    images(1,0,3,1) = -20;
-//    images(1,0,3,2) = -21;
-//    images(1,0,3,3) = -22;
-//    images(1,0,3,4) = -23;
-//    images(1,0,3,5) = -24;
-//    images(1,0,4,0) = -25;
-//    images(1,0,4,1) = -26;
-//    images(1,0,4,2) = -27;
-//    images(1,0,4,3) = -28;
-//    images(1,0,4,4) = -29;
-//    images(1,0,4,5) = -30;
-//    images(1,0,5,0) = -31;
-//    images(1,0,5,1) = -32;
-//    images(1,0,5,2) = -33;
-//    images(1,0,5,3) = -34;
-//    images(1,0,5,4) = -35;
-//    images(1,0,5,5) = -36;
+    convolutional_layer.set_synaptic_weights(filters);
+    convolutional_layer.set_biases(biases);
+    convolutional_layer.set_activation_function(OpenNN::ConvolutionalLayer::Logistic);
 
-//    filters.set(Tensor<Index, 1>({3,1,3,3}));
-//    filters(0,0,0,0) = 1;
-//    filters(0,0,0,1) = 1;
-//    filters(0,0,0,2) = 1;
-//    filters(0,0,1,0) = 1;
-//    filters(0,0,1,1) = 1;
-//    filters(0,0,1,2) = 1;
-//    filters(0,0,2,0) = 1;
-//    filters(0,0,2,1) = 1;
-//    filters(0,0,2,2) = 1;
-//    filters(1,0,0,0) = 2;
-//    filters(1,0,0,1) = 2;
-//    filters(1,0,0,2) = 2;
-//    filters(1,0,1,0) = 2;
-//    filters(1,0,1,1) = 2;
-//    filters(1,0,1,2) = 2;
-//    filters(1,0,2,0) = 2;
-//    filters(1,0,2,1) = 2;
-//    filters(1,0,2,2) = 2;
-//    filters(2,0,0,0) = 3;
-//    filters(2,0,0,1) = 3;
-//    filters(2,0,0,2) = 3;
-//    filters(2,0,1,0) = 3;
-//    filters(2,0,1,1) = 3;
-//    filters(2,0,1,2) = 3;
-//    filters(2,0,2,0) = 3;
-//    filters(2,0,2,1) = 3;
-//    filters(2,0,2,2) = 3;
+    outputs = convolutional_layer.calculate_outputs(images);
 
-//    convolutional_layer.set({1,6,6}, {3,3,3});
-//    convolutional_layer.set_synaptic_weights(filters);
-//    convolutional_layer.set_biases({-1,0,1});
-//    convolutional_layer.set_activation_function(OpenNN::ConvolutionalLayer::HardSigmoid);
-
-//    outputs = convolutional_layer.calculate_outputs(images);
-
-//    assert_true(outputs(0,0,0,0) == 1.0 &&
-//                outputs(0,0,0,0) == 1.0 &&
-//                outputs(0,0,0,1) == 1.0 &&
-//                outputs(0,0,0,2) == 1.0 &&
-//                outputs(0,0,0,3) == 1.0 &&
-//                outputs(0,0,1,0) == 1.0 &&
-//                outputs(0,0,1,1) == 1.0 &&
-//                outputs(0,0,1,2) == 1.0 &&
-//                outputs(0,0,1,3) == 1.0 &&
-//                outputs(0,0,2,0) == 1.0 &&
-//                outputs(0,0,2,1) == 1.0 &&
-//                outputs(0,0,2,2) == 1.0 &&
-//                outputs(0,0,2,3) == 1.0 &&
-//                outputs(0,0,3,0) == 1.0 &&
-//                outputs(0,0,3,1) == 1.0 &&
-//                outputs(0,0,3,2) == 1.0 &&
-//                outputs(0,0,3,3) == 1.0 &&
-//                outputs(0,1,0,0) == 1.0 &&
-//                outputs(0,1,0,1) == 1.0 &&
-//                outputs(0,1,0,2) == 1.0 &&
-//                outputs(0,1,0,3) == 1.0 &&
-//                outputs(0,1,1,0) == 1.0 &&
-//                outputs(0,1,1,1) == 1.0 &&
-//                outputs(0,1,1,2) == 1.0 &&
-//                outputs(0,1,1,3) == 1.0 &&
-//                outputs(0,1,2,0) == 1.0 &&
-//                outputs(0,1,2,1) == 1.0 &&
-//                outputs(0,1,2,2) == 1.0 &&
-//                outputs(0,1,2,3) == 1.0 &&
-//                outputs(0,1,3,0) == 1.0 &&
-//                outputs(0,1,3,1) == 1.0 &&
-//                outputs(0,1,3,2) == 1.0 &&
-//                outputs(0,1,3,3) == 1.0 &&
-//                outputs(0,2,0,0) == 1.0 &&
-//                outputs(0,2,0,1) == 1.0 &&
-//                outputs(0,2,0,2) == 1.0 &&
-//                outputs(0,2,0,3) == 1.0 &&
-//                outputs(0,2,1,0) == 1.0 &&
-//                outputs(0,2,1,1) == 1.0 &&
-//                outputs(0,2,1,2) == 1.0 &&
-//                outputs(0,2,1,3) == 1.0 &&
-//                outputs(0,2,2,0) == 1.0 &&
-//                outputs(0,2,2,1) == 1.0 &&
-//                outputs(0,2,2,2) == 1.0 &&
-//                outputs(0,2,2,3) == 1.0 &&
-//                outputs(0,2,3,0) == 1.0 &&
-//                outputs(0,2,3,1) == 1.0 &&
-//                outputs(0,2,3,2) == 1.0 &&
-//                outputs(0,2,3,3) == 1.0 &&
-//                outputs(1,0,0,0) == 0.0 &&
-//                outputs(1,0,0,1) == 0.0 &&
-//                outputs(1,0,0,2) == 0.0 &&
-//                outputs(1,0,0,3) == 0.0 &&
-//                outputs(1,0,1,0) == 0.0 &&
-//                outputs(1,0,1,1) == 0.0 &&
-//                outputs(1,0,1,2) == 0.0 &&
-//                outputs(1,0,1,3) == 0.0 &&
-//                outputs(1,0,2,0) == 0.0 &&
-//                outputs(1,0,2,1) == 0.0 &&
-//                outputs(1,0,2,2) == 0.0 &&
-//                outputs(1,0,2,3) == 0.0 &&
-//                outputs(1,0,3,0) == 0.0 &&
-//                outputs(1,0,3,1) == 0.0 &&
-//                outputs(1,0,3,2) == 0.0 &&
-//                outputs(1,0,3,3) == 0.0 &&
-//                outputs(1,1,0,0) == 0.0 &&
-//                outputs(1,1,0,1) == 0.0 &&
-//                outputs(1,1,0,2) == 0.0 &&
-//                outputs(1,1,0,3) == 0.0 &&
-//                outputs(1,1,1,0) == 0.0 &&
-//                outputs(1,1,1,1) == 0.0 &&
-//                outputs(1,1,1,2) == 0.0 &&
-//                outputs(1,1,1,3) == 0.0 &&
-//                outputs(1,1,2,0) == 0.0 &&
-//                outputs(1,1,2,1) == 0.0 &&
-//                outputs(1,1,2,2) == 0.0 &&
-//                outputs(1,1,2,3) == 0.0 &&
-//                outputs(1,1,3,0) == 0.0 &&
-//                outputs(1,1,3,1) == 0.0 &&
-//                outputs(1,1,3,2) == 0.0 &&
-//                outputs(1,1,3,3) == 0.0 &&
-//                outputs(1,2,0,0) == 0.0 &&
-//                outputs(1,2,0,1) == 0.0 &&
-//                outputs(1,2,0,2) == 0.0 &&
-//                outputs(1,2,0,3) == 0.0 &&
-//                outputs(1,2,1,0) == 0.0 &&
-//                outputs(1,2,1,1) == 0.0 &&
-//                outputs(1,2,1,2) == 0.0 &&
-//                outputs(1,2,1,3) == 0.0 &&
-//                outputs(1,2,2,0) == 0.0 &&
-//                outputs(1,2,2,1) == 0.0 &&
-//                outputs(1,2,2,2) == 0.0 &&
-//                outputs(1,2,3,0) == 0.0 &&
-//                outputs(1,2,2,3) == 0.0 &&
-//                outputs(1,2,3,1) == 0.0 &&
-//                outputs(1,2,3,2) == 0.0 &&
-//                outputs(1,2,3,3) == 0.0, LOG);
+    assert_true(outputs.dimension(0) == 2 &&
+                outputs.dimension(1) == 2 &&
+                outputs.dimension(2) == 2 &&
+                outputs.dimension(3) == 2, LOG);
+
+    assert_true(abs(outputs(0,0,0,0) - 0.268941) < 1e-6 &&
+                abs(outputs(0,0,1,1) - 0.268941) < 1e-6 &&
+                abs(outputs(0,1,0,0) - 0.731059) < 1e-6 &&
+                abs(outputs(0,1,1,1) - 0.731059) < 1e-6 &&
+                abs(outputs(1,0,0,1) - 0.268941) < 1e-6 &&
+                abs(outputs(1,1,1,0) - 0.731059) < 1e-6, LOG);
+
+    // Test
+
+    filters.setConstant(1.0);
+    filters.chip(1, 0).setConstant(-1.0);
+    biases.setZero();
+
+    for(Index i = 0; i < 3; i++)
+    {
+        for(Index j = 0; j < 3; j++)
+        {
+            images(1,0,i,j) = static_cast<type>(3*i + j + 1);
+        }
+    }
+
+    convolutional_layer.set_synaptic_weights(filters);
+    convolutional_layer.set_biases(biases);
+    convolutional_layer.set_activation_function(OpenNN::ConvolutionalLayer::Linear);
+
+    outputs = convolutional_layer.calculate_outputs(images);
+
+    assert_true(abs(outputs(0,0,0,0) - 9.2) < 1e-6 &&
+                abs(outputs(0,1,1,1) + 9.2) < 1e-6 &&
+                abs(outputs(1,0,0,0) - (12 + 8.8)) < 1e-6 &&
+                abs(outputs(1,0,0,1) - (16 + 8.8)) < 1e-6 &&
+                abs(outputs(1,0,1,0) - (24 + 8.8)) < 1e-6 &&
+                abs(outputs(1,0,1,1) - (28 + 8.8)) < 1e-6, LOG);
+
+    // Test
+
+    const Tensor<type, 4> nhwc_images = images.shuffle(Eigen::array<Index, 4>({0, 2, 3, 1}));
+
+    convolutional_layer.set_inputs_layout(OpenNN::ConvolutionalLayer::NHWC);
+
+    const Tensor<type, 4> nhwc_outputs = convolutional_layer.calculate_outputs(nhwc_images);
+
+    const Tensor<type, 0> layouts_difference = (nhwc_outputs - outputs).abs().maximum();
+
+    assert_true(layouts_difference(0) < 1e-12, LOG);
+
+    // Test
+
+    convolutional_layer.set_inputs_layout(OpenNN::ConvolutionalLayer::NCHW);
+    convolutional_layer.set_padding_option(OpenNN::ConvolutionalLayer::Same);
+
+    outputs = convolutional_layer.calculate_outputs(images);
+
+    assert_true(outputs.dimension(2) == 3 &&
+                outputs.dimension(3) == 3 &&
+                abs(outputs(1,0,0,0) - (12 + 8.8)) < 1e-6 &&
+                abs(outputs(1,0,2,2) - (9 + 2.2)) < 1e-6, LOG);
+}
+
+
+
+void ConvolutionalLayerTest::test_calculate_error_gradient()
+{
+    cout << "test_calculate_error_gradient\n";
+
+    Tensor<Index, 1> inputs_dimensions(3);
+    inputs_dimensions.setValues({2, 5, 4});
+
+    Tensor<Index, 1> filters_dimensions(3);
+    filters_dimensions.setValues({3, 3, 2});
+
+    ConvolutionalLayer convolutional_layer(inputs_dimensions, filters_dimensions);
+
+    convolutional_layer.set_activation_function(OpenNN::ConvolutionalLayer::HyperbolicTangent);
+    convolutional_layer.set_row_stride(2);
+    convolutional_layer.set_padding_option(OpenNN::ConvolutionalLayer::Same);
+
+    const Index images_number = 3;
+    const Index inputs_number = convolutional_layer.get_inputs_number();
+    const Index neurons_number = convolutional_layer.get_neurons_number();
+    const Index parameters_number = convolutional_layer.get_parameters_number();
+
+    Tensor<type, 2> inputs(images_number, inputs_number);
+    inputs.setRandom();
+
+    // The error is the sum of the outputs weighted by some fixed coefficients
+
+    Tensor<type, 2> coefficients(images_number, neurons_number);
+    coefficients.setRandom();
+
+    Layer::ForwardPropagation forward_propagation(images_number, &convolutional_layer);
+    Layer::BackPropagation back_propagation(images_number, &convolutional_layer);
+
+    convolutional_layer.forward_propagate(inputs, forward_propagation);
+
+    convolutional_layer.calculate_output_delta(forward_propagation, coefficients, back_propagation.delta);
+
+    convolutional_layer.calculate_error_gradient(inputs, forward_propagation, back_propagation);
+
+    Tensor<type, 1> gradient(parameters_number);
+
+    convolutional_layer.insert_gradient(back_propagation, 0, gradient);
+
+    Tensor<type, 2> inputs_delta;
+
+    convolutional_layer.calculate_inputs_delta(back_propagation.delta, inputs_delta);
+
+    // Numerical derivatives
+
+    const type h = static_cast<type>(1.0e-6);
+
+    const Tensor<type, 1> parameters = convolutional_layer.get_parameters();
+
+    Tensor<type, 1> numerical_gradient(parameters_number);
+
+    for(Index i = 0; i < parameters_number; i++)
+    {
+        Tensor<type, 1> parameters_forward = parameters;
+        Tensor<type, 1> parameters_backward = parameters;
+
+        parameters_forward(i) += h;
+        parameters_backward(i) -= h;
+
+        convolutional_layer.set_parameters(parameters_forward, 0);
+        const Tensor<type, 0> error_forward = (convolutional_layer.calculate_outputs(inputs)*coefficients).sum();
+
+        convolutional_layer.set_parameters(parameters_backward, 0);
+        const Tensor<type, 0> error_backward = (convolutional_layer.calculate_outputs(inputs)*coefficients).sum();
+
+        numerical_gradient(i) = (error_forward(0) - error_backward(0))/(static_cast<type>(2.0)*h);
+    }
+
+    convolutional_layer.set_parameters(parameters, 0);
+
+    Tensor<type, 2> numerical_inputs_delta(images_number, inputs_number);
+
+    for(Index i = 0; i < images_number; i++)
+    {
+        for(Index j = 0; j < inputs_number; j++)
+        {
+            Tensor<type, 2> inputs_forward = inputs;
+            Tensor<type, 2> inputs_backward = inputs;
+
+            inputs_forward(i,j) += h;
+            inputs_backward(i,j) -= h;
+
+            const Tensor<type, 0> error_forward = (convolutional_layer.calculate_outputs(inputs_forward)*coefficients).sum();
+            const Tensor<type, 0> error_backward = (convolutional_layer.calculate_outputs(inputs_backward)*coefficients).sum();
+
+            numerical_inputs_delta(i,j) = (error_forward(0) - error_backward(0))/(static_cast<type>(2.0)*h);
+        }
+    }
+
+    const Tensor<type, 0> gradient_difference = (gradient - numerical_gradient).abs().maximum();
+    const Tensor<type, 0> inputs_delta_difference = (inputs_delta - numerical_inputs_delta).abs().maximum();
+
+    assert_true(gradient_difference(0) < 1.0e-6, LOG);
+    assert_true(inputs_delta_difference(0) < 1.0e-6, LOG);
+}
+
+
+void ConvolutionalLayerTest::test_perform_training()
+{
+    cout << "test_perform_training\n";
+
+    const Index images_number = 20;
+    const Index channels_number = 1;
+    const Index rows_number = 6;
+    const Index columns_number = 6;
+    const Index inputs_number = channels_number*rows_number*columns_number;
+
+    // The target of each image is the mean of its pixels
+
+    DataSet data_set(images_number, inputs_number, 1);
+    data_set.set_data_random();
+
+    Tensor<type, 2> data = data_set.get_data();
+
+    for(Index i = 0; i < images_number; i++)
+    {
+        type mean = 0;
+
+        for(Index j = 0; j < inputs_number; j++) mean += data(i,j);
+
+        data(i, inputs_number) = mean/static_cast<type>(inputs_number);
+    }
+
+    data_set.set_data(data);
+    data_set.set_training();
+
+    Tensor<Index, 1> inputs_dimensions(3);
+    inputs_dimensions.setValues({channels_number, rows_number, columns_number});
+
+    data_set.set_input_variables_dimensions(inputs_dimensions);
+
+    Tensor<Index, 1> filters_dimensions(3);
+    filters_dimensions.setValues({2, 3, 3});
+
+    ConvolutionalLayer* convolutional_layer = new ConvolutionalLayer(inputs_dimensions, filters_dimensions);
+
+    convolutional_layer->set_activation_function(OpenNN::ConvolutionalLayer::HyperbolicTangent);
+    convolutional_layer->set_row_stride(2);
+    convolutional_layer->set_column_stride(2);
+    convolutional_layer->set_padding_option(OpenNN::ConvolutionalLayer::Same);
+
+    PerceptronLayer* perceptron_layer = new PerceptronLayer(convolutional_layer->get_neurons_number(), 1, 0, PerceptronLayer::Linear);
+
+    NeuralNetwork neural_network;
+
+    neural_network.add_layer(convolutional_layer);
+    neural_network.add_layer(perceptron_layer);
+
+    neural_network.set_parameters_random();
+
+    TrainingStrategy training_strategy(&neural_network, &data_set);
+
+    training_strategy.set_loss_method(TrainingStrategy::MEAN_SQUARED_ERROR);
+    training_strategy.get_loss_index_pointer()->set_regularization_method(LossIndex::NoRegularization);
+    training_strategy.set_optimization_method(TrainingStrategy::ADAPTIVE_MOMENT_ESTIMATION);
+    training_strategy.get_adaptive_moment_estimation_pointer()->set_batch_instances_number(images_number);
+    training_strategy.set_maximum_epochs_number(50);
+    training_strategy.set_display(false);
+
+    const OptimizationAlgorithm::Results results = training_strategy.perform_training();
+
+    assert_true(results.training_error_history.size() > 1, LOG);
+    assert_true(results.final_training_error < results.training_error_history(0), LOG);
 }
 
 
@@ -1629,6 +1638,16 @@ void ConvolutionalLayerTest::run_test_case() // @todo
    test_calculate_outputs();
    test_insert_padding();
 
+
+   // Back-propagation
+
+   test_calculate_error_gradient();
+
+
+   // Training
+
+   test_perform_training();
+
    cout << "End of convolutional layer test case.\n";
 }
 
@@ -65,6 +65,14 @@ public:
 
   void test_insert_padding();
 
+   // Back-propagation methods
+
+   void test_calculate_error_gradient();
+
+   // Training methods
+
+   void test_perform_training();
+
   // Unit testing methods
 
   void run_test_case();
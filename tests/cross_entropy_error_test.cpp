@@ -25,48 +25,76 @@ void CrossEntropyErrorTest::test_calculate_error()
    DataSet data_set;
 
    NeuralNetwork neural_network;
-   Tensor<type, 1> parameters;
-   Tensor<Index, 1> architecture(2);
-/*
-   PerceptronLayer perceptron_layer;
-   ScalingLayer scaling_layer;
 
    CrossEntropyError cee(&neural_network, &data_set);
 
-   type cross_entropy_error;
+   cee.set_regularization_method(LossIndex::RegularizationMethod::NoRegularization);
 
-   // Test
+   // Test softmax outputs
 
-   data_set.generate_sum_data(10,2);
+   const Index instances_number = 2;
+   const Index inputs_number = 1;
+   const Index outputs_number = 3;
 
-//   Tensor<Descriptives, 1> inputs = data_set.scale_inputs_minimum_maximum();
+   Tensor<type, 2> data(instances_number, inputs_number + outputs_number);
+   data.setValues({{1, 1, 0, 0},
+                   {-1, 0, 0, 1}});
 
-   scaling_layer.set_neurons_number(1);
-   scaling_layer.set_inputs_number(1);
-//   scaling_layer.set_descriptives(inputs);
+   Tensor<DataSet::VariableUse, 1> columns_uses(inputs_number + outputs_number);
+   columns_uses.setValues({DataSet::Input, DataSet::Target, DataSet::Target, DataSet::Target});
 
-//   data_set.set(10,1,1);
+   data_set.set_data(data);
+   data_set.set_columns_uses(columns_uses);
+   data_set.set_training();
 
-//   Tensor<type, 2> data(10,2);
-//   data.initialize_identity();
+   ProbabilisticLayer* probabilistic_layer = new ProbabilisticLayer(inputs_number, outputs_number);
+   probabilistic_layer->set_activation_function(ProbabilisticLayer::Softmax);
 
-//   data_set.set_data(data);
+   neural_network.add_layer(probabilistic_layer);
 
-   data_set.set_training();
+   Tensor<type, 2> biases(1, outputs_number);
+   Tensor<type, 2> synaptic_weights(inputs_number, outputs_number);
+
+   biases.setValues({{0, 1, 2}});
+   synaptic_weights.setValues({{1, -1, 0}});
+
+   probabilistic_layer->set_biases(biases);
+   probabilistic_layer->set_synaptic_weights(synaptic_weights);
+
+   DataSet::Batch batch(instances_number, &data_set);
+
+   Tensor<Index, 1> instances_indices = data_set.get_training_instances_indices();
+   const Tensor<Index, 1> input_indices = data_set.get_input_variables_indices();
+   const Tensor<Index, 1> target_indices = data_set.get_target_variables_indices();
+
+   batch.fill(instances_indices, input_indices, target_indices);
+
+   NeuralNetwork::ForwardPropagation forward_propagation(instances_number, &neural_network);
+   LossIndex::BackPropagation back_propagation(instances_number, &cee);
 
-   architecture.setValues({1,1});
+   neural_network.forward_propagate(batch, forward_propagation);
 
-   neural_network.set(NeuralNetwork::Approximation, architecture);
+   cee.calculate_error(batch, forward_propagation, back_propagation);
 
-   neural_network.set_parameters_constant(0.0);
+   const Tensor<type, 2>& outputs = forward_propagation.layers(0).activations_2d;
 
-   parameters = neural_network.get_parameters();
+   const type error = -log(outputs(0,0)) - log(outputs(1,2));
 
-//   cross_entropy_error = cee.calculate_error();
+   assert_true(abs(back_propagation.error - error) < static_cast<type>(1.0e-6), LOG);
 
-//   assert_true(abs(cross_entropy_error - cee.calculate_training_error(parameters)) < 1.0e-3, LOG);
-*/
+   // Test saturated softmax outputs
 
+   biases.setValues({{0, 1000, -1000}});
+   synaptic_weights.setZero();
+
+   probabilistic_layer->set_biases(biases);
+   probabilistic_layer->set_synaptic_weights(synaptic_weights);
+
+   neural_network.forward_propagate(batch, forward_propagation);
+
+   cee.calculate_error(batch, forward_propagation, back_propagation);
+
+   assert_true(abs(back_propagation.error - static_cast<type>(3000)) < static_cast<type>(1.0e-6), LOG);
 }
 
 
@@ -112,15 +140,57 @@ void CrossEntropyErrorTest::test_calculate_error_gradient()
    Tensor<Index, 1> architecture(3);
    architecture.setValues({inputs_number, hidden_neurons, outputs_number});
 
-//   neural_network.set(NeuralNetwork::Classification, architecture);
+   PerceptronLayer* perceptron_layer = new PerceptronLayer(inputs_number, hidden_neurons);
+   ProbabilisticLayer* probabilistic_layer = new ProbabilisticLayer(hidden_neurons, outputs_number);
+   probabilistic_layer->set_activation_function(ProbabilisticLayer::Softmax);
 
-//   neural_network.set_parameters_random();
+   neural_network.add_layer(perceptron_layer);
+   neural_network.add_layer(probabilistic_layer);
 
-//   error_gradient = cee.calculate_error_gradient();
+   neural_network.set_parameters_random();
 
-//   numerical_error_gradient = cee.calculate_error_gradient_numerical_differentiation();
+   // One-hot targets
 
-//   assert_true(absolute_value(error_gradient - numerical_error_gradient) < 1.0e-3, LOG);
+   Tensor<type, 2> data = data_set.get_data();
+
+   for(Index i = 0; i < instances_number; i++)
+   {
+       for(Index j = 0; j < outputs_number; j++)
+       {
+           data(i, inputs_number + j) = (j == i%outputs_number) ? static_cast<type>(1) : static_cast<type>(0);
+       }
+   }
+
+   Tensor<DataSet::VariableUse, 1> columns_uses = data_set.get_columns_uses();
+
+   data_set.set_data(data);
+   data_set.set_columns_uses(columns_uses);
+   data_set.set_training();
+
+   cee.set_regularization_method(LossIndex::RegularizationMethod::NoRegularization);
+
+   DataSet::Batch batch(instances_number, &data_set);
+
+   Tensor<Index, 1> instances_indices = data_set.get_training_instances_indices();
+   const Tensor<Index, 1> input_indices = data_set.get_input_variables_indices();
+   const Tensor<Index, 1> target_indices = data_set.get_target_variables_indices();
+
+   batch.fill(instances_indices, input_indices, target_indices);
+
+   NeuralNetwork::ForwardPropagation forward_propagation(instances_number, &neural_network);
+   LossIndex::BackPropagation back_propagation(instances_number, &cee);
+
+   neural_network.forward_propagate(batch, forward_propagation);
+
+   cee.back_propagate(batch, forward_propagation, back_propagation);
+
+   error_gradient = back_propagation.gradient;
+
+   numerical_error_gradient = cee.calculate_error_gradient_numerical_differentiation(&cee);
+
+   const Tensor<type, 0> gradient_difference = (error_gradient - numerical_error_gradient).abs().maximum();
+
+   assert_true(gradient_difference(0) < static_cast<type>(1.0e-3), LOG);
 
 }
 
@@ -0,0 +1,422 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   C R O S S   V A L I D A T I O N   T E S T   C L A S S
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#include "cross_validation_test.h"
+
+
+CrossValidationTest::CrossValidationTest() : UnitTesting()
+{
+}
+
+
+CrossValidationTest::~CrossValidationTest()
+{
+}
+
+
+void CrossValidationTest::test_constructor()
+{
+    cout << "test_constructor\n";
+
+    DataSet data_set(10, 2, 1);
+
+    Tensor<Index, 1> architecture(3);
+    architecture.setValues({2, 2, 1});
+
+    NeuralNetwork approximation_neural_network(NeuralNetwork::Approximation, architecture);
+    NeuralNetwork classification_neural_network(NeuralNetwork::Classification, architecture);
+
+    TrainingStrategy approximation_training_strategy(&approximation_neural_network, &data_set);
+    TrainingStrategy classification_training_strategy(&classification_neural_network, &data_set);
+
+    CrossValidation cross_validation_1(&approximation_training_strategy);
+
+    assert_true(cross_validation_1.get_training_strategy_pointer() == &approximation_training_strategy, LOG);
+    assert_true(cross_validation_1.get_partition_method() == CrossValidation::Random, LOG);
+
+    CrossValidation cross_validation_2(&classification_training_strategy);
+
+    assert_true(cross_validation_2.get_partition_method() == CrossValidation::Stratified, LOG);
+
+    CrossValidation cross_validation_3;
+
+    assert_true(cross_validation_3.get_training_strategy_pointer() == nullptr, LOG);
+    assert_true(cross_validation_3.get_folds_number() == 5, LOG);
+}
+
+
+void CrossValidationTest::test_destructor()
+{
+    cout << "test_destructor\n";
+
+    CrossValidation* cross_validation = new CrossValidation;
+
+    delete cross_validation;
+}
+
+
+void CrossValidationTest::test_set_default()
+{
+    cout << "test_set_default\n";
+
+    CrossValidation cross_validation;
+
+    cross_validation.set_folds_number(3);
+    cross_validation.set_partition_method("Blocked");
+    cross_validation.set_selection_instances_ratio(static_cast<type>(0.2));
+    cross_validation.set_workers_number(3);
+
+    assert_true(cross_validation.get_partition_method() == CrossValidation::Blocked, LOG);
+    assert_true(cross_validation.write_partition_method() == "Blocked", LOG);
+
+    cross_validation.set_default();
+
+    assert_true(cross_validation.get_folds_number() == 5, LOG);
+    assert_true(cross_validation.get_partition_method() == CrossValidation::Random, LOG);
+    assert_true(abs(cross_validation.get_selection_instances_ratio()) < numeric_limits<type>::min(), LOG);
+    assert_true(cross_validation.get_workers_number() == omp_get_max_threads(), LOG);
+    assert_true(cross_validation.get_worker_threads_number() == 1, LOG);
+
+    // Wrong values
+
+    try
+    {
+        cross_validation.set_folds_number(1);
+
+        assert_true(false, LOG);
+    }
+    catch(const logic_error&)
+    {
+        assert_true(true, LOG);
+    }
+
+    try
+    {
+        cross_validation.set_partition_method("Shuffled");
+
+        assert_true(false, LOG);
+    }
+    catch(const logic_error&)
+    {
+        assert_true(true, LOG);
+    }
+}
+
+
+void CrossValidationTest::test_calculate_folds()
+{
+    cout << "test_calculate_folds\n";
+
+    // Random
+
+    DataSet data_set(23, 2, 1);
+    data_set.set_data_random();
+    data_set.set_instance_use(0, DataSet::UnusedInstance);
+
+    const Tensor<DataSet::InstanceUse, 1> instances_uses = data_set.get_instances_uses();
+
+    Tensor<Index, 1> architecture(3);
+    architecture.setValues({2, 2, 1});
+
+    NeuralNetwork neural_network(NeuralNetwork::Approximation, architecture);
+
+    TrainingStrategy training_strategy(&neural_network, &data_set);
+
+    CrossValidation cross_validation(&training_strategy);
+
+    cross_validation.set_folds_number(5);
+
+    Tensor<Tensor<Index, 1>, 1> folds = cross_validation.calculate_folds();
+
+    Tensor<Index, 1> counts(23);
+    counts.setZero();
+
+    assert_true(folds.size() == 5, LOG);
+
+    for(Index i = 0; i < folds.size(); i++)
+    {
+        assert_true(folds(i).size() == 4 || folds(i).size() == 5, LOG);
+
+        for(Index j = 0; j < folds(i).size(); j++) counts(folds(i)(j))++;
+    }
+
+    assert_true(counts(0) == 0, LOG);
+
+    for(Index i = 1; i < 23; i++) assert_true(counts(i) == 1, LOG);
+
+    // Blocked
+
+    cross_validation.set_partition_method(CrossValidation::Blocked);
+
+    folds = cross_validation.calculate_folds();
+
+    assert_true(folds(0)(0) == 1, LOG);
+
+    for(Index i = 0; i < folds.size(); i++)
+    {
+        for(Index j = 1; j < folds(i).size(); j++) assert_true(folds(i)(j) == folds(i)(j-1) + 1, LOG);
+
+        if(i != 0) assert_true(folds(i)(0) == folds(i-1)(folds(i-1).size()-1) + 1, LOG);
+    }
+
+    // Stratified classification
+
+    Tensor<type, 2> data(30, 3);
+    data.setRandom();
+
+    for(Index i = 0; i < 30; i++) data(i, 2) = i < 9 ? 1 : 0;
+
+    DataSet classification_data_set;
+    classification_data_set.set_data(data);
+
+    NeuralNetwork classification_neural_network(NeuralNetwork::Classification, architecture);
+
+    TrainingStrategy classification_training_strategy(&classification_neural_network, &classification_data_set);
+
+    CrossValidation classification_cross_validation(&classification_training_strategy);
+
+    classification_cross_validation.set_folds_number(3);
+
+    folds = classification_cross_validation.calculate_folds();
+
+    for(Index i = 0; i < folds.size(); i++)
+    {
+        Index positives_number = 0;
+
+        for(Index j = 0; j < folds(i).size(); j++) if(data(folds(i)(j), 2) > 0.5) positives_number++;
+
+        assert_true(folds(i).size() == 10, LOG);
+        assert_true(positives_number == 3, LOG);
+    }
+
+    // Instances uses are not modified
+
+    const Tensor<bool, 0> unchanged = (data_set.get_instances_uses() == instances_uses).all();
+
+    assert_true(unchanged(), LOG);
+
+    // Too many folds
+
+    cross_validation.set_folds_number(30);
+
+    try
+    {
+        folds = cross_validation.calculate_folds();
+
+        assert_true(false, LOG);
+    }
+    catch(const logic_error&)
+    {
+        assert_true(true, LOG);
+    }
+}
+
+
+void CrossValidationTest::test_calculate_fold_instances_uses()
+{
+    cout << "test_calculate_fold_instances_uses\n";
+
+    DataSet data_set(21, 2, 1);
+    data_set.set_data_random();
+    data_set.set_instance_use(20, DataSet::UnusedInstance);
+
+    Tensor<Index, 1> architecture(3);
+    architecture.setValues({2, 2, 1});
+
+    NeuralNetwork neural_network(NeuralNetwork::Approximation, architecture);
+
+    TrainingStrategy training_strategy(&neural_network, &data_set);
+
+    CrossValidation cross_validation(&training_strategy);
+
+    cross_validation.set_folds_number(4);
+    cross_validation.set_partition_method(CrossValidation::Blocked);
+    cross_validation.set_selection_instances_ratio(static_cast<type>(0.2));
+
+    const Tensor<Tensor<Index, 1>, 1> folds = cross_validation.calculate_folds();
+
+    const Tensor<DataSet::InstanceUse, 1> instances_uses = cross_validation.calculate_fold_instances_uses(folds, 1);
+
+    Index training_number = 0;
+    Index selection_number = 0;
+    Index testing_number = 0;
+
+    for(Index i = 0; i < instances_uses.size(); i++)
+    {
+        if(instances_uses(i) == DataSet::Training) training_number++;
+        else if(instances_uses(i) == DataSet::Selection) selection_number++;
+        else if(instances_uses(i) == DataSet::Testing) testing_number++;
+    }
+
+    assert_true(instances_uses(20) == DataSet::UnusedInstance, LOG);
+    assert_true(testing_number == 5, LOG);
+    assert_true(selection_number == 3, LOG);
+    assert_true(training_number == 12, LOG);
+
+    // The selection instances of blocked partitions are the last ones
+
+    assert_true(instances_uses(19) == DataSet::Selection, LOG);
+    assert_true(instances_uses(folds(1)(0)) == DataSet::Testing, LOG);
+    assert_true(instances_uses(0) == DataSet::Training, LOG);
+}
+
+
+void CrossValidationTest::test_perform_cross_validation()
+{
+    cout << "test_perform_cross_validation\n";
+
+    // Approximation
+
+    DataSet data_set(30, 2, 1);
+    data_set.set_data_random();
+    data_set.split_instances_random();
+
+    const Tensor<DataSet::InstanceUse, 1> instances_uses = data_set.get_instances_uses();
+
+    Tensor<Index, 1> architecture(3);
+    architecture.setValues({2, 2, 1});
+
+    NeuralNetwork neural_network(NeuralNetwork::Approximation, architecture);
+
+    const Tensor<type, 1> parameters = neural_network.get_parameters();
+
+    TrainingStrategy training_strategy(&neural_network, &data_set);
+    training_strategy.set_loss_method(TrainingStrategy::SUM_SQUARED_ERROR);
+    training_strategy.set_optimization_method(TrainingStrategy::QUASI_NEWTON_METHOD);
+    training_strategy.set_maximum_epochs_number(5);
+    training_strategy.set_display(false);
+
+    CrossValidation cross_validation(&training_strategy);
+
+    cross_validation.set_folds_number(3);
+    cross_validation.set_workers_number(2);
+    cross_validation.set_display(false);
+
+    CrossValidation::Results results = cross_validation.perform_cross_validation();
+
+    assert_true(results.folds.size() == 3, LOG);
+    assert_true(results.testing_errors_mean.size() == 4, LOG);
+    assert_true(results.testing_errors_standard_deviation.size() == 4, LOG);
+    assert_true(results.confusion.size() == 0, LOG);
+    assert_true(isnan(results.accuracy_mean), LOG);
+    assert_true(results.elapsed_time >= 0, LOG);
+
+    type mean_squared_error_sum = 0;
+
+    for(Index i = 0; i < 3; i++)
+    {
+        assert_true(results.folds(i).fold_index == i, LOG);
+        assert_true(results.folds(i).testing_instances_indices.size() == 10, LOG);
+        assert_true(results.folds(i).parameters.size() == parameters.size(), LOG);
+        assert_true(results.folds(i).training_results.epochs_number <= 5, LOG);
+
+        mean_squared_error_sum += results.folds(i).testing_errors(1);
+    }
+
+    assert_true(abs(results.testing_errors_mean(1) - mean_squared_error_sum/3) < static_cast<type>(1e-6), LOG);
+
+    // Originals
+
+    const Tensor<bool, 0> unchanged_parameters = (neural_network.get_parameters() == parameters).all();
+    const Tensor<bool, 0> unchanged_uses = (data_set.get_instances_uses() == instances_uses).all();
+
+    assert_true(unchanged_parameters(), LOG);
+    assert_true(unchanged_uses(), LOG);
+
+    // Workers made again with more folds and the current training strategy
+
+    training_strategy.set_maximum_epochs_number(3);
+
+    cross_validation.set_folds_number(5);
+    cross_validation.set_workers_number(4);
+
+    results = cross_validation.perform_cross_validation();
+
+    assert_true(results.folds.size() == 5, LOG);
+
+    for(Index i = 0; i < 5; i++)
+    {
+        assert_true(results.folds(i).testing_instances_indices.size() == 6, LOG);
+        assert_true(results.folds(i).training_results.epochs_number <= 3, LOG);
+    }
+
+    // Classification
+
+    Tensor<type, 2> data(30, 3);
+    data.setRandom();
+
+    for(Index i = 0; i < 30; i++) data(i, 2) = data(i, 0) > 0 ? 1 : 0;
+
+    DataSet classification_data_set;
+    classification_data_set.set_data(data);
+
+    NeuralNetwork classification_neural_network(NeuralNetwork::Classification, architecture);
+
+    TrainingStrategy classification_training_strategy(&classification_neural_network, &classification_data_set);
+    classification_training_strategy.set_loss_method(TrainingStrategy::SUM_SQUARED_ERROR);
+    classification_training_strategy.set_optimization_method(TrainingStrategy::QUASI_NEWTON_METHOD);
+    classification_training_strategy.set_maximum_epochs_number(5);
+    classification_training_strategy.set_display(false);
+
+    CrossValidation classification_cross_validation(&classification_training_strategy);
+
+    classification_cross_validation.set_folds_number(3);
+    classification_cross_validation.set_display(false);
+
+    results = classification_cross_validation.perform_cross_validation();
+
+    const Tensor<Index, 0> confusion_sum = results.confusion.sum();
+
+    assert_true(confusion_sum(0) == 30, LOG);
+    assert_true(results.accuracy_mean >= 0 && results.accuracy_mean <= 1, LOG);
+    assert_true(results.accuracy_standard_deviation >= 0, LOG);
+}
+
+
+void CrossValidationTest::run_test_case()
+{
+    cout << "Running cross validation test case...\n";
+
+    // Constructor and destructor methods
+
+    test_constructor();
+    test_destructor();
+
+    // Set methods
+
+    test_set_default();
+
+    // Partition methods
+
+    test_calculate_folds();
+    test_calculate_fold_instances_uses();
+
+    // Cross-validation methods
+
+    test_perform_cross_validation();
+
+    cout << "End of cross validation test case.\n";
+}
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
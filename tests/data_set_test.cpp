@@ -1730,6 +1730,85 @@ void DataSetTest::test_from_XML()
 }
 
 
+void DataSetTest::test_sparse_inputs()
+{
+   cout << "test_sparse_inputs\n";
+
+   DataSet data_set;
+
+   Tensor<type, 2> data(5, 6);
+   data.setValues({{0, 1, 0, 0, 1, 2},
+                   {2, 0, 0, 3, 3, 4},
+                   {0, 0, 0, 0, 5, 6},
+                   {4, 0, 5, 0, 7, 8},
+                   {0, 6, 0, 7, 9, 1}});
+
+   data_set.set_data(data);
+
+   data_set.set_column_use(4, DataSet::Target);
+   data_set.set_column_use(5, DataSet::Target);
+
+   data_set.set_sparse_inputs(true);
+
+   // Batch
+
+   Tensor<Index, 1> instances_indices(3);
+   instances_indices.setValues({4, 1, 3});
+
+   const Tensor<Index, 1> inputs_indices = data_set.get_input_variables_indices();
+   const Tensor<Index, 1> targets_indices = data_set.get_target_variables_indices();
+
+   DataSet::Batch batch(3, &data_set);
+
+   batch.fill(instances_indices, inputs_indices, targets_indices);
+
+   assert_true(batch.sparse_inputs, LOG);
+   assert_true(batch.inputs_csr.rows() == 3, LOG);
+   assert_true(batch.inputs_csr.cols() == 4, LOG);
+   assert_true(batch.inputs_csr.nonZeros() == 6, LOG);
+
+   for(Index i = 0; i < 3; i++)
+   {
+       for(Index j = 0; j < 4; j++)
+       {
+           assert_true(batch.inputs_csr.coeff(i, j) == batch.inputs_2d(i, j), LOG);
+       }
+   }
+
+   // Serialization
+
+   data_set.set_variables_descriptives();
+
+   tinyxml2::XMLPrinter printer;
+
+   data_set.write_XML(printer);
+
+   tinyxml2::XMLDocument document;
+
+   document.Parse(printer.CStr());
+
+   DataSet data_set_2;
+
+   data_set_2.from_XML(document);
+
+   assert_true(data_set_2.get_sparse_inputs(), LOG);
+
+   data_set.set_sparse_inputs(false);
+
+   tinyxml2::XMLPrinter dense_printer;
+
+   data_set.write_XML(dense_printer);
+
+   tinyxml2::XMLDocument dense_document;
+
+   dense_document.Parse(dense_printer.CStr());
+
+   data_set_2.from_XML(dense_document);
+
+   assert_true(!data_set_2.get_sparse_inputs(), LOG);
+}
+
+
 void DataSetTest::test_read_csv() 
 {
    cout << "test_read_csv\n";
@@ -3092,6 +3171,7 @@ void DataSetTest::run_test_case()
 
    test_to_XML();
    test_from_XML();
+   test_sparse_inputs();
    test_read_csv();
    test_read_adult_csv();
    test_read_airline_passengers_csv();
@@ -186,6 +186,7 @@ public:
 
    void test_to_XML();
    void test_from_XML();
+   void test_sparse_inputs();
    void test_print();
    void test_read_csv();
    void test_read_adult_csv();
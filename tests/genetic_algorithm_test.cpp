@@ -304,17 +304,13 @@ void GeneticAlgorithmTest::test_perform_mutation()
     GeneticAlgorithm ga(&ts);
 
     Tensor<bool, 2> population(4,1);
-    Tensor<bool, 1> individual(1);
 
     Tensor<bool, 2> mutated_population;
 
-//    individual[0] = 1;
-//    population[0] = individual;
-//    population[1] = individual;
-
-//    individual[0] = 0;
-//    population[2] = individual;
-//    population[3] = individual;
+    population(0,0) = true;
+    population(1,0) = true;
+    population(2,0) = false;
+    population(3,0) = false;
 
     ga.set_population_size(4);
 
@@ -326,10 +322,10 @@ void GeneticAlgorithmTest::test_perform_mutation()
 
     mutated_population = ga.get_population();
 
-//    assert_true(mutated_population[0][0] == 1, LOG);
-//    assert_true(mutated_population[1][0] == 1, LOG);
-//    assert_true(mutated_population[2][0] == 1, LOG);
-//    assert_true(mutated_population[3][0] == 1, LOG);
+    assert_true(mutated_population(0,0) == false, LOG);
+    assert_true(mutated_population(1,0) == false, LOG);
+    assert_true(mutated_population(2,0) == true, LOG);
+    assert_true(mutated_population(3,0) == true, LOG);
 
     ga.set_population(population);
 
@@ -339,11 +335,70 @@ void GeneticAlgorithmTest::test_perform_mutation()
 
     mutated_population = ga.get_population();
 
-//    assert_true(mutated_population[0][0] == 1, LOG);
-//    assert_true(mutated_population[1][0] == 1, LOG);
-//    assert_true(mutated_population[2][0] == 0, LOG);
-//    assert_true(mutated_population[3][0] == 0, LOG);
+    assert_true(mutated_population(0,0) == true, LOG);
+    assert_true(mutated_population(1,0) == true, LOG);
+    assert_true(mutated_population(2,0) == false, LOG);
+    assert_true(mutated_population(3,0) == false, LOG);
+
+    // Test
+
+    population.resize(4,150);
+    population.setConstant(false);
+
+    ga.set_population(population);
+
+    ga.set_mutation_rate(static_cast<type>(0.5));
+
+    ga.perform_mutation();
+
+    Index mutations_number = 0;
+
+    for(Index i = 0; i < 4; i++)
+    {
+        mutations_number += ga.count_active_genes(i);
+    }
 
+    assert_true(mutations_number > 200 && mutations_number < 400, LOG);
+}
+
+
+void GeneticAlgorithmTest::test_calculate_Hamming_distance()
+{
+    cout << "test_calculate_Hamming_distance\n";
+
+    GeneticAlgorithm ga;
+
+    Tensor<bool, 2> population(4,100);
+    population.setConstant(false);
+
+    population(1,0) = true;
+    population(1,70) = true;
+    population(1,99) = true;
+
+    population(2,70) = true;
+
+    population.chip(3,0).setConstant(true);
+
+    ga.set_population_size(4);
+
+    ga.set_population(population);
+
+    assert_true(ga.get_genes_number() == 100, LOG);
+
+    assert_true(ga.calculate_Hamming_distance(0,0) == 0, LOG);
+    assert_true(ga.calculate_Hamming_distance(0,1) == 3, LOG);
+    assert_true(ga.calculate_Hamming_distance(1,2) == 2, LOG);
+    assert_true(ga.calculate_Hamming_distance(0,3) == 100, LOG);
+
+    assert_true(ga.count_active_genes(3) == 100, LOG);
+
+    const Tensor<bool, 2> unpacked_population = ga.get_population();
+
+    assert_true(unpacked_population.dimension(0) == 4, LOG);
+    assert_true(unpacked_population.dimension(1) == 100, LOG);
+    assert_true(unpacked_population(1,70) == true, LOG);
+    assert_true(unpacked_population(1,71) == false, LOG);
+    assert_true(unpacked_population(3,99) == true, LOG);
 }
 
 
@@ -511,6 +566,10 @@ void GeneticAlgorithmTest::run_test_case()
 
     test_perform_mutation();
 
+    // Utilities
+
+    test_calculate_Hamming_distance();
+
     // Order selection methods
 
     test_perform_inputs_selection();
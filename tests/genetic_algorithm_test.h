@@ -57,6 +57,10 @@ public:
 
    void test_perform_mutation();
 
+   // Utilities
+
+   void test_calculate_Hamming_distance();
+
    // Inputs selection methods
 
    void test_perform_inputs_selection();
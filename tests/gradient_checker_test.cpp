@@ -0,0 +1,395 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   G R A D I E N T   C H E C K E R   T E S T   C L A S S
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#include "gradient_checker_test.h"
+
+
+/// Sum squared error whose output gradient is doubled, to test that wrong gradients are detected.
+
+class WrongSumSquaredError : public SumSquaredError
+{
+
+public:
+
+   explicit WrongSumSquaredError(NeuralNetwork* new_neural_network_pointer, DataSet* new_data_set_pointer)
+       : SumSquaredError(new_neural_network_pointer, new_data_set_pointer)
+   {
+   }
+
+   void calculate_output_gradient(const DataSet::Batch& batch,
+                                  const NeuralNetwork::ForwardPropagation& forward_propagation,
+                                  BackPropagation& back_propagation) const
+   {
+       SumSquaredError::calculate_output_gradient(batch, forward_propagation, back_propagation);
+
+       back_propagation.output_gradient = back_propagation.output_gradient*static_cast<type>(2);
+   }
+};
+
+
+/// Sets random data with 3 inputs and 1 target to a data set.
+
+static void set_random_data(DataSet& data_set, const Index& instances_number)
+{
+    Tensor<type, 2> data(instances_number, 4);
+    data.setRandom();
+
+    data_set.set_display(false);
+    data_set.set_data(data);
+}
+
+
+GradientCheckerTest::GradientCheckerTest() : UnitTesting()
+{
+}
+
+
+GradientCheckerTest::~GradientCheckerTest()
+{
+}
+
+
+void GradientCheckerTest::test_constructor()
+{
+    cout << "test_constructor\n";
+
+    SumSquaredError sum_squared_error;
+
+    GradientChecker gradient_checker_1(&sum_squared_error);
+
+    assert_true(gradient_checker_1.get_loss_index_pointer() == &sum_squared_error, LOG);
+
+    GradientChecker gradient_checker_2;
+
+    assert_true(gradient_checker_2.get_loss_index_pointer() == nullptr, LOG);
+}
+
+
+void GradientCheckerTest::test_destructor()
+{
+    cout << "test_destructor\n";
+
+    GradientChecker* gradient_checker = new GradientChecker;
+
+    delete gradient_checker;
+}
+
+
+void GradientCheckerTest::test_set_default()
+{
+    cout << "test_set_default\n";
+
+    GradientChecker gradient_checker;
+
+    gradient_checker.set_check_method("RandomDirections");
+    gradient_checker.set_random_parameters_number(3);
+    gradient_checker.set_workers_number(5);
+
+    assert_true(gradient_checker.get_check_method() == GradientChecker::RandomDirections, LOG);
+
+    gradient_checker.set_default();
+
+    assert_true(gradient_checker.write_check_method() == "AllParameters", LOG);
+    assert_true(gradient_checker.get_random_parameters_number() == 10, LOG);
+    assert_true(gradient_checker.get_random_directions_number() == 1, LOG);
+    assert_true(gradient_checker.get_workers_number() == omp_get_max_threads(), LOG);
+
+    // Wrong values
+
+    try
+    {
+        gradient_checker.set_check_method("Complex");
+
+        assert_true(false, LOG);
+    }
+    catch(const logic_error&)
+    {
+        assert_true(true, LOG);
+    }
+
+    try
+    {
+        gradient_checker.set_tolerance(-1);
+
+        assert_true(false, LOG);
+    }
+    catch(const logic_error&)
+    {
+        assert_true(true, LOG);
+    }
+
+    // Missing loss index
+
+    try
+    {
+        gradient_checker.perform_gradient_check();
+
+        assert_true(false, LOG);
+    }
+    catch(const logic_error&)
+    {
+        assert_true(true, LOG);
+    }
+}
+
+
+void GradientCheckerTest::test_calculate_numerical_gradient()
+{
+    cout << "test_calculate_numerical_gradient\n";
+
+    DataSet data_set;
+
+    set_random_data(data_set, 12);
+
+    Tensor<Index, 1> architecture(3);
+    architecture.setValues({3, 4, 1});
+
+    NeuralNetwork neural_network(NeuralNetwork::Approximation, architecture);
+    neural_network.set_parameters_random();
+
+    SumSquaredError sum_squared_error(&neural_network, &data_set);
+
+    const Index parameters_number = neural_network.get_parameters_number();
+
+    // Serial central differences
+
+    const Index instances_number = data_set.get_training_instances_number();
+
+    DataSet::Batch batch(instances_number, &data_set);
+
+    Tensor<Index, 1> instances_indices = data_set.get_training_instances_indices();
+    const Tensor<Index, 1> input_indices = data_set.get_input_variables_indices();
+    const Tensor<Index, 1> target_indices = data_set.get_target_variables_indices();
+
+    batch.fill(instances_indices, input_indices, target_indices);
+
+    NeuralNetwork::ForwardPropagation forward_propagation(instances_number, &neural_network);
+    LossIndex::BackPropagation back_propagation(instances_number, &sum_squared_error);
+
+    const Tensor<type, 1> parameters = neural_network.get_parameters();
+
+    Tensor<type, 1> perturbed_parameters(parameters);
+
+    Tensor<type, 1> serial_gradient(parameters_number);
+
+    for(Index i = 0; i < parameters_number; i++)
+    {
+        const type h = sum_squared_error.calculate_h(parameters(i));
+
+        perturbed_parameters(i) = parameters(i) + h;
+        neural_network.forward_propagate(batch, perturbed_parameters, forward_propagation);
+        sum_squared_error.calculate_error(batch, forward_propagation, back_propagation);
+        const type error_forward = back_propagation.error;
+
+        perturbed_parameters(i) = parameters(i) - h;
+        neural_network.forward_propagate(batch, perturbed_parameters, forward_propagation);
+        sum_squared_error.calculate_error(batch, forward_propagation, back_propagation);
+        const type error_backward = back_propagation.error;
+
+        perturbed_parameters(i) = parameters(i);
+
+        serial_gradient(i) = (error_forward - error_backward)/(static_cast<type>(2)*h);
+    }
+
+    // Parallel central differences give the same derivatives with any number of workers
+
+    GradientChecker gradient_checker(&sum_squared_error);
+
+    gradient_checker.set_workers_number(1);
+
+    const Tensor<type, 1> gradient_1 = gradient_checker.calculate_numerical_gradient();
+
+    gradient_checker.set_workers_number(3);
+
+    const Tensor<type, 1> gradient_3 = gradient_checker.calculate_numerical_gradient();
+
+    const Tensor<type, 0> difference_1 = (gradient_1 - serial_gradient).abs().maximum();
+    const Tensor<type, 0> difference_3 = (gradient_3 - serial_gradient).abs().maximum();
+
+    assert_true(gradient_1.size() == parameters_number, LOG);
+    assert_true(difference_1(0) < numeric_limits<type>::min(), LOG);
+    assert_true(difference_3(0) < numeric_limits<type>::min(), LOG);
+
+    // The parameters of the neural network are not modified
+
+    const Tensor<type, 0> parameters_difference = (neural_network.get_parameters() - parameters).abs().maximum();
+
+    assert_true(parameters_difference(0) < numeric_limits<type>::min(), LOG);
+
+    // Numerical differentiation of the loss index
+
+    const Tensor<type, 1> loss_index_gradient = sum_squared_error.calculate_error_gradient_numerical_differentiation(&sum_squared_error);
+
+    const Tensor<type, 0> loss_index_difference = (loss_index_gradient - serial_gradient).abs().maximum();
+
+    assert_true(loss_index_difference(0) < numeric_limits<type>::min(), LOG);
+}
+
+
+void GradientCheckerTest::test_perform_gradient_check()
+{
+    cout << "test_perform_gradient_check\n";
+
+    DataSet data_set;
+
+    set_random_data(data_set, 20);
+
+    Tensor<Index, 1> architecture(4);
+    architecture.setValues({3, 6, 5, 1});
+
+    NeuralNetwork neural_network(NeuralNetwork::Approximation, architecture);
+    neural_network.set_parameters_random();
+
+    const Index parameters_number = neural_network.get_parameters_number();
+
+    const Index trainable_layers_number = neural_network.get_trainable_layers_number();
+
+    const Tensor<Index, 1> trainable_layers_parameters_numbers = neural_network.get_trainable_layers_parameters_numbers();
+
+    NormalizedSquaredError normalized_squared_error(&neural_network, &data_set);
+
+    GradientChecker gradient_checker(&normalized_squared_error);
+
+    gradient_checker.set_workers_number(3);
+    gradient_checker.set_display(false);
+
+    // All parameters
+
+    GradientChecker::Results results = gradient_checker.perform_gradient_check();
+
+    assert_true(results.passed, LOG);
+    assert_true(results.gradient.size() == parameters_number, LOG);
+    assert_true(results.relative_errors.size() == parameters_number, LOG);
+    assert_true(results.error_evaluations_number == 2*parameters_number, LOG);
+    assert_true(results.layers_names.size() == trainable_layers_number, LOG);
+    assert_true(results.layers_maximum_relative_errors.size() == trainable_layers_number, LOG);
+    assert_true(results.maximum_relative_error <= gradient_checker.get_tolerance(), LOG);
+    assert_true(results.parameters_indices(parameters_number-1) == parameters_number-1, LOG);
+    assert_true(results.layers_indices(parameters_number-1) == trainable_layers_number-1, LOG);
+
+    // Random parameters
+
+    gradient_checker.set_check_method(GradientChecker::RandomParameters);
+    gradient_checker.set_random_parameters_number(4);
+
+    results = gradient_checker.perform_gradient_check();
+
+    Index expected_checks_number = 0;
+
+    for(Index i = 0; i < trainable_layers_number; i++)
+    {
+        expected_checks_number += min(trainable_layers_parameters_numbers(i), static_cast<Index>(4));
+    }
+
+    assert_true(results.passed, LOG);
+    assert_true(results.relative_errors.size() == expected_checks_number, LOG);
+    assert_true(results.error_evaluations_number == 2*expected_checks_number, LOG);
+
+    for(Index i = 0; i < results.parameters_indices.size(); i++)
+    {
+        assert_true(abs(results.analytical_derivatives(i) - results.gradient(results.parameters_indices(i))) < numeric_limits<type>::min(), LOG);
+    }
+
+    // Random directions take two evaluations per direction
+
+    gradient_checker.set_check_method(GradientChecker::RandomDirections);
+    gradient_checker.set_random_directions_number(2);
+
+    results = gradient_checker.perform_gradient_check();
+
+    assert_true(results.passed, LOG);
+    assert_true(results.relative_errors.size() == 2*trainable_layers_number, LOG);
+    assert_true(results.error_evaluations_number == 4*trainable_layers_number, LOG);
+    assert_true(results.parameters_indices(0) == -1, LOG);
+
+    for(Index i = 0; i < trainable_layers_number; i++)
+    {
+        assert_true(results.layers_maximum_relative_errors(i) <= gradient_checker.get_tolerance(), LOG);
+    }
+}
+
+
+void GradientCheckerTest::test_perform_gradient_check_wrong_gradient()
+{
+    cout << "test_perform_gradient_check_wrong_gradient\n";
+
+    DataSet data_set;
+
+    set_random_data(data_set, 15);
+
+    Tensor<Index, 1> architecture(3);
+    architecture.setValues({3, 4, 1});
+
+    NeuralNetwork neural_network(NeuralNetwork::Approximation, architecture);
+    neural_network.set_parameters_random();
+
+    WrongSumSquaredError wrong_sum_squared_error(&neural_network, &data_set);
+
+    GradientChecker gradient_checker(&wrong_sum_squared_error);
+
+    gradient_checker.set_display(false);
+
+    // The analytical derivatives are twice the numerical ones, so their relative error is 0.5
+
+    const GradientChecker::Results all_parameters_results = gradient_checker.perform_gradient_check();
+
+    assert_true(!all_parameters_results.passed, LOG);
+    assert_true(all_parameters_results.maximum_relative_error > static_cast<type>(0.4), LOG);
+
+    gradient_checker.set_check_method(GradientChecker::RandomDirections);
+
+    const GradientChecker::Results directions_results = gradient_checker.perform_gradient_check();
+
+    assert_true(!directions_results.passed, LOG);
+
+    for(Index i = 0; i < directions_results.layers_maximum_relative_errors.size(); i++)
+    {
+        assert_true(directions_results.layers_maximum_relative_errors(i) > static_cast<type>(0.4), LOG);
+    }
+}
+
+
+void GradientCheckerTest::run_test_case()
+{
+    cout << "Running gradient checker test case...\n";
+
+    // Constructor and destructor methods
+
+    test_constructor();
+    test_destructor();
+
+    // Set methods
+
+    test_set_default();
+
+    // Checking methods
+
+    test_calculate_numerical_gradient();
+    test_perform_gradient_check();
+    test_perform_gradient_check_wrong_gradient();
+
+    cout << "End of gradient checker test case.\n\n";
+}
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
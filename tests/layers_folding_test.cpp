@@ -0,0 +1,479 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   L A Y E R S   F O L D I N G   T E S T   C L A S S
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#include "layers_folding_test.h"
+
+
+LayersFoldingTest::LayersFoldingTest() : UnitTesting()
+{
+}
+
+
+LayersFoldingTest::~LayersFoldingTest()
+{
+}
+
+
+void LayersFoldingTest::test_constructor()
+{
+    cout << "test_constructor\n";
+
+    // Default constructor
+
+    LayersFolding layers_folding_1;
+
+    assert_true(!layers_folding_1.has_neural_network(), LOG);
+    assert_true(abs(layers_folding_1.get_pruning_tolerance()) < numeric_limits<type>::min(), LOG);
+
+    // Neural network constructor
+
+    NeuralNetwork neural_network;
+
+    LayersFolding layers_folding_2(&neural_network);
+
+    assert_true(layers_folding_2.get_neural_network_pointer() == &neural_network, LOG);
+}
+
+
+void LayersFoldingTest::test_fold_scaling_layer()
+{
+    cout << "test_fold_scaling_layer\n";
+
+    NeuralNetwork neural_network;
+
+    ScalingLayer* scaling_layer_pointer = new ScalingLayer(5);
+
+    Tensor<Descriptives, 1> descriptives(5);
+    descriptives(0) = Descriptives(-1, 3, 1, 2);
+    descriptives(1) = Descriptives(2, 10, 5, 3);
+    descriptives(2) = Descriptives(-4, 4, static_cast<type>(0.5), static_cast<type>(1.5));
+    descriptives(3) = Descriptives(0, 20, 8, 4);
+    descriptives(4) = Descriptives(3, 3, 3, 0);
+
+    Tensor<ScalingLayer::ScalingMethod, 1> scaling_methods(5);
+    scaling_methods.setValues({ScalingLayer::NoScaling, ScalingLayer::MinimumMaximum,
+                               ScalingLayer::MeanStandardDeviation, ScalingLayer::StandardDeviation,
+                               ScalingLayer::MinimumMaximum});
+
+    scaling_layer_pointer->set_descriptives(descriptives);
+    scaling_layer_pointer->set_scaling_methods(scaling_methods);
+    scaling_layer_pointer->set_display(false);
+
+    PerceptronLayer* perceptron_layer_pointer = new PerceptronLayer(5, 3);
+
+    perceptron_layer_pointer->set_parameters_random();
+
+    neural_network.add_layer(scaling_layer_pointer);
+    neural_network.add_layer(perceptron_layer_pointer);
+
+    LayersFolding layers_folding(&neural_network);
+
+    NeuralNetwork folded_neural_network;
+
+    layers_folding.fold(folded_neural_network);
+
+    assert_true(folded_neural_network.get_layers_number() == 1, LOG);
+    assert_true(folded_neural_network.get_layers_pointers()(0)->get_type() == Layer::Perceptron, LOG);
+    assert_true(folded_neural_network.get_inputs_number() == 5, LOG);
+
+    Tensor<type, 2> inputs(10, 5);
+    inputs.setRandom();
+
+    assert_true(layers_folding.calculate_maximum_outputs_difference(folded_neural_network, inputs) < static_cast<type>(1.0e-12), LOG);
+
+    // The original neural network is not modified
+
+    assert_true(neural_network.get_layers_number() == 2, LOG);
+}
+
+
+void LayersFoldingTest::test_fold_principal_components_layer()
+{
+    cout << "test_fold_principal_components_layer\n";
+
+    NeuralNetwork neural_network;
+
+    PrincipalComponentsLayer* principal_components_layer_pointer = new PrincipalComponentsLayer(4, 2);
+
+    Tensor<type, 2> principal_components(4, 4);
+    principal_components.setRandom();
+
+    Tensor<type, 1> means(4);
+    means.setValues({1, -2, static_cast<type>(0.5), 3});
+
+    principal_components_layer_pointer->set_principal_components(principal_components);
+    principal_components_layer_pointer->set_means(means);
+    principal_components_layer_pointer->set_principal_components_method(PrincipalComponentsLayer::PrincipalComponents);
+
+    PerceptronLayer* perceptron_layer_pointer = new PerceptronLayer(2, 3);
+
+    perceptron_layer_pointer->set_parameters_random();
+
+    neural_network.add_layer(principal_components_layer_pointer);
+    neural_network.add_layer(perceptron_layer_pointer);
+
+    Tensor<type, 2> inputs(10, 4);
+    inputs.setRandom();
+
+    const Tensor<type, 2> principal_components_outputs = principal_components_layer_pointer->calculate_outputs(inputs);
+
+    assert_true(principal_components_outputs.dimension(1) == 2, LOG);
+    assert_true(abs(principal_components_outputs(0,1)
+                    - ((inputs(0,0)-1)*principal_components(1,0) + (inputs(0,1)+2)*principal_components(1,1)
+                       + (inputs(0,2)-static_cast<type>(0.5))*principal_components(1,2) + (inputs(0,3)-3)*principal_components(1,3)))
+                < static_cast<type>(1.0e-12), LOG);
+
+    LayersFolding layers_folding(&neural_network);
+
+    NeuralNetwork folded_neural_network;
+
+    layers_folding.fold(folded_neural_network);
+
+    assert_true(folded_neural_network.get_layers_number() == 1, LOG);
+    assert_true(folded_neural_network.get_inputs_number() == 4, LOG);
+
+    assert_true(layers_folding.calculate_maximum_outputs_difference(folded_neural_network, inputs) < static_cast<type>(1.0e-12), LOG);
+}
+
+
+void LayersFoldingTest::test_fold_unscaling_layer()
+{
+    cout << "test_fold_unscaling_layer\n";
+
+    Tensor<Index, 1> architecture(3);
+    architecture.setValues({3, 4, 2});
+
+    NeuralNetwork neural_network(NeuralNetwork::Approximation, architecture);
+
+    neural_network.set_parameters_random();
+
+    Tensor<Descriptives, 1> descriptives(2);
+    descriptives(0) = Descriptives(-10, 30, 5, 7);
+    descriptives(1) = Descriptives(100, 200, 160, 25);
+
+    UnscalingLayer* unscaling_layer_pointer = neural_network.get_unscaling_layer_pointer();
+
+    unscaling_layer_pointer->set_descriptives(descriptives);
+
+    Tensor<UnscalingLayer::UnscalingMethod, 1> unscaling_methods(2);
+    unscaling_methods.setValues({UnscalingLayer::MinimumMaximum, UnscalingLayer::MeanStandardDeviation});
+
+    unscaling_layer_pointer->set_unscaling_methods(unscaling_methods);
+
+    LayersFolding layers_folding(&neural_network);
+
+    NeuralNetwork folded_neural_network;
+
+    Tensor<type, 2> inputs(10, 3);
+    inputs.setRandom();
+
+    // Non linear output layer
+
+    layers_folding.fold(folded_neural_network);
+
+    assert_true(folded_neural_network.has_unscaling_layer(), LOG);
+    assert_true(!folded_neural_network.has_scaling_layer(), LOG);
+    assert_true(folded_neural_network.has_bounding_layer(), LOG);
+
+    assert_true(layers_folding.calculate_maximum_outputs_difference(folded_neural_network, inputs) < static_cast<type>(1.0e-10), LOG);
+
+    // Linear output layer
+
+    static_cast<PerceptronLayer*>(neural_network.get_trainable_layers_pointers()(1))->set_activation_function(PerceptronLayer::Linear);
+
+    layers_folding.fold(folded_neural_network);
+
+    assert_true(folded_neural_network.get_layers_number() == 3, LOG);
+    assert_true(!folded_neural_network.has_unscaling_layer(), LOG);
+    assert_true(folded_neural_network.has_bounding_layer(), LOG);
+
+    assert_true(layers_folding.calculate_maximum_outputs_difference(folded_neural_network, inputs) < static_cast<type>(1.0e-10), LOG);
+
+    // Logarithmic unscaling
+
+    unscaling_layer_pointer->set_unscaling_methods(UnscalingLayer::Logarithmic);
+
+    layers_folding.fold(folded_neural_network);
+
+    assert_true(folded_neural_network.has_unscaling_layer(), LOG);
+
+    assert_true(layers_folding.calculate_maximum_outputs_difference(folded_neural_network, inputs) < static_cast<type>(1.0e-10), LOG);
+}
+
+
+void LayersFoldingTest::test_fuse_linear_layers()
+{
+    cout << "test_fuse_linear_layers\n";
+
+    NeuralNetwork neural_network;
+
+    PerceptronLayer* perceptron_layer_pointer_1 = new PerceptronLayer(3, 8);
+    perceptron_layer_pointer_1->set_activation_function(PerceptronLayer::Linear);
+    perceptron_layer_pointer_1->set_parameters_random();
+
+    PerceptronLayer* perceptron_layer_pointer_2 = new PerceptronLayer(8, 2);
+    perceptron_layer_pointer_2->set_parameters_random();
+
+    neural_network.add_layer(perceptron_layer_pointer_1);
+    neural_network.add_layer(perceptron_layer_pointer_2);
+
+    LayersFolding layers_folding(&neural_network);
+
+    NeuralNetwork folded_neural_network;
+
+    layers_folding.fold(folded_neural_network);
+
+    assert_true(folded_neural_network.get_layers_number() == 1, LOG);
+    assert_true(folded_neural_network.get_parameters_number() == 8, LOG);
+
+    Tensor<type, 2> inputs(10, 3);
+    inputs.setRandom();
+
+    assert_true(layers_folding.calculate_maximum_outputs_difference(folded_neural_network, inputs) < static_cast<type>(1.0e-12), LOG);
+
+    // Fusion would increase the number of parameters
+
+    perceptron_layer_pointer_1->set(10, 2);
+    perceptron_layer_pointer_1->set_activation_function(PerceptronLayer::Linear);
+    perceptron_layer_pointer_1->set_parameters_random();
+
+    perceptron_layer_pointer_2->set(2, 10);
+    perceptron_layer_pointer_2->set_parameters_random();
+
+    layers_folding.fold(folded_neural_network);
+
+    assert_true(folded_neural_network.get_layers_number() == 2, LOG);
+}
+
+
+void LayersFoldingTest::test_fold_constant_neurons()
+{
+    cout << "test_fold_constant_neurons\n";
+
+    Tensor<Index, 1> architecture(3);
+    architecture.setValues({3, 5, 2});
+
+    NeuralNetwork neural_network(NeuralNetwork::Classification, architecture);
+
+    neural_network.set_parameters_random();
+
+    PerceptronLayer* perceptron_layer_pointer = neural_network.get_first_perceptron_layer_pointer();
+
+    Tensor<type, 2> synaptic_weights = perceptron_layer_pointer->get_synaptic_weights();
+
+    synaptic_weights.chip(1, 1).setZero();
+    synaptic_weights.chip(4, 1).setZero();
+
+    perceptron_layer_pointer->set_synaptic_weights(synaptic_weights);
+
+    LayersFolding layers_folding(&neural_network);
+
+    NeuralNetwork folded_neural_network;
+
+    layers_folding.fold(folded_neural_network);
+
+    assert_true(folded_neural_network.get_layers_number() == 2, LOG);
+    assert_true(folded_neural_network.get_layers_neurons_numbers()(0) == 3, LOG);
+
+    Tensor<type, 2> inputs(10, 3);
+    inputs.setRandom();
+
+    assert_true(layers_folding.calculate_maximum_outputs_difference(folded_neural_network, inputs) < static_cast<type>(1.0e-12), LOG);
+
+    // All the neurons are constant
+
+    perceptron_layer_pointer->set_synaptic_weights_constant(0);
+
+    layers_folding.fold(folded_neural_network);
+
+    assert_true(folded_neural_network.get_layers_neurons_numbers()(0) == 1, LOG);
+
+    assert_true(layers_folding.calculate_maximum_outputs_difference(folded_neural_network, inputs) < static_cast<type>(1.0e-12), LOG);
+}
+
+
+void LayersFoldingTest::test_remove_dead_neurons()
+{
+    cout << "test_remove_dead_neurons\n";
+
+    Tensor<Index, 1> architecture(4);
+    architecture.setValues({3, 6, 4, 2});
+
+    NeuralNetwork neural_network(NeuralNetwork::Classification, architecture);
+
+    neural_network.set_parameters_random();
+
+    const Tensor<Layer*, 1> trainable_layers_pointers = neural_network.get_trainable_layers_pointers();
+
+    // Neuron 2 of the second layer is not used, and then neuron 5 of the first layer only feeds that neuron
+
+    PerceptronLayer* perceptron_layer_pointer = static_cast<PerceptronLayer*>(trainable_layers_pointers(1));
+
+    Tensor<type, 2> synaptic_weights = perceptron_layer_pointer->get_synaptic_weights();
+
+    synaptic_weights.chip(5, 0).setZero();
+    synaptic_weights(5, 2) = 1;
+
+    perceptron_layer_pointer->set_synaptic_weights(synaptic_weights);
+
+    ProbabilisticLayer* probabilistic_layer_pointer = static_cast<ProbabilisticLayer*>(trainable_layers_pointers(2));
+
+    Tensor<type, 2> probabilistic_synaptic_weights = probabilistic_layer_pointer->get_synaptic_weights();
+
+    probabilistic_synaptic_weights.chip(2, 0).setZero();
+
+    probabilistic_layer_pointer->set_synaptic_weights(probabilistic_synaptic_weights);
+
+    LayersFolding layers_folding(&neural_network);
+
+    NeuralNetwork folded_neural_network;
+
+    layers_folding.fold(folded_neural_network);
+
+    const Tensor<Index, 1> neurons_numbers = folded_neural_network.get_layers_neurons_numbers();
+
+    assert_true(neurons_numbers(0) == 5, LOG);
+    assert_true(neurons_numbers(1) == 3, LOG);
+    assert_true(neurons_numbers(2) == 2, LOG);
+
+    Tensor<type, 2> inputs(10, 3);
+    inputs.setRandom();
+
+    assert_true(layers_folding.calculate_maximum_outputs_difference(folded_neural_network, inputs) < static_cast<type>(1.0e-12), LOG);
+}
+
+
+void LayersFoldingTest::test_perform_folding()
+{
+    cout << "test_perform_folding\n";
+
+    Tensor<Index, 1> architecture(4);
+    architecture.setValues({4, 6, 3, 1});
+
+    NeuralNetwork neural_network(NeuralNetwork::Approximation, architecture);
+
+    neural_network.set_parameters_random();
+
+    Tensor<Descriptives, 1> inputs_descriptives(4);
+    inputs_descriptives(0) = Descriptives(-1, 1, 0, 1);
+    inputs_descriptives(1) = Descriptives(0, 100, 40, 20);
+    inputs_descriptives(2) = Descriptives(-5, 15, 2, 3);
+    inputs_descriptives(3) = Descriptives(1, 2, static_cast<type>(1.5), static_cast<type>(0.2));
+
+    neural_network.get_scaling_layer_pointer()->set_descriptives(inputs_descriptives);
+    neural_network.get_scaling_layer_pointer()->set_scaling_methods(ScalingLayer::MeanStandardDeviation);
+
+    Tensor<Descriptives, 1> outputs_descriptives(1);
+    outputs_descriptives(0) = Descriptives(1000, 5000, 2500, 800);
+
+    neural_network.get_unscaling_layer_pointer()->set_descriptives(outputs_descriptives);
+
+    static_cast<PerceptronLayer*>(neural_network.get_trainable_layers_pointers()(2))->set_activation_function(PerceptronLayer::Linear);
+
+    const Tensor<type, 1> parameters = neural_network.get_parameters();
+
+    LayersFolding layers_folding(&neural_network);
+
+    layers_folding.set_display(false);
+
+    Tensor<type, 2> inputs(20, 4);
+    inputs.setRandom();
+
+    NeuralNetwork folded_neural_network;
+
+    const LayersFolding::FoldingResults folding_results = layers_folding.perform_folding(folded_neural_network, inputs);
+
+    assert_true(folding_results.original_layers_number == 6, LOG);
+    assert_true(folding_results.folded_layers_number == 4, LOG);
+    assert_true(folding_results.original_parameters_number == folding_results.folded_parameters_number, LOG);
+    assert_true(folding_results.maximum_outputs_difference < static_cast<type>(1.0e-8), LOG);
+
+    // The original neural network is not modified
+
+    const Tensor<type, 0> parameters_difference = (neural_network.get_parameters() - parameters).abs().maximum();
+
+    assert_true(parameters_difference(0) < numeric_limits<type>::min(), LOG);
+}
+
+
+void LayersFoldingTest::test_from_XML()
+{
+    cout << "test_from_XML\n";
+
+    LayersFolding layers_folding;
+
+    layers_folding.set_pruning_tolerance(static_cast<type>(0.001));
+    layers_folding.set_verification_tolerance(static_cast<type>(0.01));
+    layers_folding.set_display(false);
+
+    tinyxml2::XMLPrinter printer;
+
+    layers_folding.write_XML(printer);
+
+    tinyxml2::XMLDocument document;
+
+    document.Parse(printer.CStr());
+
+    LayersFolding layers_folding_2;
+
+    layers_folding_2.from_XML(document);
+
+    assert_true(abs(layers_folding_2.get_pruning_tolerance() - static_cast<type>(0.001)) < static_cast<type>(1.0e-12), LOG);
+    assert_true(abs(layers_folding_2.get_verification_tolerance() - static_cast<type>(0.01)) < static_cast<type>(1.0e-12), LOG);
+    assert_true(!layers_folding_2.get_display(), LOG);
+}
+
+
+void LayersFoldingTest::run_test_case()
+{
+   cout << "Running layers folding test case...\n";
+
+   // Constructor and destructor
+
+   test_constructor();
+
+
+   // Folding methods
+
+   test_fold_scaling_layer();
+   test_fold_principal_components_layer();
+   test_fold_unscaling_layer();
+
+   test_fuse_linear_layers();
+
+   test_fold_constant_neurons();
+   test_remove_dead_neurons();
+
+   test_perform_folding();
+
+
+   // Serialization methods
+
+   test_from_XML();
+
+
+   cout << "End of layers folding test case.\n";
+}
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright (C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
@@ -132,6 +132,69 @@ void LearningRateAlgorithmTest::test_set_loss_tolerance()
 void LearningRateAlgorithmTest::test_calculate_directional_point()
 {
    cout << "test_calculate_directional_point\n";
+
+   const Index instances_number = 20;
+   const Index inputs_number = 2;
+   const Index outputs_number = 1;
+
+   DataSet data_set(instances_number, inputs_number, outputs_number);
+   data_set.set_data_random();
+   data_set.set_training();
+
+   DataSet::Batch batch(instances_number, &data_set);
+
+   batch.fill(data_set.get_training_instances_indices(),
+              data_set.get_input_variables_indices(),
+              data_set.get_target_variables_indices());
+
+   Tensor<Index, 1> architecture(2);
+   architecture.setValues({inputs_number, outputs_number});
+
+   NeuralNetwork neural_network(NeuralNetwork::Approximation, architecture);
+   neural_network.set_parameters_random();
+
+   SumSquaredError sum_squared_error(&neural_network, &data_set);
+   sum_squared_error.set_regularization_method(LossIndex::NoRegularization);
+
+   LearningRateAlgorithm tra(&sum_squared_error);
+   tra.set_learning_rate_method(LearningRateAlgorithm::BrentMethod);
+   tra.set_bracketing_instances_number(5);
+
+   NeuralNetwork::ForwardPropagation forward_propagation(instances_number, &neural_network);
+   LossIndex::BackPropagation back_propagation(instances_number, &sum_squared_error);
+
+   neural_network.forward_propagate(batch, forward_propagation);
+   sum_squared_error.back_propagate(batch, forward_propagation, back_propagation);
+
+   const type initial_loss = back_propagation.loss;
+
+   OptimizationAlgorithm::OptimizationData optimization_data;
+
+   optimization_data.parameters = neural_network.get_parameters();
+   optimization_data.potential_parameters = optimization_data.parameters;
+   optimization_data.training_direction = -back_propagation.gradient;
+   optimization_data.initial_learning_rate = static_cast<type>(0.001);
+
+   // Bracketing on a subsample, twice to reuse the bracketing batch
+
+   for(Index i = 0; i < 2; i++)
+   {
+       back_propagation.loss = initial_loss;
+
+       const pair<type,type> directional_point
+               = tra.calculate_directional_point(batch, forward_propagation, back_propagation, optimization_data);
+
+       assert_true(directional_point.first >= 0, LOG);
+       assert_true(directional_point.second <= initial_loss, LOG);
+   }
+
+   assert_true(optimization_data.bracketing_batch.get_instances_number() == 5, LOG);
+
+   const Tensor<type, 1> difference = optimization_data.bracketing_batch.targets_2d.chip(1,0) - batch.targets_2d.chip(4,0);
+
+   const Tensor<type, 0> maximum_difference = difference.abs().maximum();
+
+   assert_true(maximum_difference(0) < numeric_limits<type>::epsilon(), LOG);
 }
 
 
@@ -394,6 +457,185 @@ void LearningRateAlgorithmTest::test_calculate_Brent_method_directional_point()
 }
 
 
+void LearningRateAlgorithmTest::test_calculate_Wolfe_directional_point()
+{
+   cout << "test_calculate_Wolfe_directional_point\n";
+
+   const Index instances_number = 10;
+   const Index inputs_number = 2;
+   const Index outputs_number = 1;
+
+   DataSet data_set(instances_number, inputs_number, outputs_number);
+   data_set.set_data_random();
+   data_set.set_training();
+
+   DataSet::Batch batch(instances_number, &data_set);
+
+   const Tensor<Index, 1> instances_indices = data_set.get_training_instances_indices();
+   const Tensor<Index, 1> input_indices = data_set.get_input_variables_indices();
+   const Tensor<Index, 1> target_indices = data_set.get_target_variables_indices();
+
+   batch.fill(instances_indices, input_indices, target_indices);
+
+   Tensor<Index, 1> architecture(2);
+   architecture.setValues({inputs_number, outputs_number});
+
+   NeuralNetwork neural_network(NeuralNetwork::Approximation, architecture);
+   neural_network.set_parameters_random();
+
+   SumSquaredError sum_squared_error(&neural_network, &data_set);
+   sum_squared_error.set_regularization_method(LossIndex::NoRegularization);
+
+   LearningRateAlgorithm tra(&sum_squared_error);
+   tra.set_learning_rate_method(LearningRateAlgorithm::StrongWolfe);
+
+   assert_true(tra.evaluates_gradient(), LOG);
+
+   NeuralNetwork::ForwardPropagation forward_propagation(instances_number, &neural_network);
+   LossIndex::BackPropagation back_propagation(instances_number, &sum_squared_error);
+
+   neural_network.forward_propagate(batch, forward_propagation);
+   sum_squared_error.back_propagate(batch, forward_propagation, back_propagation);
+
+   const type initial_loss = back_propagation.loss;
+
+   OptimizationAlgorithm::OptimizationData optimization_data;
+
+   optimization_data.parameters = neural_network.get_parameters();
+   optimization_data.potential_parameters = optimization_data.parameters;
+   optimization_data.training_direction = -back_propagation.gradient;
+   optimization_data.initial_learning_rate = static_cast<type>(0.001);
+
+   const pair<type,type> directional_point
+           = tra.calculate_Wolfe_directional_point(batch, forward_propagation, back_propagation, optimization_data);
+
+   assert_true(directional_point.first >= 0, LOG);
+   assert_true(directional_point.second <= initial_loss, LOG);
+
+   // The back propagation is left at the accepted point
+
+   assert_true(abs(back_propagation.loss - directional_point.second) < numeric_limits<type>::epsilon(), LOG);
+
+   Tensor<type, 1> accepted_parameters = optimization_data.parameters + optimization_data.training_direction*directional_point.first;
+
+   neural_network.set_parameters(accepted_parameters);
+
+   LossIndex::BackPropagation accepted_back_propagation(instances_number, &sum_squared_error);
+
+   neural_network.forward_propagate(batch, forward_propagation);
+   sum_squared_error.back_propagate(batch, forward_propagation, accepted_back_propagation);
+
+   const Tensor<type, 1> difference = accepted_back_propagation.gradient - back_propagation.gradient;
+
+   const Tensor<type, 0> maximum_difference = difference.abs().maximum();
+
+   assert_true(abs(accepted_back_propagation.loss - directional_point.second) < static_cast<type>(1.0e-6), LOG);
+   assert_true(maximum_difference(0) < static_cast<type>(1.0e-6), LOG);
+}
+
+
+void LearningRateAlgorithmTest::test_calculate_Wolfe_directional_point_quadratic()
+{
+   cout << "test_calculate_Wolfe_directional_point_quadratic\n";
+
+   const Index instances_number = 10;
+   const Index inputs_number = 2;
+   const Index outputs_number = 1;
+
+   DataSet data_set(instances_number, inputs_number, outputs_number);
+   data_set.set_data_random();
+   data_set.set_training();
+
+   DataSet::Batch batch(instances_number, &data_set);
+
+   batch.fill(data_set.get_training_instances_indices(),
+              data_set.get_input_variables_indices(),
+              data_set.get_target_variables_indices());
+
+   // The sum squared error of a linear neural network is a quadratic function of the parameters
+
+   PerceptronLayer* perceptron_layer = new PerceptronLayer(inputs_number, outputs_number, 0, PerceptronLayer::Linear);
+
+   NeuralNetwork neural_network;
+   neural_network.add_layer(perceptron_layer);
+   neural_network.set_parameters_random();
+
+   SumSquaredError sum_squared_error(&neural_network, &data_set);
+   sum_squared_error.set_regularization_method(LossIndex::NoRegularization);
+
+   LearningRateAlgorithm tra(&sum_squared_error);
+   tra.set_learning_rate_method(LearningRateAlgorithm::StrongWolfe);
+   tra.set_curvature(static_cast<type>(0.1));
+   tra.set_maximum_line_search_iterations(50);
+
+   NeuralNetwork::ForwardPropagation forward_propagation(instances_number, &neural_network);
+   LossIndex::BackPropagation back_propagation(instances_number, &sum_squared_error);
+
+   Tensor<type, 1> parameters = neural_network.get_parameters();
+
+   neural_network.forward_propagate(batch, forward_propagation);
+   sum_squared_error.back_propagate(batch, forward_propagation, back_propagation);
+
+   const type initial_loss = back_propagation.loss;
+
+   OptimizationAlgorithm::OptimizationData optimization_data;
+
+   optimization_data.parameters = parameters;
+   optimization_data.potential_parameters = parameters;
+   optimization_data.training_direction = -back_propagation.gradient;
+   optimization_data.initial_learning_rate = static_cast<type>(0.001);
+
+   const Tensor<type, 0> initial_slope = (back_propagation.gradient*optimization_data.training_direction).sum();
+
+   // Curvature of the loss along the training direction, phi(1) = phi(0) + phi'(0) + q
+
+   Tensor<type, 1> unit_parameters = parameters + optimization_data.training_direction;
+
+   neural_network.set_parameters(unit_parameters);
+
+   LossIndex::BackPropagation unit_back_propagation(instances_number, &sum_squared_error);
+
+   neural_network.forward_propagate(batch, forward_propagation);
+   sum_squared_error.back_propagate(batch, forward_propagation, unit_back_propagation);
+
+   const type quadratic_coefficient = unit_back_propagation.loss - initial_loss - initial_slope(0);
+
+   const type minimum_learning_rate = -initial_slope(0)/(2*quadratic_coefficient);
+
+   neural_network.set_parameters(parameters);
+
+   pair<type,type> directional_point
+           = tra.calculate_Wolfe_directional_point(batch, forward_propagation, back_propagation, optimization_data);
+
+   const Tensor<type, 0> slope = (back_propagation.gradient*optimization_data.training_direction).sum();
+
+   // Sufficient decrease and curvature conditions
+
+   assert_true(directional_point.second <= initial_loss + tra.get_sufficient_decrease()*directional_point.first*initial_slope(0), LOG);
+   assert_true(abs(slope(0)) <= -tra.get_curvature()*initial_slope(0) + static_cast<type>(1.0e-9), LOG);
+
+   // On a quadratic, the curvature condition bounds the distance to the minimum
+
+   assert_true(abs(directional_point.first - minimum_learning_rate) <= tra.get_curvature()*minimum_learning_rate + static_cast<type>(1.0e-9), LOG);
+
+   // Iteration cap, the first trial point is too short to satisfy the curvature condition
+
+   tra.set_maximum_line_search_iterations(1);
+
+   optimization_data.initial_learning_rate = minimum_learning_rate*static_cast<type>(1.0e-3);
+
+   neural_network.set_parameters(parameters);
+
+   neural_network.forward_propagate(batch, forward_propagation);
+   sum_squared_error.back_propagate(batch, forward_propagation, back_propagation);
+
+   directional_point = tra.calculate_Wolfe_directional_point(batch, forward_propagation, back_propagation, optimization_data);
+
+   assert_true(abs(directional_point.first - optimization_data.initial_learning_rate) < numeric_limits<type>::epsilon(), LOG);
+   assert_true(directional_point.second < initial_loss, LOG);
+}
+
+
 void LearningRateAlgorithmTest::test_to_XML()
 {
    cout << "test_to_XML\n";
@@ -408,6 +650,38 @@ void LearningRateAlgorithmTest::test_to_XML()
 }
 
 
+void LearningRateAlgorithmTest::test_from_XML()
+{
+   cout << "test_from_XML\n";
+
+   LearningRateAlgorithm tra;
+
+   tra.set_learning_rate_method(LearningRateAlgorithm::StrongWolfe);
+   tra.set_curvature(static_cast<type>(0.5));
+   tra.set_sufficient_decrease(static_cast<type>(0.25));
+   tra.set_maximum_line_search_iterations(7);
+   tra.set_bracketing_instances_number(3);
+
+   tinyxml2::XMLPrinter printer;
+
+   tra.write_XML(printer);
+
+   tinyxml2::XMLDocument document;
+
+   document.Parse(printer.CStr());
+
+   LearningRateAlgorithm tra_copy;
+
+   tra_copy.from_XML(document);
+
+   assert_true(tra_copy.get_learning_rate_method() == LearningRateAlgorithm::StrongWolfe, LOG);
+   assert_true(abs(tra_copy.get_sufficient_decrease() - static_cast<type>(0.25)) < numeric_limits<type>::epsilon(), LOG);
+   assert_true(abs(tra_copy.get_curvature() - static_cast<type>(0.5)) < numeric_limits<type>::epsilon(), LOG);
+   assert_true(tra_copy.get_maximum_line_search_iterations() == 7, LOG);
+   assert_true(tra_copy.get_bracketing_instances_number() == 3, LOG);
+}
+
+
 void LearningRateAlgorithmTest::run_test_case()
 {
    cout << "Running training rate algorithm test case...\n";
@@ -458,11 +732,14 @@ void LearningRateAlgorithmTest::run_test_case()
    test_calculate_fixed_directional_point();
    test_calculate_golden_section_directional_point();
    test_calculate_Brent_method_directional_point();
+   test_calculate_Wolfe_directional_point();
+   test_calculate_Wolfe_directional_point_quadratic();
    test_calculate_directional_point();
 
    // Serialization methods
 
    test_to_XML();
+   test_from_XML();
 
    cout << "End of training rate algorithm test case.\n";
 }
@@ -78,6 +78,8 @@ public:
    void test_calculate_fixed_directional_point();
    void test_calculate_golden_section_directional_point();
    void test_calculate_Brent_method_directional_point();
+   void test_calculate_Wolfe_directional_point();
+   void test_calculate_Wolfe_directional_point_quadratic();
    
    // Serialization methods
 
@@ -942,6 +942,56 @@ void LongShortTermMemoryLayerTest::test_calculate_outputs()
 }
 
 
+void LongShortTermMemoryLayerTest::test_calculate_error_gradient()
+{
+   cout << "test_calculate_error_gradient\n";
+
+   LongShortTermMemoryLayer long_short_term_memory_layer(2, 3);
+
+   long_short_term_memory_layer.set_timesteps(3);
+
+   long_short_term_memory_layer.set_parameters_random();
+
+   const Index instances_number = 7;
+   const Index parameters_number = long_short_term_memory_layer.get_parameters_number();
+
+   Tensor<type, 2> inputs(instances_number, 2);
+   inputs.setRandom();
+
+   Tensor<type, 2> deltas(instances_number, 3);
+   deltas.setRandom();
+
+   // The error is the sum of the outputs weighted by the deltas
+
+   const Tensor<type, 1> error_gradient = long_short_term_memory_layer.calculate_error_gradient(inputs, deltas);
+
+   assert_true(error_gradient.size() == parameters_number, LOG);
+
+   const Tensor<type, 1> parameters = long_short_term_memory_layer.get_parameters();
+
+   const type h = static_cast<type>(1.0e-6);
+
+   Tensor<type, 1> perturbed_parameters;
+   Tensor<type, 0> forward_error;
+   Tensor<type, 0> backward_error;
+
+   for(Index i = 0; i < parameters_number; i++)
+   {
+       perturbed_parameters = parameters;
+
+       perturbed_parameters(i) += h;
+       long_short_term_memory_layer.set_parameters(perturbed_parameters);
+       forward_error = (long_short_term_memory_layer.calculate_outputs(inputs)*deltas).sum();
+
+       perturbed_parameters(i) -= static_cast<type>(2.0)*h;
+       long_short_term_memory_layer.set_parameters(perturbed_parameters);
+       backward_error = (long_short_term_memory_layer.calculate_outputs(inputs)*deltas).sum();
+
+       assert_true(abs(error_gradient(i) - (forward_error(0) - backward_error(0))/(static_cast<type>(2.0)*h)) < static_cast<type>(1.0e-6), LOG);
+   }
+}
+
+
 void LongShortTermMemoryLayerTest::run_test_case()
 {
    cout << "Running long short term memory layer test case...\n";
@@ -1013,6 +1063,10 @@ void LongShortTermMemoryLayerTest::run_test_case()
 
    test_calculate_outputs();
 
+   // Calculate error gradient
+
+   test_calculate_error_gradient();
+
    cout << "End of long short term memory layer test case.\n";
 }
 
@@ -95,6 +95,10 @@ public:
 
    void test_calculate_outputs();
 
+   // Calculate error gradient
+
+   void test_calculate_error_gradient();
+
    // Unit testing methods
 
    void run_test_case();
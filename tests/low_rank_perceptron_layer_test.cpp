@@ -0,0 +1,392 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   L O W   R A N K   P E R C E P T R O N   L A Y E R   T E S T   C L A S S
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#include "low_rank_perceptron_layer_test.h"
+
+
+LowRankPerceptronLayerTest::LowRankPerceptronLayerTest() : UnitTesting()
+{
+}
+
+
+LowRankPerceptronLayerTest::~LowRankPerceptronLayerTest()
+{
+}
+
+
+void LowRankPerceptronLayerTest::test_constructor()
+{
+    cout << "test_constructor\n";
+
+    // Default constructor
+
+    LowRankPerceptronLayer low_rank_perceptron_layer_1;
+
+    assert_true(low_rank_perceptron_layer_1.get_inputs_number() == 0, LOG);
+    assert_true(low_rank_perceptron_layer_1.get_neurons_number() == 0, LOG);
+    assert_true(low_rank_perceptron_layer_1.get_rank() == 0, LOG);
+    assert_true(low_rank_perceptron_layer_1.get_type() == Layer::LowRankPerceptron, LOG);
+
+    // Architecture constructor
+
+    LowRankPerceptronLayer low_rank_perceptron_layer_2(100, 5, 3, PerceptronLayer::Linear);
+
+    assert_true(low_rank_perceptron_layer_2.get_inputs_number() == 100, LOG);
+    assert_true(low_rank_perceptron_layer_2.get_neurons_number() == 5, LOG);
+    assert_true(low_rank_perceptron_layer_2.get_rank() == 3, LOG);
+    assert_true(low_rank_perceptron_layer_2.get_activation_function() == PerceptronLayer::Linear, LOG);
+    assert_true(low_rank_perceptron_layer_2.get_type_string() == "LowRankPerceptron", LOG);
+
+    // Copy constructor
+
+    LowRankPerceptronLayer low_rank_perceptron_layer_3(low_rank_perceptron_layer_2);
+
+    assert_true(low_rank_perceptron_layer_3.get_inputs_number() == 100, LOG);
+    assert_true(low_rank_perceptron_layer_3.get_rank() == 3, LOG);
+}
+
+
+void LowRankPerceptronLayerTest::test_get_parameters_number()
+{
+    cout << "test_get_parameters_number\n";
+
+    LowRankPerceptronLayer low_rank_perceptron_layer(100, 5, 3);
+
+    assert_true(low_rank_perceptron_layer.get_synaptic_weights_number() == 100*3 + 3*5, LOG);
+    assert_true(low_rank_perceptron_layer.get_parameters_number() == 5 + 100*3 + 3*5, LOG);
+    assert_true(low_rank_perceptron_layer.get_parameters().size() == 5 + 100*3 + 3*5, LOG);
+}
+
+
+void LowRankPerceptronLayerTest::test_set_parameters()
+{
+    cout << "test_set_parameters\n";
+
+    LowRankPerceptronLayer low_rank_perceptron_layer(3, 2, 1);
+
+    Tensor<type, 1> parameters(7);
+    parameters.setValues({1,2, 3,4,5, 6,7});
+
+    low_rank_perceptron_layer.set_parameters(parameters);
+
+    assert_true(low_rank_perceptron_layer.get_biases()(1) == 2, LOG);
+    assert_true(low_rank_perceptron_layer.get_input_factors()(2,0) == 5, LOG);
+    assert_true(low_rank_perceptron_layer.get_output_factors()(0,1) == 7, LOG);
+
+    const Tensor<type, 2> synaptic_weights = low_rank_perceptron_layer.get_synaptic_weights();
+
+    assert_true(synaptic_weights.dimension(0) == 3, LOG);
+    assert_true(synaptic_weights.dimension(1) == 2, LOG);
+    assert_true(synaptic_weights(1,0) == 4*6, LOG);
+    assert_true(synaptic_weights(2,1) == 5*7, LOG);
+
+    const Tensor<type, 1> new_parameters = low_rank_perceptron_layer.get_parameters();
+
+    Tensor<type, 0> parameters_difference = (new_parameters - parameters).abs().maximum();
+
+    assert_true(parameters_difference(0) == 0, LOG);
+}
+
+
+void LowRankPerceptronLayerTest::test_forward_propagate()
+{
+    cout << "test_forward_propagate\n";
+
+    // Test against a perceptron layer with the product of the factors as synaptic weights
+
+    const Index instances_number = 10;
+    const Index inputs_number = 8;
+    const Index neurons_number = 4;
+    const Index rank = 2;
+
+    LowRankPerceptronLayer low_rank_perceptron_layer(inputs_number, neurons_number, rank, PerceptronLayer::Logistic);
+
+    PerceptronLayer perceptron_layer(inputs_number, neurons_number);
+
+    perceptron_layer.set_activation_function(PerceptronLayer::Logistic);
+    perceptron_layer.set_biases(low_rank_perceptron_layer.get_biases());
+    perceptron_layer.set_synaptic_weights(low_rank_perceptron_layer.get_synaptic_weights());
+
+    Tensor<type, 2> inputs(instances_number, inputs_number);
+    inputs.setRandom();
+
+    Layer::ForwardPropagation low_rank_forward_propagation(instances_number, &low_rank_perceptron_layer);
+    Layer::ForwardPropagation forward_propagation(instances_number, &perceptron_layer);
+
+    low_rank_perceptron_layer.forward_propagate(inputs, low_rank_forward_propagation);
+    perceptron_layer.forward_propagate(inputs, forward_propagation);
+
+    Tensor<type, 0> activations_difference
+            = (low_rank_forward_propagation.activations_2d - forward_propagation.activations_2d).abs().maximum();
+    Tensor<type, 0> derivatives_difference
+            = (low_rank_forward_propagation.activations_derivatives_2d - forward_propagation.activations_derivatives_2d).abs().maximum();
+
+    assert_true(activations_difference(0) < static_cast<type>(1.0e-12), LOG);
+    assert_true(derivatives_difference(0) < static_cast<type>(1.0e-12), LOG);
+
+    // Outputs
+
+    const Tensor<type, 2> outputs = low_rank_perceptron_layer.calculate_outputs(inputs);
+
+    activations_difference = (outputs - forward_propagation.activations_2d).abs().maximum();
+
+    assert_true(activations_difference(0) < static_cast<type>(1.0e-12), LOG);
+}
+
+
+void LowRankPerceptronLayerTest::test_forward_propagate_sparse()
+{
+    cout << "test_forward_propagate_sparse\n";
+
+    const Index instances_number = 12;
+    const Index inputs_number = 40;
+    const Index neurons_number = 3;
+    const Index rank = 2;
+
+    LowRankPerceptronLayer low_rank_perceptron_layer(inputs_number, neurons_number, rank);
+
+    Tensor<type, 2> inputs(instances_number, inputs_number);
+    inputs.setZero();
+
+    for(Index i = 0; i < instances_number; i++)
+    {
+        inputs(i, (5*i)%inputs_number) = static_cast<type>(1);
+        inputs(i, (11*i+3)%inputs_number) = static_cast<type>(i)/static_cast<type>(4);
+    }
+
+    CsrMatrix sparse_inputs(instances_number, inputs_number);
+
+    for(Index i = 0; i < instances_number; i++)
+    {
+        sparse_inputs.startVec(i);
+
+        for(Index j = 0; j < inputs_number; j++)
+        {
+            if(inputs(i,j) != static_cast<type>(0)) sparse_inputs.insertBack(i,j) = inputs(i,j);
+        }
+    }
+
+    sparse_inputs.finalize();
+
+    Layer::ForwardPropagation dense_forward_propagation(instances_number, &low_rank_perceptron_layer);
+    Layer::ForwardPropagation sparse_forward_propagation(instances_number, &low_rank_perceptron_layer);
+
+    low_rank_perceptron_layer.forward_propagate(inputs, dense_forward_propagation);
+    low_rank_perceptron_layer.forward_propagate(sparse_inputs, sparse_forward_propagation);
+
+    Tensor<type, 0> activations_difference
+            = (sparse_forward_propagation.activations_2d - dense_forward_propagation.activations_2d).abs().maximum();
+
+    assert_true(activations_difference(0) < static_cast<type>(1.0e-12), LOG);
+
+    // Gradient
+
+    Layer::BackPropagation dense_back_propagation(instances_number, &low_rank_perceptron_layer);
+    Layer::BackPropagation sparse_back_propagation(instances_number, &low_rank_perceptron_layer);
+
+    Tensor<type, 2> delta(instances_number, neurons_number);
+    delta.setRandom();
+
+    dense_back_propagation.delta = delta;
+    sparse_back_propagation.delta = delta;
+
+    low_rank_perceptron_layer.calculate_error_gradient(inputs, dense_forward_propagation, dense_back_propagation);
+    low_rank_perceptron_layer.calculate_error_gradient(sparse_inputs, sparse_forward_propagation, sparse_back_propagation);
+
+    const Index parameters_number = low_rank_perceptron_layer.get_parameters_number();
+
+    Tensor<type, 1> dense_gradient(parameters_number);
+    Tensor<type, 1> sparse_gradient(parameters_number);
+
+    low_rank_perceptron_layer.insert_gradient(dense_back_propagation, 0, dense_gradient);
+    low_rank_perceptron_layer.insert_gradient(sparse_back_propagation, 0, sparse_gradient);
+
+    Tensor<type, 0> gradient_difference = (sparse_gradient - dense_gradient).abs().maximum();
+
+    assert_true(gradient_difference(0) < static_cast<type>(1.0e-12), LOG);
+}
+
+
+void LowRankPerceptronLayerTest::test_calculate_error_gradient()
+{
+    cout << "test_calculate_error_gradient\n";
+
+    // Test against central differences of the sum of the combinations weighted by the delta
+
+    const Index instances_number = 5;
+    const Index inputs_number = 6;
+    const Index neurons_number = 3;
+    const Index rank = 2;
+
+    LowRankPerceptronLayer low_rank_perceptron_layer(inputs_number, neurons_number, rank, PerceptronLayer::Linear);
+
+    Tensor<type, 2> inputs(instances_number, inputs_number);
+    inputs.setRandom();
+
+    Tensor<type, 2> delta(instances_number, neurons_number);
+    delta.setRandom();
+
+    Layer::ForwardPropagation forward_propagation(instances_number, &low_rank_perceptron_layer);
+    low_rank_perceptron_layer.forward_propagate(inputs, forward_propagation);
+
+    Layer::BackPropagation back_propagation(instances_number, &low_rank_perceptron_layer);
+    back_propagation.delta = delta;
+
+    low_rank_perceptron_layer.calculate_error_gradient(inputs, forward_propagation, back_propagation);
+
+    const Index parameters_number = low_rank_perceptron_layer.get_parameters_number();
+
+    Tensor<type, 1> gradient(parameters_number);
+
+    low_rank_perceptron_layer.insert_gradient(back_propagation, 0, gradient);
+
+    Tensor<type, 1> parameters = low_rank_perceptron_layer.get_parameters();
+
+    const type h = static_cast<type>(1.0e-5);
+
+    type maximum_difference = 0;
+
+    for(Index i = 0; i < parameters_number; i++)
+    {
+        const type parameter = parameters(i);
+
+        const TensorMap<Tensor<type, 1>> parameters_map(parameters.data(), parameters_number);
+
+        parameters(i) = parameter + h;
+        low_rank_perceptron_layer.forward_propagate(inputs, parameters_map, forward_propagation);
+        const Tensor<type, 0> error_forward = (forward_propagation.combinations_2d*delta).sum();
+
+        parameters(i) = parameter - h;
+        low_rank_perceptron_layer.forward_propagate(inputs, parameters_map, forward_propagation);
+        const Tensor<type, 0> error_backward = (forward_propagation.combinations_2d*delta).sum();
+
+        parameters(i) = parameter;
+
+        const type numerical_derivative = (error_forward(0) - error_backward(0))/(static_cast<type>(2)*h);
+
+        maximum_difference = max(maximum_difference, abs(numerical_derivative - gradient(i)));
+    }
+
+    assert_true(maximum_difference < static_cast<type>(1.0e-6), LOG);
+}
+
+
+void LowRankPerceptronLayerTest::test_from_XML()
+{
+    cout << "test_from_XML\n";
+
+    // Layer
+
+    LowRankPerceptronLayer low_rank_perceptron_layer(7, 3, 2, PerceptronLayer::RectifiedLinear);
+
+    tinyxml2::XMLPrinter printer;
+
+    low_rank_perceptron_layer.write_XML(printer);
+
+    tinyxml2::XMLDocument document;
+
+    document.Parse(printer.CStr());
+
+    LowRankPerceptronLayer low_rank_perceptron_layer_2;
+
+    low_rank_perceptron_layer_2.from_XML(document);
+
+    assert_true(low_rank_perceptron_layer_2.get_inputs_number() == 7, LOG);
+    assert_true(low_rank_perceptron_layer_2.get_neurons_number() == 3, LOG);
+    assert_true(low_rank_perceptron_layer_2.get_rank() == 2, LOG);
+    assert_true(low_rank_perceptron_layer_2.get_activation_function() == PerceptronLayer::RectifiedLinear, LOG);
+
+    Tensor<type, 0> parameters_difference
+            = (low_rank_perceptron_layer_2.get_parameters() - low_rank_perceptron_layer.get_parameters()).abs().maximum();
+
+    assert_true(parameters_difference(0) < static_cast<type>(1.0e-3), LOG);
+
+    // Neural network
+
+    NeuralNetwork neural_network;
+
+    neural_network.add_layer(new LowRankPerceptronLayer(low_rank_perceptron_layer));
+
+    Tensor<string, 1> inputs_names(7);
+    inputs_names.setConstant("input");
+
+    Tensor<string, 1> outputs_names(3);
+    outputs_names.setConstant("output");
+
+    neural_network.set_inputs_names(inputs_names);
+    neural_network.set_outputs_names(outputs_names);
+
+    tinyxml2::XMLPrinter neural_network_printer;
+
+    neural_network.write_XML(neural_network_printer);
+
+    tinyxml2::XMLDocument neural_network_document;
+
+    neural_network_document.Parse(neural_network_printer.CStr());
+
+    NeuralNetwork neural_network_2;
+
+    neural_network_2.from_XML(neural_network_document);
+
+    assert_true(neural_network_2.get_layers_number() == 1, LOG);
+    assert_true(neural_network_2.get_layer_pointer(0)->get_type() == Layer::LowRankPerceptron, LOG);
+    assert_true(neural_network_2.get_parameters_number() == low_rank_perceptron_layer.get_parameters_number(), LOG);
+}
+
+
+void LowRankPerceptronLayerTest::run_test_case()
+{
+   cout << "Running low rank perceptron layer test case...\n";
+
+   // Constructor and destructor
+
+   test_constructor();
+
+
+   // Parameters
+
+   test_get_parameters_number();
+   test_set_parameters();
+
+
+   // Forward propagate
+
+   test_forward_propagate();
+   test_forward_propagate_sparse();
+
+
+   // Gradient
+
+   test_calculate_error_gradient();
+
+
+   // Serialization methods
+
+   test_from_XML();
+
+
+   cout << "End of low rank perceptron layer test case.\n";
+}
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright (C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
@@ -0,0 +1,78 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   L O W   R A N K   P E R C E P T R O N   L A Y E R   T E S T   C L A S S   H E A D E R
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#ifndef LOWRANKPERCEPTRONLAYERTEST_H
+#define LOWRANKPERCEPTRONLAYERTEST_H
+
+// Unit testing includes
+
+#include "unit_testing.h"
+
+using namespace OpenNN;
+
+
+class LowRankPerceptronLayerTest : public UnitTesting
+{
+
+#define STRING(x) #x
+#define TOSTRING(x) STRING(x)
+#define LOG __FILE__ ":" TOSTRING(__LINE__)"\n"
+
+public:
+
+   explicit LowRankPerceptronLayerTest();
+
+   virtual ~LowRankPerceptronLayerTest();
+
+   // Constructor and destructor methods
+
+   void test_constructor();
+
+   // Parameters
+
+   void test_get_parameters_number();
+   void test_set_parameters();
+
+   // Forward propagate
+
+   void test_forward_propagate();
+   void test_forward_propagate_sparse();
+
+   // Gradient
+
+   void test_calculate_error_gradient();
+
+   // Serialization methods
+
+   void test_from_XML();
+
+   // Unit testing methods
+
+   void run_test_case();
+};
+
+
+#endif
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright (C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
@@ -41,9 +41,11 @@ int main()
    "growing_inputs | gi\n"
    "incremental_neurons | in\n"
    "inputs_selection | is\n"
+   "layers_folding | lf\n"
    "learning_rate_algorithm | lra\n"
    "levenberg_marquardt_algorithm | lma\n"
    "long_short_term_memory_layer | lstm\n"
+   "low_rank_perceptron_layer | lrpl\n"
    "mean_squared_error | mse\n"
    "minkowski_error | me\n"
    "model_selection | ms\n"
@@ -55,6 +57,8 @@ int main()
    "pooling_layer | pll\n"
    "probabilistic_layer | pbl\n"
    "pruning_inputs | pi\n"
+   "pruning_weights | pw\n"
+   "quantized_neural_network | qnn\n"
    "quasi_newton_method | qnm\n"
    "recurrent_layer | rl\n"
    "scaling_layer | sl\n"
@@ -63,6 +67,14 @@ int main()
    "stochastic_gradient_descent | sgd\n"
    "sum_squared_error | sse\n"
    "testing_analysis | ta\n"
+   "training_checkpoint | tc\n"
+   "training_profiler | tp\n"
+   "training_observer | to\n"
+   "training_scheduler | tsc\n"
+   "cross_validation | cv\n"
+   "batch_predictor | bp\n"
+   "model_server | msv\n"
+   "gradient_checker | gc\n"
    "training_strategy | ts\n"
    "unscaling_layer | ul\n"
    "weighted_squared_error | wse\n"
@@ -116,6 +128,15 @@ int main()
          tests_failed_count += test_numerical_differentiation.get_tests_failed_count();
       }
 
+      else if(test == "low_rank_perceptron_layer" || test == "lrpl")
+      {
+         LowRankPerceptronLayerTest low_rank_perceptron_layer_test;
+         low_rank_perceptron_layer_test.run_test_case();
+         tests_count += low_rank_perceptron_layer_test.get_tests_count();
+         tests_passed_count += low_rank_perceptron_layer_test.get_tests_passed_count();
+         tests_failed_count += low_rank_perceptron_layer_test.get_tests_failed_count();
+      }
+
       else if(test == "perceptron_layer" || test == "pl")
       {
          PerceptronLayerTest perceptron_layer_test;
@@ -379,6 +400,96 @@ int main()
         tests_failed_count += pruning_inputs_test.get_tests_failed_count();
       }
 
+      else if(test == "pruning_weights" || test == "pw")
+      {
+        PruningWeightsTest pruning_weights_test;
+        pruning_weights_test.run_test_case();
+        tests_count += pruning_weights_test.get_tests_count();
+        tests_passed_count += pruning_weights_test.get_tests_passed_count();
+        tests_failed_count += pruning_weights_test.get_tests_failed_count();
+      }
+
+      else if(test == "layers_folding" || test == "lf")
+      {
+        LayersFoldingTest layers_folding_test;
+        layers_folding_test.run_test_case();
+        tests_count += layers_folding_test.get_tests_count();
+        tests_passed_count += layers_folding_test.get_tests_passed_count();
+        tests_failed_count += layers_folding_test.get_tests_failed_count();
+      }
+
+      else if(test == "training_checkpoint" || test == "tc")
+      {
+        TrainingCheckpointTest training_checkpoint_test;
+        training_checkpoint_test.run_test_case();
+        tests_count += training_checkpoint_test.get_tests_count();
+        tests_passed_count += training_checkpoint_test.get_tests_passed_count();
+        tests_failed_count += training_checkpoint_test.get_tests_failed_count();
+      }
+
+      else if(test == "training_profiler" || test == "tp")
+      {
+        TrainingProfilerTest training_profiler_test;
+        training_profiler_test.run_test_case();
+        tests_count += training_profiler_test.get_tests_count();
+        tests_passed_count += training_profiler_test.get_tests_passed_count();
+        tests_failed_count += training_profiler_test.get_tests_failed_count();
+      }
+
+      else if(test == "training_observer" || test == "to")
+      {
+        TrainingObserverTest training_observer_test;
+        training_observer_test.run_test_case();
+        tests_count += training_observer_test.get_tests_count();
+        tests_passed_count += training_observer_test.get_tests_passed_count();
+        tests_failed_count += training_observer_test.get_tests_failed_count();
+      }
+
+      else if(test == "training_scheduler" || test == "tsc")
+      {
+        TrainingSchedulerTest training_scheduler_test;
+        training_scheduler_test.run_test_case();
+        tests_count += training_scheduler_test.get_tests_count();
+        tests_passed_count += training_scheduler_test.get_tests_passed_count();
+        tests_failed_count += training_scheduler_test.get_tests_failed_count();
+      }
+
+      else if(test == "cross_validation" || test == "cv")
+      {
+        CrossValidationTest cross_validation_test;
+        cross_validation_test.run_test_case();
+        tests_count += cross_validation_test.get_tests_count();
+        tests_passed_count += cross_validation_test.get_tests_passed_count();
+        tests_failed_count += cross_validation_test.get_tests_failed_count();
+      }
+
+      else if(test == "batch_predictor" || test == "bp")
+      {
+        BatchPredictorTest batch_predictor_test;
+        batch_predictor_test.run_test_case();
+        tests_count += batch_predictor_test.get_tests_count();
+        tests_passed_count += batch_predictor_test.get_tests_passed_count();
+        tests_failed_count += batch_predictor_test.get_tests_failed_count();
+      }
+
+      else if(test == "model_server" || test == "msv")
+      {
+        ModelServerTest model_server_test;
+        model_server_test.run_test_case();
+        tests_count += model_server_test.get_tests_count();
+        tests_passed_count += model_server_test.get_tests_passed_count();
+        tests_failed_count += model_server_test.get_tests_failed_count();
+      }
+
+      else if(test == "gradient_checker" || test == "gc")
+      {
+        GradientCheckerTest gradient_checker_test;
+        gradient_checker_test.run_test_case();
+        tests_count += gradient_checker_test.get_tests_count();
+        tests_passed_count += gradient_checker_test.get_tests_passed_count();
+        tests_failed_count += gradient_checker_test.get_tests_failed_count();
+      }
+
       else if(test == "genetic_algorithm" || test == "ga")
       {
         GeneticAlgorithmTest genetic_algorithm_test;
@@ -397,6 +508,15 @@ int main()
         tests_failed_count += testing_analysis_test.get_tests_failed_count();
       }
 
+      else if(test == "quantized_neural_network" || test == "qnn")
+      {
+        QuantizedNeuralNetworkTest quantized_neural_network_test;
+        quantized_neural_network_test.run_test_case();
+        tests_count += quantized_neural_network_test.get_tests_count();
+        tests_passed_count += quantized_neural_network_test.get_tests_passed_count();
+        tests_failed_count += quantized_neural_network_test.get_tests_failed_count();
+      }
+
       else if(test == "suite" || test == "")
       {
           // numerical differentiation
@@ -435,6 +555,14 @@ int main()
           tests_passed_count += perceptron_layer_test.get_tests_passed_count();
           tests_failed_count += perceptron_layer_test.get_tests_failed_count();
 
+          // low rank perceptron layer
+
+          LowRankPerceptronLayerTest low_rank_perceptron_layer_test;
+          low_rank_perceptron_layer_test.run_test_case();
+          tests_count += low_rank_perceptron_layer_test.get_tests_count();
+          tests_passed_count += low_rank_perceptron_layer_test.get_tests_passed_count();
+          tests_failed_count += low_rank_perceptron_layer_test.get_tests_failed_count();
+
           // scaling layer
 
           ScalingLayerTest scaling_layer_test;
@@ -624,6 +752,70 @@ int main()
           tests_passed_count += pruning_inputs_test.get_tests_passed_count();
           tests_failed_count += pruning_inputs_test.get_tests_failed_count();
 
+          // training_checkpoint
+
+          TrainingCheckpointTest training_checkpoint_test;
+          training_checkpoint_test.run_test_case();
+          tests_count += training_checkpoint_test.get_tests_count();
+          tests_passed_count += training_checkpoint_test.get_tests_passed_count();
+          tests_failed_count += training_checkpoint_test.get_tests_failed_count();
+
+          // training_profiler
+
+          TrainingProfilerTest training_profiler_test;
+          training_profiler_test.run_test_case();
+          tests_count += training_profiler_test.get_tests_count();
+          tests_passed_count += training_profiler_test.get_tests_passed_count();
+          tests_failed_count += training_profiler_test.get_tests_failed_count();
+
+          // training_observer
+
+          TrainingObserverTest training_observer_test;
+          training_observer_test.run_test_case();
+          tests_count += training_observer_test.get_tests_count();
+          tests_passed_count += training_observer_test.get_tests_passed_count();
+          tests_failed_count += training_observer_test.get_tests_failed_count();
+
+          // training_scheduler
+
+          TrainingSchedulerTest training_scheduler_test;
+          training_scheduler_test.run_test_case();
+          tests_count += training_scheduler_test.get_tests_count();
+          tests_passed_count += training_scheduler_test.get_tests_passed_count();
+          tests_failed_count += training_scheduler_test.get_tests_failed_count();
+
+          // cross_validation
+
+          CrossValidationTest cross_validation_test;
+          cross_validation_test.run_test_case();
+          tests_count += cross_validation_test.get_tests_count();
+          tests_passed_count += cross_validation_test.get_tests_passed_count();
+          tests_failed_count += cross_validation_test.get_tests_failed_count();
+
+          // batch_predictor
+
+          BatchPredictorTest batch_predictor_test;
+          batch_predictor_test.run_test_case();
+          tests_count += batch_predictor_test.get_tests_count();
+          tests_passed_count += batch_predictor_test.get_tests_passed_count();
+          tests_failed_count += batch_predictor_test.get_tests_failed_count();
+
+          // model_server
+
+          ModelServerTest model_server_test;
+          model_server_test.run_test_case();
+          tests_count += model_server_test.get_tests_count();
+          tests_passed_count += model_server_test.get_tests_passed_count();
+          tests_failed_count += model_server_test.get_tests_failed_count();
+
+          // gradient_checker
+
+          GradientCheckerTest gradient_checker_test;
+          gradient_checker_test.run_test_case();
+          tests_count += gradient_checker_test.get_tests_count();
+          tests_passed_count += gradient_checker_test.get_tests_passed_count();
+          tests_failed_count += gradient_checker_test.get_tests_failed_count();
+
           // genetic_algorithm
 
           GeneticAlgorithmTest genetic_algorithm_test;
@@ -639,6 +831,30 @@ int main()
           tests_count += testing_analysis_test.get_tests_count();
           tests_passed_count += testing_analysis_test.get_tests_passed_count();
           tests_failed_count += testing_analysis_test.get_tests_failed_count();
+
+          // P R U N I N G   T E S T S
+
+          PruningWeightsTest pruning_weights_test;
+          pruning_weights_test.run_test_case();
+          tests_count += pruning_weights_test.get_tests_count();
+          tests_passed_count += pruning_weights_test.get_tests_passed_count();
+          tests_failed_count += pruning_weights_test.get_tests_failed_count();
+
+          // F O L D I N G   T E S T S
+
+          LayersFoldingTest layers_folding_test;
+          layers_folding_test.run_test_case();
+          tests_count += layers_folding_test.get_tests_count();
+          tests_passed_count += layers_folding_test.get_tests_passed_count();
+          tests_failed_count += layers_folding_test.get_tests_failed_count();
+
+          // Q U A N T I Z A T I O N   T E S T S
+
+          QuantizedNeuralNetworkTest quantized_neural_network_test;
+          quantized_neural_network_test.run_test_case();
+          tests_count += quantized_neural_network_test.get_tests_count();
+          tests_passed_count += quantized_neural_network_test.get_tests_passed_count();
+          tests_failed_count += quantized_neural_network_test.get_tests_failed_count();
       }
 
       else
@@ -0,0 +1,655 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   M O D E L   S E R V E R   T E S T   C L A S S
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#include "model_server_test.h"
+
+#ifndef _WIN32
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+
+/// Returns a socket connected to a port of the loopback address.
+
+static int connect_tcp(const int& port)
+{
+    const int client_socket = socket(AF_INET, SOCK_STREAM, 0);
+
+    sockaddr_in address;
+
+    memset(&address, 0, sizeof(address));
+
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(static_cast<uint16_t>(port));
+
+    if(connect(client_socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        close(client_socket);
+
+        return -1;
+    }
+
+    return client_socket;
+}
+
+
+/// Returns a socket connected to a Unix socket path.
+
+static int connect_unix(const string& path)
+{
+    const int client_socket = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    sockaddr_un address;
+
+    memset(&address, 0, sizeof(address));
+
+    address.sun_family = AF_UNIX;
+
+    strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+    if(connect(client_socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        close(client_socket);
+
+        return -1;
+    }
+
+    return client_socket;
+}
+
+
+/// Receives a given number of bytes, or less if the connection is closed.
+
+static string receive_bytes(const int& client_socket, const size_t& size)
+{
+    string bytes;
+    char characters[4096];
+
+    while(bytes.size() < size)
+    {
+        const ssize_t received_bytes = recv(client_socket, characters, min(sizeof(characters), size - bytes.size()), 0);
+
+        if(received_bytes <= 0) break;
+
+        bytes.append(characters, static_cast<size_t>(received_bytes));
+    }
+
+    return bytes;
+}
+
+
+/// Receives a line, without the line break.
+
+static string receive_line(const int& client_socket)
+{
+    string line;
+    char character;
+
+    while(recv(client_socket, &character, 1, 0) == 1 && character != '\n') line += character;
+
+    return line;
+}
+
+
+/// Sends a binary request with the given inputs and returns the status of the response.
+/// The outputs or the error message of the response are returned in the arguments.
+
+static uint32_t request_binary(const int& client_socket, const Tensor<type, 2>& inputs, Tensor<type, 2>& outputs, string& error_message)
+{
+    const uint32_t instances_number = static_cast<uint32_t>(inputs.dimension(0));
+    const uint32_t inputs_number = static_cast<uint32_t>(inputs.dimension(1));
+
+    string request("ONNB", 4);
+
+    request.append(reinterpret_cast<const char*>(&instances_number), sizeof(uint32_t));
+    request.append(reinterpret_cast<const char*>(&inputs_number), sizeof(uint32_t));
+
+    for(Index i = 0; i < inputs.dimension(0); i++)
+    {
+        for(Index j = 0; j < inputs.dimension(1); j++)
+        {
+            request.append(reinterpret_cast<const char*>(&inputs(i, j)), sizeof(type));
+        }
+    }
+
+    send(client_socket, request.data(), request.size(), 0);
+
+    const string header = receive_bytes(client_socket, 4 + 3*sizeof(uint32_t));
+
+    if(header.size() != 4 + 3*sizeof(uint32_t) || header.compare(0, 4, "ONNB") != 0) return numeric_limits<uint32_t>::max();
+
+    uint32_t status;
+    uint32_t rows_number;
+    uint32_t columns_number;
+
+    memcpy(&status, header.data() + 4, sizeof(uint32_t));
+    memcpy(&rows_number, header.data() + 4 + sizeof(uint32_t), sizeof(uint32_t));
+    memcpy(&columns_number, header.data() + 4 + 2*sizeof(uint32_t), sizeof(uint32_t));
+
+    if(status != 0)
+    {
+        error_message = receive_bytes(client_socket, columns_number);
+
+        return status;
+    }
+
+    const string payload = receive_bytes(client_socket, static_cast<size_t>(rows_number)*columns_number*sizeof(type));
+
+    outputs.resize(rows_number, columns_number);
+
+    for(Index i = 0; i < static_cast<Index>(rows_number); i++)
+    {
+        for(Index j = 0; j < static_cast<Index>(columns_number); j++)
+        {
+            memcpy(&outputs(i, j), payload.data() + static_cast<size_t>(i*columns_number + j)*sizeof(type), sizeof(type));
+        }
+    }
+
+    return status;
+}
+
+#endif
+
+
+/// Returns true if two matrices have the same dimensions and their values differ less than a tolerance.
+
+static bool are_equal(const Tensor<type, 2>& a, const Tensor<type, 2>& b)
+{
+    if(a.dimension(0) != b.dimension(0) || a.dimension(1) != b.dimension(1)) return false;
+
+    const Tensor<type, 0> maximum_difference = (a - b).abs().maximum();
+
+    return maximum_difference(0) < static_cast<type>(1e-10);
+}
+
+
+/// Sets a neural network with random parameters and saves it in the binary model format.
+
+static void save_model(NeuralNetwork& neural_network, const string& file_name)
+{
+    Tensor<Index, 1> architecture(3);
+    architecture.setValues({3, 5, 2});
+
+    neural_network.set(NeuralNetwork::Approximation, architecture);
+    neural_network.set_parameters_random();
+    neural_network.save_binary(file_name);
+}
+
+
+ModelServerTest::ModelServerTest() : UnitTesting()
+{
+}
+
+
+ModelServerTest::~ModelServerTest()
+{
+}
+
+
+void ModelServerTest::test_constructor()
+{
+    cout << "test_constructor\n";
+
+    ModelServer model_server_1("../data/model_server.bin");
+
+    assert_true(model_server_1.get_model_file_name() == "../data/model_server.bin", LOG);
+    assert_true(!model_server_1.is_running(), LOG);
+
+    ModelServer model_server_2;
+
+    assert_true(model_server_2.get_model_file_name().empty(), LOG);
+}
+
+
+void ModelServerTest::test_destructor()
+{
+    cout << "test_destructor\n";
+
+    ModelServer* model_server = new ModelServer;
+
+    delete model_server;
+}
+
+
+void ModelServerTest::test_set_default()
+{
+    cout << "test_set_default\n";
+
+    ModelServer model_server;
+
+    model_server.set_port(8080);
+    model_server.set_unix_socket_path("../data/model_server.sock");
+    model_server.set_maximum_batch_instances_number(5);
+    model_server.set_workers_number(3);
+
+    model_server.set_default();
+
+    assert_true(model_server.get_address() == "127.0.0.1", LOG);
+    assert_true(model_server.get_port() == 0, LOG);
+    assert_true(model_server.get_unix_socket_path().empty(), LOG);
+    assert_true(model_server.get_maximum_batch_instances_number() == 64, LOG);
+    assert_true(abs(model_server.get_maximum_batch_delay() - static_cast<type>(0.001)) < numeric_limits<type>::epsilon(), LOG);
+    assert_true(model_server.get_workers_number() == omp_get_max_threads(), LOG);
+    assert_true(model_server.get_worker_threads_number() == 1, LOG);
+
+    // Wrong values
+
+    try
+    {
+        model_server.set_port(70000);
+
+        assert_true(false, LOG);
+    }
+    catch(const logic_error&)
+    {
+        assert_true(true, LOG);
+    }
+
+    try
+    {
+        model_server.set_maximum_batch_delay(-1);
+
+        assert_true(false, LOG);
+    }
+    catch(const logic_error&)
+    {
+        assert_true(true, LOG);
+    }
+
+    // Missing model file
+
+    model_server.set_model_file_name("../data/missing_model_server.bin");
+    model_server.set_display(false);
+
+    try
+    {
+        model_server.start();
+
+        assert_true(false, LOG);
+    }
+    catch(const logic_error&)
+    {
+        assert_true(!model_server.is_running(), LOG);
+    }
+}
+
+
+void ModelServerTest::test_serve_binary()
+{
+    cout << "test_serve_binary\n";
+
+#ifndef _WIN32
+
+    const string model_file_name = "../data/model_server.bin";
+
+    NeuralNetwork neural_network;
+
+    save_model(neural_network, model_file_name);
+
+    Tensor<type, 2> inputs(7, 3);
+    inputs.setRandom();
+
+    const Tensor<type, 2> outputs = neural_network.calculate_outputs(inputs);
+
+    ModelServer model_server(model_file_name);
+
+    model_server.set_workers_number(2);
+    model_server.set_display(false);
+
+    model_server.start();
+
+    assert_true(model_server.is_running(), LOG);
+    assert_true(model_server.get_port() > 0, LOG);
+
+    // Settings cannot be changed while the server runs
+
+    try
+    {
+        model_server.set_workers_number(1);
+
+        assert_true(false, LOG);
+    }
+    catch(const logic_error&)
+    {
+        assert_true(true, LOG);
+    }
+
+    const int client_socket = connect_tcp(model_server.get_port());
+
+    assert_true(client_socket >= 0, LOG);
+
+    Tensor<type, 2> response_outputs;
+    string error_message;
+
+    assert_true(request_binary(client_socket, inputs, response_outputs, error_message) == 0, LOG);
+    assert_true(are_equal(response_outputs, outputs), LOG);
+
+    // Wrong number of inputs, on the same connection
+
+    Tensor<type, 2> wrong_inputs(2, 4);
+    wrong_inputs.setRandom();
+
+    assert_true(request_binary(client_socket, wrong_inputs, response_outputs, error_message) != 0, LOG);
+    assert_true(error_message.find("3 inputs") != string::npos, LOG);
+
+    // The connection is still served
+
+    assert_true(request_binary(client_socket, inputs, response_outputs, error_message) == 0, LOG);
+    assert_true(are_equal(response_outputs, outputs), LOG);
+
+    close(client_socket);
+
+    model_server.stop();
+
+    assert_true(!model_server.is_running(), LOG);
+
+    const ModelServer::Statistics statistics = model_server.get_statistics();
+
+    assert_true(statistics.requests_number == 2, LOG);
+    assert_true(statistics.instances_number == 14, LOG);
+    assert_true(statistics.errors_number == 1, LOG);
+    assert_true(statistics.latency_p50 > 0, LOG);
+    assert_true(statistics.latency_p99 >= statistics.latency_p50, LOG);
+
+    remove(model_file_name.c_str());
+
+#endif
+}
+
+
+void ModelServerTest::test_serve_json()
+{
+    cout << "test_serve_json\n";
+
+#ifndef _WIN32
+
+    const string model_file_name = "../data/model_server.bin";
+
+    NeuralNetwork neural_network;
+
+    save_model(neural_network, model_file_name);
+
+    Tensor<type, 2> inputs(2, 3);
+    inputs.setValues({{0.5, -1, 2}, {0.25, 0, -0.75}});
+
+    const Tensor<type, 2> outputs = neural_network.calculate_outputs(inputs);
+
+    ModelServer model_server(model_file_name);
+
+    model_server.set_workers_number(1);
+    model_server.set_display(false);
+
+    model_server.start();
+
+    const int client_socket = connect_tcp(model_server.get_port());
+
+    assert_true(client_socket >= 0, LOG);
+
+    // Several instances
+
+    string request = "{\"inputs\": [[0.5, -1, 2], [0.25, 0, -0.75]]}\n";
+
+    send(client_socket, request.data(), request.size(), 0);
+
+    string response = receive_line(client_socket);
+
+    assert_true(response.find("{\"outputs\": [[") == 0, LOG);
+
+    Tensor<type, 2> response_outputs(2, 2);
+
+    const char* position = response.c_str() + response.find("[[") + 2;
+    char* end = nullptr;
+
+    for(Index i = 0; i < 2; i++)
+    {
+        for(Index j = 0; j < 2; j++)
+        {
+            while(*position == ' ' || *position == ',' || *position == '[' || *position == ']') position++;
+
+            response_outputs(i, j) = static_cast<type>(strtod(position, &end));
+
+            position = end;
+        }
+    }
+
+    assert_true(are_equal(response_outputs, outputs), LOG);
+
+    // Single instance
+
+    request = "{\"inputs\": [0.5, -1, 2]}\n";
+
+    send(client_socket, request.data(), request.size(), 0);
+
+    response = receive_line(client_socket);
+
+    assert_true(response.find("{\"outputs\": [") == 0, LOG);
+    assert_true(response.find("[[") == string::npos, LOG);
+
+    // Errors keep the connection open
+
+    request = "{\"inputs\": [[1, 2], [3, 4, 5]]}\n{\"inputs\": [1, 2]}\n{\"inputs\": [1, \"a\", 2]}\n";
+
+    send(client_socket, request.data(), request.size(), 0);
+
+    assert_true(receive_line(client_socket).find("{\"error\": ") == 0, LOG);
+    assert_true(receive_line(client_socket).find("{\"error\": ") == 0, LOG);
+    assert_true(receive_line(client_socket).find("{\"error\": ") == 0, LOG);
+
+    // Statistics
+
+    request = "{\"command\": \"statistics\"}\n";
+
+    send(client_socket, request.data(), request.size(), 0);
+
+    response = receive_line(client_socket);
+
+    assert_true(response.find("\"requests_number\": 2") != string::npos, LOG);
+    assert_true(response.find("\"instances_number\": 3") != string::npos, LOG);
+    assert_true(response.find("\"errors_number\": 3") != string::npos, LOG);
+    assert_true(response.find("\"latency_p99\": ") != string::npos, LOG);
+
+    close(client_socket);
+
+    model_server.stop();
+
+    remove(model_file_name.c_str());
+
+#endif
+}
+
+
+void ModelServerTest::test_serve_concurrent_clients()
+{
+    cout << "test_serve_concurrent_clients\n";
+
+#ifndef _WIN32
+
+    const string model_file_name = "../data/model_server.bin";
+
+    NeuralNetwork neural_network;
+
+    save_model(neural_network, model_file_name);
+
+    const Index clients_number = 8;
+    const Index requests_number = 20;
+
+    Tensor<type, 2> inputs(clients_number, 3);
+    inputs.setRandom();
+
+    const Tensor<type, 2> outputs = neural_network.calculate_outputs(inputs);
+
+    ModelServer model_server(model_file_name);
+
+    model_server.set_workers_number(2);
+    model_server.set_maximum_batch_instances_number(4);
+    model_server.set_maximum_batch_delay(static_cast<type>(0.005));
+    model_server.set_display(false);
+
+    model_server.start();
+
+    vector<int> correct_responses_numbers(static_cast<size_t>(clients_number), 0);
+    vector<thread> clients;
+
+    for(Index i = 0; i < clients_number; i++)
+    {
+        clients.push_back(thread([&, i]()
+        {
+            const int client_socket = connect_tcp(model_server.get_port());
+
+            if(client_socket < 0) return;
+
+            const Eigen::array<Index, 2> offsets = {i, 0};
+            const Eigen::array<Index, 2> extents = {1, 3};
+
+            const Tensor<type, 2> client_inputs = inputs.slice(offsets, extents);
+
+            const Eigen::array<Index, 2> outputs_extents = {1, 2};
+
+            const Tensor<type, 2> client_outputs = outputs.slice(offsets, outputs_extents);
+
+            Tensor<type, 2> response_outputs;
+            string error_message;
+
+            for(Index j = 0; j < requests_number; j++)
+            {
+                if(request_binary(client_socket, client_inputs, response_outputs, error_message) == 0
+                && are_equal(response_outputs, client_outputs))
+                {
+                    correct_responses_numbers[static_cast<size_t>(i)]++;
+                }
+            }
+
+            close(client_socket);
+        }));
+    }
+
+    for(size_t i = 0; i < clients.size(); i++) clients[i].join();
+
+    model_server.stop();
+
+    for(size_t i = 0; i < correct_responses_numbers.size(); i++)
+    {
+        assert_true(correct_responses_numbers[i] == requests_number, LOG);
+    }
+
+    const ModelServer::Statistics statistics = model_server.get_statistics();
+
+    assert_true(statistics.requests_number == clients_number*requests_number, LOG);
+    assert_true(statistics.batches_number <= statistics.requests_number, LOG);
+    assert_true(statistics.requests_per_second > 0, LOG);
+
+    remove(model_file_name.c_str());
+
+#endif
+}
+
+
+void ModelServerTest::test_serve_unix_socket()
+{
+    cout << "test_serve_unix_socket\n";
+
+#ifndef _WIN32
+
+    const string model_file_name = "../data/model_server.xml";
+    const string socket_path = "../data/model_server.sock";
+
+    // Models in XML are also served
+
+    Tensor<Index, 1> architecture(3);
+    architecture.setValues({2, 3, 1});
+
+    NeuralNetwork neural_network(NeuralNetwork::Approximation, architecture);
+    neural_network.set_parameters_random();
+    neural_network.save(model_file_name);
+
+    NeuralNetwork loaded_neural_network;
+    loaded_neural_network.load(model_file_name);
+
+    Tensor<type, 2> inputs(3, 2);
+    inputs.setRandom();
+
+    const Tensor<type, 2> outputs = loaded_neural_network.calculate_outputs(inputs);
+
+    ModelServer model_server(model_file_name);
+
+    model_server.set_unix_socket_path(socket_path);
+    model_server.set_workers_number(1);
+    model_server.set_display(false);
+
+    model_server.start();
+
+    const int client_socket = connect_unix(socket_path);
+
+    assert_true(client_socket >= 0, LOG);
+
+    Tensor<type, 2> response_outputs;
+    string error_message;
+
+    assert_true(request_binary(client_socket, inputs, response_outputs, error_message) == 0, LOG);
+    assert_true(are_equal(response_outputs, outputs), LOG);
+
+    // The server is stopped with a connection open
+
+    model_server.stop();
+
+    assert_true(receive_bytes(client_socket, 1).empty(), LOG);
+
+    close(client_socket);
+
+    assert_true(connect_unix(socket_path) < 0, LOG);
+
+    remove(model_file_name.c_str());
+
+#endif
+}
+
+
+void ModelServerTest::run_test_case()
+{
+    cout << "Running model server test case...\n";
+
+    // Constructor and destructor methods
+
+    test_constructor();
+    test_destructor();
+
+    // Set methods
+
+    test_set_default();
+
+    // Serving methods
+
+    test_serve_binary();
+    test_serve_json();
+    test_serve_concurrent_clients();
+    test_serve_unix_socket();
+
+    cout << "End of model server test case.\n\n";
+}
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
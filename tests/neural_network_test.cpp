@@ -595,6 +595,76 @@ void NeuralNetworkTest::test_set_default()
    assert_true(display == true, LOG);
 }
 
+void NeuralNetworkTest::test_resize_inputs()
+{
+   cout << "test_resize_inputs\n";
+
+   Tensor<Index, 1> architecture(3);
+   architecture.setValues({2,3,1});
+
+   NeuralNetwork neural_network(NeuralNetwork::Approximation, architecture);
+   neural_network.set_parameters_random();
+
+   Tensor<type, 2> inputs(1,2);
+   inputs.setValues({{0.5, -0.3}});
+
+   const Tensor<type, 2> outputs = neural_network.calculate_outputs(inputs);
+
+   // Test
+
+   Tensor<Index, 1> inputs_indices(3);
+   inputs_indices.setValues({0, -1, 1});
+
+   neural_network.resize_inputs(inputs_indices);
+
+   assert_true(neural_network.get_inputs_number() == 3, LOG);
+
+   Tensor<type, 2> new_inputs(1,3);
+   new_inputs.setValues({{0.5, 0.8, -0.3}});
+
+   const Tensor<type, 2> new_outputs = neural_network.calculate_outputs(new_inputs);
+
+   assert_true(abs(new_outputs(0,0) - outputs(0,0)) < static_cast<type>(1.0e-6), LOG);
+
+   // Test
+
+   inputs_indices.resize(1);
+   inputs_indices.setValues({2});
+
+   neural_network.resize_inputs(inputs_indices);
+
+   assert_true(neural_network.get_inputs_number() == 1, LOG);
+}
+
+
+void NeuralNetworkTest::test_resize_hidden_neurons()
+{
+   cout << "test_resize_hidden_neurons\n";
+
+   Tensor<Index, 1> architecture(3);
+   architecture.setValues({2,3,1});
+
+   NeuralNetwork neural_network(NeuralNetwork::Approximation, architecture);
+   neural_network.set_parameters_random();
+
+   Tensor<type, 2> inputs(1,2);
+   inputs.setValues({{0.5, -0.3}});
+
+   const Tensor<type, 2> outputs = neural_network.calculate_outputs(inputs);
+
+   // Test
+
+   neural_network.resize_hidden_neurons(5);
+
+   assert_true(neural_network.get_trainable_layers_neurons_numbers()(0) == 5, LOG);
+   assert_true(neural_network.get_parameters_number() == 2*5 + 5 + 5*1 + 1, LOG);
+
+   const Tensor<type, 2> new_outputs = neural_network.calculate_outputs(inputs);
+
+   assert_true(abs(new_outputs(0,0) - outputs(0,0)) < static_cast<type>(1.0e-6), LOG);
+}
+
+
 void NeuralNetworkTest::test_set_pointers()
 {
    cout << "test_set_pointers\n";
@@ -1715,6 +1785,111 @@ void NeuralNetworkTest::test_load()
    neural_network.load(file_name);
 }
 
+void NeuralNetworkTest::test_save_binary()
+{
+   cout << "test_save_binary\n";
+
+   string file_name = "../data/neural_network.bin";
+
+   NeuralNetwork neural_network;
+
+   Tensor<Index, 1> architecture(3);
+
+   // Empty neural network
+
+   neural_network.save_binary(file_name);
+
+   // Multilayer perceptron
+
+   architecture.setValues({2, 4, 3});
+
+   neural_network.set(NeuralNetwork::Approximation, architecture);
+   neural_network.save_binary(file_name);
+
+   ifstream file(file_name.c_str(), ios::binary);
+
+   NeuralNetwork::BinaryModelHeader header;
+
+   file.read(reinterpret_cast<char*>(&header), sizeof(NeuralNetwork::BinaryModelHeader));
+
+   assert_true(string(header.magic, 8) == "OPENNNBM", LOG);
+   assert_true(header.endianness == 0x01020304, LOG);
+   assert_true(header.scalar_size == sizeof(type), LOG);
+   assert_true(header.parameters_number == static_cast<uint64_t>(neural_network.get_parameters_number()), LOG);
+   assert_true(header.parameters_offset % header.alignment == 0, LOG);
+}
+
+
+void NeuralNetworkTest::test_load_binary()
+{
+   cout << "test_load_binary\n";
+
+   string file_name = "../data/neural_network.bin";
+
+   NeuralNetwork neural_network;
+   NeuralNetwork loaded_neural_network;
+
+   Tensor<Index, 1> architecture(3);
+
+   Tensor<type, 2> inputs(5, 4);
+   Tensor<type, 2> outputs;
+   Tensor<type, 2> loaded_outputs;
+
+   // Empty neural network
+
+   neural_network.save_binary(file_name);
+   loaded_neural_network.load_binary(file_name);
+
+   assert_true(loaded_neural_network.get_layers_number() == 0, LOG);
+
+   // Classification
+
+   architecture.setValues({4, 6, 3});
+
+   neural_network.set(NeuralNetwork::Classification, architecture);
+   neural_network.set_parameters_random();
+
+   neural_network.save_binary(file_name);
+   loaded_neural_network.load_binary(file_name);
+
+   assert_true(loaded_neural_network.get_layers_number() == neural_network.get_layers_number(), LOG);
+   assert_true(loaded_neural_network.get_parameters_number() == neural_network.get_parameters_number(), LOG);
+
+   const Tensor<type, 1> parameters = neural_network.get_parameters();
+   const Tensor<type, 1> loaded_parameters = loaded_neural_network.get_parameters();
+
+   assert_true(memcmp(parameters.data(), loaded_parameters.data(), static_cast<size_t>(parameters.size())*sizeof(type)) == 0, LOG);
+
+   inputs.setRandom();
+
+   outputs = neural_network.calculate_outputs(inputs);
+   loaded_outputs = loaded_neural_network.calculate_outputs(inputs);
+
+   assert_true(abs(outputs(4, 2) - loaded_outputs(4, 2)) < numeric_limits<type>::min(), LOG);
+
+   // Corrupted parameters
+
+   fstream file(file_name.c_str(), ios::in | ios::out | ios::binary);
+
+   file.seekg(-1, ios::end);
+   const char last_byte = static_cast<char>(file.get());
+   file.seekp(-1, ios::end);
+   file.put(static_cast<char>(last_byte ^ 1));
+   file.close();
+
+   try
+   {
+       loaded_neural_network.load_binary(file_name);
+
+       assert_true(false, LOG);
+   }
+   catch(const logic_error&)
+   {
+       assert_true(true, LOG);
+   }
+}
+
+
 void NeuralNetworkTest::test_print()
 {
    cout << "test_print\n";
@@ -1798,6 +1973,149 @@ void NeuralNetworkTest::test_write_expression() // @todo
 
 }
 
+
+void NeuralNetworkTest::test_write_batch_expression_c()
+{
+   cout << "test_write_batch_expression_c\n";
+
+   NeuralNetwork neural_network;
+   string expression;
+
+   Tensor<Index, 1> architecture(3);
+
+   // Test
+
+   architecture.setValues({100, 100, 10});
+
+   neural_network.set(NeuralNetwork::Approximation, architecture);
+   neural_network.set_parameters_random();
+
+   expression = neural_network.write_batch_expression_c();
+
+   assert_true(expression.find("void neural_network(const float* inputs, float* outputs, int batch_size, float* workspace)") != string::npos, LOG);
+   assert_true(expression.find("#define NEURAL_NETWORK_INPUTS_NUMBER 100") != string::npos, LOG);
+   assert_true(expression.find("#define NEURAL_NETWORK_OUTPUTS_NUMBER 10") != string::npos, LOG);
+
+   // Parameters are written as arrays, not as unrolled expressions
+
+   assert_true(static_cast<Index>(expression.size()) < 20*neural_network.get_parameters_number(), LOG);
+
+#if defined(__unix__) || defined(__APPLE__)
+
+   // The compiled code calculates the outputs of the neural network, over more than one block of instances.
+   // The last case has a symmetric threshold neuron whose combination is exactly zero.
+
+   const string source_file_name = "../data/neural_network_batch_expression.c";
+   const string executable_file_name = "../data/neural_network_batch_expression";
+
+   const Index instances_number = 70;
+
+   Tensor<NeuralNetwork::ProjectType, 1> project_types(3);
+   project_types.setValues({NeuralNetwork::Approximation, NeuralNetwork::Classification, NeuralNetwork::Approximation});
+
+   architecture.setValues({3, 7, 4});
+
+   for(Index p = 0; p < project_types.size(); p++)
+   {
+       neural_network.set(project_types(p), architecture);
+       neural_network.set_parameters_random();
+
+       if(p == 2)
+       {
+           PerceptronLayer* perceptron_layer_pointer = neural_network.get_first_perceptron_layer_pointer();
+
+           perceptron_layer_pointer->set_activation_function(PerceptronLayer::SymmetricThreshold);
+
+           Tensor<type, 2> biases = perceptron_layer_pointer->get_biases();
+           Tensor<type, 2> synaptic_weights = perceptron_layer_pointer->get_synaptic_weights();
+
+           biases(0) = 0;
+           synaptic_weights.chip(0, 1).setZero();
+
+           perceptron_layer_pointer->set_biases(biases);
+           perceptron_layer_pointer->set_synaptic_weights(synaptic_weights);
+       }
+
+       const Index inputs_number = neural_network.get_inputs_number();
+       const Index outputs_number = neural_network.get_outputs_number();
+
+       Tensor<type, 2> inputs(instances_number, inputs_number);
+       inputs.setRandom();
+
+       const Tensor<type, 2> outputs = neural_network.calculate_outputs(inputs);
+
+       ofstream file(source_file_name);
+
+       file << neural_network.write_batch_expression_c() << endl;
+
+       file << "#include <stdio.h>\n" << endl;
+
+       file << "static const float test_inputs[" << instances_number*inputs_number << "] = {";
+
+       file << setprecision(9);
+
+       for(Index i = 0; i < instances_number; i++)
+       {
+           for(Index j = 0; j < inputs_number; j++)
+           {
+               file << (i == 0 && j == 0 ? "" : ", ") << inputs(i,j);
+           }
+       }
+
+       file << "};\n" << endl;
+
+       file << "int main(void)\n{" << endl;
+       file << "\tstatic float workspace[NEURAL_NETWORK_WORKSPACE_SIZE];" << endl;
+       file << "\tstatic float test_outputs[" << instances_number*outputs_number << "];\n" << endl;
+       file << "\tneural_network(test_inputs, test_outputs, " << instances_number << ", workspace);\n" << endl;
+       file << "\tfor(int i = 0; i < " << instances_number*outputs_number << "; i++) printf(\"%.9g\\n\", test_outputs[i]);\n" << endl;
+       file << "\treturn 0;\n}" << endl;
+
+       file.close();
+
+       const string command = "cc -O1 -o " + executable_file_name + " " + source_file_name + " -lm";
+
+       assert_true(system(command.c_str()) == 0, LOG);
+
+       FILE* pipe = popen(executable_file_name.c_str(), "r");
+
+       assert_true(pipe != nullptr, LOG);
+
+       if(!pipe) continue;
+
+       Tensor<type, 2> exported_outputs(instances_number, outputs_number);
+       exported_outputs.setConstant(numeric_limits<type>::quiet_NaN());
+
+       double value = 0;
+
+       for(Index i = 0; i < instances_number; i++)
+       {
+           for(Index j = 0; j < outputs_number; j++)
+           {
+               if(fscanf(pipe, "%lf", &value) == 1) exported_outputs(i,j) = static_cast<type>(value);
+           }
+       }
+
+       assert_true(pclose(pipe) == 0, LOG);
+
+       // The exported code calculates in single precision
+
+       for(Index i = 0; i < instances_number; i++)
+       {
+           for(Index j = 0; j < outputs_number; j++)
+           {
+               assert_true(abs(exported_outputs(i,j) - outputs(i,j)) < static_cast<type>(1.0e-4)*(1 + abs(outputs(i,j))), LOG);
+           }
+       }
+
+       remove(source_file_name.c_str());
+       remove(executable_file_name.c_str());
+   }
+
+#endif
+}
+
+
 void NeuralNetworkTest::test_forward_propagate() // @todo
 {
     cout << "test_forward_propagate\n";
@@ -1983,6 +2301,9 @@ void NeuralNetworkTest::run_test_case()
    test_set_names();
    test_set_number();
 
+   test_resize_inputs();
+   test_resize_hidden_neurons();
+
    test_set_pointers();
 
    test_set_display();
@@ -2029,6 +2350,7 @@ void NeuralNetworkTest::run_test_case()
 
    test_print();
    test_write_expression();
+   test_write_batch_expression_c();
 
    //Forward propagate
 
@@ -2043,6 +2365,10 @@ void NeuralNetworkTest::run_test_case()
 
    test_load();
 
+   test_save_binary();
+
+   test_load_binary();
+
    cout << "End of neural network test case.\n";
 }
 
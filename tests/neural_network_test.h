@@ -65,6 +65,9 @@ public:
    void test_set_names();
    void test_set_number();
 
+   void test_resize_inputs();
+   void test_resize_hidden_neurons();
+
    void test_set_pointers();
 
    void test_set_default();
@@ -122,6 +125,7 @@ public:
    // XML expression methods
 
    void test_write_expression();
+   void test_write_batch_expression_c();
    void test_save_expression();
 
    // Serialization methods
@@ -134,6 +138,9 @@ public:
    void test_save();
    void test_load();
 
+   void test_save_binary();
+   void test_load_binary();
+
    // Forward propagation
 
    void test_forward_propagate();
@@ -22,6 +22,7 @@
 #include "data_set_test.h"
 
 #include "perceptron_layer_test.h"
+#include "low_rank_perceptron_layer_test.h"
 #include "convolutional_layer_test.h"
 #include "pooling_layer_test.h"
 #include "scaling_layer_test.h"
@@ -48,16 +49,27 @@
 #include "stochastic_gradient_descent_test.h"
 #include "training_strategy_test.h"
 
+#include "training_checkpoint_test.h"
+#include "training_profiler_test.h"
+#include "training_observer_test.h"
+#include "training_scheduler_test.h"
+#include "cross_validation_test.h"
+#include "batch_predictor_test.h"
+#include "model_server_test.h"
+#include "gradient_checker_test.h"
 #include "model_selection_test.h"
 #include "neurons_selection_test.h"
 #include "incremental_neurons_test.h"
 #include "inputs_selection_test.h"
 #include "growing_inputs_test.h"
 #include "pruning_inputs_test.h"
+#include "pruning_weights_test.h"
+#include "layers_folding_test.h"
 #include "genetic_algorithm_test.h"
 #include "correlations_test.h"
 
 #include "testing_analysis_test.h"
+#include "quantized_neural_network_test.h"
 
 #endif
 
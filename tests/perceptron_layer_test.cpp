@@ -1251,6 +1251,63 @@ void PerceptronLayerTest::test_calculate_activations_derivatives() // @todo
    assert_true(activations_derivatives(0,0) - numerical_activation_derivative(0,0) < static_cast<type>(1e-3), LOG);
 }
 
+
+void PerceptronLayerTest::test_calculate_activations_derivatives_batch()
+{
+   cout << "test_calculate_activations_derivatives_batch\n";
+
+   PerceptronLayer perceptron_layer;
+
+   // Test activations and derivatives on several blocks
+
+   const Index instances_number = 37;
+   const Index neurons_number = 100;
+
+   perceptron_layer.set(1, neurons_number);
+
+   Tensor<type, 2> combinations_2d(instances_number, neurons_number);
+   combinations_2d.setRandom();
+   combinations_2d = static_cast<type>(20)*combinations_2d - static_cast<type>(10);
+
+   Tensor<type, 2> activations_2d(instances_number, neurons_number);
+   Tensor<type, 2> activations_derivatives(instances_number, neurons_number);
+
+   Tensor<type, 2> activations_forward(instances_number, neurons_number);
+   Tensor<type, 2> activations_backward(instances_number, neurons_number);
+   Tensor<type, 2> expected_activations(instances_number, neurons_number);
+
+   const type h = static_cast<type>(1.0e-6);
+
+   const PerceptronLayer::ActivationFunction activation_functions[] = {PerceptronLayer::Logistic,
+                                                                      PerceptronLayer::HyperbolicTangent,
+                                                                      PerceptronLayer::Linear,
+                                                                      PerceptronLayer::RectifiedLinear,
+                                                                      PerceptronLayer::ExponentialLinear,
+                                                                      PerceptronLayer::ScaledExponentialLinear,
+                                                                      PerceptronLayer::SoftPlus,
+                                                                      PerceptronLayer::SoftSign,
+                                                                      PerceptronLayer::HardSigmoid};
+
+   for(const PerceptronLayer::ActivationFunction& activation_function : activation_functions)
+   {
+       perceptron_layer.set_activation_function(activation_function);
+
+       perceptron_layer.calculate_activations_derivatives(combinations_2d, activations_2d, activations_derivatives);
+
+       perceptron_layer.calculate_activations(combinations_2d, expected_activations);
+       perceptron_layer.calculate_activations(combinations_2d + h, activations_forward);
+       perceptron_layer.calculate_activations(combinations_2d - h, activations_backward);
+
+       const Tensor<type, 0> activations_difference = (activations_2d - expected_activations).abs().maximum();
+
+       const Tensor<type, 0> derivatives_difference
+               = (activations_derivatives - (activations_forward - activations_backward)/(static_cast<type>(2)*h)).abs().maximum();
+
+       assert_true(activations_difference(0) < static_cast<type>(1.0e-12), LOG);
+       assert_true(derivatives_difference(0) < static_cast<type>(1.0e-5), LOG);
+   }
+}
+
 void PerceptronLayerTest::test_calculate_outputs() // @todo
 {
     cout << "test_calculate_outputs\n";
@@ -1371,6 +1428,174 @@ void PerceptronLayerTest::test_calculate_outputs() // @todo
 
 }
 
+void PerceptronLayerTest::test_prune_synaptic_weights()
+{
+    cout << "test_prune_synaptic_weights\n";
+
+    PerceptronLayer perceptron_layer(10, 6);
+
+    perceptron_layer.set_parameters_random();
+
+    assert_true(!perceptron_layer.is_pruned(), LOG);
+    assert_true(perceptron_layer.get_pruned_synaptic_weights_number() == 0, LOG);
+
+    // Unstructured pruning
+
+    const Tensor<type, 2> original_synaptic_weights = perceptron_layer.get_synaptic_weights();
+
+    perceptron_layer.set_sparse_block_size(1);
+
+    perceptron_layer.prune_synaptic_weights(static_cast<type>(0.5));
+
+    assert_true(perceptron_layer.is_pruned(), LOG);
+    assert_true(perceptron_layer.get_pruned_synaptic_weights_number() == 30, LOG);
+    assert_true(abs(perceptron_layer.calculate_sparsity() - static_cast<type>(0.5)) < static_cast<type>(1.0e-6), LOG);
+
+    type maximum_pruned_weight = 0;
+    type minimum_kept_weight = numeric_limits<type>::max();
+
+    for(Index i = 0; i < 10; i++)
+    {
+        for(Index j = 0; j < 6; j++)
+        {
+            if(perceptron_layer.get_pruning_mask()(i,j))
+            {
+                minimum_kept_weight = min(minimum_kept_weight, abs(original_synaptic_weights(i,j)));
+            }
+            else
+            {
+                maximum_pruned_weight = max(maximum_pruned_weight, abs(original_synaptic_weights(i,j)));
+
+                assert_true(perceptron_layer.get_synaptic_weights()(i,j) == 0, LOG);
+            }
+        }
+    }
+
+    assert_true(maximum_pruned_weight <= minimum_kept_weight, LOG);
+
+    // Blocks of inputs are pruned together
+
+    perceptron_layer.remove_pruning_mask();
+
+    perceptron_layer.set_parameters_random();
+
+    perceptron_layer.set_sparse_block_size(4);
+
+    perceptron_layer.prune_synaptic_weights(static_cast<type>(0.5));
+
+    assert_true(perceptron_layer.get_pruning_mask().dimension(0) == 10, LOG);
+
+    for(Index j = 0; j < 6; j++)
+    {
+        for(Index first_input = 0; first_input < 10; first_input += 4)
+        {
+            for(Index i = first_input+1; i < min(first_input+4, static_cast<Index>(10)); i++)
+            {
+                assert_true(perceptron_layer.get_pruning_mask()(i,j) == perceptron_layer.get_pruning_mask()(first_input,j), LOG);
+            }
+        }
+    }
+
+    // The pruned synaptic weights do not change
+
+    Tensor<type, 1> parameters(perceptron_layer.get_parameters_number());
+    parameters.setConstant(1);
+
+    perceptron_layer.set_parameters(parameters);
+
+    const Tensor<type, 0> parameters_sum = perceptron_layer.get_parameters().sum();
+
+    assert_true(abs(parameters_sum(0) - static_cast<type>(6 + 60 - perceptron_layer.get_pruned_synaptic_weights_number()))
+                < static_cast<type>(1.0e-6), LOG);
+
+    // Selected neurons
+
+    Tensor<Index, 1> neurons_indices(2);
+    neurons_indices.setValues({4, 1});
+
+    const Tensor<bool, 2> previous_pruning_mask = perceptron_layer.get_pruning_mask();
+
+    perceptron_layer.select_neurons(neurons_indices);
+
+    assert_true(perceptron_layer.get_neurons_number() == 2, LOG);
+    assert_true(perceptron_layer.get_pruning_mask()(0,0) == previous_pruning_mask(0,4), LOG);
+    assert_true(perceptron_layer.get_pruning_mask()(8,1) == previous_pruning_mask(8,1), LOG);
+
+    // Serialization
+
+    tinyxml2::XMLPrinter printer;
+
+    perceptron_layer.write_XML(printer);
+
+    tinyxml2::XMLDocument document;
+
+    document.Parse(printer.CStr());
+
+    PerceptronLayer perceptron_layer_2;
+
+    perceptron_layer_2.from_XML(document);
+
+    assert_true(perceptron_layer_2.is_pruned(), LOG);
+    assert_true(perceptron_layer_2.get_sparse_block_size() == 4, LOG);
+    assert_true(perceptron_layer_2.get_pruned_synaptic_weights_number() == perceptron_layer.get_pruned_synaptic_weights_number(), LOG);
+}
+
+
+void PerceptronLayerTest::test_calculate_sparse_combinations()
+{
+    cout << "test_calculate_sparse_combinations\n";
+
+    // Test the sparse combinations against the dense combinations of the pruned synaptic weights
+
+    const Index inputs_number = 23;
+    const Index neurons_number = 7;
+
+    Tensor<Index, 1> batch_sizes(3);
+    batch_sizes.setValues({1, 5, 300});
+
+    for(Index sparse_block_size = 1; sparse_block_size <= 5; sparse_block_size += 2)
+    {
+        PerceptronLayer perceptron_layer(inputs_number, neurons_number);
+
+        perceptron_layer.set_parameters_random();
+
+        perceptron_layer.set_sparse_block_size(sparse_block_size);
+
+        perceptron_layer.prune_synaptic_weights(static_cast<type>(0.7));
+
+        for(Index k = 0; k < batch_sizes.size(); k++)
+        {
+            Tensor<type, 2> inputs(batch_sizes(k), inputs_number);
+            inputs.setRandom();
+
+            Tensor<type, 2> dense_combinations(batch_sizes(k), neurons_number);
+            Tensor<type, 2> sparse_combinations(batch_sizes(k), neurons_number);
+
+            perceptron_layer.calculate_combinations(inputs,
+                                                    perceptron_layer.get_biases(),
+                                                    perceptron_layer.get_synaptic_weights(),
+                                                    dense_combinations);
+
+            perceptron_layer.calculate_sparse_combinations(inputs, sparse_combinations);
+
+            const Tensor<type, 0> combinations_difference = (sparse_combinations - dense_combinations).abs().maximum();
+
+            assert_true(combinations_difference(0) < static_cast<type>(1.0e-5), LOG);
+
+            // Outputs
+
+            Tensor<type, 2> activations(batch_sizes(k), neurons_number);
+
+            perceptron_layer.calculate_activations(dense_combinations, activations);
+
+            const Tensor<type, 0> outputs_difference = (perceptron_layer.calculate_outputs(inputs) - activations).abs().maximum();
+
+            assert_true(outputs_difference(0) < static_cast<type>(1.0e-5), LOG);
+        }
+    }
+}
+
+
 void PerceptronLayerTest::test_forward_propagate() // @todo
 {
     cout << "test_forward_propagate\n";
@@ -1427,6 +1652,166 @@ void PerceptronLayerTest::test_forward_propagate() // @todo
     assert_true(abs(forward_propagation_2.activations_derivatives_2d(0,1) - static_cast<type>(0.00986)) < static_cast<type>(1e-3), LOG);
 }
 
+
+void PerceptronLayerTest::test_forward_propagate_tiles()
+{
+    cout << "test_forward_propagate_tiles\n";
+
+    // Test outputs calculated in several tiles of neurons
+
+    const Index instances_number = 600;
+    const Index inputs_number = 5;
+    const Index neurons_number = 70;
+
+    PerceptronLayer perceptron_layer(inputs_number, neurons_number);
+
+    perceptron_layer.set_parameters_random();
+
+    const Tensor<type, 2> biases = perceptron_layer.get_biases();
+    const Tensor<type, 2> synaptic_weights = perceptron_layer.get_synaptic_weights();
+
+    Tensor<type, 2> inputs(instances_number, inputs_number);
+    inputs.setRandom();
+
+    Tensor<type, 2> expected_combinations(instances_number, neurons_number);
+
+    for(Index i = 0; i < instances_number; i++)
+    {
+        for(Index j = 0; j < neurons_number; j++)
+        {
+            expected_combinations(i,j) = biases(j);
+
+            for(Index k = 0; k < inputs_number; k++)
+            {
+                expected_combinations(i,j) += inputs(i,k)*synaptic_weights(k,j);
+            }
+        }
+    }
+
+    Tensor<type, 2> expected_activations(instances_number, neurons_number);
+    Tensor<type, 2> expected_activations_derivatives(instances_number, neurons_number);
+
+    const PerceptronLayer::ActivationFunction activation_functions[] = {PerceptronLayer::HyperbolicTangent,
+                                                                       PerceptronLayer::RectifiedLinear,
+                                                                       PerceptronLayer::Linear};
+
+    for(const PerceptronLayer::ActivationFunction& activation_function : activation_functions)
+    {
+        perceptron_layer.set_activation_function(activation_function);
+
+        perceptron_layer.calculate_activations_derivatives(expected_combinations,
+                                                           expected_activations,
+                                                           expected_activations_derivatives);
+
+        Layer::ForwardPropagation forward_propagation(instances_number, &perceptron_layer);
+
+        perceptron_layer.forward_propagate(inputs, forward_propagation);
+
+        Tensor<type, 0> combinations_difference = (forward_propagation.combinations_2d - expected_combinations).abs().maximum();
+        Tensor<type, 0> activations_difference = (forward_propagation.activations_2d - expected_activations).abs().maximum();
+        Tensor<type, 0> derivatives_difference
+                = (forward_propagation.activations_derivatives_2d - expected_activations_derivatives).abs().maximum();
+
+        assert_true(combinations_difference(0) < static_cast<type>(1.0e-12), LOG);
+        assert_true(activations_difference(0) < static_cast<type>(1.0e-12), LOG);
+        assert_true(derivatives_difference(0) < static_cast<type>(1.0e-12), LOG);
+
+        // Potential parameters
+
+        Tensor<type, 1> parameters = perceptron_layer.get_parameters();
+
+        const TensorMap<Tensor<type, 1>> potential_parameters(parameters.data(), parameters.size());
+
+        Layer::ForwardPropagation forward_propagation_2(instances_number, &perceptron_layer);
+
+        perceptron_layer.forward_propagate(inputs, potential_parameters, forward_propagation_2);
+
+        activations_difference = (forward_propagation_2.activations_2d - expected_activations).abs().maximum();
+        derivatives_difference = (forward_propagation_2.activations_derivatives_2d - expected_activations_derivatives).abs().maximum();
+
+        assert_true(activations_difference(0) < static_cast<type>(1.0e-12), LOG);
+        assert_true(derivatives_difference(0) < static_cast<type>(1.0e-12), LOG);
+    }
+}
+
+
+void PerceptronLayerTest::test_forward_propagate_sparse()
+{
+    cout << "test_forward_propagate_sparse\n";
+
+    // Test sparse inputs against the same inputs in a dense batch
+
+    const Index instances_number = 20;
+    const Index inputs_number = 50;
+    const Index neurons_number = 4;
+
+    PerceptronLayer perceptron_layer(inputs_number, neurons_number);
+
+    perceptron_layer.set_parameters_random();
+
+    Tensor<type, 2> inputs(instances_number, inputs_number);
+    inputs.setZero();
+
+    for(Index i = 0; i < instances_number; i++)
+    {
+        inputs(i, (7*i)%inputs_number) = static_cast<type>(i+1);
+        inputs(i, (3*i+1)%inputs_number) = static_cast<type>(-0.5);
+    }
+
+    CsrMatrix sparse_inputs(instances_number, inputs_number);
+
+    for(Index i = 0; i < instances_number; i++)
+    {
+        sparse_inputs.startVec(i);
+
+        for(Index j = 0; j < inputs_number; j++)
+        {
+            if(inputs(i,j) != static_cast<type>(0)) sparse_inputs.insertBack(i,j) = inputs(i,j);
+        }
+    }
+
+    sparse_inputs.finalize();
+
+    assert_true(sparse_inputs.nonZeros() == 2*instances_number, LOG);
+
+    Layer::ForwardPropagation dense_forward_propagation(instances_number, &perceptron_layer);
+    Layer::ForwardPropagation sparse_forward_propagation(instances_number, &perceptron_layer);
+
+    perceptron_layer.forward_propagate(inputs, dense_forward_propagation);
+    perceptron_layer.forward_propagate(sparse_inputs, sparse_forward_propagation);
+
+    Tensor<type, 0> activations_difference
+            = (sparse_forward_propagation.activations_2d - dense_forward_propagation.activations_2d).abs().maximum();
+    Tensor<type, 0> derivatives_difference
+            = (sparse_forward_propagation.activations_derivatives_2d - dense_forward_propagation.activations_derivatives_2d).abs().maximum();
+
+    assert_true(activations_difference(0) < static_cast<type>(1.0e-12), LOG);
+    assert_true(derivatives_difference(0) < static_cast<type>(1.0e-12), LOG);
+
+    // Gradient
+
+    Layer::BackPropagation dense_back_propagation(instances_number, &perceptron_layer);
+    Layer::BackPropagation sparse_back_propagation(instances_number, &perceptron_layer);
+
+    Tensor<type, 2> delta(instances_number, neurons_number);
+    delta.setRandom();
+
+    dense_back_propagation.delta = delta;
+    sparse_back_propagation.delta = delta;
+
+    perceptron_layer.calculate_error_gradient(inputs, dense_forward_propagation, dense_back_propagation);
+    perceptron_layer.calculate_error_gradient(sparse_inputs, sparse_forward_propagation, sparse_back_propagation);
+
+    Tensor<type, 0> biases_difference
+            = (sparse_back_propagation.biases_derivatives - dense_back_propagation.biases_derivatives).abs().maximum();
+    Tensor<type, 0> synaptic_weights_difference
+            = (sparse_back_propagation.synaptic_weights_derivatives - dense_back_propagation.synaptic_weights_derivatives).abs().maximum();
+
+    assert_true(biases_difference(0) < static_cast<type>(1.0e-12), LOG);
+    assert_true(synaptic_weights_difference(0) < static_cast<type>(1.0e-12), LOG);
+}
+
+
 void PerceptronLayerTest::test_calculate_output_delta() // @todo
 {
     cout << "test_calculate_output_delta\n";
@@ -1617,6 +2002,43 @@ void PerceptronLayerTest::test_write_expression()
 }
 
 
+void PerceptronLayerTest::test_write_batch_expression_c()
+{
+   cout << "test_write_batch_expression_c\n";
+
+   PerceptronLayer perceptron_layer(2, 3, 0, PerceptronLayer::Linear);
+
+   Tensor<type, 2> biases(1, 3);
+   biases.setValues({{-1, 0, 1}});
+
+   Tensor<type, 2> synaptic_weights(2, 3);
+   synaptic_weights.setValues({{1, 2, 3},{4, 5, 6}});
+
+   perceptron_layer.set_biases(biases);
+   perceptron_layer.set_synaptic_weights(synaptic_weights);
+
+   string expression = perceptron_layer.write_batch_expression_c();
+
+   // The weights of each input are contiguous
+
+   assert_true(expression.find("perceptron_layer_0_synaptic_weights[6] = {\n\t1, 2, 3, 4, 5, 6};") != string::npos, LOG);
+   assert_true(expression.find("perceptron_layer_0_biases[3] = {\n\t-1, 0, 1};") != string::npos, LOG);
+   assert_true(expression.find("static void perceptron_layer_0(const float* inputs, float* outputs, int batch_size)") != string::npos, LOG);
+   assert_true(expression.find("calculate_combinations(inputs, batch_size, 2, 3,") != string::npos, LOG);
+   assert_true(expression.find("tanhf") == string::npos, LOG);
+
+   // No unrolled weights
+
+   assert_true(expression.find("inputs[") == string::npos, LOG);
+
+   perceptron_layer.set_activation_function(PerceptronLayer::HyperbolicTangent);
+
+   expression = perceptron_layer.write_batch_expression_c();
+
+   assert_true(expression.find("outputs[i] = tanhf(x);") != string::npos, LOG);
+}
+
+
 
 void PerceptronLayerTest::run_test_case()
 {
@@ -1707,6 +2129,7 @@ void PerceptronLayerTest::run_test_case()
 
    test_calculate_activations();
    test_calculate_activations_derivatives();
+   test_calculate_activations_derivatives_batch();
 
 
    // Outputs
@@ -1714,9 +2137,17 @@ void PerceptronLayerTest::run_test_case()
    test_calculate_outputs();
 
 
+   // Pruning
+
+   test_prune_synaptic_weights();
+   test_calculate_sparse_combinations();
+
+
    // Forward propagate
 
    test_forward_propagate();
+   test_forward_propagate_tiles();
+   test_forward_propagate_sparse();
 
 
    // Delta methods
@@ -1733,6 +2164,7 @@ void PerceptronLayerTest::run_test_case()
    // Expression methods
 
    test_write_expression();
+   test_write_batch_expression_c();
 
 
    cout << "End of perceptron layer test case.\n";
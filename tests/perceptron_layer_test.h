@@ -104,14 +104,22 @@ public:
 
    void test_calculate_activations();
    void test_calculate_activations_derivatives();
+   void test_calculate_activations_derivatives_batch();
 
    // Outputs
 
    void test_calculate_outputs();
 
+   // Pruning
+
+   void test_prune_synaptic_weights();
+   void test_calculate_sparse_combinations();
+
    // Forward propagate
 
    void test_forward_propagate();
+   void test_forward_propagate_tiles();
+   void test_forward_propagate_sparse();
 
    // Hidden delta
 
@@ -125,6 +133,7 @@ public:
    // Expression methods
 
    void test_write_expression();
+   void test_write_batch_expression_c();
 
    // Unit testing methods
 
@@ -31,235 +31,184 @@ void PoolingLayerTest::test_destructor() // @todo
 
 }
 
-void PoolingLayerTest::test_calculate_average_pooling_outputs() // @todo
+void PoolingLayerTest::test_calculate_average_pooling_outputs()
 {
     cout << "test_calculate_average_pooling_outputs\n";
 
-//    PoolingLayer pooling_layer;
-
-//    Tensor<type, 2> inputs;
-//    Tensor<type, 2> outputs;
-
-//    // Test
-
-//    inputs.resize(({6,6,6,6}));
-
-//    pooling_layer.set_pool_size(1,1);
-//    pooling_layer.set_row_stride(1);
-//    pooling_layer.set_column_stride(1);
-
-//    outputs = pooling_layer.calculate_average_pooling_outputs(inputs);
-
-//    assert_true(outputs.dimension(0) == 6 &&
-//                outputs.dimension(1) == 6 &&
-//                outputs.dimension(2) == 6 &&
-//                outputs.dimension(3) == 6, LOG);
-
-//    // Test
-
-//    inputs.resize(({10,3,20,20}));
-
-//    pooling_layer.set_pool_size(2,2);
-//    pooling_layer.set_row_stride(1);
-//    pooling_layer.set_column_stride(1);
-
-//    outputs = pooling_layer.calculate_average_pooling_outputs(inputs);
-
-//    assert_true(outputs.dimension(0) == 10 &&
-//                outputs.dimension(1) == 3 &&
-//                outputs.dimension(2) == 19 &&
-//                outputs.dimension(3) == 19, LOG);
-
-//    // Test
-
-//    inputs.resize(({1,1,4,4}));
-//    inputs(0,0,0,0) = 1.0;
-//    inputs(0,0,0,1) = 2.0;
-//    inputs(0,0,0,2) = 3.0;
-//    inputs(0,0,0,3) = 4.0;
-//    inputs(0,0,1,0) = 16.0;
-//    inputs(0,0,1,1) = 9.0;
-//    inputs(0,0,1,2) = 4.0;
-//    inputs(0,0,1,3) = 1.0;
-//    inputs(0,0,2,0) = 1.0;
-//    inputs(0,0,2,1) = 8.0;
-//    inputs(0,0,2,2) = 27.0;
-//    inputs(0,0,2,3) = 64.0;
-//    inputs(0,0,3,0) = 256.0;
-//    inputs(0,0,3,1) = 81.0;
-//    inputs(0,0,3,2) = 16.0;
-//    inputs(0,0,3,3) = 1.0;
-
-//    pooling_layer.set_pool_size(2, 2);
-//    pooling_layer.set_row_stride(1);
-//    pooling_layer.set_column_stride(1);
-
-//    outputs = pooling_layer.calculate_average_pooling_outputs(inputs);
-
-//    assert_true(outputs.dimension(0) == 1 &&
-//                outputs.dimension(1) == 1 &&
-//                outputs.dimension(2) == 3 &&
-//                outputs.dimension(3) == 3 &&
-//                outputs(0,0,0,0) == 7.0 &&
-//                outputs(0,0,0,1) == 4.5 &&
-//                outputs(0,0,0,2) == 3.0 &&
-//                outputs(0,0,1,0) == 8.5 &&
-//                outputs(0,0,1,1) == 12.0 &&
-//                outputs(0,0,1,2) == 24.0 &&
-//                outputs(0,0,2,0) == 86.5 &&
-//                outputs(0,0,2,1) == 33.0 &&
-//                outputs(0,0,2,2) == 27.0, LOG);
-
-//    // Test
-
-//    inputs.resize(({1,1,4,4}));
-//    inputs(0,0,0,0) = 1.0;
-//    inputs(0,0,0,1) = 2.0;
-//    inputs(0,0,0,2) = 3.0;
-//    inputs(0,0,0,3) = 4.0;
-//    inputs(0,0,1,0) = 16.0;
-//    inputs(0,0,1,1) = 9.0;
-//    inputs(0,0,1,2) = 4.0;
-//    inputs(0,0,1,3) = 1.0;
-//    inputs(0,0,2,0) = 1.0;
-//    inputs(0,0,2,1) = 8.0;
-//    inputs(0,0,2,2) = 27.0;
-//    inputs(0,0,2,3) = 64.0;
-//    inputs(0,0,3,0) = 256.0;
-//    inputs(0,0,3,1) = 81.0;
-//    inputs(0,0,3,2) = 16.0;
-//    inputs(0,0,3,3) = 1.0;
-
-//    pooling_layer.set_pool_size(3, 3);
-//    pooling_layer.set_row_stride(1);
-//    pooling_layer.set_column_stride(1);
-
-//    outputs = pooling_layer.calculate_average_pooling_outputs(inputs);
-
-//    assert_true(outputs.dimension(0) == 1 &&
-//                outputs.dimension(1) == 1 &&
-//                outputs.dimension(2) == 2 &&
-//                outputs.dimension(3) == 2 &&
-//                outputs(0,0,0,0) - 7.8888 < 0.001 &&
-//                outputs(0,0,0,1) - 13.5555 < 0.001 &&
-//                outputs(0,0,1,0) - 46.4444 < 0.001 &&
-//                outputs(0,0,1,1) - 23.4444 < 0.001, LOG);
+    Tensor<Index, 1> inputs_dimensions(3);
+    inputs_dimensions.setValues({1, 4, 4});
+
+    Tensor<type, 4> inputs(1, 1, 4, 4);
+    inputs.setValues({{{{1.0, 2.0, 3.0, 4.0},
+                        {16.0, 9.0, 4.0, 1.0},
+                        {1.0, 8.0, 27.0, 64.0},
+                        {256.0, 81.0, 16.0, 1.0}}}});
+
+    PoolingLayer pooling_layer(inputs_dimensions);
+
+    Tensor<type, 4> outputs;
+
+    // Test
+
+    pooling_layer.set_pooling_method(PoolingLayer::AveragePooling);
+    pooling_layer.set_pool_size(2, 2);
+    pooling_layer.set_row_stride(1);
+    pooling_layer.set_column_stride(1);
+
+    outputs = pooling_layer.calculate_outputs(inputs);
+
+    assert_true(outputs.dimension(0) == 1 &&
+                outputs.dimension(1) == 1 &&
+                outputs.dimension(2) == 3 &&
+                outputs.dimension(3) == 3 &&
+                outputs(0,0,0,0) == 7.0 &&
+                outputs(0,0,0,1) == 4.5 &&
+                outputs(0,0,0,2) == 3.0 &&
+                outputs(0,0,1,0) == 8.5 &&
+                outputs(0,0,1,1) == 12.0 &&
+                outputs(0,0,1,2) == 24.0 &&
+                outputs(0,0,2,0) == 86.5 &&
+                outputs(0,0,2,1) == 33.0 &&
+                outputs(0,0,2,2) == 27.0, LOG);
+
+    // Test
+
+    pooling_layer.set_pool_size(2, 2);
+    pooling_layer.set_row_stride(2);
+    pooling_layer.set_column_stride(2);
+
+    outputs = pooling_layer.calculate_outputs(inputs);
+
+    assert_true(outputs.dimension(2) == 2 &&
+                outputs.dimension(3) == 2 &&
+                outputs(0,0,0,0) == 7.0 &&
+                outputs(0,0,0,1) == 3.0 &&
+                outputs(0,0,1,0) == 86.5 &&
+                outputs(0,0,1,1) == 27.0, LOG);
 }
 
 
-void PoolingLayerTest::test_calculate_max_pooling_outputs() // @todo
+void PoolingLayerTest::test_calculate_max_pooling_outputs()
 {
     cout << "test_calculate_max_pooling_outputs\n";
 
-//    PoolingLayer pooling_layer;
-
-//    Tensor<type, 2> inputs;
-//    Tensor<type, 2> outputs;
-
-//    // Test
-
-//    inputs.resize(({6,6,6,6}));
-
-//    pooling_layer.set_pool_size(1,1);
-//    pooling_layer.set_row_stride(1);
-//    pooling_layer.set_column_stride(1);
-
-//    outputs = pooling_layer.calculate_max_pooling_outputs(inputs);
-
-//    assert_true(outputs.dimension(0) == 6 &&
-//                outputs.dimension(1) == 6 &&
-//                outputs.dimension(2) == 6 &&
-//                outputs.dimension(3) == 6, LOG);
-
-//    // Test
-
-//    inputs.resize(({10,3,20,20}));
-
-//    pooling_layer.set_pool_size(2,2);
-//    pooling_layer.set_row_stride(1);
-//    pooling_layer.set_column_stride(1);
-
-//    outputs = pooling_layer.calculate_max_pooling_outputs(inputs);
-
-//    assert_true(outputs.dimension(0) == 10 &&
-//                outputs.dimension(1) == 3 &&
-//                outputs.dimension(2) == 19 &&
-//                outputs.dimension(3) == 19, LOG);
-
-//    // Test
-
-//    inputs.resize(({1,1,4,4}));
-//    inputs(0,0,0,0) = 1.0;
-//    inputs(0,0,0,1) = 2.0;
-//    inputs(0,0,0,2) = 3.0;
-//    inputs(0,0,0,3) = 4.0;
-//    inputs(0,0,1,0) = 16.0;
-//    inputs(0,0,1,1) = 9.0;
-//    inputs(0,0,1,2) = 4.0;
-//    inputs(0,0,1,3) = 1.0;
-//    inputs(0,0,2,0) = 1.0;
-//    inputs(0,0,2,1) = 8.0;
-//    inputs(0,0,2,2) = 27.0;
-//    inputs(0,0,2,3) = 64.0;
-//    inputs(0,0,3,0) = 256.0;
-//    inputs(0,0,3,1) = 81.0;
-//    inputs(0,0,3,2) = 16.0;
-//    inputs(0,0,3,3) = 1.0;
-
-//    pooling_layer.set_pool_size(2, 2);
-//    pooling_layer.set_row_stride(1);
-//    pooling_layer.set_column_stride(1);
-
-//    outputs = pooling_layer.calculate_max_pooling_outputs(inputs);
-
-//    assert_true(outputs.dimension(0) == 1 &&
-//                outputs.dimension(1) == 1 &&
-//                outputs.dimension(2) == 3 &&
-//                outputs.dimension(3) == 3 &&
-//                outputs(0,0,0,0) == 16.0 &&
-//                outputs(0,0,0,1) == 9.0 &&
-//                outputs(0,0,0,2) == 4.0 &&
-//                outputs(0,0,1,0) == 16.0 &&
-//                outputs(0,0,1,1) == 27.0 &&
-//                outputs(0,0,1,2) == 64.0 &&
-//                outputs(0,0,2,0) == 256.0 &&
-//                outputs(0,0,2,1) == 81.0 &&
-//                outputs(0,0,2,2) == 64.0, LOG);
-
-//    // Test
-
-//    inputs.resize(({1,1,4,4}));
-//    inputs(0,0,0,0) = 1.0;
-//    inputs(0,0,0,1) = 2.0;
-//    inputs(0,0,0,2) = 3.0;
-//    inputs(0,0,0,3) = 4.0;
-//    inputs(0,0,1,0) = -16.0;
-//    inputs(0,0,1,1) = -9.0;
-//    inputs(0,0,1,2) = -4.0;
-//    inputs(0,0,1,3) = -1.0;
-//    inputs(0,0,2,0) = 1.0;
-//    inputs(0,0,2,1) = 8.0;
-//    inputs(0,0,2,2) = 27.0;
-//    inputs(0,0,2,3) = 64.0;
-//    inputs(0,0,3,0) = -256.0;
-//    inputs(0,0,3,1) = -81.0;
-//    inputs(0,0,3,2) = -16.0;
-//    inputs(0,0,3,3) = -1.0;
-
-//    pooling_layer.set_pool_size(3, 3);
-//    pooling_layer.set_row_stride(1);
-//    pooling_layer.set_column_stride(1);
-
-//    outputs = pooling_layer.calculate_max_pooling_outputs(inputs);
-
-//    assert_true(outputs.dimension(0) == 1 &&
-//                outputs.dimension(1) == 1 &&
-//                outputs.dimension(2) == 2 &&
-//                outputs.dimension(3) == 2 &&
-//                outputs(0,0,0,0) == 27.0 &&
-//                outputs(0,0,0,1) == 64.0 &&
-//                outputs(0,0,1,0) == 27.0 &&
-//                outputs(0,0,1,1) == 64.0, LOG);
+    Tensor<Index, 1> inputs_dimensions(3);
+    inputs_dimensions.setValues({1, 4, 4});
+
+    Tensor<type, 4> inputs(1, 1, 4, 4);
+    inputs.setValues({{{{1.0, 2.0, 3.0, 4.0},
+                        {16.0, 9.0, 4.0, 1.0},
+                        {1.0, 8.0, 27.0, 64.0},
+                        {256.0, 81.0, 16.0, 1.0}}}});
+
+    PoolingLayer pooling_layer(inputs_dimensions);
+
+    Tensor<type, 4> outputs;
+
+    // Test
+
+    pooling_layer.set_pooling_method(PoolingLayer::MaxPooling);
+    pooling_layer.set_pool_size(2, 2);
+    pooling_layer.set_row_stride(1);
+    pooling_layer.set_column_stride(1);
+
+    outputs = pooling_layer.calculate_outputs(inputs);
+
+    assert_true(outputs.dimension(0) == 1 &&
+                outputs.dimension(1) == 1 &&
+                outputs.dimension(2) == 3 &&
+                outputs.dimension(3) == 3 &&
+                outputs(0,0,0,0) == 16.0 &&
+                outputs(0,0,0,1) == 9.0 &&
+                outputs(0,0,0,2) == 4.0 &&
+                outputs(0,0,1,0) == 16.0 &&
+                outputs(0,0,1,1) == 27.0 &&
+                outputs(0,0,1,2) == 64.0 &&
+                outputs(0,0,2,0) == 256.0 &&
+                outputs(0,0,2,1) == 81.0 &&
+                outputs(0,0,2,2) == 64.0, LOG);
+
+    // Test
+
+    pooling_layer.set_pool_size(3, 3);
+
+    outputs = pooling_layer.calculate_outputs(inputs);
+
+    assert_true(outputs.dimension(2) == 2 &&
+                outputs.dimension(3) == 2 &&
+                outputs(0,0,0,0) == 27.0 &&
+                outputs(0,0,0,1) == 64.0 &&
+                outputs(0,0,1,0) == 256.0 &&
+                outputs(0,0,1,1) == 81.0, LOG);
+}
+
+
+void PoolingLayerTest::test_calculate_inputs_delta()
+{
+    cout << "test_calculate_inputs_delta\n";
+
+    Tensor<Index, 1> inputs_dimensions(3);
+    inputs_dimensions.setValues({1, 4, 4});
+
+    Tensor<type, 4> inputs(1, 1, 4, 4);
+    inputs.setValues({{{{1.0, 2.0, 3.0, 4.0},
+                        {16.0, 9.0, 4.0, 1.0},
+                        {1.0, 8.0, 27.0, 64.0},
+                        {256.0, 81.0, 16.0, 1.0}}}});
+
+    PoolingLayer pooling_layer(inputs_dimensions);
+
+    Layer::ForwardPropagation forward_propagation;
+
+    Tensor<type, 2> outputs_delta;
+    Tensor<type, 2> inputs_delta;
+
+    // Test
+
+    pooling_layer.set_pooling_method(PoolingLayer::MaxPooling);
+    pooling_layer.set_pool_size(2, 2);
+    pooling_layer.set_row_stride(2);
+    pooling_layer.set_column_stride(2);
+
+    forward_propagation.set(1, &pooling_layer);
+
+    pooling_layer.forward_propagate(inputs, forward_propagation);
+
+    outputs_delta.resize(1, 4);
+    outputs_delta.setValues({{1.0, 2.0, 3.0, 4.0}});
+
+    pooling_layer.calculate_inputs_delta(forward_propagation, outputs_delta, inputs_delta);
+
+    // Maxima are 16 at (1,0), 256 at (3,0), 4 at (1,2) and 64 at (2,3)
+
+    assert_true(inputs_delta.dimension(1) == 16 &&
+                inputs_delta(0, 1) == 1.0 &&
+                inputs_delta(0, 3) == 2.0 &&
+                inputs_delta(0, 9) == 3.0 &&
+                inputs_delta(0, 14) == 4.0, LOG);
+
+    const Tensor<type, 0> max_pooling_sum = inputs_delta.sum();
+
+    assert_true(max_pooling_sum(0) == 10.0, LOG);
+
+    // Test
+
+    pooling_layer.set_pooling_method(PoolingLayer::AveragePooling);
+    pooling_layer.set_row_stride(1);
+    pooling_layer.set_column_stride(1);
+
+    forward_propagation.set(1, &pooling_layer);
+
+    pooling_layer.forward_propagate(inputs, forward_propagation);
+
+    outputs_delta.resize(1, 9);
+    outputs_delta.setConstant(4.0);
+
+    pooling_layer.calculate_inputs_delta(forward_propagation, outputs_delta, inputs_delta);
+
+    assert_true(inputs_delta(0, 0) == 1.0 &&
+                inputs_delta(0, 5) == 4.0 &&
+                inputs_delta(0, 15) == 1.0, LOG);
 }
 
 
@@ -277,6 +226,10 @@ void PoolingLayerTest::run_test_case() // @todo
     test_calculate_average_pooling_outputs();
     test_calculate_max_pooling_outputs();
 
+//    // Back-propagation
+
+    test_calculate_inputs_delta();
+
    cout << "End of pooling layer test case.\n";
 }
 
@@ -36,6 +36,10 @@ public:
    void test_calculate_average_pooling_outputs();
    void test_calculate_max_pooling_outputs();
 
+   // Back-propagation methods
+
+   void test_calculate_inputs_delta();
+
    // Unit testing methods
 
    void run_test_case();
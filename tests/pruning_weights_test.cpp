@@ -0,0 +1,338 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   P R U N I N G   W E I G H T S   T E S T   C L A S S
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#include "pruning_weights_test.h"
+
+
+PruningWeightsTest::PruningWeightsTest() : UnitTesting()
+{
+}
+
+
+PruningWeightsTest::~PruningWeightsTest()
+{
+}
+
+
+void PruningWeightsTest::test_constructor()
+{
+    cout << "test_constructor\n";
+
+    NeuralNetwork neural_network;
+    DataSet data_set;
+
+    TrainingStrategy training_strategy(&neural_network, &data_set);
+
+    PruningWeights pruning_weights_1(&training_strategy);
+
+    assert_true(pruning_weights_1.has_training_strategy(), LOG);
+
+    PruningWeights pruning_weights_2;
+
+    assert_true(!pruning_weights_2.has_training_strategy(), LOG);
+    assert_true(pruning_weights_2.get_pruning_method() == PruningWeights::MagnitudePruning, LOG);
+}
+
+
+void PruningWeightsTest::test_prune_synaptic_weights()
+{
+    cout << "test_prune_synaptic_weights\n";
+
+    Tensor<Index, 1> architecture(4);
+    architecture.setValues({6, 20, 10, 1});
+
+    NeuralNetwork neural_network(NeuralNetwork::Approximation, architecture);
+
+    neural_network.set_parameters_random();
+
+    DataSet data_set;
+
+    TrainingStrategy training_strategy(&neural_network, &data_set);
+
+    PruningWeights pruning_weights(&training_strategy);
+
+    pruning_weights.set_sparse_block_size(1);
+
+    pruning_weights.prune_synaptic_weights(static_cast<type>(0.8));
+
+    const Tensor<Layer*, 1> trainable_layers_pointers = neural_network.get_trainable_layers_pointers();
+
+    for(Index i = 0; i < trainable_layers_pointers.size(); i++)
+    {
+        const PerceptronLayer* perceptron_layer_pointer = static_cast<PerceptronLayer*>(trainable_layers_pointers(i));
+
+        assert_true(perceptron_layer_pointer->is_pruned(), LOG);
+        assert_true(abs(perceptron_layer_pointer->calculate_sparsity() - static_cast<type>(0.8)) < static_cast<type>(1.0e-6), LOG);
+    }
+
+    // Test the sparse outputs against a neural network which is not pruned
+
+    NeuralNetwork dense_neural_network(NeuralNetwork::Approximation, architecture);
+
+    Tensor<type, 1> parameters = neural_network.get_parameters();
+
+    dense_neural_network.set_parameters(parameters);
+
+    Tensor<type, 2> inputs(30, 6);
+    inputs.setRandom();
+
+    const Tensor<type, 0> outputs_difference
+            = (neural_network.calculate_outputs(inputs) - dense_neural_network.calculate_outputs(inputs)).abs().maximum();
+
+    assert_true(outputs_difference(0) < static_cast<type>(1.0e-5), LOG);
+}
+
+
+void PruningWeightsTest::test_prune_neurons()
+{
+    cout << "test_prune_neurons\n";
+
+    Tensor<Index, 1> architecture(3);
+    architecture.setValues({4, 8, 3});
+
+    NeuralNetwork neural_network(NeuralNetwork::Classification, architecture);
+
+    neural_network.set_parameters_random();
+
+    // The first neurons have no effect on the outputs
+
+    ProbabilisticLayer* probabilistic_layer_pointer = static_cast<ProbabilisticLayer*>(neural_network.get_trainable_layers_pointers()(1));
+
+    Tensor<type, 2> synaptic_weights = probabilistic_layer_pointer->get_synaptic_weights();
+
+    for(Index i = 0; i < 4; i++)
+    {
+        for(Index j = 0; j < 3; j++)
+        {
+            synaptic_weights(i,j) = 0;
+        }
+    }
+
+    probabilistic_layer_pointer->set_synaptic_weights(synaptic_weights);
+
+    Tensor<type, 2> inputs(10, 4);
+    inputs.setRandom();
+
+    const Tensor<type, 2> outputs = neural_network.calculate_outputs(inputs);
+
+    DataSet data_set;
+
+    TrainingStrategy training_strategy(&neural_network, &data_set);
+
+    PruningWeights pruning_weights(&training_strategy);
+
+    Tensor<Index, 1> initial_neurons_numbers(2);
+    initial_neurons_numbers.setValues({8, 3});
+
+    pruning_weights.prune_neurons(static_cast<type>(0.5), initial_neurons_numbers);
+
+    assert_true(neural_network.get_trainable_layers_pointers()(0)->get_neurons_number() == 4, LOG);
+    assert_true(neural_network.get_trainable_layers_pointers()(1)->get_inputs_number() == 4, LOG);
+    assert_true(neural_network.get_parameters_number() == 35, LOG);
+
+    const Tensor<type, 0> outputs_difference = (neural_network.calculate_outputs(inputs) - outputs).abs().maximum();
+
+    assert_true(outputs_difference(0) < static_cast<type>(1.0e-6), LOG);
+}
+
+
+void PruningWeightsTest::test_perform_weights_pruning()
+{
+    cout << "test_perform_weights_pruning\n";
+
+    DataSet data_set(100, 4);
+
+    data_set.set_data_random();
+
+    Tensor<Index, 1> architecture(3);
+    architecture.setValues({3, 8, 1});
+
+    NeuralNetwork neural_network(NeuralNetwork::Approximation, architecture);
+
+    neural_network.set_parameters_random();
+
+    TrainingStrategy training_strategy(&neural_network, &data_set);
+
+    training_strategy.set_loss_method(TrainingStrategy::MEAN_SQUARED_ERROR);
+    training_strategy.set_optimization_method(TrainingStrategy::ADAPTIVE_MOMENT_ESTIMATION);
+    training_strategy.set_maximum_epochs_number(10);
+    training_strategy.set_display(false);
+
+    PruningWeights pruning_weights(&training_strategy);
+
+    pruning_weights.set_display(false);
+
+    // Magnitude pruning with fine tuning
+
+    pruning_weights.set_sparsity(static_cast<type>(0.5));
+    pruning_weights.set_sparse_block_size(1);
+    pruning_weights.set_pruning_steps_number(2);
+
+    PruningWeights::PruningWeightsResults results = pruning_weights.perform_weights_pruning();
+
+    assert_true(results.pruned_synaptic_weights_number == 16, LOG);
+    assert_true(abs(results.sparsity - static_cast<type>(0.5)) < static_cast<type>(1.0e-6), LOG);
+    assert_true(results.final_parameters_number == results.initial_parameters_number, LOG);
+
+    // The pruned synaptic weights remain zero after the training
+
+    const Tensor<Layer*, 1> trainable_layers_pointers = neural_network.get_trainable_layers_pointers();
+
+    for(Index k = 0; k < trainable_layers_pointers.size(); k++)
+    {
+        const PerceptronLayer* perceptron_layer_pointer = static_cast<PerceptronLayer*>(trainable_layers_pointers(k));
+
+        const Tensor<bool, 2>& pruning_mask = perceptron_layer_pointer->get_pruning_mask();
+        const Tensor<type, 2>& synaptic_weights = perceptron_layer_pointer->get_synaptic_weights();
+
+        for(Index i = 0; i < synaptic_weights.dimension(0); i++)
+        {
+            for(Index j = 0; j < synaptic_weights.dimension(1); j++)
+            {
+                if(!pruning_mask(i,j)) assert_true(synaptic_weights(i,j) == 0, LOG);
+            }
+        }
+    }
+
+    // Magnitude pruning with fine tuning by optimizers whose training direction mixes the gradient entries
+
+    Tensor<TrainingStrategy::OptimizationMethod, 1> optimization_methods(2);
+    optimization_methods.setValues({TrainingStrategy::QUASI_NEWTON_METHOD, TrainingStrategy::LEVENBERG_MARQUARDT_ALGORITHM});
+
+    for(Index m = 0; m < optimization_methods.size(); m++)
+    {
+        neural_network.set(NeuralNetwork::Approximation, architecture);
+
+        neural_network.set_parameters_random();
+
+        training_strategy.set_optimization_method(optimization_methods(m));
+
+        results = pruning_weights.perform_weights_pruning();
+
+        assert_true(results.pruned_synaptic_weights_number == 16, LOG);
+
+        const OptimizationAlgorithm::Results training_results = training_strategy.perform_training();
+
+        const Tensor<Layer*, 1> layers_pointers = neural_network.get_trainable_layers_pointers();
+
+        Index index = 0;
+
+        for(Index k = 0; k < layers_pointers.size(); k++)
+        {
+            const PerceptronLayer* perceptron_layer_pointer = static_cast<PerceptronLayer*>(layers_pointers(k));
+
+            const Tensor<bool, 2>& pruning_mask = perceptron_layer_pointer->get_pruning_mask();
+            const Tensor<type, 2>& synaptic_weights = perceptron_layer_pointer->get_synaptic_weights();
+
+            const Index biases_number = perceptron_layer_pointer->get_biases_number();
+
+            for(Index i = 0; i < pruning_mask.size(); i++)
+            {
+                if(pruning_mask(i)) continue;
+
+                assert_true(synaptic_weights(i) == 0, LOG);
+                assert_true(training_results.final_parameters(index + biases_number + i) == 0, LOG);
+            }
+
+            index += perceptron_layer_pointer->get_parameters_number();
+        }
+    }
+
+    training_strategy.set_optimization_method(TrainingStrategy::ADAPTIVE_MOMENT_ESTIMATION);
+
+    // Neurons pruning with fine tuning
+
+    neural_network.set(NeuralNetwork::Approximation, architecture);
+
+    neural_network.set_parameters_random();
+
+    pruning_weights.set_pruning_method(PruningWeights::NeuronsPruning);
+
+    results = pruning_weights.perform_weights_pruning();
+
+    assert_true(neural_network.get_trainable_layers_pointers()(0)->get_neurons_number() == 4, LOG);
+    assert_true(results.initial_parameters_number == 41, LOG);
+    assert_true(results.final_parameters_number == 21, LOG);
+    assert_true(results.pruned_synaptic_weights_number == 0, LOG);
+}
+
+
+void PruningWeightsTest::test_from_XML()
+{
+    cout << "test_from_XML\n";
+
+    PruningWeights pruning_weights;
+
+    pruning_weights.set_pruning_method(PruningWeights::NeuronsPruning);
+    pruning_weights.set_sparsity(static_cast<type>(0.75));
+    pruning_weights.set_sparse_block_size(8);
+    pruning_weights.set_fine_tuning(false);
+    pruning_weights.set_pruning_steps_number(3);
+
+    tinyxml2::XMLPrinter printer;
+
+    pruning_weights.write_XML(printer);
+
+    tinyxml2::XMLDocument document;
+
+    document.Parse(printer.CStr());
+
+    PruningWeights pruning_weights_2;
+
+    pruning_weights_2.from_XML(document);
+
+    assert_true(pruning_weights_2.get_pruning_method() == PruningWeights::NeuronsPruning, LOG);
+    assert_true(abs(pruning_weights_2.get_sparsity() - static_cast<type>(0.75)) < static_cast<type>(1.0e-6), LOG);
+    assert_true(pruning_weights_2.get_sparse_block_size() == 8, LOG);
+    assert_true(!pruning_weights_2.get_fine_tuning(), LOG);
+    assert_true(pruning_weights_2.get_pruning_steps_number() == 3, LOG);
+}
+
+
+void PruningWeightsTest::run_test_case()
+{
+   cout << "Running pruning weights test case...\n";
+
+   // Constructor and destructor
+
+   test_constructor();
+
+
+   // Pruning methods
+
+   test_prune_synaptic_weights();
+   test_prune_neurons();
+
+   test_perform_weights_pruning();
+
+
+   // Serialization methods
+
+   test_from_XML();
+
+
+   cout << "End of pruning weights test case.\n";
+}
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright (C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
@@ -0,0 +1,335 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   Q U A N T I Z E D   N E U R A L   N E T W O R K   T E S T   C L A S S
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#include "quantized_neural_network_test.h"
+
+
+QuantizedNeuralNetworkTest::QuantizedNeuralNetworkTest() : UnitTesting()
+{
+}
+
+
+QuantizedNeuralNetworkTest::~QuantizedNeuralNetworkTest()
+{
+}
+
+
+void QuantizedNeuralNetworkTest::test_constructor()
+{
+    cout << "test_constructor\n";
+
+    // Default constructor
+
+    QuantizedNeuralNetwork quantized_neural_network_1;
+
+    assert_true(quantized_neural_network_1.get_neural_network_pointer() == nullptr, LOG);
+    assert_true(quantized_neural_network_1.get_quantized_layers_number() == 0, LOG);
+
+    // Neural network constructor
+
+    NeuralNetwork neural_network;
+
+    QuantizedNeuralNetwork quantized_neural_network_2(&neural_network);
+
+    assert_true(quantized_neural_network_2.get_neural_network_pointer() == &neural_network, LOG);
+    assert_true(quantized_neural_network_2.get_quantized_layers_number() == 0, LOG);
+}
+
+
+void QuantizedNeuralNetworkTest::test_quantize()
+{
+    cout << "test_quantize\n";
+
+    Tensor<Index, 1> architecture(3);
+    architecture.setValues({40, 8, 3});
+
+    NeuralNetwork neural_network(NeuralNetwork::Classification, architecture);
+
+    neural_network.set_parameters_random();
+
+    Tensor<type, 2> inputs(50, 40);
+    inputs.setRandom();
+
+    QuantizedNeuralNetwork quantized_neural_network(&neural_network);
+
+    quantized_neural_network.set_display(false);
+
+    quantized_neural_network.quantize(inputs);
+
+    const Tensor<QuantizedNeuralNetwork::QuantizedLayer, 1>& quantized_layers = quantized_neural_network.get_quantized_layers();
+
+    assert_true(quantized_layers.size() == 2, LOG);
+    assert_true(quantized_layers(0).layer_index == 1, LOG);
+    assert_true(quantized_layers(1).layer_index == 2, LOG);
+
+    assert_true(quantized_layers(0).weights.dimension(0) == 40, LOG);
+    assert_true(quantized_layers(0).weights.dimension(1) == 8, LOG);
+    assert_true(quantized_layers(1).weights.dimension(0) == 8, LOG);
+    assert_true(quantized_layers(1).weights.dimension(1) == 3, LOG);
+
+    // Each neuron uses the whole range
+
+    for(Index j = 0; j < 8; j++)
+    {
+        Index maximum_weight = 0;
+
+        for(Index k = 0; k < 40; k++)
+        {
+            maximum_weight = max(maximum_weight, static_cast<Index>(abs(quantized_layers(0).weights(k,j))));
+        }
+
+        assert_true(maximum_weight == 127, LOG);
+    }
+
+    // Outputs
+
+    const Tensor<type, 2> float_outputs = neural_network.calculate_outputs(inputs);
+    const Tensor<type, 2> quantized_outputs = quantized_neural_network.calculate_outputs(inputs);
+
+    assert_true(quantized_outputs.dimension(0) == 50, LOG);
+    assert_true(quantized_outputs.dimension(1) == 3, LOG);
+
+    const Tensor<type, 0> maximum_difference = (quantized_outputs - float_outputs).abs().maximum();
+
+    assert_true(maximum_difference(0) < static_cast<type>(0.05), LOG);
+}
+
+
+void QuantizedNeuralNetworkTest::test_calculate_outputs()
+{
+    cout << "test_calculate_outputs\n";
+
+    // Test with values which are exactly representable
+
+    NeuralNetwork neural_network;
+
+    PerceptronLayer* perceptron_layer_pointer = new PerceptronLayer(2, 1);
+
+    perceptron_layer_pointer->set_activation_function(PerceptronLayer::Linear);
+
+    Tensor<type, 1> parameters(3);
+    parameters.setValues({static_cast<type>(0.25), static_cast<type>(1.27), static_cast<type>(0.27)});
+
+    perceptron_layer_pointer->set_parameters(parameters);
+
+    neural_network.add_layer(perceptron_layer_pointer);
+
+    Tensor<type, 2> calibration_inputs(1, 2);
+    calibration_inputs.setValues({{static_cast<type>(1.27), static_cast<type>(-0.5)}});
+
+    QuantizedNeuralNetwork quantized_neural_network(&neural_network);
+
+    quantized_neural_network.quantize(calibration_inputs);
+
+    const QuantizedNeuralNetwork::QuantizedLayer& quantized_layer = quantized_neural_network.get_quantized_layers()(0);
+
+    assert_true(abs(quantized_layer.inputs_scale - static_cast<type>(0.01)) < static_cast<type>(1.0e-12), LOG);
+    assert_true(quantized_layer.weights(0,0) == 127, LOG);
+    assert_true(quantized_layer.weights(1,0) == 27, LOG);
+
+    Tensor<type, 2> inputs(2, 2);
+    inputs.setValues({{static_cast<type>(0.5), static_cast<type>(1)},
+                      {static_cast<type>(-1), static_cast<type>(0.1)}});
+
+    const Tensor<type, 2> outputs = quantized_neural_network.calculate_outputs(inputs);
+
+    assert_true(abs(outputs(0,0) - static_cast<type>(1.155)) < static_cast<type>(1.0e-12), LOG);
+    assert_true(abs(outputs(1,0) - static_cast<type>(-0.993)) < static_cast<type>(1.0e-12), LOG);
+
+    // Inputs out of the calibrated range saturate
+
+    inputs.setValues({{static_cast<type>(10), static_cast<type>(0)},
+                      {static_cast<type>(-10), static_cast<type>(0)}});
+
+    const Tensor<type, 2> saturated_outputs = quantized_neural_network.calculate_outputs(inputs);
+
+    assert_true(abs(saturated_outputs(0,0) - static_cast<type>(0.25 + 1.27*1.27)) < static_cast<type>(1.0e-12), LOG);
+    assert_true(abs(saturated_outputs(1,0) - static_cast<type>(0.25 - 1.27*1.27)) < static_cast<type>(1.0e-12), LOG);
+}
+
+
+
+void QuantizedNeuralNetworkTest::test_calculate_outputs_vectorized()
+{
+    cout << "test_calculate_outputs_vectorized\n";
+
+    // The number of inputs is not a multiple of sixteen, so that the vectorized products also have a remainder
+
+    const Index inputs_number = 37;
+    const Index neurons_number = 5;
+    const Index instances_number = 9;
+
+    NeuralNetwork neural_network;
+
+    PerceptronLayer* perceptron_layer_pointer = new PerceptronLayer(inputs_number, neurons_number);
+
+    perceptron_layer_pointer->set_activation_function(PerceptronLayer::Linear);
+    perceptron_layer_pointer->set_parameters_random();
+
+    neural_network.add_layer(perceptron_layer_pointer);
+
+    Tensor<type, 2> inputs(instances_number, inputs_number);
+    inputs.setRandom();
+
+    QuantizedNeuralNetwork quantized_neural_network(&neural_network);
+
+    quantized_neural_network.set_display(false);
+
+    quantized_neural_network.quantize(inputs);
+
+    assert_true(quantized_neural_network.get_vectorized(), LOG);
+
+    const Tensor<type, 2> vectorized_outputs = quantized_neural_network.calculate_outputs(inputs);
+
+    quantized_neural_network.set_vectorized(false);
+
+    const Tensor<type, 2> outputs = quantized_neural_network.calculate_outputs(inputs);
+
+    // The products are accumulated exactly in integers, so both ways give the same outputs
+
+    for(Index i = 0; i < instances_number; i++)
+    {
+        for(Index j = 0; j < neurons_number; j++)
+        {
+            assert_true(vectorized_outputs(i,j) == outputs(i,j), LOG);
+        }
+    }
+
+    const Tensor<type, 2> float_outputs = neural_network.calculate_outputs(inputs);
+
+    const Tensor<type, 0> maximum_difference = (outputs - float_outputs).abs().maximum();
+
+    assert_true(maximum_difference(0) < static_cast<type>(0.5), LOG);
+}
+
+void QuantizedNeuralNetworkTest::test_calculate_quantization_results()
+{
+    cout << "test_calculate_quantization_results\n";
+
+    DataSet data_set(200, 6);
+
+    data_set.set_data_random();
+
+    Tensor<Index, 1> architecture(3);
+    architecture.setValues({5, 6, 1});
+
+    NeuralNetwork neural_network(NeuralNetwork::Classification, architecture);
+
+    neural_network.set_parameters_random();
+
+    QuantizedNeuralNetwork quantized_neural_network(&neural_network);
+
+    quantized_neural_network.set_display(false);
+    quantized_neural_network.set_calibration_instances_number(50);
+
+    quantized_neural_network.quantize(&data_set);
+
+    const QuantizedNeuralNetwork::QuantizationResults quantization_results
+            = quantized_neural_network.calculate_quantization_results(&data_set);
+
+    assert_true(quantization_results.maximum_outputs_difference < static_cast<type>(0.05), LOG);
+    assert_true(quantization_results.mean_outputs_difference <= quantization_results.maximum_outputs_difference, LOG);
+    assert_true(quantization_results.decisions_agreement > static_cast<type>(0.9), LOG);
+    assert_true(abs(quantization_results.quantized_testing_error - quantization_results.float_testing_error)
+                < static_cast<type>(0.05)*quantization_results.float_testing_error, LOG);
+}
+
+
+void QuantizedNeuralNetworkTest::test_from_XML()
+{
+    cout << "test_from_XML\n";
+
+    Tensor<Index, 1> architecture(3);
+    architecture.setValues({4, 5, 2});
+
+    NeuralNetwork neural_network(NeuralNetwork::Classification, architecture);
+
+    neural_network.set_parameters_random();
+
+    Tensor<type, 2> inputs(10, 4);
+    inputs.setRandom();
+
+    QuantizedNeuralNetwork quantized_neural_network(&neural_network);
+
+    quantized_neural_network.set_display(false);
+
+    quantized_neural_network.quantize(inputs);
+
+    tinyxml2::XMLPrinter printer;
+
+    quantized_neural_network.write_XML(printer);
+
+    tinyxml2::XMLDocument document;
+
+    document.Parse(printer.CStr());
+
+    QuantizedNeuralNetwork quantized_neural_network_2;
+
+    quantized_neural_network_2.from_XML(document);
+
+    quantized_neural_network_2.set_neural_network_pointer(&neural_network);
+
+    assert_true(quantized_neural_network_2.get_quantized_layers_number() == 2, LOG);
+
+    const Tensor<type, 0> outputs_difference
+            = (quantized_neural_network_2.calculate_outputs(inputs) - quantized_neural_network.calculate_outputs(inputs)).abs().maximum();
+
+    assert_true(outputs_difference(0) < static_cast<type>(1.0e-12), LOG);
+}
+
+
+void QuantizedNeuralNetworkTest::run_test_case()
+{
+   cout << "Running quantized neural network test case...\n";
+
+   // Constructor and destructor
+
+   test_constructor();
+
+
+   // Quantization methods
+
+   test_quantize();
+
+
+   // Outputs
+
+   test_calculate_outputs();
+   test_calculate_outputs_vectorized();
+
+
+   // Accuracy methods
+
+   test_calculate_quantization_results();
+
+
+   // Serialization methods
+
+   test_from_XML();
+
+
+   cout << "End of quantized neural network test case.\n";
+}
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright (C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
@@ -489,6 +489,81 @@ void RecurrentLayerTest::test_calculate_outputs()
    parameters = recurrent_layer.get_parameters();
 
    Tensor<type, 2> outputs = recurrent_layer.calculate_outputs(inputs);
+
+   const type first_output = log(static_cast<type>(1.0) + exp(static_cast<type>(3.0)));
+   const type second_output = log(static_cast<type>(1.0) + exp(static_cast<type>(3.0) + static_cast<type>(2.0)*first_output));
+
+   assert_true(outputs.dimension(0) == instances, LOG);
+   assert_true(abs(outputs(0,0) - first_output) < static_cast<type>(1.0e-6), LOG);
+   assert_true(abs(outputs(1,1) - second_output) < static_cast<type>(1.0e-6), LOG);
+
+   // Test independent sequences
+
+   inputs.resize(6,2);
+   inputs.setConstant(1.0);
+
+   outputs = recurrent_layer.calculate_outputs(inputs);
+
+   assert_true(abs(outputs(3,0) - first_output) < static_cast<type>(1.0e-6), LOG);
+   assert_true(abs(outputs(4,1) - second_output) < static_cast<type>(1.0e-6), LOG);
+}
+
+
+void RecurrentLayerTest::test_calculate_error_gradient()
+{
+   cout << "test_calculate_error_gradient\n";
+
+   RecurrentLayer recurrent_layer(2, 3);
+
+   recurrent_layer.set_timesteps(3);
+
+   recurrent_layer.set_parameters_random();
+
+   const Index instances_number = 7;
+   const Index parameters_number = recurrent_layer.get_parameters_number();
+
+   Tensor<type, 2> inputs(instances_number, 2);
+   inputs.setRandom();
+
+   Tensor<type, 2> outputs_gradient(instances_number, 3);
+   outputs_gradient.setRandom();
+
+   // The error is the sum of the outputs weighted by the outputs gradient
+
+   Layer::ForwardPropagation forward_propagation(instances_number, &recurrent_layer);
+
+   recurrent_layer.forward_propagate(inputs, forward_propagation);
+
+   Tensor<type, 2> deltas(instances_number, 3);
+
+   recurrent_layer.calculate_output_delta(forward_propagation, outputs_gradient, deltas);
+
+   const Tensor<type, 1> error_gradient = recurrent_layer.calculate_error_gradient(inputs, forward_propagation, deltas);
+
+   assert_true(error_gradient.size() == parameters_number, LOG);
+
+   const Tensor<type, 1> parameters = recurrent_layer.get_parameters();
+
+   const type h = static_cast<type>(1.0e-6);
+
+   Tensor<type, 1> perturbed_parameters;
+   Tensor<type, 0> forward_error;
+   Tensor<type, 0> backward_error;
+
+   for(Index i = 0; i < parameters_number; i++)
+   {
+       perturbed_parameters = parameters;
+
+       perturbed_parameters(i) += h;
+       recurrent_layer.set_parameters(perturbed_parameters);
+       forward_error = (recurrent_layer.calculate_outputs(inputs)*outputs_gradient).sum();
+
+       perturbed_parameters(i) -= static_cast<type>(2.0)*h;
+       recurrent_layer.set_parameters(perturbed_parameters);
+       backward_error = (recurrent_layer.calculate_outputs(inputs)*outputs_gradient).sum();
+
+       assert_true(abs(error_gradient(i) - (forward_error(0) - backward_error(0))/(static_cast<type>(2.0)*h)) < static_cast<type>(1.0e-6), LOG);
+   }
 }
 
 
@@ -525,6 +600,8 @@ void RecurrentLayerTest::run_test_case()
    test_calculate_combinations();
    test_calculate_outputs();
 
+   test_calculate_error_gradient();
+
    cout << "End of recurrent layer test case.\n";
 }
 
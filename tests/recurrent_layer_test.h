@@ -59,6 +59,8 @@ public:
    void test_calculate_combinations();
    void test_calculate_outputs();
 
+   void test_calculate_error_gradient();
+
    // Unit testing methods
 
    void run_test_case();
@@ -383,7 +383,6 @@ void SumSquaredErrorTest::test_calculate_output_gradient() // @todo
 //   neural_network.set();
 
 //   RecurrentLayer* recurrent_layer = new RecurrentLayer(inputs_number, outputs_number);
-//   recurrent_layer->initialize_hidden_states(0.0);
 //   recurrent_layer->set_timesteps(10);
 //   neural_network.add_layer(recurrent_layer);
 
@@ -544,7 +543,6 @@ void SumSquaredErrorTest::test_calculate_error_gradient()
 
     RecurrentLayer* recurrent_layer = new RecurrentLayer(inputs_number, hidden_neurons);
 
-    recurrent_layer->initialize_hidden_states(0.0);
     recurrent_layer->set_timesteps(10);
 
     neural_network.add_layer(recurrent_layer);
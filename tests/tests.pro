@@ -27,6 +27,7 @@ SOURCES += \
     scaling_layer_test.cpp \
     probabilistic_layer_test.cpp \
     perceptron_layer_test.cpp \
+    low_rank_perceptron_layer_test.cpp \
     long_short_term_memory_layer_test.cpp \
     recurrent_layer_test.cpp \
     neural_network_test.cpp \
@@ -43,14 +44,25 @@ SOURCES += \
     levenberg_marquardt_algorithm_test.cpp \
     gradient_descent_test.cpp \
     conjugate_gradient_test.cpp \
+    training_checkpoint_test.cpp \
+    training_profiler_test.cpp \
+    training_observer_test.cpp \
+    training_scheduler_test.cpp \
+    cross_validation_test.cpp \
+    batch_predictor_test.cpp \
+    model_server_test.cpp \
+    gradient_checker_test.cpp \
     model_selection_test.cpp \
     neurons_selection_test.cpp \
     incremental_neurons_test.cpp \
     inputs_selection_test.cpp \
     growing_inputs_test.cpp \
     pruning_inputs_test.cpp \
+    pruning_weights_test.cpp \
+    layers_folding_test.cpp \
     genetic_algorithm_test.cpp \
     testing_analysis_test.cpp \
+    quantized_neural_network_test.cpp \
     numerical_differentiation_test.cpp \
     correlations_test.cpp \
     stochastic_gradient_descent_test.cpp \
@@ -66,6 +78,7 @@ HEADERS += \
     scaling_layer_test.h \
     probabilistic_layer_test.h \
     perceptron_layer_test.h \
+    low_rank_perceptron_layer_test.h \
     long_short_term_memory_layer_test.h \
     recurrent_layer_test.h \
     neural_network_test.h \
@@ -82,14 +95,25 @@ HEADERS += \
     levenberg_marquardt_algorithm_test.h \
     gradient_descent_test.h \
     conjugate_gradient_test.h \
+    training_checkpoint_test.h \
+    training_profiler_test.h \
+    training_observer_test.h \
+    training_scheduler_test.h \
+    cross_validation_test.h \
+    batch_predictor_test.h \
+    model_server_test.h \
+    gradient_checker_test.h \
     model_selection_test.h \
     neurons_selection_test.h \
     incremental_neurons_test.h \
     inputs_selection_test.h \
     growing_inputs_test.h \
     pruning_inputs_test.h \
+    pruning_weights_test.h \
+    layers_folding_test.h \
     genetic_algorithm_test.h \
     testing_analysis_test.h  \
+    quantized_neural_network_test.h \
     numerical_differentiation_test.h \
     opennn_tests.h \
     stochastic_gradient_descent_test.h \
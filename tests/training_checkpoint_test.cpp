@@ -0,0 +1,350 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   T R A I N I N G   C H E C K P O I N T   T E S T   C L A S S
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#include "training_checkpoint_test.h"
+
+
+TrainingCheckpointTest::TrainingCheckpointTest() : UnitTesting()
+{
+}
+
+
+TrainingCheckpointTest::~TrainingCheckpointTest()
+{
+}
+
+
+void TrainingCheckpointTest::test_constructor()
+{
+    cout << "test_constructor\n";
+
+    TrainingCheckpoint training_checkpoint;
+
+    assert_true(training_checkpoint.get_epoch() == 0, LOG);
+    assert_true(!training_checkpoint.has_vector("parameters"), LOG);
+}
+
+
+void TrainingCheckpointTest::test_destructor()
+{
+    cout << "test_destructor\n";
+
+    TrainingCheckpoint* training_checkpoint = new TrainingCheckpoint;
+
+    delete training_checkpoint;
+}
+
+
+void TrainingCheckpointTest::test_save()
+{
+    cout << "test_save\n";
+
+    const string file_name = "../data/training_checkpoint.bin";
+
+    TrainingCheckpoint training_checkpoint;
+
+    Tensor<type, 1> vector(5);
+    vector.setRandom();
+
+    training_checkpoint.set_optimization_algorithm_type("ADAPTIVE_MOMENT_ESTIMATION");
+    training_checkpoint.set_vector("parameters", vector);
+
+    training_checkpoint.save(file_name);
+
+    ifstream file(file_name.c_str(), ios::binary);
+
+    char magic[8];
+    file.read(magic, 8);
+
+    assert_true(file.good(), LOG);
+    assert_true(string(magic, 8) == "OPENNNCP", LOG);
+
+    file.close();
+
+    remove(file_name.c_str());
+}
+
+
+void TrainingCheckpointTest::test_load()
+{
+    cout << "test_load\n";
+
+    const string file_name = "../data/training_checkpoint.bin";
+
+    TrainingCheckpoint training_checkpoint;
+    TrainingCheckpoint loaded_training_checkpoint;
+
+    Tensor<type, 1> vector(5);
+    vector.setRandom();
+
+    Tensor<type, 2> matrix(3, 4);
+    matrix.setRandom();
+
+    training_checkpoint.set_optimization_algorithm_type("QUASI_NEWTON_METHOD");
+    training_checkpoint.set_epoch(7);
+    training_checkpoint.set_elapsed_time(12.5);
+    training_checkpoint.set_random_seed(123);
+    training_checkpoint.set_vector("parameters", vector);
+    training_checkpoint.set_matrix("old_inverse_hessian", matrix);
+    training_checkpoint.set_scalar("old_learning_rate", static_cast<type>(0.01));
+    training_checkpoint.set_index("selection_failures", 2);
+
+    training_checkpoint.save(file_name);
+
+    loaded_training_checkpoint.load(file_name);
+
+    const Tensor<bool, 0> vector_equal = (loaded_training_checkpoint.get_vector("parameters") == vector).all();
+    const Tensor<bool, 0> matrix_equal = (loaded_training_checkpoint.get_matrix("old_inverse_hessian") == matrix).all();
+
+    assert_true(loaded_training_checkpoint.get_optimization_algorithm_type() == "QUASI_NEWTON_METHOD", LOG);
+    assert_true(loaded_training_checkpoint.get_epoch() == 7, LOG);
+    assert_true(abs(loaded_training_checkpoint.get_elapsed_time() - static_cast<type>(12.5)) < numeric_limits<type>::min(), LOG);
+    assert_true(loaded_training_checkpoint.get_random_seed() == 123, LOG);
+    assert_true(vector_equal(), LOG);
+    assert_true(loaded_training_checkpoint.get_matrix("old_inverse_hessian").dimension(1) == 4, LOG);
+    assert_true(matrix_equal(), LOG);
+    assert_true(abs(loaded_training_checkpoint.get_scalar("old_learning_rate") - static_cast<type>(0.01)) < numeric_limits<type>::min(), LOG);
+    assert_true(loaded_training_checkpoint.get_index("selection_failures") == 2, LOG);
+
+    // Corrupted file
+
+    fstream file(file_name.c_str(), ios::in | ios::out | ios::binary);
+
+    file.seekg(-1, ios::end);
+    const char last_byte = static_cast<char>(file.get());
+    file.seekp(-1, ios::end);
+    file.put(static_cast<char>(last_byte ^ 1));
+    file.close();
+
+    try
+    {
+        loaded_training_checkpoint.load(file_name);
+
+        assert_true(false, LOG);
+    }
+    catch(const logic_error&)
+    {
+        assert_true(true, LOG);
+    }
+
+    remove(file_name.c_str());
+}
+
+
+void TrainingCheckpointTest::test_write_XML()
+{
+    cout << "test_write_XML\n";
+
+    NeuralNetwork neural_network;
+    DataSet data_set;
+
+    TrainingStrategy training_strategy(&neural_network, &data_set);
+
+    const Index optimization_methods_number = 6;
+
+    const TrainingStrategy::OptimizationMethod optimization_methods[optimization_methods_number]
+            = {TrainingStrategy::GRADIENT_DESCENT,
+               TrainingStrategy::CONJUGATE_GRADIENT,
+               TrainingStrategy::QUASI_NEWTON_METHOD,
+               TrainingStrategy::LEVENBERG_MARQUARDT_ALGORITHM,
+               TrainingStrategy::STOCHASTIC_GRADIENT_DESCENT,
+               TrainingStrategy::ADAPTIVE_MOMENT_ESTIMATION};
+
+    for(Index i = 0; i < optimization_methods_number; i++)
+    {
+        training_strategy.set_optimization_method(optimization_methods[i]);
+
+        OptimizationAlgorithm* optimization_algorithm_pointer = training_strategy.get_optimization_algorithm_pointer();
+
+        optimization_algorithm_pointer->set_checkpoint_period(5);
+        optimization_algorithm_pointer->set_checkpoint_file_name("../data/training_checkpoint");
+        optimization_algorithm_pointer->set_maximum_checkpoints_number(2);
+
+        tinyxml2::XMLPrinter file_stream;
+
+        optimization_algorithm_pointer->write_XML(file_stream);
+
+        tinyxml2::XMLDocument document;
+
+        document.Parse(file_stream.CStr());
+
+        optimization_algorithm_pointer->set_checkpoint_period(0);
+        optimization_algorithm_pointer->set_checkpoint_file_name("checkpoint");
+        optimization_algorithm_pointer->set_maximum_checkpoints_number(3);
+
+        optimization_algorithm_pointer->from_XML(document);
+
+        assert_true(optimization_algorithm_pointer->get_checkpoint_period() == 5, LOG);
+        assert_true(optimization_algorithm_pointer->get_checkpoint_file_name() == "../data/training_checkpoint", LOG);
+        assert_true(optimization_algorithm_pointer->get_maximum_checkpoints_number() == 2, LOG);
+    }
+}
+
+
+void TrainingCheckpointTest::test_perform_training()
+{
+    cout << "test_perform_training\n";
+
+    const string checkpoint_file_name = "../data/checkpoint";
+
+    DataSet data_set(20, 3, 1);
+    data_set.set_data_random();
+
+    Tensor<Index, 1> architecture(3);
+    architecture.setValues({3, 2, 1});
+
+    NeuralNetwork neural_network(NeuralNetwork::Approximation, architecture);
+
+    TrainingStrategy training_strategy(&neural_network, &data_set);
+    training_strategy.set_loss_method(TrainingStrategy::SUM_SQUARED_ERROR);
+    training_strategy.set_optimization_method(TrainingStrategy::ADAPTIVE_MOMENT_ESTIMATION);
+    training_strategy.set_maximum_epochs_number(6);
+    training_strategy.set_display(false);
+
+    OptimizationAlgorithm* optimization_algorithm_pointer = training_strategy.get_optimization_algorithm_pointer();
+
+    optimization_algorithm_pointer->set_checkpoint_period(2);
+    optimization_algorithm_pointer->set_checkpoint_file_name(checkpoint_file_name);
+    optimization_algorithm_pointer->set_maximum_checkpoints_number(2);
+
+    training_strategy.perform_training();
+
+    // Only the two most recent checkpoints are kept
+
+    assert_true(!ifstream((checkpoint_file_name + "_2.bin").c_str()).good(), LOG);
+    assert_true(ifstream((checkpoint_file_name + "_4.bin").c_str()).good(), LOG);
+    assert_true(ifstream((checkpoint_file_name + "_6.bin").c_str()).good(), LOG);
+
+    TrainingCheckpoint training_checkpoint;
+
+    training_checkpoint.load(checkpoint_file_name + "_4.bin");
+
+    assert_true(training_checkpoint.get_optimization_algorithm_type() == "ADAPTIVE_MOMENT_ESTIMATION", LOG);
+    assert_true(training_checkpoint.get_epoch() == 4, LOG);
+    assert_true(training_checkpoint.get_vector("parameters").size() == neural_network.get_parameters_number(), LOG);
+    assert_true(training_checkpoint.has_vector("last_square_gradient_exponential_decay"), LOG);
+
+    remove((checkpoint_file_name + "_4.bin").c_str());
+    remove((checkpoint_file_name + "_6.bin").c_str());
+}
+
+
+void TrainingCheckpointTest::test_resume_training()
+{
+    cout << "test_resume_training\n";
+
+    const string checkpoint_file_name = "../data/checkpoint";
+
+    DataSet data_set(20, 3, 1);
+    data_set.set_data_random();
+    data_set.split_instances_random();
+
+    Tensor<Index, 1> architecture(3);
+    architecture.setValues({3, 2, 1});
+
+    NeuralNetwork neural_network(NeuralNetwork::Approximation, architecture);
+
+    Tensor<type, 1> initial_parameters = neural_network.get_parameters();
+
+    TrainingStrategy training_strategy(&neural_network, &data_set);
+    training_strategy.set_loss_method(TrainingStrategy::SUM_SQUARED_ERROR);
+    training_strategy.set_maximum_epochs_number(6);
+    training_strategy.set_display(false);
+
+    const Index optimization_methods_number = 6;
+
+    const TrainingStrategy::OptimizationMethod optimization_methods[optimization_methods_number]
+            = {TrainingStrategy::GRADIENT_DESCENT,
+               TrainingStrategy::CONJUGATE_GRADIENT,
+               TrainingStrategy::QUASI_NEWTON_METHOD,
+               TrainingStrategy::LEVENBERG_MARQUARDT_ALGORITHM,
+               TrainingStrategy::STOCHASTIC_GRADIENT_DESCENT,
+               TrainingStrategy::ADAPTIVE_MOMENT_ESTIMATION};
+
+    for(Index i = 0; i < optimization_methods_number; i++)
+    {
+        training_strategy.set_optimization_method(optimization_methods[i]);
+
+        OptimizationAlgorithm* optimization_algorithm_pointer = training_strategy.get_optimization_algorithm_pointer();
+
+        optimization_algorithm_pointer->set_checkpoint_period(2);
+        optimization_algorithm_pointer->set_checkpoint_file_name(checkpoint_file_name);
+        optimization_algorithm_pointer->set_maximum_checkpoints_number(0);
+
+        // Uninterrupted training
+
+        neural_network.set_parameters(initial_parameters);
+
+        const OptimizationAlgorithm::Results results = training_strategy.perform_training();
+
+        const Tensor<type, 1> parameters = neural_network.get_parameters();
+
+        // Training resumed from the middle checkpoint
+
+        neural_network.set_parameters_random();
+
+        optimization_algorithm_pointer->set_checkpoint_period(0);
+        optimization_algorithm_pointer->set_resume_file_name(checkpoint_file_name + "_4.bin");
+
+        const OptimizationAlgorithm::Results resumed_results = training_strategy.perform_training();
+
+        const Tensor<bool, 0> equal = (neural_network.get_parameters() == parameters).all();
+
+        assert_true(equal(), LOG);
+        assert_true(resumed_results.training_error_history.size() == results.training_error_history.size(), LOG);
+        assert_true(resumed_results.training_error_history(0) == results.training_error_history(0), LOG);
+
+        optimization_algorithm_pointer->set_resume_file_name("");
+
+        remove((checkpoint_file_name + "_2.bin").c_str());
+        remove((checkpoint_file_name + "_4.bin").c_str());
+        remove((checkpoint_file_name + "_6.bin").c_str());
+    }
+}
+
+
+void TrainingCheckpointTest::run_test_case()
+{
+    cout << "Running training checkpoint test case...\n";
+
+    // Constructor and destructor methods
+
+    test_constructor();
+    test_destructor();
+
+    // Serialization methods
+
+    test_save();
+    test_load();
+    test_write_XML();
+
+    // Training methods
+
+    test_perform_training();
+    test_resume_training();
+
+    cout << "End of training checkpoint test case.\n";
+}
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
@@ -0,0 +1,58 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   T R A I N I N G   C H E C K P O I N T   T E S T   C L A S S   H E A D E R
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#ifndef TRAININGCHECKPOINTTEST_H
+#define TRAININGCHECKPOINTTEST_H
+
+// Unit testing includes
+
+#include "unit_testing.h"
+
+using namespace OpenNN;
+
+
+class TrainingCheckpointTest : public UnitTesting
+{
+
+#define	STRING(x) #x
+#define TOSTRING(x) STRING(x)
+#define LOG __FILE__ ":" TOSTRING(__LINE__)"\n"
+
+public:
+
+   // CONSTRUCTOR
+
+   explicit TrainingCheckpointTest();
+
+   virtual ~TrainingCheckpointTest();
+
+   // Constructor and destructor methods
+
+   void test_constructor();
+   void test_destructor();
+
+   // Serialization methods
+
+   void test_save();
+   void test_load();
+
+   void test_write_XML();
+
+   // Training methods
+
+   void test_perform_training();
+   void test_resume_training();
+
+   // Unit testing methods
+
+   void run_test_case();
+
+};
+
+
+#endif
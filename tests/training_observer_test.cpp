@@ -0,0 +1,614 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   T R A I N I N G   O B S E R V E R   T E S T   C L A S S
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#include "training_observer_test.h"
+
+#ifndef _WIN32
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#endif
+
+
+/// Observer which records the events on the training thread, and which can request a stop at a given epoch.
+
+class RecordingTrainingObserver : public TrainingObserver
+{
+
+public:
+
+    explicit RecordingTrainingObserver(TrainingControl* new_training_control_pointer = nullptr, const Index& new_stop_epoch = -1)
+    {
+        training_control_pointer = new_training_control_pointer;
+        stop_epoch = new_stop_epoch;
+    }
+
+    void on_training_begin(const string& new_optimization_algorithm_type)
+    {
+        optimization_algorithm_type = new_optimization_algorithm_type;
+        beginnings_number++;
+    }
+
+    void on_iteration(const Metrics& metrics)
+    {
+        iterations_metrics.push_back(metrics);
+    }
+
+    void on_epoch(const Metrics& metrics)
+    {
+        epochs_metrics.push_back(metrics);
+
+        if(training_control_pointer != nullptr && metrics.epoch == stop_epoch) training_control_pointer->request_stop();
+    }
+
+    void on_training_end(const Metrics&, const string& new_stopping_condition)
+    {
+        stopping_condition = new_stopping_condition;
+        ends_number++;
+    }
+
+    TrainingControl* training_control_pointer = nullptr;
+
+    Index stop_epoch = -1;
+
+    string optimization_algorithm_type;
+
+    string stopping_condition;
+
+    Index beginnings_number = 0;
+
+    Index ends_number = 0;
+
+    vector<Metrics> iterations_metrics;
+
+    vector<Metrics> epochs_metrics;
+};
+
+
+/// Asynchronous observer which writes slowly, so that its queue fills up.
+
+class SlowTrainingObserver : public AsyncTrainingObserver
+{
+
+public:
+
+    explicit SlowTrainingObserver(const Index& new_maximum_queue_size) : AsyncTrainingObserver(new_maximum_queue_size)
+    {
+    }
+
+    virtual ~SlowTrainingObserver()
+    {
+        stop();
+    }
+
+    Index written_iterations_number = 0;
+
+    Index written_epochs_number = 0;
+
+protected:
+
+    void write_event(const Event& event)
+    {
+        this_thread::sleep_for(chrono::milliseconds(20));
+
+        if(event.type == Iteration) written_iterations_number++;
+        if(event.type == Epoch) written_epochs_number++;
+    }
+};
+
+
+TrainingObserverTest::TrainingObserverTest() : UnitTesting()
+{
+}
+
+
+TrainingObserverTest::~TrainingObserverTest()
+{
+}
+
+
+void TrainingObserverTest::test_constructor()
+{
+    cout << "test_constructor\n";
+
+    TrainingControl training_control;
+
+    assert_true(!training_control.is_stop_requested(), LOG);
+    assert_true(!training_control.is_pause_requested(), LOG);
+
+    TrainingObserver::Metrics metrics;
+
+    assert_true(isnan(metrics.selection_error), LOG);
+    assert_true(isnan(metrics.learning_rate), LOG);
+
+    SlowTrainingObserver slow_training_observer(5);
+
+    assert_true(slow_training_observer.get_maximum_queue_size() == 5, LOG);
+    assert_true(slow_training_observer.get_dropped_events_number() == 0, LOG);
+
+    // Empty queue
+
+    try
+    {
+        SlowTrainingObserver empty_training_observer(0);
+
+        assert_true(false, LOG);
+    }
+    catch(const logic_error&)
+    {
+        assert_true(true, LOG);
+    }
+}
+
+
+void TrainingObserverTest::test_destructor()
+{
+    cout << "test_destructor\n";
+
+    SlowTrainingObserver* slow_training_observer = new SlowTrainingObserver(10);
+
+    TrainingObserver::Metrics metrics;
+
+    slow_training_observer->on_epoch(metrics);
+
+    delete slow_training_observer;
+}
+
+
+void TrainingObserverTest::test_training_control()
+{
+    cout << "test_training_control\n";
+
+    TrainingControl training_control;
+
+    // Not paused
+
+    assert_true(!training_control.wait_while_paused(), LOG);
+
+    // Resume
+
+    training_control.request_pause();
+
+    assert_true(training_control.is_pause_requested(), LOG);
+
+    thread resuming_thread([&training_control]
+    {
+        this_thread::sleep_for(chrono::milliseconds(50));
+        training_control.request_resume();
+    });
+
+    assert_true(!training_control.wait_while_paused(), LOG);
+    assert_true(!training_control.is_pause_requested(), LOG);
+
+    resuming_thread.join();
+
+    // Stop while paused
+
+    training_control.request_pause();
+
+    thread stopping_thread([&training_control]
+    {
+        this_thread::sleep_for(chrono::milliseconds(50));
+        training_control.request_stop();
+    });
+
+    assert_true(training_control.wait_while_paused(), LOG);
+    assert_true(training_control.is_stop_requested(), LOG);
+
+    stopping_thread.join();
+
+    // Reset
+
+    training_control.reset();
+
+    assert_true(!training_control.is_stop_requested(), LOG);
+    assert_true(!training_control.is_pause_requested(), LOG);
+}
+
+
+void TrainingObserverTest::test_async_training_observer()
+{
+    cout << "test_async_training_observer\n";
+
+    SlowTrainingObserver slow_training_observer(2);
+
+    TrainingObserver::Metrics metrics;
+
+    // The callbacks do not wait for the writing
+
+    const chrono::steady_clock::time_point beginning_time = chrono::steady_clock::now();
+
+    for(Index i = 0; i < 20; i++)
+    {
+        slow_training_observer.on_iteration(metrics);
+    }
+
+    for(Index i = 0; i < 5; i++)
+    {
+        slow_training_observer.on_epoch(metrics);
+    }
+
+    const double callbacks_time = chrono::duration<double>(chrono::steady_clock::now() - beginning_time).count();
+
+    assert_true(callbacks_time < 0.2, LOG);
+
+    slow_training_observer.flush();
+
+    // Only iterations are dropped
+
+    assert_true(slow_training_observer.get_dropped_events_number() > 0, LOG);
+    assert_true(slow_training_observer.written_epochs_number == 5, LOG);
+    assert_true(slow_training_observer.written_iterations_number + slow_training_observer.get_dropped_events_number() == 20, LOG);
+
+    assert_true(AsyncTrainingObserver::write_event_type(AsyncTrainingObserver::TrainingEnd) == "training_end", LOG);
+}
+
+
+void TrainingObserverTest::test_csv_training_observer()
+{
+    cout << "test_csv_training_observer\n";
+
+    const string file_name = "../data/training_observer.csv";
+
+    TrainingObserver::Metrics metrics;
+
+    metrics.epoch = 3;
+    metrics.iterations_number = 4;
+    metrics.instances_number = 10;
+    metrics.training_loss = static_cast<type>(0.5);
+    metrics.gradient_norm = static_cast<type>(2);
+
+    {
+        CSVTrainingObserver csv_training_observer(file_name);
+
+        assert_true(csv_training_observer.get_file_name() == file_name, LOG);
+
+        csv_training_observer.on_training_begin("QUASI_NEWTON_METHOD");
+        csv_training_observer.on_epoch(metrics);
+        csv_training_observer.on_training_end(metrics, "Stop requested");
+    }
+
+    ifstream file(file_name.c_str());
+
+    vector<string> lines;
+    string line;
+
+    while(getline(file, line)) lines.push_back(line);
+
+    file.close();
+
+    assert_true(lines.size() == 3, LOG);
+    assert_true(lines[0].find("event,epoch,iteration,iterations_number") == 0, LOG);
+    assert_true(lines[1] == "epoch,3,0,4,10,0.5,,,2,,0,0,0", LOG);
+    assert_true(lines[2].find("training_end,3,") == 0, LOG);
+
+    remove(file_name.c_str());
+
+    // Wrong file name
+
+    try
+    {
+        CSVTrainingObserver wrong_training_observer("../data/missing_directory/training_observer.csv");
+
+        assert_true(false, LOG);
+    }
+    catch(const logic_error&)
+    {
+        assert_true(true, LOG);
+    }
+}
+
+
+void TrainingObserverTest::test_json_lines_training_observer()
+{
+    cout << "test_json_lines_training_observer\n";
+
+    const string file_name = "../data/training_observer.jsonl";
+
+    TrainingObserver::Metrics metrics;
+
+    metrics.epoch = 1;
+    metrics.training_loss = static_cast<type>(0.25);
+    metrics.learning_rate = static_cast<type>(0.01);
+
+    JSONLinesTrainingObserver json_lines_training_observer(file_name);
+
+    json_lines_training_observer.on_training_begin("ADAPTIVE_MOMENT_ESTIMATION");
+    json_lines_training_observer.on_iteration(metrics);
+    json_lines_training_observer.on_training_end(metrics, "Loss \"goal\"");
+
+    json_lines_training_observer.flush();
+
+    ifstream file(file_name.c_str());
+
+    vector<string> lines;
+    string line;
+
+    while(getline(file, line)) lines.push_back(line);
+
+    file.close();
+
+    assert_true(lines.size() == 3, LOG);
+    assert_true(lines[0] == "{\"event\": \"training_begin\", \"optimization_algorithm\": \"ADAPTIVE_MOMENT_ESTIMATION\"}", LOG);
+    assert_true(lines[1].find("{\"event\": \"iteration\", \"epoch\": 1,") == 0, LOG);
+    assert_true(lines[1].find("\"training_loss\": 0.25,") != string::npos, LOG);
+    assert_true(lines[1].find("\"selection_error\": null,") != string::npos, LOG);
+    assert_true(lines[1].find("\"learning_rate\": 0.01,") != string::npos, LOG);
+    assert_true(lines[2].find("\"stopping_condition\": \"Loss \\\"goal\\\"\"}") != string::npos, LOG);
+
+    remove(file_name.c_str());
+}
+
+
+void TrainingObserverTest::test_prometheus_training_observer()
+{
+    cout << "test_prometheus_training_observer\n";
+
+#ifndef _WIN32
+
+    PrometheusTrainingObserver prometheus_training_observer;
+
+    assert_true(prometheus_training_observer.get_port() > 0, LOG);
+
+    TrainingObserver::Metrics metrics;
+
+    metrics.epoch = 7;
+    metrics.iterations_number = 8;
+    metrics.training_loss = static_cast<type>(1.5);
+
+    prometheus_training_observer.on_training_begin("GRADIENT_DESCENT");
+    prometheus_training_observer.on_epoch(metrics);
+    prometheus_training_observer.flush();
+
+    ostringstream buffer;
+
+    prometheus_training_observer.write_metrics(buffer);
+
+    const string text = buffer.str();
+
+    assert_true(text.find("opennn_training_info{optimization_algorithm=\"GRADIENT_DESCENT\"} 1\n") != string::npos, LOG);
+    assert_true(text.find("opennn_training_running 1\n") != string::npos, LOG);
+    assert_true(text.find("opennn_training_epochs_total 1\n") != string::npos, LOG);
+    assert_true(text.find("opennn_training_epoch 7\n") != string::npos, LOG);
+    assert_true(text.find("opennn_training_loss 1.5\n") != string::npos, LOG);
+    assert_true(text.find("opennn_training_selection_error NaN\n") != string::npos, LOG);
+    assert_true(text.find("# TYPE opennn_training_loss gauge\n") != string::npos, LOG);
+
+    // HTTP request
+
+    const int client_socket = socket(AF_INET, SOCK_STREAM, 0);
+
+    sockaddr_in address;
+
+    memset(&address, 0, sizeof(address));
+
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(static_cast<uint16_t>(prometheus_training_observer.get_port()));
+
+    assert_true(connect(client_socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0, LOG);
+
+    const string request = "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n";
+
+    send(client_socket, request.data(), request.size(), 0);
+
+    string response;
+    char characters[1024];
+    ssize_t received_bytes;
+
+    while((received_bytes = recv(client_socket, characters, sizeof(characters), 0)) > 0)
+    {
+        response.append(characters, static_cast<size_t>(received_bytes));
+    }
+
+    close(client_socket);
+
+    assert_true(response.find("HTTP/1.1 200 OK\r\n") == 0, LOG);
+    assert_true(response.find("opennn_training_epoch 7\n") != string::npos, LOG);
+
+#endif
+}
+
+
+void TrainingObserverTest::test_perform_training()
+{
+    cout << "test_perform_training\n";
+
+    DataSet data_set(20, 3, 1);
+    data_set.set_data_random();
+
+    Tensor<Index, 1> architecture(3);
+    architecture.setValues({3, 2, 1});
+
+    NeuralNetwork neural_network(NeuralNetwork::Approximation, architecture);
+
+    TrainingStrategy training_strategy(&neural_network, &data_set);
+    training_strategy.set_loss_method(TrainingStrategy::SUM_SQUARED_ERROR);
+    training_strategy.set_maximum_epochs_number(4);
+    training_strategy.set_display(false);
+
+    training_strategy.get_adaptive_moment_estimation_pointer()->set_batch_instances_number(5);
+
+    const Index optimization_methods_number = 3;
+
+    const TrainingStrategy::OptimizationMethod optimization_methods[optimization_methods_number]
+            = {TrainingStrategy::QUASI_NEWTON_METHOD,
+               TrainingStrategy::LEVENBERG_MARQUARDT_ALGORITHM,
+               TrainingStrategy::ADAPTIVE_MOMENT_ESTIMATION};
+
+    for(Index i = 0; i < optimization_methods_number; i++)
+    {
+        training_strategy.set_optimization_method(optimization_methods[i]);
+
+        OptimizationAlgorithm* optimization_algorithm_pointer = training_strategy.get_optimization_algorithm_pointer();
+
+        RecordingTrainingObserver recording_training_observer;
+
+        optimization_algorithm_pointer->add_observer(&recording_training_observer);
+
+        const OptimizationAlgorithm::Results results = training_strategy.perform_training();
+
+        optimization_algorithm_pointer->clear_observers();
+
+        assert_true(optimization_algorithm_pointer->get_observers().empty(), LOG);
+
+        assert_true(recording_training_observer.beginnings_number == 1, LOG);
+        assert_true(recording_training_observer.ends_number == 1, LOG);
+        assert_true(recording_training_observer.optimization_algorithm_type == optimization_algorithm_pointer->write_optimization_algorithm_type(), LOG);
+        assert_true(recording_training_observer.stopping_condition == results.write_stopping_condition(), LOG);
+        assert_true(static_cast<Index>(recording_training_observer.epochs_metrics.size()) == results.epochs_number + 1, LOG);
+
+        const TrainingObserver::Metrics& last_metrics = recording_training_observer.epochs_metrics.back();
+
+        assert_true(last_metrics.epoch == results.epochs_number, LOG);
+        assert_true(abs(last_metrics.training_error - results.final_training_error) < numeric_limits<type>::epsilon(), LOG);
+        assert_true(last_metrics.gradient_norm >= 0, LOG);
+        assert_true(last_metrics.elapsed_time >= 0, LOG);
+
+        if(optimization_methods[i] == TrainingStrategy::ADAPTIVE_MOMENT_ESTIMATION)
+        {
+            const Index iterations_number = static_cast<Index>(recording_training_observer.iterations_metrics.size());
+
+            assert_true(iterations_number > results.epochs_number, LOG);
+            assert_true(iterations_number % (results.epochs_number + 1) == 0, LOG);
+            assert_true(recording_training_observer.iterations_metrics.back().instances_number == 5, LOG);
+            assert_true(last_metrics.iterations_number == iterations_number, LOG);
+            assert_true(last_metrics.learning_rate > 0, LOG);
+        }
+        else
+        {
+            assert_true(recording_training_observer.iterations_metrics.empty(), LOG);
+            assert_true(last_metrics.instances_number == data_set.get_training_instances_number(), LOG);
+        }
+
+        if(optimization_methods[i] == TrainingStrategy::LEVENBERG_MARQUARDT_ALGORITHM)
+        {
+            assert_true(isnan(last_metrics.learning_rate), LOG);
+        }
+    }
+
+    // Null observer
+
+    try
+    {
+        training_strategy.get_optimization_algorithm_pointer()->add_observer(nullptr);
+
+        assert_true(false, LOG);
+    }
+    catch(const logic_error&)
+    {
+        assert_true(true, LOG);
+    }
+}
+
+
+void TrainingObserverTest::test_stop_request()
+{
+    cout << "test_stop_request\n";
+
+    DataSet data_set(20, 3, 1);
+    data_set.set_data_random();
+
+    Tensor<Index, 1> architecture(3);
+    architecture.setValues({3, 2, 1});
+
+    NeuralNetwork neural_network(NeuralNetwork::Approximation, architecture);
+
+    TrainingStrategy training_strategy(&neural_network, &data_set);
+    training_strategy.set_loss_method(TrainingStrategy::SUM_SQUARED_ERROR);
+    training_strategy.set_maximum_epochs_number(100);
+    training_strategy.set_display(false);
+
+    const Index optimization_methods_number = 2;
+
+    const TrainingStrategy::OptimizationMethod optimization_methods[optimization_methods_number]
+            = {TrainingStrategy::GRADIENT_DESCENT,
+               TrainingStrategy::STOCHASTIC_GRADIENT_DESCENT};
+
+    for(Index i = 0; i < optimization_methods_number; i++)
+    {
+        training_strategy.set_optimization_method(optimization_methods[i]);
+
+        OptimizationAlgorithm* optimization_algorithm_pointer = training_strategy.get_optimization_algorithm_pointer();
+
+        RecordingTrainingObserver recording_training_observer(&optimization_algorithm_pointer->get_training_control(), 2);
+
+        optimization_algorithm_pointer->add_observer(&recording_training_observer);
+
+        const OptimizationAlgorithm::Results results = training_strategy.perform_training();
+
+        optimization_algorithm_pointer->clear_observers();
+
+        assert_true(results.stopping_condition == OptimizationAlgorithm::StopRequested, LOG);
+        assert_true(results.write_stopping_condition() == "Stop requested", LOG);
+        assert_true(results.epochs_number == 3, LOG);
+        assert_true(recording_training_observer.stopping_condition == "Stop requested", LOG);
+
+        // The signals are cleared by the next training
+
+        optimization_algorithm_pointer->get_training_control().request_stop();
+
+        training_strategy.set_maximum_epochs_number(1);
+
+        const OptimizationAlgorithm::Results next_results = training_strategy.perform_training();
+
+        assert_true(next_results.stopping_condition != OptimizationAlgorithm::StopRequested, LOG);
+
+        training_strategy.set_maximum_epochs_number(100);
+    }
+}
+
+
+void TrainingObserverTest::run_test_case()
+{
+    cout << "Running training observer test case...\n";
+
+    // Constructor and destructor methods
+
+    test_constructor();
+    test_destructor();
+
+    // Control methods
+
+    test_training_control();
+
+    // Observer methods
+
+    test_async_training_observer();
+    test_csv_training_observer();
+    test_json_lines_training_observer();
+    test_prometheus_training_observer();
+
+    // Training methods
+
+    test_perform_training();
+    test_stop_request();
+
+    cout << "End of training observer test case.\n";
+}
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
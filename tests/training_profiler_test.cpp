@@ -0,0 +1,313 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   T R A I N I N G   P R O F I L E R   T E S T   C L A S S
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#include "training_profiler_test.h"
+
+
+TrainingProfilerTest::TrainingProfilerTest() : UnitTesting()
+{
+}
+
+
+TrainingProfilerTest::~TrainingProfilerTest()
+{
+}
+
+
+void TrainingProfilerTest::test_constructor()
+{
+    cout << "test_constructor\n";
+
+    TrainingProfiler training_profiler;
+
+    assert_true(!training_profiler.is_started(), LOG);
+    assert_true(!training_profiler.get_record_trace(), LOG);
+    assert_true(training_profiler.get_epochs_profiles().empty(), LOG);
+}
+
+
+void TrainingProfilerTest::test_destructor()
+{
+    cout << "test_destructor\n";
+
+    TrainingProfiler* training_profiler = new TrainingProfiler;
+
+    delete training_profiler;
+}
+
+
+void TrainingProfilerTest::test_scoped_timer()
+{
+    cout << "test_scoped_timer\n";
+
+    TrainingProfiler training_profiler;
+
+    // Profiler not started
+
+    {
+        TrainingProfiler::ScopedTimer scoped_timer(&training_profiler, TrainingProfiler::ForwardPropagate);
+    }
+
+    assert_true(training_profiler.get_epochs_profiles().empty(), LOG);
+
+    // Profiler started
+
+    training_profiler.start(2);
+    training_profiler.begin_epoch(0);
+
+    for(Index i = 0; i < 3; i++)
+    {
+        TrainingProfiler::ScopedTimer scoped_timer(&training_profiler, TrainingProfiler::UpdateIteration);
+    }
+
+    {
+        TrainingProfiler::ScopedTimer scoped_timer(&training_profiler, TrainingProfiler::ForwardPropagate, 1);
+    }
+
+    training_profiler.finish();
+
+    const vector<TrainingProfiler::EpochProfile>& epochs_profiles = training_profiler.get_epochs_profiles();
+
+    assert_true(epochs_profiles.size() == 1, LOG);
+    assert_true(epochs_profiles[0].phases.size() == TrainingProfiler::phases_number, LOG);
+    assert_true(epochs_profiles[0].phases[TrainingProfiler::UpdateIteration].calls_number == 3, LOG);
+    assert_true(epochs_profiles[0].phases[TrainingProfiler::UpdateIteration].time >= 0, LOG);
+    assert_true(epochs_profiles[0].phases[TrainingProfiler::ForwardPropagate].calls_number == 0, LOG);
+    assert_true(epochs_profiles[0].layers[TrainingProfiler::ForwardPropagate][1].calls_number == 1, LOG);
+    assert_true(epochs_profiles[0].layers[TrainingProfiler::ForwardPropagate][0].calls_number == 0, LOG);
+    assert_true(epochs_profiles[0].time >= epochs_profiles[0].phases[TrainingProfiler::UpdateIteration].time, LOG);
+
+    // Null pointer
+
+    {
+        TrainingProfiler::ScopedTimer scoped_timer(nullptr, TrainingProfiler::BatchFill);
+    }
+}
+
+
+void TrainingProfilerTest::test_add_counts()
+{
+    cout << "test_add_counts\n";
+
+    TrainingProfiler training_profiler;
+
+    PerceptronLayer perceptron_layer(3, 2);
+
+    training_profiler.start(1);
+    training_profiler.begin_epoch(0);
+
+    training_profiler.add_counts(TrainingProfiler::CalculateError, -1, 10, 20, 1);
+    training_profiler.add_layer_counts(TrainingProfiler::ForwardPropagate, 0, &perceptron_layer, 5);
+
+    // Layer index out of range
+
+    try
+    {
+        training_profiler.add_counts(TrainingProfiler::ForwardPropagate, 1, 1, 1, 1);
+
+        assert_true(false, LOG);
+    }
+    catch(const logic_error&)
+    {
+        assert_true(true, LOG);
+    }
+
+    training_profiler.finish();
+
+    const TrainingProfiler::EpochProfile total_profile = training_profiler.calculate_total_profile();
+
+    const TrainingProfiler::Counters& error_counters = total_profile.phases[TrainingProfiler::CalculateError];
+    const TrainingProfiler::Counters& layer_counters = total_profile.layers[TrainingProfiler::ForwardPropagate][0];
+
+    assert_true(total_profile.epoch == 1, LOG);
+    assert_true(error_counters.flops_number == 10, LOG);
+    assert_true(error_counters.bytes_number == 20, LOG);
+    assert_true(error_counters.allocations_number == 1, LOG);
+    assert_true(layer_counters.flops_number == 5*(2*8 + 2), LOG);
+    assert_true(layer_counters.bytes_number == static_cast<Index>(sizeof(type))*(5*(3 + 2) + 8), LOG);
+    assert_true(total_profile.phases[TrainingProfiler::ForwardPropagate].flops_number == layer_counters.flops_number, LOG);
+}
+
+
+void TrainingProfilerTest::test_begin_epoch()
+{
+    cout << "test_begin_epoch\n";
+
+    TrainingProfiler training_profiler;
+
+    training_profiler.start(1);
+
+    // Measures before the first epoch belong to it
+
+    training_profiler.add_counts(TrainingProfiler::BatchFill, -1, 0, 100, 0);
+
+    for(Index epoch = 0; epoch < 3; epoch++)
+    {
+        training_profiler.begin_epoch(epoch);
+
+        training_profiler.add_counts(TrainingProfiler::UpdateIteration, -1, epoch, 0, 0);
+    }
+
+    training_profiler.finish();
+
+    const vector<TrainingProfiler::EpochProfile>& epochs_profiles = training_profiler.get_epochs_profiles();
+
+    assert_true(epochs_profiles.size() == 3, LOG);
+    assert_true(epochs_profiles[0].phases[TrainingProfiler::BatchFill].bytes_number == 100, LOG);
+    assert_true(epochs_profiles[1].phases[TrainingProfiler::BatchFill].bytes_number == 0, LOG);
+    assert_true(epochs_profiles[2].epoch == 2, LOG);
+    assert_true(epochs_profiles[2].phases[TrainingProfiler::UpdateIteration].flops_number == 2, LOG);
+
+    // Start clears the previous measures
+
+    training_profiler.start(1);
+    training_profiler.finish();
+
+    assert_true(training_profiler.get_epochs_profiles().empty(), LOG);
+}
+
+
+void TrainingProfilerTest::test_write_trace()
+{
+    cout << "test_write_trace\n";
+
+    TrainingProfiler training_profiler;
+
+    training_profiler.set_record_trace(true);
+
+    training_profiler.start(1);
+    training_profiler.begin_epoch(0);
+
+    {
+        TrainingProfiler::ScopedTimer scoped_timer(&training_profiler, TrainingProfiler::CalculateLayersDelta, 0);
+    }
+
+    {
+        TrainingProfiler::ScopedTimer scoped_timer(&training_profiler, TrainingProfiler::SetParameters);
+    }
+
+    training_profiler.finish();
+
+    ostringstream buffer;
+
+    training_profiler.write_trace(buffer);
+
+    const string trace = buffer.str();
+
+    assert_true(trace.find("{\"traceEvents\": [") == 0, LOG);
+    assert_true(trace.find("\"name\": \"epoch 0\"") != string::npos, LOG);
+    assert_true(trace.find("\"name\": \"calculate_layers_delta layer 0\", \"cat\": \"layer\"") != string::npos, LOG);
+    assert_true(trace.find("\"name\": \"set_parameters\", \"cat\": \"phase\"") != string::npos, LOG);
+    assert_true(trace.find("\"ph\": \"X\"") != string::npos, LOG);
+}
+
+
+void TrainingProfilerTest::test_perform_training()
+{
+    cout << "test_perform_training\n";
+
+    DataSet data_set(20, 3, 1);
+    data_set.set_data_random();
+
+    Tensor<Index, 1> architecture(3);
+    architecture.setValues({3, 2, 1});
+
+    NeuralNetwork neural_network(NeuralNetwork::Approximation, architecture);
+
+    TrainingStrategy training_strategy(&neural_network, &data_set);
+    training_strategy.set_loss_method(TrainingStrategy::SUM_SQUARED_ERROR);
+    training_strategy.set_maximum_epochs_number(4);
+    training_strategy.set_display(false);
+
+    const Index optimization_methods_number = 3;
+
+    const TrainingStrategy::OptimizationMethod optimization_methods[optimization_methods_number]
+            = {TrainingStrategy::QUASI_NEWTON_METHOD,
+               TrainingStrategy::LEVENBERG_MARQUARDT_ALGORITHM,
+               TrainingStrategy::ADAPTIVE_MOMENT_ESTIMATION};
+
+    for(Index i = 0; i < optimization_methods_number; i++)
+    {
+        training_strategy.set_optimization_method(optimization_methods[i]);
+
+        training_strategy.get_optimization_algorithm_pointer()->get_profiler().set_record_trace(true);
+
+        const OptimizationAlgorithm::Results results = training_strategy.perform_training();
+
+        assert_true(neural_network.get_profiler_pointer() == nullptr, LOG);
+
+#ifdef OPENNN_PROFILE
+
+        assert_true(static_cast<Index>(results.profile_history.size()) == results.epochs_number + 1, LOG);
+
+        const TrainingProfiler::EpochProfile total_profile
+                = training_strategy.get_optimization_algorithm_pointer()->get_profiler().calculate_total_profile();
+
+        assert_true(total_profile.phases[TrainingProfiler::BatchFill].calls_number > 0, LOG);
+        assert_true(total_profile.phases[TrainingProfiler::ForwardPropagate].calls_number > 0, LOG);
+        assert_true(total_profile.phases[TrainingProfiler::CalculateError].calls_number > 0, LOG);
+        assert_true(total_profile.phases[TrainingProfiler::CalculateLayersDelta].calls_number > 0, LOG);
+        assert_true(total_profile.phases[TrainingProfiler::CalculateErrorGradient].calls_number > 0, LOG);
+        assert_true(total_profile.phases[TrainingProfiler::UpdateIteration].calls_number > 0, LOG);
+        assert_true(total_profile.phases[TrainingProfiler::SetParameters].calls_number > 0, LOG);
+        assert_true(total_profile.phases[TrainingProfiler::ForwardPropagate].flops_number > 0, LOG);
+        assert_true(total_profile.layers[TrainingProfiler::ForwardPropagate][1].calls_number > 0, LOG);
+        assert_true(total_profile.layers[TrainingProfiler::CalculateLayersDelta][0].calls_number > 0, LOG);
+
+#else
+
+        assert_true(results.profile_history.empty(), LOG);
+
+#endif
+    }
+}
+
+
+void TrainingProfilerTest::run_test_case()
+{
+    cout << "Running training profiler test case...\n";
+
+    // Constructor and destructor methods
+
+    test_constructor();
+    test_destructor();
+
+    // Measure methods
+
+    test_scoped_timer();
+    test_add_counts();
+    test_begin_epoch();
+
+    // Serialization methods
+
+    test_write_trace();
+
+    // Training methods
+
+    test_perform_training();
+
+    cout << "End of training profiler test case.\n";
+}
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
@@ -0,0 +1,60 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   T R A I N I N G   P R O F I L E R   T E S T   C L A S S   H E A D E R
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#ifndef TRAININGPROFILERTEST_H
+#define TRAININGPROFILERTEST_H
+
+// Unit testing includes
+
+#include "unit_testing.h"
+
+using namespace OpenNN;
+
+
+class TrainingProfilerTest : public UnitTesting
+{
+
+#define	STRING(x) #x
+#define TOSTRING(x) STRING(x)
+#define LOG __FILE__ ":" TOSTRING(__LINE__)"\n"
+
+public:
+
+   // CONSTRUCTOR
+
+   explicit TrainingProfilerTest();
+
+   virtual ~TrainingProfilerTest();
+
+   // Constructor and destructor methods
+
+   void test_constructor();
+   void test_destructor();
+
+   // Measure methods
+
+   void test_scoped_timer();
+   void test_add_counts();
+   void test_begin_epoch();
+
+   // Serialization methods
+
+   void test_write_trace();
+
+   // Training methods
+
+   void test_perform_training();
+
+   // Unit testing methods
+
+   void run_test_case();
+
+};
+
+
+#endif
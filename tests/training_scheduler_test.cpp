@@ -0,0 +1,293 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   T R A I N I N G   S C H E D U L E R   T E S T   C L A S S
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#include "training_scheduler_test.h"
+
+
+TrainingSchedulerTest::TrainingSchedulerTest() : UnitTesting()
+{
+}
+
+
+TrainingSchedulerTest::~TrainingSchedulerTest()
+{
+}
+
+
+void TrainingSchedulerTest::test_constructor()
+{
+    cout << "test_constructor\n";
+
+    NeuralNetwork neural_network;
+    DataSet data_set;
+
+    TrainingStrategy training_strategy(&neural_network, &data_set);
+
+    TrainingScheduler training_scheduler_1(&training_strategy);
+
+    assert_true(training_scheduler_1.get_training_strategy_pointer() == &training_strategy, LOG);
+
+    TrainingScheduler training_scheduler_2;
+
+    assert_true(training_scheduler_2.get_training_strategy_pointer() == nullptr, LOG);
+}
+
+
+void TrainingSchedulerTest::test_destructor()
+{
+    cout << "test_destructor\n";
+
+    TrainingScheduler* training_scheduler = new TrainingScheduler;
+
+    delete training_scheduler;
+}
+
+
+void TrainingSchedulerTest::test_set_default()
+{
+    cout << "test_set_default\n";
+
+    TrainingScheduler training_scheduler;
+
+    training_scheduler.set_workers_number(3);
+    training_scheduler.set_worker_threads_number(2);
+
+    training_scheduler.set_default();
+
+    assert_true(training_scheduler.get_workers_number() == omp_get_max_threads(), LOG);
+    assert_true(training_scheduler.get_worker_threads_number() == 1, LOG);
+}
+
+
+void TrainingSchedulerTest::test_perform_trainings()
+{
+    cout << "test_perform_trainings\n";
+
+    DataSet data_set(20, 3, 1);
+    data_set.set_data_random();
+    data_set.split_instances_random();
+
+    Tensor<Index, 1> architecture(3);
+    architecture.setValues({3, 2, 1});
+
+    NeuralNetwork neural_network(NeuralNetwork::Approximation, architecture);
+
+    TrainingStrategy training_strategy(&neural_network, &data_set);
+    training_strategy.set_loss_method(TrainingStrategy::SUM_SQUARED_ERROR);
+    training_strategy.set_optimization_method(TrainingStrategy::QUASI_NEWTON_METHOD);
+    training_strategy.set_maximum_epochs_number(5);
+    training_strategy.set_display(false);
+
+    TrainingScheduler training_scheduler(&training_strategy);
+    training_scheduler.set_workers_number(2);
+
+    const Tensor<type, 1> parameters = neural_network.get_parameters();
+
+    Tensor<DataSet::VariableUse, 1> columns_uses = data_set.get_columns_uses();
+    columns_uses(0) = DataSet::UnusedVariable;
+
+    Tensor<TrainingScheduler::Candidate, 1> candidates(3);
+
+    candidates(1).neurons_number = 4;
+    candidates(2).columns_uses = columns_uses;
+
+    const Tensor<OptimizationAlgorithm::Results, 1> results = training_scheduler.perform_trainings(candidates);
+
+    assert_true(results.size() == 3, LOG);
+
+    // Parameters of the candidates
+
+    assert_true(results(0).final_parameters.size() == 3*2 + 2 + 2*1 + 1, LOG);
+    assert_true(results(1).final_parameters.size() == 3*4 + 4 + 4*1 + 1, LOG);
+    assert_true(results(2).final_parameters.size() == 2*2 + 2 + 2*1 + 1, LOG);
+
+    // Settings of the training strategy
+
+    for(Index i = 0; i < results.size(); i++)
+    {
+        assert_true(results(i).epochs_number <= 5, LOG);
+    }
+
+    // Originals
+
+    const Tensor<bool, 0> unchanged = (neural_network.get_parameters() == parameters).all();
+
+    assert_true(unchanged(), LOG);
+    assert_true(data_set.get_input_variables_number() == 3, LOG);
+}
+
+
+void TrainingSchedulerTest::test_perform_racing()
+{
+    cout << "test_perform_racing\n";
+
+    DataSet data_set(20, 2, 1);
+    data_set.set_data_random();
+    data_set.split_instances_random();
+
+    Tensor<Index, 1> architecture(3);
+    architecture.setValues({2, 2, 1});
+
+    NeuralNetwork neural_network(NeuralNetwork::Approximation, architecture);
+
+    TrainingStrategy training_strategy(&neural_network, &data_set);
+    training_strategy.set_loss_method(TrainingStrategy::SUM_SQUARED_ERROR);
+    training_strategy.set_optimization_method(TrainingStrategy::QUASI_NEWTON_METHOD);
+    training_strategy.set_maximum_epochs_number(8);
+    training_strategy.set_display(false);
+
+    TrainingScheduler training_scheduler(&training_strategy);
+    training_scheduler.set_racing_epochs_number(2);
+
+    Tensor<TrainingScheduler::Candidate, 1> candidates(5);
+
+    Tensor<Index, 1> rungs;
+
+    const Tensor<OptimizationAlgorithm::Results, 1> results = training_scheduler.perform_racing(candidates, rungs);
+
+    assert_true(results.size() == 5, LOG);
+
+    for(Index i = 0; i < results.size(); i++)
+    {
+        assert_true(results(i).final_parameters.size() == neural_network.get_parameters_number(), LOG);
+    }
+
+    // Rounds of 2, 4 and 8 epochs, with 5, 3 and 2 candidates
+
+    Index second_rung_candidates_number = 0;
+    Index third_rung_candidates_number = 0;
+
+    for(Index i = 0; i < rungs.size(); i++)
+    {
+        if(rungs(i) >= 1) second_rung_candidates_number++;
+        if(rungs(i) == 2) third_rung_candidates_number++;
+    }
+
+    assert_true(rungs.size() == 5, LOG);
+    assert_true(second_rung_candidates_number == 3, LOG);
+    assert_true(third_rung_candidates_number == 2, LOG);
+}
+
+
+void TrainingSchedulerTest::test_perform_trials()
+{
+    cout << "test_perform_trials\n";
+
+    DataSet data_set(20, 3, 1);
+    data_set.set_data_random();
+    data_set.split_instances_random();
+
+    Tensor<Index, 1> architecture(3);
+    architecture.setValues({3, 2, 1});
+
+    NeuralNetwork neural_network(NeuralNetwork::Approximation, architecture);
+
+    TrainingStrategy training_strategy(&neural_network, &data_set);
+    training_strategy.set_loss_method(TrainingStrategy::SUM_SQUARED_ERROR);
+    training_strategy.set_optimization_method(TrainingStrategy::QUASI_NEWTON_METHOD);
+    training_strategy.set_maximum_epochs_number(5);
+    training_strategy.set_display(false);
+
+    TrainingScheduler training_scheduler(&training_strategy);
+
+    Tensor<DataSet::VariableUse, 1> columns_uses = data_set.get_columns_uses();
+    columns_uses(1) = DataSet::UnusedVariable;
+
+    Tensor<TrainingScheduler::Candidate, 1> candidates(3);
+
+    candidates(1).columns_uses = columns_uses;
+    candidates(2).columns_uses = columns_uses;
+
+    Tensor<OptimizationAlgorithm::Results, 1> results = training_scheduler.perform_trials(candidates, 2);
+
+    assert_true(results.size() == 3, LOG);
+    assert_true(training_scheduler.get_cache_size() == 2, LOG);
+    assert_true(abs(results(1).final_selection_error - results(2).final_selection_error) < numeric_limits<type>::min(), LOG);
+
+    // Cached candidates
+
+    const type selection_error = results(0).final_selection_error;
+
+    results = training_scheduler.perform_trials(candidates, 2);
+
+    assert_true(training_scheduler.get_cache_size() == 2, LOG);
+    assert_true(abs(results(0).final_selection_error - selection_error) < numeric_limits<type>::min(), LOG);
+
+    // Cache file
+
+    const string file_name = "../data/training_scheduler_cache.xml";
+
+    training_scheduler.save_cache(file_name);
+
+    training_scheduler.clear_cache();
+
+    assert_true(training_scheduler.get_cache_size() == 0, LOG);
+
+    training_scheduler.load_cache(file_name);
+
+    assert_true(training_scheduler.get_cache_size() == 2, LOG);
+
+    const Tensor<OptimizationAlgorithm::Results, 1> loaded_results = training_scheduler.perform_trials(candidates, 2);
+
+    assert_true(training_scheduler.get_cache_size() == 2, LOG);
+    assert_true(abs(loaded_results(0).final_selection_error - selection_error) < numeric_limits<type>::min(), LOG);
+    assert_true(loaded_results(0).final_parameters.size() == results(0).final_parameters.size(), LOG);
+
+    const Tensor<type, 1> difference = loaded_results(0).final_parameters - results(0).final_parameters;
+
+    const Tensor<type, 0> maximum_difference = difference.abs().maximum();
+
+    assert_true(maximum_difference(0) < numeric_limits<type>::min(), LOG);
+
+    remove(file_name.c_str());
+
+    training_scheduler.clear_cache();
+
+    assert_true(training_scheduler.get_cache_size() == 0, LOG);
+}
+
+
+void TrainingSchedulerTest::run_test_case()
+{
+    cout << "Running training scheduler test case...\n";
+
+    // Constructor and destructor methods
+
+    test_constructor();
+    test_destructor();
+
+    // Set methods
+
+    test_set_default();
+
+    // Training methods
+
+    test_perform_trainings();
+    test_perform_racing();
+    test_perform_trials();
+
+    cout << "End of training scheduler test case.\n";
+}
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright(C) 2005-2020 Artificial Intelligence Techniques, SL.
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
@@ -0,0 +1,56 @@
+//   OpenNN: Open Neural Networks Library
+//   www.opennn.net
+//
+//   T R A I N I N G   S C H E D U L E R   T E S T   C L A S S   H E A D E R
+//
+//   Artificial Intelligence Techniques SL
+//   artelnics@artelnics.com
+
+#ifndef TRAININGSCHEDULERTEST_H
+#define TRAININGSCHEDULERTEST_H
+
+// Unit testing includes
+
+#include "unit_testing.h"
+
+using namespace OpenNN;
+
+
+class TrainingSchedulerTest : public UnitTesting
+{
+
+#define	STRING(x) #x
+#define TOSTRING(x) STRING(x)
+#define LOG __FILE__ ":" TOSTRING(__LINE__)"\n"
+
+public:
+
+   // CONSTRUCTOR
+
+   explicit TrainingSchedulerTest();
+
+   virtual ~TrainingSchedulerTest();
+
+   // Constructor and destructor methods
+
+   void test_constructor();
+   void test_destructor();
+
+   // Set methods
+
+   void test_set_default();
+
+   // Training methods
+
+   void test_perform_trainings();
+   void test_perform_racing();
+   void test_perform_trials();
+
+   // Unit testing methods
+
+   void run_test_case();
+
+};
+
+
+#endif